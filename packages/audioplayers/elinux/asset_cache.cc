@@ -0,0 +1,131 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "asset_cache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "plugin_log.h"
+
+namespace {
+// The read size of filesrc in push mode, instead of its 4 KiB. A multiple
+// of the page size.
+constexpr guint kReadBlockSize = 256 * 1024;
+// How much of an asset is read ahead on Prefetch(), e.g. its header and
+// the first seconds.
+constexpr int64_t kPrefetchSize = 4 * 1024 * 1024;
+// Only short assets are pinned, up to a total for the whole process.
+constexpr int64_t kMaxPinnedFileSize = 8 * 1024 * 1024;
+constexpr int64_t kMaxPinnedSize = 32 * 1024 * 1024;
+}  // namespace
+
+// static
+AssetCache& AssetCache::GetInstance() {
+  static AssetCache instance;
+  return instance;
+}
+
+AssetCache::~AssetCache() {
+  for (auto& entry : entries_) {
+    if (entry.second.data) {
+      munmap(entry.second.data, entry.second.size);
+    }
+  }
+}
+
+void AssetCache::Prefetch(const std::string& path) {
+  const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode)) {
+    close(fd);
+    return;
+  }
+  // The readahead is shared through the page cache with the file
+  // descriptor of filesrc.
+  posix_fadvise(fd, 0, std::min<int64_t>(status.st_size, kPrefetchSize),
+                POSIX_FADV_WILLNEED);
+  close(fd);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // A pinned asset keeps its mapping.
+  auto& entry = entries_[path];
+  if (!entry.data) {
+    entry.size = status.st_size;
+  }
+}
+
+void AssetCache::ConfigureSource(GstElement* source) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (GetAssetLocation(source).empty()) {
+    return;
+  }
+  g_object_set(G_OBJECT(source), "blocksize", kReadBlockSize, NULL);
+}
+
+bool AssetCache::Pin(GstElement* source) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto location = GetAssetLocation(source);
+  if (location.empty()) {
+    return false;
+  }
+  auto& entry = entries_[location];
+  if (entry.data) {
+    return true;
+  }
+  if (entry.size <= 0 || entry.size > kMaxPinnedFileSize ||
+      pinned_size_ + entry.size > kMaxPinnedSize) {
+    return false;
+  }
+  const auto fd = open(location.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  // The pages were just read by filesrc, so populating the mapping causes
+  // no I/O.
+  auto* data =
+      mmap(nullptr, entry.size, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    PLUGIN_LOG(Warning, "asset")
+        << "Failed to map " << location << ": " << std::strerror(errno);
+    return false;
+  }
+  // Limited by RLIMIT_MEMLOCK. Otherwise the file stays mapped, which only
+  // makes its pages less likely to be reclaimed.
+  entry.is_locked = mlock(data, entry.size) == 0;
+  if (!entry.is_locked) {
+    PLUGIN_LOG(Info, "asset")
+        << "Failed to lock " << location << ": " << std::strerror(errno);
+  }
+  entry.data = data;
+  pinned_size_ += entry.size;
+  PLUGIN_LOG(Debug, "asset") << "Pinned " << location << " (" << entry.size
+                             << " bytes)";
+  return true;
+}
+
+std::string AssetCache::GetAssetLocation(GstElement* source) const {
+  auto* factory = source ? gst_element_get_factory(source) : nullptr;
+  if (!factory || std::strcmp(GST_OBJECT_NAME(factory), "filesrc") != 0) {
+    return std::string();
+  }
+  gchar* location = nullptr;
+  g_object_get(G_OBJECT(source), "location", &location, NULL);
+  if (!location) {
+    return std::string();
+  }
+  std::string path(location);
+  g_free(location);
+  return entries_.count(path) ? path : std::string();
+}
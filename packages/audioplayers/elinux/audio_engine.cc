@@ -0,0 +1,403 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "audio_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "plugin_log.h"
+
+namespace {
+constexpr size_t kFrameBytes = AudioEngine::kChannels * sizeof(float);
+// Bounds the samples queued in a branch, e.g. while the output starts, to
+// 200 ms.
+constexpr guint64 kMaxQueuedBytes = AudioEngine::kSampleRate * kFrameBytes / 5;
+// The voices are mixed 5 ms at a time, and at most one chunk is queued
+// ahead, so that a voice started is heard with the next chunk.
+constexpr size_t kVoiceChunkFrames = AudioEngine::kSampleRate / 200;
+// How long the mixer waits for the samples of a player before mixing
+// without them.
+constexpr GstClockTime kMixerLatency = 20 * GST_MSECOND;
+}  // namespace
+
+AudioEngine::Branch::~Branch() {
+  if (source) {
+    gst_object_unref(source);
+  }
+}
+
+AudioEngine::Voice::~Voice() {
+  if (samples) {
+    gst_buffer_unmap(samples, &map);
+    gst_buffer_unref(samples);
+  }
+}
+
+// static
+AudioEngine& AudioEngine::GetInstance() {
+  static AudioEngine instance;
+  return instance;
+}
+
+// static
+GstCaps* AudioEngine::CreateCaps() {
+  return gst_caps_new_simple("audio/x-raw", "format", G_TYPE_STRING, "F32LE",
+                             "layout", G_TYPE_STRING, "interleaved", "rate",
+                             G_TYPE_INT, kSampleRate, "channels", G_TYPE_INT,
+                             kChannels, NULL);
+}
+
+GstElement* AudioEngine::CreateSink() {
+  auto* bin = gst_bin_new(nullptr);
+  auto* convert = gst_element_factory_make("audioconvert", nullptr);
+  auto* resample = gst_element_factory_make("audioresample", nullptr);
+  auto* filter = gst_element_factory_make("capsfilter", nullptr);
+  auto* sink = gst_element_factory_make("appsink", nullptr);
+  if (!convert || !resample || !filter || !sink) {
+    std::cerr << "Failed to create a sink of the audio engine" << std::endl;
+    for (auto* element : {convert, resample, filter, sink}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    gst_object_unref(bin);
+    return nullptr;
+  }
+
+  auto* caps = CreateCaps();
+  g_object_set(G_OBJECT(filter), "caps", caps, NULL);
+  // The samples are handed over at their presentation time, so that the
+  // mixer stamps them in step with the clock of the player. Samples aren't
+  // queued up once the sink is released while the playbin still runs.
+  g_object_set(G_OBJECT(sink), "sync", TRUE, "max-buffers", 1, "drop", TRUE,
+               NULL);
+  gst_bin_add_many(GST_BIN(bin), convert, resample, filter, sink, NULL);
+  gst_element_link_many(convert, resample, filter, sink, NULL);
+  auto* sink_pad = gst_element_get_static_pad(convert, "sink");
+  gst_element_add_pad(bin, gst_ghost_pad_new("sink", sink_pad));
+  gst_object_unref(sink_pad);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto* source = EnsurePipeline()
+                     ? gst_element_factory_make("appsrc", nullptr)
+                     : nullptr;
+  if (!source) {
+    std::cerr << "Failed to attach a player to the audio engine" << std::endl;
+    gst_caps_unref(caps);
+    gst_object_unref(bin);
+    return nullptr;
+  }
+  g_object_set(G_OBJECT(source), "caps", caps, "format", GST_FORMAT_TIME,
+               "is-live", TRUE, "do-timestamp", TRUE, "max-bytes",
+               kMaxQueuedBytes, NULL);
+  gst_caps_unref(caps);
+
+  auto branch = std::make_shared<Branch>();
+  branch->source = GST_ELEMENT(gst_object_ref(source));
+  branch->sink = sink;
+  gst_bin_add(GST_BIN(pipeline_), source);
+  branch->mixer_pad = gst_element_request_pad_simple(mixer_, "sink_%u");
+  auto* source_pad = gst_element_get_static_pad(source, "src");
+  gst_pad_link(source_pad, branch->mixer_pad);
+  gst_object_unref(source_pad);
+  gst_element_sync_state_with_parent(source);
+
+  GstAppSinkCallbacks callbacks = {};
+  callbacks.new_sample = OnNewSample;
+  gst_app_sink_set_callbacks(GST_APP_SINK(sink), &callbacks,
+                             new std::shared_ptr<Branch>(branch),
+                             DeleteBranch);
+  branches_[bin] = branch;
+  UpdatePipelineState();
+  return bin;
+}
+
+void AudioEngine::ReleaseSink(GstElement* sink) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = branches_.find(sink);
+  if (iter == branches_.end()) {
+    return;
+  }
+  auto branch = iter->second;
+  branches_.erase(iter);
+
+  branch->is_attached = false;
+  GstAppSinkCallbacks callbacks = {};
+  gst_app_sink_set_callbacks(GST_APP_SINK(branch->sink), &callbacks, nullptr,
+                             nullptr);
+  gst_element_set_state(branch->source, GST_STATE_NULL);
+  auto* source_pad = gst_element_get_static_pad(branch->source, "src");
+  gst_pad_unlink(source_pad, branch->mixer_pad);
+  gst_object_unref(source_pad);
+  gst_element_release_request_pad(mixer_, branch->mixer_pad);
+  gst_object_unref(branch->mixer_pad);
+  branch->mixer_pad = nullptr;
+  gst_bin_remove(GST_BIN(pipeline_), branch->source);
+  UpdatePipelineState();
+}
+
+void AudioEngine::AcquireVoices() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!EnsurePipeline()) {
+    return;
+  }
+  voice_users_++;
+  UpdatePipelineState();
+}
+
+void AudioEngine::ReleaseVoices() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (voice_users_ == 0) {
+    return;
+  }
+  voice_users_--;
+  UpdatePipelineState();
+}
+
+uint64_t AudioEngine::StartVoice(GstBuffer* samples, int64_t position_ms,
+                                 const VoiceSettings& settings,
+                                 std::function<void()> on_completed) {
+  auto voice = std::make_unique<Voice>();
+  if (!gst_buffer_map(samples, &voice->map, GST_MAP_READ)) {
+    PLUGIN_LOG(Error, "mix") << "Failed to map the samples of a voice";
+    return 0;
+  }
+  voice->samples = gst_buffer_ref(samples);
+  voice->data = reinterpret_cast<const float*>(voice->map.data);
+  voice->length = voice->map.size / kFrameBytes;
+  voice->position = std::min<double>(
+      static_cast<double>(std::max<int64_t>(position_ms, 0)) * kSampleRate /
+          1000,
+      voice->length);
+  voice->on_completed = std::move(on_completed);
+  ApplyVoiceSettings(settings, *voice);
+  // A sound resumed midway fades in, but one started from the beginning
+  // starts at its own attack.
+  voice->current_gain =
+      voice->position > 0 ? mix_kernel::StereoGain{0.0f, 0.0f} : voice->gain;
+
+  std::lock_guard<std::mutex> lock(voices_mutex_);
+  const auto id = next_voice_id_++;
+  voices_[id] = std::move(voice);
+  return id;
+}
+
+void AudioEngine::UpdateVoice(uint64_t id, const VoiceSettings& settings) {
+  std::lock_guard<std::mutex> lock(voices_mutex_);
+  auto iter = voices_.find(id);
+  if (iter != voices_.end() && !iter->second->is_stopping) {
+    ApplyVoiceSettings(settings, *iter->second);
+  }
+}
+
+int64_t AudioEngine::StopVoice(uint64_t id) {
+  std::lock_guard<std::mutex> lock(voices_mutex_);
+  auto iter = voices_.find(id);
+  if (iter == voices_.end() || iter->second->is_stopping) {
+    return -1;
+  }
+  // Removed by OnNeedVoiceData() once faded out.
+  auto& voice = *iter->second;
+  voice.is_stopping = true;
+  voice.on_completed = nullptr;
+  return static_cast<int64_t>(voice.position * 1000 / kSampleRate);
+}
+
+int64_t AudioEngine::GetVoicePosition(uint64_t id) {
+  std::lock_guard<std::mutex> lock(voices_mutex_);
+  auto iter = voices_.find(id);
+  if (iter == voices_.end() || iter->second->is_stopping) {
+    return -1;
+  }
+  return static_cast<int64_t>(iter->second->position * 1000 / kSampleRate);
+}
+
+bool AudioEngine::MeasureLatency(AudioOutput::Latency& latency) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!output_sink_ || !AudioOutput::MeasureLatency(output_sink_, latency)) {
+    return false;
+  }
+  latency.latency_us += static_cast<int64_t>(kMixerLatency / GST_USECOND);
+  return true;
+}
+
+bool AudioEngine::EnsurePipeline() {
+  if (pipeline_) {
+    return true;
+  }
+
+  auto* pipeline = gst_pipeline_new("audio-engine");
+  auto* mixer = gst_element_factory_make("audiomixer", nullptr);
+  auto* convert = gst_element_factory_make("audioconvert", nullptr);
+  auto* resample = gst_element_factory_make("audioresample", nullptr);
+  auto* sink =
+      AudioOutput::CreateSink(AudioOutput::GetInstance().GetDefaultProfile());
+  auto* voices = gst_element_factory_make("appsrc", nullptr);
+  if (!pipeline || !mixer || !convert || !resample || !sink || !voices) {
+    std::cerr << "Failed to create the audio engine" << std::endl;
+    for (auto* element : {mixer, convert, resample, sink, voices, pipeline}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    return false;
+  }
+  g_object_set(G_OBJECT(mixer), "latency", kMixerLatency, NULL);
+  auto* caps = CreateCaps();
+  g_object_set(G_OBJECT(voices), "caps", caps, "format", GST_FORMAT_TIME,
+               "is-live", TRUE, "do-timestamp", TRUE, "max-bytes",
+               static_cast<guint64>(kVoiceChunkFrames * kFrameBytes), NULL);
+  gst_caps_unref(caps);
+  GstAppSrcCallbacks callbacks = {};
+  callbacks.need_data = OnNeedVoiceData;
+  gst_app_src_set_callbacks(GST_APP_SRC(voices), &callbacks, this, nullptr);
+  gst_bin_add_many(GST_BIN(pipeline), voices, mixer, convert, resample, sink,
+                   NULL);
+  if (!gst_element_link_many(voices, mixer, convert, resample, sink, NULL)) {
+    std::cerr << "Failed to link the audio engine" << std::endl;
+    gst_object_unref(pipeline);
+    return false;
+  }
+  pipeline_ = pipeline;
+  mixer_ = mixer;
+  output_sink_ = sink;
+  return true;
+}
+
+void AudioEngine::UpdatePipelineState() {
+  if (!pipeline_) {
+    return;
+  }
+  // Closes the device while nothing plays through it.
+  const auto state = branches_.empty() && voice_users_ == 0
+                         ? GST_STATE_NULL
+                         : GST_STATE_PLAYING;
+  if (GST_STATE_TARGET(pipeline_) == state) {
+    return;
+  }
+  if (gst_element_set_state(pipeline_, state) == GST_STATE_CHANGE_FAILURE) {
+    std::cerr << "Failed to change the state of the audio engine" << std::endl;
+  }
+}
+
+// static
+void AudioEngine::ApplyVoiceSettings(const VoiceSettings& settings,
+                                     Voice& voice) {
+  const auto volume = static_cast<float>(std::clamp(settings.volume, 0.0, 1.0));
+  const auto balance =
+      static_cast<float>(std::clamp(settings.balance, -1.0, 1.0));
+  // Constant power, so that a voice panned across keeps its loudness.
+  voice.gain = mix_kernel::GetPannedGain(volume, balance);
+  voice.rate = settings.rate > 0 ? settings.rate : 1.0;
+  voice.is_looping = settings.is_looping;
+}
+
+// static
+GstFlowReturn AudioEngine::OnNewSample(GstAppSink* sink, gpointer user_data) {
+  auto& branch = *reinterpret_cast<std::shared_ptr<Branch>*>(user_data);
+  auto* sample = gst_app_sink_pull_sample(sink);
+  if (!sample) {
+    return GST_FLOW_OK;
+  }
+  if (branch->is_attached) {
+    // appsrc stamps the buffer with the running time of the mixer.
+    auto* buffer = gst_buffer_copy(gst_sample_get_buffer(sample));
+    GST_BUFFER_PTS(buffer) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_DTS(buffer) = GST_CLOCK_TIME_NONE;
+    gst_app_src_push_buffer(GST_APP_SRC(branch->source), buffer);
+  }
+  gst_sample_unref(sample);
+  return GST_FLOW_OK;
+}
+
+// static
+void AudioEngine::DeleteBranch(gpointer user_data) {
+  delete reinterpret_cast<std::shared_ptr<Branch>*>(user_data);
+}
+
+// static
+const float* AudioEngine::RenderVoice(Voice& voice, float* scratch,
+                                      size_t& frames) {
+  frames = 0;
+  if (voice.length == 0) {
+    return scratch;
+  }
+  // Played as it is, the chunk is read in place.
+  const auto frame = static_cast<size_t>(voice.position);
+  if (voice.rate == 1.0 && voice.position == frame &&
+      frame + kVoiceChunkFrames <= voice.length) {
+    voice.position += kVoiceChunkFrames;
+    frames = kVoiceChunkFrames;
+    return voice.data + frame * kChannels;
+  }
+
+  for (; frames < kVoiceChunkFrames; frames++) {
+    if (voice.position >= voice.length) {
+      if (!voice.is_looping) {
+        break;
+      }
+      voice.position = std::fmod(voice.position, voice.length);
+    }
+    // Linear interpolation is enough for the rates of sound effects.
+    const auto current = static_cast<size_t>(voice.position);
+    const auto next = current + 1 < voice.length
+                          ? current + 1
+                          : (voice.is_looping ? 0 : current);
+    const auto fraction = static_cast<float>(voice.position - current);
+    const auto* a = voice.data + current * kChannels;
+    const auto* b = voice.data + next * kChannels;
+    scratch[frames * kChannels] = a[0] + (b[0] - a[0]) * fraction;
+    scratch[frames * kChannels + 1] = a[1] + (b[1] - a[1]) * fraction;
+    voice.position += voice.rate;
+  }
+  return scratch;
+}
+
+// static
+void AudioEngine::OnNeedVoiceData(GstAppSrc* source, guint length,
+                                  gpointer user_data) {
+  auto* self = reinterpret_cast<AudioEngine*>(user_data);
+  auto* buffer =
+      gst_buffer_new_allocate(nullptr, kVoiceChunkFrames * kFrameBytes,
+                              nullptr);
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_WRITE)) {
+    gst_buffer_unref(buffer);
+    return;
+  }
+  auto* output = reinterpret_cast<float*>(map.data);
+  std::fill(output, output + kVoiceChunkFrames * kChannels, 0.0f);
+
+  {
+    float scratch[kVoiceChunkFrames * kChannels];
+    std::lock_guard<std::mutex> lock(self->voices_mutex_);
+    for (auto iter = self->voices_.begin(); iter != self->voices_.end();) {
+      auto& voice = *iter->second;
+      size_t frames;
+      const auto* samples = RenderVoice(voice, scratch, frames);
+      const auto target = voice.is_stopping ? mix_kernel::StereoGain{0, 0}
+                                            : voice.gain;
+      // The gains are ramped across the chunk, or across the end of a
+      // completed sound.
+      mix_kernel::MixStereo(output, samples, frames, voice.current_gain,
+                            target);
+      voice.current_gain = target;
+      if (voice.is_stopping || frames < kVoiceChunkFrames) {
+        if (voice.on_completed) {
+          voice.on_completed();
+        }
+        iter = self->voices_.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+
+  gst_buffer_unmap(buffer, &map);
+  gst_app_src_push_buffer(source, buffer);
+}
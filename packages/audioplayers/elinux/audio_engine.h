@@ -0,0 +1,157 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_AUDIO_ENGINE_H_
+#define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_AUDIO_ENGINE_H_
+
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/gst.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "audio_output.h"
+#include "mix_kernel.h"
+
+// Mixes the players in low latency mode into one output pipeline.
+// $ appsrc ! audiomixer ! audioconvert ! audioresample ! autoaudiosink
+//   appsrc ! audiomixer.sink_1 ...
+//
+// Each player keeps its playbin, so that seeking, rates and looping stay
+// per player, but plays into a sink from CreateSink() instead of an audio
+// sink of its own. The sink hands the decoded samples over to an appsrc of
+// the mixer, which stamps them on arrival. Many short sound effects then
+// cost one device connection and one output thread instead of one of each
+// per player. The output pipeline is stopped while it has no players. Its
+// sink is created with the default profile of AudioOutput.
+//
+// Sounds decoded in advance by SampleBank are played as voices instead,
+// which are mixed in software into one more appsrc. Starting a voice costs
+// no demuxing, decoding or state change. The gains of a voice are applied
+// by the vectorized kernels of mix_kernel.h in the same pass as the mixing,
+// and ramped across a chunk when they change, so that starting, stopping,
+// panning or changing the volume of a voice doesn't click.
+class AudioEngine {
+ public:
+  // The format of the mixer and of the samples of voices.
+  static constexpr int32_t kSampleRate = 48000;
+  static constexpr int32_t kChannels = 2;
+
+  struct VoiceSettings {
+    double volume = 1.0;
+    // -1.0 is left and 1.0 is right.
+    double balance = 0.0;
+    double rate = 1.0;
+    bool is_looping = false;
+  };
+
+  static AudioEngine& GetInstance();
+
+  // Returns new caps of the format above.
+  static GstCaps* CreateCaps();
+
+  // Prevent copying.
+  AudioEngine(AudioEngine const&) = delete;
+  AudioEngine& operator=(AudioEngine const&) = delete;
+
+  // Returns a sink bin to be set as the audio sink of a playbin, or nullptr
+  // on failure. The caller owns the floating reference.
+  GstElement* CreateSink();
+  // Detaches |sink| from the mixer. Must be called before |sink| is
+  // destroyed.
+  void ReleaseSink(GstElement* sink);
+
+  // Keeps the output running while a player may start voices, so that
+  // starting one doesn't wait for the audio device.
+  void AcquireVoices();
+  void ReleaseVoices();
+  // Starts playing |samples| from SampleBank at |position_ms|, and returns
+  // the id of the voice. |on_completed| is called at the end unless the
+  // voice loops, on the streaming thread with the voices locked, so it must
+  // not call back into the engine.
+  uint64_t StartVoice(GstBuffer* samples, int64_t position_ms,
+                      const VoiceSettings& settings,
+                      std::function<void()> on_completed);
+  void UpdateVoice(uint64_t id, const VoiceSettings& settings);
+  // Returns the position in milliseconds where the voice stopped, or -1 if
+  // it has already ended. The voice fades out over the next chunk.
+  int64_t StopVoice(uint64_t id);
+  // Returns -1 if the voice has ended.
+  int64_t GetVoicePosition(uint64_t id);
+  // Measures the output, including the latency of the mixer, once it has
+  // played.
+  bool MeasureLatency(AudioOutput::Latency& latency);
+
+ private:
+  struct Branch {
+    ~Branch();
+
+    // The appsrc in the mixer pipeline, of which a reference is held.
+    GstElement* source = nullptr;
+    // The appsink in the sink bin of the player.
+    GstElement* sink = nullptr;
+    GstPad* mixer_pad = nullptr;
+    // Cleared by ReleaseSink(), since the streaming thread of the player
+    // may still be in OnNewSample().
+    std::atomic<bool> is_attached{true};
+  };
+
+  struct Voice {
+    ~Voice();
+
+    // A reference is held, and |map| stays mapped for reading.
+    GstBuffer* samples = nullptr;
+    GstMapInfo map;
+    const float* data = nullptr;
+    // In frames.
+    size_t length = 0;
+    double position = 0;
+    double rate = 1.0;
+    // The gains of the settings, and those the last chunk ended with.
+    mix_kernel::StereoGain gain = {1.0f, 1.0f};
+    mix_kernel::StereoGain current_gain = {0.0f, 0.0f};
+    bool is_looping = false;
+    // Set by StopVoice(), after which the voice fades out and is removed.
+    bool is_stopping = false;
+    std::function<void()> on_completed;
+  };
+
+  AudioEngine() = default;
+  ~AudioEngine() = default;
+
+  // Must be called with |mutex_| held.
+  bool EnsurePipeline();
+  // Runs the output while it has players.
+  void UpdatePipelineState();
+  static void ApplyVoiceSettings(const VoiceSettings& settings, Voice& voice);
+  // Resamples the next frames of |voice| into |scratch| unless they can be
+  // read as they are, and returns them. |frames| is set to their number,
+  // which is less than a chunk if the voice has completed.
+  static const float* RenderVoice(Voice& voice, float* scratch,
+                                  size_t& frames);
+  static GstFlowReturn OnNewSample(GstAppSink* sink, gpointer user_data);
+  static void DeleteBranch(gpointer user_data);
+  // Mixes the next chunk of the voices on the streaming thread.
+  static void OnNeedVoiceData(GstAppSrc* source, guint length,
+                              gpointer user_data);
+
+  std::mutex mutex_;
+  GstElement* pipeline_ = nullptr;
+  GstElement* mixer_ = nullptr;
+  GstElement* output_sink_ = nullptr;
+  // Keyed by the sink bin.
+  std::unordered_map<GstElement*, std::shared_ptr<Branch>> branches_;
+  int32_t voice_users_ = 0;
+
+  std::mutex voices_mutex_;
+  std::unordered_map<uint64_t, std::unique_ptr<Voice>> voices_;
+  uint64_t next_voice_id_ = 1;
+};
+
+#endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_AUDIO_ENGINE_H_
@@ -0,0 +1,177 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "audio_output.h"
+
+#include <gst/audio/audio.h>
+
+#include <iostream>
+
+namespace {
+const char* GetSinkFactoryName(const std::string& sink) {
+  if (sink == "alsa") {
+    return "alsasink";
+  }
+  if (sink == "pulse") {
+    return "pulsesink";
+  }
+  if (sink == "pipewire") {
+    return "pipewiresink";
+  }
+  if (sink == "fake") {
+    return "fakesink";
+  }
+  return nullptr;
+}
+
+gint IsAudioBaseSink(gconstpointer value, gconstpointer user_data) {
+  auto* element = g_value_get_object(reinterpret_cast<const GValue*>(value));
+  return GST_IS_AUDIO_BASE_SINK(element) ? 0 : 1;
+}
+
+// Returns a reference to the audio sink in |sink|, e.g. the one that
+// autoaudiosink has picked, or nullptr if there's none yet.
+GstAudioBaseSink* FindAudioBaseSink(GstElement* sink) {
+  if (GST_IS_AUDIO_BASE_SINK(sink)) {
+    return GST_AUDIO_BASE_SINK(gst_object_ref(sink));
+  }
+  if (!GST_IS_BIN(sink)) {
+    return nullptr;
+  }
+  GstAudioBaseSink* result = nullptr;
+  GValue value = G_VALUE_INIT;
+  auto* iterator = gst_bin_iterate_recurse(GST_BIN(sink));
+  if (gst_iterator_find_custom(iterator, IsAudioBaseSink, &value, nullptr)) {
+    result = GST_AUDIO_BASE_SINK(gst_object_ref(g_value_get_object(&value)));
+    g_value_unset(&value);
+  }
+  gst_iterator_free(iterator);
+  return result;
+}
+}  // namespace
+
+// static
+AudioOutput& AudioOutput::GetInstance() {
+  static AudioOutput instance;
+  return instance;
+}
+
+void AudioOutput::SetDefaultProfile(const Profile& profile) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  default_profile_ = profile;
+}
+
+AudioOutput::Profile AudioOutput::GetDefaultProfile() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return default_profile_;
+}
+
+// static
+GstElement* AudioOutput::CreateSink(const Profile& profile) {
+  GstElement* sink = nullptr;
+  const auto* factory_name = GetSinkFactoryName(profile.sink);
+  if (factory_name) {
+    sink = gst_element_factory_make(factory_name, nullptr);
+    if (!sink) {
+      std::cerr << "Failed to create a " << factory_name
+                << ", falling back to autoaudiosink" << std::endl;
+    }
+  } else if (!profile.sink.empty()) {
+    std::cerr << "Unknown audio sink " << profile.sink
+              << ", falling back to autoaudiosink" << std::endl;
+  }
+  if (sink) {
+    // fakesink renders as fast as it's fed unless it syncs to the clock.
+    if (profile.sink == "fake") {
+      g_object_set(G_OBJECT(sink), "sync", TRUE, NULL);
+    }
+    if (!profile.device.empty() &&
+        g_object_class_find_property(G_OBJECT_GET_CLASS(sink), "device")) {
+      g_object_set(G_OBJECT(sink), "device", profile.device.c_str(), NULL);
+    }
+    ApplyProfile(sink, profile);
+    return sink;
+  }
+
+  sink = gst_element_factory_make("autoaudiosink", nullptr);
+  if (!sink) {
+    std::cerr << "Failed to create an autoaudiosink" << std::endl;
+    return nullptr;
+  }
+  if (profile.buffer_time_us > 0 || profile.latency_time_us > 0) {
+    // autoaudiosink adds the sink it picks on the change to READY.
+    g_signal_connect_data(sink, "element-added", G_CALLBACK(OnElementAdded),
+                          new Profile(profile), DeleteProfile,
+                          static_cast<GConnectFlags>(0));
+  }
+  return sink;
+}
+
+// static
+bool AudioOutput::MeasureLatency(GstElement* sink, Latency& latency) {
+  auto* base_sink = FindAudioBaseSink(sink);
+  if (!base_sink) {
+    return false;
+  }
+  auto is_measured = false;
+  GST_OBJECT_LOCK(base_sink);
+  auto* ring_buffer = base_sink->ringbuffer;
+  if (ring_buffer) {
+    gst_object_ref(ring_buffer);
+  }
+  GST_OBJECT_UNLOCK(base_sink);
+  if (ring_buffer && gst_audio_ring_buffer_is_acquired(ring_buffer)) {
+    const auto& spec = ring_buffer->spec;
+    const auto rate = GST_AUDIO_INFO_RATE(&spec.info);
+    const auto bpf = GST_AUDIO_INFO_BPF(&spec.info);
+    if (rate > 0 && bpf > 0) {
+      // The segments actually negotiated, which the device may have
+      // rounded from the requested ones.
+      const auto segment_us =
+          static_cast<int64_t>(spec.segsize / bpf) * G_USEC_PER_SEC / rate;
+      const auto delay_us =
+          static_cast<int64_t>(gst_audio_ring_buffer_delay(ring_buffer)) *
+          G_USEC_PER_SEC / rate;
+      latency.latency_time_us = segment_us;
+      latency.buffer_time_us = segment_us * spec.segtotal;
+      latency.latency_us = latency.buffer_time_us + delay_us;
+      auto* factory = gst_element_get_factory(GST_ELEMENT(base_sink));
+      latency.sink = factory ? GST_OBJECT_NAME(factory) : "";
+      is_measured = true;
+    }
+  }
+  if (ring_buffer) {
+    gst_object_unref(ring_buffer);
+  }
+  gst_object_unref(base_sink);
+  return is_measured;
+}
+
+// static
+void AudioOutput::ApplyProfile(GstElement* sink, const Profile& profile) {
+  auto* object_class = G_OBJECT_GET_CLASS(sink);
+  if (profile.buffer_time_us > 0 &&
+      g_object_class_find_property(object_class, "buffer-time")) {
+    g_object_set(G_OBJECT(sink), "buffer-time",
+                 static_cast<gint64>(profile.buffer_time_us), NULL);
+  }
+  if (profile.latency_time_us > 0 &&
+      g_object_class_find_property(object_class, "latency-time")) {
+    g_object_set(G_OBJECT(sink), "latency-time",
+                 static_cast<gint64>(profile.latency_time_us), NULL);
+  }
+}
+
+// static
+void AudioOutput::OnElementAdded(GstBin* bin, GstElement* element,
+                                 gpointer user_data) {
+  if (GST_IS_AUDIO_BASE_SINK(element)) {
+    ApplyProfile(element, *reinterpret_cast<Profile*>(user_data));
+  }
+}
+
+// static
+void AudioOutput::DeleteProfile(gpointer data, GClosure* closure) {
+  delete reinterpret_cast<Profile*>(data);
+}
@@ -0,0 +1,84 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_AUDIO_OUTPUT_H_
+#define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_AUDIO_OUTPUT_H_
+
+#include <gst/gst.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Creates the audio sinks of the players and of AudioEngine according to an
+// output profile, and measures the latency of a sink once it plays.
+//
+// autoaudiosink with its default buffering queues 200 ms or more on some
+// ALSA devices. A profile picks the sink explicitly and sizes its ring
+// buffer, so that rhythm and game audio are heard close to the moment they
+// are played.
+class AudioOutput {
+ public:
+  struct Profile {
+    // "alsa", "pulse" or "pipewire", or "fake" for a fakesink synced to the
+    // clock, e.g. for headless tests. Empty for autoaudiosink.
+    std::string sink;
+    // The device of alsasink or pulsesink. Empty for the default one.
+    std::string device;
+    // The buffer-time and latency-time of the sink in microseconds. Zero
+    // keeps the defaults of the sink.
+    int64_t buffer_time_us = 0;
+    int64_t latency_time_us = 0;
+
+    bool IsDefault() const {
+      return sink.empty() && device.empty() && buffer_time_us <= 0 &&
+             latency_time_us <= 0;
+    }
+  };
+
+  struct Latency {
+    // The time a sample written to the sink now takes to be heard: its ring
+    // buffer and the delay reported by the device.
+    int64_t latency_us = 0;
+    // The ring buffer as negotiated with the device.
+    int64_t buffer_time_us = 0;
+    int64_t latency_time_us = 0;
+    // The factory name of the sink, e.g. alsasink.
+    std::string sink;
+  };
+
+  static AudioOutput& GetInstance();
+
+  // Prevent copying.
+  AudioOutput(AudioOutput const&) = delete;
+  AudioOutput& operator=(AudioOutput const&) = delete;
+
+  // The profile of the players without one of their own. Takes effect on
+  // their next source, and on AudioEngine if its output hasn't started yet.
+  void SetDefaultProfile(const Profile& profile);
+  Profile GetDefaultProfile();
+
+  // Returns a new floating sink of |profile|, or nullptr on failure. Falls
+  // back to autoaudiosink if the sink of |profile| isn't installed.
+  static GstElement* CreateSink(const Profile& profile);
+  // Measures |sink| from CreateSink(), which must have negotiated its ring
+  // buffer, i.e. be PAUSED or PLAYING with data. Returns false otherwise.
+  static bool MeasureLatency(GstElement* sink, Latency& latency);
+
+ private:
+  AudioOutput() = default;
+  ~AudioOutput() = default;
+
+  // Sets the buffering of |profile| on |sink| if it has the properties.
+  static void ApplyProfile(GstElement* sink, const Profile& profile);
+  // Sets the profile on the sink autoaudiosink picks once it's added.
+  static void OnElementAdded(GstBin* bin, GstElement* element,
+                             gpointer user_data);
+  static void DeleteProfile(gpointer data, GClosure* closure);
+
+  std::mutex mutex_;
+  Profile default_profile_;
+};
+
+#endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_AUDIO_OUTPUT_H_
@@ -5,6 +5,7 @@
 #ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_AUDIO_PLAYER_STREAM_HANDLER_H_
 #define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_AUDIO_PLAYER_STREAM_HANDLER_H_
 
+#include <cstdint>
 #include <string>
 
 class AudioPlayerStreamHandler {
@@ -28,6 +29,12 @@ class AudioPlayerStreamHandler {
     OnNotifyDurationInternal(player_id, duration);
   }
 
+  // Notifies the current position of an audio while it plays.
+  void OnNotifyCurrentPosition(const std::string &player_id,
+                               const int64_t position) {
+    OnNotifyCurrentPositionInternal(player_id, position);
+  }
+
   // Notifies the completion of seeks an audio.
   void OnNotifySeekCompleted(const std::string &player_id) {
     OnNotifySeekCompletedInternal(player_id);
@@ -47,6 +54,8 @@ class AudioPlayerStreamHandler {
  protected:
   virtual void OnNotifyPreparedInternal(const std::string&, const bool) = 0;
   virtual void OnNotifyDurationInternal(const std::string&, const int32_t) = 0;
+  virtual void OnNotifyCurrentPositionInternal(const std::string&,
+                                               const int64_t) = 0;
   virtual void OnNotifySeekCompletedInternal(const std::string&) = 0;
   virtual void OnNotifyPlayCompletedInternal(const std::string &) = 0;
   virtual void OnNotifyLogInternal(const std::string&, const std::string&) = 0;
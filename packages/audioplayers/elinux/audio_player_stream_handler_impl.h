@@ -14,6 +14,8 @@ class AudioPlayerStreamHandlerImpl : public AudioPlayerStreamHandler {
   using OnNotifyPrepared = std::function<void(const std::string&, const bool)>;
   using OnNotifyDuration =
       std::function<void(const std::string&, const int32_t)>;
+  using OnNotifyCurrentPosition =
+      std::function<void(const std::string&, const int64_t)>;
   using OnNotifySeekCompleted = std::function<void(const std::string&)>;
   using OnNotifyPlayCompleted = std::function<void(const std::string&)>;
   using OnNotifyLog =
@@ -21,11 +23,14 @@ class AudioPlayerStreamHandlerImpl : public AudioPlayerStreamHandler {
 
   AudioPlayerStreamHandlerImpl(OnNotifyPrepared on_notify_prepared,
                                OnNotifyDuration on_notify_duration,
+                               OnNotifyCurrentPosition
+                                   on_notify_current_position,
                                OnNotifySeekCompleted on_notify_seek_completed,
                                OnNotifyPlayCompleted on_notify_play_completed,
                                OnNotifyLog on_notify_log)
       : on_notify_prepared_(on_notify_prepared),
         on_notify_duration_(on_notify_duration),
+        on_notify_current_position_(on_notify_current_position),
         on_notify_seek_completed_(on_notify_seek_completed),
         on_notify_play_completed_(on_notify_play_completed),
         on_notify_log_(on_notify_log) {}
@@ -53,6 +58,14 @@ class AudioPlayerStreamHandlerImpl : public AudioPlayerStreamHandler {
     }
   }
 
+  // |AudioPlayerStreamHandler|
+  void OnNotifyCurrentPositionInternal(const std::string &player_id,
+                                       const int64_t position) {
+    if (on_notify_current_position_) {
+      on_notify_current_position_(player_id, position);
+    }
+  }
+
   // |AudioPlayerStreamHandler|
   void OnNotifySeekCompletedInternal(const std::string &player_id) {
     if (on_notify_seek_completed_) {
@@ -77,6 +90,7 @@ class AudioPlayerStreamHandlerImpl : public AudioPlayerStreamHandler {
 
   OnNotifyPrepared on_notify_prepared_;
   OnNotifyDuration on_notify_duration_;
+  OnNotifyCurrentPosition on_notify_current_position_;
   OnNotifySeekCompleted on_notify_seek_completed_;
   OnNotifyPlayCompleted on_notify_play_completed_;
   OnNotifyLog on_notify_log_;
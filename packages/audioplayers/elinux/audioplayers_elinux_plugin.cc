@@ -14,17 +14,37 @@
 #include <flutter/standard_message_codec.h>
 #include <flutter/standard_method_codec.h>
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <variant>
+#include <vector>
 
+#include "asset_cache.h"
+#include "audio_output.h"
+#include "download_cache.h"
 #include "gst_audio_player.h"
+#include "gst_runtime.h"
 #include "audio_player_stream_handler_impl.h"
+#include "metadata_prober.h"
+#include "platform_task_queue.h"
+#include "plugin_stats_channel.h"
+#include "position_ticker.h"
+#include "sample_bank.h"
 
 namespace {
+constexpr char kPlatformTasksChannelName[] =
+    "xyz.luan/audioplayers/platformTasks";
 constexpr char kInvalidArgument[] = "Invalid argument";
 constexpr char kAudioDurationEvent[] = "audio.onDuration";
+constexpr char kAudioCurrentPositionEvent[] = "audio.onCurrentPosition";
 constexpr char kAudioPreparedEvent[] = "audio.onPrepared";
 constexpr char kAudioSeekCompleteEvent[] = "audio.onSeekComplete";
 constexpr char kAudioCompleteEvent[] = "audio.onComplete";
@@ -43,6 +63,28 @@ bool GetValueFromEncodableMap(const flutter::EncodableMap* map, const char* key,
   return false;
 }
 
+// Dart sends an int as int32_t if it fits and as int64_t otherwise.
+bool GetIntegerFromEncodableMap(const flutter::EncodableMap* map,
+                                const char* key, int64_t &out) {
+  int32_t value = 0;
+  if (GetValueFromEncodableMap(map, key, value)) {
+    out = value;
+    return true;
+  }
+  return GetValueFromEncodableMap(map, key, out);
+}
+
+// Reads the output profile of setOutputProfile.
+AudioOutput::Profile GetOutputProfileFromEncodableMap(
+    const flutter::EncodableMap* map) {
+  AudioOutput::Profile profile;
+  GetValueFromEncodableMap(map, "sink", profile.sink);
+  GetValueFromEncodableMap(map, "device", profile.device);
+  GetIntegerFromEncodableMap(map, "bufferTimeUs", profile.buffer_time_us);
+  GetIntegerFromEncodableMap(map, "latencyTimeUs", profile.latency_time_us);
+  return profile;
+}
+
 class AudioplayersElinuxPlugin : public flutter::Plugin {
  public:
   static void RegisterWithRegistrar(flutter::PluginRegistrar* registrar) {
@@ -71,20 +113,43 @@ class AudioplayersElinuxPlugin : public flutter::Plugin {
   }
 
   AudioplayersElinuxPlugin(flutter::PluginRegistrar* registrar)
-      : registrar_(registrar) {
-      GstAudioPlayer::GstLibraryLoad();
+      : platform_tasks_(registrar->messenger(), kPlatformTasksChannelName),
+        registrar_(registrar),
+        plugin_stats_channel_(registrar) {
+    // Waited for by the first call from Dart.
+    GstRuntime::StartInit();
   }
 
-  virtual ~AudioplayersElinuxPlugin() {}
+  virtual ~AudioplayersElinuxPlugin() {
+    // Destroys the players while GStreamer is still initialized, since this
+    // plugin may be the last one to release it.
+    for (const auto& [player_id, player] : audio_players_) {
+      position_ticker_.Remove(player_id);
+    }
+    metadata_prober_ = nullptr;
+    audio_players_.clear();
+    if (is_gst_library_loaded_) {
+      GstAudioPlayer::GstLibraryUnload();
+    }
+  }
 
   void SetRegistrar(flutter::PluginRegistrar* registrar) {
     registrar_ = registrar;
   }
 
  private:
+  // Must be called before GStreamer is used.
+  void LoadGstLibrary() {
+    if (!is_gst_library_loaded_) {
+      GstAudioPlayer::GstLibraryLoad();
+      is_gst_library_loaded_ = true;
+    }
+  }
+
   void HandleMethodCall(
       const flutter::MethodCall<flutter::EncodableValue>& method_call,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+    LoadGstLibrary();
     const auto* arguments =
         std::get_if<flutter::EncodableMap>(method_call.arguments());
     if (!arguments) {
@@ -112,27 +177,45 @@ class AudioplayersElinuxPlugin : public flutter::Plugin {
       return;
     }
 
+    const auto is_query = method_name == "getDuration" ||
+                          method_name == "getCurrentPosition" ||
+                          method_name == "getOutputLatency" ||
+                          method_name == "setPositionUpdateInterval" ||
+                          method_name == "dispose";
+    if (!is_query) {
+      // A suspended player is restored before the call, but for those that
+      // restore or drop the pipeline themselves. Queries are answered from
+      // what it has kept.
+      if (method_name != "setSourceUrl" && method_name != "release") {
+        player->Wake();
+      }
+      last_uses_[player_id] = ++use_count_;
+      EnforcePlayerLimit(player_id);
+    }
+
+    // The calls run in order on the worker of the player, and are replied
+    // to as they are posted, but for the getters.
     if (method_name == "resume") {
-      player->Resume();
+      player->Post([player]() { player->Resume(); });
       result->Success();
     } else if (method_name == "pause") {
-      player->Pause();
+      player->Post([player]() { player->Pause(); });
       result->Success();
     } else if (method_name == "stop") {
-      player->Stop();
+      player->Post([player]() { player->Stop(); });
       result->Success();
     } else if (method_name == "release") {
-      player->Release();
+      player->Post([player]() { player->Release(); });
       result->Success();
     } else if (method_name == "seek") {
       int32_t position = 0;
       GetValueFromEncodableMap(arguments, "position", position);
-      player->Seek(position);
+      player->Post([player, position]() { player->Seek(position); });
       result->Success();
     } else if (method_name == "setVolume") {
       double volume = 0;
       GetValueFromEncodableMap(arguments, "volume", volume);
-      player->SetVolume(volume);
+      player->Post([player, volume]() { player->SetVolume(volume); });
       result->Success();
     } else if (method_name == "setSourceUrl") {
       bool is_local = false;
@@ -140,43 +223,106 @@ class AudioplayersElinuxPlugin : public flutter::Plugin {
       std::string url = "";
       GetValueFromEncodableMap(arguments, "url", url);
       if (is_local) {
+        // AudioCache copies the assets to local files.
+        AssetCache::GetInstance().Prefetch(url);
         url = std::string("file://") + url;
       }
-      player->SetSourceUrl(url);
+      // audio.onPrepared is sent once the source has prerolled.
+      player->Post([player, url]() { player->SetSourceUrl(url); });
       result->Success();
     } else if (method_name == "setPlaybackRate") {
       double rate = 0;
       GetValueFromEncodableMap(arguments, "playbackRate", rate);
-      player->SetPlaybackRate(rate);
+      player->Post([player, rate]() { player->SetPlaybackRate(rate); });
       result->Success();
     } else if (method_name == "setReleaseMode") {
       std::string release_mode = "";
       GetValueFromEncodableMap(arguments, "releaseMode", release_mode);
       bool looping = release_mode.find("loop") != std::string::npos;
-      player->SetLooping(looping);
+      player->Post([player, looping]() { player->SetLooping(looping); });
       result->Success();
     } else if (method_name == "getDuration") {
-      int64_t duration = player->GetDuration();
-      if (duration >= 0) {
-        result->Success(flutter::EncodableValue(duration));
-      } else {
-        result->Success();
-      }
+      std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>>
+          shared_result = std::move(result);
+      player->Post([player, shared_result]() {
+        int64_t duration = player->GetDuration();
+        if (duration >= 0) {
+          shared_result->Success(flutter::EncodableValue(duration));
+        } else {
+          shared_result->Success();
+        }
+      });
     } else if (method_name == "getCurrentPosition") {
-      int64_t position = player->GetCurrentPosition();
-      if (position >= 0) {
-        result->Success(flutter::EncodableValue(position));
-      } else {
-        result->Success();
-      }
+      std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>>
+          shared_result = std::move(result);
+      player->Post([player, shared_result]() {
+        int64_t position = player->GetCurrentPosition();
+        if (position >= 0) {
+          shared_result->Success(flutter::EncodableValue(position));
+        } else {
+          shared_result->Success();
+        }
+      });
     } else if (method_name == "setBalance") {
       double balance = 0;
       GetValueFromEncodableMap(arguments, "balance", balance);
-      player->SetBalance(balance);
+      player->Post([player, balance]() { player->SetBalance(balance); });
       result->Success();
     }
     else if (method_name == "setPlayerMode") {
-      result->NotImplemented();
+      std::string player_mode = "";
+      GetValueFromEncodableMap(arguments, "playerMode", player_mode);
+      bool is_low_latency =
+          player_mode.find("lowLatency") != std::string::npos;
+      player->Post([player, is_low_latency]() {
+        player->SetSharedOutput(is_low_latency);
+      });
+      result->Success();
+    } else if (method_name == "setNextSourceUrl") {
+      bool is_local = false;
+      GetValueFromEncodableMap(arguments, "isLocal", is_local);
+      std::string url = "";
+      GetValueFromEncodableMap(arguments, "url", url);
+      if (is_local && !url.empty()) {
+        AssetCache::GetInstance().Prefetch(url);
+        url = std::string("file://") + url;
+      }
+      player->Post([player, url]() { player->SetNextSourceUrl(url); });
+      result->Success();
+    } else if (method_name == "setCrossfade") {
+      int64_t duration = 0;
+      GetIntegerFromEncodableMap(arguments, "durationMs", duration);
+      player->Post([player, duration]() { player->SetCrossfade(duration); });
+      result->Success();
+    } else if (method_name == "setPositionUpdateInterval") {
+      int64_t interval = 0;
+      GetIntegerFromEncodableMap(arguments, "intervalMs", interval);
+      position_ticker_.Set(player_id, interval,
+                           [player]() { player->PostPositionUpdate(); });
+      result->Success();
+    } else if (method_name == "setOutputProfile") {
+      const auto profile = GetOutputProfileFromEncodableMap(arguments);
+      player->Post([player, profile]() { player->SetOutputProfile(profile); });
+      result->Success();
+    } else if (method_name == "getOutputLatency") {
+      std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>>
+          shared_result = std::move(result);
+      player->Post([player, shared_result]() {
+        AudioOutput::Latency latency;
+        if (!player->GetOutputLatency(latency)) {
+          shared_result->Success();
+          return;
+        }
+        shared_result->Success(flutter::EncodableValue(flutter::EncodableMap{
+            {flutter::EncodableValue("latencyUs"),
+             flutter::EncodableValue(latency.latency_us)},
+            {flutter::EncodableValue("bufferTimeUs"),
+             flutter::EncodableValue(latency.buffer_time_us)},
+            {flutter::EncodableValue("latencyTimeUs"),
+             flutter::EncodableValue(latency.latency_time_us)},
+            {flutter::EncodableValue("sink"),
+             flutter::EncodableValue(latency.sink)}}));
+      });
     } else if (method_name == "setAudioContext") {
       result->NotImplemented();
     } else if (method_name == "emitLog") {
@@ -184,9 +330,16 @@ class AudioplayersElinuxPlugin : public flutter::Plugin {
     } else if (method_name == "emitError") {
       result->NotImplemented();
     } else if (method_name == "dispose") {
-      player->Dispose();
+      position_ticker_.Remove(player_id);
+      last_uses_.erase(player_id);
+      auto disposed = std::move(audio_players_[player_id]);
       audio_players_.erase(player_id);
       event_sinks_.erase(player_id);
+      // Destroys the player off the platform thread, since it waits for its
+      // worker, which may be in a slow state change.
+      GstRuntime::RunTask(
+          [disposed = std::shared_ptr<GstAudioPlayer>(std::move(disposed))]()
+              mutable { disposed.reset(); });
       result->Success();
     } else {
       result->NotImplemented();
@@ -196,8 +349,69 @@ class AudioplayersElinuxPlugin : public flutter::Plugin {
   void HandleGlobalMethodCall(
       const flutter::MethodCall<flutter::EncodableValue>& method_call,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+    LoadGstLibrary();
     const std::string &method_name = method_call.method_name();
-    if (method_name == "setAudioContext") {
+    if (method_name == "setDownloadCache") {
+      const auto* arguments =
+          std::get_if<flutter::EncodableMap>(method_call.arguments());
+      if (!arguments) {
+        result->Error(kInvalidArgument, "No arguments provided.");
+        return;
+      }
+      DownloadCache::Settings settings;
+      GetValueFromEncodableMap(arguments, "directory", settings.directory);
+      GetIntegerFromEncodableMap(arguments, "maxSizeBytes",
+                                 settings.max_size_bytes);
+      GetIntegerFromEncodableMap(arguments, "bufferDurationMs",
+                                 settings.buffer_duration_ms);
+      int64_t buffer_size_bytes = 0;
+      GetIntegerFromEncodableMap(arguments, "bufferSizeBytes",
+                                 buffer_size_bytes);
+      settings.buffer_size_bytes = static_cast<int32_t>(
+          std::min<int64_t>(buffer_size_bytes,
+                            std::numeric_limits<int32_t>::max()));
+      DownloadCache::GetInstance().Configure(settings);
+      result->Success();
+    } else if (method_name == "setOutputProfile") {
+      const auto* arguments =
+          std::get_if<flutter::EncodableMap>(method_call.arguments());
+      if (!arguments) {
+        result->Error(kInvalidArgument, "No arguments provided.");
+        return;
+      }
+      AudioOutput::GetInstance().SetDefaultProfile(
+          GetOutputProfileFromEncodableMap(arguments));
+      result->Success();
+    } else if (method_name == "setMaxLivePlayers") {
+      const auto* arguments =
+          std::get_if<flutter::EncodableMap>(method_call.arguments());
+      if (!arguments) {
+        result->Error(kInvalidArgument, "No arguments provided.");
+        return;
+      }
+      int64_t max_live_players = 0;
+      GetIntegerFromEncodableMap(arguments, "maxLivePlayers",
+                                 max_live_players);
+      max_live_players_ =
+          static_cast<size_t>(std::max<int64_t>(max_live_players, 0));
+      EnforcePlayerLimit(std::string());
+      result->Success();
+    } else if (method_name == "getPlayerReport") {
+      result->Success(flutter::EncodableValue(GetPlayerReport()));
+    } else if (method_name == "probeMetadata") {
+      const auto* arguments =
+          std::get_if<flutter::EncodableMap>(method_call.arguments());
+      if (!arguments) {
+        result->Error(kInvalidArgument, "No arguments provided.");
+        return;
+      }
+      flutter::EncodableList urls;
+      if (!GetValueFromEncodableMap(arguments, "urls", urls)) {
+        result->Error(kInvalidArgument, "No urls provided.");
+        return;
+      }
+      ProbeMetadata(urls, std::move(result));
+    } else if (method_name == "setAudioContext") {
       result->NotImplemented();
     } else if (method_name == "emitLog") {
       result->NotImplemented();
@@ -208,6 +422,158 @@ class AudioplayersElinuxPlugin : public flutter::Plugin {
     }
   }
 
+  // Replies with a map per URL, in order, once all of them are probed.
+  void ProbeMetadata(
+      const flutter::EncodableList& urls,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+    if (urls.empty()) {
+      result->Success(flutter::EncodableValue(flutter::EncodableList()));
+      return;
+    }
+    if (!metadata_prober_) {
+      metadata_prober_ = std::make_unique<MetadataProber>();
+    }
+
+    // The reply is sent by the worker thread that completes the batch.
+    struct Batch {
+      std::mutex mutex;
+      flutter::EncodableList entries;
+      size_t remaining;
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result;
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->entries.resize(urls.size());
+    batch->remaining = urls.size();
+    batch->result = std::move(result);
+    const auto complete = [batch](size_t index, const std::string& url,
+                                  MetadataProber::Metadata metadata) {
+      flutter::EncodableMap entry = {
+          {flutter::EncodableValue("url"), flutter::EncodableValue(url)}};
+      if (!metadata.error.empty()) {
+        entry[flutter::EncodableValue("error")] =
+            flutter::EncodableValue(metadata.error);
+      }
+      if (metadata.duration_ms >= 0) {
+        entry[flutter::EncodableValue("duration")] =
+            flutter::EncodableValue(metadata.duration_ms);
+      }
+      const std::pair<const char*, const std::string*> strings[] = {
+          {"title", &metadata.title},
+          {"artist", &metadata.artist},
+          {"album", &metadata.album},
+          {"genre", &metadata.genre}};
+      for (const auto& string : strings) {
+        if (!string.second->empty()) {
+          entry[flutter::EncodableValue(string.first)] =
+              flutter::EncodableValue(*string.second);
+        }
+      }
+      const std::pair<const char*, uint32_t> numbers[] = {
+          {"trackNumber", metadata.track_number},
+          {"sampleRate", metadata.sample_rate},
+          {"channels", metadata.channels},
+          {"bitrate", metadata.bitrate}};
+      for (const auto& number : numbers) {
+        if (number.second > 0) {
+          entry[flutter::EncodableValue(number.first)] =
+              flutter::EncodableValue(static_cast<int64_t>(number.second));
+        }
+      }
+
+      std::lock_guard<std::mutex> lock(batch->mutex);
+      batch->entries[index] = flutter::EncodableValue(std::move(entry));
+      if (--batch->remaining > 0) {
+        return;
+      }
+      batch->result->Success(
+          flutter::EncodableValue(std::move(batch->entries)));
+    };
+
+    for (size_t i = 0; i < urls.size(); i++) {
+      const auto* url = std::get_if<std::string>(&urls[i]);
+      if (!url) {
+        MetadataProber::Metadata metadata;
+        metadata.error = "Not a URL";
+        complete(i, std::string(), std::move(metadata));
+        continue;
+      }
+      metadata_prober_->Probe(
+          *url, [complete, i, url = *url](MetadataProber::Metadata metadata) {
+            complete(i, url, std::move(metadata));
+          });
+    }
+  }
+
+  // Suspends the least recently used idle players beyond the limit of live
+  // ones, but for |used_player_id|. A player playing isn't suspended, so the
+  // limit may be exceeded while they all play.
+  void EnforcePlayerLimit(const std::string& used_player_id) {
+    if (max_live_players_ == 0) {
+      return;
+    }
+    std::vector<std::pair<uint64_t, GstAudioPlayer*>> idle_players;
+    size_t live_players = 0;
+    for (const auto& [id, player] : audio_players_) {
+      if (!player->IsLoaded()) {
+        continue;
+      }
+      live_players++;
+      if (id != used_player_id && !player->IsPlaying()) {
+        idle_players.emplace_back(last_uses_[id], player.get());
+      }
+    }
+    if (live_players <= max_live_players_) {
+      return;
+    }
+    std::sort(idle_players.begin(), idle_players.end());
+    for (size_t i = 0;
+         i < idle_players.size() && live_players > max_live_players_; i++) {
+      idle_players[i].second->PostSuspend();
+      live_players--;
+    }
+  }
+
+  flutter::EncodableMap GetPlayerReport() {
+    flutter::EncodableList players;
+    int64_t live_players = 0;
+    int64_t suspended_players = 0;
+    for (const auto& [id, player] : audio_players_) {
+      std::string state = "empty";
+      if (player->IsSuspended()) {
+        state = "suspended";
+        suspended_players++;
+      } else if (player->IsLoaded()) {
+        state = player->IsPlaying() ? "playing" : "idle";
+        live_players++;
+      }
+      players.push_back(flutter::EncodableValue(flutter::EncodableMap{
+          {flutter::EncodableValue("playerId"), flutter::EncodableValue(id)},
+          {flutter::EncodableValue("state"), flutter::EncodableValue(state)}}));
+    }
+    flutter::EncodableMap report = {
+        {flutter::EncodableValue("players"),
+         flutter::EncodableValue(std::move(players))},
+        {flutter::EncodableValue("livePlayers"),
+         flutter::EncodableValue(live_players)},
+        {flutter::EncodableValue("suspendedPlayers"),
+         flutter::EncodableValue(suspended_players)},
+        {flutter::EncodableValue("maxLivePlayers"),
+         flutter::EncodableValue(static_cast<int64_t>(max_live_players_))},
+        {flutter::EncodableValue("sampleBankBytes"),
+         flutter::EncodableValue(
+             static_cast<int64_t>(SampleBank::GetInstance().GetSize()))}};
+    // The resident set of the whole process, in pages.
+    std::ifstream statm("/proc/self/statm");
+    int64_t size_pages = 0;
+    int64_t resident_pages = 0;
+    if (statm >> size_pages >> resident_pages) {
+      report[flutter::EncodableValue("residentBytes")] =
+          flutter::EncodableValue(
+              resident_pages * static_cast<int64_t>(sysconf(_SC_PAGESIZE)));
+    }
+    return report;
+  }
+
   GstAudioPlayer* GetAudioPlayer(const std::string &player_id) {
     auto iter = audio_players_.find(player_id);
     if (iter != audio_players_.end()) {
@@ -250,7 +616,7 @@ class AudioplayersElinuxPlugin : public flutter::Plugin {
                flutter::EncodableValue(kAudioPreparedEvent)},
               {flutter::EncodableValue("value"),
                flutter::EncodableValue(is_prepared)}};
-          event_sinks_[player_id]->Success(flutter::EncodableValue(map));
+          SendEvent(player_id, map);
         },
         // OnNotifyDuration
         [this](const std::string &player_id, int32_t duration) {
@@ -259,21 +625,30 @@ class AudioplayersElinuxPlugin : public flutter::Plugin {
                flutter::EncodableValue(kAudioDurationEvent)},
               {flutter::EncodableValue("value"),
                flutter::EncodableValue(duration)}};
-          event_sinks_[player_id]->Success(flutter::EncodableValue(map));
+          SendEvent(player_id, map);
+        },
+        // OnNotifyCurrentPosition
+        [this](const std::string &player_id, int64_t position) {
+          flutter::EncodableMap map = {
+              {flutter::EncodableValue("event"),
+               flutter::EncodableValue(kAudioCurrentPositionEvent)},
+              {flutter::EncodableValue("value"),
+               flutter::EncodableValue(position)}};
+          SendEvent(player_id, map);
         },
         // OnNotifySeekCompleted
         [this](const std::string &player_id) {
           flutter::EncodableMap map = {
               {flutter::EncodableValue("event"),
                flutter::EncodableValue(kAudioSeekCompleteEvent)}};
-          event_sinks_[player_id]->Success(flutter::EncodableValue(map));
+          SendEvent(player_id, map);
         },
         // OnNotifyPlayCompleted
         [this](const std::string &player_id) {
           flutter::EncodableMap map = {
               {flutter::EncodableValue("event"),
                flutter::EncodableValue(kAudioCompleteEvent)}};
-          event_sinks_[player_id]->Success(flutter::EncodableValue(map));
+          SendEvent(player_id, map);
         },
         // OnNotifyLog
         [this](const std::string &player_id, const std::string &message) {
@@ -282,7 +657,7 @@ class AudioplayersElinuxPlugin : public flutter::Plugin {
                flutter::EncodableValue(kAudioLogEvent)},
               {flutter::EncodableValue("value"),
                flutter::EncodableValue(message)}};
-        event_sinks_[player_id]->Success(flutter::EncodableValue(map));
+          SendEvent(player_id, map);
       });
 
     auto player =
@@ -290,11 +665,37 @@ class AudioplayersElinuxPlugin : public flutter::Plugin {
     audio_players_[player_id] = std::move(player);
   }
 
+  // Called from the workers of the players and, for the events posted on the
+  // bus, from the bus bridge thread. The event is sent from the platform
+  // thread, where |event_sinks_| is used.
+  void SendEvent(const std::string& player_id,
+                 const flutter::EncodableMap& map) {
+    platform_tasks_.Post([this, player_id, map]() {
+      auto iter = event_sinks_.find(player_id);
+      if (iter != event_sinks_.end() && iter->second) {
+        iter->second->Success(flutter::EncodableValue(map));
+      }
+    });
+  }
+
+  // Declared first, so that it is destroyed after the threads that post to
+  // it.
+  PlatformTaskQueue platform_tasks_;
   std::map<std::string, std::unique_ptr<GstAudioPlayer>> audio_players_;
   std::map<std::string,
       std::unique_ptr<flutter::EventSink<flutter::EncodableValue>>>
         event_sinks_;
+  // The order in which the players were last used, and the limit of those
+  // with a live pipeline. Zero is unlimited.
+  std::map<std::string, uint64_t> last_uses_;
+  uint64_t use_count_ = 0;
+  size_t max_live_players_ = 0;
+  PositionTicker position_ticker_;
+  std::unique_ptr<MetadataProber> metadata_prober_;
   flutter::PluginRegistrar* registrar_;
+  PluginStatsChannel plugin_stats_channel_;
+  // Whether GStreamer was initialized for the plugin, on the first call.
+  bool is_gst_library_loaded_ = false;
 };
 
 }  // namespace
@@ -0,0 +1,517 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Plays a sound with 1 to 64 GstAudioPlayers at once, without Flutter, and
+// measures how the latencies and the cost of the players scale in each
+// output mode:
+//  - playbin: a playbin and an audio sink per player,
+//  - shared:  a playbin per player into the shared AudioEngine,
+//  - samples: voices of AudioEngine, decoded once by SampleBank.
+// Prints what it measured as JSON, for regression tracking.
+//
+// $ audioplayers_bench [--players=1,2,4,8,16,32,64]
+//       [--modes=playbin,shared,samples] [--sink=fake|alsa|pulse|pipewire]
+//       [--device=<device>] [--uri=<uri>] [--seeks=5]
+
+#include <dirent.h>
+#include <gst/gst.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio_output.h"
+#include "audio_player_stream_handler.h"
+#include "gst_audio_player.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// The test sources: the short one fits in SampleBank, the long one doesn't.
+constexpr int kShortSourceSeconds = 2;
+constexpr int kLongSourceSeconds = 30;
+constexpr auto kTimeout = std::chrono::seconds(10);
+constexpr auto kPollInterval = std::chrono::milliseconds(1);
+// How far past its target a seek may have played once it's polled.
+constexpr int64_t kSeekToleranceMs = 500;
+
+struct Options {
+  std::vector<int> players = {1, 2, 4, 8, 16, 32, 64};
+  // "playbin", "shared" or "samples".
+  std::vector<std::string> modes = {"playbin", "shared", "samples"};
+  // The sink of the default output profile. "fake" plays in real time
+  // without an audio device.
+  std::string sink = "fake";
+  std::string device;
+  // Played in every mode instead of the test sources if set.
+  std::string uri;
+  int seeks = 5;
+};
+
+// Records when the player has been prepared.
+class BenchStreamHandler : public AudioPlayerStreamHandler {
+ public:
+  // Waits until the player has been prepared, and returns whether it has
+  // succeeded, and when.
+  bool WaitForPrepared(Clock::time_point& prepared_at) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cv_.wait_for(lock, kTimeout, [this]() { return is_notified_; })) {
+      return false;
+    }
+    prepared_at = prepared_at_;
+    return is_prepared_;
+  }
+
+ protected:
+  void OnNotifyPreparedInternal(const std::string&,
+                                const bool is_prepared) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (is_notified_) {
+        return;
+      }
+      is_notified_ = true;
+      is_prepared_ = is_prepared;
+      prepared_at_ = Clock::now();
+    }
+    cv_.notify_all();
+  }
+  void OnNotifyDurationInternal(const std::string&, const int32_t) override {}
+  void OnNotifyCurrentPositionInternal(const std::string&,
+                                       const int64_t) override {}
+  void OnNotifySeekCompletedInternal(const std::string&) override {}
+  void OnNotifyPlayCompletedInternal(const std::string&) override {}
+  void OnNotifyLogInternal(const std::string&,
+                           const std::string& message) override {
+    std::cerr << message << std::endl;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool is_notified_ = false;
+  bool is_prepared_ = false;
+  Clock::time_point prepared_at_;
+};
+
+struct BenchPlayer {
+  BenchStreamHandler* handler;
+  std::unique_ptr<GstAudioPlayer> player;
+};
+
+struct Summary {
+  int64_t p50 = 0;
+  int64_t p95 = 0;
+  int64_t max = 0;
+  int64_t mean = 0;
+  size_t count = 0;
+};
+
+Summary Summarize(std::vector<int64_t> samples) {
+  Summary summary;
+  summary.count = samples.size();
+  if (samples.empty()) {
+    return summary;
+  }
+  std::sort(samples.begin(), samples.end());
+  const auto at = [&samples](size_t percent) {
+    return samples[std::min(samples.size() - 1,
+                            samples.size() * percent / 100)];
+  };
+  summary.p50 = at(50);
+  summary.p95 = at(95);
+  summary.max = samples.back();
+  int64_t total = 0;
+  for (const auto sample : samples) {
+    total += sample;
+  }
+  summary.mean = total / static_cast<int64_t>(samples.size());
+  return summary;
+}
+
+std::string EscapeJson(const std::string& value) {
+  std::string escaped;
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+std::vector<std::string> SplitList(const std::string& value) {
+  std::vector<std::string> items;
+  std::stringstream stream(value);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const auto equal = arg.find('=');
+    const auto name = arg.substr(0, equal);
+    const auto value = equal == std::string::npos ? "" : arg.substr(equal + 1);
+    if (name == "--players") {
+      options.players.clear();
+      for (const auto& item : SplitList(value)) {
+        options.players.push_back(std::atoi(item.c_str()));
+      }
+    } else if (name == "--modes") {
+      options.modes = SplitList(value);
+    } else if (name == "--sink") {
+      options.sink = value;
+    } else if (name == "--device") {
+      options.device = value;
+    } else if (name == "--uri") {
+      options.uri = value;
+    } else if (name == "--seeks") {
+      options.seeks = std::atoi(value.c_str());
+    } else {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return false;
+    }
+  }
+  if (options.players.empty() || options.modes.empty()) {
+    std::cerr << "No players or modes to run" << std::endl;
+    return false;
+  }
+  for (const auto count : options.players) {
+    if (count < 1 || count > 64) {
+      std::cerr << "Invalid player count: " << count << std::endl;
+      return false;
+    }
+  }
+  for (const auto& mode : options.modes) {
+    if (mode != "playbin" && mode != "shared" && mode != "samples") {
+      std::cerr << "Unknown mode: " << mode << std::endl;
+      return false;
+    }
+  }
+  if (options.seeks < 0) {
+    std::cerr << "Invalid seek count" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool RunToEos(GstElement* pipeline) {
+  if (gst_element_set_state(pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    return false;
+  }
+  auto* bus = gst_element_get_bus(pipeline);
+  auto* message = gst_bus_timed_pop_filtered(
+      bus, GST_CLOCK_TIME_NONE,
+      static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  const bool is_eos = message && GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS;
+  if (message) {
+    gst_message_unref(message);
+  }
+  gst_object_unref(bus);
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  return is_eos;
+}
+
+// Writes |seconds| of a sine wave into a temporary WAV file, and returns its
+// URI, or an empty string.
+std::string CreateTestFile(int seconds, std::string& path) {
+  gchar* name = nullptr;
+  GError* error = nullptr;
+  const auto fd =
+      g_file_open_tmp("audioplayers_bench-XXXXXX.wav", &name, &error);
+  if (fd < 0) {
+    std::cerr << "Failed to create a test file: " << error->message
+              << std::endl;
+    g_clear_error(&error);
+    return "";
+  }
+  close(fd);
+  path = name;
+  g_free(name);
+
+  // 100 ms per buffer.
+  const auto description =
+      "audiotestsrc wave=sine samplesperbuffer=4800 num-buffers=" +
+      std::to_string(seconds * 10) +
+      " ! audio/x-raw,format=S16LE,rate=48000,channels=2 ! wavenc"
+      " ! filesink location=\"" +
+      path + "\"";
+  auto* pipeline = gst_parse_launch(description.c_str(), &error);
+  if (!pipeline) {
+    std::cerr << "Failed to make the test file: " << error->message
+              << std::endl;
+    g_clear_error(&error);
+    return "";
+  }
+  const bool ok = RunToEos(pipeline);
+  gst_object_unref(pipeline);
+  if (!ok) {
+    std::cerr << "Failed to make the test file" << std::endl;
+    return "";
+  }
+  auto* uri = gst_filename_to_uri(path.c_str(), nullptr);
+  const std::string result = uri;
+  g_free(uri);
+  return result;
+}
+
+// Runs |function| on the worker of |player| and waits for its result.
+template <typename T>
+T CallOnWorker(GstAudioPlayer* player, std::function<T()> function) {
+  auto promise = std::make_shared<std::promise<T>>();
+  auto future = promise->get_future();
+  player->Post([promise, function]() { promise->set_value(function()); });
+  return future.get();
+}
+
+int64_t GetCurrentPosition(GstAudioPlayer* player) {
+  return CallOnWorker<int64_t>(
+      player, [player]() { return player->GetCurrentPosition(); });
+}
+
+int64_t ElapsedUs(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(to - from)
+      .count();
+}
+
+int64_t GetRssKb() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0;
+  int64_t resident = 0;
+  if (!(statm >> size >> resident)) {
+    return 0;
+  }
+  return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+int GetThreadCount() {
+  auto* dir = opendir("/proc/self/task");
+  if (!dir) {
+    return 0;
+  }
+  int count = 0;
+  while (auto* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      count++;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+void PrintSummary(const char* name, const Summary& summary) {
+  std::printf(
+      "      \"%s\": {\"p50\": %lld, \"p95\": %lld, \"max\": %lld, "
+      "\"mean\": %lld, \"count\": %zu},\n",
+      name, static_cast<long long>(summary.p50),
+      static_cast<long long>(summary.p95),
+      static_cast<long long>(summary.max),
+      static_cast<long long>(summary.mean), summary.count);
+}
+
+struct RunResult {
+  int prepared = 0;
+  int started = 0;
+  std::vector<int64_t> prepare_us;
+  std::vector<int64_t> first_sample_us;
+  std::vector<int64_t> seek_us;
+  double threads_per_player = 0.0;
+  int64_t rss_kb_per_player = 0;
+  int64_t teardown_us = 0;
+};
+
+// Creates |count| players of |mode|, loads and plays |uri| with all of them
+// at once, then seeks them one at a time while the others play.
+RunResult RunPlayers(const Options& options, const std::string& mode,
+                     const std::string& uri, int count) {
+  RunResult result;
+  const auto base_threads = GetThreadCount();
+  const auto base_rss_kb = GetRssKb();
+
+  std::vector<BenchPlayer> players;
+  for (int i = 0; i < count; i++) {
+    auto handler = std::make_unique<BenchStreamHandler>();
+    auto* handler_pointer = handler.get();
+    auto player = std::make_unique<GstAudioPlayer>(
+        mode + "-" + std::to_string(i), std::move(handler));
+    const bool is_shared = mode != "playbin";
+    auto* player_pointer = player.get();
+    player->Post([player_pointer, is_shared]() {
+      player_pointer->SetSharedOutput(is_shared);
+    });
+    players.push_back({handler_pointer, std::move(player)});
+  }
+
+  // SetSourceUrl() to onPrepared, with all the players loading at once.
+  const auto load_start = Clock::now();
+  for (auto& bench_player : players) {
+    auto* player = bench_player.player.get();
+    player->Post([player, uri]() { player->SetSourceUrl(uri); });
+  }
+  for (auto& bench_player : players) {
+    Clock::time_point prepared_at;
+    if (bench_player.handler->WaitForPrepared(prepared_at)) {
+      result.prepared++;
+      result.prepare_us.push_back(ElapsedUs(load_start, prepared_at));
+    }
+  }
+
+  // Resume() to the first advance of the position, which is as close to the
+  // first sample rendered as the player tells.
+  const auto resume_start = Clock::now();
+  for (auto& bench_player : players) {
+    auto* player = bench_player.player.get();
+    player->Post([player]() { player->Resume(); });
+  }
+  std::vector<bool> is_started(players.size(), false);
+  while (result.started < result.prepared &&
+         Clock::now() - resume_start < kTimeout) {
+    for (size_t i = 0; i < players.size(); i++) {
+      if (is_started[i] ||
+          GetCurrentPosition(players[i].player.get()) <= 0) {
+        continue;
+      }
+      is_started[i] = true;
+      result.started++;
+      result.first_sample_us.push_back(ElapsedUs(resume_start, Clock::now()));
+    }
+    std::this_thread::sleep_for(kPollInterval);
+  }
+
+  // Measured while all the players play.
+  result.threads_per_player =
+      static_cast<double>(GetThreadCount() - base_threads) / count;
+  result.rss_kb_per_player = (GetRssKb() - base_rss_kb) / count;
+
+  // Seek() to the position reported at the target, alternating between two
+  // targets so that each seek moves.
+  for (int i = 0; i < options.seeks; i++) {
+    for (size_t j = 0; j < players.size(); j++) {
+      if (!is_started[j]) {
+        continue;
+      }
+      auto* player = players[j].player.get();
+      const auto duration = CallOnWorker<int64_t>(
+          player, [player]() { return player->GetDuration(); });
+      if (duration <= 0) {
+        continue;
+      }
+      const auto target = duration * (i % 2 == 0 ? 1 : 2) / 4;
+      const auto seek_start = Clock::now();
+      player->Post([player, target]() { player->Seek(target); });
+      while (Clock::now() - seek_start < kTimeout) {
+        const auto position = GetCurrentPosition(player);
+        if (position >= target && position < target + kSeekToleranceMs) {
+          result.seek_us.push_back(ElapsedUs(seek_start, Clock::now()));
+          break;
+        }
+        std::this_thread::sleep_for(kPollInterval);
+      }
+    }
+  }
+
+  // Stops and destroys the players, each waiting for its worker.
+  const auto teardown_start = Clock::now();
+  for (auto& bench_player : players) {
+    auto* player = bench_player.player.get();
+    player->Post([player]() { player->Stop(); });
+  }
+  players.clear();
+  result.teardown_us = ElapsedUs(teardown_start, Clock::now());
+  return result;
+}
+
+int Run(const Options& options) {
+  AudioOutput::Profile profile;
+  profile.sink = options.sink;
+  profile.device = options.device;
+  AudioOutput::GetInstance().SetDefaultProfile(profile);
+
+  std::string short_uri = options.uri;
+  std::string long_uri = options.uri;
+  std::string short_file;
+  std::string long_file;
+  if (options.uri.empty()) {
+    short_uri = CreateTestFile(kShortSourceSeconds, short_file);
+    long_uri = CreateTestFile(kLongSourceSeconds, long_file);
+    if (short_uri.empty() || long_uri.empty()) {
+      return 1;
+    }
+  }
+
+  auto ok = true;
+  std::printf("{\n");
+  std::printf("  \"sink\": \"%s\",\n", EscapeJson(options.sink).c_str());
+  std::printf("  \"runs\": [\n");
+  for (size_t i = 0; i < options.modes.size(); i++) {
+    const auto& mode = options.modes[i];
+    const auto& uri = mode == "samples" ? short_uri : long_uri;
+    for (size_t j = 0; j < options.players.size(); j++) {
+      const auto count = options.players[j];
+      const auto result = RunPlayers(options, mode, uri, count);
+      ok = ok && result.prepared == count && result.started == count;
+      std::printf("    {\n");
+      std::printf("      \"mode\": \"%s\",\n", mode.c_str());
+      std::printf("      \"uri\": \"%s\",\n", EscapeJson(uri).c_str());
+      std::printf("      \"players\": %d,\n", count);
+      std::printf("      \"prepared\": %d,\n", result.prepared);
+      std::printf("      \"started\": %d,\n", result.started);
+      PrintSummary("prepare_us", Summarize(result.prepare_us));
+      PrintSummary("first_sample_us", Summarize(result.first_sample_us));
+      PrintSummary("seek_us", Summarize(result.seek_us));
+      std::printf("      \"threads_per_player\": %.2f,\n",
+                  result.threads_per_player);
+      std::printf("      \"rss_kb_per_player\": %lld,\n",
+                  static_cast<long long>(result.rss_kb_per_player));
+      std::printf("      \"teardown_us\": %lld\n",
+                  static_cast<long long>(result.teardown_us));
+      const bool is_last =
+          i + 1 == options.modes.size() && j + 1 == options.players.size();
+      std::printf("    }%s\n", is_last ? "" : ",");
+      std::fflush(stdout);
+    }
+  }
+  std::printf("  ]\n");
+  std::printf("}\n");
+
+  if (!short_file.empty()) {
+    std::remove(short_file.c_str());
+  }
+  if (!long_file.empty()) {
+    std::remove(long_file.c_str());
+  }
+  return ok ? 0 : 1;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    return 2;
+  }
+  GstAudioPlayer::GstLibraryLoad();
+  const auto result = Run(options);
+  GstAudioPlayer::GstLibraryUnload();
+  return result;
+}
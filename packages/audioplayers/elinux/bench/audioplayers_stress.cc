@@ -0,0 +1,680 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Stresses the lifecycle of GstAudioPlayer, without Flutter: creates,
+// loads, plays, seeks, changes the rate of and disposes players from
+// concurrent threads at random times, through their workers as the plugin
+// does, in both the playbin and the shared output modes. Then checks that
+// no pipeline, thread or file descriptor has outlived the players, and
+// prints what it measured as JSON. Exits with 1 if it found a leak, and
+// aborts if an operation hangs, so that it can run under ASan or TSan, see
+// BENCH_SANITIZER in CMakeLists.txt.
+//
+// $ audioplayers_stress [--players=8] [--duration=30] [--uri=<uri>]
+//       [--sink=fake|alsa|pulse|pipewire] [--device=<device>]
+//       [--seed=<seed>] [--hang-timeout=10]
+
+#include <dirent.h>
+#include <gst/gst.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio_output.h"
+#include "audio_player_stream_handler.h"
+#include "gst_audio_player.h"
+#include "gst_runtime.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// The test sources: the short one fits in SampleBank, the long one doesn't.
+constexpr int kShortSourceSeconds = 1;
+constexpr int kLongSourceSeconds = 10;
+// Counts the live pipelines, unless GST_TRACERS is already set.
+constexpr char kLeaksTracer[] = "leaks(filters=GstPipeline)";
+// How long the threads and the pipelines of the disposed players may take
+// to go away.
+constexpr auto kSettleTimeout = std::chrono::seconds(3);
+constexpr int kMaxOperationsPerCycle = 8;
+constexpr int kMaxPauseMs = 100;
+// One in ... cycles disposes the player right after setting its source,
+// while it is still loading.
+constexpr int kEarlyDisposeOdds = 8;
+constexpr double kPlaybackRates[] = {0.25, 0.5, 1.0, 1.5, 2.0};
+
+enum Operation {
+  kCreate,
+  kSetSource,
+  kPrepare,
+  kResume,
+  kPause,
+  kSeek,
+  kSetPlaybackRate,
+  kSetVolume,
+  kGetPosition,
+  kDispose,
+  kOperationCount,
+};
+// The operations on a prepared player, from kResume.
+constexpr int kPlayerOperationCount = kGetPosition - kResume + 1;
+constexpr const char* kOperationNames[] = {
+    "create", "set_source", "prepare", "resume", "pause", "seek",
+    "set_playback_rate", "set_volume", "get_position", "dispose",
+};
+
+struct Options {
+  // The threads creating and disposing players at once.
+  int players = 8;
+  int duration_s = 30;
+  // Played instead of the test sources if set.
+  std::string uri;
+  // The sink of the default output profile. "fake" plays in real time
+  // without an audio device.
+  std::string sink = "fake";
+  std::string device;
+  // Random if zero. Printed, so that a run can be repeated.
+  uint32_t seed = 0;
+  int hang_timeout_s = 10;
+};
+
+// Tells when the player has been prepared.
+class StressStreamHandler : public AudioPlayerStreamHandler {
+ public:
+  // Waits until the player has been prepared, and returns whether it has
+  // succeeded. The watchdog catches a notification that never comes.
+  bool WaitForPrepared() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return is_notified_; });
+    return is_prepared_;
+  }
+
+ protected:
+  void OnNotifyPreparedInternal(const std::string&,
+                                const bool is_prepared) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (is_notified_) {
+        return;
+      }
+      is_notified_ = true;
+      is_prepared_ = is_prepared;
+    }
+    cv_.notify_all();
+  }
+  void OnNotifyDurationInternal(const std::string&, const int32_t) override {}
+  void OnNotifyCurrentPositionInternal(const std::string&,
+                                       const int64_t) override {}
+  void OnNotifySeekCompletedInternal(const std::string&) override {}
+  void OnNotifyPlayCompletedInternal(const std::string&) override {}
+  void OnNotifyLogInternal(const std::string&,
+                           const std::string& message) override {
+    std::cerr << message << std::endl;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool is_notified_ = false;
+  bool is_prepared_ = false;
+};
+
+// A churning thread. The watchdog reads the operation in progress.
+struct Worker {
+  std::atomic<int> operation{-1};
+  std::atomic<int64_t> operation_started_us{0};
+  std::vector<int64_t> latencies_us[kOperationCount];
+  int failures[kOperationCount] = {};
+  int cycles = 0;
+  std::thread thread;
+};
+
+struct Summary {
+  int64_t p50 = 0;
+  int64_t p95 = 0;
+  int64_t p99 = 0;
+  int64_t max = 0;
+  size_t count = 0;
+};
+
+// The resources that outlive the players if they leak.
+struct Resources {
+  int threads = 0;
+  int fds = 0;
+  // -1 if the leaks tracer isn't active.
+  int pipelines = -1;
+  int64_t rss_kb = 0;
+};
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+Summary Summarize(std::vector<int64_t> samples) {
+  Summary summary;
+  summary.count = samples.size();
+  if (samples.empty()) {
+    return summary;
+  }
+  std::sort(samples.begin(), samples.end());
+  const auto at = [&samples](size_t percent) {
+    return samples[std::min(samples.size() - 1,
+                            samples.size() * percent / 100)];
+  };
+  summary.p50 = at(50);
+  summary.p95 = at(95);
+  summary.p99 = at(99);
+  summary.max = samples.back();
+  return summary;
+}
+
+std::string EscapeJson(const std::string& value) {
+  std::string escaped;
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const auto equal = arg.find('=');
+    const auto name = arg.substr(0, equal);
+    const auto value = equal == std::string::npos ? "" : arg.substr(equal + 1);
+    if (name == "--players") {
+      options.players = std::atoi(value.c_str());
+    } else if (name == "--duration") {
+      options.duration_s = std::atoi(value.c_str());
+    } else if (name == "--uri") {
+      options.uri = value;
+    } else if (name == "--sink") {
+      options.sink = value;
+    } else if (name == "--device") {
+      options.device = value;
+    } else if (name == "--seed") {
+      options.seed = static_cast<uint32_t>(std::strtoul(value.c_str(),
+                                                        nullptr, 10));
+    } else if (name == "--hang-timeout") {
+      options.hang_timeout_s = std::atoi(value.c_str());
+    } else {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return false;
+    }
+  }
+  if (options.players < 1 || options.players > 64) {
+    std::cerr << "Invalid player count: " << options.players << std::endl;
+    return false;
+  }
+  if (options.duration_s < 0 || options.hang_timeout_s <= 0) {
+    std::cerr << "Invalid duration or timeout" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool RunToEos(GstElement* pipeline) {
+  if (gst_element_set_state(pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    return false;
+  }
+  auto* bus = gst_element_get_bus(pipeline);
+  auto* message = gst_bus_timed_pop_filtered(
+      bus, GST_CLOCK_TIME_NONE,
+      static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  const bool is_eos = message && GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS;
+  if (message) {
+    gst_message_unref(message);
+  }
+  gst_object_unref(bus);
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  return is_eos;
+}
+
+// Writes |seconds| of a sine wave into a temporary WAV file, and returns its
+// URI, or an empty string.
+std::string CreateTestFile(int seconds, std::string& path) {
+  gchar* name = nullptr;
+  GError* error = nullptr;
+  const auto fd =
+      g_file_open_tmp("audioplayers_stress-XXXXXX.wav", &name, &error);
+  if (fd < 0) {
+    std::cerr << "Failed to create a test file: " << error->message
+              << std::endl;
+    g_clear_error(&error);
+    return "";
+  }
+  close(fd);
+  path = name;
+  g_free(name);
+
+  // 100 ms per buffer.
+  const auto description =
+      "audiotestsrc wave=sine samplesperbuffer=4800 num-buffers=" +
+      std::to_string(seconds * 10) +
+      " ! audio/x-raw,format=S16LE,rate=48000,channels=2 ! wavenc"
+      " ! filesink location=\"" +
+      path + "\"";
+  auto* pipeline = gst_parse_launch(description.c_str(), &error);
+  if (!pipeline) {
+    std::cerr << "Failed to make the test file: " << error->message
+              << std::endl;
+    g_clear_error(&error);
+    return "";
+  }
+  const bool ok = RunToEos(pipeline);
+  gst_object_unref(pipeline);
+  if (!ok) {
+    std::cerr << "Failed to make the test file" << std::endl;
+    return "";
+  }
+  auto* uri = gst_filename_to_uri(path.c_str(), nullptr);
+  const std::string result = uri;
+  g_free(uri);
+  return result;
+}
+
+// Runs |function| on the worker of |player| and waits for its result.
+template <typename T>
+T CallOnWorker(GstAudioPlayer* player, std::function<T()> function) {
+  auto promise = std::make_shared<std::promise<T>>();
+  auto future = promise->get_future();
+  player->Post([promise, function]() { promise->set_value(function()); });
+  return future.get();
+}
+
+// Leak checking.
+
+int CountEntries(const char* path) {
+  auto* dir = opendir(path);
+  if (!dir) {
+    return 0;
+  }
+  int count = 0;
+  while (auto* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      count++;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+int64_t GetRssKb() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0;
+  int64_t resident = 0;
+  if (!(statm >> size >> resident)) {
+    return 0;
+  }
+  return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+int CountLivePipelines() {
+  auto* tracers = gst_tracing_get_active_tracers();
+  int count = -1;
+  for (auto* item = tracers; item; item = item->next) {
+    if (std::strcmp(G_OBJECT_TYPE_NAME(item->data), "GstLeaksTracer") != 0) {
+      continue;
+    }
+    GstStructure* info = nullptr;
+    g_signal_emit_by_name(item->data, "get-live-objects", &info);
+    const auto* objects =
+        info ? gst_structure_get_value(info, "live-objects-list") : nullptr;
+    if (objects) {
+      count = static_cast<int>(gst_value_list_get_size(objects));
+    }
+    if (info) {
+      gst_structure_free(info);
+    }
+    break;
+  }
+  g_list_free_full(tracers, gst_object_unref);
+  return count;
+}
+
+Resources GetResources() {
+  Resources resources;
+  resources.threads = CountEntries("/proc/self/task");
+  // Without the descriptor of the directory itself.
+  resources.fds = CountEntries("/proc/self/fd") - 1;
+  resources.pipelines = CountLivePipelines();
+  resources.rss_kb = GetRssKb();
+  return resources;
+}
+
+bool IsSettled(const Resources& resources, const Resources& baseline) {
+  return resources.threads <= baseline.threads &&
+         resources.fds <= baseline.fds &&
+         resources.pipelines <= baseline.pipelines;
+}
+
+// Waits for the streaming threads of the destroyed pipelines to go away.
+Resources Settle(const Resources& baseline) {
+  const auto end = Clock::now() + kSettleTimeout;
+  while (true) {
+    // Joins the idle threads of the default task pool.
+    gst_task_cleanup_all();
+    const auto resources = GetResources();
+    if (IsSettled(resources, baseline) || Clock::now() >= end) {
+      return resources;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
+// Churning.
+
+template <typename Function>
+bool Measure(Worker& worker, Operation operation, Function function) {
+  const auto start_us = NowUs();
+  worker.operation_started_us = start_us;
+  worker.operation = operation;
+  const bool ok = function();
+  worker.operation = -1;
+  worker.latencies_us[operation].push_back(NowUs() - start_us);
+  if (!ok) {
+    worker.failures[operation]++;
+  }
+  return ok;
+}
+
+// Measures |task| from its posting to its end on the worker of |player|, as
+// the platform thread would wait for a getter.
+bool MeasureOnWorker(Worker& worker, Operation operation,
+                     GstAudioPlayer* player, std::function<void()> task) {
+  return Measure(worker, operation, [player, &task]() {
+    return CallOnWorker<bool>(player, [&task]() {
+      task();
+      return true;
+    });
+  });
+}
+
+void PauseRandomly(std::mt19937& random) {
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(random() % (kMaxPauseMs + 1)));
+}
+
+// Runs the lifecycle of a player once, as the plugin does.
+void RunCycle(Worker& worker, const std::vector<std::string>& uris,
+              bool is_shared, std::mt19937& random, bool is_warm_up) {
+  static std::atomic<int> player_count{0};
+  std::unique_ptr<GstAudioPlayer> player;
+  StressStreamHandler* handler = nullptr;
+  Measure(worker, kCreate, [&]() {
+    auto stream_handler = std::make_unique<StressStreamHandler>();
+    handler = stream_handler.get();
+    player = std::make_unique<GstAudioPlayer>(
+        "stress-" + std::to_string(player_count++),
+        std::move(stream_handler));
+    return true;
+  });
+  auto* target = player.get();
+  const auto& uri = uris[random() % uris.size()];
+  MeasureOnWorker(worker, kSetSource, target, [target, is_shared, uri]() {
+    target->SetSharedOutput(is_shared);
+    target->SetSourceUrl(uri);
+  });
+
+  // Destroys the player off the calling thread, as the plugin does, and
+  // waits for it, so that the leaks are checked after the last one.
+  const auto dispose = [&]() {
+    Measure(worker, kDispose, [&]() {
+      std::promise<void> destroyed;
+      auto future = destroyed.get_future();
+      GstRuntime::RunTask(
+          [disposed = std::shared_ptr<GstAudioPlayer>(std::move(player)),
+           &destroyed]() mutable {
+            disposed.reset();
+            destroyed.set_value();
+          });
+      future.get();
+      return true;
+    });
+    worker.cycles++;
+  };
+  if (!is_warm_up && random() % kEarlyDisposeOdds == 0) {
+    dispose();
+    return;
+  }
+
+  if (!Measure(worker, kPrepare, [handler]() {
+        return handler->WaitForPrepared();
+      })) {
+    dispose();
+    return;
+  }
+  MeasureOnWorker(worker, kResume, target, [target]() { target->Resume(); });
+
+  // The warm-up runs every operation once.
+  const auto operations =
+      is_warm_up ? kPlayerOperationCount
+                 : 1 + static_cast<int>(random() % kMaxOperationsPerCycle);
+  for (int i = 0; i < operations; i++) {
+    PauseRandomly(random);
+    const auto operation =
+        kResume + (is_warm_up
+                       ? i
+                       : static_cast<int>(random() % kPlayerOperationCount));
+    switch (operation) {
+      case kResume:
+        MeasureOnWorker(worker, kResume, target,
+                        [target]() { target->Resume(); });
+        break;
+      case kPause:
+        MeasureOnWorker(worker, kPause, target,
+                        [target]() { target->Pause(); });
+        break;
+      case kSeek: {
+        const auto fraction = random() % 100;
+        MeasureOnWorker(worker, kSeek, target, [target, fraction]() {
+          const auto duration = target->GetDuration();
+          target->Seek(duration > 0 ? duration * fraction / 100 : 0);
+        });
+        break;
+      }
+      case kSetPlaybackRate: {
+        constexpr auto kRateCount =
+            sizeof(kPlaybackRates) / sizeof(kPlaybackRates[0]);
+        const auto rate = kPlaybackRates[random() % kRateCount];
+        MeasureOnWorker(worker, kSetPlaybackRate, target,
+                        [target, rate]() { target->SetPlaybackRate(rate); });
+        break;
+      }
+      case kSetVolume: {
+        const auto volume = (random() % 101) / 100.0;
+        MeasureOnWorker(worker, kSetVolume, target,
+                        [target, volume]() { target->SetVolume(volume); });
+        break;
+      }
+      default:
+        MeasureOnWorker(worker, kGetPosition, target,
+                        [target]() { target->GetCurrentPosition(); });
+        break;
+    }
+  }
+  PauseRandomly(random);
+  dispose();
+}
+
+// Aborts if an operation takes longer than |timeout_us|, so that a hang
+// leaves a core dump, or the report of the sanitizer.
+void RunWatchdog(std::vector<Worker>& workers, int64_t timeout_us,
+                 std::atomic<bool>& is_done) {
+  while (!is_done) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto now_us = NowUs();
+    for (size_t i = 0; i < workers.size(); i++) {
+      const auto started_us = workers[i].operation_started_us.load();
+      const auto operation = workers[i].operation.load();
+      if (operation >= 0 && now_us - started_us > timeout_us) {
+        std::cerr << "Player " << i << " has hung in "
+                  << kOperationNames[operation] << " for "
+                  << (now_us - started_us) / 1000 << " ms" << std::endl;
+        std::abort();
+      }
+    }
+  }
+}
+
+void PrintSummary(const char* name, const Summary& summary, int failures,
+                  const char* separator) {
+  std::printf(
+      "    \"%s\": {\"p50\": %lld, \"p95\": %lld, \"p99\": %lld, \"max\": "
+      "%lld, \"count\": %zu, \"failures\": %d}%s\n",
+      name, static_cast<long long>(summary.p50),
+      static_cast<long long>(summary.p95),
+      static_cast<long long>(summary.p99),
+      static_cast<long long>(summary.max), summary.count, failures,
+      separator);
+}
+
+int Run(const Options& options) {
+  AudioOutput::Profile profile;
+  profile.sink = options.sink;
+  profile.device = options.device;
+  AudioOutput::GetInstance().SetDefaultProfile(profile);
+
+  const auto seed = options.seed ? options.seed : std::random_device()();
+  std::mt19937 random(seed);
+  std::vector<std::string> uris;
+  std::vector<std::string> test_files;
+  if (!options.uri.empty()) {
+    uris.push_back(options.uri);
+  } else {
+    for (const auto seconds : {kShortSourceSeconds, kLongSourceSeconds}) {
+      std::string path;
+      const auto uri = CreateTestFile(seconds, path);
+      if (!path.empty()) {
+        test_files.push_back(path);
+      }
+      if (uri.empty()) {
+        for (const auto& file : test_files) {
+          std::remove(file.c_str());
+        }
+        return 1;
+      }
+      uris.push_back(uri);
+    }
+  }
+
+  std::vector<Worker> workers(options.players);
+  std::atomic<bool> is_done{false};
+  std::thread watchdog(RunWatchdog, std::ref(workers),
+                       static_cast<int64_t>(options.hang_timeout_s) * 1000000,
+                       std::ref(is_done));
+
+  // The first players load the plugins and start the shared threads and
+  // the shared output, which aren't leaks.
+  const auto before = GetResources();
+  for (const auto is_shared : {false, true}) {
+    Worker warm_up;
+    RunCycle(warm_up, uris, is_shared, random, true);
+  }
+  const auto baseline = Settle(before);
+
+  const auto start = Clock::now();
+  const auto end = start + std::chrono::seconds(options.duration_s);
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i].thread = std::thread([&, i]() {
+      std::mt19937 worker_random(seed + static_cast<uint32_t>(i) + 1);
+      // Spreads the first cycles.
+      PauseRandomly(worker_random);
+      while (Clock::now() < end) {
+        RunCycle(workers[i], uris, worker_random() % 2 == 0, worker_random,
+                 false);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.thread.join();
+  }
+  const auto elapsed_s =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  const auto after = Settle(baseline);
+  is_done = true;
+  watchdog.join();
+
+  int cycles = 0;
+  std::vector<int64_t> latencies_us[kOperationCount];
+  int failures[kOperationCount] = {};
+  for (const auto& worker : workers) {
+    cycles += worker.cycles;
+    for (int i = 0; i < kOperationCount; i++) {
+      latencies_us[i].insert(latencies_us[i].end(),
+                             worker.latencies_us[i].begin(),
+                             worker.latencies_us[i].end());
+      failures[i] += worker.failures[i];
+    }
+  }
+  const auto leaked_threads = after.threads - baseline.threads;
+  const auto leaked_fds = after.fds - baseline.fds;
+  // Unknown without the leaks tracer.
+  const auto leaked_pipelines = after.pipelines >= 0 && baseline.pipelines >= 0
+                                    ? after.pipelines - baseline.pipelines
+                                    : -1;
+
+  std::printf("{\n");
+  std::printf("  \"sink\": \"%s\",\n", EscapeJson(options.sink).c_str());
+  std::printf("  \"seed\": %u,\n", seed);
+  std::printf("  \"players\": %d,\n", options.players);
+  std::printf("  \"duration_s\": %.3f,\n", elapsed_s);
+  std::printf("  \"cycles\": %d,\n", cycles);
+  std::printf("  \"latency_us\": {\n");
+  for (int i = 0; i < kOperationCount; i++) {
+    PrintSummary(kOperationNames[i], Summarize(latencies_us[i]), failures[i],
+                 i + 1 < kOperationCount ? "," : "");
+  }
+  std::printf("  },\n");
+  std::printf("  \"leaked_threads\": %d,\n", leaked_threads);
+  std::printf("  \"leaked_fds\": %d,\n", leaked_fds);
+  std::printf("  \"leaked_pipelines\": %d,\n", leaked_pipelines);
+  std::printf("  \"rss_growth_kb\": %lld\n",
+              static_cast<long long>(after.rss_kb - baseline.rss_kb));
+  std::printf("}\n");
+
+  for (const auto& file : test_files) {
+    std::remove(file.c_str());
+  }
+  return leaked_threads > 0 || leaked_fds > 0 || leaked_pipelines > 0 ||
+                 (options.duration_s > 0 && cycles == 0)
+             ? 1
+             : 0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    return 2;
+  }
+  // Read by gst_init().
+  setenv("GST_TRACERS", kLeaksTracer, 0);
+  GstAudioPlayer::GstLibraryLoad();
+  const auto result = Run(options);
+  GstAudioPlayer::GstLibraryUnload();
+  return result;
+}
@@ -0,0 +1,192 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "download_cache.h"
+
+#include <fcntl.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+namespace {
+constexpr char kCacheName[] = "audioplayers_elinux";
+constexpr char kMediaSuffix[] = ".media";
+constexpr char kPartSuffix[] = ".part";
+// Temporary files left over by a crash are removed after this long.
+constexpr time_t kStalePartSeconds = 60 * 60;
+
+bool HasSuffix(const char* name, const char* suffix) {
+  const auto length = std::strlen(name);
+  const auto suffix_length = std::strlen(suffix);
+  return length >= suffix_length &&
+         std::strcmp(name + length - suffix_length, suffix) == 0;
+}
+}  // namespace
+
+// static
+DownloadCache& DownloadCache::GetInstance() {
+  static DownloadCache instance;
+  return instance;
+}
+
+void DownloadCache::Configure(const Settings& settings) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  settings_ = settings;
+  if (settings_.directory.empty()) {
+    auto* directory = g_build_filename(g_get_user_cache_dir(), kCacheName,
+                                       "downloads", nullptr);
+    directory_ = directory;
+    g_free(directory);
+  } else {
+    directory_ = settings_.directory;
+  }
+  if (settings_.max_size_bytes > 0 && EnsureDirectory()) {
+    Trim();
+  }
+}
+
+DownloadCache::Settings DownloadCache::GetSettings() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return settings_;
+}
+
+bool DownloadCache::IsEnabled() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return settings_.max_size_bytes > 0;
+}
+
+// static
+bool DownloadCache::IsNetworkUri(const std::string& uri) {
+  return g_str_has_prefix(uri.c_str(), "http://") ||
+         g_str_has_prefix(uri.c_str(), "https://");
+}
+
+std::string DownloadCache::Lookup(const std::string& uri) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (settings_.max_size_bytes <= 0 || !IsNetworkUri(uri)) {
+    return std::string();
+  }
+  const auto path = GetPath(uri);
+  // The access time, which is set explicitly whatever the mount options,
+  // orders the downloads for eviction.
+  const struct timespec times[2] = {{0, UTIME_NOW}, {0, UTIME_OMIT}};
+  if (utimensat(AT_FDCWD, path.c_str(), times, 0) != 0) {
+    return std::string();
+  }
+  auto* file_uri = g_filename_to_uri(path.c_str(), nullptr, nullptr);
+  if (!file_uri) {
+    return std::string();
+  }
+  std::string result(file_uri);
+  g_free(file_uri);
+  return result;
+}
+
+std::string DownloadCache::GetTemporaryTemplate(const std::string& uri) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (settings_.max_size_bytes <= 0 || !IsNetworkUri(uri) ||
+      !EnsureDirectory()) {
+    return std::string();
+  }
+  // queue2 replaces the trailing X's to make the name unique.
+  return GetPath(uri) + kPartSuffix + ".XXXXXX";
+}
+
+bool DownloadCache::Commit(const std::string& uri,
+                           const std::string& temporary_location,
+                           int64_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (settings_.max_size_bytes <= 0) {
+    return false;
+  }
+  struct stat file_stat;
+  if (stat(temporary_location.c_str(), &file_stat) != 0 ||
+      file_stat.st_size == 0 || (size >= 0 && file_stat.st_size != size)) {
+    return false;
+  }
+  if (file_stat.st_size > settings_.max_size_bytes) {
+    std::cerr << uri << " is larger than the download cache" << std::endl;
+    return false;
+  }
+
+  // A hard link leaves the temporary file to queue2, which removes it when
+  // the stream stops.
+  const auto path = GetPath(uri);
+  g_remove(path.c_str());
+  if (link(temporary_location.c_str(), path.c_str()) != 0) {
+    std::cerr << "Failed to cache the download of " << uri << ": "
+              << std::strerror(errno) << std::endl;
+    return false;
+  }
+  Trim();
+  return true;
+}
+
+std::string DownloadCache::GetPath(const std::string& uri) const {
+  auto* checksum =
+      g_compute_checksum_for_string(G_CHECKSUM_SHA1, uri.c_str(), -1);
+  const auto path = directory_ + "/" + checksum + kMediaSuffix;
+  g_free(checksum);
+  return path;
+}
+
+bool DownloadCache::EnsureDirectory() {
+  if (g_mkdir_with_parents(directory_.c_str(), 0700) != 0) {
+    std::cerr << "Failed to create the download cache " << directory_
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void DownloadCache::Trim() {
+  struct Entry {
+    std::string path;
+    int64_t size;
+    time_t used;
+  };
+
+  auto* dir = g_dir_open(directory_.c_str(), 0, nullptr);
+  if (!dir) {
+    return;
+  }
+  std::vector<Entry> entries;
+  int64_t total_size = 0;
+  const auto now = time(nullptr);
+  while (const auto* name = g_dir_read_name(dir)) {
+    const auto path = directory_ + "/" + name;
+    struct stat file_stat;
+    if (stat(path.c_str(), &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+      continue;
+    }
+    if (HasSuffix(name, kMediaSuffix)) {
+      entries.push_back({path, file_stat.st_size, file_stat.st_atime});
+      total_size += file_stat.st_size;
+    } else if (std::strstr(name, kPartSuffix) &&
+               now - file_stat.st_mtime > kStalePartSeconds) {
+      g_remove(path.c_str());
+    }
+  }
+  g_dir_close(dir);
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.used < b.used; });
+  for (const auto& entry : entries) {
+    if (total_size <= settings_.max_size_bytes) {
+      break;
+    }
+    // A player still reading the file keeps its data until it closes it.
+    if (g_remove(entry.path.c_str()) == 0) {
+      total_size -= entry.size;
+    }
+  }
+}
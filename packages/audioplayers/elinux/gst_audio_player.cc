@@ -4,13 +4,32 @@
 
 #include "gst_audio_player.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 
+#include "asset_cache.h"
+#include "download_cache.h"
+#include "gst_runtime.h"
+#include "plugin_log.h"
+#include "sample_bank.h"
+
+namespace {
+// GST_PLAY_FLAG_DOWNLOAD of playbin, which has no public header.
+constexpr guint kPlayFlagDownload = 1 << 7;
+// How often the worker ramps the volumes of a crossfade.
+constexpr auto kCrossfadeInterval = std::chrono::milliseconds(20);
+// Bounds the preroll of a suspended pipeline, e.g. of a slow HTTP source.
+constexpr GstClockTime kRestoreTimeout = 5 * GST_SECOND;
+}  // namespace
+
 GstAudioPlayer::GstAudioPlayer(
     const std::string &player_id,
     std::unique_ptr<AudioPlayerStreamHandler> handler)
     : player_id_(player_id),
     stream_handler_(std::move(handler)) {
+  stats_.SetId(player_id_);
   gst_.playbin = nullptr;
   gst_.bus = nullptr;
   gst_.source = nullptr;
@@ -19,6 +38,8 @@ GstAudioPlayer::GstAudioPlayer(
   gst_.audiosink = nullptr;
   gst_.panoramasinkpad = nullptr;
 
+  worker_ = std::thread([this]() { RunWorker(); });
+
   if (!CreatePipeline()) {
     std::cerr << "Failed to create a pipeline" << std::endl;
     Dispose();
@@ -27,15 +48,136 @@ GstAudioPlayer::GstAudioPlayer(
 }
 
 GstAudioPlayer::~GstAudioPlayer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_worker_);
+    is_worker_stopped_ = true;
+  }
+  worker_cv_.notify_one();
+  worker_.join();
   Stop();
   Dispose();
 }
 
+void GstAudioPlayer::Post(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_worker_);
+    tasks_.push_back(std::move(task));
+  }
+  worker_cv_.notify_one();
+}
+
+void GstAudioPlayer::PostPositionUpdate() {
+  if (is_position_update_pending_.exchange(true)) {
+    return;
+  }
+  Post([this]() {
+    is_position_update_pending_ = false;
+    if (!is_initialized_ || !is_playing_) {
+      return;
+    }
+    const auto position = GetCurrentPosition();
+    if (position >= 0) {
+      stream_handler_->OnNotifyCurrentPosition(player_id_, position);
+    }
+  });
+}
+
+void GstAudioPlayer::PostSuspend() {
+  if (is_suspended_.exchange(true)) {
+    return;
+  }
+  Post([this]() { Suspend(); });
+}
+
+void GstAudioPlayer::Wake() {
+  if (!is_suspended_.exchange(false)) {
+    return;
+  }
+  Post([this]() { RestorePipeline(); });
+}
+
+void GstAudioPlayer::Suspend() {
+  // Woken, or started playing, since it was posted.
+  if (!is_suspended_ || is_pipeline_suspended_) {
+    return;
+  }
+  if (is_playing_ || fading_.playbin || is_preparing_) {
+    is_suspended_ = false;
+    return;
+  }
+  // Nothing is resident, e.g. for a source played from SampleBank.
+  if (!gst_.playbin || GST_STATE_TARGET(gst_.playbin) <= GST_STATE_READY) {
+    return;
+  }
+  suspended_position_ = std::max<int64_t>(GetCurrentPosition(), 0);
+  suspended_duration_ = GetDuration();
+  gst_bus_set_flushing(gst_.bus, TRUE);
+  gst_element_set_state(gst_.playbin, GST_STATE_NULL);
+  is_pipeline_suspended_ = true;
+}
+
+void GstAudioPlayer::RestorePipeline() {
+  is_suspended_ = false;
+  if (!is_pipeline_suspended_) {
+    return;
+  }
+  is_pipeline_suspended_ = false;
+  // Waits for the preroll, so that the position can be restored before the
+  // next call, e.g. a resume, runs.
+  const auto result =
+      gst_element_set_state(gst_.playbin, GST_STATE_PAUSED) ==
+              GST_STATE_CHANGE_FAILURE
+          ? GST_STATE_CHANGE_FAILURE
+          : gst_element_get_state(gst_.playbin, nullptr, nullptr,
+                                  kRestoreTimeout);
+  if (result == GST_STATE_CHANGE_FAILURE || result == GST_STATE_CHANGE_ASYNC) {
+    std::cerr << "Failed to restore the pipeline of " << url_ << std::endl;
+    return;
+  }
+  if (suspended_position_ > 0 &&
+      !gst_element_seek(
+          gst_.playbin, playback_rate_, GST_FORMAT_TIME,
+          (GstSeekFlags)(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE),
+          GST_SEEK_TYPE_SET, suspended_position_ * GST_MSECOND,
+          GST_SEEK_TYPE_SET, GST_CLOCK_TIME_NONE)) {
+    std::cerr << "Failed to restore the position of " << url_ << std::endl;
+  }
+}
+
+void GstAudioPlayer::RunWorker() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_worker_);
+      const auto has_task = [this]() {
+        return is_worker_stopped_ || !tasks_.empty();
+      };
+      if (IsCrossfadePolled()) {
+        if (!worker_cv_.wait_for(lock, kCrossfadeInterval, has_task)) {
+          lock.unlock();
+          UpdateCrossfade();
+          continue;
+        }
+      } else {
+        worker_cv_.wait(lock, has_task);
+      }
+      // The tasks left are dropped along with the player.
+      if (is_worker_stopped_) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    TRACE_SCOPE(trace_track_, "worker task");
+    task();
+  }
+}
+
 // static
-void GstAudioPlayer::GstLibraryLoad() { gst_init(NULL, NULL); }
+void GstAudioPlayer::GstLibraryLoad() { GstRuntime::Acquire(); }
 
 // static
-void GstAudioPlayer::GstLibraryUnload() { gst_deinit(); }
+void GstAudioPlayer::GstLibraryUnload() { GstRuntime::Release(); }
 
 // Creates a audio playbin.
 // $ playbin uri=<file>
@@ -50,7 +192,7 @@ bool GstAudioPlayer::CreatePipeline() {
   gst_.panorama = gst_element_factory_make("audiopanorama", "audiopanorama");
   if (gst_.panorama) {
     gst_.audiobin = gst_bin_new(NULL);
-    gst_.audiosink = gst_element_factory_make("autoaudiosink", "autoaudiosink");
+    gst_.audiosink = AudioOutput::CreateSink(GetOutputProfile());
 
     gst_bin_add_many(GST_BIN(gst_.audiobin), gst_.panorama, gst_.audiosink, NULL);
     gst_element_link(gst_.panorama, gst_.audiosink);
@@ -67,10 +209,17 @@ bool GstAudioPlayer::CreatePipeline() {
   // Setup source options
   g_signal_connect(gst_.playbin, "source-setup",
                    G_CALLBACK(GstAudioPlayer::SourceSetup), &gst_.source);
+  g_signal_connect(gst_.playbin, "deep-element-added",
+                   G_CALLBACK(GstAudioPlayer::OnDeepElementAdded), this);
+  g_signal_connect(gst_.playbin, "about-to-finish",
+                   G_CALLBACK(GstAudioPlayer::OnAboutToFinish), this);
 
   // Watch bus messages for one time events
   gst_.bus = gst_pipeline_get_bus(GST_PIPELINE(gst_.playbin));
   gst_bus_set_sync_handler(gst_.bus, HandleGstMessage, this, NULL);
+  bus_watch_id_ = GstBusBridge::GetInstance().Watch(
+      gst_.bus,
+      [this](GstMessage* message) { HandleAsyncGstMessage(message); });
 
   return true;
 }
@@ -84,6 +233,146 @@ void GstAudioPlayer::SourceSetup(GstElement* playbin,
       G_OBJECT_GET_CLASS(source), "ssl-strict") != 0) {
     g_object_set(G_OBJECT(source), "ssl-strict", FALSE, NULL);
   }
+  AssetCache::GetInstance().ConfigureSource(source);
+}
+
+// static
+void GstAudioPlayer::OnAboutToFinish(GstElement* playbin, gpointer user_data) {
+  auto* self = reinterpret_cast<GstAudioPlayer*>(user_data);
+  std::lock_guard<std::mutex> lock(self->mutex_next_);
+  if (self->gapless_uri_.empty()) {
+    return;
+  }
+  // playbin plays the new URI right after the current one, and posts
+  // STREAM_START once it does.
+  g_object_set(G_OBJECT(playbin), "uri", self->gapless_uri_.c_str(), NULL);
+  self->is_advance_pending_ = true;
+}
+
+// static
+void GstAudioPlayer::OnDeepElementAdded(GstBin* bin, GstBin* sub_bin,
+                                        GstElement* element,
+                                        gpointer user_data) {
+  auto* factory = gst_element_get_factory(element);
+  if (!factory) {
+    return;
+  }
+  auto* self = reinterpret_cast<GstAudioPlayer*>(user_data);
+  const auto* klass =
+      gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+  if (klass && strstr(klass, "Decoder") && strstr(klass, "Audio")) {
+    self->stats_.SetDecoder(GST_OBJECT_NAME(factory));
+    return;
+  }
+  if (g_strcmp0(GST_OBJECT_NAME(factory), "queue2") != 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(self->mutex_download_);
+  if (self->download_url_.empty() || self->download_queue_) {
+    return;
+  }
+  // uridecodebin gives a temp-template only to the queue2 downloading the
+  // stream, before adding it.
+  gchar* default_template = nullptr;
+  g_object_get(G_OBJECT(element), "temp-template", &default_template, NULL);
+  if (!default_template) {
+    return;
+  }
+  g_free(default_template);
+  const auto temp_template =
+      DownloadCache::GetInstance().GetTemporaryTemplate(self->download_url_);
+  if (temp_template.empty()) {
+    return;
+  }
+  g_object_set(G_OBJECT(element), "temp-template", temp_template.c_str(),
+               "temp-remove", TRUE, NULL);
+  self->download_queue_ = GST_ELEMENT(gst_object_ref(element));
+}
+
+std::string GstAudioPlayer::PrepareDownload(const std::string& url) {
+  std::string uri = url;
+  bool is_downloading = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_download_);
+    download_url_.clear();
+    if (download_queue_) {
+      gst_object_unref(download_queue_);
+      download_queue_ = nullptr;
+    }
+    is_download_committed_ = false;
+    auto& cache = DownloadCache::GetInstance();
+    const auto cached_uri = cache.Lookup(url);
+    if (!cached_uri.empty()) {
+      uri = cached_uri;
+    } else if (cache.IsEnabled() && DownloadCache::IsNetworkUri(url)) {
+      download_url_ = url;
+      is_downloading = true;
+    }
+  }
+
+  guint flags = 0;
+  g_object_get(G_OBJECT(gst_.playbin), "flags", &flags, NULL);
+  if (is_downloading) {
+    flags |= kPlayFlagDownload;
+  } else {
+    flags &= ~kPlayFlagDownload;
+  }
+  // -1 is the default of playbin for both.
+  const auto settings = DownloadCache::GetInstance().GetSettings();
+  const gint64 buffer_duration = settings.buffer_duration_ms > 0
+                                     ? settings.buffer_duration_ms * GST_MSECOND
+                                     : -1;
+  const gint buffer_size =
+      settings.buffer_size_bytes > 0 ? settings.buffer_size_bytes : -1;
+  g_object_set(G_OBJECT(gst_.playbin), "flags", flags, "buffer-duration",
+               buffer_duration, "buffer-size", buffer_size, NULL);
+  return uri;
+}
+
+void GstAudioPlayer::CommitDownload() {
+  std::lock_guard<std::mutex> lock(mutex_download_);
+  if (!download_queue_ || is_download_committed_) {
+    return;
+  }
+  auto* query = gst_query_new_buffering(GST_FORMAT_PERCENT);
+  gint64 start = 0;
+  gint64 stop = 0;
+  const bool is_complete =
+      gst_element_query(download_queue_, query) &&
+      gst_query_get_n_buffering_ranges(query) == 1 &&
+      gst_query_parse_nth_buffering_range(query, 0, &start, &stop) &&
+      start == 0 && stop >= GST_FORMAT_PERCENT_MAX;
+  gst_query_unref(query);
+  if (!is_complete) {
+    return;
+  }
+
+  gchar* location = nullptr;
+  g_object_get(G_OBJECT(download_queue_), "temp-location", &location, NULL);
+  if (!location) {
+    return;
+  }
+  // The server tells the size, unless the stream is chunked.
+  gint64 size = -1;
+  if (!gst_element_query_duration(download_queue_, GST_FORMAT_BYTES, &size)) {
+    size = -1;
+  }
+  is_download_committed_ =
+      DownloadCache::GetInstance().Commit(download_url_, location, size);
+  g_free(location);
+}
+
+void GstAudioPlayer::PinLoopingAsset() {
+  if (!gst_.playbin) {
+    return;
+  }
+  GstElement* source = nullptr;
+  g_object_get(G_OBJECT(gst_.playbin), "source", &source, NULL);
+  if (!source) {
+    return;
+  }
+  AssetCache::GetInstance().Pin(source);
+  gst_object_unref(source);
 }
 
 std::string GstAudioPlayer::ParseUri(const std::string& uri) {
@@ -103,6 +392,7 @@ std::string GstAudioPlayer::ParseUri(const std::string& uri) {
 }
 
 void GstAudioPlayer::Resume() {
+  TRACE_SCOPE(trace_track_, "Resume");
   if (!is_playing_) {
     is_playing_ = true;
   }
@@ -111,6 +401,22 @@ void GstAudioPlayer::Resume() {
     return;
   }
 
+  if (samples_) {
+    auto& engine = AudioEngine::GetInstance();
+    if (voice_id_ && engine.GetVoicePosition(voice_id_) >= 0) {
+      return;
+    }
+    // A voice that has ended starts over.
+    if (voice_id_) {
+      voice_position_ = 0;
+    }
+    voice_id_ = engine.StartVoice(
+        samples_, voice_position_, GetVoiceSettings(),
+        [this]() { stream_handler_->OnNotifyPlayCompleted(player_id_); });
+    stream_handler_->OnNotifyDuration(player_id_, GetDuration());
+    return;
+  }
+
   if (gst_element_set_state(gst_.playbin, GST_STATE_PLAYING) ==
       GST_STATE_CHANGE_FAILURE) {
     std::cerr << "Unable to set the pipeline to GST_STATE_PLAYING" << std::endl;
@@ -126,12 +432,22 @@ void GstAudioPlayer::Play() {
 }
 
 void GstAudioPlayer::Pause() {
+  TRACE_SCOPE(trace_track_, "Pause");
+  FinishCrossfade();
   if (is_playing_) {
     is_playing_ = false;
   }
   if (!is_initialized_) {
     return;
   }
+  if (samples_) {
+    if (voice_id_) {
+      voice_position_ =
+          std::max<int64_t>(AudioEngine::GetInstance().StopVoice(voice_id_), 0);
+      voice_id_ = 0;
+    }
+    return;
+  }
   if (gst_element_set_state(gst_.playbin, GST_STATE_PAUSED) ==
       GST_STATE_CHANGE_FAILURE) {
     std::cerr << "Failed to change the state to PAUSED" << std::endl;
@@ -148,9 +464,23 @@ void GstAudioPlayer::Stop() {
 }
 
 void GstAudioPlayer::Seek(int64_t position) {
+  TRACE_SCOPE(trace_track_, "Seek");
+  FinishCrossfade();
   if (!is_initialized_) {
     return;
   }
+  if (samples_) {
+    voice_position_ = std::max<int64_t>(position, 0);
+    if (voice_id_) {
+      auto& engine = AudioEngine::GetInstance();
+      engine.StopVoice(voice_id_);
+      voice_id_ = engine.StartVoice(
+          samples_, voice_position_, GetVoiceSettings(),
+          [this]() { stream_handler_->OnNotifyPlayCompleted(player_id_); });
+    }
+    stream_handler_->OnNotifySeekCompleted(player_id_);
+    return;
+  }
   auto nanosecond = position * 1000 * 1000;
   if (!gst_element_seek(
           gst_.playbin, playback_rate_, GST_FORMAT_TIME,
@@ -164,27 +494,53 @@ void GstAudioPlayer::Seek(int64_t position) {
 }
 
 void GstAudioPlayer::SetSourceUrl(std::string url) {
+  TRACE_SCOPE(trace_track_, "SetSourceUrl");
+  auto is_prepared = true;
+  // The same source loaded again is prepared, unless it's still prerolling.
+  auto is_notified_on_bus = url_ == url && is_preparing_;
+  if (url_ == url && is_pipeline_suspended_) {
+    RestorePipeline();
+  }
   if (url_ != url) {
+    FinishCrossfade();
     url_ = url;
+    is_pipeline_suspended_ = false;
+    is_suspended_ = false;
+    is_loaded_ = !url_.empty();
+    ReleaseSamples();
+    is_preparing_ = false;
+    is_advance_pending_ = false;
 
     // flush unhandled messeges
     gst_bus_set_flushing(gst_.bus, TRUE);
     gst_element_set_state(gst_.playbin, GST_STATE_NULL);
     is_playing_ = false;
-    if (!url_.empty()) {
-      g_object_set(GST_OBJECT(gst_.playbin), "uri", url_.c_str(), NULL);
-      if (gst_.playbin->current_state != GST_STATE_READY) {
-        GstStateChangeReturn ret =
-            gst_element_set_state(gst_.playbin, GST_STATE_READY);
-        if (ret == GST_STATE_CHANGE_FAILURE) {
-          std::cerr <<
-            "Unable to set the pipeline to GST_STATE_READY." << std::endl;
-        }
+    if (is_output_pending_) {
+      ApplyOutput();
+    }
+    if (!url_.empty() && !(is_shared_output_ && LoadSamples(url_))) {
+      const auto uri = PrepareDownload(url_);
+      g_object_set(GST_OBJECT(gst_.playbin), "uri", uri.c_str(), NULL);
+      // Prerolls in the background. onPrepared is sent once it's done, or
+      // on an error.
+      is_preparing_ = true;
+      if (gst_element_set_state(gst_.playbin, GST_STATE_PAUSED) ==
+          GST_STATE_CHANGE_FAILURE) {
+        std::cerr << "Unable to set the pipeline to GST_STATE_PAUSED."
+                  << std::endl;
+        is_prepared = false;
+        // Unless an error on the bus has been notified already.
+        is_notified_on_bus = !is_preparing_.exchange(false);
+      } else {
+        is_notified_on_bus = true;
       }
     }
     is_initialized_ = true;
+    UpdateNextUri();
+  }
+  if (!is_notified_on_bus) {
+    stream_handler_->OnNotifyPrepared(player_id_, is_prepared);
   }
-  stream_handler_->OnNotifyPrepared(player_id_, true);
 }
 
 void GstAudioPlayer::SetVolume(double volume) {
@@ -195,19 +551,26 @@ void GstAudioPlayer::SetVolume(double volume) {
   }
   volume_ = volume;
   g_object_set(gst_.playbin, "volume", volume, NULL);
+  if (voice_id_) {
+    AudioEngine::GetInstance().UpdateVoice(voice_id_, GetVoiceSettings());
+  }
 }
 
 void GstAudioPlayer::SetBalance(double balance) {
-  if (!gst_.panorama) {
-    std::cerr << "Audiopanorama was not initialized" << std::endl;
-    return;
-  }
-
   if (balance > 1.0) {
     balance = 1.0;
   } else if (balance < -1.0) {
     balance = -1.0;
   }
+  balance_ = balance;
+  if (voice_id_) {
+    AudioEngine::GetInstance().UpdateVoice(voice_id_, GetVoiceSettings());
+  }
+
+  if (!gst_.panorama) {
+    std::cerr << "Audiopanorama was not initialized" << std::endl;
+    return;
+  }
   g_object_set(G_OBJECT(gst_.panorama), "panorama", balance, NULL);
 }
 
@@ -220,6 +583,13 @@ void GstAudioPlayer::SetPlaybackRate(double playback_rate) {
   if (!is_initialized_) {
     return;
   }
+  if (samples_) {
+    playback_rate_ = playback_rate;
+    if (voice_id_) {
+      AudioEngine::GetInstance().UpdateVoice(voice_id_, GetVoiceSettings());
+    }
+    return;
+  }
   int64_t position = GetCurrentPosition();
   if (!gst_element_seek(gst_.playbin, playback_rate, GST_FORMAT_TIME,
                         GST_SEEK_FLAG_FLUSH, GST_SEEK_TYPE_SET,
@@ -235,9 +605,287 @@ void GstAudioPlayer::SetPlaybackRate(double playback_rate) {
 
 void GstAudioPlayer::SetLooping(bool is_looping) {
   is_looping_ = is_looping;
+  if (voice_id_) {
+    AudioEngine::GetInstance().UpdateVoice(voice_id_, GetVoiceSettings());
+  }
+  UpdateNextUri();
+}
+
+void GstAudioPlayer::SetNextSourceUrl(std::string url) {
+  next_url_ = url;
+  UpdateNextUri();
+}
+
+void GstAudioPlayer::SetCrossfade(int64_t duration_ms) {
+  crossfade_ms_ = std::max<int64_t>(duration_ms, 0);
+  if (crossfade_ms_ == 0) {
+    FinishCrossfade();
+  }
+  UpdateNextUri();
+}
+
+void GstAudioPlayer::UpdateNextUri() {
+  auto url = next_url_.empty() && is_looping_ ? url_ : next_url_;
+  // A crossfade starts the next source in a pipeline of its own, and voices
+  // loop by themselves.
+  if (crossfade_ms_ > 0 || samples_) {
+    url.clear();
+  }
+  if (!url.empty()) {
+    const auto cached_uri = DownloadCache::GetInstance().Lookup(url);
+    if (!cached_uri.empty()) {
+      url = cached_uri;
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_next_);
+  gapless_uri_ = url;
+}
+
+void GstAudioPlayer::OnSourceAdvanced() {
+  if (!next_url_.empty()) {
+    url_ = next_url_;
+    next_url_.clear();
+  }
+  UpdateNextUri();
+  const auto duration = GetDuration();
+  if (duration >= 0) {
+    stream_handler_->OnNotifyDuration(player_id_, duration);
+  }
+}
+
+bool GstAudioPlayer::IsCrossfadePolled() const {
+  if (fading_.playbin) {
+    return true;
+  }
+  return crossfade_ms_ > 0 && is_initialized_ && is_playing_ && !samples_ &&
+         (!next_url_.empty() || is_looping_);
+}
+
+void GstAudioPlayer::UpdateCrossfade() {
+  if (!fading_.playbin) {
+    const auto duration = GetDuration();
+    const auto position = GetCurrentPosition();
+    if (duration > 0 && position >= 0 &&
+        duration - position <= crossfade_ms_) {
+      StartCrossfade();
+    }
+    return;
+  }
+  if (crossfade_ms_ <= 0) {
+    FinishCrossfade();
+    return;
+  }
+  const auto elapsed = std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - crossfade_start_)
+                           .count();
+  const auto progress = std::min(elapsed / crossfade_ms_, 1.0);
+  // Equal power ramps keep the loudness even across the crossfade.
+  g_object_set(G_OBJECT(gst_.playbin), "volume",
+               volume_ * std::sin(progress * M_PI_2), NULL);
+  g_object_set(G_OBJECT(fading_.playbin), "volume",
+               fading_volume_ * std::cos(progress * M_PI_2), NULL);
+  if (progress >= 1.0) {
+    FinishCrossfade();
+  }
+}
+
+void GstAudioPlayer::StartCrossfade() {
+  const auto url = next_url_.empty() ? url_ : next_url_;
+  // The messages of the pipeline fading out, e.g. its EOS, are dropped.
+  GstBusBridge::GetInstance().Unwatch(bus_watch_id_);
+  bus_watch_id_ = 0;
+  gst_bus_set_flushing(gst_.bus, TRUE);
+  fading_ = gst_;
+  fading_volume_ = volume_;
+  fading_shared_sink_ = shared_sink_;
+  gst_ = {};
+  shared_sink_ = nullptr;
+  if (!CreatePipeline()) {
+    std::cerr << "Failed to create a pipeline to crossfade" << std::endl;
+    // Plays on without crossfades.
+    gst_ = fading_;
+    fading_ = {};
+    shared_sink_ = fading_shared_sink_;
+    fading_shared_sink_ = nullptr;
+    gst_bus_set_flushing(gst_.bus, FALSE);
+    bus_watch_id_ = GstBusBridge::GetInstance().Watch(
+        gst_.bus,
+        [this](GstMessage* message) { HandleAsyncGstMessage(message); });
+    crossfade_ms_ = 0;
+    UpdateNextUri();
+    return;
+  }
+  if (is_shared_output_) {
+    ApplyOutput();
+  }
+  if (gst_.panorama) {
+    g_object_set(G_OBJECT(gst_.panorama), "panorama", balance_, NULL);
+  }
+  const auto uri = PrepareDownload(url);
+  g_object_set(G_OBJECT(gst_.playbin), "uri", uri.c_str(), "volume", 0.0,
+               NULL);
+  url_ = url;
+  next_url_.clear();
+  is_advance_pending_ = false;
+  UpdateNextUri();
+  crossfade_start_ = std::chrono::steady_clock::now();
+  if (gst_element_set_state(gst_.playbin, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    std::cerr << "Unable to start crossfading to " << url << std::endl;
+    FinishCrossfade();
+  }
+}
+
+void GstAudioPlayer::FinishCrossfade() {
+  if (!fading_.playbin) {
+    return;
+  }
+  if (fading_shared_sink_) {
+    AudioEngine::GetInstance().ReleaseSink(fading_shared_sink_);
+    fading_shared_sink_ = nullptr;
+  }
+  gst_element_set_state(fading_.playbin, GST_STATE_NULL);
+  gst_object_unref(fading_.bus);
+  gst_object_unref(fading_.playbin);
+  fading_ = {};
+  if (gst_.playbin) {
+    g_object_set(G_OBJECT(gst_.playbin), "volume", volume_, NULL);
+  }
+}
+
+void GstAudioPlayer::SetSharedOutput(bool is_shared) {
+  if (!gst_.playbin || is_shared_output_ == is_shared) {
+    return;
+  }
+  is_shared_output_ = is_shared;
+  // Swapping the sink of a running playbin would need its dataflow blocked,
+  // so it waits for the next source then.
+  if (GST_STATE(gst_.playbin) <= GST_STATE_READY) {
+    ApplyOutput();
+  } else {
+    is_output_pending_ = true;
+  }
+}
+
+void GstAudioPlayer::SetOutputProfile(const AudioOutput::Profile& profile) {
+  output_profile_ = profile;
+  if (!gst_.playbin || is_shared_output_) {
+    return;
+  }
+  if (GST_STATE(gst_.playbin) <= GST_STATE_READY) {
+    ApplyOutput();
+  } else {
+    is_output_pending_ = true;
+  }
+}
+
+bool GstAudioPlayer::GetOutputLatency(AudioOutput::Latency& latency) {
+  if (!gst_.playbin) {
+    return false;
+  }
+  if (samples_ || shared_sink_) {
+    return AudioEngine::GetInstance().MeasureLatency(latency);
+  }
+  // Finds the sink in the audio bin, or the one playbin has picked.
+  return AudioOutput::MeasureLatency(gst_.playbin, latency);
+}
+
+AudioOutput::Profile GstAudioPlayer::GetOutputProfile() const {
+  return output_profile_.IsDefault()
+             ? AudioOutput::GetInstance().GetDefaultProfile()
+             : output_profile_;
+}
+
+void GstAudioPlayer::ApplyOutput() {
+  is_output_pending_ = false;
+  GstElement* sink = nullptr;
+  if (is_shared_output_) {
+    sink = AudioEngine::GetInstance().CreateSink();
+    if (!sink) {
+      is_shared_output_ = false;
+      return;
+    }
+  } else {
+    const auto profile = GetOutputProfile();
+    if (gst_.panorama || !profile.IsDefault()) {
+      sink = AudioOutput::CreateSink(profile);
+      if (!sink) {
+        return;
+      }
+    }
+  }
+
+  // Detaches the previous sink before it is destroyed.
+  if (shared_sink_) {
+    AudioEngine::GetInstance().ReleaseSink(shared_sink_);
+  }
+  shared_sink_ = is_shared_output_ ? sink : nullptr;
+
+  if (gst_.panorama) {
+    gst_element_set_state(gst_.audiosink, GST_STATE_NULL);
+    gst_element_unlink(gst_.panorama, gst_.audiosink);
+    gst_bin_remove(GST_BIN(gst_.audiobin), gst_.audiosink);
+    gst_bin_add(GST_BIN(gst_.audiobin), sink);
+    gst_element_link(gst_.panorama, sink);
+    gst_element_sync_state_with_parent(sink);
+    gst_.audiosink = sink;
+  } else {
+    // Without audiopanorama, no sink means the default one of playbin.
+    g_object_set(G_OBJECT(gst_.playbin), "audio-sink", sink, NULL);
+  }
+}
+
+bool GstAudioPlayer::LoadSamples(const std::string& url) {
+  auto uri = url;
+  // Network sounds are decoded once they are in the download cache.
+  if (DownloadCache::IsNetworkUri(url)) {
+    uri = DownloadCache::GetInstance().Lookup(url);
+    if (uri.empty()) {
+      return false;
+    }
+  }
+  samples_ = SampleBank::GetInstance().Load(uri);
+  if (!samples_) {
+    return false;
+  }
+  AudioEngine::GetInstance().AcquireVoices();
+  voice_position_ = 0;
+  return true;
+}
+
+void GstAudioPlayer::ReleaseSamples() {
+  if (!samples_) {
+    return;
+  }
+  auto& engine = AudioEngine::GetInstance();
+  if (voice_id_) {
+    engine.StopVoice(voice_id_);
+    voice_id_ = 0;
+  }
+  engine.ReleaseVoices();
+  gst_buffer_unref(samples_);
+  samples_ = nullptr;
+  voice_position_ = 0;
+}
+
+AudioEngine::VoiceSettings GstAudioPlayer::GetVoiceSettings() const {
+  AudioEngine::VoiceSettings settings;
+  settings.volume = volume_;
+  settings.balance = balance_;
+  settings.rate = playback_rate_;
+  settings.is_looping = is_looping_;
+  return settings;
 }
 
 int64_t GstAudioPlayer::GetDuration() {
+  if (is_pipeline_suspended_) {
+    return suspended_duration_;
+  }
+  if (samples_) {
+    const auto frames = gst_buffer_get_size(samples_) /
+                        (AudioEngine::kChannels * sizeof(float));
+    return static_cast<int64_t>(frames * 1000 / AudioEngine::kSampleRate);
+  }
   gint64 duration;
   if (!gst_element_query_duration(gst_.playbin, GST_FORMAT_TIME, &duration)) {
     return -1;
@@ -247,38 +895,37 @@ int64_t GstAudioPlayer::GetDuration() {
 }
 
 int64_t GstAudioPlayer::GetCurrentPosition() {
+  if (is_pipeline_suspended_) {
+    return suspended_position_;
+  }
+  if (samples_) {
+    if (voice_id_) {
+      // Zero once the voice has ended, as after a stop.
+      return std::max<int64_t>(
+          AudioEngine::GetInstance().GetVoicePosition(voice_id_), 0);
+    }
+    return voice_position_;
+  }
   gint64 position = 0;
   if (!gst_element_query_position(gst_.playbin, GST_FORMAT_TIME, &position)) {
     return -1;
   }
 
-  // TODO: We need to handle this code in the proper plase.
-  // The VideoPlayer plugin doesn't have a main loop, so EOS message
-  // received from GStreamer cannot be processed directly in a callback
-  // function. This is because the event channel message of playback complettion
-  // needs to be thrown in the main thread.
-  if (is_completed_) {
-    is_completed_ = false;
-    if (is_looping_) {
-      Play();
-    }  else {
-      stream_handler_->OnNotifyPlayCompleted(player_id_);
-      Stop();
-    }
-    position = 0;
-  }
-
   return position / GST_MSECOND;
 }
 
 void GstAudioPlayer::Release() {
   is_playing_ = false;
   is_initialized_ = false;
+  is_loaded_ = false;
+  is_suspended_ = false;
+  is_pipeline_suspended_ = false;
   url_.clear();
+  ReleaseSamples();
 
-  GstState state;
-  gst_element_get_state(gst_.playbin, &state, NULL, GST_CLOCK_TIME_NONE);
-  if (state > GST_STATE_NULL) {
+  is_preparing_ = false;
+  // Doesn't wait for a pending state change to complete.
+  if (GST_STATE_TARGET(gst_.playbin) > GST_STATE_NULL) {
     gst_bus_set_flushing(gst_.bus, TRUE);
     gst_element_set_state(gst_.playbin, GST_STATE_NULL);
   }
@@ -291,8 +938,15 @@ void GstAudioPlayer::Dispose() {
   }
   is_playing_ = false;
   is_initialized_ = false;
+  is_loaded_ = false;
   url_.clear();
+  FinishCrossfade();
+  ReleaseSamples();
 
+  if (bus_watch_id_) {
+    GstBusBridge::GetInstance().Unwatch(bus_watch_id_);
+    bus_watch_id_ = 0;
+  }
   if (gst_.bus) {
     gst_bus_set_flushing(gst_.bus, TRUE);
     gst_object_unref(GST_OBJECT(gst_.bus));
@@ -304,6 +958,19 @@ void GstAudioPlayer::Dispose() {
     gst_.source = nullptr;
   }
 
+  {
+    std::lock_guard<std::mutex> lock(mutex_download_);
+    if (download_queue_) {
+      gst_object_unref(download_queue_);
+      download_queue_ = nullptr;
+    }
+  }
+
+  if (shared_sink_) {
+    AudioEngine::GetInstance().ReleaseSink(shared_sink_);
+    shared_sink_ = nullptr;
+  }
+
   if (gst_.panorama) {
     gst_element_set_state(gst_.audiobin, GST_STATE_NULL);
     gst_element_remove_pad(gst_.audiobin, gst_.panoramasinkpad);
@@ -319,32 +986,66 @@ void GstAudioPlayer::Dispose() {
 GstBusSyncReply GstAudioPlayer::HandleGstMessage(GstBus* bus,
                                                  GstMessage* message,
                                                  gpointer user_data) {
-  auto* self = reinterpret_cast<GstAudioPlayer*>(user_data);
+  TRACE_GST_MESSAGE(reinterpret_cast<GstAudioPlayer*>(user_data)->trace_track_,
+                    message);
+  switch (GST_MESSAGE_TYPE(message)) {
+    case GST_MESSAGE_STATE_CHANGED:
+    case GST_MESSAGE_EOS:
+    case GST_MESSAGE_WARNING:
+    case GST_MESSAGE_ERROR:
+    case GST_MESSAGE_BUFFERING:
+    case GST_MESSAGE_STREAM_START:
+    case GST_MESSAGE_DURATION_CHANGED:
+      // Handled by HandleAsyncGstMessage() on the bus bridge thread.
+      return GST_BUS_PASS;
+    default:
+      break;
+  }
+
+  gst_message_unref(message);
+
+  return GST_BUS_DROP;
+}
+
+void GstAudioPlayer::HandleAsyncGstMessage(GstMessage* message) {
+  TRACE_SCOPE(trace_track_, "HandleAsyncGstMessage");
   switch (GST_MESSAGE_TYPE(message)) {
     case GST_MESSAGE_STATE_CHANGED: {
-      if (GST_MESSAGE_SRC(message) == GST_OBJECT(self->gst_.playbin)) {
+      if (GST_MESSAGE_SRC(message) == GST_OBJECT(gst_.playbin)) {
         GstState old_state, new_state;
         gst_message_parse_state_changed(message, &old_state, &new_state, NULL);
-        if (new_state == GST_STATE_READY) {
-          if (gst_element_set_state(self->gst_.playbin, GST_STATE_PAUSED) ==
-              GST_STATE_CHANGE_FAILURE) {
-            g_printerr("Unable to set the pipeline from GST_STATE_READY "
-                "to GST_STATE_PAUSED\n");
-          }
+        if (new_state == GST_STATE_PAUSED && is_preparing_.exchange(false)) {
+          stream_handler_->OnNotifyPrepared(player_id_, true);
+          // Known once prerolled, so that Dart needn't ask for it.
+          Post([this]() {
+            const auto duration = GetDuration();
+            if (duration >= 0) {
+              stream_handler_->OnNotifyDuration(player_id_, duration);
+            }
+          });
         }
       }
       break;
     }
     case GST_MESSAGE_EOS:
-      self->is_completed_ = true;
+      // Seeks in order with the calls of the platform thread.
+      Post([this]() {
+        if (is_looping_) {
+          PinLoopingAsset();
+          Play();
+        } else {
+          stream_handler_->OnNotifyPlayCompleted(player_id_);
+          Stop();
+        }
+      });
       break;
     case GST_MESSAGE_WARNING: {
       gchar* debug;
       GError* error;
       gst_message_parse_warning(message, &error, &debug);
-      g_printerr("WARNING from element %s: %s\n", GST_OBJECT_NAME(message->src),
-                 error->message);
-      g_printerr("Warning details: %s\n", debug);
+      PLUGIN_LOG(Warning, "gst")
+          << "WARNING from element " << GST_OBJECT_NAME(message->src) << ": "
+          << error->message << "\nWarning details: " << (debug ? debug : "");
       g_free(debug);
       g_error_free(error);
       break;
@@ -353,18 +1054,41 @@ GstBusSyncReply GstAudioPlayer::HandleGstMessage(GstBus* bus,
       gchar* debug;
       GError* error;
       gst_message_parse_error(message, &error, &debug);
-      g_printerr("ERROR from element %s: %s\n", GST_OBJECT_NAME(message->src),
-                 error->message);
-      g_printerr("Error details: %s\n", debug);
+      PLUGIN_LOG(Error, "gst")
+          << "ERROR from element " << GST_OBJECT_NAME(message->src) << ": "
+          << error->message << "\nError details: " << (debug ? debug : "");
+      stats_.Add(PluginStats::kBusErrors);
+      stream_handler_->OnNotifyLog(player_id_, error->message);
+      if (is_preparing_.exchange(false)) {
+        stream_handler_->OnNotifyPrepared(player_id_, false);
+      }
       g_free(debug);
       g_error_free(error);
       break;
     }
+    case GST_MESSAGE_STREAM_START:
+      if (is_advance_pending_.exchange(false)) {
+        Post([this]() { OnSourceAdvanced(); });
+      }
+      break;
+    case GST_MESSAGE_DURATION_CHANGED:
+      Post([this]() {
+        const auto duration = GetDuration();
+        if (duration >= 0) {
+          stream_handler_->OnNotifyDuration(player_id_, duration);
+        }
+      });
+      break;
+    case GST_MESSAGE_BUFFERING: {
+      gint percent = 0;
+      gst_message_parse_buffering(message, &percent);
+      stats_.Set(PluginStats::kQueueLevel, percent);
+      if (percent == 100) {
+        CommitDownload();
+      }
+      break;
+    }
     default:
       break;
   }
-
-  gst_message_unref(message);
-
-  return GST_BUS_DROP;
 }
@@ -7,23 +7,54 @@
 
 #include <gst/gst.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
 
+#include "audio_engine.h"
+#include "audio_output.h"
 #include "audio_player_stream_handler.h"
+#include "gst_bus_bridge.h"
+#include "plugin_stats.h"
+#include "trace_event.h"
 
+// Except for Post(), the methods are called on the worker thread of the
+// player, so that a slow state change, e.g. of an HTTP source, holds up
+// neither the platform thread nor the other players.
 class GstAudioPlayer {
  public:
   GstAudioPlayer(const std::string &player_id,
                  std::unique_ptr<AudioPlayerStreamHandler> handler);
+  // Waits for the task running on the worker, if any.
   ~GstAudioPlayer();
 
   static void GstLibraryLoad();
   static void GstLibraryUnload();
 
+  // Runs |task| on the worker after the tasks posted before it.
+  void Post(std::function<void()> task);
+  // Notifies the current position from the worker if it's playing. Skipped
+  // while the previous one is pending, e.g. behind a slow source.
+  void PostPositionUpdate();
+
+  // Whether the player plays, or has a source that isn't suspended. Read
+  // from the platform thread.
+  bool IsPlaying() const { return is_playing_; }
+  bool IsLoaded() const { return is_loaded_ && !is_suspended_; }
+  bool IsSuspended() const { return is_suspended_; }
+  // Suspends the pipeline from the worker unless the player plays by then.
+  void PostSuspend();
+  // Restores a suspended pipeline from the worker before the tasks posted
+  // after this.
+  void Wake();
+
   void Resume();
   void Play();
   void Pause();
@@ -34,6 +65,22 @@ class GstAudioPlayer {
   void SetBalance(double balance);
   void SetPlaybackRate(double playback_rate);
   void SetLooping(bool is_looping);
+  // Plays into the shared AudioEngine instead of an audio sink of its own,
+  // and plays short sounds from SampleBank. Takes effect on the next source
+  // unless the player is stopped.
+  void SetSharedOutput(bool is_shared);
+  // Queues |url| to play after the current source without a gap. Empty
+  // clears the queue. A looping source is looped without a gap.
+  void SetNextSourceUrl(std::string url);
+  // Fades the queued source, or the looping one, in over the last
+  // |duration_ms| of the current source instead. Zero disables it.
+  void SetCrossfade(int64_t duration_ms);
+  // Plays through a sink of |profile| instead of the default profile of
+  // AudioOutput, unless |profile| is the default one. Takes effect on the
+  // next source unless the player is stopped.
+  void SetOutputProfile(const AudioOutput::Profile& profile);
+  // Measures the output the player plays through, once it has played.
+  bool GetOutputLatency(AudioOutput::Latency& latency);
   int64_t GetDuration();
   int64_t GetCurrentPosition();
   void Release();
@@ -52,22 +99,117 @@ class GstAudioPlayer {
 
   static GstBusSyncReply HandleGstMessage(GstBus* bus, GstMessage* message,
                                           gpointer user_data);
+  // Handles the messages HandleGstMessage() passes on, on the bus bridge
+  // thread.
+  void HandleAsyncGstMessage(GstMessage* message);
+  // Switches the playbin to the queued source on the streaming thread.
+  static void OnAboutToFinish(GstElement* playbin, gpointer user_data);
   static void SourceSetup(GstElement* playbin,
                           GstElement* source,
                           GstElement** p_src);
+  // Points the download of a network stream into the download cache.
+  static void OnDeepElementAdded(GstBin* bin, GstBin* sub_bin,
+                                 GstElement* element, gpointer user_data);
+  // Returns the cached copy of |url| if there's one. Otherwise sets up the
+  // download of |url| into the download cache if it's enabled.
+  std::string PrepareDownload(const std::string& url);
+  // Commits the download once it covers the whole stream. Called on the bus
+  // bridge thread.
+  void CommitDownload();
+  // Pins the file played in a loop, if it's an asset, once it has been read
+  // to its end.
+  void PinLoopingAsset();
+  AudioOutput::Profile GetOutputProfile() const;
+  // Replaces the audio sink according to |is_shared_output_| and the output
+  // profile. The playbin must be in the READY state or below.
+  void ApplyOutput();
+  // Plays |url| as a voice of AudioEngine if SampleBank can load it.
+  bool LoadSamples(const std::string& url);
+  void ReleaseSamples();
+  AudioEngine::VoiceSettings GetVoiceSettings() const;
+  // Hands |next_url_|, or the looping source, over to OnAboutToFinish().
+  void UpdateNextUri();
+  // Called on the worker once the playbin plays the queued source.
+  void OnSourceAdvanced();
+  // Whether the worker polls UpdateCrossfade().
+  bool IsCrossfadePolled() const;
+  void UpdateCrossfade();
+  // Moves the playing pipeline to |fading_| and starts the next source in
+  // a new one.
+  void StartCrossfade();
+  // Ends a crossfade in progress right away.
+  void FinishCrossfade();
+  // Sets an idle pipeline to NULL, which frees its decoders, buffers and
+  // audio device, and keeps its source and position to be restored.
+  void Suspend();
+  // Prerolls a suspended pipeline again at the position it was suspended at.
+  void RestorePipeline();
   bool CreatePipeline();
+  void RunWorker();
   std::string ParseUri(const std::string& uri);
 
   GstAudioElements gst_;
   const std::string player_id_;
+#ifdef USE_TRACE_EVENTS
+  // The track of the trace events of the player.
+  const std::string trace_track_ = "audioplayers " + player_id_;
+#endif  // USE_TRACE_EVENTS
   std::string url_;
   bool is_initialized_ = false;
-  bool is_playing_ = false;
+  std::atomic<bool> is_playing_{false};
   bool is_looping_ = false;
   double volume_ = 1.0;
   double playback_rate_ = 1.0;
-  bool is_completed_ = false;
+  guint bus_watch_id_ = 0;
+  // The network URL being downloaded into the download cache, and the
+  // queue2 downloading it, set on the streaming thread.
+  std::mutex mutex_download_;
+  std::string download_url_;
+  GstElement* download_queue_ = nullptr;
+  bool is_download_committed_ = false;
+  bool is_shared_output_ = false;
+  bool is_output_pending_ = false;
+  AudioOutput::Profile output_profile_;
+  // The sink from AudioEngine, if the player plays into it.
+  GstElement* shared_sink_ = nullptr;
+  double balance_ = 0.0;
+  // The decoded source and the voice playing it, if the source is played
+  // from SampleBank. |voice_position_| is where a voice starts.
+  GstBuffer* samples_ = nullptr;
+  uint64_t voice_id_ = 0;
+  int64_t voice_position_ = 0;
+  // Set while the source prerolls, until onPrepared is sent from the bus
+  // bridge thread.
+  std::atomic<bool> is_preparing_{false};
+  std::string next_url_;
+  int64_t crossfade_ms_ = 0;
+  // The pipeline fading out during a crossfade, and its volume and sink
+  // from AudioEngine.
+  GstAudioElements fading_ = {};
+  double fading_volume_ = 0.0;
+  GstElement* fading_shared_sink_ = nullptr;
+  std::chrono::steady_clock::time_point crossfade_start_;
+  // The URI OnAboutToFinish() switches to, and whether it has switched.
+  std::mutex mutex_next_;
+  std::string gapless_uri_;
+  std::atomic<bool> is_advance_pending_{false};
+  std::atomic<bool> is_position_update_pending_{false};
+  // Whether the player has a source, and whether it's suspended or is to be
+  // once the worker gets to it.
+  std::atomic<bool> is_loaded_{false};
+  std::atomic<bool> is_suspended_{false};
+  // Set by Suspend() if it has set the pipeline to NULL, with the position
+  // and the duration to restore and to answer with meanwhile.
+  bool is_pipeline_suspended_ = false;
+  int64_t suspended_position_ = 0;
+  int64_t suspended_duration_ = -1;
   std::unique_ptr<AudioPlayerStreamHandler> stream_handler_;
+  PluginStats stats_{"audioplayers"};
+  std::mutex mutex_worker_;
+  std::condition_variable worker_cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool is_worker_stopped_ = false;
+  std::thread worker_;
 };
 
 #endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_GST_AUDIO_PLAYER_H_
@@ -0,0 +1,83 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gst_bus_bridge.h"
+
+#include <utility>
+
+#include "gst_runtime.h"
+
+// static
+GstBusBridge& GstBusBridge::GetInstance() {
+  static GstBusBridge instance;
+  return instance;
+}
+
+GstBusBridge::GstBusBridge() {
+  // Held until exit, so that the context outlives the watches.
+  GstRuntime::Acquire();
+  context_ = GstRuntime::GetMainContext();
+}
+
+GstBusBridge::~GstBusBridge() {
+  for (auto& watcher : watchers_) {
+    g_source_destroy(watcher.second->source);
+    g_source_unref(watcher.second->source);
+  }
+  GstRuntime::Release();
+}
+
+guint GstBusBridge::Watch(GstBus* bus, Handler handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto id = next_id_++;
+  auto* source = gst_bus_create_watch(bus);
+  g_source_set_callback(source, reinterpret_cast<GSourceFunc>(Dispatch),
+                        GUINT_TO_POINTER(id), nullptr);
+  auto watcher = std::make_shared<Watcher>();
+  watcher->source = source;
+  watcher->handler = std::move(handler);
+  watchers_[id] = std::move(watcher);
+  g_source_attach(source, context_);
+  return id;
+}
+
+void GstBusBridge::Unwatch(guint id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = watchers_.find(id);
+  if (it == watchers_.end()) {
+    return;
+  }
+  auto watcher = std::move(it->second);
+  watchers_.erase(it);
+  g_source_destroy(watcher->source);
+  g_source_unref(watcher->source);
+  // No dispatch finds the watcher anymore; waits for the one in progress.
+  dispatch_done_.wait(lock, [&] { return watcher->dispatch_count == 0; });
+}
+
+// static
+gboolean GstBusBridge::Dispatch(GstBus* bus, GstMessage* message,
+                                gpointer user_data) {
+  auto& self = GetInstance();
+  std::shared_ptr<Watcher> watcher;
+  {
+    std::lock_guard<std::mutex> lock(self.mutex_);
+    // The source may have been destroyed while this dispatch was pending.
+    auto it = self.watchers_.find(GPOINTER_TO_UINT(user_data));
+    if (it == self.watchers_.end()) {
+      return TRUE;
+    }
+    watcher = it->second;
+    watcher->dispatch_count++;
+  }
+
+  watcher->handler(message);
+
+  {
+    std::lock_guard<std::mutex> lock(self.mutex_);
+    watcher->dispatch_count--;
+  }
+  self.dispatch_done_.notify_all();
+  return TRUE;
+}
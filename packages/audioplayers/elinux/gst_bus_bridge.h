@@ -0,0 +1,65 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_GST_BUS_BRIDGE_H_
+#define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_GST_BUS_BRIDGE_H_
+
+#include <gst/gst.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Dispatches the messages of GStreamer buses on a thread running a
+// GMainLoop, so that EOS, errors and state changes are handled as soon as
+// they are posted. The plugin has no main loop of its own, and the threads
+// that run the sync handlers must not seek or change states.
+class GstBusBridge {
+ public:
+  using Handler = std::function<void(GstMessage*)>;
+
+  // Returns the bridge shared by all the players. Its messages are
+  // dispatched on the thread of GstRuntime, shared with the other plugins,
+  // which the bridge holds on to until exit.
+  static GstBusBridge& GetInstance();
+
+  // Prevent copying.
+  GstBusBridge(GstBusBridge const&) = delete;
+  GstBusBridge& operator=(GstBusBridge const&) = delete;
+
+  // Calls |handler| on the bridge thread with every message the sync
+  // handler of |bus| passes on. Returns the id to give to Unwatch().
+  guint Watch(GstBus* bus, Handler handler);
+  // Once this returns, the handler of |id| isn't called anymore. Must not be
+  // called from a handler.
+  void Unwatch(guint id);
+
+ private:
+  struct Watcher {
+    GSource* source;
+    Handler handler;
+    // The calls of |handler| in progress, guarded by |mutex_|.
+    int dispatch_count = 0;
+  };
+
+  GstBusBridge();
+  ~GstBusBridge();
+
+  static gboolean Dispatch(GstBus* bus, GstMessage* message,
+                           gpointer user_data);
+
+  // Owned by GstRuntime.
+  GMainContext* context_;
+  // Not held while a handler runs, so that a slow handler doesn't hold up
+  // Watch() and Unwatch() of the other players.
+  std::mutex mutex_;
+  // Notified when a handler returns.
+  std::condition_variable dispatch_done_;
+  std::unordered_map<guint, std::shared_ptr<Watcher>> watchers_;
+  guint next_id_ = 1;
+};
+
+#endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_GST_BUS_BRIDGE_H_
@@ -0,0 +1,205 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "metadata_prober.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#include "download_cache.h"
+
+namespace {
+// Bounds each URL, so that a broken file or server doesn't hold a worker.
+constexpr GstClockTime kDiscoverTimeout = 10 * GST_SECOND;
+constexpr unsigned int kMaxWorkers = 4;
+// The results are dropped at once beyond this, which a playlist shown again
+// recovers from in one batch.
+constexpr size_t kMaxCacheEntries = 4096;
+
+std::string GetTagString(const GstTagList* tags, const char* tag) {
+  gchar* value = nullptr;
+  if (!tags || !gst_tag_list_get_string(tags, tag, &value) || !value) {
+    return std::string();
+  }
+  std::string result(value);
+  g_free(value);
+  return result;
+}
+}  // namespace
+
+MetadataProber::MetadataProber() {
+  const auto worker_count =
+      std::min(std::max(std::thread::hardware_concurrency(), 1u), kMaxWorkers);
+  for (unsigned int i = 0; i < worker_count; i++) {
+    workers_.emplace_back([this]() { RunWorker(); });
+  }
+}
+
+MetadataProber::~MetadataProber() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+    jobs_.clear();
+  }
+  job_available_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void MetadataProber::Probe(const std::string& url, Callback callback) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back({url, std::move(callback)});
+  }
+  job_available_.notify_one();
+}
+
+void MetadataProber::RunWorker() {
+  // A discoverer examines one URL at a time, so each worker has its own.
+  GError* error = nullptr;
+  auto* discoverer = gst_discoverer_new(kDiscoverTimeout, &error);
+  if (!discoverer) {
+    std::cerr << "Failed to create a discoverer: "
+              << (error ? error->message : "unknown error") << std::endl;
+    if (error) {
+      g_error_free(error);
+    }
+  }
+
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      job_available_.wait(lock,
+                          [this]() { return is_stopping_ || !jobs_.empty(); });
+      if (is_stopping_) {
+        break;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    if (!discoverer) {
+      Metadata metadata;
+      metadata.error = "The metadata of " + job.url + " can't be probed";
+      job.callback(std::move(metadata));
+      continue;
+    }
+    job.callback(Run(discoverer, job.url));
+  }
+
+  if (discoverer) {
+    g_object_unref(discoverer);
+  }
+}
+
+MetadataProber::Metadata MetadataProber::Run(GstDiscoverer* discoverer,
+                                             const std::string& url) {
+  std::string uri = url;
+  if (!gst_uri_is_valid(uri.c_str())) {
+    auto* filename_uri = gst_filename_to_uri(uri.c_str(), NULL);
+    if (filename_uri) {
+      uri = filename_uri;
+      g_free(filename_uri);
+    }
+  }
+  // A track a player has downloaded is probed from its local copy.
+  const auto cached_uri = DownloadCache::GetInstance().Lookup(uri);
+  if (!cached_uri.empty()) {
+    uri = cached_uri;
+  }
+
+  const auto key = GetCacheKey(uri);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = cache_.find(key);
+    if (iter != cache_.end()) {
+      return iter->second;
+    }
+  }
+
+  Metadata metadata;
+  if (!Discover(discoverer, uri, metadata)) {
+    if (metadata.error.empty()) {
+      metadata.error = "Failed to probe the metadata of " + url;
+    }
+    std::cerr << metadata.error << std::endl;
+    return metadata;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (cache_.size() >= kMaxCacheEntries) {
+    cache_.clear();
+  }
+  cache_[key] = metadata;
+  return metadata;
+}
+
+// static
+bool MetadataProber::Discover(GstDiscoverer* discoverer,
+                              const std::string& uri, Metadata& metadata) {
+  GError* error = nullptr;
+  auto* info = gst_discoverer_discover_uri(discoverer, uri.c_str(), &error);
+  if (error) {
+    metadata.error = std::string("Failed to probe the metadata of ") + uri +
+                     ": " + error->message;
+    g_error_free(error);
+  }
+  if (!info) {
+    return false;
+  }
+  const auto result = gst_discoverer_info_get_result(info);
+  if (result != GST_DISCOVERER_OK) {
+    g_object_unref(info);
+    return false;
+  }
+
+  const auto duration = gst_discoverer_info_get_duration(info);
+  if (GST_CLOCK_TIME_IS_VALID(duration)) {
+    metadata.duration_ms = static_cast<int64_t>(duration / GST_MSECOND);
+  }
+  const auto* tags = gst_discoverer_info_get_tags(info);
+  metadata.title = GetTagString(tags, GST_TAG_TITLE);
+  metadata.artist = GetTagString(tags, GST_TAG_ARTIST);
+  metadata.album = GetTagString(tags, GST_TAG_ALBUM);
+  metadata.genre = GetTagString(tags, GST_TAG_GENRE);
+  guint track_number = 0;
+  if (tags &&
+      gst_tag_list_get_uint(tags, GST_TAG_TRACK_NUMBER, &track_number)) {
+    metadata.track_number = track_number;
+  }
+
+  auto* streams = gst_discoverer_info_get_audio_streams(info);
+  if (streams) {
+    const auto* audio = GST_DISCOVERER_AUDIO_INFO(streams->data);
+    metadata.sample_rate = gst_discoverer_audio_info_get_sample_rate(audio);
+    metadata.channels = gst_discoverer_audio_info_get_channels(audio);
+    metadata.bitrate = gst_discoverer_audio_info_get_bitrate(audio);
+    gst_discoverer_stream_info_list_free(streams);
+  }
+  g_object_unref(info);
+  metadata.error.clear();
+  return true;
+}
+
+// static
+std::string MetadataProber::GetCacheKey(const std::string& uri) {
+  // Only local files have a modification time to invalidate the results
+  // with. The others are kept for the session.
+  auto* filename = g_filename_from_uri(uri.c_str(), nullptr, nullptr);
+  if (!filename) {
+    return uri;
+  }
+  struct stat file_stat;
+  const auto has_stat = stat(filename, &file_stat) == 0;
+  g_free(filename);
+  if (!has_stat) {
+    return uri;
+  }
+  return uri + "|" + std::to_string(file_stat.st_mtim.tv_sec) + "." +
+         std::to_string(file_stat.st_mtim.tv_nsec) + "|" +
+         std::to_string(file_stat.st_size);
+}
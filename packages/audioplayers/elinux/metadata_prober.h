@@ -0,0 +1,79 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_METADATA_PROBER_H_
+#define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_METADATA_PROBER_H_
+
+#include <gst/pbutils/pbutils.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Probes the durations and tags of audio files, e.g. of a playlist, without
+// a player or an audio device.
+//
+// Each URL is examined by a GstDiscoverer on a small pool of worker threads,
+// so that a batch of URLs is probed in parallel. The results are kept in
+// memory by URL and, for local files, modification time and size, so that
+// showing the same playlist again costs nothing.
+class MetadataProber {
+ public:
+  struct Metadata {
+    // -1 if unknown.
+    int64_t duration_ms = -1;
+    std::string title;
+    std::string artist;
+    std::string album;
+    std::string genre;
+    // Zero if unknown.
+    uint32_t track_number = 0;
+    uint32_t sample_rate = 0;
+    uint32_t channels = 0;
+    uint32_t bitrate = 0;
+    // Empty on success.
+    std::string error;
+  };
+
+  // Called on a worker thread.
+  using Callback = std::function<void(Metadata metadata)>;
+
+  MetadataProber();
+  // Drops the pending URLs and waits for the running ones.
+  ~MetadataProber();
+
+  // Prevent copying.
+  MetadataProber(MetadataProber const&) = delete;
+  MetadataProber& operator=(MetadataProber const&) = delete;
+
+  void Probe(const std::string& url, Callback callback);
+
+ private:
+  struct Job {
+    std::string url;
+    Callback callback;
+  };
+
+  void RunWorker();
+  Metadata Run(GstDiscoverer* discoverer, const std::string& url);
+  static bool Discover(GstDiscoverer* discoverer, const std::string& uri,
+                       Metadata& metadata);
+  // Returns the key of the results of |uri|.
+  static std::string GetCacheKey(const std::string& uri);
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable job_available_;
+  std::deque<Job> jobs_;
+  bool is_stopping_ = false;
+  std::unordered_map<std::string, Metadata> cache_;
+};
+
+#endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_METADATA_PROBER_H_
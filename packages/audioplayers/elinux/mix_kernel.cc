@@ -0,0 +1,76 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "mix_kernel.h"
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+namespace mix_kernel {
+
+namespace {
+constexpr float kQuarterPi = 0.78539816f;
+}  // namespace
+
+StereoGain GetPannedGain(float volume, float balance) {
+  const auto angle = (std::min(std::max(balance, -1.0f), 1.0f) + 1.0f) *
+                     kQuarterPi;
+  return {volume * std::cos(angle), volume * std::sin(angle)};
+}
+
+void MixStereo(float* output, const float* input, size_t frames,
+               StereoGain from, StereoGain to) {
+  if (frames == 0) {
+    return;
+  }
+  const auto left_step = (to.left - from.left) / frames;
+  const auto right_step = (to.right - from.right) / frames;
+  auto left = from.left;
+  auto right = from.right;
+  size_t i = 0;
+
+  // Two frames per vector, i.e. L0 R0 L1 R1.
+#if defined(__SSE__)
+  auto gain = _mm_set_ps(right + right_step, left + left_step, right, left);
+  const auto step = _mm_set_ps(right_step * 2, left_step * 2, right_step * 2,
+                               left_step * 2);
+  for (; i + 2 <= frames; i += 2) {
+    const auto samples = _mm_loadu_ps(input + i * 2);
+    const auto mixed = _mm_loadu_ps(output + i * 2);
+    _mm_storeu_ps(output + i * 2, _mm_add_ps(mixed, _mm_mul_ps(samples, gain)));
+    gain = _mm_add_ps(gain, step);
+  }
+#elif defined(__ARM_NEON)
+  const float initial_gain[] = {left, right, left + left_step,
+                                right + right_step};
+  const float gain_step[] = {left_step * 2, right_step * 2, left_step * 2,
+                             right_step * 2};
+  auto gain = vld1q_f32(initial_gain);
+  const auto step = vld1q_f32(gain_step);
+  for (; i + 2 <= frames; i += 2) {
+    const auto samples = vld1q_f32(input + i * 2);
+    const auto mixed = vld1q_f32(output + i * 2);
+    vst1q_f32(output + i * 2, vmlaq_f32(mixed, samples, gain));
+    gain = vaddq_f32(gain, step);
+  }
+#endif
+
+  // The remainder, and the whole pass where neither is available.
+  left += left_step * i;
+  right += right_step * i;
+  for (; i < frames; i++) {
+    output[i * 2] += input[i * 2] * left;
+    output[i * 2 + 1] += input[i * 2 + 1] * right;
+    left += left_step;
+    right += right_step;
+  }
+}
+
+}  // namespace mix_kernel
@@ -0,0 +1,31 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_MIX_KERNEL_H_
+#define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_MIX_KERNEL_H_
+
+#include <cstddef>
+
+namespace mix_kernel {
+
+// Gains of a stereo voice, ramped linearly from the current ones to the
+// target ones across a mixing pass so that changes don't click.
+struct StereoGain {
+  float left;
+  float right;
+};
+
+// Returns the constant power gains of |volume| panned to |balance|, where
+// -1.0 is left and 1.0 is right. The center is 3 dB down.
+StereoGain GetPannedGain(float volume, float balance);
+
+// Adds |frames| interleaved stereo frames of |input| to |output|, with the
+// gains ramped from |from| at the first frame to |to| after the last one.
+// Uses SSE or NEON where the target has it.
+void MixStereo(float* output, const float* input, size_t frames,
+               StereoGain from, StereoGain to);
+
+}  // namespace mix_kernel
+
+#endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_MIX_KERNEL_H_
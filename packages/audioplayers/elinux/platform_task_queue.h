@@ -0,0 +1,63 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_PLATFORM_TASK_QUEUE_H_
+#define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_PLATFORM_TASK_QUEUE_H_
+
+#include <flutter/basic_message_channel.h>
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Runs the tasks posted from any thread on the platform thread, from which
+// the engine expects the messages to Dart to be sent, e.g. the events of the
+// players. The client wrapper of flutter-elinux has no way to post a task to
+// the platform thread, so the queue wakes Dart through a native port, which
+// any thread may post to, and Dart runs the tasks by sending a message on
+// |channel_name|, whose handler is called on the platform thread. Dart sends
+// its port on the same channel, see lib/src/platform_tasks.dart.
+class PlatformTaskQueue {
+ public:
+  using Task = std::function<void()>;
+
+  PlatformTaskQueue(flutter::BinaryMessenger* messenger,
+                    const std::string& channel_name);
+  // The pending tasks are dropped. The threads that post tasks must be
+  // stopped before.
+  ~PlatformTaskQueue();
+
+  // Prevent copying.
+  PlatformTaskQueue(PlatformTaskQueue const&) = delete;
+  PlatformTaskQueue& operator=(PlatformTaskQueue const&) = delete;
+
+  // Runs |task| on the platform thread, in the order of the posts.
+  void Post(Task task);
+  // Runs the tasks posted so far. Must be called on the platform thread.
+  void RunPending();
+
+ private:
+  // Dart_PostCObject, as NativeApi.postCObject gives it.
+  using PostCObject = bool (*)(int64_t port, void* message);
+
+  void HandleMessage(const flutter::EncodableValue& message);
+  // Must be called with |mutex_| held.
+  void Wake();
+
+  std::unique_ptr<flutter::BasicMessageChannel<flutter::EncodableValue>>
+      channel_;
+  std::mutex mutex_;
+  std::vector<Task> tasks_;
+  int64_t port_ = 0;
+  PostCObject post_cobject_ = nullptr;
+  // Whether Dart was woken and hasn't run the tasks since.
+  bool is_wake_pending_ = false;
+};
+
+#endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_PLATFORM_TASK_QUEUE_H_
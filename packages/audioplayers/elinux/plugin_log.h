@@ -0,0 +1,65 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_PLUGIN_LOG_H_
+#define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_PLUGIN_LOG_H_
+
+#include <sstream>
+#include <string>
+
+// Logging for the paths that run on streaming threads, where a flapping
+// stream would otherwise flood a serial console and stall decoding on it.
+// The messages are queued and written by a background thread, and every
+// category is limited to a burst of messages, after which the dropped ones
+// are only counted. The verbosity of the categories is set with
+// ELINUX_PLUGIN_LOG, e.g. "gst:error,rtsp:debug,*:warning". Each level is
+// one of none, error, warning, info and debug, and the default is info.
+// video_player, camera and audioplayers each have a copy of this file.
+class PluginLog {
+ public:
+  enum Level {
+    kNone = -1,
+    kError,
+    kWarning,
+    kInfo,
+    kDebug,
+  };
+
+  static bool IsEnabled(Level level, const char* category);
+  // Never waits for stderr, but drops |message| when |category| is over its
+  // rate or the queue is full.
+  static void Write(Level level, const char* category,
+                    const std::string& message);
+  // Waits until the queued messages are written, e.g. before an abort.
+  static void Flush();
+
+  PluginLog() = delete;
+};
+
+class PluginLogMessage {
+ public:
+  PluginLogMessage(PluginLog::Level level, const char* category)
+      : level_(level), category_(category) {}
+  ~PluginLogMessage() { PluginLog::Write(level_, category_, stream_.str()); }
+
+  // Prevent copying.
+  PluginLogMessage(PluginLogMessage const&) = delete;
+  PluginLogMessage& operator=(PluginLogMessage const&) = delete;
+
+  std::ostream& stream() { return stream_; }
+
+ private:
+  const PluginLog::Level level_;
+  const char* const category_;
+  std::ostringstream stream_;
+};
+
+// E.g. PLUGIN_LOG(Warning, "gst") << "..."; without a trailing std::endl.
+// The message isn't formatted when the level of the category is lower.
+#define PLUGIN_LOG(level, category)                          \
+  if (!PluginLog::IsEnabled(PluginLog::k##level, category)) { \
+  } else                                                     \
+    PluginLogMessage(PluginLog::k##level, category).stream()
+
+#endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_PLUGIN_LOG_H_
@@ -0,0 +1,207 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "plugin_stats.h"
+
+#include <gst/gst.h>
+
+#include <iostream>
+#include <sstream>
+
+namespace {
+// Renamed whenever SharedState, Source or SharedEntry changes.
+constexpr char kStateQuark[] = "elinux-plugin-stats-1";
+
+constexpr const char* kCounterNames[] = {
+    "frames_decoded", "frames_dropped", "frames_rendered", "bytes_copied",
+    "queue_level",    "reconnects",     "bus_errors",
+};
+constexpr const char* kCounterKeys[] = {
+    "framesDecoded", "framesDropped", "framesRendered", "bytesCopied",
+    "queueLevel",    "reconnects",    "busErrors",
+};
+static_assert(sizeof(kCounterNames) / sizeof(kCounterNames[0]) ==
+                  PluginStats::kCounterCount,
+              "A counter has no name");
+static_assert(sizeof(kCounterKeys) / sizeof(kCounterKeys[0]) ==
+                  PluginStats::kCounterCount,
+              "A counter has no key");
+
+// Plain C structs, since the copies may not be built by the same version of
+// the plugins.
+struct SharedEntry {
+  gchar plugin[32];
+  gchar id[64];
+  gchar decoder[64];
+  guint64 values[PluginStats::kCounterCount];
+};
+
+struct Source {
+  // Fills the SharedEntry, or returns 0 if the counters have no id yet.
+  int (*collect)(void* data, void* entry);
+  void* data;
+};
+
+struct SharedState {
+  GMutex mutex;
+  GList* sources;
+};
+
+// Looked up once per copy, so that the counters can still be removed once
+// another plugin has deinitialized GStreamer. Never freed for the same
+// reason.
+SharedState* GetState() {
+  static SharedState* const state = []() {
+    auto* registry = gst_registry_get();
+    const auto quark = g_quark_from_static_string(kStateQuark);
+    GST_OBJECT_LOCK(registry);
+    auto* state = static_cast<SharedState*>(
+        g_object_get_qdata(G_OBJECT(registry), quark));
+    if (!state) {
+      state = g_new0(SharedState, 1);
+      g_mutex_init(&state->mutex);
+      g_object_set_qdata(G_OBJECT(registry), quark, state);
+    }
+    GST_OBJECT_UNLOCK(registry);
+    return state;
+  }();
+  return state;
+}
+
+std::string EscapeLabel(const std::string& value) {
+  std::string escaped;
+  for (const char c : value) {
+    if (c == '\n') {
+      escaped += "\\n";
+      continue;
+    }
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+}  // namespace
+
+PluginStats::PluginStats(const char* plugin) : plugin_(plugin) {
+  for (auto& value : values_) {
+    value.store(0, std::memory_order_relaxed);
+  }
+  auto* source = g_new(Source, 1);
+  source->collect = CollectEntry;
+  source->data = this;
+  auto* state = GetState();
+  g_mutex_lock(&state->mutex);
+  state->sources = g_list_prepend(state->sources, source);
+  g_mutex_unlock(&state->mutex);
+}
+
+PluginStats::~PluginStats() {
+  // Waits for a Collect() in progress.
+  auto* state = GetState();
+  g_mutex_lock(&state->mutex);
+  for (auto* link = state->sources; link; link = link->next) {
+    auto* source = static_cast<Source*>(link->data);
+    if (source->data == this) {
+      state->sources = g_list_delete_link(state->sources, link);
+      g_free(source);
+      break;
+    }
+  }
+  g_mutex_unlock(&state->mutex);
+}
+
+void PluginStats::SetId(const std::string& id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  id_ = id;
+}
+
+void PluginStats::SetDecoder(const std::string& decoder) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  decoder_ = decoder;
+}
+
+// static
+int PluginStats::CollectEntry(void* data, void* entry) {
+  auto* self = static_cast<PluginStats*>(data);
+  auto* shared_entry = static_cast<SharedEntry*>(entry);
+  std::lock_guard<std::mutex> lock(self->mutex_);
+  if (self->id_.empty()) {
+    return 0;
+  }
+  g_strlcpy(shared_entry->plugin, self->plugin_, sizeof(shared_entry->plugin));
+  g_strlcpy(shared_entry->id, self->id_.c_str(), sizeof(shared_entry->id));
+  g_strlcpy(shared_entry->decoder, self->decoder_.c_str(),
+            sizeof(shared_entry->decoder));
+  for (int i = 0; i < kCounterCount; i++) {
+    shared_entry->values[i] =
+        self->values_[i].load(std::memory_order_relaxed);
+  }
+  return 1;
+}
+
+// static
+std::vector<PluginStats::Entry> PluginStats::Collect() {
+  std::vector<Entry> entries;
+  auto* state = GetState();
+  g_mutex_lock(&state->mutex);
+  for (auto* link = state->sources; link; link = link->next) {
+    auto* source = static_cast<Source*>(link->data);
+    SharedEntry shared_entry = {};
+    if (!source->collect(source->data, &shared_entry)) {
+      continue;
+    }
+    Entry entry;
+    entry.plugin = shared_entry.plugin;
+    entry.id = shared_entry.id;
+    entry.decoder = shared_entry.decoder;
+    for (int i = 0; i < kCounterCount; i++) {
+      entry.values[i] = shared_entry.values[i];
+    }
+    entries.push_back(std::move(entry));
+  }
+  g_mutex_unlock(&state->mutex);
+  return entries;
+}
+
+// static
+const char* PluginStats::GetCounterName(Counter counter) {
+  return kCounterNames[counter];
+}
+
+// static
+const char* PluginStats::GetCounterKey(Counter counter) {
+  return kCounterKeys[counter];
+}
+
+// static
+bool PluginStats::WritePrometheus(const std::string& path) {
+  const auto entries = Collect();
+  std::ostringstream text;
+  for (int i = 0; i < kCounterCount; i++) {
+    const auto counter = static_cast<Counter>(i);
+    const auto is_gauge = counter == kQueueLevel;
+    const auto name = std::string("elinux_plugin_") + GetCounterName(counter) +
+                      (is_gauge ? "" : "_total");
+    text << "# TYPE " << name << (is_gauge ? " gauge" : " counter") << "\n";
+    for (const auto& entry : entries) {
+      text << name << "{plugin=\"" << EscapeLabel(entry.plugin) << "\",id=\""
+           << EscapeLabel(entry.id) << "\",decoder=\""
+           << EscapeLabel(entry.decoder) << "\"} " << entry.values[i] << "\n";
+    }
+  }
+  const auto contents = text.str();
+  GError* error = nullptr;
+  // Written to a temporary file and renamed, so that a reader never sees a
+  // partial one.
+  if (!g_file_set_contents(path.c_str(), contents.c_str(), contents.size(),
+                           &error)) {
+    std::cerr << "Failed to write " << path << ": " << error->message
+              << std::endl;
+    g_clear_error(&error);
+    return false;
+  }
+  return true;
+}
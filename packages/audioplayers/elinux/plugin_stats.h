@@ -0,0 +1,80 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_PLUGIN_STATS_H_
+#define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_PLUGIN_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// The counters of one player or camera, updated without a lock from any
+// thread. video_player, camera and audioplayers each have a copy of this
+// file, but the copies list their counters in one place, attached to the
+// default GstRegistry as GstRuntime's state is, so that Collect() from any
+// plugin returns those of all of them.
+class PluginStats {
+ public:
+  enum Counter {
+    kFramesDecoded,
+    kFramesDropped,
+    kFramesRendered,
+    kBytesCopied,
+    // A level rather than a count, e.g. the buffering percentage.
+    kQueueLevel,
+    kReconnects,
+    kBusErrors,
+    kCounterCount,
+  };
+
+  struct Entry {
+    std::string plugin;
+    std::string id;
+    std::string decoder;
+    uint64_t values[kCounterCount];
+  };
+
+  // Must be constructed while GStreamer is initialized. The counters are
+  // listed once they have an id.
+  explicit PluginStats(const char* plugin);
+  ~PluginStats();
+
+  // Prevent copying.
+  PluginStats(PluginStats const&) = delete;
+  PluginStats& operator=(PluginStats const&) = delete;
+
+  void Add(Counter counter, uint64_t value = 1) {
+    values_[counter].fetch_add(value, std::memory_order_relaxed);
+  }
+  void Set(Counter counter, uint64_t value) {
+    values_[counter].store(value, std::memory_order_relaxed);
+  }
+  // E.g. the texture id of the player.
+  void SetId(const std::string& id);
+  // The factory name of the decoder in use.
+  void SetDecoder(const std::string& decoder);
+
+  // The counters of all the plugins of the process.
+  static std::vector<Entry> Collect();
+  // The snake case name of |counter| used in the Prometheus text format,
+  // e.g. "frames_decoded", and its camel case name, e.g. "framesDecoded".
+  static const char* GetCounterName(Counter counter);
+  static const char* GetCounterKey(Counter counter);
+  // Writes Collect() to |path| in the Prometheus text format, e.g. for the
+  // textfile collector of node_exporter. The file is replaced at once.
+  static bool WritePrometheus(const std::string& path);
+
+ private:
+  static int CollectEntry(void* data, void* entry);
+
+  const char* const plugin_;
+  std::atomic<uint64_t> values_[kCounterCount];
+  std::mutex mutex_;
+  std::string id_;
+  std::string decoder_;
+};
+
+#endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_PLUGIN_STATS_H_
@@ -0,0 +1,60 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_POSITION_TICKER_H_
+#define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_POSITION_TICKER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Calls a tick function of each registered player at its own rate, from one
+// thread shared by all the players, so that the position is pushed to Dart
+// instead of being polled by a message per player. The ticks are aligned to
+// the multiples of their intervals, so that the players ticking at the same
+// rate are ticked in one wakeup.
+class PositionTicker {
+ public:
+  using Tick = std::function<void()>;
+
+  PositionTicker() = default;
+  ~PositionTicker();
+
+  // Prevent copying.
+  PositionTicker(PositionTicker const&) = delete;
+  PositionTicker& operator=(PositionTicker const&) = delete;
+
+  // Calls |tick| every |interval_ms| milliseconds for |player_id|, or stops
+  // if |interval_ms| is zero or less.
+  void Set(const std::string& player_id, int64_t interval_ms, Tick tick);
+  // Stops the ticks of |player_id|. No tick runs once this returns.
+  void Remove(const std::string& player_id);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    std::chrono::milliseconds interval;
+    Clock::time_point next_tick;
+    Tick tick;
+  };
+
+  static Clock::time_point GetNextTick(Clock::time_point now,
+                                       std::chrono::milliseconds interval);
+  void Run();
+
+  // Also held while ticking, so that Remove() waits for a running tick.
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::map<std::string, Entry> entries_;
+  std::thread thread_;
+  bool is_stopping_ = false;
+};
+
+#endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_POSITION_TICKER_H_
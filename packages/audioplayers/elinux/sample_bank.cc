@@ -0,0 +1,163 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sample_bank.h"
+
+#include <gst/app/gstappsink.h>
+
+#include <iostream>
+#include <vector>
+
+#include "audio_engine.h"
+
+namespace {
+constexpr size_t kFrameBytes = AudioEngine::kChannels * sizeof(float);
+// Longer sounds are streamed by playbin as usual.
+constexpr size_t kMaxSampleSize = 10 * AudioEngine::kSampleRate * kFrameBytes;
+constexpr size_t kMaxBankSize = 32 * 1024 * 1024;
+constexpr GstClockTime kPullInterval = 100 * GST_MSECOND;
+constexpr gint64 kDecodeTimeoutUs = 5 * G_USEC_PER_SEC;
+
+void OnPadAdded(GstElement* decoder, GstPad* pad, gpointer user_data) {
+  auto* convert = reinterpret_cast<GstElement*>(user_data);
+  auto* sink_pad = gst_element_get_static_pad(convert, "sink");
+  if (!gst_pad_is_linked(sink_pad)) {
+    // Fails but for the first audio stream.
+    gst_pad_link(pad, sink_pad);
+  }
+  gst_object_unref(sink_pad);
+}
+}  // namespace
+
+// static
+SampleBank& SampleBank::GetInstance() {
+  static SampleBank instance;
+  return instance;
+}
+
+GstBuffer* SampleBank::Load(const std::string& uri) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = index_.find(uri);
+    if (iter != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, iter->second);
+      return gst_buffer_ref(iter->second->second);
+    }
+  }
+
+  // Decodes without the lock, so that other players aren't held up. A
+  // sound loaded by two players at once is decoded twice.
+  auto* samples = Decode(uri);
+  if (!samples) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (index_.find(uri) == index_.end()) {
+    entries_.emplace_front(uri, gst_buffer_ref(samples));
+    index_[uri] = entries_.begin();
+    total_size_ += gst_buffer_get_size(samples);
+    Trim();
+  }
+  return samples;
+}
+
+size_t SampleBank::GetSize() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_size_;
+}
+
+GstBuffer* SampleBank::Decode(const std::string& uri) {
+  auto* pipeline = gst_pipeline_new("sample-bank");
+  auto* decoder = gst_element_factory_make("uridecodebin", nullptr);
+  auto* convert = gst_element_factory_make("audioconvert", nullptr);
+  auto* resample = gst_element_factory_make("audioresample", nullptr);
+  auto* filter = gst_element_factory_make("capsfilter", nullptr);
+  auto* sink = gst_element_factory_make("appsink", nullptr);
+  if (!pipeline || !decoder || !convert || !resample || !filter || !sink) {
+    std::cerr << "Failed to create a decoder of the sample bank" << std::endl;
+    for (auto* element : {decoder, convert, resample, filter, sink, pipeline}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    return nullptr;
+  }
+  auto* caps = AudioEngine::CreateCaps();
+  g_object_set(G_OBJECT(decoder), "uri", uri.c_str(), NULL);
+  g_object_set(G_OBJECT(filter), "caps", caps, NULL);
+  g_object_set(G_OBJECT(sink), "sync", FALSE, NULL);
+  gst_caps_unref(caps);
+  gst_bin_add_many(GST_BIN(pipeline), decoder, convert, resample, filter, sink,
+                   NULL);
+  gst_element_link_many(convert, resample, filter, sink, NULL);
+  g_signal_connect(decoder, "pad-added", G_CALLBACK(OnPadAdded), convert);
+
+  std::vector<uint8_t> data;
+  auto is_done = false;
+  auto* bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline));
+  if (gst_element_set_state(pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    std::cerr << "Failed to decode " << uri << std::endl;
+  } else {
+    const auto deadline = g_get_monotonic_time() + kDecodeTimeoutUs;
+    while (true) {
+      auto* sample =
+          gst_app_sink_try_pull_sample(GST_APP_SINK(sink), kPullInterval);
+      if (sample) {
+        GstMapInfo map;
+        auto* buffer = gst_sample_get_buffer(sample);
+        if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+          data.insert(data.end(), map.data, map.data + map.size);
+          gst_buffer_unmap(buffer, &map);
+        }
+        gst_sample_unref(sample);
+        if (data.size() > kMaxSampleSize) {
+          break;
+        }
+        continue;
+      }
+      if (gst_app_sink_is_eos(GST_APP_SINK(sink))) {
+        is_done = true;
+        break;
+      }
+      auto* message = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+      if (message) {
+        GError* error;
+        gchar* debug;
+        gst_message_parse_error(message, &error, &debug);
+        std::cerr << "Failed to decode " << uri << ": " << error->message
+                  << std::endl;
+        g_free(debug);
+        g_error_free(error);
+        gst_message_unref(message);
+        break;
+      }
+      if (g_get_monotonic_time() > deadline) {
+        std::cerr << "Timed out decoding " << uri << std::endl;
+        break;
+      }
+    }
+  }
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(bus);
+  gst_object_unref(pipeline);
+
+  if (!is_done || data.empty()) {
+    return nullptr;
+  }
+  auto* samples = gst_buffer_new_allocate(nullptr, data.size(), nullptr);
+  gst_buffer_fill(samples, 0, data.data(), data.size());
+  return samples;
+}
+
+void SampleBank::Trim() {
+  // Players still playing an evicted sound keep its samples until they stop.
+  while (total_size_ > kMaxBankSize && entries_.size() > 1) {
+    auto& entry = entries_.back();
+    total_size_ -= gst_buffer_get_size(entry.second);
+    gst_buffer_unref(entry.second);
+    index_.erase(entry.first);
+    entries_.pop_back();
+  }
+}
@@ -0,0 +1,53 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_SAMPLE_BANK_H_
+#define PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_SAMPLE_BANK_H_
+
+#include <gst/gst.h>
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Keeps short sounds decoded in memory, in the format of AudioEngine, so
+// that a sound effect played again is started as a voice of the engine
+// without being demuxed and decoded again. The least recently used sounds
+// are evicted once the bank exceeds its size.
+class SampleBank {
+ public:
+  static SampleBank& GetInstance();
+
+  // Prevent copying.
+  SampleBank(SampleBank const&) = delete;
+  SampleBank& operator=(SampleBank const&) = delete;
+
+  // Returns the samples of |uri|, decoding it unless it's in the bank, or
+  // nullptr if it fails or the sound is too long for the bank. The caller
+  // owns the reference.
+  GstBuffer* Load(const std::string& uri);
+  // Returns the bytes of the sounds in the bank.
+  size_t GetSize();
+
+ private:
+  SampleBank() = default;
+  ~SampleBank() = default;
+
+  // Decodes |uri| as fast as it can be read.
+  GstBuffer* Decode(const std::string& uri);
+  // Must be called with |mutex_| held.
+  void Trim();
+
+  std::mutex mutex_;
+  // The most recently used first.
+  std::list<std::pair<std::string, GstBuffer*>> entries_;
+  std::unordered_map<std::string,
+                     std::list<std::pair<std::string, GstBuffer*>>::iterator>
+      index_;
+  size_t total_size_ = 0;
+};
+
+#endif  // PACKAGES_AUDIOPLAYERS_AUDIOPLAYERS_ELINUX_SAMPLE_BANK_H_
@@ -0,0 +1,15 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'src/platform_tasks.dart';
+
+/// Starts sending the events of the native players to Dart. The players
+/// themselves are driven by the method channel implementation of
+/// audioplayers_platform_interface.
+class AudioplayersElinux {
+  /// Called when the plugins are registered, before main().
+  static void registerWith() {
+    PlatformTasks.start('xyz.luan/audioplayers/platformTasks');
+  }
+}
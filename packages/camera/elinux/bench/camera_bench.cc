@@ -0,0 +1,514 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Runs a camera with GstCamera, without Flutter, and fetches its preview at
+// the rate of a simulated vsync, as the texture callback of the plugin does.
+// Prints what it measured as JSON, for regression tracking. Long runs, with
+// the camera reopened periodically, show the growth of the RSS.
+//
+// $ camera_bench [--source=device|testsrc] [--device=/dev/video0]
+//       [--width=1280] [--height=720] [--fps=30] [--duration=10]
+//       [--vsync=60] [--image-stream] [--picture-interval=5]
+//       [--restart-interval=0] [--rss-interval=10]
+//
+// With --source=testsrc, videotestsrc is written to |device|, which must be
+// a v4l2loopback device, and the camera reads it back.
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/method_call.h>
+#include <flutter/standard_method_codec.h>
+#include <gst/gst.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "camera_stream_handler.h"
+#include "channels/event_channel_image_stream.h"
+#include "gst_camera.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr int32_t kBytesPerPixel = 4;
+// How long a picture may take before it counts as failed.
+constexpr auto kPictureTimeout = std::chrono::seconds(10);
+
+struct Options {
+  // "device" or "testsrc".
+  std::string source = "device";
+  std::string device = "/dev/video0";
+  int width = 1280;
+  int height = 720;
+  int fps = 30;
+  int duration_s = 10;
+  int vsync_hz = 60;
+  // Also sends every fetched frame on the image stream.
+  bool image_stream = false;
+  // Zero disables these.
+  int picture_interval_s = 5;
+  int restart_interval_s = 0;
+  int rss_interval_s = 10;
+};
+
+// Counts the frames, and tells the vsync loop when one is pending, as the
+// plugin marks the texture frame available.
+class BenchStreamHandler : public CameraStreamHandler {
+ public:
+  uint64_t GetFrameCount() const { return frames_; }
+  // Returns whether a frame has arrived since the last call.
+  bool TakeFramePending() { return frame_pending_.exchange(false); }
+
+ protected:
+  void OnNotifyFrameDecodedInternal() override {
+    frames_++;
+    frame_pending_ = true;
+  }
+
+ private:
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<bool> frame_pending_{false};
+};
+
+// Stands in for the engine: answers the handlers of the channels, and
+// counts what is sent to Dart.
+class StubMessenger : public flutter::BinaryMessenger {
+ public:
+  void Send(const std::string& channel, const uint8_t* message,
+            size_t message_size,
+            flutter::BinaryReply reply = nullptr) const override {
+    sent_bytes_ += message_size;
+  }
+
+  void SetMessageHandler(const std::string& channel,
+                         flutter::BinaryMessageHandler handler) override {
+    handlers_[channel] = std::move(handler);
+  }
+
+  // Calls |method| on |channel|, as Dart would.
+  void CallMethod(const std::string& channel, const std::string& method) {
+    auto it = handlers_.find(channel);
+    if (it == handlers_.end() || !it->second) {
+      return;
+    }
+    const auto message =
+        flutter::StandardMethodCodec::GetInstance().EncodeMethodCall(
+            flutter::MethodCall<flutter::EncodableValue>(method, nullptr));
+    it->second(message->data(), message->size(),
+               [](const uint8_t* reply, size_t reply_size) {});
+  }
+
+  uint64_t GetSentBytes() const { return sent_bytes_; }
+
+ private:
+  std::map<std::string, flutter::BinaryMessageHandler> handlers_;
+  mutable std::atomic<uint64_t> sent_bytes_{0};
+};
+
+struct Summary {
+  int64_t p50 = 0;
+  int64_t p95 = 0;
+  int64_t p99 = 0;
+  int64_t max = 0;
+  int64_t mean = 0;
+  size_t count = 0;
+};
+
+Summary Summarize(std::vector<int64_t> samples) {
+  Summary summary;
+  if (samples.empty()) {
+    return summary;
+  }
+  std::sort(samples.begin(), samples.end());
+  const auto at = [&samples](size_t percent) {
+    return samples[std::min(samples.size() - 1,
+                            samples.size() * percent / 100)];
+  };
+  summary.p50 = at(50);
+  summary.p95 = at(95);
+  summary.p99 = at(99);
+  summary.max = samples.back();
+  int64_t total = 0;
+  for (const auto sample : samples) {
+    total += sample;
+  }
+  summary.mean = total / static_cast<int64_t>(samples.size());
+  summary.count = samples.size();
+  return summary;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const auto equal = arg.find('=');
+    const auto name = arg.substr(0, equal);
+    const auto value = equal == std::string::npos ? "" : arg.substr(equal + 1);
+    if (name == "--source") {
+      options.source = value;
+    } else if (name == "--device") {
+      options.device = value;
+    } else if (name == "--width") {
+      options.width = std::atoi(value.c_str());
+    } else if (name == "--height") {
+      options.height = std::atoi(value.c_str());
+    } else if (name == "--fps") {
+      options.fps = std::atoi(value.c_str());
+    } else if (name == "--duration") {
+      options.duration_s = std::atoi(value.c_str());
+    } else if (name == "--vsync") {
+      options.vsync_hz = std::atoi(value.c_str());
+    } else if (name == "--image-stream") {
+      options.image_stream = true;
+    } else if (name == "--picture-interval") {
+      options.picture_interval_s = std::atoi(value.c_str());
+    } else if (name == "--restart-interval") {
+      options.restart_interval_s = std::atoi(value.c_str());
+    } else if (name == "--rss-interval") {
+      options.rss_interval_s = std::atoi(value.c_str());
+    } else {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return false;
+    }
+  }
+  if (options.source != "device" && options.source != "testsrc") {
+    std::cerr << "Unknown source: " << options.source << std::endl;
+    return false;
+  }
+  if (options.width <= 0 || options.height <= 0 || options.fps <= 0 ||
+      options.duration_s <= 0 || options.vsync_hz <= 0 ||
+      options.picture_interval_s < 0 || options.restart_interval_s < 0 ||
+      options.rss_interval_s < 0) {
+    std::cerr << "Invalid size, rate or interval" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Writes videotestsrc to the v4l2loopback device of |options|.
+GstElement* StartTestSource(const Options& options) {
+  const auto description =
+      "videotestsrc is-live=true pattern=ball ! video/x-raw,format=YUY2,"
+      "width=" +
+      std::to_string(options.width) +
+      ",height=" + std::to_string(options.height) +
+      ",framerate=" + std::to_string(options.fps) +
+      "/1 ! v4l2sink device=\"" + options.device + "\"";
+  GError* error = nullptr;
+  auto* pipeline = gst_parse_launch(description.c_str(), &error);
+  if (!pipeline) {
+    std::cerr << "Failed to create the test source: " << error->message
+              << std::endl;
+    g_clear_error(&error);
+    return nullptr;
+  }
+  if (gst_element_set_state(pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    std::cerr << "Failed to write to " << options.device
+              << ", which must be a v4l2loopback device" << std::endl;
+    gst_object_unref(pipeline);
+    return nullptr;
+  }
+  return pipeline;
+}
+
+std::unique_ptr<GstCamera> OpenCamera(const Options& options,
+                                      BenchStreamHandler*& handler) {
+  auto stream_handler = std::make_unique<BenchStreamHandler>();
+  handler = stream_handler.get();
+  GstCamera::PreviewConfig config;
+  config.width = options.width;
+  config.height = options.height;
+  config.fps = options.fps;
+  auto camera = std::make_unique<GstCamera>(std::move(stream_handler),
+                                            options.device, config);
+  if (!camera->Play()) {
+    std::cerr << "Failed to play " << options.device << std::endl;
+    return nullptr;
+  }
+  return camera;
+}
+
+// Takes a picture and returns how long it took in microseconds, or -1 if
+// it failed or timed out.
+int64_t TakePicture(GstCamera& camera) {
+  // Shared with the callback, which may still come after a timeout.
+  struct Picture {
+    std::mutex mutex;
+    std::condition_variable done;
+    bool is_done = false;
+    std::string path;
+  };
+  auto picture = std::make_shared<Picture>();
+  const auto start = Clock::now();
+  camera.TakePicture([picture](const std::string& captured_file_path) {
+    std::lock_guard<std::mutex> lock(picture->mutex);
+    picture->path = captured_file_path;
+    picture->is_done = true;
+    picture->done.notify_one();
+  });
+  std::unique_lock<std::mutex> lock(picture->mutex);
+  if (!picture->done.wait_for(lock, kPictureTimeout,
+                              [&picture] { return picture->is_done; })) {
+    std::cerr << "A picture timed out" << std::endl;
+    return -1;
+  }
+  if (picture->path.empty()) {
+    return -1;
+  }
+  std::remove(picture->path.c_str());
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                               start)
+      .count();
+}
+
+int64_t GetCpuTimeUs() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (static_cast<int64_t>(usage.ru_utime.tv_sec) +
+          usage.ru_stime.tv_sec) *
+             1000000 +
+         usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+int64_t GetRssKb() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0;
+  int64_t resident = 0;
+  if (!(statm >> size >> resident)) {
+    return 0;
+  }
+  return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+int64_t GetPeakRssKb() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// The slope of the least-squares line through |samples|, in kB per hour.
+double GetGrowthKbPerHour(
+    const std::vector<std::pair<double, int64_t>>& samples) {
+  if (samples.size() < 2) {
+    return 0;
+  }
+  double mean_t = 0;
+  double mean_rss = 0;
+  for (const auto& [t, rss] : samples) {
+    mean_t += t;
+    mean_rss += rss;
+  }
+  mean_t /= samples.size();
+  mean_rss /= samples.size();
+  double covariance = 0;
+  double variance = 0;
+  for (const auto& [t, rss] : samples) {
+    covariance += (t - mean_t) * (rss - mean_rss);
+    variance += (t - mean_t) * (t - mean_t);
+  }
+  return variance > 0 ? covariance / variance * 3600 : 0;
+}
+
+void PrintSummary(const char* name, const Summary& summary) {
+  std::printf(
+      "  \"%s\": {\"p50\": %lld, \"p95\": %lld, \"p99\": %lld, \"max\": %lld, "
+      "\"mean\": %lld, \"count\": %zu},\n",
+      name, static_cast<long long>(summary.p50),
+      static_cast<long long>(summary.p95),
+      static_cast<long long>(summary.p99),
+      static_cast<long long>(summary.max),
+      static_cast<long long>(summary.mean), summary.count);
+}
+
+int Run(const Options& options) {
+  GstElement* test_source = nullptr;
+  if (options.source == "testsrc") {
+    test_source = StartTestSource(options);
+    if (!test_source) {
+      return 1;
+    }
+  }
+
+  StubMessenger messenger;
+  EventChannelImageStream image_stream(&messenger);
+  if (options.image_stream) {
+    messenger.CallMethod("plugins.flutter.io/camera/imageStream", "listen");
+  }
+
+  BenchStreamHandler* handler = nullptr;
+  auto camera = OpenCamera(options, handler);
+  if (!camera) {
+    if (test_source) {
+      gst_element_set_state(test_source, GST_STATE_NULL);
+      gst_object_unref(test_source);
+    }
+    return 1;
+  }
+
+  std::vector<int64_t> fetch_times_us;
+  std::vector<int64_t> send_times_us;
+  std::vector<int64_t> picture_times_us;
+  std::vector<std::pair<double, int64_t>> rss_samples;
+  uint64_t frames = 0;
+  uint64_t failed_pictures = 0;
+  uint64_t restarts = 0;
+
+  const auto start_cpu_us = GetCpuTimeUs();
+  const auto start = Clock::now();
+  const auto end = start + std::chrono::seconds(options.duration_s);
+  const auto period = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / options.vsync_hz));
+  auto next_vsync = start;
+  auto next_picture = start + std::chrono::seconds(options.picture_interval_s);
+  auto next_restart = start + std::chrono::seconds(options.restart_interval_s);
+  auto next_rss_sample = start;
+  while (Clock::now() < end) {
+    next_vsync += period;
+    std::this_thread::sleep_until(next_vsync);
+    const auto now = Clock::now();
+
+    if (options.rss_interval_s > 0 && now >= next_rss_sample) {
+      rss_samples.emplace_back(
+          std::chrono::duration<double>(now - start).count(), GetRssKb());
+      next_rss_sample += std::chrono::seconds(options.rss_interval_s);
+    }
+    if (options.restart_interval_s > 0 && now >= next_restart) {
+      frames += handler->GetFrameCount();
+      camera->Stop();
+      camera = OpenCamera(options, handler);
+      if (!camera) {
+        break;
+      }
+      restarts++;
+      next_restart += std::chrono::seconds(options.restart_interval_s);
+    }
+    if (options.picture_interval_s > 0 && now >= next_picture) {
+      const auto picture_time_us = TakePicture(*camera);
+      if (picture_time_us < 0) {
+        failed_pictures++;
+      } else {
+        picture_times_us.push_back(picture_time_us);
+      }
+      next_picture += std::chrono::seconds(options.picture_interval_s);
+    }
+
+    if (!handler->TakeFramePending()) {
+      continue;
+    }
+    int32_t width = 0;
+    int32_t height = 0;
+    const auto fetch_start = Clock::now();
+    const auto* pixels = camera->GetPreviewFrameBuffer(width, height);
+    fetch_times_us.push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                              fetch_start)
+            .count());
+    if (!options.image_stream || !pixels) {
+      continue;
+    }
+
+    EventChannelImageStream::Plane plane;
+    plane.bytes.assign(pixels, pixels + static_cast<size_t>(width) * height *
+                                            kBytesPerPixel);
+    plane.bytes_per_row = width * kBytesPerPixel;
+    plane.bytes_per_pixel = kBytesPerPixel;
+    plane.width = width;
+    plane.height = height;
+    std::vector<EventChannelImageStream::Plane> planes;
+    planes.push_back(std::move(plane));
+    const auto send_start = Clock::now();
+    image_stream.Send(width, height,
+                      EventChannelImageStream::kImageFormatRGBA8888,
+                      std::move(planes), camera->GetPreviewFrameMetadata());
+    send_times_us.push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                              send_start)
+            .count());
+  }
+
+  const auto elapsed_s =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  const auto cpu_percent =
+      (GetCpuTimeUs() - start_cpu_us) / 1e6 / elapsed_s * 100.0;
+  int32_t preview_width = 0;
+  int32_t preview_height = 0;
+  double preview_fps = 0;
+  if (camera) {
+    frames += handler->GetFrameCount();
+    camera->GetNegotiatedPreview(preview_width, preview_height, preview_fps);
+  }
+  const auto rss_kb = GetRssKb();
+
+  std::printf("{\n");
+  std::printf("  \"source\": \"%s\",\n", options.source.c_str());
+  std::printf("  \"device\": \"%s\",\n", options.device.c_str());
+  std::printf("  \"width\": %d,\n  \"height\": %d,\n", preview_width,
+              preview_height);
+  std::printf("  \"negotiated_fps\": %.2f,\n", preview_fps);
+  std::printf("  \"duration_s\": %.3f,\n", elapsed_s);
+  std::printf("  \"vsync_hz\": %d,\n", options.vsync_hz);
+  std::printf("  \"frames\": %llu,\n", static_cast<unsigned long long>(frames));
+  std::printf("  \"preview_fps\": %.2f,\n", frames / elapsed_s);
+  std::printf("  \"fetch_fps\": %.2f,\n", fetch_times_us.size() / elapsed_s);
+  PrintSummary("fetch_us", Summarize(fetch_times_us));
+  PrintSummary("image_stream_send_us", Summarize(send_times_us));
+  std::printf("  \"image_stream_bytes\": %llu,\n",
+              static_cast<unsigned long long>(messenger.GetSentBytes()));
+  PrintSummary("picture_us", Summarize(picture_times_us));
+  std::printf("  \"failed_pictures\": %llu,\n",
+              static_cast<unsigned long long>(failed_pictures));
+  std::printf("  \"restarts\": %llu,\n",
+              static_cast<unsigned long long>(restarts));
+  std::printf("  \"cpu_percent\": %.1f,\n", cpu_percent);
+  std::printf("  \"rss_kb\": %lld,\n", static_cast<long long>(rss_kb));
+  std::printf("  \"peak_rss_kb\": %lld,\n",
+              static_cast<long long>(GetPeakRssKb()));
+  std::printf("  \"rss_growth_kb_per_hour\": %.1f,\n",
+              GetGrowthKbPerHour(rss_samples));
+  std::printf("  \"rss_samples\": [");
+  for (size_t i = 0; i < rss_samples.size(); i++) {
+    std::printf("%s[%.1f, %lld]", i ? ", " : "", rss_samples[i].first,
+                static_cast<long long>(rss_samples[i].second));
+  }
+  std::printf("]\n}\n");
+
+  // Null if it failed to reopen.
+  const bool ok = camera != nullptr;
+  if (camera) {
+    camera->Stop();
+    camera = nullptr;
+  }
+  if (test_source) {
+    gst_element_set_state(test_source, GST_STATE_NULL);
+    gst_object_unref(test_source);
+  }
+  return ok ? 0 : 1;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    return 2;
+  }
+  GstCamera::GstLibraryLoad();
+  const auto result = Run(options);
+  GstCamera::GstLibraryUnload();
+  return result;
+}
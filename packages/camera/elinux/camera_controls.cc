@@ -0,0 +1,261 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "camera_controls.h"
+
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace {
+// V4L2_CID_AUTO_EXPOSURE_BIAS is in 0.001 EV.
+constexpr double kBiasUnitsPerEv = 1000.0;
+
+int Ioctl(int fd, unsigned long request, void* arg) {
+  int ret;
+  do {
+    ret = ioctl(fd, request, arg);
+  } while (ret < 0 && errno == EINTR);
+  return ret;
+}
+}  // namespace
+
+// static
+std::unique_ptr<CameraControls> CameraControls::Open(
+    const std::string& device_path) {
+  if (device_path.empty()) {
+    return nullptr;
+  }
+  const int fd = open(device_path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    std::cerr << "Failed to open the controls of " << device_path << ": "
+              << std::strerror(errno) << std::endl;
+    return nullptr;
+  }
+  return std::unique_ptr<CameraControls>(new CameraControls(fd));
+}
+
+CameraControls::CameraControls(int fd) : fd_(fd) {
+  QueryControls();
+  thread_ = std::thread([this]() { Run(); });
+}
+
+CameraControls::~CameraControls() {
+  std::deque<Task> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+    tasks.swap(tasks_);
+  }
+  cv_.notify_one();
+  thread_.join();
+  for (auto& task : tasks) {
+    task.on_applied(false);
+  }
+  close(fd_);
+}
+
+double CameraControls::GetMinExposureOffset() const {
+  return biases_.empty() ? 0.0 : biases_.front() / kBiasUnitsPerEv;
+}
+
+double CameraControls::GetMaxExposureOffset() const {
+  return biases_.empty() ? 0.0 : biases_.back() / kBiasUnitsPerEv;
+}
+
+double CameraControls::GetExposureOffsetStepSize() const {
+  if (biases_.size() < 2) {
+    return 0.0;
+  }
+  return (biases_.back() - biases_.front()) / kBiasUnitsPerEv /
+         (biases_.size() - 1);
+}
+
+void CameraControls::SetExposureMode(ExposureMode mode, OnApplied on_applied) {
+  const bool locked = mode == ExposureMode::kLocked;
+  Post(
+      [this, locked]() {
+        // The lock keeps the exposure the algorithm has reached, where
+        // switching to manual exposure may jump to a stale value.
+        if (lock_) {
+          return SetLock(V4L2_LOCK_EXPOSURE, locked) &&
+                 (locked || !exposure_auto_ ||
+                  SetControl(V4L2_CID_EXPOSURE_AUTO, exposure_auto_on_));
+        }
+        return exposure_auto_ &&
+               SetControl(V4L2_CID_EXPOSURE_AUTO,
+                          locked ? V4L2_EXPOSURE_MANUAL : exposure_auto_on_);
+      },
+      std::move(on_applied));
+}
+
+void CameraControls::SetFocusMode(FocusMode mode, OnApplied on_applied) {
+  const bool locked = mode == FocusMode::kLocked;
+  Post(
+      [this, locked]() {
+        if (lock_) {
+          return SetLock(V4L2_LOCK_FOCUS, locked) &&
+                 (locked || !focus_auto_ ||
+                  SetControl(V4L2_CID_FOCUS_AUTO, 1));
+        }
+        // The lens stays where the autofocus left it.
+        return focus_auto_ && SetControl(V4L2_CID_FOCUS_AUTO, locked ? 0 : 1);
+      },
+      std::move(on_applied));
+}
+
+void CameraControls::SetWhiteBalanceMode(WhiteBalanceMode mode,
+                                         OnApplied on_applied) {
+  const bool locked = mode == WhiteBalanceMode::kLocked;
+  Post(
+      [this, locked]() {
+        if (lock_) {
+          return SetLock(V4L2_LOCK_WHITE_BALANCE, locked) &&
+                 (locked || !white_balance_auto_ ||
+                  SetControl(V4L2_CID_AUTO_WHITE_BALANCE, 1));
+        }
+        return white_balance_auto_ &&
+               SetControl(V4L2_CID_AUTO_WHITE_BALANCE, locked ? 0 : 1);
+      },
+      std::move(on_applied));
+}
+
+void CameraControls::SetExposureOffset(double offset,
+                                       OnExposureOffsetApplied on_applied) {
+  if (biases_.empty()) {
+    Post([]() { return false; },
+         [on_applied](bool applied) { on_applied(false, 0.0); });
+    return;
+  }
+  size_t nearest = 0;
+  for (size_t i = 1; i < biases_.size(); i++) {
+    if (std::abs(biases_[i] / kBiasUnitsPerEv - offset) <
+        std::abs(biases_[nearest] / kBiasUnitsPerEv - offset)) {
+      nearest = i;
+    }
+  }
+  const auto index = bias_minimum_ + static_cast<int32_t>(nearest);
+  const auto applied_offset = biases_[nearest] / kBiasUnitsPerEv;
+  Post([this, index]() { return SetControl(V4L2_CID_AUTO_EXPOSURE_BIAS, index); },
+       [on_applied, applied_offset](bool applied) {
+         on_applied(applied, applied_offset);
+       });
+}
+
+void CameraControls::QueryControls() {
+  int32_t minimum;
+  int32_t maximum;
+  if (HasControl(V4L2_CID_EXPOSURE_AUTO, minimum, maximum)) {
+    // UVC cameras usually offer aperture priority rather than full auto.
+    for (const int32_t value :
+         {V4L2_EXPOSURE_AUTO, V4L2_EXPOSURE_APERTURE_PRIORITY}) {
+      v4l2_querymenu menu = {};
+      menu.id = V4L2_CID_EXPOSURE_AUTO;
+      menu.index = value;
+      if (value >= minimum && value <= maximum &&
+          !Ioctl(fd_, VIDIOC_QUERYMENU, &menu)) {
+        exposure_auto_ = true;
+        exposure_auto_on_ = value;
+        break;
+      }
+    }
+  }
+  focus_auto_ = HasControl(V4L2_CID_FOCUS_AUTO, minimum, maximum);
+  white_balance_auto_ =
+      HasControl(V4L2_CID_AUTO_WHITE_BALANCE, minimum, maximum);
+  lock_ = HasControl(V4L2_CID_3A_LOCK, minimum, maximum);
+
+  v4l2_queryctrl query = {};
+  query.id = V4L2_CID_AUTO_EXPOSURE_BIAS;
+  if (!Ioctl(fd_, VIDIOC_QUERYCTRL, &query) &&
+      !(query.flags & V4L2_CTRL_FLAG_DISABLED) &&
+      query.type == V4L2_CTRL_TYPE_INTEGER_MENU) {
+    bias_minimum_ = query.minimum;
+    for (int32_t index = query.minimum; index <= query.maximum; index++) {
+      v4l2_querymenu menu = {};
+      menu.id = V4L2_CID_AUTO_EXPOSURE_BIAS;
+      menu.index = index;
+      if (Ioctl(fd_, VIDIOC_QUERYMENU, &menu)) {
+        // The menu must be contiguous for the index to follow the offset.
+        biases_.clear();
+        break;
+      }
+      biases_.push_back(menu.value);
+    }
+  }
+}
+
+bool CameraControls::HasControl(uint32_t id, int32_t& minimum,
+                                int32_t& maximum) const {
+  v4l2_queryctrl query = {};
+  query.id = id;
+  if (Ioctl(fd_, VIDIOC_QUERYCTRL, &query) ||
+      (query.flags & V4L2_CTRL_FLAG_DISABLED)) {
+    return false;
+  }
+  minimum = query.minimum;
+  maximum = query.maximum;
+  return true;
+}
+
+bool CameraControls::GetControl(uint32_t id, int32_t& value) const {
+  v4l2_control control = {};
+  control.id = id;
+  if (Ioctl(fd_, VIDIOC_G_CTRL, &control)) {
+    return false;
+  }
+  value = control.value;
+  return true;
+}
+
+bool CameraControls::SetControl(uint32_t id, int32_t value) const {
+  v4l2_control control = {};
+  control.id = id;
+  control.value = value;
+  if (Ioctl(fd_, VIDIOC_S_CTRL, &control)) {
+    std::cerr << "Failed to set the control " << std::hex << id << std::dec
+              << " to " << value << ": " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool CameraControls::SetLock(int32_t bit, bool locked) const {
+  int32_t value = 0;
+  if (!GetControl(V4L2_CID_3A_LOCK, value)) {
+    return false;
+  }
+  return SetControl(V4L2_CID_3A_LOCK, locked ? (value | bit) : (value & ~bit));
+}
+
+void CameraControls::Post(std::function<bool()> apply, OnApplied on_applied) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back({std::move(apply), std::move(on_applied)});
+  }
+  cv_.notify_one();
+}
+
+void CameraControls::Run() {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return !tasks_.empty() || is_stopping_; });
+      if (is_stopping_) {
+        break;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task.on_applied(task.apply());
+  }
+}
@@ -0,0 +1,105 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_CONTROLS_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_CONTROLS_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "types/exposure_mode.h"
+#include "types/focus_mode.h"
+
+// Applies focus, exposure and white balance settings through the V4L2
+// controls of a camera, on a thread of its own.
+//
+// The device is opened a second time next to v4l2src, which V4L2 allows for
+// the controls. Some drivers take tens of milliseconds per control, so the
+// settings are queued and applied in order, and neither the platform thread
+// nor the streaming threads wait for them.
+class CameraControls {
+ public:
+  enum class WhiteBalanceMode {
+    kAuto,
+    kLocked,
+  };
+
+  // Called on the control thread once a setting has been applied, or with
+  // false if it couldn't be. Called with false by the destructor, on its
+  // thread, for the settings not applied yet.
+  using OnApplied = std::function<void(bool applied)>;
+  // Called with the exposure offset the camera applied, in EV.
+  using OnExposureOffsetApplied =
+      std::function<void(bool applied, double offset)>;
+
+  // Opens the controls of |device_path|. Returns nullptr if it can't be
+  // opened.
+  static std::unique_ptr<CameraControls> Open(const std::string& device_path);
+
+  // Fails the settings not applied yet, then closes the device.
+  ~CameraControls();
+
+  // Prevent copying.
+  CameraControls(CameraControls const&) = delete;
+  CameraControls& operator=(CameraControls const&) = delete;
+
+  bool SupportsExposureMode() const { return exposure_auto_ || lock_; }
+  bool SupportsFocusMode() const { return focus_auto_ || lock_; }
+  bool SupportsWhiteBalanceMode() const { return white_balance_auto_ || lock_; }
+  // In EV, all zero if the camera has no exposure bias.
+  double GetMinExposureOffset() const;
+  double GetMaxExposureOffset() const;
+  double GetExposureOffsetStepSize() const;
+
+  void SetExposureMode(ExposureMode mode, OnApplied on_applied);
+  void SetFocusMode(FocusMode mode, OnApplied on_applied);
+  void SetWhiteBalanceMode(WhiteBalanceMode mode, OnApplied on_applied);
+  // Applies the bias nearest to |offset|.
+  void SetExposureOffset(double offset, OnExposureOffsetApplied on_applied);
+
+ private:
+  struct Task {
+    std::function<bool()> apply;
+    OnApplied on_applied;
+  };
+
+  explicit CameraControls(int fd);
+
+  void QueryControls();
+  bool HasControl(uint32_t id, int32_t& minimum, int32_t& maximum) const;
+  bool GetControl(uint32_t id, int32_t& value) const;
+  bool SetControl(uint32_t id, int32_t value) const;
+  // Sets or clears |bit| of V4L2_CID_3A_LOCK.
+  bool SetLock(int32_t bit, bool locked) const;
+  void Post(std::function<bool()> apply, OnApplied on_applied);
+  void Run();
+
+  const int fd_;
+  // The controls the camera has, found once by QueryControls().
+  bool exposure_auto_ = false;
+  int32_t exposure_auto_on_ = 0;
+  bool focus_auto_ = false;
+  bool white_balance_auto_ = false;
+  bool lock_ = false;
+  // The values of the menu of V4L2_CID_AUTO_EXPOSURE_BIAS in 0.001 EV, by
+  // index from |bias_minimum_|.
+  std::vector<int64_t> biases_;
+  int32_t bias_minimum_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Guarded by |mutex_|.
+  std::deque<Task> tasks_;
+  bool is_stopping_ = false;
+  std::thread thread_;
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_CONTROLS_H_
@@ -0,0 +1,86 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "camera_device_monitor.h"
+
+#include <gst/gst.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+constexpr char kDefaultCameraName[] = "camera0";
+constexpr char kDeviceNodePrefix[] = "/dev/";
+
+// v4l2deviceprovider has named the property api.v4l2.path since 1.24.
+const gchar* GetDevicePath(const GstStructure* properties) {
+  const auto* path = gst_structure_get_string(properties, "api.v4l2.path");
+  if (!path) {
+    path = gst_structure_get_string(properties, "device.path");
+  }
+  return path;
+}
+}  // namespace
+
+// static
+std::vector<CameraDeviceMonitor::Device> CameraDeviceMonitor::Enumerate() {
+  std::vector<Device> devices;
+  auto* monitor = gst_device_monitor_new();
+  gst_device_monitor_add_filter(monitor, "Video/Source", nullptr);
+  // Probes the hardware without starting the monitor.
+  auto* list = gst_device_monitor_get_devices(monitor);
+  for (auto* item = list; item; item = item->next) {
+    auto* device = GST_DEVICE(item->data);
+    auto* properties = gst_device_get_properties(device);
+    const gchar* path = properties ? GetDevicePath(properties) : nullptr;
+    // Other providers, e.g. the one of PipeWire, list the same cameras again.
+    if (path && std::none_of(devices.begin(), devices.end(),
+                             [path](const Device& other) {
+                               return other.path == path;
+                             })) {
+      Device entry;
+      entry.name = path;
+      entry.path = path;
+      auto* display_name = gst_device_get_display_name(device);
+      entry.display_name = display_name ? display_name : path;
+      g_free(display_name);
+      devices.push_back(std::move(entry));
+    }
+    if (properties) {
+      gst_structure_free(properties);
+    }
+  }
+  g_list_free_full(list, gst_object_unref);
+  gst_object_unref(monitor);
+
+  std::sort(devices.begin(), devices.end(),
+            [](const Device& a, const Device& b) { return a.path < b.path; });
+  if (devices.empty()) {
+    Device entry;
+    entry.name = kDefaultCameraName;
+    entry.display_name = kDefaultCameraName;
+    devices.push_back(std::move(entry));
+  }
+  return devices;
+}
+
+// static
+CameraDeviceMonitor::Device CameraDeviceMonitor::Find(
+    const std::string& name) {
+  for (auto& device : Enumerate()) {
+    if (device.name == name) {
+      return device;
+    }
+  }
+  Device device;
+  device.name = name;
+  device.display_name = name;
+  if (name.rfind(kDeviceNodePrefix, 0) == 0) {
+    device.path = name;
+  } else {
+    std::cerr << "Unknown camera " << name << ", using the default one"
+              << std::endl;
+  }
+  return device;
+}
@@ -0,0 +1,32 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_DEVICE_MONITOR_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_DEVICE_MONITOR_H_
+
+#include <string>
+#include <vector>
+
+// Enumerates the cameras of the system with GstDeviceMonitor.
+class CameraDeviceMonitor {
+ public:
+  struct Device {
+    // The name of the camera on the Dart side, which is its device node if
+    // known.
+    std::string name;
+    // The device node v4l2src opens, e.g. /dev/video0, or empty for the
+    // default source of camerabin.
+    std::string path;
+    // The name of the device as reported by the driver.
+    std::string display_name;
+  };
+
+  // Returns the V4L2 video sources, or the default source of camerabin if
+  // there's none.
+  static std::vector<Device> Enumerate();
+  // Returns the device of |name|, as listed by Enumerate() or a device node.
+  static Device Find(const std::string& name);
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_DEVICE_MONITOR_H_
@@ -8,23 +8,39 @@
 #include <flutter/plugin_registrar.h>
 #include <flutter/standard_method_codec.h>
 
+#include <map>
 #include <memory>
+#include <string>
+#include <variant>
 
+#include "camera_controls.h"
+#include "camera_device_monitor.h"
 #include "camera_stream_handler_impl.h"
 #include "channels/event_channel_image_stream.h"
 #include "channels/method_channel_camera.h"
 #include "channels/method_channel_device.h"
 #include "events/camera_initialized_event.h"
 #include "gst_camera.h"
+#include "gst_runtime.h"
+#include "image_stream_worker.h"
 #include "messages/messages.h"
+#include "platform_task_queue.h"
+#include "plugin_stats_channel.h"
+#include "thread_policy.h"
+#include "trace_event.h"
+#include "types/resolution_preset.h"
 
 namespace {
 constexpr char kCameraChannelName[] = "plugins.flutter.io/camera";
+constexpr char kCameraPlatformTasksChannelName[] =
+    "plugins.flutter.io/camera/platformTasks";
 
 constexpr char kCameraChannelApiAvailableCameras[] = "availableCameras";
 constexpr char kCameraChannelApiCreate[] = "create";
 constexpr char kCameraChannelApiInitialize[] = "initialize";
 constexpr char kCameraChannelApiTakePicture[] = "takePicture";
+constexpr char kCameraChannelApiTakePictureBurst[] = "takePictureBurst";
+constexpr char kCameraChannelApiCaptureFrame[] = "captureFrame";
 constexpr char kCameraChannelApiPrepareForVideoRecording[] =
     "prepareForVideoRecording";
 constexpr char kCameraChannelApiStartVideoRecording[] = "startVideoRecording";
@@ -41,8 +57,10 @@ constexpr char kCameraChannelApiGetExposureOffsetStepSize[] =
 constexpr char kCameraChannelApiSetExposureOffset[] = "setExposureOffset";
 constexpr char kCameraChannelApiSetFocusMode[] = "setFocusMode";
 constexpr char kCameraChannelApiSetFocusPoint[] = "setFocusPoint";
+constexpr char kCameraChannelApiSetWhiteBalanceMode[] = "setWhiteBalanceMode";
 constexpr char kCameraChannelApiStartImageStream[] = "startImageStream";
 constexpr char kCameraChannelApiStopImageStream[] = "stopImageStream";
+constexpr char kCameraChannelApiGetFrameStats[] = "getFrameStats";
 constexpr char kCameraChannelApiGetMaxZoomLevel[] = "getMaxZoomLevel";
 constexpr char kCameraChannelApiGetMinZoomLevel[] = "getMinZoomLevel";
 constexpr char kCameraChannelApiSetZoomLevel[] = "setZoomLevel";
@@ -51,6 +69,60 @@ constexpr char kCameraChannelApiLockCaptureOrientation[] =
 constexpr char kCameraChannelApiUnlockCaptureOrientation[] =
     "unlockCaptureOrientation";
 constexpr char kCameraChannelApiDispose[] = "dispose";
+constexpr char kCameraChannelApiSetThreadPolicy[] = "setThreadPolicy";
+#ifdef USE_RTSP_SERVER
+constexpr char kCameraChannelApiStartStreamServer[] = "startStreamServer";
+constexpr char kCameraChannelApiStopStreamServer[] = "stopStreamServer";
+#endif  // USE_RTSP_SERVER
+
+// The frame captures of all the cameras share these threads.
+constexpr size_t kCaptureThreadCount = 2;
+constexpr size_t kMaxQueuedCaptures = 8;
+
+// Returns the value of |key| in |map| if it's an integer, or |default_value|.
+int32_t GetIntValue(const flutter::EncodableMap& map, const char* key,
+                    int32_t default_value) {
+  auto it = map.find(flutter::EncodableValue(key));
+  if (it == map.end()) {
+    return default_value;
+  }
+  if (std::holds_alternative<int32_t>(it->second)) {
+    return std::get<int32_t>(it->second);
+  }
+  if (std::holds_alternative<int64_t>(it->second)) {
+    return static_cast<int32_t>(std::get<int64_t>(it->second));
+  }
+  return default_value;
+}
+
+// Returns the value of |key| in |map| if it's a string, or an empty one.
+std::string GetStringValue(const flutter::EncodableMap& map, const char* key) {
+  auto it = map.find(flutter::EncodableValue(key));
+  if (it == map.end() || !std::holds_alternative<std::string>(it->second)) {
+    return std::string();
+  }
+  return std::get<std::string>(it->second);
+}
+
+// A camera created by Dart, with its preview texture. The camera ID is the
+// texture ID.
+struct FlutterCamera {
+  int64_t camera_id;
+  std::unique_ptr<GstCamera> camera;
+  std::unique_ptr<flutter::TextureVariant> texture;
+#ifdef USE_EGL_IMAGE_DMABUF
+  std::unique_ptr<FlutterDesktopEGLImage> egl_image;
+#else
+  std::unique_ptr<FlutterDesktopPixelBuffer> buffer;
+#endif  // USE_EGL_IMAGE_DMABUF
+  std::unique_ptr<MethodChannelCamera> method_channel;
+  // Its callbacks find the camera by |camera_id| on the platform thread, so
+  // they don't use |method_channel| once it's destroyed.
+  std::unique_ptr<CameraControls> controls;
+  // From the imageFormatGroup of initialize.
+  ImageStreamWorker::Format image_stream_format =
+      ImageStreamWorker::Format::kRgba;
+};
 
 class CameraPlugin : public flutter::Plugin {
  public:
@@ -59,15 +131,23 @@ class CameraPlugin : public flutter::Plugin {
   CameraPlugin(flutter::PluginRegistrar* plugin_registrar,
                flutter::TextureRegistrar* texture_registrar)
       : plugin_registrar_(plugin_registrar),
-        texture_registrar_(texture_registrar) {
-    GstCamera::GstLibraryLoad();
+        texture_registrar_(texture_registrar),
+        plugin_stats_channel_(plugin_registrar),
+        platform_tasks_(plugin_registrar->messenger(),
+                        kCameraPlatformTasksChannelName) {
+    // Waited for by the first call from Dart.
+    GstRuntime::StartInit();
   }
   virtual ~CameraPlugin() {
-    if (camera_) {
-      camera_->Stop();
-      camera_ = nullptr;
+    StopImageStream();
+    for (auto& [camera_id, instance] : cameras_) {
+      instance->camera->Stop();
+      texture_registrar_->UnregisterTexture(camera_id);
+    }
+    cameras_.clear();
+    if (is_gst_library_loaded_) {
+      GstCamera::GstLibraryUnload();
     }
-    GstCamera::GstLibraryUnload();
   }
 
  private:
@@ -86,6 +166,41 @@ class CameraPlugin : public flutter::Plugin {
   void HandleTakePictureCall(
       const flutter::EncodableValue* message,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleTakePictureBurstCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleCaptureFrameCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+#ifdef USE_RTSP_SERVER
+  void HandleStartStreamServerCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleStopStreamServerCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+#endif  // USE_RTSP_SERVER
+  void HandleStartVideoRecordingCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleStopVideoRecordingCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleSetExposureModeCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleGetExposureOffsetStepSizeCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleSetExposureOffsetCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleSetFocusModeCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleSetWhiteBalanceModeCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
   void HandleGetMinExposureOffsetCall(
       const flutter::EncodableValue* message,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
@@ -98,6 +213,9 @@ class CameraPlugin : public flutter::Plugin {
   void HandleStopImageStreamCall(
       const flutter::EncodableValue* message,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleGetFrameStatsCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
   void HandleGetMaxZoomLevelCall(
       const flutter::EncodableValue* message,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
@@ -113,19 +231,49 @@ class CameraPlugin : public flutter::Plugin {
   void HandleDisposeCall(
       const flutter::EncodableValue* message,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleSetThreadPolicyCall(
+      const flutter::EncodableValue* message,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // Returns the camera of the cameraId of |message|, or the only one if
+  // |message| has none, or nullptr.
+  FlutterCamera* GetCamera(const flutter::EncodableValue* message);
+  void StopImageStream();
+
+  // Replies to a setting the camera couldn't apply, and reports it as an
+  // error of the camera if it has been initialized and isn't disposed yet.
+  // Called on the platform thread.
+  void ReplyNotApplied(flutter::MethodResult<flutter::EncodableValue>& result,
+                       int64_t camera_id, const std::string& setting);
+  // Returns a callback of CameraControls replying to |result| once the
+  // setting is applied. The callback is called on the control thread, or
+  // while the controls are destroyed, so it posts the reply to the platform
+  // thread.
+  CameraControls::OnApplied ReplyWhenApplied(
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+      int64_t camera_id, const std::string& setting);
 
   flutter::PluginRegistrar* plugin_registrar_;
   flutter::TextureRegistrar* texture_registrar_;
+  PluginStatsChannel plugin_stats_channel_;
+  // Declared before |cameras_|, so that it outlives the controls, which fail
+  // their pending settings when destroyed.
+  PlatformTaskQueue platform_tasks_;
 
-  std::unique_ptr<FlutterDesktopPixelBuffer> buffer_;
-  std::unique_ptr<flutter::TextureVariant> texture_;
-  std::unique_ptr<GstCamera> camera_ = nullptr;
-  int64_t texture_id_;
+  std::map<int64_t, std::unique_ptr<FlutterCamera>> cameras_;
 
+  // The image stream channel is shared by the cameras, so that only one of
+  // them streams at a time.
   std::unique_ptr<EventChannelImageStream> event_channel_image_stream_ =
       nullptr;
-  std::unique_ptr<MethodChannelCamera> method_channel_camera_;
+  // Converts and sends the frames of |event_channel_image_stream_|.
+  std::unique_ptr<ImageStreamWorker> image_stream_worker_ = nullptr;
+  int64_t image_stream_camera_id_ = -1;
   std::unique_ptr<MethodChannelDevice> method_channel_device_;
+  // Created on the first captureFrame call.
+  std::unique_ptr<FrameCapturePool> frame_capture_pool_;
+  // Whether GStreamer was initialized for the plugin, on the first call.
+  bool is_gst_library_loaded_ = false;
 };
 
 // static
@@ -150,6 +298,10 @@ void CameraPlugin::HandleMethodCall(
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
   const std::string& method_name = method_call.method_name();
 
+  if (!is_gst_library_loaded_) {
+    GstCamera::GstLibraryLoad();
+    is_gst_library_loaded_ = true;
+  }
   if (!method_name.compare(kCameraChannelApiAvailableCameras)) {
     HandleAvailableCamerasCall(std::move(result));
   } else if (!method_name.compare(kCameraChannelApiCreate)) {
@@ -158,12 +310,16 @@ void CameraPlugin::HandleMethodCall(
     HandleInitializeCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiTakePicture)) {
     HandleTakePictureCall(method_call.arguments(), std::move(result));
+  } else if (!method_name.compare(kCameraChannelApiTakePictureBurst)) {
+    HandleTakePictureBurstCall(method_call.arguments(), std::move(result));
+  } else if (!method_name.compare(kCameraChannelApiCaptureFrame)) {
+    HandleCaptureFrameCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiPrepareForVideoRecording)) {
-    result->NotImplemented();
+    result->Success();
   } else if (!method_name.compare(kCameraChannelApiStartVideoRecording)) {
-    result->NotImplemented();
+    HandleStartVideoRecordingCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiStopVideoRecording)) {
-    result->NotImplemented();
+    HandleStopVideoRecordingCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiPauseVideoRecording)) {
     result->NotImplemented();
   } else if (!method_name.compare(kCameraChannelApiResumeVideoRecording)) {
@@ -171,7 +327,7 @@ void CameraPlugin::HandleMethodCall(
   } else if (!method_name.compare(kCameraChannelApiSetFlashMode)) {
     result->NotImplemented();
   } else if (!method_name.compare(kCameraChannelApiSetExposureMode)) {
-    result->NotImplemented();
+    HandleSetExposureModeCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiSetExposurePoint)) {
     result->NotImplemented();
   } else if (!method_name.compare(kCameraChannelApiGetMinExposureOffset)) {
@@ -179,11 +335,14 @@ void CameraPlugin::HandleMethodCall(
   } else if (!method_name.compare(kCameraChannelApiGetMaxExposureOffset)) {
     HandleGetMaxExposureOffsetCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiGetExposureOffsetStepSize)) {
-    result->NotImplemented();
+    HandleGetExposureOffsetStepSizeCall(method_call.arguments(),
+                                        std::move(result));
   } else if (!method_name.compare(kCameraChannelApiSetExposureOffset)) {
-    result->NotImplemented();
+    HandleSetExposureOffsetCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiSetFocusMode)) {
-    result->NotImplemented();
+    HandleSetFocusModeCall(method_call.arguments(), std::move(result));
+  } else if (!method_name.compare(kCameraChannelApiSetWhiteBalanceMode)) {
+    HandleSetWhiteBalanceModeCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiSetFocusPoint)) {
     result->NotImplemented();
   } else if (!method_name.compare(kCameraChannelApiStartImageStream)) {
@@ -192,6 +351,8 @@ void CameraPlugin::HandleMethodCall(
     HandleStopImageStreamCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiGetMaxZoomLevel)) {
     HandleGetMaxZoomLevelCall(method_call.arguments(), std::move(result));
+  } else if (!method_name.compare(kCameraChannelApiGetFrameStats)) {
+    HandleGetFrameStatsCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiGetMinZoomLevel)) {
     HandleGetMinZoomLevelCall(method_call.arguments(), std::move(result));
   } else if (!method_name.compare(kCameraChannelApiSetZoomLevel)) {
@@ -203,6 +364,14 @@ void CameraPlugin::HandleMethodCall(
     result->NotImplemented();
   } else if (!method_name.compare(kCameraChannelApiDispose)) {
     HandleDisposeCall(method_call.arguments(), std::move(result));
+  } else if (!method_name.compare(kCameraChannelApiSetThreadPolicy)) {
+    HandleSetThreadPolicyCall(method_call.arguments(), std::move(result));
+#ifdef USE_RTSP_SERVER
+  } else if (!method_name.compare(kCameraChannelApiStartStreamServer)) {
+    HandleStartStreamServerCall(method_call.arguments(), std::move(result));
+  } else if (!method_name.compare(kCameraChannelApiStopStreamServer)) {
+    HandleStopStreamServerCall(method_call.arguments(), std::move(result));
+#endif  // USE_RTSP_SERVER
   } else {
     result->NotImplemented();
   }
@@ -212,10 +381,9 @@ void CameraPlugin::HandleAvailableCamerasCall(
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
   flutter::EncodableList cameras;
 
-  // TODO: add multi camera support.
-  for (int i = 0; i < 1; i++) {
+  for (const auto& device : CameraDeviceMonitor::Enumerate()) {
     AvailableCamerasMessage camera;
-    camera.SetName("camera" + std::to_string(i));
+    camera.SetName(device.name);
     camera.SetSensorOrientation(0);
     camera.SetLensFacing("external");
     cameras.push_back(camera.ToMap());
@@ -227,33 +395,84 @@ void CameraPlugin::HandleAvailableCamerasCall(
 void CameraPlugin::HandleCreateCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  buffer_ = std::make_unique<FlutterDesktopPixelBuffer>();
-  texture_ =
+  std::string camera_name;
+  auto preset = ResolutionPreset::kMax;
+  int32_t fps = 0;
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    const auto& map = std::get<flutter::EncodableMap>(*message);
+    auto it = map.find(flutter::EncodableValue("cameraName"));
+    if (it != map.end() && std::holds_alternative<std::string>(it->second)) {
+      camera_name = std::get<std::string>(it->second);
+    }
+    it = map.find(flutter::EncodableValue("resolutionPreset"));
+    if (it != map.end() && std::holds_alternative<std::string>(it->second)) {
+      preset = DeserializeResolutionPreset(std::get<std::string>(it->second));
+    }
+    fps = GetIntValue(map, "fps", 0);
+  }
+  const auto device = CameraDeviceMonitor::Find(camera_name);
+  for (const auto& [camera_id, other] : cameras_) {
+    if (other->camera->GetDevicePath() == device.path) {
+      result->Error("Camera in use",
+                    "Dispose of the camera before creating it again");
+      return;
+    }
+  }
+
+  auto instance = std::make_unique<FlutterCamera>();
+#ifdef USE_EGL_IMAGE_DMABUF
+  instance->egl_image = std::make_unique<FlutterDesktopEGLImage>();
+  instance->texture =
+      std::make_unique<flutter::TextureVariant>(flutter::EGLImageTexture(
+          [instance = instance.get()](
+              size_t width, size_t height, void* egl_display,
+              void* egl_context) -> const FlutterDesktopEGLImage* {
+            TRACE_SCOPE("camera", "EGLImageTexture");
+            if (!instance->camera) {
+              return nullptr;
+            }
+            instance->egl_image->width = instance->camera->GetPreviewWidth();
+            instance->egl_image->height = instance->camera->GetPreviewHeight();
+            instance->egl_image->egl_image =
+                instance->camera->GetEGLImage(egl_display, egl_context);
+            return instance->egl_image.get();
+          }));
+#else
+  instance->buffer = std::make_unique<FlutterDesktopPixelBuffer>();
+  instance->texture =
       std::make_unique<flutter::TextureVariant>(flutter::PixelBufferTexture(
-          [this](size_t width,
-                 size_t height) -> const FlutterDesktopPixelBuffer* {
-            buffer_->width = camera_->GetPreviewWidth();
-            buffer_->height = camera_->GetPreviewHeight();
-            buffer_->buffer = camera_->GetPreviewFrameBuffer();
-
-            // TODO: We need to handle this code (event_channel_image_stream_)
-            // in the proper place, but the Camera plugin doesn't have a main
-            // loop.
-            if (event_channel_image_stream_) {
-              event_channel_image_stream_->Send(buffer_->width, buffer_->height,
-                                                buffer_->buffer);
+          [instance = instance.get()](
+              size_t width, size_t height) -> const FlutterDesktopPixelBuffer* {
+            TRACE_SCOPE("camera", "PixelBufferTexture");
+            if (!instance->camera) {
+              return nullptr;
             }
-
-            return buffer_.get();
+            int32_t frame_width = 0;
+            int32_t frame_height = 0;
+            instance->buffer->buffer = instance->camera->GetPreviewFrameBuffer(
+                frame_width, frame_height);
+            instance->buffer->width = frame_width;
+            instance->buffer->height = frame_height;
+            return instance->buffer.get();
           }));
-  auto texture_id = texture_registrar_->RegisterTexture(texture_.get());
+#endif  // USE_EGL_IMAGE_DMABUF
+  auto texture_id =
+      texture_registrar_->RegisterTexture(instance->texture.get());
   auto stream_handler =
       std::make_unique<CameraStreamHandlerImpl>([texture_id, this]() {
+        TRACE_SCOPE("camera", "MarkTextureFrameAvailable");
         texture_registrar_->MarkTextureFrameAvailable(texture_id);
       });
 
-  camera_ = std::make_unique<GstCamera>(std::move(stream_handler));
-  texture_id_ = texture_id;
+  GstCamera::PreviewConfig config;
+  GetResolutionPresetSize(preset, config.width, config.height);
+  config.fps = fps;
+  instance->camera_id = texture_id;
+  instance->camera = std::make_unique<GstCamera>(std::move(stream_handler),
+                                                 device.path, config);
+  instance->camera->GetStats().SetId(std::to_string(texture_id));
+  instance->controls = CameraControls::Open(device.path);
+  cameras_[texture_id] = std::move(instance);
 
   flutter::EncodableMap reply;
   reply[flutter::EncodableValue("cameraId")] =
@@ -265,26 +484,57 @@ void CameraPlugin::HandleCreateCall(
 void CameraPlugin::HandleInitializeCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  camera_->Play();
-  double preview_width = camera_->GetPreviewWidth();
-  double preview_height = camera_->GetPreviewHeight();
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+
+  instance->image_stream_format = ImageStreamWorker::Format::kRgba;
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    const auto& map = std::get<flutter::EncodableMap>(*message);
+    auto it = map.find(flutter::EncodableValue("imageFormatGroup"));
+    if (it != map.end() && std::holds_alternative<std::string>(it->second)) {
+      const auto& group = std::get<std::string>(it->second);
+      if (group == "yuv420") {
+        instance->image_stream_format = ImageStreamWorker::Format::kYuv420;
+      } else if (group == "nv21") {
+        instance->image_stream_format = ImageStreamWorker::Format::kNv21;
+      }
+    }
+  }
+
+  const auto& camera = instance->camera;
+  camera->Play();
+  double preview_width = camera->GetPreviewWidth();
+  double preview_height = camera->GetPreviewHeight();
+  int32_t negotiated_width;
+  int32_t negotiated_height;
+  double preview_fps = 0;
+  if (camera->GetNegotiatedPreview(negotiated_width, negotiated_height,
+                                   preview_fps)) {
+    preview_width = negotiated_width;
+    preview_height = negotiated_height;
+  }
 
   {
-    method_channel_camera_ =
-        std::make_unique<MethodChannelCamera>(plugin_registrar_, texture_id_);
+    instance->method_channel = std::make_unique<MethodChannelCamera>(
+        plugin_registrar_, instance->camera_id);
 
     CameraInitializedEvent message;
     message.SetPreviewWidth(preview_width);
     message.SetPreviewHeight(preview_height);
+    message.SetPreviewFps(preview_fps);
     message.SetFocusMode(FocusMode::kAuto);
     message.SetExposureMode(ExposureMode::kAuto);
     message.SetFocusPointSupported(false);
     message.SetExposurePointSupported(false);
 
-    method_channel_camera_->SendInitializedEvent(message);
+    instance->method_channel->SendInitializedEvent(message);
   }
 
-  {
+  if (!method_channel_device_) {
     method_channel_device_ =
         std::make_unique<MethodChannelDevice>(plugin_registrar_);
     auto orientation = DeviceOrientation::kLandscapeRight;
@@ -297,12 +547,13 @@ void CameraPlugin::HandleInitializeCall(
 void CameraPlugin::HandleTakePictureCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  if (!camera_) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
     result->Error("Not found an active camera",
                   "Check for creating a camera device");
     return;
   }
-  camera_->TakePicture([p_result = result.release()](
+  instance->camera->TakePicture([p_result = result.release()](
                            const std::string& captured_file_path) {
     if (!captured_file_path.empty()) {
       flutter::EncodableValue value(captured_file_path);
@@ -314,82 +565,505 @@ void CameraPlugin::HandleTakePictureCall(
   });
 }
 
+void CameraPlugin::HandleTakePictureBurstCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+
+  int32_t count = 1;
+  bool in_memory = false;
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    const auto& map = std::get<flutter::EncodableMap>(*message);
+    count = GetIntValue(map, "count", 1);
+    auto it = map.find(flutter::EncodableValue("inMemory"));
+    if (it != map.end() && std::holds_alternative<bool>(it->second)) {
+      in_memory = std::get<bool>(it->second);
+    }
+  }
+
+  auto* p_result = result.release();
+  auto on_captured =
+      [p_result, in_memory](std::vector<GstCamera::CapturedPicture>&& pictures) {
+        flutter::EncodableList list;
+        for (auto& picture : pictures) {
+          if (in_memory && !picture.jpeg.empty()) {
+            list.push_back(flutter::EncodableValue(std::move(picture.jpeg)));
+          } else if (!in_memory && !picture.path.empty()) {
+            list.push_back(flutter::EncodableValue(picture.path));
+          }
+        }
+        if (!list.empty()) {
+          p_result->Success(flutter::EncodableValue(std::move(list)));
+        } else {
+          p_result->Error("Failed to capture",
+                          "Failed to capture camera images");
+        }
+        delete p_result;
+      };
+  if (!instance->camera->TakePictureBurst(count, in_memory,
+                                          std::move(on_captured))) {
+    p_result->Error("Failed to capture", "Failed to capture camera images");
+    delete p_result;
+  }
+}
+
+void CameraPlugin::HandleCaptureFrameCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+
+  FrameCapturePool::Request request;
+  std::string format = "jpeg";
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    const auto& map = std::get<flutter::EncodableMap>(*message);
+    request.max_size = GetIntValue(map, "maxSize", 0);
+    request.path = GetStringValue(map, "path");
+    const auto value = GetStringValue(map, "format");
+    if (!value.empty()) {
+      format = value;
+    }
+  }
+  if (!FrameCapturePool::ParseFormat(format, request.format)) {
+    result->Error("Invalid argument", "Unknown frame format: " + format);
+    return;
+  }
+  if (!frame_capture_pool_) {
+    frame_capture_pool_ = std::make_unique<FrameCapturePool>(
+        kCaptureThreadCount, kMaxQueuedCaptures);
+  }
+
+  auto* p_result = result.release();
+  auto on_captured = [p_result](FrameCapturePool::Picture&& picture) {
+    if (!picture.error.empty()) {
+      p_result->Error("Failed to capture", picture.error);
+    } else {
+      flutter::EncodableMap map = {
+          {flutter::EncodableValue("width"),
+           flutter::EncodableValue(picture.width)},
+          {flutter::EncodableValue("height"),
+           flutter::EncodableValue(picture.height)}};
+      if (picture.path.empty()) {
+        map.emplace(flutter::EncodableValue("data"),
+                    flutter::EncodableValue(std::move(picture.data)));
+      } else {
+        map.emplace(flutter::EncodableValue("path"),
+                    flutter::EncodableValue(picture.path));
+      }
+      p_result->Success(flutter::EncodableValue(std::move(map)));
+    }
+    delete p_result;
+  };
+  if (!instance->camera->CaptureFrame(*frame_capture_pool_, request,
+                                      std::move(on_captured))) {
+    p_result->Error("Failed to capture", "Failed to capture a camera frame");
+    delete p_result;
+  }
+}
+
+void CameraPlugin::HandleStartVideoRecordingCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+
+  auto codec = VideoRecorder::Codec::kH264;
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    const auto& map = std::get<flutter::EncodableMap>(*message);
+    auto it = map.find(flutter::EncodableValue("codec"));
+    if (it != map.end() && std::holds_alternative<std::string>(it->second) &&
+        std::get<std::string>(it->second) == "h265") {
+      codec = VideoRecorder::Codec::kH265;
+    }
+  }
+  if (!instance->camera->StartVideoRecording(codec)) {
+    result->Error("Failed to start recording",
+                  "Failed to start recording a video");
+    return;
+  }
+  result->Success();
+}
+
+void CameraPlugin::HandleStopVideoRecordingCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+
+  auto path = instance->camera->StopVideoRecording();
+  if (path.empty()) {
+    result->Error("Failed to stop recording",
+                  "Failed to finish recording a video");
+    return;
+  }
+  result->Success(flutter::EncodableValue(path));
+}
+
+#ifdef USE_RTSP_SERVER
+void CameraPlugin::HandleStartStreamServerCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+
+  RtspStreamServer::Options options;
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    const auto& map = std::get<flutter::EncodableMap>(*message);
+    options.port = GetIntValue(map, "port", options.port);
+    auto it = map.find(flutter::EncodableValue("path"));
+    if (it != map.end() && std::holds_alternative<std::string>(it->second)) {
+      options.path = std::get<std::string>(it->second);
+    }
+    it = map.find(flutter::EncodableValue("codec"));
+    if (it != map.end() && std::holds_alternative<std::string>(it->second) &&
+        std::get<std::string>(it->second) == "h265") {
+      options.codec = VideoCodec::kH265;
+    }
+  }
+  if (!instance->camera->StartStreamServer(options)) {
+    result->Error("Failed to start streaming",
+                  "Failed to start the RTSP server of the camera");
+    return;
+  }
+  result->Success(
+      flutter::EncodableValue(instance->camera->GetStreamServerUrl()));
+}
+
+void CameraPlugin::HandleStopStreamServerCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+  instance->camera->StopStreamServer();
+  result->Success();
+}
+#endif  // USE_RTSP_SERVER
+
 void CameraPlugin::HandleGetMinExposureOffsetCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  if (!camera_) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
     result->Error("Not found an active camera",
                   "Check for creating a camera device");
     return;
   }
 
-  // TODO: Implement exposure control support
-  double value = 0.0;
+  double value =
+      instance->controls ? instance->controls->GetMinExposureOffset() : 0.0;
   result->Success(flutter::EncodableValue(value));
 }
 
 void CameraPlugin::HandleGetMaxExposureOffsetCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  if (!camera_) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+
+  double value =
+      instance->controls ? instance->controls->GetMaxExposureOffset() : 0.0;
+  result->Success(flutter::EncodableValue(value));
+}
+
+void CameraPlugin::HandleGetExposureOffsetStepSizeCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
     result->Error("Not found an active camera",
                   "Check for creating a camera device");
     return;
   }
 
-  // TODO: Implement exposure control support
-  double value = 0.0;
+  double value = instance->controls
+                     ? instance->controls->GetExposureOffsetStepSize()
+                     : 0.0;
   result->Success(flutter::EncodableValue(value));
 }
 
+void CameraPlugin::HandleSetExposureOffsetCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+  if (!instance->controls) {
+    result->Error("Not supported", "The camera has no exposure offset");
+    return;
+  }
+
+  double offset = 0.0;
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    const auto& map = std::get<flutter::EncodableMap>(*message);
+    auto it = map.find(flutter::EncodableValue("offset"));
+    if (it != map.end() && std::holds_alternative<double>(it->second)) {
+      offset = std::get<double>(it->second);
+    }
+  }
+  std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>>
+      shared_result = std::move(result);
+  instance->controls->SetExposureOffset(
+      offset, [this, shared_result, camera_id = instance->camera_id](
+                  bool applied, double applied_offset) {
+        platform_tasks_.Post(
+            [this, shared_result, camera_id, applied, applied_offset]() {
+              if (!applied) {
+                ReplyNotApplied(*shared_result, camera_id, "exposure offset");
+                return;
+              }
+              shared_result->Success(flutter::EncodableValue(applied_offset));
+            });
+      });
+}
+
+void CameraPlugin::HandleSetExposureModeCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+  if (!instance->controls || !instance->controls->SupportsExposureMode()) {
+    result->Error("Not supported", "The camera has no exposure mode control");
+    return;
+  }
+
+  auto mode = ExposureMode::kAuto;
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    mode = DeserializeExposureMode(
+        GetStringValue(std::get<flutter::EncodableMap>(*message), "mode"));
+  }
+  instance->controls->SetExposureMode(
+      mode, ReplyWhenApplied(std::move(result), instance->camera_id,
+                             "exposure mode"));
+}
+
+void CameraPlugin::HandleSetFocusModeCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+  if (!instance->controls || !instance->controls->SupportsFocusMode()) {
+    result->Error("Not supported", "The camera has no focus mode control");
+    return;
+  }
+
+  auto mode = FocusMode::kAuto;
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    mode = DeserializeFocusMode(
+        GetStringValue(std::get<flutter::EncodableMap>(*message), "mode"));
+  }
+  instance->controls->SetFocusMode(
+      mode, ReplyWhenApplied(std::move(result), instance->camera_id,
+                             "focus mode"));
+}
+
+void CameraPlugin::HandleSetWhiteBalanceModeCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+  if (!instance->controls || !instance->controls->SupportsWhiteBalanceMode()) {
+    result->Error("Not supported",
+                  "The camera has no white balance mode control");
+    return;
+  }
+
+  auto mode = CameraControls::WhiteBalanceMode::kAuto;
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message) &&
+      GetStringValue(std::get<flutter::EncodableMap>(*message), "mode") ==
+          "locked") {
+    mode = CameraControls::WhiteBalanceMode::kLocked;
+  }
+  instance->controls->SetWhiteBalanceMode(
+      mode, ReplyWhenApplied(std::move(result), instance->camera_id,
+                             "white balance mode"));
+}
+
 void CameraPlugin::HandleStartImageStreamCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+
+  StopImageStream();
+  ImageStreamWorker::Options options;
+  options.format = instance->image_stream_format;
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    const auto& map = std::get<flutter::EncodableMap>(*message);
+    options.max_fps = GetIntValue(map, "maxFps", 0);
+    options.max_width = GetIntValue(map, "maxWidth", 0);
+    auto it = map.find(flutter::EncodableValue("transport"));
+    if (it != map.end() && std::holds_alternative<std::string>(it->second) &&
+        std::get<std::string>(it->second) == "sharedMemory") {
+      options.transport = ImageStreamWorker::Transport::kSharedMemory;
+    }
+  }
   event_channel_image_stream_ =
       std::make_unique<EventChannelImageStream>(plugin_registrar_);
+  image_stream_worker_ = std::make_unique<ImageStreamWorker>(
+      options, event_channel_image_stream_.get(),
+      &instance->camera->GetFrameStats());
+  instance->camera->SetImageStreamWorker(image_stream_worker_.get());
+  image_stream_camera_id_ = instance->camera_id;
   result->Success();
 }
 
 void CameraPlugin::HandleStopImageStreamCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  event_channel_image_stream_ = nullptr;
+  StopImageStream();
   result->Success();
 }
 
+void CameraPlugin::StopImageStream() {
+  // The streaming thread lets go of the worker first, then the worker of the
+  // channel.
+  auto it = cameras_.find(image_stream_camera_id_);
+  if (it != cameras_.end()) {
+    it->second->camera->SetImageStreamWorker(nullptr);
+  }
+  image_stream_worker_ = nullptr;
+  event_channel_image_stream_ = nullptr;
+  image_stream_camera_id_ = -1;
+}
+
+void CameraPlugin::HandleGetFrameStatsCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
+    result->Error("Not found an active camera",
+                  "Check for creating a camera device");
+    return;
+  }
+
+  auto& stats = instance->camera->GetFrameStats();
+  const auto get = [&stats](FrameStats::Stage stage) {
+    const auto latency = stats.Get(stage);
+    flutter::EncodableList histogram;
+    for (const auto count : latency.histogram) {
+      histogram.push_back(flutter::EncodableValue(static_cast<int64_t>(count)));
+    }
+    return flutter::EncodableValue(flutter::EncodableMap{
+        {flutter::EncodableValue("p50"), flutter::EncodableValue(latency.p50)},
+        {flutter::EncodableValue("p95"), flutter::EncodableValue(latency.p95)},
+        {flutter::EncodableValue("p99"), flutter::EncodableValue(latency.p99)},
+        {flutter::EncodableValue("max"), flutter::EncodableValue(latency.max)},
+        {flutter::EncodableValue("count"),
+         flutter::EncodableValue(static_cast<int64_t>(latency.count))},
+        {flutter::EncodableValue("histogram"),
+         flutter::EncodableValue(std::move(histogram))},
+    });
+  };
+  const auto metadata = instance->camera->GetPreviewFrameMetadata();
+  flutter::EncodableMap reply = {
+      {flutter::EncodableValue("captureToHandoff"),
+       get(FrameStats::kCaptureToHandoff)},
+      {flutter::EncodableValue("captureToTexture"),
+       get(FrameStats::kCaptureToTexture)},
+      {flutter::EncodableValue("captureToDart"),
+       get(FrameStats::kCaptureToDart)},
+      {flutter::EncodableValue("sensorTimestampUs"),
+       flutter::EncodableValue(metadata.capture_time_us)},
+      {flutter::EncodableValue("frameNumber"),
+       flutter::EncodableValue(static_cast<int64_t>(metadata.frame_number))},
+      {flutter::EncodableValue("lostFrames"),
+       flutter::EncodableValue(static_cast<int64_t>(metadata.dropped_frames))},
+      {flutter::EncodableValue("skippedFrames"),
+       flutter::EncodableValue(static_cast<int64_t>(metadata.skipped_frames))},
+  };
+  if (image_stream_worker_ &&
+      image_stream_camera_id_ == instance->camera_id) {
+    reply[flutter::EncodableValue("imageStreamDroppedFrames")] =
+        flutter::EncodableValue(
+            static_cast<int64_t>(image_stream_worker_->GetDroppedFrameCount()));
+  }
+  result->Success(flutter::EncodableValue(reply));
+}
+
 void CameraPlugin::HandleGetMaxZoomLevelCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  if (!camera_) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
     result->Error("Not found an active camera",
                   "Check for creating a camera device");
     return;
   }
-  result->Success(flutter::EncodableValue(camera_->GetMaxZoomLevel()));
+  result->Success(flutter::EncodableValue(instance->camera->GetMaxZoomLevel()));
 }
 
 void CameraPlugin::HandleGetMinZoomLevelCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  if (!camera_) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
     result->Error("Not found an active camera",
                   "Check for creating a camera device");
     return;
   }
-  result->Success(flutter::EncodableValue(camera_->GetMinZoomLevel()));
+  result->Success(flutter::EncodableValue(instance->camera->GetMinZoomLevel()));
 }
 
 void CameraPlugin::HandleSetZoomLevelCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  if (!camera_) {
+  auto* instance = GetCamera(message);
+  if (!instance) {
     result->Error("Not found an active camera",
                   "Check for creating a camera device");
     return;
   }
 
   auto meta = ZoomLevelMessage::FromMap(*message);
-  if (camera_->SetZoomLevel(meta.GetZoom())) {
+  if (instance->camera->SetZoomLevel(meta.GetZoom())) {
     result->Success();
   } else {
     result->Error("Failed to change the zoom level", "Check the zoom level");
@@ -405,15 +1079,95 @@ void CameraPlugin::HandleLockCaptureOrientationCall(
 void CameraPlugin::HandleDisposeCall(
     const flutter::EncodableValue* message,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  // TODO: add multi camera support.
-  if (camera_) {
-    camera_->Stop();
-    camera_ = nullptr;
-    texture_registrar_->UnregisterTexture(texture_id_);
+  auto* instance = GetCamera(message);
+  if (instance) {
+    const auto camera_id = instance->camera_id;
+    if (camera_id == image_stream_camera_id_) {
+      StopImageStream();
+    }
+    instance->camera->Stop();
+    texture_registrar_->UnregisterTexture(camera_id);
+    cameras_.erase(camera_id);
+  }
+  result->Success();
+}
+
+void CameraPlugin::HandleSetThreadPolicyCall(
+    const flutter::EncodableValue* message,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  if (!message || !std::holds_alternative<flutter::EncodableMap>(*message)) {
+    result->Error("Invalid argument", "No thread policy");
+    return;
+  }
+  const auto& map = std::get<flutter::EncodableMap>(*message);
+  const auto name = GetStringValue(map, "role");
+  ThreadPolicy::Role role;
+  ThreadPolicy::Settings settings;
+  auto it = map.find(flutter::EncodableValue("cpus"));
+  if (it != map.end() &&
+      std::holds_alternative<flutter::EncodableList>(it->second)) {
+    for (const auto& cpu : std::get<flutter::EncodableList>(it->second)) {
+      if (std::holds_alternative<int32_t>(cpu) ||
+          std::holds_alternative<int64_t>(cpu)) {
+        settings.cpus.push_back(static_cast<int>(cpu.LongValue()));
+      }
+    }
+  }
+  settings.realtime_priority = GetIntValue(map, "realtimePriority", 0);
+  settings.nice = GetIntValue(map, "nice", 0);
+  if (!ThreadPolicy::ParseRole(name, role) ||
+      !ThreadPolicy::GetInstance().Set(role, settings)) {
+    result->Error("Invalid argument",
+                  "Invalid thread policy for role: " + name);
+    return;
   }
   result->Success();
 }
 
+FlutterCamera* CameraPlugin::GetCamera(
+    const flutter::EncodableValue* message) {
+  if (message && std::holds_alternative<flutter::EncodableMap>(*message)) {
+    const auto& map = std::get<flutter::EncodableMap>(*message);
+    auto it = map.find(flutter::EncodableValue("cameraId"));
+    if (it != map.end() && (std::holds_alternative<int32_t>(it->second) ||
+                            std::holds_alternative<int64_t>(it->second))) {
+      auto camera = cameras_.find(it->second.LongValue());
+      return camera != cameras_.end() ? camera->second.get() : nullptr;
+    }
+  }
+  if (cameras_.size() == 1) {
+    return cameras_.begin()->second.get();
+  }
+  return nullptr;
+}
+
+void CameraPlugin::ReplyNotApplied(
+    flutter::MethodResult<flutter::EncodableValue>& result, int64_t camera_id,
+    const std::string& setting) {
+  const auto description = "Failed to set the " + setting + " of the camera";
+  auto camera = cameras_.find(camera_id);
+  if (camera != cameras_.end() && camera->second->method_channel) {
+    camera->second->method_channel->SendErrorEvent(description);
+  }
+  result.Error("Failed to apply", description);
+}
+
+CameraControls::OnApplied CameraPlugin::ReplyWhenApplied(
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+    int64_t camera_id, const std::string& setting) {
+  std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>>
+      shared_result = std::move(result);
+  return [this, shared_result, camera_id, setting](bool applied) {
+    platform_tasks_.Post([this, shared_result, camera_id, setting, applied]() {
+      if (!applied) {
+        ReplyNotApplied(*shared_result, camera_id, setting);
+        return;
+      }
+      shared_result->Success();
+    });
+  };
+}
+
 }  // namespace
 
 void CameraElinuxPluginRegisterWithRegistrar(
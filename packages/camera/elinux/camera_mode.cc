@@ -0,0 +1,156 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "camera_mode.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace {
+CameraMode::Format GetFormat(const GstStructure* structure) {
+  if (gst_structure_has_name(structure, "image/jpeg")) {
+    return CameraMode::Format::kMjpeg;
+  }
+  if (!gst_structure_has_name(structure, "video/x-raw")) {
+    return CameraMode::Format::kNone;
+  }
+  auto const* format = gst_structure_get_string(structure, "format");
+  if (!g_strcmp0(format, "NV12")) {
+    return CameraMode::Format::kNv12;
+  }
+  if (!g_strcmp0(format, "YUY2")) {
+    return CameraMode::Format::kYuyv;
+  }
+  return CameraMode::Format::kNone;
+}
+
+// Higher is better.
+int GetFormatRank(CameraMode::Format format, bool has_hw_jpeg_decoder) {
+  switch (format) {
+    case CameraMode::Format::kMjpeg:
+      return has_hw_jpeg_decoder ? 3 : 1;
+    case CameraMode::Format::kNv12:
+      return has_hw_jpeg_decoder ? 2 : 3;
+    case CameraMode::Format::kYuyv:
+      return 2;
+    default:
+      return 0;
+  }
+}
+}  // namespace
+
+std::string CameraMode::ToCapsString() const {
+  std::string caps;
+  switch (format) {
+    case Format::kMjpeg:
+      caps = "image/jpeg";
+      break;
+    case Format::kNv12:
+      caps = "video/x-raw,format=NV12";
+      break;
+    case Format::kYuyv:
+      caps = "video/x-raw,format=YUY2";
+      break;
+    default:
+      return caps;
+  }
+  caps += ",width=" + std::to_string(width) +
+          ",height=" + std::to_string(height);
+  if (fps_n > 0) {
+    caps += ",framerate=" + std::to_string(fps_n) + "/" +
+            std::to_string(fps_d);
+  }
+  return caps;
+}
+
+// static
+GstCaps* CameraMode::QueryCaps(const std::string& device_path) {
+  auto* source = gst_element_factory_make("v4l2src", nullptr);
+  if (!source) {
+    std::cerr << "Failed to create a v4l2src" << std::endl;
+    return nullptr;
+  }
+  g_object_set(G_OBJECT(source), "device", device_path.c_str(), NULL);
+
+  GstCaps* caps = nullptr;
+  if (gst_element_set_state(source, GST_STATE_READY) !=
+      GST_STATE_CHANGE_FAILURE) {
+    auto* pad = gst_element_get_static_pad(source, "src");
+    caps = gst_pad_query_caps(pad, nullptr);
+    gst_object_unref(pad);
+  } else {
+    std::cerr << "Failed to open " << device_path << std::endl;
+  }
+  gst_element_set_state(source, GST_STATE_NULL);
+  gst_object_unref(source);
+  return caps;
+}
+
+// static
+CameraMode CameraMode::Select(const GstCaps* caps, int32_t width,
+                              int32_t height, int32_t fps,
+                              bool has_hw_jpeg_decoder) {
+  CameraMode best;
+  bool best_covers = false;
+  if (!caps) {
+    return best;
+  }
+
+  for (guint i = 0; i < gst_caps_get_size(caps); i++) {
+    auto const* structure = gst_caps_get_structure(caps, i);
+    auto format = GetFormat(structure);
+    if (format == Format::kNone) {
+      continue;
+    }
+
+    // Drivers with stepwise sizes report ranges, and most report lists of
+    // frame rates, which are fixated to the values nearest to the request.
+    auto* fixed = gst_structure_copy(structure);
+    gst_structure_fixate_field_nearest_int(fixed, "width",
+                                           width > 0 ? width : G_MAXINT);
+    gst_structure_fixate_field_nearest_int(fixed, "height",
+                                           height > 0 ? height : G_MAXINT);
+    gst_structure_fixate_field_nearest_fraction(fixed, "framerate",
+                                                fps > 0 ? fps : G_MAXINT, 1);
+    CameraMode mode;
+    mode.format = format;
+    auto has_size = gst_structure_get_int(fixed, "width", &mode.width) &&
+                    gst_structure_get_int(fixed, "height", &mode.height);
+    if (!gst_structure_get_fraction(fixed, "framerate", &mode.fps_n,
+                                    &mode.fps_d) ||
+        mode.fps_d <= 0) {
+      mode.fps_n = 0;
+      mode.fps_d = 1;
+    }
+    gst_structure_free(fixed);
+    if (!has_size) {
+      continue;
+    }
+
+    const bool covers = width > 0 && height > 0 && mode.width >= width &&
+                        mode.height >= height;
+    const int64_t area = static_cast<int64_t>(mode.width) * mode.height;
+    const int64_t best_area = static_cast<int64_t>(best.width) * best.height;
+    bool is_better;
+    if (!best.IsValid()) {
+      is_better = true;
+    } else if (covers != best_covers) {
+      is_better = covers;
+    } else if (area != best_area) {
+      is_better = covers ? area < best_area : area > best_area;
+    } else if (mode.GetFps() != best.GetFps()) {
+      is_better = fps > 0 ? std::abs(mode.GetFps() - fps) <
+                                std::abs(best.GetFps() - fps)
+                          : mode.GetFps() > best.GetFps();
+    } else {
+      is_better = GetFormatRank(format, has_hw_jpeg_decoder) >
+                  GetFormatRank(best.format, has_hw_jpeg_decoder);
+    }
+    if (is_better) {
+      best = mode;
+      best_covers = covers;
+    }
+  }
+  return best;
+}
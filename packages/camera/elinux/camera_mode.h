@@ -0,0 +1,52 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_MODE_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_MODE_H_
+
+#include <gst/gst.h>
+
+#include <cstdint>
+#include <string>
+
+// A format and size a V4L2 camera captures in natively.
+struct CameraMode {
+  enum class Format {
+    kNone,
+    kMjpeg,
+    kNv12,
+    kYuyv,
+  };
+
+  Format format = Format::kNone;
+  int32_t width = 0;
+  int32_t height = 0;
+  // The frame rate as a fraction, 0/1 if the device doesn't report one.
+  int32_t fps_n = 0;
+  int32_t fps_d = 1;
+
+  bool IsValid() const { return format != Format::kNone; }
+  double GetFps() const {
+    return fps_d > 0 ? static_cast<double>(fps_n) / fps_d : 0;
+  }
+  // The caps to ask the source for, e.g.
+  // "image/jpeg,width=1280,height=720,framerate=30/1".
+  std::string ToCapsString() const;
+
+  // Returns the caps |device_path| can output, or nullptr on failure. Opens
+  // the device briefly.
+  static GstCaps* QueryCaps(const std::string& device_path);
+
+  // Picks the mode of |caps| for a preview of |width| x |height| at |fps|:
+  // the smallest mode that covers the size, or the largest one if none does
+  // or either is zero. Among modes of that size, the one closest to |fps|,
+  // or the fastest one if zero, is picked. MJPEG is then preferred when
+  // |has_hw_jpeg_decoder|, since cameras usually reach their full rate only
+  // in MJPEG at large sizes, and NV12 then YUYV otherwise. Returns an invalid
+  // mode if |caps| has none of them.
+  static CameraMode Select(const GstCaps* caps, int32_t width, int32_t height,
+                           int32_t fps, bool has_hw_jpeg_decoder);
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_MODE_H_
@@ -8,21 +8,33 @@
 #include <flutter/event_stream_handler_functions.h>
 #include <flutter/standard_method_codec.h>
 
-#include <vector>
+#include <utility>
 
 namespace {
 constexpr char kChannelName[] = "plugins.flutter.io/camera/imageStream";
 
-// See: [getFormat()] in
-// https://developer.android.com/reference/android/media/Image
-constexpr int32_t kImageFormatRGBA8888 = 4;
+void AddMetadata(const FrameMetadata& metadata,
+                 flutter::EncodableMap& encodables) {
+  encodables[flutter::EncodableValue("sensorTimestampUs")] =
+      flutter::EncodableValue(metadata.capture_time_us);
+  encodables[flutter::EncodableValue("frameNumber")] =
+      flutter::EncodableValue(static_cast<int64_t>(metadata.frame_number));
+  encodables[flutter::EncodableValue("lostFrames")] =
+      flutter::EncodableValue(static_cast<int64_t>(metadata.dropped_frames));
+  encodables[flutter::EncodableValue("skippedFrames")] =
+      flutter::EncodableValue(static_cast<int64_t>(metadata.skipped_frames));
+}
 };  // namespace
 
 EventChannelImageStream::EventChannelImageStream(
-    flutter::PluginRegistrar* registrar) {
+    flutter::PluginRegistrar* registrar)
+    : EventChannelImageStream(registrar->messenger()) {}
+
+EventChannelImageStream::EventChannelImageStream(
+    flutter::BinaryMessenger* messenger) {
   auto event_channel =
       std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
-          registrar->messenger(), kChannelName,
+          messenger, kChannelName,
           &flutter::StandardMethodCodec::GetInstance());
 
   auto event_channel_handler = std::make_unique<
@@ -32,12 +44,14 @@ EventChannelImageStream::EventChannelImageStream(
           std::unique_ptr<flutter::EventSink<flutter::EncodableValue>>&& events)
           -> std::unique_ptr<
               flutter::StreamHandlerError<flutter::EncodableValue>> {
+        std::lock_guard<std::mutex> lock(event_sink_mutex_);
         event_sink_ = std::move(events);
         return nullptr;
       },
       [this](const flutter::EncodableValue* arguments)
           -> std::unique_ptr<
               flutter::StreamHandlerError<flutter::EncodableValue>> {
+        std::lock_guard<std::mutex> lock(event_sink_mutex_);
         event_sink_ = nullptr;
         return nullptr;
       });
@@ -46,27 +60,87 @@ EventChannelImageStream::EventChannelImageStream(
 
 // See: [setImageStreamImageAvailableListener] in
 // flutter/plugins/packages/camera/camera/android/src/main/java/io/flutter/plugins/camera/Camera.java
-void EventChannelImageStream::Send(const int32_t& width, const int32_t& height,
-                                   const uint8_t* pixels) {
-  const uint32_t len = width * 4 * height;
-  std::vector<uint8_t> bytes(pixels, pixels + len);
-
-  flutter::EncodableList planes;
-  flutter::EncodableMap plane = {
-      {flutter::EncodableValue("bytesPerRow"), flutter::EncodableValue(width)},
-      {flutter::EncodableValue("bytesPerPixel"), flutter::EncodableValue(4)},
-      {flutter::EncodableValue("bytes"), flutter::EncodableValue(bytes)},
-  };
-  flutter::EncodableValue plane_value(plane);
-  planes.push_back(plane_value);
+void EventChannelImageStream::Send(int32_t width, int32_t height,
+                                   int32_t format,
+                                   std::vector<Plane>&& planes,
+                                   const FrameMetadata& metadata) {
+  flutter::EncodableList plane_values;
+  for (auto& plane : planes) {
+    flutter::EncodableMap plane_value = {
+        {flutter::EncodableValue("bytesPerRow"),
+         flutter::EncodableValue(plane.bytes_per_row)},
+        {flutter::EncodableValue("bytesPerPixel"),
+         flutter::EncodableValue(plane.bytes_per_pixel)},
+        {flutter::EncodableValue("width"), flutter::EncodableValue(plane.width)},
+        {flutter::EncodableValue("height"),
+         flutter::EncodableValue(plane.height)},
+    };
+    // Moved rather than listed above, which would copy the pixels.
+    plane_value[flutter::EncodableValue("bytes")] =
+        flutter::EncodableValue(std::move(plane.bytes));
+    plane_values.push_back(flutter::EncodableValue(std::move(plane_value)));
+  }
 
   flutter::EncodableMap encodables = {
       {flutter::EncodableValue("width"), flutter::EncodableValue(width)},
       {flutter::EncodableValue("height"), flutter::EncodableValue(height)},
+      {flutter::EncodableValue("format"), flutter::EncodableValue(format)}};
+  AddMetadata(metadata, encodables);
+  encodables[flutter::EncodableValue("planes")] =
+      flutter::EncodableValue(std::move(plane_values));
+  flutter::EncodableValue event(std::move(encodables));
+
+  std::lock_guard<std::mutex> lock(event_sink_mutex_);
+  if (event_sink_) {
+    event_sink_->Success(event);
+  }
+}
+
+bool EventChannelImageStream::SendSharedFrame(const SharedFrame& frame) {
+  const auto address = [](const void* pointer) {
+    return static_cast<int64_t>(reinterpret_cast<uintptr_t>(pointer));
+  };
+  flutter::EncodableList planes;
+  for (const auto& plane : frame.planes) {
+    flutter::EncodableMap plane_value = {
+        {flutter::EncodableValue("address"),
+         flutter::EncodableValue(address(plane.data))},
+        {flutter::EncodableValue("size"),
+         flutter::EncodableValue(static_cast<int64_t>(plane.size))},
+        {flutter::EncodableValue("bytesPerRow"),
+         flutter::EncodableValue(plane.bytes_per_row)},
+        {flutter::EncodableValue("bytesPerPixel"),
+         flutter::EncodableValue(plane.bytes_per_pixel)},
+        {flutter::EncodableValue("width"), flutter::EncodableValue(plane.width)},
+        {flutter::EncodableValue("height"),
+         flutter::EncodableValue(plane.height)},
+    };
+    planes.push_back(flutter::EncodableValue(std::move(plane_value)));
+  }
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("width"), flutter::EncodableValue(frame.width)},
+      {flutter::EncodableValue("height"),
+       flutter::EncodableValue(frame.height)},
       {flutter::EncodableValue("format"),
-       flutter::EncodableValue(kImageFormatRGBA8888)},
+       flutter::EncodableValue(frame.format)},
+      {flutter::EncodableValue("slot"), flutter::EncodableValue(frame.slot)},
+      {flutter::EncodableValue("sequence"),
+       flutter::EncodableValue(static_cast<int64_t>(frame.sequence))},
+      {flutter::EncodableValue("timestampUs"),
+       flutter::EncodableValue(frame.timestamp_us)},
+      {flutter::EncodableValue("stateAddress"),
+       flutter::EncodableValue(address(frame.state))},
+      {flutter::EncodableValue("droppedFrames"),
+       flutter::EncodableValue(static_cast<int64_t>(frame.dropped_frames))},
       {flutter::EncodableValue("planes"), flutter::EncodableValue(planes)}};
-  flutter::EncodableValue event(encodables);
+  AddMetadata(frame.metadata, encodables);
+  flutter::EncodableValue event(std::move(encodables));
 
+  std::lock_guard<std::mutex> lock(event_sink_mutex_);
+  if (!event_sink_) {
+    return false;
+  }
   event_sink_->Success(event);
+  return true;
 }
@@ -6,21 +6,34 @@
 #ifndef PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_CHANNELS_EVENT_CHANNEL_IMAGE_STREAM_H_
 #define PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_CHANNELS_EVENT_CHANNEL_IMAGE_STREAM_H_
 
+#include <flutter/binary_messenger.h>
 #include <flutter/encodable_value.h>
 #include <flutter/event_channel.h>
 #include <flutter/plugin_registrar.h>
 
+#include <mutex>
 #include <string>
+#include <vector>
 
-class EventChannelImageStream {
+#include "frame_stats.h"
+#include "image_stream_sink.h"
+
+class EventChannelImageStream : public ImageStreamSink {
  public:
   EventChannelImageStream(flutter::PluginRegistrar* registrar);
-  ~EventChannelImageStream() = default;
+  // On |messenger| directly, e.g. a stub one outside of the engine.
+  explicit EventChannelImageStream(flutter::BinaryMessenger* messenger);
+  ~EventChannelImageStream() override = default;
 
-  void Send(const int32_t& width, const int32_t& height, const uint8_t* pixels);
+  void Send(int32_t width, int32_t height, int32_t format,
+            std::vector<Plane>&& planes,
+            const FrameMetadata& metadata) override;
+  bool SendSharedFrame(const SharedFrame& frame) override;
 
  private:
   std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>> channel_;
+  // Guards |event_sink_| against the thread of ImageStreamWorker.
+  std::mutex event_sink_mutex_;
   std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> event_sink_;
 };
 
@@ -10,6 +10,7 @@
 namespace {
 constexpr char kChannelName[] = "plugins.flutter.io/camera/camera";
 constexpr char kChannelMethodInitialized[] = "initialized";
+constexpr char kChannelMethodError[] = "error";
 };  // namespace
 
 MethodChannelCamera::MethodChannelCamera(flutter::PluginRegistrar* registrar,
@@ -26,6 +27,14 @@ void MethodChannelCamera::SendInitializedEvent(
   Send(kChannelMethodInitialized, std::move(value));
 }
 
+void MethodChannelCamera::SendErrorEvent(const std::string& description) {
+  flutter::EncodableMap map = {
+      {flutter::EncodableValue("description"),
+       flutter::EncodableValue(description)}};
+  Send(kChannelMethodError,
+       std::make_unique<flutter::EncodableValue>(std::move(map)));
+}
+
 void MethodChannelCamera::Send(
     const std::string& method,
     std::unique_ptr<flutter::EncodableValue>&& arguments) {
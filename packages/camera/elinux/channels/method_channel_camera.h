@@ -20,6 +20,9 @@ class MethodChannelCamera {
   ~MethodChannelCamera() = default;
 
   void SendInitializedEvent(CameraInitializedEvent& message);
+  // Reports an error of the camera to the CameraController. May be called
+  // from any thread.
+  void SendErrorEvent(const std::string& description);
 
  private:
   void Send(const std::string& method,
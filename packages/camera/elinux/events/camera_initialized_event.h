@@ -32,6 +32,10 @@ class CameraInitializedEvent {
   void SetPreviewHeight(const double& height) { preview_height_ = height; }
   double GetPreviewHeight() const { return preview_height_; }
 
+  // Zero if unknown. Not part of the platform interface.
+  void SetPreviewFps(const double& fps) { preview_fps_ = fps; }
+  double GetPreviewFps() const { return preview_fps_; }
+
   void SetFocusMode(const FocusMode& focus_mode) { focus_mode_ = focus_mode; }
   FocusMode GetFocusMode() const { return focus_mode_; }
 
@@ -56,6 +60,8 @@ class CameraInitializedEvent {
          flutter::EncodableValue(preview_width_)},
         {flutter::EncodableValue("previewHeight"),
          flutter::EncodableValue(preview_height_)},
+        {flutter::EncodableValue("previewFps"),
+         flutter::EncodableValue(preview_fps_)},
         {flutter::EncodableValue("focusMode"),
          flutter::EncodableValue(SerializeFocusMode(focus_mode_))},
         {flutter::EncodableValue("exposureMode"),
@@ -85,6 +91,12 @@ class CameraInitializedEvent {
         message.SetPreviewHeight(std::get<double>(preview_height));
       }
 
+      flutter::EncodableValue& preview_fps =
+          map[flutter::EncodableValue("previewFps")];
+      if (std::holds_alternative<double>(preview_fps)) {
+        message.SetPreviewFps(std::get<double>(preview_fps));
+      }
+
       flutter::EncodableValue& focus_mode =
           map[flutter::EncodableValue("focusMode")];
       if (std::holds_alternative<std::string>(focus_mode)) {
@@ -119,6 +131,7 @@ class CameraInitializedEvent {
  private:
   double preview_width_;
   double preview_height_;
+  double preview_fps_ = 0;
   FocusMode focus_mode_;
   ExposureMode exposure_mode_;
   bool focus_point_supported_;
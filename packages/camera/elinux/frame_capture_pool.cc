@@ -0,0 +1,305 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "frame_capture_pool.h"
+
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/video/video.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+// The encoders in order of preference. The first are hardware encoders.
+constexpr const char* kJpegEncoders[] = {"v4l2jpegenc", "jpegenc"};
+
+// How long a frame may take to be captured before the pipeline is
+// considered stuck.
+constexpr GstClockTime kCaptureTimeout = 5 * GST_SECOND;
+
+bool WriteFile(const std::string& path, const uint8_t* data, size_t size) {
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char*>(data), size);
+  if (!file) {
+    std::cerr << "Failed to write " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+FrameCapturePool::FrameCapturePool(size_t thread_count,
+                                   size_t max_queued_frames)
+    : max_queued_frames_(max_queued_frames) {
+  for (size_t i = 0; i < thread_count; i++) {
+    threads_.emplace_back(&FrameCapturePool::Run, this);
+  }
+}
+
+FrameCapturePool::~FrameCapturePool() {
+  std::deque<Task> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+    tasks.swap(tasks_);
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  for (auto& task : tasks) {
+    gst_buffer_unref(task.buffer);
+    gst_caps_unref(task.caps);
+    Picture picture;
+    picture.error = "The capture was cancelled";
+    task.callback(std::move(picture));
+  }
+}
+
+// static
+bool FrameCapturePool::ParseFormat(const std::string& name, Format& format) {
+  if (name == "jpeg") {
+    format = Format::kJpeg;
+  } else if (name == "png") {
+    format = Format::kPng;
+  } else if (name == "rgba") {
+    format = Format::kRgba;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool FrameCapturePool::Capture(GstBuffer* buffer, GstCaps* caps,
+                               const Request& request, Callback callback) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_stopping_ || tasks_.size() >= max_queued_frames_) {
+      return false;
+    }
+    tasks_.push_back({gst_buffer_ref(buffer), gst_caps_ref(caps), request,
+                      std::move(callback)});
+  }
+  cv_.notify_one();
+  return true;
+}
+
+void FrameCapturePool::Run() {
+  Encoder encoder;
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return is_stopping_ || !tasks_.empty(); });
+      if (is_stopping_) {
+        break;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    Picture picture;
+    int32_t width = 0;
+    int32_t height = 0;
+    if (!GetPictureSize(task.caps, task.request.max_size, width, height)) {
+      picture.error = "The frame has no size";
+    } else {
+      if (encoder.pipeline &&
+          (encoder.format != task.request.format || encoder.width != width ||
+           encoder.height != height ||
+           !gst_caps_is_equal(encoder.caps, task.caps))) {
+        DestroyEncoder(encoder);
+      }
+      if (!encoder.pipeline &&
+          !CreateEncoder(encoder, task.caps, task.request.format, width,
+                         height)) {
+        picture.error = "Failed to create a capture pipeline";
+      } else if (!CaptureFrame(encoder, task, picture)) {
+        // Starts over with a new pipeline for the next frame.
+        DestroyEncoder(encoder);
+      }
+    }
+    gst_buffer_unref(task.buffer);
+    gst_caps_unref(task.caps);
+    task.callback(std::move(picture));
+  }
+  DestroyEncoder(encoder);
+}
+
+// static
+bool FrameCapturePool::GetPictureSize(GstCaps* caps, int32_t max_size,
+                                      int32_t& width, int32_t& height) {
+  GstVideoInfo info;
+  if (!gst_video_info_from_caps(&info, caps) ||
+      GST_VIDEO_INFO_WIDTH(&info) <= 0 || GST_VIDEO_INFO_HEIGHT(&info) <= 0) {
+    return false;
+  }
+  // The picture has square pixels.
+  width = GST_VIDEO_INFO_WIDTH(&info);
+  height = GST_VIDEO_INFO_HEIGHT(&info);
+  if (GST_VIDEO_INFO_PAR_N(&info) > 0 && GST_VIDEO_INFO_PAR_D(&info) > 0) {
+    width = static_cast<int32_t>(gst_util_uint64_scale_int(
+        width, GST_VIDEO_INFO_PAR_N(&info), GST_VIDEO_INFO_PAR_D(&info)));
+  }
+  if (max_size > 0 && std::max(width, height) > max_size) {
+    if (width >= height) {
+      height = static_cast<int32_t>(
+          gst_util_uint64_scale_int(height, max_size, width));
+      width = max_size;
+    } else {
+      width = static_cast<int32_t>(
+          gst_util_uint64_scale_int(width, max_size, height));
+      height = max_size;
+    }
+  }
+  // The JPEG encoders subsample the chroma in 2x2 blocks.
+  width = std::max(width & ~1, 2);
+  height = std::max(height & ~1, 2);
+  return true;
+}
+
+// static
+bool FrameCapturePool::CreateEncoder(Encoder& encoder, GstCaps* caps,
+                                     Format format, int32_t width,
+                                     int32_t height) {
+  encoder.pipeline = gst_pipeline_new("framecapture");
+  encoder.source = gst_element_factory_make("appsrc", "source");
+  auto* convert = gst_element_factory_make("videoconvert", "convert");
+  auto* scale = gst_element_factory_make("videoscale", "scale");
+  auto* filter = gst_element_factory_make("capsfilter", "filter");
+  GstElement* encode = nullptr;
+  if (format == Format::kJpeg) {
+    for (auto const* name : kJpegEncoders) {
+      encode = gst_element_factory_make(name, "encoder");
+      if (encode) {
+        break;
+      }
+    }
+  } else if (format == Format::kPng) {
+    encode = gst_element_factory_make("pngenc", "encoder");
+  }
+  encoder.sink = gst_element_factory_make("appsink", "sink");
+  if (!encoder.pipeline || !encoder.source || !convert || !scale ||
+      !filter || (format != Format::kRgba && !encode) || !encoder.sink) {
+    std::cerr << "Failed to create a frame capture pipeline" << std::endl;
+    for (auto* element :
+         {encoder.source, convert, scale, filter, encode, encoder.sink}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    if (encoder.pipeline) {
+      gst_object_unref(encoder.pipeline);
+    }
+    encoder = Encoder();
+    return false;
+  }
+
+  auto* filter_caps = gst_caps_new_simple(
+      "video/x-raw", "width", G_TYPE_INT, width, "height", G_TYPE_INT, height,
+      "pixel-aspect-ratio", GST_TYPE_FRACTION, 1, 1, NULL);
+  if (format == Format::kRgba) {
+    gst_caps_set_simple(filter_caps, "format", G_TYPE_STRING, "RGBA", NULL);
+  }
+  g_object_set(G_OBJECT(filter), "caps", filter_caps, NULL);
+  gst_caps_unref(filter_caps);
+  g_object_set(G_OBJECT(encoder.source), "format", GST_FORMAT_TIME, NULL);
+  gst_app_src_set_caps(GST_APP_SRC(encoder.source), caps);
+  g_object_set(G_OBJECT(encoder.sink), "sync", FALSE, NULL);
+  gst_bin_add_many(GST_BIN(encoder.pipeline), encoder.source, convert, scale,
+                   filter, encoder.sink, NULL);
+  auto linked = false;
+  if (encode) {
+    gst_bin_add(GST_BIN(encoder.pipeline), encode);
+    linked = gst_element_link_many(encoder.source, convert, scale, filter,
+                                   encode, encoder.sink, NULL);
+  } else {
+    linked = gst_element_link_many(encoder.source, convert, scale, filter,
+                                   encoder.sink, NULL);
+  }
+  encoder.caps = gst_caps_ref(caps);
+  encoder.format = format;
+  encoder.width = width;
+  encoder.height = height;
+  if (!linked || gst_element_set_state(encoder.pipeline, GST_STATE_PLAYING) ==
+                     GST_STATE_CHANGE_FAILURE) {
+    std::cerr << "Failed to start a frame capture pipeline" << std::endl;
+    DestroyEncoder(encoder);
+    return false;
+  }
+  return true;
+}
+
+// static
+void FrameCapturePool::DestroyEncoder(Encoder& encoder) {
+  if (encoder.pipeline) {
+    gst_element_set_state(encoder.pipeline, GST_STATE_NULL);
+    gst_object_unref(encoder.pipeline);
+  }
+  if (encoder.caps) {
+    gst_caps_unref(encoder.caps);
+  }
+  encoder = Encoder();
+}
+
+// static
+bool FrameCapturePool::CaptureFrame(Encoder& encoder, Task& task,
+                                    Picture& picture) {
+  if (gst_app_src_push_buffer(GST_APP_SRC(encoder.source),
+                              gst_buffer_ref(task.buffer)) != GST_FLOW_OK) {
+    picture.error = "Failed to push a frame to the capture pipeline";
+    return false;
+  }
+  auto* sample =
+      gst_app_sink_try_pull_sample(GST_APP_SINK(encoder.sink), kCaptureTimeout);
+  if (!sample) {
+    picture.error = "Failed to capture a frame";
+    return false;
+  }
+
+  auto* buffer = gst_sample_get_buffer(sample);
+  GstMapInfo map;
+  if (!buffer || !gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    gst_sample_unref(sample);
+    picture.error = "Failed to read a captured frame";
+    return false;
+  }
+  picture.width = encoder.width;
+  picture.height = encoder.height;
+  if (task.request.format == Format::kRgba) {
+    // Drops the padding of the rows, if any.
+    GstVideoInfo info;
+    gst_video_info_from_caps(&info, gst_sample_get_caps(sample));
+    const auto row_size = static_cast<size_t>(picture.width) * 4;
+    const auto stride =
+        static_cast<size_t>(GST_VIDEO_INFO_PLANE_STRIDE(&info, 0));
+    picture.data.resize(row_size * picture.height);
+    for (int32_t row = 0; row < picture.height; row++) {
+      if (row * stride + row_size > map.size) {
+        break;
+      }
+      std::memcpy(picture.data.data() + row * row_size,
+                  map.data + row * stride, row_size);
+    }
+  } else {
+    picture.data.assign(map.data, map.data + map.size);
+  }
+  gst_buffer_unmap(buffer, &map);
+  gst_sample_unref(sample);
+
+  if (!task.request.path.empty()) {
+    if (!WriteFile(task.request.path, picture.data.data(),
+                   picture.data.size())) {
+      picture.error = "Failed to write " + task.request.path;
+    } else {
+      picture.path = task.request.path;
+    }
+    picture.data.clear();
+  }
+  // A failed write isn't the pipeline's fault.
+  return true;
+}
@@ -0,0 +1,114 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_FRAME_CAPTURE_POOL_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_FRAME_CAPTURE_POOL_H_
+
+#include <gst/gst.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Scales and encodes single frames of the players or the cameras, e.g. for
+// screenshots, on threads of its own, so that neither the streaming threads
+// nor the platform thread wait for them. The frames are referenced rather
+// than copied. Each thread keeps the pipeline of its last capture:
+// appsrc ! videoconvert ! videoscale ! capsfilter ! v4l2jpegenc ! appsink
+// with jpegenc if there's no hardware encoder, pngenc for PNG, and no
+// encoder for RGBA pixels. A capture of another input, size or format
+// creates a new pipeline.
+//
+// video_player and camera each have a copy of this file.
+class FrameCapturePool {
+ public:
+  enum class Format {
+    kJpeg,
+    kPng,
+    // Tightly packed RGBA pixels.
+    kRgba,
+  };
+
+  struct Request {
+    Format format = Format::kJpeg;
+    // The longest side of the picture, which is scaled down to it keeping
+    // its aspect ratio. Zero or less keeps the size of the frame.
+    int32_t max_size = 0;
+    // The file the picture is written to, or empty to return its data.
+    std::string path;
+  };
+
+  struct Picture {
+    int32_t width = 0;
+    int32_t height = 0;
+    // Empty if the picture was written to |path|.
+    std::vector<uint8_t> data;
+    std::string path;
+    // Empty on success.
+    std::string error;
+  };
+
+  // Called on a thread of the pool.
+  using Callback = std::function<void(Picture&& picture)>;
+
+  FrameCapturePool(size_t thread_count, size_t max_queued_frames);
+  // Waits for the frame being captured by each thread. The queued frames are
+  // given to their callbacks as failures.
+  ~FrameCapturePool();
+
+  // Prevent copying.
+  FrameCapturePool(FrameCapturePool const&) = delete;
+  FrameCapturePool& operator=(FrameCapturePool const&) = delete;
+
+  static bool ParseFormat(const std::string& name, Format& format);
+
+  // Queues |buffer| of |caps| to be captured, taking references to both.
+  // Returns false without calling |callback| if the queue is full.
+  bool Capture(GstBuffer* buffer, GstCaps* caps, const Request& request,
+               Callback callback);
+
+ private:
+  struct Task {
+    GstBuffer* buffer;
+    GstCaps* caps;
+    Request request;
+    Callback callback;
+  };
+
+  struct Encoder {
+    GstElement* pipeline = nullptr;
+    GstElement* source = nullptr;
+    GstElement* sink = nullptr;
+    // What the pipeline was created for.
+    GstCaps* caps = nullptr;
+    Format format = Format::kJpeg;
+    int32_t width = 0;
+    int32_t height = 0;
+  };
+
+  void Run();
+  static bool CreateEncoder(Encoder& encoder, GstCaps* caps, Format format,
+                            int32_t width, int32_t height);
+  static void DestroyEncoder(Encoder& encoder);
+  static bool CaptureFrame(Encoder& encoder, Task& task, Picture& picture);
+  // Sets |width| and |height| to the size of a frame of |caps| scaled down
+  // to |max_size|. Returns false if |caps| has no size.
+  static bool GetPictureSize(GstCaps* caps, int32_t max_size, int32_t& width,
+                             int32_t& height);
+
+  const size_t max_queued_frames_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Guarded by |mutex_|.
+  std::deque<Task> tasks_;
+  bool is_stopping_ = false;
+  std::vector<std::thread> threads_;
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_FRAME_CAPTURE_POOL_H_
@@ -0,0 +1,92 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "frame_stats.h"
+
+#include <algorithm>
+#include <vector>
+
+void FrameStats::RecordSince(Stage stage, int64_t capture_time_us) {
+  if (capture_time_us < 0) {
+    return;
+  }
+  // The clock of the driver may run slightly ahead of ours.
+  const auto latency_us =
+      std::max<int64_t>(g_get_monotonic_time() - capture_time_us, 0);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& window = windows_[stage];
+  window.samples[window.next] = latency_us;
+  window.next = (window.next + 1) % kWindowSize;
+  window.count = std::min(window.count + 1, kWindowSize);
+}
+
+FrameStats::Latency FrameStats::Get(Stage stage) const {
+  std::vector<int64_t> samples;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto& window = windows_[stage];
+    samples.assign(window.samples.begin(),
+                   window.samples.begin() + window.count);
+  }
+
+  Latency latency;
+  latency.count = samples.size();
+  if (samples.empty()) {
+    return latency;
+  }
+  for (const auto sample : samples) {
+    size_t bucket = 0;
+    while (bucket + 1 < kHistogramBucketCount &&
+           sample >= (int64_t{1000} << bucket)) {
+      bucket++;
+    }
+    latency.histogram[bucket]++;
+  }
+  // Nearest-rank percentiles. The element at each rank is selected in
+  // ascending order, so every nth_element() only scans the upper part.
+  const auto select = [&samples](size_t percent, size_t from) {
+    const size_t rank = (samples.size() * percent + 99) / 100;
+    const size_t index = std::max<size_t>(rank, 1) - 1;
+    std::nth_element(samples.begin() + std::min(from, index),
+                     samples.begin() + index, samples.end());
+    return index;
+  };
+  const auto p50 = select(50, 0);
+  latency.p50 = samples[p50];
+  const auto p95 = select(95, p50);
+  latency.p95 = samples[p95];
+  const auto p99 = select(99, p95);
+  latency.p99 = samples[p99];
+  latency.max = *std::max_element(samples.begin() + p99, samples.end());
+  return latency;
+}
+
+void FrameStats::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& window : windows_) {
+    window.next = 0;
+    window.count = 0;
+  }
+}
+
+// static
+int64_t FrameStats::GetCaptureTime(GstElement* pipeline, GstBuffer* buffer) {
+  if (!GST_BUFFER_PTS_IS_VALID(buffer)) {
+    return -1;
+  }
+  auto* clock = gst_element_get_clock(pipeline);
+  if (!clock) {
+    return -1;
+  }
+  // v4l2src stamps the frames with the capture time of the driver in the
+  // pipeline clock, which is taken back to the monotonic clock through the
+  // current time of both.
+  const auto now = gst_clock_get_time(clock);
+  gst_object_unref(clock);
+  const auto time =
+      gst_element_get_base_time(pipeline) + GST_BUFFER_PTS(buffer);
+  const auto age_us =
+      GST_CLOCK_DIFF(time, now) / static_cast<GstClockTimeDiff>(GST_USECOND);
+  return g_get_monotonic_time() - age_us;
+}
@@ -0,0 +1,93 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_FRAME_STATS_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_FRAME_STATS_H_
+
+#include <gst/gst.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// What the camera tells about a frame.
+struct FrameMetadata {
+  // The capture time in the monotonic clock, as g_get_monotonic_time(), in
+  // microseconds, or -1 if unknown.
+  int64_t capture_time_us = -1;
+  // The sequence number of the driver, or the number of the frame since the
+  // start of the preview if the source doesn't number them.
+  uint64_t frame_number = 0;
+  // The frames lost so far between the sensor and the preview, detected as
+  // gaps in the frame numbers.
+  uint64_t dropped_frames = 0;
+  // The frames the queues and videorate of the pipeline skipped so far,
+  // without reaching the preview.
+  uint64_t skipped_frames = 0;
+};
+
+// Rolling percentiles and histograms of the per-frame latencies of the
+// camera, over the last |kWindowSize| frames.
+//
+// Record() is called from the streaming, raster and image stream threads and
+// only takes a short lock, the percentiles are computed on demand by Get().
+class FrameStats {
+ public:
+  enum Stage {
+    // From the capture time to the preview branch handing the frame over:
+    // the decoding, the conversion and the queues of the pipeline.
+    kCaptureToHandoff = 0,
+    // From the capture time to the texture callback picking up the frame.
+    kCaptureToTexture,
+    // From the capture time to the image stream event being posted to Dart.
+    kCaptureToDart,
+    kStageCount,
+  };
+
+  // The upper bound of bucket i is 2^i ms, the last bucket is unbounded.
+  static constexpr size_t kHistogramBucketCount = 10;
+
+  struct Latency {
+    // In microseconds.
+    int64_t p50 = 0;
+    int64_t p95 = 0;
+    int64_t p99 = 0;
+    int64_t max = 0;
+    // The number of frames in the window.
+    size_t count = 0;
+    std::array<size_t, kHistogramBucketCount> histogram = {};
+  };
+
+  static constexpr size_t kWindowSize = 300;
+
+  FrameStats() = default;
+  ~FrameStats() = default;
+
+  // Prevent copying.
+  FrameStats(FrameStats const&) = delete;
+  FrameStats& operator=(FrameStats const&) = delete;
+
+  // Records the latency of a frame captured at |capture_time_us|, up to now.
+  // Does nothing if the capture time is unknown.
+  void RecordSince(Stage stage, int64_t capture_time_us);
+  Latency Get(Stage stage) const;
+  void Reset();
+
+  // Returns the capture time of |buffer| in the monotonic clock, from its PTS
+  // and the base time of |pipeline|, or -1 if unknown.
+  static int64_t GetCaptureTime(GstElement* pipeline, GstBuffer* buffer);
+
+ private:
+  struct Window {
+    std::array<int64_t, kWindowSize> samples;
+    size_t next = 0;
+    size_t count = 0;
+  };
+
+  mutable std::mutex mutex_;
+  Window windows_[kStageCount];
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_FRAME_STATS_H_
@@ -4,12 +4,167 @@
 
 #include "gst_camera.h"
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <vector>
 
-GstCamera::GstCamera(std::unique_ptr<CameraStreamHandler> handler)
-    : stream_handler_(std::move(handler)) {
+#include "gst_runtime.h"
+#include "plugin_log.h"
+#include "thread_policy.h"
+
+namespace {
+constexpr char kOutputCaps[] = "video/x-raw,format=RGBA";
+
+// The JPEG decoders of the direct pipeline, in order of preference. The
+// first are hardware decoders.
+constexpr const char* kJpegDecoders[] = {"v4l2jpegdec", "jpegdec"};
+constexpr size_t kHardwareJpegDecoderCount = 1;
+
+bool HasHardwareJpegDecoder() {
+  for (size_t i = 0; i < kHardwareJpegDecoderCount; i++) {
+    auto* factory = gst_element_factory_find(kJpegDecoders[i]);
+    if (factory) {
+      gst_object_unref(factory);
+      return true;
+    }
+  }
+  return false;
+}
+
+GstElement* CreateJpegDecoder() {
+  for (auto const* name : kJpegDecoders) {
+    auto* decoder = gst_element_factory_make(name, "jpegdec");
+    if (decoder) {
+      return decoder;
+    }
+  }
+  return nullptr;
+}
+
+// Burst pictures are encoded by a few threads, and the preview frames beyond
+// what they keep up with are skipped rather than queued.
+constexpr size_t kEncoderThreadCount = 2;
+constexpr size_t kMaxQueuedPictures = 8;
+
+// Well over the frames in the queues between the source and the preview.
+constexpr size_t kMaxPendingFrameMetadata = 16;
+
+bool WriteFile(const std::string& path, const uint8_t* data, size_t size) {
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char*>(data), size);
+  if (!file) {
+    std::cerr << "Failed to write " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool LinkChain(const std::vector<GstElement*>& elements) {
+  for (size_t i = 1; i < elements.size(); i++) {
+    if (!gst_element_link(elements[i - 1], elements[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#ifdef USE_EGL_IMAGE_DMABUF
+// Prefers DMABUF memory so that the frames can be imported as EGLImages
+// without a copy, and falls back to system memory if upstream can't export
+// it.
+constexpr char kDmabufOutputCaps[] =
+    "video/x-raw(memory:DMABuf),format=RGBA; video/x-raw,format=RGBA";
+
+// Upper bound of the EGLImage cache. Capture pools usually hold well under
+// this many buffers.
+constexpr size_t kMaxCachedEGLImages = 32;
+
+// The number of frames the plugin keeps referenced downstream of the
+// converter: one in the sink, one being drawn and one on its way.
+constexpr guint kHeldFrameCount = 3;
+
+// Asks V4L2 based elements to export their capture buffers as DMABUF instead
+// of copying them to system memory. v4l2src names the property io-mode, the
+// m2m converters capture-io-mode.
+void RequestDmabufOutput(GstElement* element) {
+  auto* object_class = G_OBJECT_GET_CLASS(element);
+  auto* factory = gst_element_get_factory(element);
+  if (factory && !g_strcmp0(GST_OBJECT_NAME(factory), "v4l2src") &&
+      g_object_class_find_property(object_class, "io-mode")) {
+    gst_util_set_object_arg(G_OBJECT(element), "io-mode", "dmabuf");
+  } else if (g_object_class_find_property(object_class, "capture-io-mode")) {
+    gst_util_set_object_arg(G_OBJECT(element), "capture-io-mode", "dmabuf");
+  }
+}
+
+// camerabin creates its source on the change to READY.
+void OnDeepElementAdded(GstBin* bin, GstBin* sub_bin, GstElement* element,
+                        gpointer user_data) {
+  RequestDmabufOutput(element);
+}
+
+// fakesink doesn't propose a pool in the allocation query, so upstream pools
+// would be sized as if the sink released each frame right away. Answers it
+// on behalf of the sink, so that v4l2src doesn't run out of buffers while the
+// plugin holds frames, and allows padded strides.
+GstPadProbeReturn OnVideoSinkQuery(GstPad* pad, GstPadProbeInfo* info,
+                                   gpointer user_data) {
+  auto* query = GST_PAD_PROBE_INFO_QUERY(info);
+  if (GST_QUERY_TYPE(query) != GST_QUERY_ALLOCATION) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstCaps* caps = nullptr;
+  gboolean need_pool = FALSE;
+  gst_query_parse_allocation(query, &caps, &need_pool);
+  GstVideoInfo video_info;
+  guint size = 0;
+  if (caps && gst_video_info_from_caps(&video_info, caps)) {
+    size = GST_VIDEO_INFO_SIZE(&video_info);
+  }
+  gst_query_add_allocation_pool(query, nullptr, size, kHeldFrameCount, 0);
+  gst_query_add_allocation_meta(query, GST_VIDEO_META_API_TYPE, nullptr);
+  return GST_PAD_PROBE_HANDLED;
+}
+
+// The viewfinder bin of camerabin converts and scales the frames in system
+// memory by default, which would copy them out of DMABUF.
+void DisableViewfinderConversion(GstElement* camerabin) {
+  auto* spec =
+      g_object_class_find_property(G_OBJECT_GET_CLASS(camerabin), "flags");
+  if (!spec || !G_IS_PARAM_SPEC_FLAGS(spec)) {
+    return;
+  }
+  auto* value = g_flags_get_value_by_nick(G_PARAM_SPEC_FLAGS(spec)->flags_class,
+                                          "no-viewfinder-conversion");
+  if (!value) {
+    return;
+  }
+  guint flags = 0;
+  g_object_get(camerabin, "flags", &flags, NULL);
+  g_object_set(camerabin, "flags", flags | value->value, NULL);
+}
+#endif  // USE_EGL_IMAGE_DMABUF
+}  // namespace
+
+// static
+std::atomic<int> GstCamera::captured_count_ = 0;
+// static
+std::atomic<int> GstCamera::recorded_count_ = 0;
+
+GstCamera::GstCamera(std::unique_ptr<CameraStreamHandler> handler,
+                     const std::string& device_path,
+                     const PreviewConfig& config)
+    : stream_handler_(std::move(handler)),
+      device_path_(device_path),
+      preview_config_(config) {
   gst_.pipeline = nullptr;
   gst_.camerabin = nullptr;
+  gst_.source = nullptr;
+  gst_.tee = nullptr;
+  gst_.capture_valve = nullptr;
+  gst_.capture_sink = nullptr;
   gst_.video_convert = nullptr;
   gst_.video_sink = nullptr;
   gst_.output = nullptr;
@@ -29,15 +184,34 @@ GstCamera::GstCamera(std::unique_ptr<CameraStreamHandler> handler)
 }
 
 GstCamera::~GstCamera() {
+  if (recorder_) {
+    recorder_->Stop();
+    recorder_ = nullptr;
+  }
+#ifdef USE_RTSP_SERVER
+  stream_server_ = nullptr;
+#endif  // USE_RTSP_SERVER
   Stop();
   DestroyPipeline();
+  FailPendingBursts();
+#ifdef USE_EGL_IMAGE_DMABUF
+  UnrefEGLImage();
+#endif  // USE_EGL_IMAGE_DMABUF
 }
 
+#ifdef USE_TRACE_EVENTS
 // static
-void GstCamera::GstLibraryLoad() { gst_init(NULL, NULL); }
+std::string GstCamera::CreateTraceTrack() {
+  static std::atomic<int> count{0};
+  return "camera " + std::to_string(++count);
+}
+#endif  // USE_TRACE_EVENTS
+
+// static
+void GstCamera::GstLibraryLoad() { GstRuntime::Acquire(); }
 
 // static
-void GstCamera::GstLibraryUnload() { gst_deinit(); }
+void GstCamera::GstLibraryUnload() { GstRuntime::Release(); }
 
 bool GstCamera::Play() {
   auto result = gst_element_set_state(gst_.pipeline, GST_STATE_PLAYING);
@@ -78,18 +252,224 @@ bool GstCamera::Stop() {
 }
 
 void GstCamera::TakePicture(OnNotifyCaptured on_notify_captured) {
-  if (!gst_.camerabin) {
+  if (!gst_.camerabin && !gst_.capture_valve) {
     std::cerr << "Failed to take a picture" << std::endl;
     return;
   }
 
-  on_notify_captured_ = on_notify_captured;
-  std::string filename =
-      g_strdup_printf("captured_%04u.jpg", captured_count_++);
-  g_object_set(gst_.camerabin, "location", filename.c_str(), NULL);
-  g_signal_emit_by_name(gst_.camerabin, "start-capture", NULL);
+  auto filename = GetNextCaptureFilename();
+  if (gst_.camerabin) {
+    on_notify_captured_ = on_notify_captured;
+    g_object_set(gst_.camerabin, "location", filename.c_str(), NULL);
+    g_signal_emit_by_name(gst_.camerabin, "start-capture", NULL);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_capture_);
+    if (is_capturing_) {
+      std::cerr << "A picture is already being taken" << std::endl;
+      on_notify_captured("");
+      return;
+    }
+    on_notify_captured_ = on_notify_captured;
+    capture_filename_ = filename;
+    is_capturing_ = true;
+  }
+  // Lets the next frame through to the encoder of the capture branch.
+  g_object_set(G_OBJECT(gst_.capture_valve), "drop", FALSE, NULL);
+}
+
+bool GstCamera::TakePictureBurst(int32_t count, bool in_memory,
+                                 OnNotifyBurstCaptured on_notify_captured) {
+  if (!gst_.pipeline || count <= 0) {
+    std::cerr << "Failed to take a burst of pictures" << std::endl;
+    return false;
+  }
+
+  auto burst = std::make_shared<Burst>();
+  burst->count = count;
+  burst->in_memory = in_memory;
+  burst->on_notify_captured = std::move(on_notify_captured);
+  burst->frames_to_take = count;
+  burst->pictures.resize(count);
+  std::lock_guard<std::mutex> lock(mutex_burst_);
+  if (!encoder_pool_) {
+    encoder_pool_ = std::make_unique<JpegEncoderPool>(kEncoderThreadCount,
+                                                      kMaxQueuedPictures);
+  }
+  bursts_.push_back(std::move(burst));
+  return true;
+}
+
+bool GstCamera::CaptureFrame(FrameCapturePool& pool,
+                             const FrameCapturePool::Request& request,
+                             FrameCapturePool::Callback callback) {
+  std::shared_lock<std::shared_mutex> lock(mutex_buffer_);
+  if (!gst_.buffer || buffer_width_ <= 0 || buffer_height_ <= 0) {
+    std::cerr << "No preview frame to capture" << std::endl;
+    return false;
+  }
+#ifdef USE_EGL_IMAGE_DMABUF
+  // As with the bursts, the few DMABUF buffers of the converter mustn't
+  // wait for the capture.
+  auto* frame = gst_buffer_copy_deep(gst_.buffer);
+#else
+  auto* frame = gst_buffer_ref(gst_.buffer);
+#endif  // USE_EGL_IMAGE_DMABUF
+  auto caps_string = std::string(kOutputCaps) +
+                     ",width=" + std::to_string(buffer_width_) +
+                     ",height=" + std::to_string(buffer_height_) +
+                     ",framerate=0/1";
+  auto* caps = gst_caps_from_string(caps_string.c_str());
+  const auto is_queued = pool.Capture(frame, caps, request, std::move(callback));
+  gst_caps_unref(caps);
+  gst_buffer_unref(frame);
+  return is_queued;
+}
+
+// static
+std::string GstCamera::GetNextCaptureFilename() {
+  auto* name = g_strdup_printf("captured_%04u.jpg", captured_count_++);
+  std::string filename(name);
+  g_free(name);
+  return filename;
 }
 
+void GstCamera::TakeBurstFrame(GstBuffer* buffer, int32_t width,
+                               int32_t height) {
+  std::lock_guard<std::mutex> lock(mutex_burst_);
+  if (bursts_.empty()) {
+    return;
+  }
+
+#ifdef USE_EGL_IMAGE_DMABUF
+  // The converter has only a few DMABUF buffers, which mustn't wait for the
+  // encoders.
+  auto* frame = gst_buffer_copy_deep(buffer);
+#else
+  auto* frame = gst_buffer_ref(buffer);
+#endif  // USE_EGL_IMAGE_DMABUF
+  auto caps_string = std::string(kOutputCaps) +
+                     ",width=" + std::to_string(width) +
+                     ",height=" + std::to_string(height) + ",framerate=0/1";
+  auto* caps = gst_caps_from_string(caps_string.c_str());
+
+  for (auto& burst : bursts_) {
+    const int32_t index = burst->count - burst->frames_to_take;
+    std::string path;
+    if (!burst->in_memory) {
+      path = GetNextCaptureFilename();
+    }
+    auto on_encoded = [burst, index, path](std::vector<uint8_t>&& jpeg) {
+      CapturedPicture picture;
+      if (!jpeg.empty()) {
+        if (burst->in_memory) {
+          picture.jpeg = std::move(jpeg);
+        } else if (WriteFile(path, jpeg.data(), jpeg.size())) {
+          picture.path = path;
+        }
+      }
+
+      std::vector<CapturedPicture> pictures;
+      {
+        std::lock_guard<std::mutex> burst_lock(burst->mutex);
+        burst->pictures[index] = std::move(picture);
+        if (++burst->done_count < burst->count) {
+          return;
+        }
+        pictures.swap(burst->pictures);
+      }
+      burst->on_notify_captured(std::move(pictures));
+    };
+    if (encoder_pool_->Encode(frame, caps, std::move(on_encoded))) {
+      burst->frames_to_take--;
+    }
+  }
+  bursts_.erase(std::remove_if(bursts_.begin(), bursts_.end(),
+                               [](const std::shared_ptr<Burst>& burst) {
+                                 return burst->frames_to_take == 0;
+                               }),
+                bursts_.end());
+
+  gst_caps_unref(caps);
+  gst_buffer_unref(frame);
+}
+
+void GstCamera::FailPendingBursts() {
+  std::vector<std::shared_ptr<Burst>> bursts;
+  {
+    std::lock_guard<std::mutex> lock(mutex_burst_);
+    bursts.swap(bursts_);
+  }
+  for (auto& burst : bursts) {
+    std::vector<CapturedPicture> pictures;
+    {
+      std::lock_guard<std::mutex> burst_lock(burst->mutex);
+      burst->done_count += burst->frames_to_take;
+      burst->frames_to_take = 0;
+      if (burst->done_count < burst->count) {
+        continue;
+      }
+      pictures.swap(burst->pictures);
+    }
+    burst->on_notify_captured(std::move(pictures));
+  }
+}
+
+void GstCamera::SetImageStreamWorker(ImageStreamWorker* worker) {
+  std::lock_guard<std::mutex> lock(mutex_image_stream_);
+  image_stream_worker_ = worker;
+}
+
+bool GstCamera::StartVideoRecording(VideoRecorder::Codec codec) {
+  if (recorder_) {
+    std::cerr << "The video is already being recorded" << std::endl;
+    return false;
+  }
+  if (!gst_.tee) {
+    std::cerr << "Video recording requires a V4L2 camera" << std::endl;
+    return false;
+  }
+
+  auto* name = g_strdup_printf("recorded_%04u.mp4", recorded_count_++);
+  std::string path(name);
+  g_free(name);
+  recorder_ = VideoRecorder::Start(gst_.pipeline, gst_.tee, path, codec);
+  return recorder_ != nullptr;
+}
+
+std::string GstCamera::StopVideoRecording() {
+  if (!recorder_) {
+    std::cerr << "The video isn't being recorded" << std::endl;
+    return std::string();
+  }
+  auto path = recorder_->Stop() ? recorder_->GetPath() : std::string();
+  recorder_ = nullptr;
+  return path;
+}
+
+#ifdef USE_RTSP_SERVER
+bool GstCamera::StartStreamServer(const RtspStreamServer::Options& options) {
+  if (stream_server_) {
+    std::cerr << "The stream is already being served" << std::endl;
+    return false;
+  }
+  if (!gst_.tee) {
+    std::cerr << "Streaming requires a V4L2 camera" << std::endl;
+    return false;
+  }
+  stream_server_ = RtspStreamServer::Start(gst_.pipeline, gst_.tee, options);
+  return stream_server_ != nullptr;
+}
+
+void GstCamera::StopStreamServer() { stream_server_ = nullptr; }
+
+std::string GstCamera::GetStreamServerUrl() const {
+  return stream_server_ ? stream_server_->GetUrl() : std::string();
+}
+#endif  // USE_RTSP_SERVER
+
 bool GstCamera::SetZoomLevel(float zoom) {
   if (zoom_level_ == zoom) {
     return true;
@@ -110,32 +490,232 @@ bool GstCamera::SetZoomLevel(float zoom) {
   return true;
 }
 
-const uint8_t* GstCamera::GetPreviewFrameBuffer() {
+FrameMetadata GstCamera::GetPreviewFrameMetadata() {
+  std::shared_lock<std::shared_mutex> lock(mutex_buffer_);
+  return buffer_metadata_;
+}
+
+const uint8_t* GstCamera::GetPreviewFrameBuffer(int32_t& width,
+                                                int32_t& height) {
+  TRACE_SCOPE(trace_track_, "GetPreviewFrameBuffer");
   std::shared_lock<std::shared_mutex> lock(mutex_buffer_);
   if (!gst_.buffer) {
     return nullptr;
   }
+  // Only the raster thread touches |pixels_|, so it can be replaced here
+  // while the previous frame is no longer read.
+  const size_t pixel_bytes =
+      static_cast<size_t>(buffer_width_) * buffer_height_ * 4;
+  if (pixel_bytes > pixels_.capacity()) {
+    pixels_ = FrameBufferPool::GetInstance().Acquire(pixel_bytes);
+    if (!pixels_.data()) {
+      std::cerr << "Failed to allocate a pixel buffer" << std::endl;
+      return nullptr;
+    }
+  }
+  if (buffer_metadata_.frame_number != textured_frame_number_) {
+    textured_frame_number_ = buffer_metadata_.frame_number;
+    frame_stats_.RecordSince(FrameStats::kCaptureToTexture,
+                             buffer_metadata_.capture_time_us);
+    stats_.Add(PluginStats::kFramesRendered);
+  }
+
+  gst_buffer_extract(gst_.buffer, 0, pixels_.data(), pixel_bytes);
+  stats_.Add(PluginStats::kBytesCopied, pixel_bytes);
+  width = buffer_width_;
+  height = buffer_height_;
+  return pixels_.data();
+}
+
+#ifdef USE_EGL_IMAGE_DMABUF
+void* GstCamera::GetEGLImage(void* egl_display, void* egl_context) {
+  TRACE_SCOPE(trace_track_, "GetEGLImage");
+  GstCaps* caps = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_buffer_);
+    if (!gst_.buffer || !buffer_caps_) {
+      return nullptr;
+    }
+    if (gst_.buffer != rendered_buffer_) {
+      if (rendered_buffer_) {
+        gst_buffer_unref(rendered_buffer_);
+      }
+      rendered_buffer_ = gst_buffer_ref(gst_.buffer);
+    }
+    if (buffer_metadata_.frame_number != textured_frame_number_) {
+      textured_frame_number_ = buffer_metadata_.frame_number;
+      frame_stats_.RecordSince(FrameStats::kCaptureToTexture,
+                               buffer_metadata_.capture_time_us);
+      stats_.Add(PluginStats::kFramesRendered);
+    }
+    caps = gst_caps_ref(buffer_caps_);
+  }
+
+  GstMemory* memory = gst_buffer_peek_memory(rendered_buffer_, 0);
+  if (!gst_is_dmabuf_memory(memory)) {
+    if (!warned_non_dmabuf_) {
+      std::cerr << "The preview frames are not in DMABUF memory. Use a "
+                   "converter that can export DMABUF."
+                << std::endl;
+      warned_non_dmabuf_ = true;
+    }
+    gst_caps_unref(caps);
+    return nullptr;
+  }
+  if (!EnsureGLContext(egl_display, egl_context)) {
+    gst_caps_unref(caps);
+    return nullptr;
+  }
+
+  if (!egl_image_caps_ || !gst_caps_is_equal(egl_image_caps_, caps)) {
+    ClearEGLImageCache();
+    if (!gst_video_info_from_caps(&gst_video_info_, caps)) {
+      std::cerr << "Failed to get a gst_video_info" << std::endl;
+      gst_caps_unref(caps);
+      return nullptr;
+    }
+    gst_caps_replace(&egl_image_caps_, caps);
+  }
+  gst_caps_unref(caps);
+
+  const gint fd = gst_dmabuf_memory_get_fd(memory);
+  const auto key = std::make_tuple(memory, fd, memory->offset);
+  auto it = egl_images_.find(key);
+  if (it == egl_images_.end()) {
+    if (egl_images_.size() >= kMaxCachedEGLImages) {
+      // The upstream pool isn't recycling its buffers.
+      ClearEGLImageCache();
+    }
+    auto* image = gst_egl_image_from_dmabuf(gst_gl_ctx_, fd, &gst_video_info_,
+                                            0, memory->offset);
+    if (!image) {
+      std::cerr << "Failed to create an EGLImage from dmabuf" << std::endl;
+      return nullptr;
+    }
+    it = egl_images_.emplace(key, image).first;
+  }
+  return reinterpret_cast<void*>(gst_egl_image_get_image(it->second));
+}
+
+bool GstCamera::EnsureGLContext(void* egl_display, void* egl_context) {
+  if (gst_gl_ctx_ && egl_display == egl_display_ &&
+      egl_context == egl_context_) {
+    gst_gl_context_activate(gst_gl_ctx_, TRUE);
+    return true;
+  }
+  ClearEGLImageCache();
+  if (gst_gl_ctx_) {
+    gst_object_unref(gst_gl_ctx_);
+    gst_gl_ctx_ = NULL;
+  }
+  if (gst_gl_display_egl_) {
+    gst_object_unref(gst_gl_display_egl_);
+    gst_gl_display_egl_ = NULL;
+  }
+
+  gst_gl_display_egl_ = gst_gl_display_egl_new_with_egl_display(
+      reinterpret_cast<gpointer>(egl_display));
+  if (!gst_gl_display_egl_) {
+    std::cerr << "Failed to wrap the EGL display" << std::endl;
+    return false;
+  }
+  gst_gl_ctx_ = gst_gl_context_new_wrapped(
+      GST_GL_DISPLAY_CAST(gst_gl_display_egl_),
+      reinterpret_cast<guintptr>(egl_context), GST_GL_PLATFORM_EGL,
+      GST_GL_API_GLES2);
+  if (!gst_gl_ctx_) {
+    std::cerr << "Failed to wrap the EGL context" << std::endl;
+    gst_object_unref(gst_gl_display_egl_);
+    gst_gl_display_egl_ = NULL;
+    return false;
+  }
+  egl_display_ = egl_display;
+  egl_context_ = egl_context;
 
-  const uint32_t pixel_bytes = width_ * height_ * 4;
-  gst_buffer_extract(gst_.buffer, 0, pixels_.get(), pixel_bytes);
-  return reinterpret_cast<const uint8_t*>(pixels_.get());
+  gst_gl_context_activate(gst_gl_ctx_, TRUE);
+  return true;
 }
 
-// Creats a camra pipeline using camerabin.
-// $ gst-launch-1.0 camerabin viewfinder-sink="videoconvert !
-// video/x-raw,format=RGBA ! fakesink"
+void GstCamera::ClearEGLImageCache() {
+  for (auto& entry : egl_images_) {
+    gst_egl_image_unref(entry.second);
+  }
+  egl_images_.clear();
+}
+
+void GstCamera::UnrefEGLImage() {
+  ClearEGLImageCache();
+  if (egl_image_caps_) {
+    gst_caps_unref(egl_image_caps_);
+    egl_image_caps_ = NULL;
+  }
+  if (rendered_buffer_) {
+    gst_buffer_unref(rendered_buffer_);
+    rendered_buffer_ = NULL;
+  }
+  if (gst_gl_ctx_) {
+    gst_object_unref(gst_gl_ctx_);
+    gst_gl_ctx_ = NULL;
+  }
+  if (gst_gl_display_egl_) {
+    gst_object_unref(gst_gl_display_egl_);
+    gst_gl_display_egl_ = NULL;
+  }
+  egl_display_ = nullptr;
+  egl_context_ = nullptr;
+}
+#endif  // USE_EGL_IMAGE_DMABUF
+
 bool GstCamera::CreatePipeline() {
   gst_.pipeline = gst_pipeline_new("pipeline");
   if (!gst_.pipeline) {
     std::cerr << "Failed to create a pipeline" << std::endl;
     return false;
   }
-  gst_.camerabin = gst_element_factory_make("camerabin", "camerabin");
-  if (!gst_.camerabin) {
-    std::cerr << "Failed to create a source" << std::endl;
+  gst_.bus = gst_pipeline_get_bus(GST_PIPELINE(gst_.pipeline));
+  if (!gst_.bus) {
+    std::cerr << "Failed to create a bus" << std::endl;
+    return false;
+  }
+  gst_bus_set_sync_handler(gst_.bus, HandleGstMessage, this,
+                           NULL);
+
+  if (!CreateOutput()) {
     return false;
   }
+
+  if (!device_path_.empty()) {
+    auto* caps = CameraMode::QueryCaps(device_path_);
+    auto mode = CameraMode::Select(caps, preview_config_.width,
+                                   preview_config_.height, preview_config_.fps,
+                                   HasHardwareJpegDecoder());
+    if (caps) {
+      gst_caps_unref(caps);
+    }
+    if (mode.IsValid()) {
+      return CreateDirectPipeline(mode);
+    }
+    std::cerr << "No supported mode on " << device_path_
+              << ", falling back to camerabin" << std::endl;
+  }
+  return CreateCamerabinPipeline();
+}
+
+// Creates the bin that converts the preview frames to RGBA and hands them to
+// HandoffHandler:
+// videoconvert ! video/x-raw,format=RGBA ! fakesink
+bool GstCamera::CreateOutput() {
+#ifdef USE_EGL_IMAGE_DMABUF
+  gst_.video_convert = gst_element_factory_make("v4l2convert", "videoconvert");
+  if (gst_.video_convert) {
+    RequestDmabufOutput(gst_.video_convert);
+  } else {
+    gst_.video_convert =
+        gst_element_factory_make("videoconvert", "videoconvert");
+  }
+#else
   gst_.video_convert = gst_element_factory_make("videoconvert", "videoconvert");
+#endif  // USE_EGL_IMAGE_DMABUF
   if (!gst_.video_convert) {
     std::cerr << "Failed to create a videoconvert" << std::endl;
     return false;
@@ -145,18 +725,19 @@ bool GstCamera::CreatePipeline() {
     std::cerr << "Failed to create a videosink" << std::endl;
     return false;
   }
+  auto* video_sinkpad = gst_element_get_static_pad(gst_.video_sink, "sink");
+  gst_pad_add_probe(video_sinkpad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+                    OnVideoSinkEvent, this, nullptr);
+#ifdef USE_EGL_IMAGE_DMABUF
+  gst_pad_add_probe(video_sinkpad, GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM,
+                    OnVideoSinkQuery, nullptr, nullptr);
+#endif  // USE_EGL_IMAGE_DMABUF
+  gst_object_unref(video_sinkpad);
   gst_.output = gst_bin_new("output");
   if (!gst_.output) {
     std::cerr << "Failed to create an output" << std::endl;
     return false;
   }
-  gst_.bus = gst_pipeline_get_bus(GST_PIPELINE(gst_.pipeline));
-  if (!gst_.bus) {
-    std::cerr << "Failed to create a bus" << std::endl;
-    return false;
-  }
-  gst_bus_set_sync_handler(gst_.bus, HandleGstMessage, this,
-                           NULL);
 
   // Sets properties to fakesink to get the callback of a decoded frame.
   g_object_set(G_OBJECT(gst_.video_sink), "sync", TRUE, "qos", FALSE, NULL);
@@ -167,7 +748,11 @@ bool GstCamera::CreatePipeline() {
                    NULL);
 
   // Adds caps to the converter to convert the color format to RGBA.
-  auto* caps = gst_caps_from_string("video/x-raw,format=RGBA");
+#ifdef USE_EGL_IMAGE_DMABUF
+  auto* caps = gst_caps_from_string(kDmabufOutputCaps);
+#else
+  auto* caps = gst_caps_from_string(kOutputCaps);
+#endif  // USE_EGL_IMAGE_DMABUF
   auto link_ok =
       gst_element_link_filtered(gst_.video_convert, gst_.video_sink, caps);
   gst_caps_unref(caps);
@@ -181,6 +766,37 @@ bool GstCamera::CreatePipeline() {
   gst_pad_set_active(ghost_sinkpad, TRUE);
   gst_element_add_pad(gst_.output, ghost_sinkpad);
 
+  return true;
+}
+
+// Creats a camra pipeline using camerabin.
+// $ gst-launch-1.0 camerabin viewfinder-sink="videoconvert !
+// video/x-raw,format=RGBA ! fakesink"
+//
+// With USE_EGL_IMAGE_DMABUF, v4l2src exports DMABUF and v4l2convert, if
+// available, converts into DMABUF as well:
+// $ gst-launch-1.0 camerabin flags=no-viewfinder-conversion
+// viewfinder-sink="v4l2convert capture-io-mode=dmabuf !
+// video/x-raw(memory:DMABuf),format=RGBA ! fakesink"
+bool GstCamera::CreateCamerabinPipeline() {
+  gst_.camerabin = gst_element_factory_make("camerabin", "camerabin");
+  if (!gst_.camerabin) {
+    std::cerr << "Failed to create a source" << std::endl;
+    return false;
+  }
+
+#ifdef USE_EGL_IMAGE_DMABUF
+  DisableViewfinderConversion(gst_.camerabin);
+  g_signal_connect(gst_.camerabin, "deep-element-added",
+                   G_CALLBACK(OnDeepElementAdded), nullptr);
+#endif  // USE_EGL_IMAGE_DMABUF
+
+  if (!device_path_.empty() && !SetCameraSource()) {
+    return false;
+  }
+
+  SetViewfinderCaps();
+
   // Sets properties to camerabin.
   g_object_set(gst_.camerabin, "viewfinder-sink", gst_.output, NULL);
   gst_bin_add_many(GST_BIN(gst_.pipeline), gst_.camerabin, NULL);
@@ -188,8 +804,223 @@ bool GstCamera::CreatePipeline() {
   return true;
 }
 
+// Creates a pipeline that reads |mode| from the device without camerabin,
+// and takes pictures from a branch that only lets a frame through on
+// request. videorate drops the frames beyond the requested rate if the
+// device can't capture at it. e.g.
+// $ gst-launch-1.0 v4l2src device=/dev/video0 !
+// image/jpeg,width=1280,height=720 ! v4l2jpegdec ! tee name=t
+// t. ! queue leaky=downstream max-size-buffers=2 ! videoconvert !
+// video/x-raw,format=RGBA ! fakesink
+// t. ! queue leaky=downstream max-size-buffers=1 ! valve drop=true !
+// videoconvert ! jpegenc ! fakesink
+// Raw modes skip the decoder.
+bool GstCamera::CreateDirectPipeline(const CameraMode& mode) {
+  gst_.source = gst_element_factory_make("v4l2src", "camerasource");
+  auto* source_caps = gst_element_factory_make("capsfilter", "sourcecaps");
+  GstElement* decoder = nullptr;
+  if (mode.format == CameraMode::Format::kMjpeg) {
+    decoder = CreateJpegDecoder();
+  }
+  stats_.SetDecoder(decoder ? GST_OBJECT_NAME(gst_element_get_factory(decoder))
+                            : "");
+  gst_.tee = gst_element_factory_make("tee", "tee");
+  auto* preview_queue = gst_element_factory_make("queue", "previewqueue");
+  GstElement* preview_rate = nullptr;
+  const bool limits_rate =
+      preview_config_.fps > 0 &&
+      (mode.fps_n == 0 || mode.GetFps() > preview_config_.fps);
+  if (limits_rate) {
+    preview_rate = gst_element_factory_make("videorate", "previewrate");
+  }
+  auto* capture_queue = gst_element_factory_make("queue", "capturequeue");
+  gst_.capture_valve = gst_element_factory_make("valve", "capturevalve");
+  auto* capture_convert =
+      gst_element_factory_make("videoconvert", "captureconvert");
+  auto* capture_encoder = gst_element_factory_make("jpegenc", "captureenc");
+  gst_.capture_sink = gst_element_factory_make("fakesink", "capturesink");
+
+  std::vector<GstElement*> preview_chain = {gst_.source, source_caps};
+  if (mode.format == CameraMode::Format::kMjpeg) {
+    preview_chain.push_back(decoder);
+  }
+  preview_chain.insert(preview_chain.end(), {gst_.tee, preview_queue});
+  if (limits_rate) {
+    preview_chain.push_back(preview_rate);
+  }
+  preview_chain.push_back(gst_.output);
+  const std::vector<GstElement*> capture_chain = {
+      gst_.tee,        capture_queue,   gst_.capture_valve,
+      capture_convert, capture_encoder, gst_.capture_sink};
+  bool created = true;
+  for (auto* element : preview_chain) {
+    created = created && element;
+  }
+  for (auto* element : capture_chain) {
+    created = created && element;
+  }
+  if (!created) {
+    std::cerr << "Failed to create the elements of the camera pipeline"
+              << std::endl;
+    for (auto* element :
+         {gst_.source, source_caps, decoder, gst_.tee, preview_queue,
+          preview_rate, capture_queue, gst_.capture_valve, capture_convert,
+          capture_encoder, gst_.capture_sink}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    gst_.source = nullptr;
+    gst_.tee = nullptr;
+    gst_.capture_valve = nullptr;
+    gst_.capture_sink = nullptr;
+    return false;
+  }
+
+  g_object_set(G_OBJECT(gst_.source), "device", device_path_.c_str(), NULL);
+#ifdef USE_EGL_IMAGE_DMABUF
+  RequestDmabufOutput(gst_.source);
+  if (decoder) {
+    RequestDmabufOutput(decoder);
+  }
+#endif  // USE_EGL_IMAGE_DMABUF
+  auto* caps = gst_caps_from_string(mode.ToCapsString().c_str());
+  g_object_set(G_OBJECT(source_caps), "caps", caps, NULL);
+  gst_caps_unref(caps);
+
+  // Neither branch may hold the camera back: the preview keeps the latest
+  // frames only, and the capture branch the latest one.
+  g_object_set(G_OBJECT(preview_queue), "max-size-buffers", 2,
+               "max-size-bytes", 0, "max-size-time", 0, NULL);
+  gst_util_set_object_arg(G_OBJECT(preview_queue), "leaky", "downstream");
+  if (preview_rate) {
+    g_object_set(G_OBJECT(preview_rate), "drop-only", TRUE, "max-rate",
+                 preview_config_.fps, NULL);
+  }
+  g_object_set(G_OBJECT(capture_queue), "max-size-buffers", 1,
+               "max-size-bytes", 0, "max-size-time", 0, NULL);
+  gst_util_set_object_arg(G_OBJECT(capture_queue), "leaky", "downstream");
+  g_object_set(G_OBJECT(gst_.capture_valve), "drop", TRUE, NULL);
+
+  // The capture sink sees no buffer until a picture is taken, so it must not
+  // wait for one to preroll.
+  g_object_set(G_OBJECT(gst_.capture_sink), "sync", FALSE, "async", FALSE,
+               "signal-handoffs", TRUE, NULL);
+  g_signal_connect(G_OBJECT(gst_.capture_sink), "handoff",
+                   G_CALLBACK(CaptureHandoffHandler), this);
+
+  auto* source_pad = gst_element_get_static_pad(gst_.source, "src");
+  gst_pad_add_probe(source_pad, GST_PAD_PROBE_TYPE_BUFFER, SourceProbe, this,
+                    nullptr);
+  gst_object_unref(source_pad);
+
+  for (auto* element : preview_chain) {
+    gst_bin_add(GST_BIN(gst_.pipeline), element);
+  }
+  for (auto* element : capture_chain) {
+    if (element != gst_.tee) {
+      gst_bin_add(GST_BIN(gst_.pipeline), element);
+    }
+  }
+  if (!LinkChain(preview_chain) || !LinkChain(capture_chain)) {
+    std::cerr << "Failed to link elements" << std::endl;
+    return false;
+  }
+
+  mode_ = mode;
+  PLUGIN_LOG(Info, "caps") << "Camera mode: " << mode.ToCapsString();
+  return true;
+}
+
+// Replaces the default source of camerabin with
+// wrappercamerabinsrc video-source="v4l2src device=<device_path_>".
+bool GstCamera::SetCameraSource() {
+  auto* source = gst_element_factory_make("v4l2src", nullptr);
+  if (!source) {
+    std::cerr << "Failed to create a v4l2src" << std::endl;
+    return false;
+  }
+  g_object_set(G_OBJECT(source), "device", device_path_.c_str(), NULL);
+#ifdef USE_EGL_IMAGE_DMABUF
+  RequestDmabufOutput(source);
+#endif  // USE_EGL_IMAGE_DMABUF
+
+  auto* camera_source =
+      gst_element_factory_make("wrappercamerabinsrc", "camerasource");
+  if (!camera_source) {
+    std::cerr << "Failed to create a wrappercamerabinsrc" << std::endl;
+    gst_object_unref(source);
+    return false;
+  }
+  g_object_set(camera_source, "video-source", source, NULL);
+  g_object_set(gst_.camerabin, "camera-source", camera_source, NULL);
+  return true;
+}
+
+// Asks camerabin for the preview size and rate of |preview_config_|, which
+// it scales and converts to if the source can't capture at them.
+void GstCamera::SetViewfinderCaps() {
+  if (preview_config_.width <= 0 && preview_config_.fps <= 0) {
+    return;
+  }
+  std::string caps_string = "video/x-raw";
+  if (preview_config_.width > 0 && preview_config_.height > 0) {
+    caps_string += ",width=" + std::to_string(preview_config_.width) +
+                   ",height=" + std::to_string(preview_config_.height);
+  }
+  if (preview_config_.fps > 0) {
+    caps_string +=
+        ",framerate=" + std::to_string(preview_config_.fps) + "/1";
+  }
+  auto* caps = gst_caps_from_string(caps_string.c_str());
+  if (!caps) {
+    std::cerr << "Failed to create caps: " << caps_string << std::endl;
+    return;
+  }
+  g_object_set(gst_.camerabin, "viewfinder-caps", caps, NULL);
+  gst_caps_unref(caps);
+}
+
+bool GstCamera::GetNegotiatedPreview(int32_t& width, int32_t& height,
+                                     double& fps) {
+  GstCaps* caps = nullptr;
+  if (gst_.video_sink) {
+    auto* pad = gst_element_get_static_pad(gst_.video_sink, "sink");
+    caps = gst_pad_get_current_caps(pad);
+    gst_object_unref(pad);
+  }
+  if (caps) {
+    auto* structure = gst_caps_get_structure(caps, 0);
+    gint fps_n = 0;
+    gint fps_d = 1;
+    auto has_size = structure &&
+                    gst_structure_get_int(structure, "width", &width) &&
+                    gst_structure_get_int(structure, "height", &height);
+    if (!structure ||
+        !gst_structure_get_fraction(structure, "framerate", &fps_n, &fps_d) ||
+        fps_d <= 0) {
+      fps_n = mode_.fps_n;
+      fps_d = mode_.fps_d;
+    }
+    gst_caps_unref(caps);
+    if (has_size) {
+      fps = static_cast<double>(fps_n) / fps_d;
+      return true;
+    }
+  }
+
+  // The direct pipeline doesn't scale, so its mode is the preview size.
+  if (!mode_.IsValid()) {
+    return false;
+  }
+  width = mode_.width;
+  height = mode_.height;
+  fps = mode_.GetFps();
+  return true;
+}
+
 void GstCamera::Preroll() {
-  if (!gst_.camerabin) {
+  if (!gst_.pipeline) {
     return;
   }
 
@@ -214,6 +1045,9 @@ void GstCamera::DestroyPipeline() {
   if (gst_.video_sink) {
     g_object_set(G_OBJECT(gst_.video_sink), "signal-handoffs", FALSE, NULL);
   }
+  if (gst_.capture_sink) {
+    g_object_set(G_OBJECT(gst_.capture_sink), "signal-handoffs", FALSE, NULL);
+  }
 
   if (gst_.pipeline) {
     gst_element_set_state(gst_.pipeline, GST_STATE_NULL);
@@ -224,6 +1058,17 @@ void GstCamera::DestroyPipeline() {
     gst_.buffer = nullptr;
   }
 
+#ifdef USE_EGL_IMAGE_DMABUF
+  if (caps_) {
+    gst_caps_unref(caps_);
+    caps_ = NULL;
+  }
+  if (buffer_caps_) {
+    gst_caps_unref(buffer_caps_);
+    buffer_caps_ = NULL;
+  }
+#endif  // USE_EGL_IMAGE_DMABUF
+
   if (gst_.bus) {
     gst_object_unref(gst_.bus);
     gst_.bus = nullptr;
@@ -238,6 +1083,11 @@ void GstCamera::DestroyPipeline() {
     gst_.camerabin = nullptr;
   }
 
+  gst_.source = nullptr;
+  gst_.tee = nullptr;
+  gst_.capture_valve = nullptr;
+  gst_.capture_sink = nullptr;
+
   if (gst_.output) {
     gst_.output = nullptr;
   }
@@ -252,48 +1102,201 @@ void GstCamera::DestroyPipeline() {
 }
 
 void GstCamera::GetZoomMaxMinSize(float& max, float& min) {
-  if (!gst_.pipeline || !gst_.camerabin) {
+  if (!gst_.pipeline) {
     std::cerr << "The pileline hasn't initialized yet.";
     return;
   }
+  // The direct pipeline has no digital zoom.
+  if (!gst_.camerabin) {
+    max = 1.0;
+    min = 1.0;
+    return;
+  }
 
   g_object_get(gst_.camerabin, "max-zoom", &max, NULL);
   min = 1.0;
 }
 
 // static
-void GstCamera::HandoffHandler(GstElement* fakesink, GstBuffer* buf,
-                               GstPad* new_pad, gpointer user_data) {
+GstPadProbeReturn GstCamera::SourceProbe(GstPad* pad, GstPadProbeInfo* info,
+                                         gpointer user_data) {
+  auto* self = reinterpret_cast<GstCamera*>(user_data);
+  auto* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  if (!GST_BUFFER_PTS_IS_VALID(buffer)) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  // v4l2src sets the offset to the sequence number of the driver, which
+  // skips the frames the driver lost.
+  auto& metadata = self->last_metadata_;
+  const auto sequence = GST_BUFFER_OFFSET(buffer);
+  if (sequence == GST_BUFFER_OFFSET_NONE) {
+    metadata.frame_number =
+        self->has_frame_number_ ? metadata.frame_number + 1 : 0;
+  } else {
+    if (self->has_frame_number_ && sequence > self->last_sequence_ + 1) {
+      metadata.dropped_frames += sequence - self->last_sequence_ - 1;
+    }
+    self->last_sequence_ = sequence;
+    metadata.frame_number = sequence;
+  }
+  self->has_frame_number_ = true;
+  metadata.capture_time_us =
+      FrameStats::GetCaptureTime(self->gst_.pipeline, buffer);
+
+  std::lock_guard<std::mutex> lock(self->mutex_frame_metadata_);
+  self->source_metadata_.emplace_back(GST_BUFFER_PTS(buffer), metadata);
+  if (self->source_metadata_.size() > kMaxPendingFrameMetadata) {
+    self->source_metadata_.pop_front();
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+FrameMetadata GstCamera::TakeFrameMetadata(GstBuffer* buffer) {
+  if (!gst_.source) {
+    // camerabin doesn't expose its source, so the frames reaching the
+    // preview are all that can be seen.
+    last_metadata_.frame_number =
+        has_frame_number_ ? last_metadata_.frame_number + 1 : 0;
+    has_frame_number_ = true;
+    last_metadata_.capture_time_us =
+        FrameStats::GetCaptureTime(gst_.pipeline, buffer);
+    return last_metadata_;
+  }
+
+  const auto pts = GST_BUFFER_PTS(buffer);
+  std::lock_guard<std::mutex> lock(mutex_frame_metadata_);
+  // The frames leave in order, so the older ones were dropped on the way:
+  // the preview skipped them, the sensor didn't lose them.
+  while (!source_metadata_.empty()) {
+    auto entry = source_metadata_.front();
+    source_metadata_.pop_front();
+    if (entry.first == pts) {
+      entry.second.skipped_frames = skipped_frames_;
+      return entry.second;
+    }
+    skipped_frames_++;
+  }
+  FrameMetadata metadata;
+  metadata.capture_time_us = FrameStats::GetCaptureTime(gst_.pipeline, buffer);
+  return metadata;
+}
+
+// static
+GstPadProbeReturn GstCamera::OnVideoSinkEvent(GstPad* pad,
+                                              GstPadProbeInfo* info,
+                                              gpointer user_data) {
+  auto* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) != GST_EVENT_CAPS) {
+    return GST_PAD_PROBE_OK;
+  }
   auto* self = reinterpret_cast<GstCamera*>(user_data);
-  auto* caps = gst_pad_get_current_caps(new_pad);
-  auto* structure = gst_caps_get_structure(caps, 0);
+  GstCaps* caps = nullptr;
+  gst_event_parse_caps(event, &caps);
+  auto* structure = caps ? gst_caps_get_structure(caps, 0) : nullptr;
+  gint width = 0;
+  gint height = 0;
+  if (!structure || !gst_structure_get_int(structure, "width", &width) ||
+      !gst_structure_get_int(structure, "height", &height) || width <= 0 ||
+      height <= 0) {
+    PLUGIN_LOG(Error, "caps") << "The preview caps have no size";
+    return GST_PAD_PROBE_OK;
+  }
 
-  int width;
-  int height;
-  gst_structure_get_int(structure, "width", &width);
-  gst_structure_get_int(structure, "height", &height);
-  gst_caps_unref(caps);
+#ifdef USE_EGL_IMAGE_DMABUF
+  gst_caps_replace(&self->caps_, caps);
+#endif  // USE_EGL_IMAGE_DMABUF
   if (width != self->width_ || height != self->height_) {
     self->width_ = width;
     self->height_ = height;
-    self->pixels_.reset(new uint32_t[width * height]);
-    std::cout << "Pixel buffer size: width = " << width
-              << ", height = " << height << std::endl;
+    PLUGIN_LOG(Info, "caps") << "Pixel buffer size: width = " << width
+                             << ", height = " << height;
   }
+  return GST_PAD_PROBE_OK;
+}
 
+// static
+void GstCamera::HandoffHandler(GstElement* fakesink, GstBuffer* buf,
+                               GstPad* new_pad, gpointer user_data) {
+  auto* self = reinterpret_cast<GstCamera*>(user_data);
+  TRACE_SCOPE(self->trace_track_, "HandoffHandler");
+  const auto metadata = self->TakeFrameMetadata(buf);
+  self->frame_stats_.RecordSince(FrameStats::kCaptureToHandoff,
+                                 metadata.capture_time_us);
+  self->stats_.Add(PluginStats::kFramesDecoded);
+  self->stats_.Set(PluginStats::kFramesDropped,
+                   metadata.dropped_frames + metadata.skipped_frames);
+  // The caps event precedes the buffers it describes on the streaming
+  // thread, so the size it left describes |buf|.
+  const int32_t width = self->width_;
+  const int32_t height = self->height_;
+  if (width <= 0 || height <= 0) {
+    return;
+  }
   std::lock_guard<std::shared_mutex> lock(self->mutex_buffer_);
+#ifdef USE_EGL_IMAGE_DMABUF
+  if (self->caps_) {
+    gst_caps_replace(&self->buffer_caps_, self->caps_);
+  }
+#endif  // USE_EGL_IMAGE_DMABUF
+  self->buffer_width_ = width;
+  self->buffer_height_ = height;
+
   if (self->gst_.buffer) {
     gst_buffer_unref(self->gst_.buffer);
     self->gst_.buffer = nullptr;
   }
   self->gst_.buffer = gst_buffer_ref(buf);
+  self->buffer_metadata_ = metadata;
+  {
+    std::lock_guard<std::mutex> stream_lock(self->mutex_image_stream_);
+    if (self->image_stream_worker_) {
+      self->image_stream_worker_->Push(buf, width, height, metadata);
+    }
+  }
+  self->TakeBurstFrame(buf, width, height);
   self->stream_handler_->OnNotifyFrameDecoded();
 }
 
+// static
+void GstCamera::CaptureHandoffHandler(GstElement* fakesink, GstBuffer* buf,
+                                      GstPad* new_pad, gpointer user_data) {
+  auto* self = reinterpret_cast<GstCamera*>(user_data);
+  TRACE_SCOPE(self->trace_track_, "CaptureHandoffHandler");
+  std::string filename;
+  OnNotifyCaptured on_notify_captured;
+  {
+    std::lock_guard<std::mutex> lock(self->mutex_capture_);
+    if (!self->is_capturing_) {
+      return;
+    }
+    g_object_set(G_OBJECT(self->gst_.capture_valve), "drop", TRUE, NULL);
+    self->is_capturing_ = false;
+    filename = self->capture_filename_;
+    on_notify_captured = self->on_notify_captured_;
+  }
+
+  GstMapInfo map;
+  if (!gst_buffer_map(buf, &map, GST_MAP_READ)) {
+    PLUGIN_LOG(Error, "capture") << "Failed to map a captured image";
+    filename.clear();
+  } else {
+    if (!WriteFile(filename, map.data, map.size)) {
+      filename.clear();
+    }
+    gst_buffer_unmap(buf, &map);
+  }
+  if (on_notify_captured) {
+    on_notify_captured(filename);
+  }
+}
+
 // static
 GstBusSyncReply GstCamera::HandleGstMessage(GstBus* bus,
                                             GstMessage* message,
                                             gpointer user_data) {
+  TRACE_GST_MESSAGE(reinterpret_cast<GstCamera*>(user_data)->trace_track_,
+                    message);
   switch (GST_MESSAGE_TYPE(message)) {
     case GST_MESSAGE_ELEMENT: {
       auto const* st = gst_message_get_structure(message);
@@ -307,13 +1310,16 @@ GstBusSyncReply GstCamera::HandleGstMessage(GstBus* bus,
       }
       break;
     }
+    case GST_MESSAGE_STREAM_STATUS:
+      ThreadPolicy::GetInstance().HandleStreamStatus(message);
+      break;
     case GST_MESSAGE_WARNING: {
       gchar* debug;
       GError* error;
       gst_message_parse_warning(message, &error, &debug);
-      g_printerr("WARNING from element %s: %s\n", GST_OBJECT_NAME(message->src),
-                 error->message);
-      g_printerr("Warning details: %s\n", debug);
+      PLUGIN_LOG(Warning, "gst")
+          << "WARNING from element " << GST_OBJECT_NAME(message->src) << ": "
+          << error->message << "\nWarning details: " << (debug ? debug : "");
       g_free(debug);
       g_error_free(error);
       break;
@@ -322,11 +1328,13 @@ GstBusSyncReply GstCamera::HandleGstMessage(GstBus* bus,
       gchar* debug;
       GError* error;
       gst_message_parse_error(message, &error, &debug);
-      g_printerr("ERROR from element %s: %s\n", GST_OBJECT_NAME(message->src),
-                 error->message);
-      g_printerr("Error details: %s\n", debug);
+      PLUGIN_LOG(Error, "gst")
+          << "ERROR from element " << GST_OBJECT_NAME(message->src) << ": "
+          << error->message << "\nError details: " << (debug ? debug : "");
       g_free(debug);
       g_error_free(error);
+      reinterpret_cast<GstCamera*>(user_data)->stats_.Add(
+          PluginStats::kBusErrors);
       break;
     }
     default:
@@ -7,19 +7,68 @@
 
 #include <gst/gst.h>
 
+#ifdef USE_EGL_IMAGE_DMABUF
+#include <gst/allocators/gstdmabuf.h>
+#include <gst/gl/egl/egl.h>
+#include <gst/gl/gl.h>
+#include <gst/video/video.h>
+#endif  // USE_EGL_IMAGE_DMABUF
+
+#include <atomic>
+#include <deque>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <tuple>
+#include <vector>
 
+#include "camera_mode.h"
 #include "camera_stream_handler.h"
+#include "frame_buffer_pool.h"
+#include "frame_capture_pool.h"
+#include "frame_stats.h"
+#include "image_stream_worker.h"
+#include "jpeg_encoder_pool.h"
+#include "plugin_stats.h"
+#include "trace_event.h"
+#include "video_recorder.h"
+#ifdef USE_RTSP_SERVER
+#include "rtsp_stream_server.h"
+#endif  // USE_RTSP_SERVER
 
 class GstCamera {
  public:
   using OnNotifyCaptured =
       std::function<void(const std::string& captured_file_path)>;
 
-  GstCamera(std::unique_ptr<CameraStreamHandler> handler);
+  // A picture of a burst, with either its path or its JPEG data. Both are
+  // empty if it failed.
+  struct CapturedPicture {
+    std::string path;
+    std::vector<uint8_t> jpeg;
+  };
+  using OnNotifyBurstCaptured =
+      std::function<void(std::vector<CapturedPicture>&& pictures)>;
+
+  struct PreviewConfig {
+    // The preview size the UI needs, zero for the largest one of the camera.
+    int32_t width = 0;
+    int32_t height = 0;
+    // The frame rate the UI needs, zero for the fastest one of the camera.
+    int32_t fps = 0;
+  };
+
+  // Opens |device_path| with v4l2src, or the default source of camerabin if
+  // empty. Each camera has a pipeline and streaming threads of its own.
+  //
+  // A V4L2 device is read in the native mode picked for |config|, without
+  // camerabin. camerabin is used for the default source, or if the device
+  // has no mode the pipeline can handle.
+  GstCamera(std::unique_ptr<CameraStreamHandler> handler,
+            const std::string& device_path, const PreviewConfig& config);
   ~GstCamera();
 
   static void GstLibraryLoad();
@@ -30,19 +79,91 @@ class GstCamera {
   bool Stop();
 
   void TakePicture(OnNotifyCaptured on_notify_captured);
+  // Takes the next |count| preview frames and encodes them into JPEG on
+  // |encoder_pool_|, keeping them in memory if |in_memory| or writing them to
+  // files otherwise. Neither the preview nor any camerabin mode is switched,
+  // and several bursts may be in flight. |on_notify_captured| is called on an
+  // encoder thread once all the pictures are done.
+  bool TakePictureBurst(int32_t count, bool in_memory,
+                        OnNotifyBurstCaptured on_notify_captured);
+  // Captures the latest preview frame on |pool|, as |request| asks, without
+  // switching any camerabin mode. Returns false without calling |callback|
+  // if there's no frame yet or the pool is busy.
+  bool CaptureFrame(FrameCapturePool& pool,
+                    const FrameCapturePool::Request& request,
+                    FrameCapturePool::Callback callback);
+
+  // Records the preview frames into a new "recorded_%04u.mp4" file, in a
+  // branch of the direct pipeline. camerabin isn't supported.
+  bool StartVideoRecording(VideoRecorder::Codec codec);
+  // Returns the path of the recording, or an empty string on failure.
+  std::string StopVideoRecording();
+
+#ifdef USE_RTSP_SERVER
+  // Serves the preview frames over RTSP, from a branch of the direct
+  // pipeline. camerabin isn't supported.
+  bool StartStreamServer(const RtspStreamServer::Options& options);
+  void StopStreamServer();
+  // Returns the URL of the stream, or an empty string if it isn't served.
+  std::string GetStreamServerUrl() const;
+#endif  // USE_RTSP_SERVER
 
   bool SetZoomLevel(float zoom);
   float GetMaxZoomLevel() const { return max_zoom_level_; };
   float GetMinZoomLevel() const { return min_zoom_level_; };
 
-  const uint8_t* GetPreviewFrameBuffer();
+  // Copies the latest preview frame into a pixel buffer, and gets its size.
+  // Called from the raster thread.
+  const uint8_t* GetPreviewFrameBuffer(int32_t& width, int32_t& height);
   int32_t GetPreviewWidth() const { return width_; };
   int32_t GetPreviewHeight() const { return height_; };
+  const std::string& GetDevicePath() const { return device_path_; }
+  // The native mode the camera is read in, or an invalid one with camerabin.
+  const CameraMode& GetCameraMode() const { return mode_; }
+  // Gets the size and frame rate the preview has negotiated, which are
+  // usually known once Play() has returned. Returns false if they aren't
+  // known yet.
+  bool GetNegotiatedPreview(int32_t& width, int32_t& height, double& fps);
+  // Hands the frames to |worker| on the streaming thread, or to nothing if
+  // nullptr. |worker| must outlive the next call.
+  void SetImageStreamWorker(ImageStreamWorker* worker);
+  // The metadata of the latest preview frame.
+  FrameMetadata GetPreviewFrameMetadata();
+  // The latencies of the preview, and of the image stream once it records
+  // them in it.
+  FrameStats& GetFrameStats() { return frame_stats_; }
+  // The counters of the camera listed on the stats channel once they have
+  // an id.
+  PluginStats& GetStats() { return stats_; }
+
+#ifdef USE_EGL_IMAGE_DMABUF
+  // Returns the EGLImage of the latest preview frame, imported from its
+  // DMABUF without a copy, or nullptr if there's none or the frame isn't in
+  // DMABUF memory. Called from the raster thread.
+  void* GetEGLImage(void* egl_display, void* egl_context);
+#endif  // USE_EGL_IMAGE_DMABUF
 
  private:
+  struct Burst {
+    int32_t count = 0;
+    bool in_memory = false;
+    OnNotifyBurstCaptured on_notify_captured;
+    // The frames still to be taken, guarded by |mutex_burst_|.
+    int32_t frames_to_take = 0;
+    // Guarded by |mutex|.
+    std::mutex mutex;
+    std::vector<CapturedPicture> pictures;
+    int32_t done_count = 0;
+  };
+
   struct GstCameraElements {
     GstElement* pipeline;
     GstElement* camerabin;
+    // The elements of the direct pipeline, unused with camerabin.
+    GstElement* source;
+    GstElement* tee;
+    GstElement* capture_valve;
+    GstElement* capture_sink;
     GstElement* video_convert;
     GstElement* video_sink;
     GstElement* output;
@@ -52,26 +173,131 @@ class GstCamera {
 
   static void HandoffHandler(GstElement* fakesink, GstBuffer* buf,
                              GstPad* new_pad, gpointer user_data);
+  static void CaptureHandoffHandler(GstElement* fakesink, GstBuffer* buf,
+                                    GstPad* new_pad, gpointer user_data);
+  // Numbers the frames as they leave v4l2src, before the queues and
+  // videorate drop any.
+  static GstPadProbeReturn SourceProbe(GstPad* pad, GstPadProbeInfo* info,
+                                       gpointer user_data);
+  // Takes the size of the preview from the caps event, rather than from the
+  // caps of every frame.
+  static GstPadProbeReturn OnVideoSinkEvent(GstPad* pad,
+                                            GstPadProbeInfo* info,
+                                            gpointer user_data);
   static GstBusSyncReply HandleGstMessage(GstBus* bus, GstMessage* message,
                                    gpointer user_data);
 
+  // Returns a new "captured_%04u.jpg" path, unique across the cameras.
+  static std::string GetNextCaptureFilename();
+
+  // Returns the metadata SourceProbe() noted for |buffer|, or what the
+  // preview frame itself tells with camerabin.
+  FrameMetadata TakeFrameMetadata(GstBuffer* buffer);
+  // Hands |buffer| to the bursts in flight, on the streaming thread.
+  void TakeBurstFrame(GstBuffer* buffer, int32_t width, int32_t height);
+  // Completes the bursts in flight with the frames not taken yet as failures.
+  void FailPendingBursts();
   bool CreatePipeline();
+  bool CreateOutput();
+  bool CreateCamerabinPipeline();
+  bool CreateDirectPipeline(const CameraMode& mode);
+  bool SetCameraSource();
+  void SetViewfinderCaps();
   void DestroyPipeline();
   void Preroll();
   void GetZoomMaxMinSize(float& max, float& min);
+#ifdef USE_EGL_IMAGE_DMABUF
+  bool EnsureGLContext(void* egl_display, void* egl_context);
+  void ClearEGLImageCache();
+  void UnrefEGLImage();
+#endif  // USE_EGL_IMAGE_DMABUF
 
   GstCameraElements gst_;
-  std::unique_ptr<uint32_t> pixels_;
-  int32_t width_ = -1;
-  int32_t height_ = -1;
+  // Used by the raster thread only.
+  FrameBufferPool::Buffer pixels_;
+  // The size of the latest caps of the preview, set on the streaming thread.
+  std::atomic<int32_t> width_ = -1;
+  std::atomic<int32_t> height_ = -1;
+  // The size of |gst_.buffer|, guarded by |mutex_buffer_|.
+  int32_t buffer_width_ = 0;
+  int32_t buffer_height_ = 0;
   std::shared_mutex mutex_buffer_;
   std::unique_ptr<CameraStreamHandler> stream_handler_ = nullptr;
+#ifdef USE_TRACE_EVENTS
+  // The track of the trace events of the camera, numbered in the order the
+  // cameras are created.
+  static std::string CreateTraceTrack();
+  const std::string trace_track_ = CreateTraceTrack();
+#endif  // USE_TRACE_EVENTS
   float max_zoom_level_;
   float min_zoom_level_;
   float zoom_level_ = 1.0f;
-  int captured_count_ = 0;
+  // Shared by the cameras, so that their pictures don't overwrite each
+  // other.
+  static std::atomic<int> captured_count_;
+  static std::atomic<int> recorded_count_;
+  const std::string device_path_;
+  const PreviewConfig preview_config_;
+  CameraMode mode_;
 
   OnNotifyCaptured on_notify_captured_ = nullptr;
+  // Guards the picture being taken by the direct pipeline.
+  std::mutex mutex_capture_;
+  bool is_capturing_ = false;
+  std::string capture_filename_;
+  // Called from the platform thread only.
+  std::unique_ptr<VideoRecorder> recorder_;
+#ifdef USE_RTSP_SERVER
+  // Called from the platform thread only.
+  std::unique_ptr<RtspStreamServer> stream_server_;
+#endif  // USE_RTSP_SERVER
+  // Created by the first burst, and outlives the pipeline.
+  std::unique_ptr<JpegEncoderPool> encoder_pool_;
+  std::mutex mutex_burst_;
+  std::vector<std::shared_ptr<Burst>> bursts_;
+  std::mutex mutex_image_stream_;
+  ImageStreamWorker* image_stream_worker_ = nullptr;
+
+  FrameStats frame_stats_;
+  PluginStats stats_{"camera"};
+  // The metadata of |gst_.buffer|, guarded by |mutex_buffer_|.
+  FrameMetadata buffer_metadata_;
+  // The frame the texture callback last recorded, used by the raster thread
+  // only.
+  uint64_t textured_frame_number_ = UINT64_MAX;
+  // The frames noted by SourceProbe() by their PTS, guarded by
+  // |mutex_frame_metadata_|.
+  std::mutex mutex_frame_metadata_;
+  std::deque<std::pair<GstClockTime, FrameMetadata>> source_metadata_;
+  // Used by the thread of the source, or of the preview with camerabin.
+  bool has_frame_number_ = false;
+  uint64_t last_sequence_ = 0;
+  // Used by the streaming thread of the preview only.
+  uint64_t skipped_frames_ = 0;
+  FrameMetadata last_metadata_;
+
+#ifdef USE_EGL_IMAGE_DMABUF
+  // The latest caps of the preview, used by the streaming thread only.
+  GstCaps* caps_ = NULL;
+  // The caps of |gst_.buffer|, guarded by |mutex_buffer_|.
+  GstCaps* buffer_caps_ = NULL;
+  // The frame Flutter is drawing, kept referenced until the next one so that
+  // v4l2src doesn't capture into it meanwhile.
+  GstBuffer* rendered_buffer_ = NULL;
+  GstVideoInfo gst_video_info_;
+  // The wrapped display and context are created once per Flutter
+  // (egl_display, egl_context) pair.
+  void* egl_display_ = nullptr;
+  void* egl_context_ = nullptr;
+  GstGLContext* gst_gl_ctx_ = NULL;
+  GstGLDisplayEGL* gst_gl_display_egl_ = NULL;
+  // EGLImages keyed by (memory, dmabuf fd, offset). v4l2src and the
+  // converters recycle a fixed set of buffers, so the cache stops growing
+  // once every buffer has been seen. It is flushed when the caps change.
+  std::map<std::tuple<GstMemory*, gint, gsize>, GstEGLImage*> egl_images_;
+  GstCaps* egl_image_caps_ = NULL;
+  bool warned_non_dmabuf_ = false;
+#endif  // USE_EGL_IMAGE_DMABUF
 };
 
 #endif  // PACKAGES_CAMERA_CAMERA_ELINUX_GST_CAMERA_H_
@@ -0,0 +1,168 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gst_runtime.h"
+
+#include <iostream>
+#include <mutex>
+#include <utility>
+
+namespace {
+// Renamed whenever SharedState or Task changes.
+constexpr char kStateQuark[] = "elinux-gst-runtime-1";
+constexpr gint kMaxPoolThreads = 4;
+
+struct Task {
+  void (*run)(void* data);
+  void* data;
+};
+
+// Guarded by the object lock of the default registry.
+struct SharedState {
+  gint refcount;
+  GMainContext* context;
+  GMainLoop* loop;
+  GThread* thread;
+  GThreadPool* pool;
+};
+
+GQuark GetStateQuark() { return g_quark_from_static_string(kStateQuark); }
+
+gpointer RunMainLoop(gpointer data) {
+  auto* state = static_cast<SharedState*>(data);
+  g_main_context_push_thread_default(state->context);
+  g_main_loop_run(state->loop);
+  g_main_context_pop_thread_default(state->context);
+  return nullptr;
+}
+
+void RunPoolTask(gpointer data, gpointer) {
+  auto* task = static_cast<Task*>(data);
+  task->run(task->data);
+  g_free(task);
+}
+
+SharedState* CreateState() {
+  auto* state = g_new0(SharedState, 1);
+  state->context = g_main_context_new();
+  state->loop = g_main_loop_new(state->context, FALSE);
+  state->thread = g_thread_new("gst-runtime", RunMainLoop, state);
+  state->pool =
+      g_thread_pool_new(RunPoolTask, nullptr, kMaxPoolThreads, FALSE, nullptr);
+  return state;
+}
+
+void DestroyState(SharedState* state) {
+  // Runs the queued tasks first, since they may still use GStreamer.
+  g_thread_pool_free(state->pool, FALSE, TRUE);
+
+  // Quits from the loop itself, in case it hasn't started running yet.
+  auto* source = g_idle_source_new();
+  g_source_set_callback(
+      source,
+      [](gpointer loop) -> gboolean {
+        g_main_loop_quit(reinterpret_cast<GMainLoop*>(loop));
+        return FALSE;
+      },
+      state->loop, nullptr);
+  g_source_attach(source, state->context);
+  g_source_unref(source);
+  g_thread_join(state->thread);
+
+  g_main_loop_unref(state->loop);
+  g_main_context_unref(state->context);
+  g_free(state);
+}
+
+SharedState* GetState() {
+  auto* registry = gst_registry_get();
+  GST_OBJECT_LOCK(registry);
+  auto* state = static_cast<SharedState*>(
+      g_object_get_qdata(G_OBJECT(registry), GetStateQuark()));
+  GST_OBJECT_UNLOCK(registry);
+  return state;
+}
+}  // namespace
+
+// static
+void GstRuntime::StartInit() {
+  static std::once_flag once;
+  // gst_init() is serialized and runs once, so Acquire() waits for this
+  // thread if it is still running, and the threads the other copies of this
+  // file start return at once. Its errors are reported by Acquire().
+  std::call_once(once, []() {
+    g_thread_unref(g_thread_new(
+        "gst-init",
+        [](gpointer) -> gpointer {
+          gst_init_check(nullptr, nullptr, nullptr);
+          return nullptr;
+        },
+        nullptr));
+  });
+}
+
+// static
+bool GstRuntime::Acquire() {
+  GError* error = nullptr;
+  if (!gst_init_check(nullptr, nullptr, &error)) {
+    std::cerr << "Failed to initialize GStreamer: "
+              << (error ? error->message : "unknown error") << std::endl;
+    g_clear_error(&error);
+    return false;
+  }
+
+  auto* registry = gst_registry_get();
+  GST_OBJECT_LOCK(registry);
+  auto* state = static_cast<SharedState*>(
+      g_object_get_qdata(G_OBJECT(registry), GetStateQuark()));
+  if (!state) {
+    state = CreateState();
+    g_object_set_qdata(G_OBJECT(registry), GetStateQuark(), state);
+  }
+  state->refcount++;
+  GST_OBJECT_UNLOCK(registry);
+  return true;
+}
+
+// static
+void GstRuntime::Release() {
+  auto* registry = gst_registry_get();
+  GST_OBJECT_LOCK(registry);
+  auto* state = static_cast<SharedState*>(
+      g_object_get_qdata(G_OBJECT(registry), GetStateQuark()));
+  const bool is_last = state && --state->refcount == 0;
+  if (is_last) {
+    g_object_set_qdata(G_OBJECT(registry), GetStateQuark(), nullptr);
+  }
+  GST_OBJECT_UNLOCK(registry);
+
+  // Outside of the lock, since the tasks and the handlers being waited for
+  // may look up the registry.
+  if (is_last) {
+    DestroyState(state);
+    gst_deinit();
+  }
+}
+
+// static
+GMainContext* GstRuntime::GetMainContext() { return GetState()->context; }
+
+// static
+void GstRuntime::RunTask(std::function<void()> task) {
+  auto* pool_task = g_new(Task, 1);
+  pool_task->run = [](void* data) {
+    auto* function = static_cast<std::function<void()>*>(data);
+    (*function)();
+    delete function;
+  };
+  pool_task->data = new std::function<void()>(std::move(task));
+
+  GError* error = nullptr;
+  // The task is queued even if no thread could be started for it.
+  if (!g_thread_pool_push(GetState()->pool, pool_task, &error)) {
+    std::cerr << "Failed to start a task thread: " << error->message
+              << std::endl;
+    g_clear_error(&error);
+  }
+}
@@ -0,0 +1,73 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "image_ring.h"
+
+#include <sys/mman.h>
+
+#include <iostream>
+
+namespace {
+constexpr int32_t kSlotCount = 4;
+constexpr size_t kPageSize = 4096;
+
+size_t RoundUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+}  // namespace
+
+ImageRing::~ImageRing() {
+  for (const auto& region : regions_) {
+    munmap(region.base, region.size);
+  }
+}
+
+bool ImageRing::Acquire(size_t size, Slot& slot) {
+  if (size == 0 || (size > slot_size_ && !Allocate(size))) {
+    return false;
+  }
+  for (int32_t i = 0; i < kSlotCount; i++) {
+    const auto candidate = (next_slot_ + i) % kSlotCount;
+    if (GetState(candidate)->load(std::memory_order_acquire) == kFree) {
+      slot.index = candidate;
+      slot.data = regions_.back().base + kPageSize + candidate * slot_size_;
+      slot.state = reinterpret_cast<uint32_t*>(GetState(candidate));
+      return true;
+    }
+  }
+  return false;
+}
+
+void ImageRing::Publish(const Slot& slot) {
+  GetState(slot.index)->store(kInUse, std::memory_order_release);
+  next_slot_ = (slot.index + 1) % kSlotCount;
+}
+
+void ImageRing::Release(const Slot& slot) {
+  GetState(slot.index)->store(kFree, std::memory_order_release);
+}
+
+bool ImageRing::Allocate(size_t slot_size) {
+  slot_size = RoundUp(slot_size, kPageSize);
+  // The first page holds the state words.
+  const auto size = kPageSize + slot_size * kSlotCount;
+  auto* base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) {
+    std::cerr << "Failed to map an image ring of " << size << " bytes"
+              << std::endl;
+    return false;
+  }
+  // Anonymous pages are zeroed, so that all the slots start free.
+  regions_.push_back({static_cast<uint8_t*>(base), size});
+  slot_size_ = slot_size;
+  next_slot_ = 0;
+  return true;
+}
+
+std::atomic<uint32_t>* ImageRing::GetState(int32_t slot) const {
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "The state words are shared with Dart");
+  return reinterpret_cast<std::atomic<uint32_t>*>(regions_.back().base) + slot;
+}
@@ -0,0 +1,69 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_IMAGE_RING_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_IMAGE_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A ring of reusable frame slots in memory shared with the Dart isolate, so
+// that the image stream can hand a frame to Dart with dart:ffi instead of
+// copying it into an EncodableValue.
+//
+// The first page of a ring holds a state word per slot. A slot is owned by
+// Dart from Publish() until Dart clears its state word, and Acquire() fails
+// while every slot is held, so a slow consumer drops frames instead of
+// queueing them.
+class ImageRing {
+ public:
+  // The state word of a slot.
+  enum SlotState : uint32_t {
+    kFree = 0,
+    // Set before the frame is sent, cleared by the consumer.
+    kInUse = 1,
+  };
+
+  struct Slot {
+    int32_t index;
+    uint8_t* data;
+    uint32_t* state;
+  };
+
+  ImageRing() = default;
+  // Unmaps the slots, which Dart must no longer read.
+  ~ImageRing();
+
+  // Prevent copying.
+  ImageRing(ImageRing const&) = delete;
+  ImageRing& operator=(ImageRing const&) = delete;
+
+  // Finds a free slot of at least |size| bytes. Returns false if every slot
+  // is held or the memory can't be mapped.
+  bool Acquire(size_t size, Slot& slot);
+  // Hands |slot| over to Dart.
+  void Publish(const Slot& slot);
+  // Takes back a published slot that never reached Dart.
+  void Release(const Slot& slot);
+
+ private:
+  struct Region {
+    uint8_t* base;
+    size_t size;
+  };
+
+  // Maps a new ring with slots of |slot_size| bytes. The previous one is
+  // kept mapped until destruction, since Dart may still read its slots.
+  bool Allocate(size_t slot_size);
+  std::atomic<uint32_t>* GetState(int32_t slot) const;
+
+  int32_t next_slot_ = 0;
+  // The current ring is the last one.
+  std::vector<Region> regions_;
+  size_t slot_size_ = 0;
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_IMAGE_RING_H_
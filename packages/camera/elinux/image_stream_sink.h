@@ -0,0 +1,76 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_IMAGE_STREAM_SINK_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_IMAGE_STREAM_SINK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "frame_stats.h"
+
+// Where ImageStreamWorker sends the frames of the image stream, i.e.
+// EventChannelImageStream in the plugin, so that the worker doesn't depend
+// on Flutter.
+class ImageStreamSink {
+ public:
+  // See: [getFormat()] in
+  // https://developer.android.com/reference/android/media/Image
+  static constexpr int32_t kImageFormatRGBA8888 = 4;
+  static constexpr int32_t kImageFormatNV21 = 17;
+  static constexpr int32_t kImageFormatYUV420888 = 35;
+
+  struct Plane {
+    std::vector<uint8_t> bytes;
+    int32_t bytes_per_row;
+    int32_t bytes_per_pixel;
+    int32_t width;
+    int32_t height;
+  };
+
+  // A frame in a slot of ImageRing, which Dart reads with dart:ffi. Only
+  // the addresses and the layout are sent.
+  struct SharedFrame {
+    struct Plane {
+      const uint8_t* data;
+      size_t size;
+      int32_t bytes_per_row;
+      int32_t bytes_per_pixel;
+      int32_t width;
+      int32_t height;
+    };
+
+    int32_t width;
+    int32_t height;
+    int32_t format;
+    int32_t slot;
+    uint64_t sequence;
+    // The presentation timestamp in microseconds, or -1 if unknown.
+    int64_t timestamp_us;
+    // The state word Dart clears to release the slot.
+    uint32_t* state;
+    // The frames dropped so far.
+    uint64_t dropped_frames;
+    FrameMetadata metadata;
+    std::vector<Plane> planes;
+  };
+
+  ImageStreamSink() = default;
+  virtual ~ImageStreamSink() = default;
+
+  // Prevent copying.
+  ImageStreamSink(ImageStreamSink const&) = delete;
+  ImageStreamSink& operator=(ImageStreamSink const&) = delete;
+
+  // Sends a frame if Dart listens. May be called from any thread.
+  virtual void Send(int32_t width, int32_t height, int32_t format,
+                    std::vector<Plane>&& planes,
+                    const FrameMetadata& metadata) = 0;
+  // Returns false if Dart doesn't listen, in which case nobody will release
+  // the slot of |frame|.
+  virtual bool SendSharedFrame(const SharedFrame& frame) = 0;
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_IMAGE_STREAM_SINK_H_
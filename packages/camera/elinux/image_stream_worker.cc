@@ -0,0 +1,333 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "image_stream_worker.h"
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "plugin_log.h"
+
+namespace {
+constexpr int32_t kRgbaBytesPerPixel = 4;
+
+// BT.601 limited range, as the camera plugins of the other platforms.
+inline uint8_t ToY(const uint8_t* rgba) {
+  return static_cast<uint8_t>(
+      ((66 * rgba[0] + 129 * rgba[1] + 25 * rgba[2] + 128) >> 8) + 16);
+}
+
+inline uint8_t ToU(const uint8_t* rgba) {
+  return static_cast<uint8_t>(
+      ((-38 * rgba[0] - 74 * rgba[1] + 112 * rgba[2] + 128) >> 8) + 128);
+}
+
+inline uint8_t ToV(const uint8_t* rgba) {
+  return static_cast<uint8_t>(
+      ((112 * rgba[0] - 94 * rgba[1] - 18 * rgba[2] + 128) >> 8) + 128);
+}
+
+struct PlaneLayout {
+  size_t offset;
+  int32_t bytes_per_row;
+  int32_t bytes_per_pixel;
+  int32_t width;
+  int32_t height;
+
+  size_t GetSize() const { return static_cast<size_t>(bytes_per_row) * height; }
+};
+
+// Lays out the planes of a frame of |format| contiguously, and returns their
+// total size.
+size_t GetLayout(ImageStreamWorker::Format format, int32_t width,
+                 int32_t height, std::vector<PlaneLayout>& layouts) {
+  const auto add = [&layouts](int32_t width, int32_t height,
+                              int32_t bytes_per_pixel) {
+    const auto offset =
+        layouts.empty() ? 0 : layouts.back().offset + layouts.back().GetSize();
+    layouts.push_back(
+        {offset, width * bytes_per_pixel, bytes_per_pixel, width, height});
+  };
+  switch (format) {
+    case ImageStreamWorker::Format::kRgba:
+      add(width, height, kRgbaBytesPerPixel);
+      break;
+    case ImageStreamWorker::Format::kYuv420:
+      add(width, height, 1);
+      add(width / 2, height / 2, 1);
+      add(width / 2, height / 2, 1);
+      break;
+    case ImageStreamWorker::Format::kNv21:
+      add(width, height, 1);
+      add(width / 2, height / 2, 2);
+      break;
+  }
+  return layouts.back().offset + layouts.back().GetSize();
+}
+
+int32_t GetImageFormat(ImageStreamWorker::Format format) {
+  switch (format) {
+    case ImageStreamWorker::Format::kYuv420:
+      return ImageStreamSink::kImageFormatYUV420888;
+    case ImageStreamWorker::Format::kNv21:
+      return ImageStreamSink::kImageFormatNV21;
+    default:
+      return ImageStreamSink::kImageFormatRGBA8888;
+  }
+}
+
+// Point sampling by an integral factor costs no more than the copy.
+void ScaleRgba(const uint8_t* source, int32_t source_stride, int32_t factor,
+               const PlaneLayout& layout, uint8_t* data) {
+  for (int32_t y = 0; y < layout.height; y++) {
+    const auto* source_row = source + y * factor * source_stride;
+    auto* row = data + y * layout.bytes_per_row;
+    if (factor == 1) {
+      std::memcpy(row, source_row, layout.bytes_per_row);
+      continue;
+    }
+    for (int32_t x = 0; x < layout.width; x++) {
+      std::memcpy(row + x * kRgbaBytesPerPixel,
+                  source_row + x * factor * kRgbaBytesPerPixel,
+                  kRgbaBytesPerPixel);
+    }
+  }
+}
+
+// Writes the luma to |y_data|, and the chroma sampled at the top left pixel
+// of each 2x2 block to |u_data| and |v_data|, which may interleave in one
+// plane of |chroma|.
+void ConvertToYuv(const uint8_t* source, int32_t source_stride, int32_t factor,
+                  const PlaneLayout& luma, uint8_t* y_data,
+                  const PlaneLayout& chroma, uint8_t* u_data,
+                  uint8_t* v_data) {
+  const auto pixel_step = factor * kRgbaBytesPerPixel;
+  for (int32_t y = 0; y < luma.height; y++) {
+    const auto* source_row = source + y * factor * source_stride;
+    auto* y_row = y_data + y * luma.bytes_per_row;
+    for (int32_t x = 0; x < luma.width; x++) {
+      y_row[x] = ToY(source_row + x * pixel_step);
+    }
+    if (y % 2) {
+      continue;
+    }
+    auto* u_row = u_data + (y / 2) * chroma.bytes_per_row;
+    auto* v_row = v_data + (y / 2) * chroma.bytes_per_row;
+    for (int32_t x = 0; x < chroma.width; x++) {
+      const auto* pixel = source_row + 2 * x * pixel_step;
+      u_row[x * chroma.bytes_per_pixel] = ToU(pixel);
+      v_row[x * chroma.bytes_per_pixel] = ToV(pixel);
+    }
+  }
+}
+
+// Converts into the planes |data| laid out as |layouts|.
+void Convert(ImageStreamWorker::Format format, const uint8_t* source,
+             int32_t source_stride, int32_t factor,
+             const std::vector<PlaneLayout>& layouts,
+             const std::vector<uint8_t*>& data) {
+  switch (format) {
+    case ImageStreamWorker::Format::kRgba:
+      ScaleRgba(source, source_stride, factor, layouts[0], data[0]);
+      break;
+    case ImageStreamWorker::Format::kYuv420:
+      ConvertToYuv(source, source_stride, factor, layouts[0], data[0],
+                   layouts[1], data[1], data[2]);
+      break;
+    case ImageStreamWorker::Format::kNv21:
+      ConvertToYuv(source, source_stride, factor, layouts[0], data[0],
+                   layouts[1], data[1] + 1, data[1]);
+      break;
+  }
+}
+}  // namespace
+
+ImageStreamWorker::ImageStreamWorker(const Options& options,
+                                     ImageStreamSink* sink,
+                                     FrameStats* stats)
+    : options_(options), sink_(sink), stats_(stats) {
+  thread_ = std::thread([this]() { Run(); });
+}
+
+ImageStreamWorker::~ImageStreamWorker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+  if (pending_buffer_) {
+    gst_buffer_unref(pending_buffer_);
+    pending_buffer_ = nullptr;
+  }
+}
+
+void ImageStreamWorker::Push(GstBuffer* buffer, int32_t width,
+                             int32_t height, const FrameMetadata& metadata) {
+  const auto now_us = g_get_monotonic_time();
+  int64_t interval_us = 0;
+  if (options_.max_fps > 0) {
+    interval_us = G_USEC_PER_SEC / options_.max_fps;
+    // Tolerates the jitter of the capture, which would otherwise skip a
+    // frame that arrives just before it's due.
+    if (now_us < next_frame_us_ - interval_us / 4) {
+      dropped_frames_++;
+      return;
+    }
+  }
+  if (is_busy_.exchange(true)) {
+    dropped_frames_++;
+    return;
+  }
+  if (interval_us > 0) {
+    next_frame_us_ += interval_us;
+    if (next_frame_us_ < now_us) {
+      next_frame_us_ = now_us + interval_us;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_buffer_ = gst_buffer_ref(buffer);
+    pending_width_ = width;
+    pending_height_ = height;
+    pending_metadata_ = metadata;
+  }
+  cv_.notify_one();
+}
+
+void ImageStreamWorker::Run() {
+  while (true) {
+    GstBuffer* buffer = nullptr;
+    int32_t width = 0;
+    int32_t height = 0;
+    FrameMetadata metadata;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return pending_buffer_ || is_stopping_; });
+      if (is_stopping_) {
+        break;
+      }
+      std::swap(buffer, pending_buffer_);
+      width = pending_width_;
+      height = pending_height_;
+      metadata = pending_metadata_;
+    }
+    Send(buffer, width, height, metadata);
+    gst_buffer_unref(buffer);
+    is_busy_ = false;
+  }
+}
+
+void ImageStreamWorker::Send(GstBuffer* buffer, int32_t width,
+                             int32_t height, const FrameMetadata& metadata) {
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    PLUGIN_LOG(Error, "frame") << "Failed to map a frame of the image stream";
+    return;
+  }
+  const int32_t source_stride = width * kRgbaBytesPerPixel;
+  if (width <= 0 || height <= 0 ||
+      map.size < static_cast<size_t>(source_stride) * height) {
+    gst_buffer_unmap(buffer, &map);
+    return;
+  }
+
+  int32_t factor = 1;
+  if (options_.max_width > 0 && width > options_.max_width) {
+    factor = (width + options_.max_width - 1) / options_.max_width;
+  }
+  int32_t output_width = width / factor;
+  int32_t output_height = height / factor;
+  if (options_.format != Format::kRgba) {
+    // The chroma is subsampled by 2 in both directions.
+    output_width &= ~1;
+    output_height &= ~1;
+  }
+
+  bool is_sent;
+  if (options_.transport == Transport::kSharedMemory) {
+    const auto timestamp_us =
+        GST_CLOCK_TIME_IS_VALID(GST_BUFFER_PTS(buffer))
+            ? static_cast<int64_t>(GST_TIME_AS_USECONDS(GST_BUFFER_PTS(buffer)))
+            : -1;
+    is_sent = SendShared(map.data, source_stride, factor, output_width,
+                         output_height, timestamp_us, metadata);
+  } else {
+    is_sent = SendCopy(map.data, source_stride, factor, output_width,
+                       output_height, metadata);
+  }
+  gst_buffer_unmap(buffer, &map);
+  if (!is_sent) {
+    dropped_frames_++;
+    return;
+  }
+  stats_->RecordSince(FrameStats::kCaptureToDart, metadata.capture_time_us);
+}
+
+bool ImageStreamWorker::SendCopy(const uint8_t* source, int32_t source_stride,
+                                 int32_t factor, int32_t width, int32_t height,
+                                 const FrameMetadata& metadata) {
+  std::vector<PlaneLayout> layouts;
+  GetLayout(options_.format, width, height, layouts);
+  std::vector<ImageStreamSink::Plane> planes;
+  std::vector<uint8_t*> data;
+  planes.reserve(layouts.size());
+  for (const auto& layout : layouts) {
+    ImageStreamSink::Plane plane;
+    plane.bytes.resize(layout.GetSize());
+    plane.bytes_per_row = layout.bytes_per_row;
+    plane.bytes_per_pixel = layout.bytes_per_pixel;
+    plane.width = layout.width;
+    plane.height = layout.height;
+    planes.push_back(std::move(plane));
+    data.push_back(planes.back().bytes.data());
+  }
+  Convert(options_.format, source, source_stride, factor, layouts, data);
+  sink_->Send(width, height, GetImageFormat(options_.format),
+                 std::move(planes), metadata);
+  return true;
+}
+
+bool ImageStreamWorker::SendShared(const uint8_t* source,
+                                   int32_t source_stride, int32_t factor,
+                                   int32_t width, int32_t height,
+                                   int64_t timestamp_us,
+                                   const FrameMetadata& metadata) {
+  std::vector<PlaneLayout> layouts;
+  const auto size = GetLayout(options_.format, width, height, layouts);
+  ImageRing::Slot slot;
+  if (!ring_.Acquire(size, slot)) {
+    return false;
+  }
+  std::vector<uint8_t*> data;
+  for (const auto& layout : layouts) {
+    data.push_back(slot.data + layout.offset);
+  }
+  Convert(options_.format, source, source_stride, factor, layouts, data);
+
+  ImageStreamSink::SharedFrame frame;
+  frame.width = width;
+  frame.height = height;
+  frame.format = GetImageFormat(options_.format);
+  frame.slot = slot.index;
+  frame.sequence = sequence_++;
+  frame.timestamp_us = timestamp_us;
+  frame.state = slot.state;
+  frame.dropped_frames = dropped_frames_;
+  frame.metadata = metadata;
+  for (size_t i = 0; i < layouts.size(); i++) {
+    const auto& layout = layouts[i];
+    frame.planes.push_back({data[i], layout.GetSize(), layout.bytes_per_row,
+                            layout.bytes_per_pixel, layout.width,
+                            layout.height});
+  }
+  ring_.Publish(slot);
+  if (!sink_->SendSharedFrame(frame)) {
+    ring_.Release(slot);
+  }
+  return true;
+}
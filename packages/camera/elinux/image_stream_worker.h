@@ -0,0 +1,113 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_IMAGE_STREAM_WORKER_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_IMAGE_STREAM_WORKER_H_
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "frame_stats.h"
+#include "image_ring.h"
+#include "image_stream_sink.h"
+
+// Converts the frames of the image stream and sends them to an
+// ImageStreamSink from a thread of its own, so that neither the
+// streaming thread of the camera nor the raster thread waits for the copy
+// and the encoding of a frame.
+//
+// It holds at most one frame: a frame that arrives while the previous one is
+// still being converted or sent is dropped, as are the frames over the
+// maximum rate. A slow consumer then lowers the rate of the stream instead of
+// queueing frames or delaying the preview.
+class ImageStreamWorker {
+ public:
+  enum class Format {
+    kRgba,
+    // Three planes, as android.graphics.ImageFormat.YUV_420_888.
+    kYuv420,
+    // The luma plane and an interleaved VU plane.
+    kNv21,
+  };
+
+  enum class Transport {
+    // The pixels are copied into the events.
+    kEventChannel,
+    // The pixels are left in an ImageRing, and the events only carry their
+    // addresses.
+    kSharedMemory,
+  };
+
+  struct Options {
+    Format format = Format::kRgba;
+    Transport transport = Transport::kEventChannel;
+    // The maximum frames per second, or zero for the rate of the camera.
+    int32_t max_fps = 0;
+    // Frames wider than this are scaled down by an integral factor. Zero
+    // keeps the size of the camera.
+    int32_t max_width = 0;
+  };
+
+  // Records the latency of the frames sent into |stats|, which must outlive
+  // the worker.
+  ImageStreamWorker(const Options& options, ImageStreamSink* sink,
+                    FrameStats* stats);
+  // Waits for the frame in flight.
+  ~ImageStreamWorker();
+
+  // Prevent copying.
+  ImageStreamWorker(ImageStreamWorker const&) = delete;
+  ImageStreamWorker& operator=(ImageStreamWorker const&) = delete;
+
+  // Hands over the RGBA frame |buffer| of |width| x |height|, or drops it.
+  // Called on the streaming thread, and doesn't wait for the conversion.
+  void Push(GstBuffer* buffer, int32_t width, int32_t height,
+            const FrameMetadata& metadata);
+
+  // The frames dropped so far by the backpressure, the rate limit or for lack
+  // of a free slot.
+  uint64_t GetDroppedFrameCount() const { return dropped_frames_; }
+
+ private:
+  void Run();
+  void Send(GstBuffer* buffer, int32_t width, int32_t height,
+            const FrameMetadata& metadata);
+  // Converts into a frame of the sink or of |ring_|. Returns false if
+  // the frame was dropped.
+  bool SendCopy(const uint8_t* source, int32_t source_stride, int32_t factor,
+                int32_t width, int32_t height, const FrameMetadata& metadata);
+  bool SendShared(const uint8_t* source, int32_t source_stride,
+                  int32_t factor, int32_t width, int32_t height,
+                  int64_t timestamp_us, const FrameMetadata& metadata);
+
+  const Options options_;
+  ImageStreamSink* const sink_;
+  FrameStats* const stats_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // The frame waiting for the thread, guarded by |mutex_|.
+  GstBuffer* pending_buffer_ = nullptr;
+  int32_t pending_width_ = 0;
+  int32_t pending_height_ = 0;
+  FrameMetadata pending_metadata_;
+  bool is_stopping_ = false;
+  // Set from Push() until the frame has been sent.
+  std::atomic<bool> is_busy_ = false;
+  std::atomic<uint64_t> dropped_frames_ = 0;
+  // The time the next frame is due at, in the monotonic clock, guarded by
+  // the streaming thread.
+  int64_t next_frame_us_ = 0;
+  // Only used by the thread.
+  ImageRing ring_;
+  uint64_t sequence_ = 0;
+  std::thread thread_;
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_IMAGE_STREAM_WORKER_H_
@@ -0,0 +1,174 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "jpeg_encoder_pool.h"
+
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+// The encoders in order of preference. The first are hardware encoders.
+constexpr const char* kJpegEncoders[] = {"v4l2jpegenc", "jpegenc"};
+
+// How long a frame may take to be encoded before the encoder is considered
+// stuck.
+constexpr GstClockTime kEncodeTimeout = 5 * GST_SECOND;
+}  // namespace
+
+JpegEncoderPool::JpegEncoderPool(size_t thread_count, size_t max_queued_frames)
+    : max_queued_frames_(max_queued_frames) {
+  for (size_t i = 0; i < thread_count; i++) {
+    threads_.emplace_back(&JpegEncoderPool::Run, this);
+  }
+}
+
+JpegEncoderPool::~JpegEncoderPool() {
+  std::deque<Task> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+    tasks.swap(tasks_);
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  for (auto& task : tasks) {
+    gst_buffer_unref(task.buffer);
+    gst_caps_unref(task.caps);
+    task.on_encoded({});
+  }
+}
+
+bool JpegEncoderPool::Encode(GstBuffer* buffer, GstCaps* caps,
+                             OnEncoded on_encoded) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_stopping_ || tasks_.size() >= max_queued_frames_) {
+      return false;
+    }
+    tasks_.push_back(
+        {gst_buffer_ref(buffer), gst_caps_ref(caps), std::move(on_encoded)});
+  }
+  cv_.notify_one();
+  return true;
+}
+
+void JpegEncoderPool::Run() {
+  Encoder encoder;
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return is_stopping_ || !tasks_.empty(); });
+      if (is_stopping_) {
+        break;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    std::vector<uint8_t> jpeg;
+    if (encoder.pipeline || CreateEncoder(encoder)) {
+      jpeg = EncodeFrame(encoder, task);
+      if (jpeg.empty()) {
+        // Starts over with a new pipeline for the next frame.
+        DestroyEncoder(encoder);
+      }
+    }
+    gst_buffer_unref(task.buffer);
+    gst_caps_unref(task.caps);
+    task.on_encoded(std::move(jpeg));
+  }
+  DestroyEncoder(encoder);
+}
+
+// static
+bool JpegEncoderPool::CreateEncoder(Encoder& encoder) {
+  encoder.pipeline = gst_pipeline_new("jpegencoder");
+  encoder.source = gst_element_factory_make("appsrc", "source");
+  auto* convert = gst_element_factory_make("videoconvert", "convert");
+  GstElement* jpegenc = nullptr;
+  for (auto const* name : kJpegEncoders) {
+    jpegenc = gst_element_factory_make(name, "encoder");
+    if (jpegenc) {
+      break;
+    }
+  }
+  encoder.sink = gst_element_factory_make("appsink", "sink");
+  if (!encoder.pipeline || !encoder.source || !convert || !jpegenc ||
+      !encoder.sink) {
+    std::cerr << "Failed to create a JPEG encoder" << std::endl;
+    for (auto* element : {encoder.source, convert, jpegenc, encoder.sink}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    if (encoder.pipeline) {
+      gst_object_unref(encoder.pipeline);
+    }
+    encoder = Encoder();
+    return false;
+  }
+
+  g_object_set(G_OBJECT(encoder.source), "format", GST_FORMAT_TIME, NULL);
+  g_object_set(G_OBJECT(encoder.sink), "sync", FALSE, NULL);
+  gst_bin_add_many(GST_BIN(encoder.pipeline), encoder.source, convert, jpegenc,
+                   encoder.sink, NULL);
+  if (!gst_element_link_many(encoder.source, convert, jpegenc, encoder.sink,
+                             NULL) ||
+      gst_element_set_state(encoder.pipeline, GST_STATE_PLAYING) ==
+          GST_STATE_CHANGE_FAILURE) {
+    std::cerr << "Failed to start a JPEG encoder" << std::endl;
+    DestroyEncoder(encoder);
+    return false;
+  }
+  return true;
+}
+
+// static
+void JpegEncoderPool::DestroyEncoder(Encoder& encoder) {
+  if (encoder.pipeline) {
+    gst_element_set_state(encoder.pipeline, GST_STATE_NULL);
+    gst_object_unref(encoder.pipeline);
+  }
+  if (encoder.caps) {
+    gst_caps_unref(encoder.caps);
+  }
+  encoder = Encoder();
+}
+
+// static
+std::vector<uint8_t> JpegEncoderPool::EncodeFrame(Encoder& encoder,
+                                                  Task& task) {
+  std::vector<uint8_t> jpeg;
+  if (!encoder.caps || !gst_caps_is_equal(encoder.caps, task.caps)) {
+    gst_app_src_set_caps(GST_APP_SRC(encoder.source), task.caps);
+    gst_caps_replace(&encoder.caps, task.caps);
+  }
+  if (gst_app_src_push_buffer(GST_APP_SRC(encoder.source),
+                              gst_buffer_ref(task.buffer)) != GST_FLOW_OK) {
+    std::cerr << "Failed to push a frame to the JPEG encoder" << std::endl;
+    return jpeg;
+  }
+
+  auto* sample =
+      gst_app_sink_try_pull_sample(GST_APP_SINK(encoder.sink), kEncodeTimeout);
+  if (!sample) {
+    std::cerr << "Failed to encode a frame into JPEG" << std::endl;
+    return jpeg;
+  }
+  auto* buffer = gst_sample_get_buffer(sample);
+  GstMapInfo map;
+  if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    jpeg.resize(map.size);
+    std::memcpy(jpeg.data(), map.data, map.size);
+    gst_buffer_unmap(buffer, &map);
+  }
+  gst_sample_unref(sample);
+  return jpeg;
+}
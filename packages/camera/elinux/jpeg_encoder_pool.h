@@ -0,0 +1,70 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_JPEG_ENCODER_POOL_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_JPEG_ENCODER_POOL_H_
+
+#include <gst/gst.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Encodes frames into JPEG on threads of its own, so that pictures are taken
+// while the previous ones are still being encoded and neither the streaming
+// thread nor the platform thread waits for them. Each thread has an encoding
+// pipeline of its own:
+// appsrc ! videoconvert ! v4l2jpegenc ! appsink
+// with jpegenc if there's no hardware encoder.
+class JpegEncoderPool {
+ public:
+  // Called on a thread of the pool with the JPEG data, empty on failure.
+  using OnEncoded = std::function<void(std::vector<uint8_t>&& jpeg)>;
+
+  JpegEncoderPool(size_t thread_count, size_t max_queued_frames);
+  // Waits for the frame being encoded by each thread. The queued frames are
+  // given to their callbacks as failures.
+  ~JpegEncoderPool();
+
+  // Prevent copying.
+  JpegEncoderPool(JpegEncoderPool const&) = delete;
+  JpegEncoderPool& operator=(JpegEncoderPool const&) = delete;
+
+  // Queues |buffer| of |caps| to be encoded, taking references to both.
+  // Returns false without calling |on_encoded| if the queue is full.
+  bool Encode(GstBuffer* buffer, GstCaps* caps, OnEncoded on_encoded);
+
+ private:
+  struct Task {
+    GstBuffer* buffer;
+    GstCaps* caps;
+    OnEncoded on_encoded;
+  };
+
+  struct Encoder {
+    GstElement* pipeline = nullptr;
+    GstElement* source = nullptr;
+    GstElement* sink = nullptr;
+    GstCaps* caps = nullptr;
+  };
+
+  void Run();
+  static bool CreateEncoder(Encoder& encoder);
+  static void DestroyEncoder(Encoder& encoder);
+  static std::vector<uint8_t> EncodeFrame(Encoder& encoder, Task& task);
+
+  const size_t max_queued_frames_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Guarded by |mutex_|.
+  std::deque<Task> tasks_;
+  bool is_stopping_ = false;
+  std::vector<std::thread> threads_;
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_JPEG_ENCODER_POOL_H_
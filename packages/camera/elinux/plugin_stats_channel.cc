@@ -0,0 +1,76 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "plugin_stats_channel.h"
+
+#include <flutter/standard_method_codec.h>
+
+#include <string>
+
+#include "plugin_stats.h"
+
+namespace {
+constexpr char kChannelName[] = "elinux/plugin_stats";
+constexpr char kMethodGetStats[] = "getStats";
+constexpr char kMethodWritePrometheus[] = "writePrometheus";
+
+constexpr char kPlugin[] = "plugin";
+constexpr char kId[] = "id";
+constexpr char kDecoder[] = "decoder";
+constexpr char kPath[] = "path";
+}  // namespace
+
+PluginStatsChannel::PluginStatsChannel(flutter::PluginRegistrar* registrar) {
+  channel_ = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+      registrar->messenger(), kChannelName,
+      &flutter::StandardMethodCodec::GetInstance());
+  channel_->SetMethodCallHandler(HandleMethodCall);
+}
+
+// static
+void PluginStatsChannel::HandleMethodCall(
+    const flutter::MethodCall<flutter::EncodableValue>& method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto& method_name = method_call.method_name();
+  if (method_name == kMethodGetStats) {
+    flutter::EncodableList list;
+    for (const auto& entry : PluginStats::Collect()) {
+      flutter::EncodableMap map = {
+          {flutter::EncodableValue(kPlugin),
+           flutter::EncodableValue(entry.plugin)},
+          {flutter::EncodableValue(kId), flutter::EncodableValue(entry.id)},
+          {flutter::EncodableValue(kDecoder),
+           flutter::EncodableValue(entry.decoder)},
+      };
+      for (int i = 0; i < PluginStats::kCounterCount; i++) {
+        map[flutter::EncodableValue(PluginStats::GetCounterKey(
+            static_cast<PluginStats::Counter>(i)))] =
+            flutter::EncodableValue(static_cast<int64_t>(entry.values[i]));
+      }
+      list.push_back(flutter::EncodableValue(map));
+    }
+    result->Success(flutter::EncodableValue(list));
+  } else if (method_name == kMethodWritePrometheus) {
+    const auto* arguments =
+        std::get_if<flutter::EncodableMap>(method_call.arguments());
+    const flutter::EncodableValue* path = nullptr;
+    if (arguments) {
+      auto iter = arguments->find(flutter::EncodableValue(kPath));
+      if (iter != arguments->end()) {
+        path = &iter->second;
+      }
+    }
+    if (!path || !std::holds_alternative<std::string>(*path)) {
+      result->Error("InvalidArguments", "writePrometheus needs a path");
+      return;
+    }
+    if (!PluginStats::WritePrometheus(std::get<std::string>(*path))) {
+      result->Error("WriteFailed", "Failed to write the stats");
+      return;
+    }
+    result->Success();
+  } else {
+    result->NotImplemented();
+  }
+}
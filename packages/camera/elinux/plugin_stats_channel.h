@@ -0,0 +1,31 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_PLUGIN_STATS_CHANNEL_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_PLUGIN_STATS_CHANNEL_H_
+
+#include <flutter/encodable_value.h>
+#include <flutter/method_channel.h>
+#include <flutter/plugin_registrar.h>
+
+#include <memory>
+
+// Answers "elinux/plugin_stats" with the PluginStats of all the plugins of
+// the process. video_player, camera and audioplayers each register it, and
+// the one registered last answers. The handler doesn't refer to the
+// PluginStatsChannel, so it keeps answering after it's destroyed.
+class PluginStatsChannel {
+ public:
+  explicit PluginStatsChannel(flutter::PluginRegistrar* registrar);
+  ~PluginStatsChannel() = default;
+
+ private:
+  static void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& method_call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_PLUGIN_STATS_CHANNEL_H_
@@ -0,0 +1,267 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "rtsp_stream_server.h"
+
+#include <gst/app/gstappsrc.h>
+
+#include <iostream>
+
+#include "tee_branch.h"
+
+namespace {
+// See VideoRecorder.
+constexpr guint kMaxQueuedFrames = 5;
+
+// About a second at usual camera rates, so that a new client starts
+// decoding soon.
+constexpr int32_t kKeyframeInterval = 30;
+
+GstRTSPFilterResult RemoveClient(GstRTSPServer* server, GstRTSPClient* client,
+                                 gpointer user_data) {
+  return GST_RTSP_FILTER_REMOVE;
+}
+}  // namespace
+
+// static
+std::unique_ptr<RtspStreamServer> RtspStreamServer::Start(
+    GstElement* pipeline, GstElement* tee, const Options& options) {
+  std::unique_ptr<RtspStreamServer> server(
+      new RtspStreamServer(pipeline, tee, options));
+  if (!server->CreateBranch() || !server->StartServer()) {
+    return nullptr;
+  }
+  return server;
+}
+
+RtspStreamServer::RtspStreamServer(GstElement* pipeline, GstElement* tee,
+                                   const Options& options)
+    : pipeline_(pipeline), tee_(tee), options_(options) {}
+
+RtspStreamServer::~RtspStreamServer() {
+  // Stops the server first, so that no media is configured afterwards.
+  if (server_) {
+    gst_rtsp_server_client_filter(server_, RemoveClient, nullptr);
+  }
+  if (source_id_) {
+    auto* source = g_main_context_find_source_by_id(context_, source_id_);
+    if (source) {
+      g_source_destroy(source);
+    }
+  }
+  if (thread_.joinable()) {
+    // Quits from the loop itself, in case it hasn't started running yet.
+    g_main_context_invoke(
+        context_,
+        [](gpointer loop) -> gboolean {
+          g_main_loop_quit(reinterpret_cast<GMainLoop*>(loop));
+          return G_SOURCE_REMOVE;
+        },
+        loop_);
+    thread_.join();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReleaseMedia();
+    if (media_caps_) {
+      gst_caps_unref(media_caps_);
+      media_caps_ = nullptr;
+    }
+  }
+  if (bin_) {
+    DetachTeeBranch(tee_, tee_pad_, bin_);
+    RemoveTeeBranch(pipeline_, bin_);
+    bin_ = nullptr;
+    valve_ = nullptr;
+  }
+
+  if (server_) {
+    gst_object_unref(server_);
+  }
+  if (loop_) {
+    g_main_loop_unref(loop_);
+  }
+  if (context_) {
+    g_main_context_unref(context_);
+  }
+}
+
+std::string RtspStreamServer::GetUrl() const {
+  return std::string("rtsp://") + g_get_host_name() + ":" +
+         std::to_string(options_.port) + options_.path;
+}
+
+bool RtspStreamServer::CreateBranch() {
+  auto* queue = gst_element_factory_make("queue", "queue");
+  valve_ = gst_element_factory_make("valve", "valve");
+  auto* convert = gst_element_factory_make("videoconvert", "convert");
+  auto* encoder = CreateVideoEncoder(options_.codec, kKeyframeInterval);
+  auto* encoder_caps = gst_element_factory_make("capsfilter", "encodercaps");
+  auto* parser = CreateVideoParser(options_.codec);
+  auto* sink = gst_element_factory_make("appsink", "sink");
+  bin_ = gst_bin_new(nullptr);
+  if (!queue || !valve_ || !convert || !encoder || !encoder_caps || !parser ||
+      !sink || !bin_) {
+    std::cerr << "Failed to create the elements of the stream server"
+              << std::endl;
+    for (auto* element :
+         {queue, valve_, convert, encoder, encoder_caps, parser, sink, bin_}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    valve_ = nullptr;
+    bin_ = nullptr;
+    return false;
+  }
+
+  g_object_set(G_OBJECT(queue), "max-size-buffers", kMaxQueuedFrames,
+               "max-size-bytes", 0, "max-size-time", 0, NULL);
+  gst_util_set_object_arg(G_OBJECT(queue), "leaky", "downstream");
+  g_object_set(G_OBJECT(valve_), "drop", TRUE, NULL);
+  auto* caps = gst_caps_from_string(GetVideoCodecCaps(options_.codec));
+  g_object_set(G_OBJECT(encoder_caps), "caps", caps, NULL);
+  gst_caps_unref(caps);
+  // Each keyframe carries the parameter sets, for the clients that join late.
+  g_object_set(G_OBJECT(parser), "config-interval", -1, NULL);
+  // Nothing reaches the sink until a client connects.
+  g_object_set(G_OBJECT(sink), "sync", FALSE, "async", FALSE, "max-buffers",
+               2, "drop", TRUE, NULL);
+  GstAppSinkCallbacks callbacks = {};
+  callbacks.new_sample = OnNewSample;
+  gst_app_sink_set_callbacks(GST_APP_SINK(sink), &callbacks, this, nullptr);
+
+  gst_bin_add_many(GST_BIN(bin_), queue, valve_, convert, encoder,
+                   encoder_caps, parser, sink, NULL);
+  if (!gst_element_link_many(queue, valve_, convert, encoder, encoder_caps,
+                             parser, sink, NULL)) {
+    std::cerr << "Failed to link the elements of the stream server"
+              << std::endl;
+    gst_object_unref(bin_);
+    valve_ = nullptr;
+    bin_ = nullptr;
+    return false;
+  }
+
+  tee_pad_ = AttachTeeBranch(pipeline_, tee_, bin_, queue);
+  if (!tee_pad_) {
+    valve_ = nullptr;
+    bin_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool RtspStreamServer::StartServer() {
+  context_ = g_main_context_new();
+  loop_ = g_main_loop_new(context_, FALSE);
+  server_ = gst_rtsp_server_new();
+  gst_rtsp_server_set_service(server_, std::to_string(options_.port).c_str());
+
+  const bool is_h265 = options_.codec == VideoCodec::kH265;
+  auto launch = std::string(
+                    "( appsrc name=source is-live=true format=time "
+                    "do-timestamp=true ! ") +
+                (is_h265 ? "rtph265pay" : "rtph264pay") +
+                " name=pay0 pt=96 config-interval=-1 )";
+  auto* factory = gst_rtsp_media_factory_new();
+  gst_rtsp_media_factory_set_launch(factory, launch.c_str());
+  gst_rtsp_media_factory_set_shared(factory, TRUE);
+  g_signal_connect(factory, "media-configure", G_CALLBACK(OnMediaConfigure),
+                   this);
+  auto* mounts = gst_rtsp_server_get_mount_points(server_);
+  gst_rtsp_mount_points_add_factory(mounts, options_.path.c_str(), factory);
+  g_object_unref(mounts);
+
+  source_id_ = gst_rtsp_server_attach(server_, context_);
+  if (!source_id_) {
+    std::cerr << "Failed to listen on port " << options_.port << std::endl;
+    return false;
+  }
+  thread_ = std::thread([this]() {
+    g_main_context_push_thread_default(context_);
+    g_main_loop_run(loop_);
+    g_main_context_pop_thread_default(context_);
+  });
+  return true;
+}
+
+// static
+GstFlowReturn RtspStreamServer::OnNewSample(GstAppSink* sink,
+                                            gpointer user_data) {
+  auto* self = reinterpret_cast<RtspStreamServer*>(user_data);
+  auto* sample = gst_app_sink_pull_sample(sink);
+  if (!sample) {
+    return GST_FLOW_OK;
+  }
+
+  std::lock_guard<std::mutex> lock(self->mutex_);
+  auto* source = self->media_source_;
+  auto* buffer = gst_sample_get_buffer(sample);
+  auto* caps = gst_sample_get_caps(sample);
+  if (source && buffer && caps) {
+    if (!self->media_caps_ || !gst_caps_is_equal(self->media_caps_, caps)) {
+      gst_app_src_set_caps(GST_APP_SRC(source), caps);
+      gst_caps_replace(&self->media_caps_, caps);
+    }
+    // The media has a clock of its own, so appsrc timestamps the frames
+    // again. The copy shares the encoded data.
+    auto* copy = gst_buffer_copy(buffer);
+    GST_BUFFER_PTS(copy) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_DTS(copy) = GST_CLOCK_TIME_NONE;
+    gst_app_src_push_buffer(GST_APP_SRC(source), copy);
+  }
+  gst_sample_unref(sample);
+  return GST_FLOW_OK;
+}
+
+// static
+void RtspStreamServer::OnMediaConfigure(GstRTSPMediaFactory* factory,
+                                        GstRTSPMedia* media,
+                                        gpointer user_data) {
+  auto* self = reinterpret_cast<RtspStreamServer*>(user_data);
+  auto* element = gst_rtsp_media_get_element(media);
+  auto* source = gst_bin_get_by_name(GST_BIN(element), "source");
+  gst_object_unref(element);
+  if (!source) {
+    std::cerr << "Failed to get the source of the stream" << std::endl;
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(self->mutex_);
+  self->ReleaseMedia();
+  self->media_ = GST_RTSP_MEDIA(g_object_ref(media));
+  self->media_source_ = source;
+  self->unprepared_handler_ = g_signal_connect(
+      media, "unprepared", G_CALLBACK(OnMediaUnprepared), self);
+  gst_caps_replace(&self->media_caps_, nullptr);
+  g_object_set(G_OBJECT(self->valve_), "drop", FALSE, NULL);
+}
+
+// static
+void RtspStreamServer::OnMediaUnprepared(GstRTSPMedia* media,
+                                         gpointer user_data) {
+  auto* self = reinterpret_cast<RtspStreamServer*>(user_data);
+  std::lock_guard<std::mutex> lock(self->mutex_);
+  if (media == self->media_) {
+    self->ReleaseMedia();
+  }
+}
+
+void RtspStreamServer::ReleaseMedia() {
+  if (valve_) {
+    g_object_set(G_OBJECT(valve_), "drop", TRUE, NULL);
+  }
+  if (media_source_) {
+    gst_object_unref(media_source_);
+    media_source_ = nullptr;
+  }
+  if (media_) {
+    g_signal_handler_disconnect(media_, unprepared_handler_);
+    g_object_unref(media_);
+    media_ = nullptr;
+    unprepared_handler_ = 0;
+  }
+}
@@ -0,0 +1,86 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_RTSP_STREAM_SERVER_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_RTSP_STREAM_SERVER_H_
+
+#include <gst/app/gstappsink.h>
+#include <gst/gst.h>
+#include <gst/rtsp-server/rtsp-server.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "video_encoder.h"
+
+// Serves the frames of a tee of a camera pipeline over RTSP. They are encoded
+// once, in a branch of the camera pipeline:
+// tee. ! queue ! valve ! videoconvert ! v4l2h264enc ! h264parse ! appsink
+// and all the clients share one media, which sends the encoded stream:
+// appsrc ! rtph264pay
+// The valve drops the frames while no client is connected, so that nothing
+// is encoded then. The server runs a main loop on a thread of its own.
+class RtspStreamServer {
+ public:
+  struct Options {
+    int32_t port = 8554;
+    std::string path = "/camera";
+    VideoCodec codec = VideoCodec::kH264;
+  };
+
+  // Starts serving |tee| of |pipeline|. Returns nullptr on failure, e.g. if
+  // the port is in use.
+  static std::unique_ptr<RtspStreamServer> Start(GstElement* pipeline,
+                                                 GstElement* tee,
+                                                 const Options& options);
+  // Disconnects the clients and removes the branch.
+  ~RtspStreamServer();
+
+  // Prevent copying.
+  RtspStreamServer(RtspStreamServer const&) = delete;
+  RtspStreamServer& operator=(RtspStreamServer const&) = delete;
+
+  // Returns e.g. "rtsp://<host name>:8554/camera".
+  std::string GetUrl() const;
+
+ private:
+  RtspStreamServer(GstElement* pipeline, GstElement* tee,
+                   const Options& options);
+
+  bool CreateBranch();
+  bool StartServer();
+
+  static GstFlowReturn OnNewSample(GstAppSink* sink, gpointer user_data);
+  static void OnMediaConfigure(GstRTSPMediaFactory* factory,
+                               GstRTSPMedia* media, gpointer user_data);
+  static void OnMediaUnprepared(GstRTSPMedia* media, gpointer user_data);
+  // Forgets |media_|. Called with |mutex_| held.
+  void ReleaseMedia();
+
+  GstElement* const pipeline_;
+  GstElement* const tee_;
+  const Options options_;
+
+  GstElement* bin_ = nullptr;
+  GstPad* tee_pad_ = nullptr;
+  GstElement* valve_ = nullptr;
+
+  GMainContext* context_ = nullptr;
+  GMainLoop* loop_ = nullptr;
+  GstRTSPServer* server_ = nullptr;
+  guint source_id_ = 0;
+  std::thread thread_;
+
+  std::mutex mutex_;
+  // The media being served and its source, guarded by |mutex_|.
+  GstRTSPMedia* media_ = nullptr;
+  gulong unprepared_handler_ = 0;
+  GstElement* media_source_ = nullptr;
+  GstCaps* media_caps_ = nullptr;
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_RTSP_STREAM_SERVER_H_
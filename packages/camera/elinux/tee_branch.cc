@@ -0,0 +1,49 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "tee_branch.h"
+
+#include <iostream>
+
+GstPad* AttachTeeBranch(GstElement* pipeline, GstElement* tee, GstElement* bin,
+                        GstElement* first) {
+  auto* first_pad = gst_element_get_static_pad(first, "sink");
+  auto* ghost_pad = gst_ghost_pad_new("sink", first_pad);
+  gst_object_unref(first_pad);
+  gst_pad_set_active(ghost_pad, TRUE);
+  gst_element_add_pad(bin, ghost_pad);
+
+  gst_bin_add(GST_BIN(pipeline), bin);
+  if (!gst_element_sync_state_with_parent(bin)) {
+    std::cerr << "Failed to start a branch of the camera pipeline"
+              << std::endl;
+    RemoveTeeBranch(pipeline, bin);
+    return nullptr;
+  }
+
+  auto* tee_pad = gst_element_request_pad_simple(tee, "src_%u");
+  if (!tee_pad || gst_pad_link(tee_pad, ghost_pad) != GST_PAD_LINK_OK) {
+    std::cerr << "Failed to link a branch of the camera pipeline" << std::endl;
+    if (tee_pad) {
+      gst_element_release_request_pad(tee, tee_pad);
+      gst_object_unref(tee_pad);
+    }
+    RemoveTeeBranch(pipeline, bin);
+    return nullptr;
+  }
+  return tee_pad;
+}
+
+void DetachTeeBranch(GstElement* tee, GstPad* tee_pad, GstElement* bin) {
+  auto* ghost_pad = gst_element_get_static_pad(bin, "sink");
+  gst_pad_unlink(tee_pad, ghost_pad);
+  gst_object_unref(ghost_pad);
+  gst_element_release_request_pad(tee, tee_pad);
+  gst_object_unref(tee_pad);
+}
+
+void RemoveTeeBranch(GstElement* pipeline, GstElement* bin) {
+  gst_element_set_state(bin, GST_STATE_NULL);
+  gst_bin_remove(GST_BIN(pipeline), bin);
+}
@@ -0,0 +1,26 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_TEE_BRANCH_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_TEE_BRANCH_H_
+
+#include <gst/gst.h>
+
+// Helpers to add branches to the tee of a running camera pipeline, and to
+// remove them again, without interrupting the other branches.
+
+// Adds |bin| to |pipeline|, with a sink pad for its |first| element, starts
+// it and links it to a new pad of |tee|. Returns the pad of |tee|, or nullptr
+// on failure, when |bin| is destroyed.
+GstPad* AttachTeeBranch(GstElement* pipeline, GstElement* tee, GstElement* bin,
+                        GstElement* first);
+
+// Unlinks |bin| from |tee| and releases |tee_pad|. The branch gets no frames
+// afterwards, but can still be drained, e.g. by an EOS sent to its sink pad.
+void DetachTeeBranch(GstElement* tee, GstPad* tee_pad, GstElement* bin);
+
+// Stops |bin| and removes it from |pipeline|, which destroys it.
+void RemoveTeeBranch(GstElement* pipeline, GstElement* bin);
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_TEE_BRANCH_H_
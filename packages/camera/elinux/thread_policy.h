@@ -0,0 +1,93 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_THREAD_POLICY_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_THREAD_POLICY_H_
+
+#include <gst/gst.h>
+#include <sched.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Pins the streaming threads of the pipelines to a set of CPUs and sets
+// their scheduling, e.g. to keep them on the big cores of a big.LITTLE SoC
+// under load.
+//
+// The threads are told apart by the element whose task they run. The tasks
+// of network sources, e.g. udpsrc, souphttpsrc or the TCP connection of
+// rtspsrc, have the network role, and all the others, which demux, decode,
+// convert and hand the frames to Flutter, have the streaming role. The
+// settings of a role are applied by the thread itself when it enters its
+// task, and undone when it leaves it, since the default task pool hands its
+// threads to other tasks afterwards. The threads a decoder creates for
+// itself inherit the settings of the thread that opens it.
+//
+// The settings are read from ELINUX_PLUGIN_THREADS, e.g.
+// "streaming:cpus=4-7:fifo=10;network:cpus=0-3:nice=-5", or set by the
+// plugin. Real-time priorities need CAP_SYS_NICE or an RLIMIT_RTPRIO, and
+// negative nice values need CAP_SYS_NICE or an RLIMIT_NICE.
+//
+// video_player and camera each have a copy of this file.
+class ThreadPolicy {
+ public:
+  enum Role {
+    kNetwork,
+    kStreaming,
+    kRoleCount,
+  };
+
+  struct Settings {
+    // The CPUs the threads may run on, or any if empty.
+    std::vector<int> cpus;
+    // The SCHED_FIFO priority from 1 to 99, or zero for SCHED_OTHER.
+    int realtime_priority = 0;
+    // The nice value of the threads with SCHED_OTHER.
+    int nice = 0;
+
+    bool IsDefault() const {
+      return cpus.empty() && realtime_priority == 0 && nice == 0;
+    }
+  };
+
+  static ThreadPolicy& GetInstance();
+
+  // Prevent copying.
+  ThreadPolicy(ThreadPolicy const&) = delete;
+  ThreadPolicy& operator=(ThreadPolicy const&) = delete;
+
+  static bool ParseRole(const std::string& name, Role& role);
+
+  // Applies to the threads that enter a task from now on. Returns false if
+  // |settings| are out of range.
+  bool Set(Role role, const Settings& settings);
+  Settings Get(Role role) const;
+
+  // Called from the sync handlers of the buses, on the thread posting the
+  // stream status.
+  void HandleStreamStatus(GstMessage* message);
+
+ private:
+  ThreadPolicy();
+  ~ThreadPolicy() = default;
+
+  static bool IsValid(const Settings& settings);
+  static Role GetRole(GstElement* owner);
+  // Applies |settings| to the calling thread.
+  void Apply(const Settings& settings, const char* role_name) const;
+  // Undoes Apply() on the calling thread.
+  void Restore() const;
+
+  mutable std::mutex mutex_;
+  Settings settings_[kRoleCount];
+  // Whether any role has settings, so that no thread pays for the lock
+  // otherwise.
+  std::atomic<bool> is_enabled_{false};
+  // The CPUs of the process when the plugin was loaded.
+  cpu_set_t default_cpus_;
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_THREAD_POLICY_H_
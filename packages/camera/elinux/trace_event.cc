@@ -0,0 +1,119 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "trace_event.h"
+
+#ifdef USE_TRACE_EVENTS
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace {
+constexpr const char* kTraceMarkerPaths[] = {
+    "/sys/kernel/tracing/trace_marker",
+    "/sys/kernel/debug/tracing/trace_marker",
+};
+// Longer events are truncated, as the kernel would.
+constexpr size_t kMaxEventSize = 256;
+
+int GetTraceMarker() {
+  // Kept open for the lifetime of the process.
+  static const int fd = []() {
+    for (const auto* path : kTraceMarkerPaths) {
+      const auto fd = open(path, O_WRONLY | O_CLOEXEC);
+      if (fd >= 0) {
+        return fd;
+      }
+    }
+    return -1;
+  }();
+  return fd;
+}
+
+int GetPid() {
+  static const int pid = getpid();
+  return pid;
+}
+
+void WriteEvent(const char* event, int length) {
+  const auto fd = GetTraceMarker();
+  if (fd < 0 || length <= 0) {
+    return;
+  }
+  const auto size = std::min(static_cast<size_t>(length), kMaxEventSize - 1);
+  // A failed write only loses the event.
+  [[maybe_unused]] const auto written = write(fd, event, size);
+}
+}  // namespace
+
+// static
+bool TraceEvent::IsEnabled() { return GetTraceMarker() >= 0; }
+
+// static
+void TraceEvent::Begin(const std::string& track, const char* name) {
+  if (!IsEnabled()) {
+    return;
+  }
+  char event[kMaxEventSize];
+  WriteEvent(event, std::snprintf(event, sizeof(event), "B|%d|%s %s",
+                                  GetPid(), track.c_str(), name));
+}
+
+// static
+void TraceEvent::End() {
+  if (!IsEnabled()) {
+    return;
+  }
+  char event[kMaxEventSize];
+  WriteEvent(event, std::snprintf(event, sizeof(event), "E|%d", GetPid()));
+}
+
+// static
+void TraceEvent::Instant(const std::string& track, const std::string& name) {
+  if (!IsEnabled()) {
+    return;
+  }
+  char event[kMaxEventSize];
+  WriteEvent(event, std::snprintf(event, sizeof(event), "N|%d|%s|%s",
+                                  GetPid(), track.c_str(), name.c_str()));
+}
+
+// static
+void TraceEvent::Counter(const std::string& track, const char* name,
+                         int64_t value) {
+  if (!IsEnabled()) {
+    return;
+  }
+  char event[kMaxEventSize];
+  WriteEvent(event,
+             std::snprintf(event, sizeof(event), "C|%d|%s %s|%" PRId64,
+                           GetPid(), track.c_str(), name, value));
+}
+
+// static
+void TraceEvent::Message(const std::string& track, GstMessage* message) {
+  if (!IsEnabled()) {
+    return;
+  }
+  if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_STATE_CHANGED) {
+    if (!GST_IS_PIPELINE(GST_MESSAGE_SRC(message))) {
+      return;
+    }
+    GstState old_state;
+    GstState new_state;
+    gst_message_parse_state_changed(message, &old_state, &new_state, nullptr);
+    Instant(track, std::string("state ") +
+                       gst_element_state_get_name(old_state) + " -> " +
+                       gst_element_state_get_name(new_state));
+    return;
+  }
+  Instant(track, std::string("bus ") + GST_MESSAGE_TYPE_NAME(message) +
+                     " from " + GST_MESSAGE_SRC_NAME(message));
+}
+
+#endif  // USE_TRACE_EVENTS
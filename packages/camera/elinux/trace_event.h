@@ -0,0 +1,75 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_TRACE_EVENT_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_TRACE_EVENT_H_
+
+// Trace points, compiled in with add_definitions(-DUSE_TRACE_EVENTS) only.
+// Otherwise the macros expand to nothing, and their arguments aren't
+// evaluated.
+//
+// The events are written to the ftrace trace_marker in the atrace format,
+// as the systrace timeline of the Flutter engine is, so a Perfetto or
+// trace-cmd capture of ftrace shows both on the same threads and clock:
+//  - TRACE_SCOPE() is a slice on the thread it runs on,
+//  - TRACE_INSTANT() an event, and TRACE_COUNTER() a value, on the track of
+//    a player,
+//  - TRACE_GST_MESSAGE() a bus message, or a state change of the pipeline,
+//    as an event on the track of a player.
+// video_player, camera and audioplayers each have a copy of this file.
+#ifdef USE_TRACE_EVENTS
+
+#include <gst/gst.h>
+
+#include <cstdint>
+#include <string>
+
+class TraceEvent {
+ public:
+  // Whether the trace_marker could be opened, e.g. not without the
+  // permission to write to tracefs.
+  static bool IsEnabled();
+
+  static void Begin(const std::string& track, const char* name);
+  static void End();
+  static void Instant(const std::string& track, const std::string& name);
+  static void Counter(const std::string& track, const char* name,
+                      int64_t value);
+  // State changes of elements other than the pipeline are skipped.
+  static void Message(const std::string& track, GstMessage* message);
+
+  TraceEvent() = delete;
+};
+
+class TraceScope {
+ public:
+  TraceScope(const std::string& track, const char* name) {
+    TraceEvent::Begin(track, name);
+  }
+  ~TraceScope() { TraceEvent::End(); }
+
+  // Prevent copying.
+  TraceScope(TraceScope const&) = delete;
+  TraceScope& operator=(TraceScope const&) = delete;
+};
+
+#define TRACE_EVENT_CONCAT_(a, b) a##b
+#define TRACE_EVENT_CONCAT(a, b) TRACE_EVENT_CONCAT_(a, b)
+#define TRACE_SCOPE(track, name) \
+  TraceScope TRACE_EVENT_CONCAT(trace_scope_, __LINE__)(track, name)
+#define TRACE_INSTANT(track, name) TraceEvent::Instant(track, name)
+#define TRACE_COUNTER(track, name, value) \
+  TraceEvent::Counter(track, name, value)
+#define TRACE_GST_MESSAGE(track, message) TraceEvent::Message(track, message)
+
+#else
+
+#define TRACE_SCOPE(track, name)
+#define TRACE_INSTANT(track, name)
+#define TRACE_COUNTER(track, name, value)
+#define TRACE_GST_MESSAGE(track, message)
+
+#endif  // USE_TRACE_EVENTS
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_TRACE_EVENT_H_
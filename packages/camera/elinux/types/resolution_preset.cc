@@ -0,0 +1,61 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "types/resolution_preset.h"
+
+ResolutionPreset DeserializeResolutionPreset(std::string str) {
+  if (!str.compare("low")) {
+    return ResolutionPreset::kLow;
+  }
+  if (!str.compare("medium")) {
+    return ResolutionPreset::kMedium;
+  }
+  if (!str.compare("high")) {
+    return ResolutionPreset::kHigh;
+  }
+  if (!str.compare("veryHigh")) {
+    return ResolutionPreset::kVeryHigh;
+  }
+  if (!str.compare("ultraHigh")) {
+    return ResolutionPreset::kUltraHigh;
+  }
+  if (!str.compare("max")) {
+    return ResolutionPreset::kMax;
+  }
+  std::cerr << str.c_str() << " is not a valid ResolutionPreset value"
+            << std::endl;
+  return ResolutionPreset::kMax;
+}
+
+void GetResolutionPresetSize(ResolutionPreset preset, int32_t& width,
+                             int32_t& height) {
+  switch (preset) {
+    case ResolutionPreset::kLow:
+      width = 320;
+      height = 240;
+      break;
+    case ResolutionPreset::kMedium:
+      width = 720;
+      height = 480;
+      break;
+    case ResolutionPreset::kHigh:
+      width = 1280;
+      height = 720;
+      break;
+    case ResolutionPreset::kVeryHigh:
+      width = 1920;
+      height = 1080;
+      break;
+    case ResolutionPreset::kUltraHigh:
+      width = 3840;
+      height = 2160;
+      break;
+    case ResolutionPreset::kMax:
+    default:
+      width = 0;
+      height = 0;
+      break;
+  }
+}
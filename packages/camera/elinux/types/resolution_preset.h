@@ -0,0 +1,30 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_TYPES_RESOLUTION_PRESET_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_TYPES_RESOLUTION_PRESET_H_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+// See:
+// flutter/plugins/packages/camera/camera_platform_interface/lib/src/types/resolution_preset.dart
+enum class ResolutionPreset {
+  kLow,
+  kMedium,
+  kHigh,
+  kVeryHigh,
+  kUltraHigh,
+  kMax,
+};
+
+ResolutionPreset DeserializeResolutionPreset(std::string str);
+
+// The preview size of |preset|, or zero for the largest size of the camera.
+void GetResolutionPresetSize(ResolutionPreset preset, int32_t& width,
+                             int32_t& height);
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_CAMERA_TYPES_RESOLUTION_PRESET_H_
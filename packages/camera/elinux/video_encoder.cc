@@ -0,0 +1,63 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "video_encoder.h"
+
+#include <string>
+
+namespace {
+constexpr const char* kH264Encoders[] = {"v4l2h264enc", "qtic2venc",
+                                         "x264enc"};
+constexpr const char* kH265Encoders[] = {"v4l2h265enc", "qtic2venc",
+                                         "x265enc"};
+
+template <size_t N>
+GstElement* CreateFirstElement(const char* const (&names)[N]) {
+  for (auto const* name : names) {
+    auto* element = gst_element_factory_make(name, "encoder");
+    if (element) {
+      return element;
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
+GstElement* CreateVideoEncoder(VideoCodec codec, int32_t keyframe_interval) {
+  auto* encoder = codec == VideoCodec::kH265 ? CreateFirstElement(kH265Encoders)
+                                             : CreateFirstElement(kH264Encoders);
+  auto* factory = encoder ? gst_element_get_factory(encoder) : nullptr;
+  if (!factory) {
+    return encoder;
+  }
+
+  auto const* name = GST_OBJECT_NAME(factory);
+  auto* object_class = G_OBJECT_GET_CLASS(encoder);
+  // The software encoders default to presets meant for offline encoding.
+  if (!g_strcmp0(name, "x264enc") || !g_strcmp0(name, "x265enc")) {
+    gst_util_set_object_arg(G_OBJECT(encoder), "speed-preset", "ultrafast");
+    gst_util_set_object_arg(G_OBJECT(encoder), "tune", "zerolatency");
+  }
+  if (keyframe_interval <= 0) {
+    return encoder;
+  }
+  if (g_object_class_find_property(object_class, "key-int-max")) {
+    g_object_set(G_OBJECT(encoder), "key-int-max", keyframe_interval, NULL);
+  } else if (g_object_class_find_property(object_class, "extra-controls")) {
+    auto controls =
+        "controls,video_gop_size=" + std::to_string(keyframe_interval);
+    gst_util_set_object_arg(G_OBJECT(encoder), "extra-controls",
+                            controls.c_str());
+  }
+  return encoder;
+}
+
+GstElement* CreateVideoParser(VideoCodec codec) {
+  return gst_element_factory_make(
+      codec == VideoCodec::kH265 ? "h265parse" : "h264parse", "parser");
+}
+
+const char* GetVideoCodecCaps(VideoCodec codec) {
+  return codec == VideoCodec::kH265 ? "video/x-h265" : "video/x-h264";
+}
@@ -0,0 +1,31 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_VIDEO_ENCODER_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_VIDEO_ENCODER_H_
+
+#include <gst/gst.h>
+
+#include <cstdint>
+
+enum class VideoCodec {
+  kH264,
+  kH265,
+};
+
+// Creates the first encoder of |codec| found, hardware ones first:
+// v4l2h264enc, qtic2venc, then x264enc, or their H.265 counterparts. Software
+// encoders are set up for live encoding. If |keyframe_interval| is positive,
+// a keyframe is forced every that many frames, so that new receivers of a
+// stream can start decoding soon. Returns nullptr if there's none.
+GstElement* CreateVideoEncoder(VideoCodec codec, int32_t keyframe_interval);
+
+// Returns the h264parse or h265parse of |codec|.
+GstElement* CreateVideoParser(VideoCodec codec);
+
+// The caps of the encoded stream, which select the codec of encoders that
+// have several, e.g. qtic2venc.
+const char* GetVideoCodecCaps(VideoCodec codec);
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_VIDEO_ENCODER_H_
@@ -0,0 +1,145 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "video_recorder.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "tee_branch.h"
+
+namespace {
+// Bounds the frames the recording branch holds, which may come from the
+// small buffer pool of the camera.
+constexpr guint kMaxQueuedFrames = 5;
+
+// How long Stop() waits for the encoder and the muxer to drain.
+constexpr auto kFinishTimeout = std::chrono::seconds(5);
+}  // namespace
+
+// static
+std::unique_ptr<VideoRecorder> VideoRecorder::Start(GstElement* pipeline,
+                                                    GstElement* tee,
+                                                    const std::string& path,
+                                                    Codec codec) {
+  std::unique_ptr<VideoRecorder> recorder(
+      new VideoRecorder(pipeline, tee, path));
+  if (!recorder->CreateBranch(codec)) {
+    recorder->is_stopped_ = true;
+    return nullptr;
+  }
+  return recorder;
+}
+
+VideoRecorder::VideoRecorder(GstElement* pipeline, GstElement* tee,
+                             const std::string& path)
+    : pipeline_(pipeline), tee_(tee), path_(path) {}
+
+VideoRecorder::~VideoRecorder() {
+  if (!is_stopped_) {
+    Stop();
+  }
+}
+
+bool VideoRecorder::CreateBranch(Codec codec) {
+  auto* queue = gst_element_factory_make("queue", "queue");
+  auto* convert = gst_element_factory_make("videoconvert", "convert");
+  auto* encoder = CreateVideoEncoder(codec, 0);
+  auto* encoder_caps = gst_element_factory_make("capsfilter", "encodercaps");
+  auto* parser = CreateVideoParser(codec);
+  auto* muxer = gst_element_factory_make("mp4mux", "muxer");
+  auto* sink = gst_element_factory_make("filesink", "sink");
+  bin_ = gst_bin_new(nullptr);
+  if (!queue || !convert || !encoder || !encoder_caps || !parser || !muxer ||
+      !sink || !bin_) {
+    std::cerr << "Failed to create the elements of the video recorder"
+              << std::endl;
+    for (auto* element :
+         {queue, convert, encoder, encoder_caps, parser, muxer, sink, bin_}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    bin_ = nullptr;
+    return false;
+  }
+
+  g_object_set(G_OBJECT(queue), "max-size-buffers", kMaxQueuedFrames,
+               "max-size-bytes", 0, "max-size-time", 0, NULL);
+  gst_util_set_object_arg(G_OBJECT(queue), "leaky", "downstream");
+  auto* caps = gst_caps_from_string(GetVideoCodecCaps(codec));
+  g_object_set(G_OBJECT(encoder_caps), "caps", caps, NULL);
+  gst_caps_unref(caps);
+  g_object_set(G_OBJECT(sink), "location", path_.c_str(), "sync", FALSE,
+               "async", FALSE, NULL);
+
+  gst_bin_add_many(GST_BIN(bin_), queue, convert, encoder, encoder_caps,
+                   parser, muxer, sink, NULL);
+  if (!gst_element_link_many(queue, convert, encoder, encoder_caps, parser,
+                             muxer, sink, NULL)) {
+    std::cerr << "Failed to link the elements of the video recorder"
+              << std::endl;
+    gst_object_unref(bin_);
+    bin_ = nullptr;
+    return false;
+  }
+
+  auto* sink_pad = gst_element_get_static_pad(sink, "sink");
+  gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, OnSinkEvent,
+                    this, nullptr);
+  gst_object_unref(sink_pad);
+
+  tee_pad_ = AttachTeeBranch(pipeline_, tee_, bin_, queue);
+  if (!tee_pad_) {
+    bin_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool VideoRecorder::Stop() {
+  if (is_stopped_) {
+    return false;
+  }
+  is_stopped_ = true;
+
+  // The tee drops the frames of the released pad from now on, and the EOS
+  // drains the encoder and makes the muxer write the index of the file.
+  DetachTeeBranch(tee_, tee_pad_, bin_);
+  tee_pad_ = nullptr;
+  auto* ghost_pad = gst_element_get_static_pad(bin_, "sink");
+  gst_pad_send_event(ghost_pad, gst_event_new_eos());
+  gst_object_unref(ghost_pad);
+
+  bool is_finished;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    is_finished =
+        cv_.wait_for(lock, kFinishTimeout, [this] { return is_finished_; });
+  }
+  if (!is_finished) {
+    std::cerr << "Timed out finishing " << path_ << std::endl;
+  }
+
+  RemoveTeeBranch(pipeline_, bin_);
+  bin_ = nullptr;
+  return is_finished;
+}
+
+// static
+GstPadProbeReturn VideoRecorder::OnSinkEvent(GstPad* pad,
+                                             GstPadProbeInfo* info,
+                                             gpointer user_data) {
+  auto* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) != GST_EVENT_EOS) {
+    return GST_PAD_PROBE_OK;
+  }
+  auto* self = reinterpret_cast<VideoRecorder*>(user_data);
+  {
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    self->is_finished_ = true;
+  }
+  self->cv_.notify_all();
+  return GST_PAD_PROBE_OK;
+}
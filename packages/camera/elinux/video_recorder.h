@@ -0,0 +1,68 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_CAMERA_CAMERA_ELINUX_VIDEO_RECORDER_H_
+#define PACKAGES_CAMERA_CAMERA_ELINUX_VIDEO_RECORDER_H_
+
+#include <gst/gst.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "video_encoder.h"
+
+// Records the frames of a tee of a camera pipeline into an MP4 file, in a
+// branch added to the running pipeline:
+// tee. ! queue ! videoconvert ! v4l2h264enc ! h264parse ! mp4mux ! filesink
+// See CreateVideoEncoder() for the encoders.
+// The frames are shared with the other branches of the tee without a copy,
+// and the converter passes them through if the encoder takes their format.
+// The queue drops frames rather than holding the tee back if the encoder
+// can't keep up, so that the preview isn't delayed.
+class VideoRecorder {
+ public:
+  using Codec = VideoCodec;
+
+  // Starts recording |tee| of |pipeline| into |path|. Returns nullptr on
+  // failure.
+  static std::unique_ptr<VideoRecorder> Start(GstElement* pipeline,
+                                              GstElement* tee,
+                                              const std::string& path,
+                                              Codec codec);
+  // Stops recording if it hasn't been stopped.
+  ~VideoRecorder();
+
+  // Prevent copying.
+  VideoRecorder(VideoRecorder const&) = delete;
+  VideoRecorder& operator=(VideoRecorder const&) = delete;
+
+  // Detaches the branch from the tee and waits for the muxer to finish the
+  // file. Returns false if the file may be incomplete.
+  bool Stop();
+
+  const std::string& GetPath() const { return path_; }
+
+ private:
+  VideoRecorder(GstElement* pipeline, GstElement* tee, const std::string& path);
+
+  bool CreateBranch(Codec codec);
+  static GstPadProbeReturn OnSinkEvent(GstPad* pad, GstPadProbeInfo* info,
+                                       gpointer user_data);
+
+  GstElement* const pipeline_;
+  GstElement* const tee_;
+  const std::string path_;
+  GstElement* bin_ = nullptr;
+  GstPad* tee_pad_ = nullptr;
+  bool is_stopped_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Set once the EOS reaches the file sink, guarded by |mutex_|.
+  bool is_finished_ = false;
+};
+
+#endif  // PACKAGES_CAMERA_CAMERA_ELINUX_VIDEO_RECORDER_H_
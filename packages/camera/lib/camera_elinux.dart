@@ -3,4 +3,5 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+export 'src/camera_frame_buffer.dart';
 export 'src/elinux_camera.dart';
@@ -0,0 +1,157 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:camera_platform_interface/camera_platform_interface.dart';
+
+/// A plane of a [CameraFrameBuffer].
+class CameraFrameBufferPlane {
+  CameraFrameBufferPlane._({
+    required this.bytesPerRow,
+    required this.bytesPerPixel,
+    required this.width,
+    required this.height,
+    required int address,
+    required int size,
+  })  : _address = address,
+        _size = size;
+
+  /// The number of bytes between the starts of two rows.
+  final int bytesPerRow;
+
+  /// The distance between two adjacent pixels of a row in bytes.
+  final int bytesPerPixel;
+
+  /// The width of the plane in pixels.
+  final int width;
+
+  /// The height of the plane in pixels.
+  final int height;
+
+  final int _address;
+  final int _size;
+}
+
+/// A frame of [ELinuxCamera.onFrameBufferAvailable], in memory shared with
+/// the plugin.
+///
+/// The slot of the frame is reused only after [release] is called, so call
+/// it as soon as the pixels are no longer needed. The planes must not be read
+/// after [release] or after the stream is cancelled.
+class CameraFrameBuffer {
+  CameraFrameBuffer._({
+    required this.sequence,
+    required this.width,
+    required this.height,
+    required this.format,
+    required this.timestamp,
+    required this.droppedFrames,
+    required this.sensorTimestamp,
+    required this.frameNumber,
+    required this.lostFrames,
+    required this.skippedFrames,
+    required this.planes,
+    required int stateAddress,
+  }) : _stateAddress = stateAddress;
+
+  /// Converts an event of the image stream.
+  factory CameraFrameBuffer.fromPlatformData(Map<dynamic, dynamic> data) {
+    final int timestampUs = data['timestampUs'] as int;
+    final int sensorTimestampUs = data['sensorTimestampUs'] as int;
+    return CameraFrameBuffer._(
+      sequence: data['sequence'] as int,
+      width: data['width'] as int,
+      height: data['height'] as int,
+      format: _formatGroupFromPlatformData(data['format'] as int),
+      timestamp: timestampUs < 0 ? null : Duration(microseconds: timestampUs),
+      droppedFrames: data['droppedFrames'] as int,
+      sensorTimestamp: sensorTimestampUs < 0
+          ? null
+          : Duration(microseconds: sensorTimestampUs),
+      frameNumber: data['frameNumber'] as int,
+      lostFrames: data['lostFrames'] as int,
+      skippedFrames: data['skippedFrames'] as int,
+      planes: List<CameraFrameBufferPlane>.unmodifiable(
+          (data['planes'] as List<dynamic>).map<CameraFrameBufferPlane>(
+              (dynamic plane) {
+        final Map<dynamic, dynamic> map = plane as Map<dynamic, dynamic>;
+        return CameraFrameBufferPlane._(
+          bytesPerRow: map['bytesPerRow'] as int,
+          bytesPerPixel: map['bytesPerPixel'] as int,
+          width: map['width'] as int,
+          height: map['height'] as int,
+          address: map['address'] as int,
+          size: map['size'] as int,
+        );
+      })),
+      stateAddress: data['stateAddress'] as int,
+    );
+  }
+
+  /// The number of the frame in the stream, counting the frames sent.
+  final int sequence;
+
+  /// The width of the frame in pixels.
+  final int width;
+
+  /// The height of the frame in pixels.
+  final int height;
+
+  /// The format of the planes. [ImageFormatGroup.unknown] stands for RGBA.
+  final ImageFormatGroup format;
+
+  /// The presentation timestamp of the frame, or null if unknown.
+  final Duration? timestamp;
+
+  /// The frames dropped so far, because a slot or the stream was busy or
+  /// over its maximum rate.
+  final int droppedFrames;
+
+  /// The time the sensor captured the frame, in the monotonic clock of the
+  /// device, or null if unknown.
+  final Duration? sensorTimestamp;
+
+  /// The number of the frame from the driver of the camera.
+  final int frameNumber;
+
+  /// The frames the camera lost so far, before they reached the plugin.
+  final int lostFrames;
+
+  /// The frames the pipeline skipped so far before the preview.
+  final int skippedFrames;
+
+  /// The planes of the frame.
+  final List<CameraFrameBufferPlane> planes;
+
+  final int _stateAddress;
+  bool _isReleased = false;
+
+  /// A view of the bytes of [planes][index], without a copy.
+  Uint8List bytesOf(int index) {
+    assert(!_isReleased);
+    final CameraFrameBufferPlane plane = planes[index];
+    return Pointer<Uint8>.fromAddress(plane._address).asTypedList(plane._size);
+  }
+
+  /// Gives the slot of the frame back to the plugin.
+  void release() {
+    if (_isReleased) {
+      return;
+    }
+    _isReleased = true;
+    Pointer<Uint32>.fromAddress(_stateAddress).value = 0;
+  }
+
+  static ImageFormatGroup _formatGroupFromPlatformData(int data) {
+    switch (data) {
+      case 35: // android.graphics.ImageFormat.YUV_420_888
+        return ImageFormatGroup.yuv420;
+      case 17: // android.graphics.ImageFormat.NV21
+        return ImageFormatGroup.nv21;
+    }
+    return ImageFormatGroup.unknown;
+  }
+}
@@ -12,6 +12,8 @@ import 'package:flutter/services.dart';
 import 'package:flutter/widgets.dart';
 import 'package:stream_transform/stream_transform.dart';
 
+import 'camera_frame_buffer.dart';
+import 'platform_tasks.dart';
 import 'type_conversion.dart';
 import 'utils.dart';
 
@@ -23,6 +25,7 @@ class ELinuxCamera extends CameraPlatform {
   /// Registers this class as the default instance of [CameraPlatform].
   static void registerWith() {
     CameraPlatform.instance = ELinuxCamera();
+    PlatformTasks.start('plugins.flutter.io/camera/platformTasks');
   }
 
   final Map<int, MethodChannel> _channels = <int, MethodChannel>{};
@@ -65,6 +68,53 @@ class ELinuxCamera extends CameraPlatform {
   // The stream for vending frames to platform interface clients.
   StreamController<CameraImageData>? _frameStreamController;
 
+  // The camera of [_frameStreamController].
+  int? _frameStreamCameraId;
+
+  /// The maximum frames per second of [onStreamedFrameAvailable], or null for
+  /// the rate of the camera. Applies to the streams started afterwards.
+  ///
+  /// The frames that arrive while the previous one is still being sent are
+  /// dropped regardless, so that a slow consumer doesn't delay the preview.
+  int? imageStreamMaxFps;
+
+  /// The maximum width of the frames of [onStreamedFrameAvailable], which are
+  /// scaled down by an integral factor beyond it, or null for the size of the
+  /// camera. Applies to the streams started afterwards.
+  int? imageStreamMaxWidth;
+
+  /// The frame rate the previews of the cameras created afterwards aim at,
+  /// or null for the fastest rate of the camera at the size of the
+  /// [ResolutionPreset].
+  int? previewFps;
+
+  /// The codec of the videos recorded afterwards, `h264` or `h265`.
+  String videoCodec = 'h264';
+
+  // The frame rates the previews have negotiated, by camera.
+  final Map<int, double> _previewFps = <int, double>{};
+
+  /// The frame rate the preview of [cameraId] has negotiated, once it has
+  /// been initialized, or null if it's unknown.
+  double? negotiatedPreviewFps(int cameraId) => _previewFps[cameraId];
+
+  /// The latencies of the frames of [cameraId] over the last 300 frames,
+  /// and the metadata of the latest preview frame.
+  ///
+  /// `captureToHandoff`, `captureToTexture` and `captureToDart` each map
+  /// `p50`, `p95`, `p99` and `max` in microseconds from the sensor, `count`
+  /// and a `histogram` of the frames under 1, 2, 4, ... 256 ms and over.
+  /// `sensorTimestampUs`, `frameNumber`, `lostFrames` and `skippedFrames`
+  /// describe the latest preview frame.
+  Future<Map<String, Object?>> getFrameStats(int cameraId) async {
+    final Map<String, Object?>? stats =
+        await _channel.invokeMapMethod<String, Object?>(
+      'getFrameStats',
+      <String, dynamic>{'cameraId': cameraId},
+    );
+    return stats ?? <String, Object?>{};
+  }
+
   Stream<CameraEvent> _cameraEvents(int cameraId) =>
       cameraEventStreamController.stream
           .where((CameraEvent event) => event.cameraId == cameraId);
@@ -106,6 +156,7 @@ class ELinuxCamera extends CameraPlatform {
             ? _serializeResolutionPreset(resolutionPreset)
             : null,
         'enableAudio': enableAudio,
+        if (previewFps != null) 'fps': previewFps,
       });
 
       return reply!['cameraId']! as int;
@@ -166,6 +217,7 @@ class ELinuxCamera extends CameraPlatform {
       cameraChannel?.setMethodCallHandler(null);
       _channels.remove(cameraId);
     }
+    _previewFps.remove(cameraId);
 
     await _channel.invokeMethod<void>(
       'dispose',
@@ -243,6 +295,118 @@ class ELinuxCamera extends CameraPlatform {
     return XFile(path);
   }
 
+  /// Takes the next [count] frames of the preview of [cameraId] as JPEG
+  /// files, without interrupting the preview. Several bursts may be in flight
+  /// at once. The pictures that fail are left out.
+  Future<List<XFile>> takePictureBurst(int cameraId, int count) async {
+    final List<String>? paths = await _channel.invokeListMethod<String>(
+      'takePictureBurst',
+      <String, dynamic>{'cameraId': cameraId, 'count': count},
+    );
+    return (paths ?? <String>[]).map((String path) => XFile(path)).toList();
+  }
+
+  /// Like [takePictureBurst], but returns the JPEG data of the pictures
+  /// instead of writing them to files.
+  Future<List<Uint8List>> takePictureBurstInMemory(
+      int cameraId, int count) async {
+    final List<Uint8List>? pictures =
+        await _channel.invokeListMethod<Uint8List>(
+      'takePictureBurst',
+      <String, dynamic>{
+        'cameraId': cameraId,
+        'count': count,
+        'inMemory': true,
+      },
+    );
+    return pictures ?? <Uint8List>[];
+  }
+
+  /// Captures the latest preview frame of [cameraId], e.g. for a screenshot,
+  /// without switching the camera to a capture mode.
+  ///
+  /// [format] is 'jpeg', encoded in hardware when the device can, 'png' or
+  /// 'rgba' for tightly packed pixels. The frame is scaled down so that its
+  /// longest side is at most [maxSize] if given. The frame is scaled and
+  /// encoded on worker threads shared by the cameras.
+  Future<Uint8List> captureFrame(int cameraId,
+      {String format = 'jpeg', int? maxSize}) async {
+    final Map<String, dynamic>? frame =
+        await _channel.invokeMapMethod<String, dynamic>(
+      'captureFrame',
+      <String, dynamic>{
+        'cameraId': cameraId,
+        'format': format,
+        'maxSize': maxSize ?? 0,
+      },
+    );
+    return frame!['data'] as Uint8List;
+  }
+
+  /// Like [captureFrame], but writes the frame to [path] on the worker
+  /// thread instead of returning it.
+  Future<XFile> captureFrameToFile(int cameraId, String path,
+      {String format = 'jpeg', int? maxSize}) async {
+    final Map<String, dynamic>? frame =
+        await _channel.invokeMapMethod<String, dynamic>(
+      'captureFrame',
+      <String, dynamic>{
+        'cameraId': cameraId,
+        'format': format,
+        'maxSize': maxSize ?? 0,
+        'path': path,
+      },
+    );
+    return XFile(frame!['path'] as String);
+  }
+
+  /// Serves the preview of the given camera over RTSP, encoded with
+  /// [codec] ('h264' or 'h265'), and returns the URL of the stream.
+  ///
+  /// Requires the plugin to be built with `USE_RTSP_SERVER`.
+  Future<String> startStreamServer(int cameraId,
+      {int port = 8554, String path = '/camera', String codec = 'h264'}) async {
+    final String? url = await _channel.invokeMethod<String>(
+      'startStreamServer',
+      <String, dynamic>{
+        'cameraId': cameraId,
+        'port': port,
+        'path': path,
+        'codec': codec,
+      },
+    );
+    return url ?? '';
+  }
+
+  /// Stops serving the preview of the given camera.
+  Future<void> stopStreamServer(int cameraId) => _channel.invokeMethod<void>(
+        'stopStreamServer',
+        <String, dynamic>{'cameraId': cameraId},
+      );
+
+  /// Pins the threads of [role] ('network' or 'streaming') of all the
+  /// cameras to [cpus], and runs them with SCHED_FIFO at [realtimePriority]
+  /// from 1 to 99, or else with [nice].
+  ///
+  /// Applies to the threads that start afterwards, e.g. when a camera is
+  /// initialized. An empty [cpus] lets them run on any CPU. Real-time
+  /// priorities and negative nice values need CAP_SYS_NICE or the matching
+  /// rlimit, otherwise the threads keep their scheduling and a warning is
+  /// logged.
+  Future<void> setThreadPolicy(String role,
+          {List<int> cpus = const <int>[],
+          int realtimePriority = 0,
+          int nice = 0}) =>
+      _channel.invokeMethod<void>(
+        'setThreadPolicy',
+        <String, dynamic>{
+          'role': role,
+          'cpus': cpus,
+          'realtimePriority': realtimePriority,
+          'nice': nice,
+        },
+      );
+
   @override
   Future<void> prepareForVideoRecording() =>
       _channel.invokeMethod<void>('prepareForVideoRecording');
@@ -262,6 +426,7 @@ class ELinuxCamera extends CameraPlatform {
         'cameraId': options.cameraId,
         'maxVideoDuration': options.maxDuration?.inMilliseconds,
         'enableStream': options.streamCallback != null,
+        'codec': videoCodec,
       },
     );
 
@@ -304,7 +469,7 @@ class ELinuxCamera extends CameraPlatform {
   @override
   Stream<CameraImageData> onStreamedFrameAvailable(int cameraId,
       {CameraImageStreamOptions? options}) {
-    _installStreamController(onListen: _onFrameStreamListen);
+    _installStreamController(onListen: () => _onFrameStreamListen(cameraId));
     return _frameStreamController!.stream;
   }
 
@@ -319,12 +484,17 @@ class ELinuxCamera extends CameraPlatform {
     return _frameStreamController!;
   }
 
-  void _onFrameStreamListen() {
-    _startPlatformStream();
+  void _onFrameStreamListen(int cameraId) {
+    _startPlatformStream(cameraId);
   }
 
-  Future<void> _startPlatformStream() async {
-    await _channel.invokeMethod<void>('startImageStream');
+  Future<void> _startPlatformStream(int cameraId) async {
+    _frameStreamCameraId = cameraId;
+    await _channel.invokeMethod<void>('startImageStream', <String, dynamic>{
+      'cameraId': cameraId,
+      if (imageStreamMaxFps != null) 'maxFps': imageStreamMaxFps,
+      if (imageStreamMaxWidth != null) 'maxWidth': imageStreamMaxWidth,
+    });
     _startStreamListener();
   }
 
@@ -339,12 +509,58 @@ class ELinuxCamera extends CameraPlatform {
   }
 
   FutureOr<void> _onFrameStreamCancel() async {
-    await _channel.invokeMethod<void>('stopImageStream');
+    await _channel.invokeMethod<void>('stopImageStream',
+        <String, dynamic>{'cameraId': _frameStreamCameraId});
     await _platformImageStreamSubscription?.cancel();
     _platformImageStreamSubscription = null;
     _frameStreamController = null;
   }
 
+  /// Streams the frames of [cameraId] like [onStreamedFrameAvailable], but
+  /// through memory shared with the plugin instead of copies, e.g. for
+  /// on-device inference.
+  ///
+  /// Each frame holds one of four slots until [CameraFrameBuffer.release] is
+  /// called, and the frames that find no free slot are dropped, so a slow
+  /// consumer only lowers the frame rate of the stream. [imageStreamMaxFps],
+  /// [imageStreamMaxWidth] and the `imageFormatGroup` of the camera apply as
+  /// well. Only one of the two streams can be active at a time.
+  Stream<CameraFrameBuffer> onFrameBufferAvailable(int cameraId) {
+    late final StreamController<CameraFrameBuffer> controller;
+    StreamSubscription<dynamic>? subscription;
+    controller = StreamController<CameraFrameBuffer>(
+      onListen: () async {
+        await _channel.invokeMethod<void>('startImageStream', <String, dynamic>{
+          'cameraId': cameraId,
+          'transport': 'sharedMemory',
+          if (imageStreamMaxFps != null) 'maxFps': imageStreamMaxFps,
+          if (imageStreamMaxWidth != null) 'maxWidth': imageStreamMaxWidth,
+        });
+        subscription =
+            const EventChannel('plugins.flutter.io/camera/imageStream')
+                .receiveBroadcastStream()
+                .listen((dynamic data) {
+          final CameraFrameBuffer frame = CameraFrameBuffer.fromPlatformData(
+              data as Map<dynamic, dynamic>);
+          if (controller.isClosed) {
+            frame.release();
+            return;
+          }
+          controller.add(frame);
+        });
+      },
+      onPause: _onFrameStreamPauseResume,
+      onResume: _onFrameStreamPauseResume,
+      onCancel: () async {
+        await subscription?.cancel();
+        subscription = null;
+        await _channel.invokeMethod<void>(
+            'stopImageStream', <String, dynamic>{'cameraId': cameraId});
+      },
+    );
+    return controller.stream;
+  }
+
   void _onFrameStreamPauseResume() {
     throw CameraException('InvalidCall',
         'Pause and resume are not supported for onStreamedFrameAvailable');
@@ -455,6 +671,17 @@ class ELinuxCamera extends CameraPlatform {
     );
   }
 
+  /// Locks the white balance of [cameraId] where it is, or gives it back to
+  /// the camera with [locked] false.
+  Future<void> setWhiteBalanceLocked(int cameraId, bool locked) =>
+      _channel.invokeMethod<void>(
+        'setWhiteBalanceMode',
+        <String, dynamic>{
+          'cameraId': cameraId,
+          'mode': locked ? 'locked' : 'auto',
+        },
+      );
+
   @override
   Future<double> getMaxZoomLevel(int cameraId) async {
     final double? maxZoomLevel = await _channel.invokeMethod<double>(
@@ -590,6 +817,10 @@ class ELinuxCamera extends CameraPlatform {
     switch (call.method) {
       case 'initialized':
         final Map<String, Object?> arguments = _getArgumentDictionary(call);
+        final double? fps = arguments['previewFps'] as double?;
+        if (fps != null && fps > 0) {
+          _previewFps[cameraId] = fps;
+        }
         cameraEventStreamController.add(CameraInitializedEvent(
           cameraId,
           arguments['previewWidth']! as double,
@@ -0,0 +1,236 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evdev_joystick.h"
+
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace {
+constexpr int kReadBatchSize = 64;
+constexpr int32_t kAxisMax = 32767;
+constexpr size_t kBitsPerLong = sizeof(unsigned long) * CHAR_BIT;
+
+template <size_t kCount>
+using BitArray = std::array<unsigned long, (kCount + kBitsPerLong - 1) /
+                                               kBitsPerLong>;
+
+bool TestBit(const unsigned long* bits, size_t bit) {
+  return (bits[bit / kBitsPerLong] >> (bit % kBitsPerLong)) & 1;
+}
+
+int64_t GetMonotonicTimeUs() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+}  // namespace
+
+// static
+std::unique_ptr<EvdevJoystick> EvdevJoystick::Create(int fd) {
+  auto joystick = std::unique_ptr<EvdevJoystick>(new EvdevJoystick(fd));
+  if (!joystick->QueryCapabilities()) {
+    return nullptr;
+  }
+  int clock = CLOCK_MONOTONIC;
+  joystick->is_monotonic_ = !ioctl(fd, EVIOCSCLOCKID, &clock);
+  return joystick;
+}
+
+EvdevJoystick::EvdevJoystick(int fd) : fd_(fd) {
+  axis_numbers_.fill(kUnmapped);
+  button_numbers_.fill(kUnmapped);
+}
+
+bool EvdevJoystick::QueryCapabilities() {
+  BitArray<KEY_CNT> keys = {};
+  BitArray<ABS_CNT> abs = {};
+  BitArray<INPUT_PROP_CNT> properties = {};
+  if (ioctl(fd_, EVIOCGBIT(EV_KEY, sizeof(keys)), keys.data()) < 0 ||
+      ioctl(fd_, EVIOCGBIT(EV_ABS, sizeof(abs)), abs.data()) < 0) {
+    return false;
+  }
+  ioctl(fd_, EVIOCGPROP(sizeof(properties)), properties.data());
+
+  // As joydev matches devices: touchscreens, tablets and accelerometers have
+  // absolute axes too.
+  if (TestBit(keys.data(), BTN_TOUCH) || TestBit(keys.data(), BTN_DIGI) ||
+      TestBit(properties.data(), INPUT_PROP_ACCELEROMETER)) {
+    return false;
+  }
+  if (!TestBit(keys.data(), BTN_JOYSTICK) &&
+      !TestBit(keys.data(), BTN_GAMEPAD) &&
+      !TestBit(keys.data(), BTN_TRIGGER_HAPPY)) {
+    return false;
+  }
+
+  for (uint16_t code = 0; code < ABS_CNT; code++) {
+    input_absinfo info;
+    if (!TestBit(abs.data(), code) || ioctl(fd_, EVIOCGABS(code), &info) < 0 ||
+        axes_.size() >= JoystickState::kMaxAxes) {
+      continue;
+    }
+    axis_numbers_[code] = axes_.size();
+    axes_.push_back({info, Scale(info, info.value)});
+    axis_codes_.push_back(code);
+  }
+
+  // joydev numbers the joystick and gamepad buttons first, then the others
+  // from BTN_MISC.
+  BitArray<KEY_CNT> pressed = {};
+  ioctl(fd_, EVIOCGKEY(sizeof(pressed)), pressed.data());
+  const auto add_button = [&](uint16_t code) {
+    if (TestBit(keys.data(), code) &&
+        button_codes_.size() < JoystickState::kMaxButtons) {
+      button_numbers_[code] = button_codes_.size();
+      button_codes_.push_back(code);
+      buttons_.push_back(TestBit(pressed.data(), code));
+    }
+  };
+  for (uint16_t code = BTN_JOYSTICK; code < KEY_CNT; code++) {
+    add_button(code);
+  }
+  for (uint16_t code = BTN_MISC; code < BTN_JOYSTICK; code++) {
+    add_button(code);
+  }
+  return true;
+}
+
+void EvdevJoystick::GetInitialEvents(
+    int64_t timestamp_us, std::vector<JoystickReaderEvent>& events) {
+  for (size_t i = 0; i < buttons_.size(); i++) {
+    AppendButton(i, buttons_[i], JS_EVENT_INIT, timestamp_us, events);
+  }
+  for (size_t i = 0; i < axes_.size(); i++) {
+    AppendAxis(i, axes_[i].value, JS_EVENT_INIT, timestamp_us, events);
+  }
+}
+
+bool EvdevJoystick::Read(std::vector<JoystickReaderEvent>& events) {
+  input_event input[kReadBatchSize];
+  const auto bytes = read(fd_, input, sizeof(input));
+  if (bytes < 0) {
+    return errno == EAGAIN || errno == EINTR;
+  }
+  const auto now_us = is_monotonic_ ? 0 : GetMonotonicTimeUs();
+  const auto count = static_cast<size_t>(bytes) / sizeof(input[0]);
+  for (size_t i = 0; i < count; i++) {
+    const auto& event = input[i];
+    const auto timestamp_us =
+        is_monotonic_ ? static_cast<int64_t>(event.input_event_sec) * 1000000 +
+                            event.input_event_usec
+                      : now_us;
+    if (event.type == EV_SYN) {
+      if (event.code == SYN_DROPPED) {
+        is_dropping_ = true;
+      } else if (event.code == SYN_REPORT && is_dropping_) {
+        is_dropping_ = false;
+        Resync(timestamp_us, events);
+      }
+    } else if (!is_dropping_) {
+      Translate(event, timestamp_us, events);
+    }
+  }
+  return true;
+}
+
+// static
+int16_t EvdevJoystick::Scale(const input_absinfo& info, int32_t value) {
+  // In half units, so that the center of an even range is exact.
+  const int64_t range = static_cast<int64_t>(info.maximum) - info.minimum;
+  if (range <= 0) {
+    return 0;
+  }
+  const int64_t offset =
+      2 * static_cast<int64_t>(value) - info.minimum - info.maximum;
+  const int64_t flat = 2 * static_cast<int64_t>(info.flat);
+  if (std::abs(offset) <= flat) {
+    return 0;
+  }
+  if (range <= flat) {
+    return offset < 0 ? -kAxisMax : kAxisMax;
+  }
+  // Scaled from the edges of the flat zone, as joydev corrects the axes.
+  const int64_t scaled =
+      (offset < 0 ? offset + flat : offset - flat) * kAxisMax / (range - flat);
+  return std::clamp<int64_t>(scaled, -kAxisMax, kAxisMax);
+}
+
+void EvdevJoystick::Translate(const input_event& event, int64_t timestamp_us,
+                              std::vector<JoystickReaderEvent>& events) {
+  if (event.type == EV_ABS && event.code < ABS_CNT) {
+    const auto number = axis_numbers_[event.code];
+    if (number == kUnmapped) {
+      return;
+    }
+    const auto value = Scale(axes_[number].info, event.value);
+    if (value != axes_[number].value) {
+      axes_[number].value = value;
+      AppendAxis(number, value, 0, timestamp_us, events);
+    }
+  } else if (event.type == EV_KEY && event.code < KEY_CNT) {
+    const auto number = button_numbers_[event.code];
+    // Auto-repeat, with a value of 2, isn't a change.
+    if (number == kUnmapped || event.value > 1) {
+      return;
+    }
+    const bool pressed = event.value != 0;
+    if (pressed != buttons_[number]) {
+      buttons_[number] = pressed;
+      AppendButton(number, pressed, 0, timestamp_us, events);
+    }
+  }
+}
+
+void EvdevJoystick::Resync(int64_t timestamp_us,
+                           std::vector<JoystickReaderEvent>& events) {
+  BitArray<KEY_CNT> pressed = {};
+  if (ioctl(fd_, EVIOCGKEY(sizeof(pressed)), pressed.data()) >= 0) {
+    for (size_t i = 0; i < button_codes_.size(); i++) {
+      input_event event = {};
+      event.type = EV_KEY;
+      event.code = button_codes_[i];
+      event.value = TestBit(pressed.data(), button_codes_[i]);
+      Translate(event, timestamp_us, events);
+    }
+  }
+  for (size_t i = 0; i < axis_codes_.size(); i++) {
+    input_absinfo info;
+    if (ioctl(fd_, EVIOCGABS(axis_codes_[i]), &info) >= 0) {
+      input_event event = {};
+      event.type = EV_ABS;
+      event.code = axis_codes_[i];
+      event.value = info.value;
+      Translate(event, timestamp_us, events);
+    }
+  }
+}
+
+void EvdevJoystick::AppendAxis(uint8_t number, int16_t value, uint8_t flags,
+                               int64_t timestamp_us,
+                               std::vector<JoystickReaderEvent>& events) {
+  js_event event;
+  event.time = static_cast<uint32_t>(timestamp_us / 1000);
+  event.value = value;
+  event.type = JS_EVENT_AXIS | flags;
+  event.number = number;
+  events.push_back({fd_, event, timestamp_us});
+}
+
+void EvdevJoystick::AppendButton(uint8_t number, bool pressed, uint8_t flags,
+                                 int64_t timestamp_us,
+                                 std::vector<JoystickReaderEvent>& events) {
+  js_event event;
+  event.time = static_cast<uint32_t>(timestamp_us / 1000);
+  event.value = pressed ? 1 : 0;
+  event.type = JS_EVENT_BUTTON | flags;
+  event.number = number;
+  events.push_back({fd_, event, timestamp_us});
+}
@@ -0,0 +1,89 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_JOYSTICK_JOYSTICK_ELINUX_EVDEV_JOYSTICK_H_
+#define PACKAGES_JOYSTICK_JOYSTICK_ELINUX_EVDEV_JOYSTICK_H_
+
+#include <linux/input.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "joystick_reader.h"
+
+// A joystick read through its evdev device, /dev/input/event*, whose events
+// are translated into those of the js interface.
+//
+// The axes and buttons are numbered the way joydev numbers them for
+// /dev/input/js*, and the axes are scaled to -32767..32767 from the range and
+// flat zone EVIOCGABS reports. Unlike js_event.time, the timestamps come from
+// the kernel when it received the input, in CLOCK_MONOTONIC microseconds.
+class EvdevJoystick {
+ public:
+  // Returns nullptr if |fd| isn't a joystick or a gamepad. |fd| stays owned
+  // by the caller.
+  static std::unique_ptr<EvdevJoystick> Create(int fd);
+
+  // Prevent copying.
+  EvdevJoystick(EvdevJoystick const&) = delete;
+  EvdevJoystick& operator=(EvdevJoystick const&) = delete;
+
+  uint8_t GetAxisCount() const { return axes_.size(); }
+  uint8_t GetButtonCount() const { return button_codes_.size(); }
+
+  // Appends the current value of every axis and button, as events flagged
+  // JS_EVENT_INIT, as the js interface sends them first.
+  void GetInitialEvents(int64_t timestamp_us,
+                        std::vector<JoystickReaderEvent>& events);
+
+  // Reads the pending input and appends its events to |events|. Returns
+  // false once the device is gone.
+  bool Read(std::vector<JoystickReaderEvent>& events);
+
+ private:
+  static constexpr int16_t kUnmapped = -1;
+
+  struct Axis {
+    input_absinfo info;
+    // The latest value sent, scaled.
+    int16_t value;
+  };
+
+  explicit EvdevJoystick(int fd);
+
+  bool QueryCapabilities();
+  // Scales |value| to -32767..32767, with its flat zone as 0.
+  static int16_t Scale(const input_absinfo& info, int32_t value);
+  // Appends the event of |event|, if it changes an axis or a button.
+  void Translate(const input_event& event, int64_t timestamp_us,
+                 std::vector<JoystickReaderEvent>& events);
+  // After the kernel dropped events, sends what changed meanwhile.
+  void Resync(int64_t timestamp_us, std::vector<JoystickReaderEvent>& events);
+  void AppendAxis(uint8_t number, int16_t value, uint8_t flags,
+                  int64_t timestamp_us,
+                  std::vector<JoystickReaderEvent>& events);
+  void AppendButton(uint8_t number, bool pressed, uint8_t flags,
+                    int64_t timestamp_us,
+                    std::vector<JoystickReaderEvent>& events);
+
+  const int fd_;
+  // The js numbers of the ABS_* and KEY_* codes, or kUnmapped.
+  std::array<int16_t, ABS_CNT> axis_numbers_;
+  std::array<int16_t, KEY_CNT> button_numbers_;
+  // By js number.
+  std::vector<Axis> axes_;
+  std::vector<uint16_t> axis_codes_;
+  std::vector<uint16_t> button_codes_;
+  std::vector<bool> buttons_;
+  // False if the kernel is too old to stamp the events with CLOCK_MONOTONIC,
+  // in which case they are stamped when read.
+  bool is_monotonic_ = false;
+  // Set from SYN_DROPPED until the next SYN_REPORT, whose events are
+  // incomplete.
+  bool is_dropping_ = false;
+};
+
+#endif  // PACKAGES_JOYSTICK_JOYSTICK_ELINUX_EVDEV_JOYSTICK_H_
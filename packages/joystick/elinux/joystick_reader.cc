@@ -0,0 +1,510 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "joystick_reader.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <mutex>
+
+#include "evdev_joystick.h"
+#include "joystick_rumble.h"
+
+namespace {
+constexpr int kMaxEpollEvents = 8;
+// Drained per read() of a device.
+constexpr int kReadBatchSize = 64;
+constexpr char kInputDirectory[] = "/dev/input";
+
+// The layout of Dart_CObject of dart_native_api.h for the int64 the reader
+// posts, which spares the plugin the headers of the Dart SDK.
+struct DartCObjectInt64 {
+  int32_t type;
+  int64_t value;
+};
+// Dart_CObject_kInt64.
+constexpr int32_t kDartCObjectInt64 = 3;
+
+struct DeviceState {
+  std::mutex mutex;
+  // Guarded by |mutex|.
+  JoystickState state;
+};
+
+// The states of the joysticks of all the readers by descriptor. The lock is
+// only held to look a state up.
+std::mutex& GetDevicesMutex() {
+  static auto* mutex = new std::mutex();
+  return *mutex;
+}
+
+std::map<int, std::shared_ptr<DeviceState>>& GetDevices() {
+  static auto* devices = new std::map<int, std::shared_ptr<DeviceState>>();
+  return *devices;
+}
+
+std::shared_ptr<DeviceState> FindDevice(int fd) {
+  std::lock_guard<std::mutex> lock(GetDevicesMutex());
+  auto it = GetDevices().find(fd);
+  return it != GetDevices().end() ? it->second : nullptr;
+}
+
+int64_t GetMonotonicTimeUs() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+bool HasPrefix(const std::string& name, const char* prefix) {
+  return name.compare(0, std::strlen(prefix), prefix) == 0;
+}
+}  // namespace
+
+// static
+std::unique_ptr<JoystickReader> JoystickReader::Create(
+    int64_t port, PostCObject post_cobject) {
+  const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd < 0) {
+    fprintf(stderr, "Failed to create an epoll instance (%d)\n", errno);
+    return nullptr;
+  }
+  const int wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wake_fd < 0) {
+    fprintf(stderr, "Failed to create an eventfd (%d)\n", errno);
+    close(epoll_fd);
+    return nullptr;
+  }
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = wake_fd;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event) < 0) {
+    fprintf(stderr, "Failed to watch the eventfd (%d)\n", errno);
+    close(wake_fd);
+    close(epoll_fd);
+    return nullptr;
+  }
+  return std::unique_ptr<JoystickReader>(
+      new JoystickReader(epoll_fd, wake_fd, port, post_cobject));
+}
+
+JoystickReader::JoystickReader(int epoll_fd, int wake_fd, int64_t port,
+                               PostCObject post_cobject)
+    : epoll_fd_(epoll_fd),
+      wake_fd_(wake_fd),
+      port_(port),
+      post_cobject_(post_cobject) {
+  events_.reserve(kReadBatchSize);
+  thread_ = std::thread([this]() { Run(); });
+}
+
+JoystickReader::~JoystickReader() {
+  is_stopping_ = true;
+  const uint64_t value = 1;
+  if (write(wake_fd_, &value, sizeof(value)) < 0) {
+    fprintf(stderr, "Failed to wake the joystick reader (%d)\n", errno);
+  }
+  thread_.join();
+  while (!devices_.empty()) {
+    const int fd = devices_.begin()->first;
+    Remove(fd);
+    devices_.erase(fd);
+    close(fd);
+    JoystickRumble::Forget(fd);
+  }
+  if (inotify_fd_ >= 0) {
+    close(inotify_fd_);
+  }
+  close(wake_fd_);
+  close(epoll_fd_);
+}
+
+bool JoystickReader::Add(int fd) {
+  uint8_t axis_count = 0;
+  uint8_t button_count = 0;
+  ioctl(fd, JSIOCGAXES, &axis_count);
+  ioctl(fd, JSIOCGBUTTONS, &button_count);
+  return Watch(fd, axis_count, button_count);
+}
+
+bool JoystickReader::Watch(int fd, uint8_t axis_count, uint8_t button_count) {
+  auto device = std::make_shared<DeviceState>();
+  std::memset(&device->state, 0, sizeof(device->state));
+  device->state.axis_count = axis_count;
+  device->state.button_count = button_count;
+  {
+    std::lock_guard<std::mutex> lock(GetDevicesMutex());
+    GetDevices()[fd] = device;
+  }
+
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+    fprintf(stderr, "Failed to watch the joystick %d (%d)\n", fd, errno);
+    std::lock_guard<std::mutex> lock(GetDevicesMutex());
+    GetDevices().erase(fd);
+    return false;
+  }
+  return true;
+}
+
+bool JoystickReader::Remove(int fd) {
+  {
+    std::lock_guard<std::mutex> lock(GetDevicesMutex());
+    GetDevices().erase(fd);
+  }
+  return epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr) == 0;
+}
+
+bool JoystickReader::WatchDevices(Backend backend) {
+  if (inotify_fd_ >= 0) {
+    return false;
+  }
+  const int inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd < 0) {
+    fprintf(stderr, "Failed to create an inotify instance (%d)\n", errno);
+    return false;
+  }
+  // udev creates a node before giving it its permissions, so a node that
+  // can't be opened yet is tried again when its attributes change.
+  if (inotify_add_watch(inotify_fd, kInputDirectory,
+                        IN_CREATE | IN_ATTRIB | IN_DELETE) < 0) {
+    fprintf(stderr, "Failed to watch %s (%d)\n", kInputDirectory, errno);
+    close(inotify_fd);
+    return false;
+  }
+  backend_ = backend;
+  inotify_fd_ = inotify_fd;
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = inotify_fd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, inotify_fd, &event) < 0) {
+    fprintf(stderr, "Failed to watch the inotify instance (%d)\n", errno);
+    inotify_fd_ = -1;
+    close(inotify_fd);
+    return false;
+  }
+  // The joysticks plugged in already are opened on the reader thread too.
+  is_scan_pending_ = true;
+  const uint64_t value = 1;
+  if (write(wake_fd_, &value, sizeof(value)) < 0) {
+    fprintf(stderr, "Failed to wake the joystick reader (%d)\n", errno);
+  }
+  return true;
+}
+
+// static
+bool JoystickReader::GetState(int fd, JoystickState& state) {
+  auto device = FindDevice(fd);
+  if (!device) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(device->mutex);
+  state = device->state;
+  return true;
+}
+
+// static
+void JoystickReader::UpdateState(int fd, const JoystickReaderEvent* events,
+                                 size_t count) {
+  auto device = FindDevice(fd);
+  if (!device) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(device->mutex);
+  auto& state = device->state;
+  for (size_t i = 0; i < count; i++) {
+    const auto& event = events[i].event;
+    // The initial state is sent as events flagged JS_EVENT_INIT.
+    const auto type = event.type & ~JS_EVENT_INIT;
+    if (type == JS_EVENT_AXIS && event.number < JoystickState::kMaxAxes) {
+      state.axes[event.number] = event.value;
+    } else if (type == JS_EVENT_BUTTON) {
+      const auto bit = uint64_t{1} << (event.number % 64);
+      if (event.value) {
+        state.buttons[event.number / 64] |= bit;
+      } else {
+        state.buttons[event.number / 64] &= ~bit;
+      }
+    }
+    state.time = event.time;
+    state.timestamp_us = events[i].timestamp_us;
+  }
+}
+
+int JoystickReader::Read(JoystickReaderEvent* events, int max) {
+  // Cleared before looking at the ring, so that an event pushed meanwhile
+  // either is read below or wakes Dart again.
+  is_notified_ = false;
+  const auto tail = tail_.load(std::memory_order_relaxed);
+  // Sequentially consistent against the store of NotifyDart's flag.
+  const auto head = head_.load();
+  int count = 0;
+  for (auto index = tail; index != head && count < max; index++) {
+    events[count++] = ring_[index % kRingSize];
+  }
+  tail_.store(tail + count, std::memory_order_release);
+  return count;
+}
+
+void JoystickReader::Run() {
+  epoll_event events[kMaxEpollEvents];
+  while (true) {
+    const int count = epoll_wait(epoll_fd_, events, kMaxEpollEvents, -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fprintf(stderr, "Failed to wait for the joysticks (%d)\n", errno);
+      return;
+    }
+    for (int i = 0; i < count; i++) {
+      const int fd = events[i].data.fd;
+      if (fd == wake_fd_) {
+        if (!OnWake()) {
+          return;
+        }
+        continue;
+      }
+      if (fd == inotify_fd_) {
+        OnDeviceChanges();
+        continue;
+      }
+      const bool is_present = ReadDevice(fd) &&
+                              !(events[i].events & (EPOLLHUP | EPOLLERR));
+      if (is_present) {
+        continue;
+      }
+      if (devices_.count(fd)) {
+        CloseDevice(fd);
+      } else {
+        // Unplugged. The app still owns the descriptor.
+        Remove(fd);
+      }
+    }
+  }
+}
+
+bool JoystickReader::OnWake() {
+  uint64_t value;
+  if (read(wake_fd_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+    fprintf(stderr, "Failed to read the eventfd (%d)\n", errno);
+  }
+  if (is_stopping_) {
+    return false;
+  }
+  if (is_scan_pending_.exchange(false)) {
+    ScanDevices();
+  }
+  return true;
+}
+
+bool JoystickReader::ReadDevice(int fd) {
+  events_.clear();
+  bool is_present = true;
+  auto it = devices_.find(fd);
+  if (it != devices_.end() && it->second.evdev) {
+    is_present = it->second.evdev->Read(events_);
+  } else {
+    js_event events[kReadBatchSize];
+    const auto bytes = read(fd, events, sizeof(events));
+    if (bytes < 0) {
+      is_present = errno == EAGAIN || errno == EINTR;
+    } else {
+      const auto timestamp_us = GetMonotonicTimeUs();
+      const auto count = static_cast<size_t>(bytes) / sizeof(events[0]);
+      for (size_t i = 0; i < count; i++) {
+        events_.push_back({fd, events[i], timestamp_us});
+      }
+    }
+  }
+  if (!events_.empty()) {
+    UpdateState(fd, events_.data(), events_.size());
+    for (const auto& event : events_) {
+      Push(event);
+    }
+    NotifyDart();
+  }
+  return is_present;
+}
+
+void JoystickReader::ScanDevices() {
+  DIR* directory = opendir(kInputDirectory);
+  if (!directory) {
+    fprintf(stderr, "Failed to open %s (%d)\n", kInputDirectory, errno);
+    return;
+  }
+  while (const dirent* entry = readdir(directory)) {
+    OpenDevice(entry->d_name);
+  }
+  closedir(directory);
+}
+
+void JoystickReader::OnDeviceChanges() {
+  alignas(inotify_event) char buffer[4096];
+  while (true) {
+    const auto bytes = read(inotify_fd_, buffer, sizeof(buffer));
+    if (bytes <= 0) {
+      return;
+    }
+    for (ssize_t offset = 0; offset < bytes;) {
+      const auto* event = reinterpret_cast<inotify_event*>(buffer + offset);
+      offset += sizeof(inotify_event) + event->len;
+      if (!event->len) {
+        continue;
+      }
+      if (event->mask & IN_DELETE) {
+        const auto path = std::string(kInputDirectory) + "/" + event->name;
+        for (const auto& device : devices_) {
+          if (device.second.path == path) {
+            CloseDevice(device.first);
+            break;
+          }
+        }
+      } else {
+        OpenDevice(event->name);
+      }
+    }
+  }
+}
+
+void JoystickReader::OpenDevice(const std::string& name) {
+  const bool is_evdev = backend_ == Backend::kEvdev;
+  if (!HasPrefix(name, is_evdev ? "event" : "js")) {
+    return;
+  }
+  const auto path = std::string(kInputDirectory) + "/" + name;
+  for (const auto& device : devices_) {
+    if (device.second.path == path) {
+      return;
+    }
+  }
+  // Read-write for force feedback where the permissions allow it.
+  int fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0 && errno == EACCES) {
+    fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  }
+  if (fd < 0) {
+    // Not accessible yet, or gone already.
+    return;
+  }
+
+  Device device = {path, nullptr};
+  uint8_t axis_count = 0;
+  uint8_t button_count = 0;
+  if (is_evdev) {
+    device.evdev = EvdevJoystick::Create(fd);
+    if (!device.evdev) {
+      // A keyboard, a mouse, etc.
+      close(fd);
+      return;
+    }
+    axis_count = device.evdev->GetAxisCount();
+    button_count = device.evdev->GetButtonCount();
+  } else {
+    ioctl(fd, JSIOCGAXES, &axis_count);
+    ioctl(fd, JSIOCGBUTTONS, &button_count);
+  }
+  if (!Watch(fd, axis_count, button_count)) {
+    close(fd);
+    return;
+  }
+
+  const auto timestamp_us = GetMonotonicTimeUs();
+  js_event connected = {};
+  connected.time = static_cast<uint32_t>(timestamp_us / 1000);
+  connected.type = kJoystickEventConnected;
+  events_.clear();
+  events_.push_back({fd, connected, timestamp_us});
+  // js sends the initial state by itself on the first read.
+  if (device.evdev) {
+    device.evdev->GetInitialEvents(timestamp_us, events_);
+  }
+  UpdateState(fd, events_.data(), events_.size());
+  for (const auto& event : events_) {
+    Push(event);
+  }
+  NotifyDart();
+  devices_[fd] = std::move(device);
+}
+
+void JoystickReader::CloseDevice(int fd) {
+  Remove(fd);
+  devices_.erase(fd);
+  close(fd);
+  JoystickRumble::Forget(fd);
+
+  const auto timestamp_us = GetMonotonicTimeUs();
+  js_event disconnected = {};
+  disconnected.time = static_cast<uint32_t>(timestamp_us / 1000);
+  disconnected.type = kJoystickEventDisconnected;
+  Push({fd, disconnected, timestamp_us});
+  NotifyDart();
+}
+
+void JoystickReader::Push(const JoystickReaderEvent& event) {
+  const auto head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) >= kRingSize) {
+    dropped_events_++;
+    return;
+  }
+  ring_[head % kRingSize] = event;
+  head_.store(head + 1);
+}
+
+void JoystickReader::NotifyDart() {
+  if (is_notified_.exchange(true)) {
+    return;
+  }
+  DartCObjectInt64 message = {kDartCObjectInt64, 0};
+  post_cobject_(port_, &message);
+}
+
+extern "C" __attribute__((visibility("default"))) JoystickReader*
+joystick_reader_create(int64_t port, void* post_cobject) {
+  return JoystickReader::Create(
+             port, reinterpret_cast<JoystickReader::PostCObject>(post_cobject))
+      .release();
+}
+
+extern "C" __attribute__((visibility("default"))) void joystick_reader_destroy(
+    JoystickReader* reader) {
+  delete reader;
+}
+
+extern "C" __attribute__((visibility("default"))) int joystick_reader_add(
+    JoystickReader* reader, int fd) {
+  return reader->Add(fd);
+}
+
+extern "C" __attribute__((visibility("default"))) int joystick_reader_remove(
+    JoystickReader* reader, int fd) {
+  return reader->Remove(fd);
+}
+
+extern "C" __attribute__((visibility("default"))) int
+joystick_reader_watch_devices(JoystickReader* reader, int evdev) {
+  return reader->WatchDevices(evdev ? JoystickReader::Backend::kEvdev
+                                    : JoystickReader::Backend::kJs);
+}
+
+extern "C" __attribute__((visibility("default"))) int joystick_reader_read(
+    JoystickReader* reader, JoystickReaderEvent* events, int max) {
+  return reader->Read(events, max);
+}
+
+extern "C" __attribute__((visibility("default"))) int joystick_get_state(
+    int fd, JoystickState* state) {
+  return JoystickReader::GetState(fd, *state);
+}
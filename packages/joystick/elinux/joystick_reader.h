@@ -0,0 +1,168 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_JOYSTICK_JOYSTICK_ELINUX_JOYSTICK_READER_H_
+#define PACKAGES_JOYSTICK_JOYSTICK_ELINUX_JOYSTICK_READER_H_
+
+#include <linux/joystick.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class EvdevJoystick;
+
+// An event of JoystickReader, as JoystickReaderEvent of joystick.dart.
+struct JoystickReaderEvent {
+  int32_t fd;
+  js_event event;
+  // The time the event was read, or received by the kernel for evdev, in
+  // CLOCK_MONOTONIC microseconds.
+  int64_t timestamp_us;
+};
+
+// The types of the events JoystickReader sends when a joystick it opened by
+// itself is plugged or unplugged, next to those of js_event. The connection
+// comes before the first event of the descriptor, and the disconnection after
+// the last one, once the descriptor is closed.
+constexpr uint8_t kJoystickEventConnected = 0x10;
+constexpr uint8_t kJoystickEventDisconnected = 0x20;
+
+// The current state of a joystick, as the offsets of JoystickState of
+// joystick.dart.
+struct JoystickState {
+  static constexpr size_t kMaxAxes = 64;
+  static constexpr size_t kMaxButtons = 256;
+
+  // The time of the latest event, in CLOCK_MONOTONIC microseconds, or 0 if
+  // there has been none.
+  int64_t timestamp_us;
+  // Bit n % 64 of buttons[n / 64] is set while button n is pressed.
+  uint64_t buttons[kMaxButtons / 64];
+  int16_t axes[kMaxAxes];
+  // The time of the latest event from the driver, in milliseconds.
+  uint32_t time;
+  // As the driver reports them.
+  uint8_t axis_count;
+  uint8_t button_count;
+};
+
+// Reads the events of joysticks on a thread of its own, which sleeps in
+// epoll_wait() until one of them has input.
+//
+// The events are queued in a single-producer single-consumer ring, drained
+// by Read() on the Dart thread. Dart is woken through its native port when
+// the ring stops being empty only, so a burst of events costs one message
+// and one FFI call.
+class JoystickReader {
+ public:
+  // The interface of the joysticks WatchDevices() opens.
+  enum class Backend {
+    // /dev/input/js*, with the timestamps of the reads in milliseconds.
+    kJs,
+    // /dev/input/event*, with the timestamps of the kernel in microseconds.
+    kEvdev,
+  };
+
+  // Dart_PostCObject, as NativeApi.postCObject gives it.
+  using PostCObject = bool (*)(int64_t port, void* message);
+
+  // Returns nullptr if the thread couldn't be started.
+  static std::unique_ptr<JoystickReader> Create(int64_t port,
+                                                PostCObject post_cobject);
+  // Stops the thread. The joysticks given to Add() are left open, those of
+  // WatchDevices() are closed.
+  ~JoystickReader();
+
+  // Prevent copying.
+  JoystickReader(JoystickReader const&) = delete;
+  JoystickReader& operator=(JoystickReader const&) = delete;
+
+  // Starts or stops reading |fd|, which must be non-blocking. The state of
+  // |fd| is kept from Add() to Remove().
+  bool Add(int fd);
+  bool Remove(int fd);
+
+  // Opens the joysticks of /dev/input through |backend|, and reads them
+  // along with those of Add(). The joysticks plugged in later are opened,
+  // and those unplugged closed, without restarting the app. May be called
+  // once.
+  bool WatchDevices(Backend backend);
+
+  // Copies the state of |fd|, as the events read so far left it. Returns
+  // false if no reader reads |fd|. May be called from any thread.
+  static bool GetState(int fd, JoystickState& state);
+
+  // Moves up to |max| events into |events|, and returns their number.
+  // Called from the Dart thread only.
+  int Read(JoystickReaderEvent* events, int max);
+
+  // The events dropped because the ring was full.
+  uint64_t GetDroppedEventCount() const { return dropped_events_; }
+
+ private:
+  static constexpr size_t kRingSize = 1024;
+
+  // A joystick opened by WatchDevices().
+  struct Device {
+    std::string path;
+    // Null for the js backend.
+    std::unique_ptr<EvdevJoystick> evdev;
+  };
+
+  JoystickReader(int epoll_fd, int wake_fd, int64_t port,
+                 PostCObject post_cobject);
+
+  void Run();
+  // Handles the wake of the eventfd. Returns false to stop the thread.
+  bool OnWake();
+  // Returns false once |fd| is gone.
+  bool ReadDevice(int fd);
+  // Registers the state of |fd| and starts watching it.
+  bool Watch(int fd, uint8_t axis_count, uint8_t button_count);
+  // Applies |events| to the state of |fd|.
+  static void UpdateState(int fd, const JoystickReaderEvent* events,
+                          size_t count);
+
+  // The joysticks of WatchDevices(), on the reader thread only.
+  void ScanDevices();
+  void OnDeviceChanges();
+  void OpenDevice(const std::string& name);
+  void CloseDevice(int fd);
+  void Push(const JoystickReaderEvent& event);
+  void NotifyDart();
+
+  const int epoll_fd_;
+  // An eventfd that stops the thread, or makes it scan /dev/input.
+  const int wake_fd_;
+  std::atomic<bool> is_stopping_ = false;
+  std::atomic<bool> is_scan_pending_ = false;
+  // The inotify instance watching /dev/input, or -1.
+  std::atomic<int> inotify_fd_ = -1;
+  std::atomic<Backend> backend_ = Backend::kJs;
+  // Used by the reader thread only.
+  std::map<int, Device> devices_;
+  std::vector<JoystickReaderEvent> events_;
+
+  const int64_t port_;
+  const PostCObject post_cobject_;
+
+  std::array<JoystickReaderEvent, kRingSize> ring_;
+  // Written by the reader thread.
+  std::atomic<size_t> head_ = 0;
+  // Written by the Dart thread.
+  std::atomic<size_t> tail_ = 0;
+  // Set once Dart has been woken, until Read() finds the ring empty.
+  std::atomic<bool> is_notified_ = false;
+  std::atomic<uint64_t> dropped_events_ = 0;
+  std::thread thread_;
+};
+
+#endif  // PACKAGES_JOYSTICK_JOYSTICK_ELINUX_JOYSTICK_READER_H_
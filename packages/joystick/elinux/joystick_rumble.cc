@@ -0,0 +1,118 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "joystick_rumble.h"
+
+#include <errno.h>
+#include <linux/input.h>
+#include <stdio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <map>
+#include <mutex>
+
+namespace {
+struct Effect {
+  int16_t id;
+  uint16_t strong;
+  uint16_t weak;
+  uint16_t duration_ms;
+};
+
+// The effects uploaded, by descriptor.
+std::mutex& GetEffectsMutex() {
+  static auto* mutex = new std::mutex();
+  return *mutex;
+}
+
+std::map<int, Effect>& GetEffects() {
+  static auto* effects = new std::map<int, Effect>();
+  return *effects;
+}
+
+// Uploads |effect|, replacing the previous one of |fd| if it has an ID.
+bool Upload(int fd, Effect& effect) {
+  ff_effect ff = {};
+  ff.type = FF_RUMBLE;
+  ff.id = effect.id;
+  ff.u.rumble.strong_magnitude = effect.strong;
+  ff.u.rumble.weak_magnitude = effect.weak;
+  ff.replay.length = effect.duration_ms;
+  if (ioctl(fd, EVIOCSFF, &ff) < 0) {
+    fprintf(stderr, "Failed to upload the rumble of %d (%d)\n", fd, errno);
+    return false;
+  }
+  effect.id = ff.id;
+  return true;
+}
+
+bool Play(int fd, int16_t id, bool play) {
+  input_event event = {};
+  event.type = EV_FF;
+  event.code = id;
+  event.value = play ? 1 : 0;
+  if (write(fd, &event, sizeof(event)) != sizeof(event)) {
+    fprintf(stderr, "Failed to play the rumble of %d (%d)\n", fd, errno);
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+// static
+bool JoystickRumble::Rumble(int fd, uint16_t strong, uint16_t weak,
+                            uint16_t duration_ms) {
+  std::lock_guard<std::mutex> lock(GetEffectsMutex());
+  auto& effects = GetEffects();
+  auto it = effects.find(fd);
+  if (!strong && !weak) {
+    return it == effects.end() || Play(fd, it->second.id, false);
+  }
+  if (it == effects.end()) {
+    Effect effect = {-1, strong, weak, duration_ms};
+    if (!Upload(fd, effect)) {
+      return false;
+    }
+    it = effects.emplace(fd, effect).first;
+  } else if (it->second.strong != strong || it->second.weak != weak ||
+             it->second.duration_ms != duration_ms) {
+    // Updated in place, under the same ID.
+    Effect effect = {it->second.id, strong, weak, duration_ms};
+    if (!Upload(fd, effect)) {
+      return false;
+    }
+    it->second = effect;
+  }
+  return Play(fd, it->second.id, true);
+}
+
+// static
+void JoystickRumble::Release(int fd) {
+  std::lock_guard<std::mutex> lock(GetEffectsMutex());
+  auto it = GetEffects().find(fd);
+  if (it == GetEffects().end()) {
+    return;
+  }
+  if (ioctl(fd, EVIOCRMFF, static_cast<int>(it->second.id)) < 0) {
+    fprintf(stderr, "Failed to remove the rumble of %d (%d)\n", fd, errno);
+  }
+  GetEffects().erase(it);
+}
+
+// static
+void JoystickRumble::Forget(int fd) {
+  std::lock_guard<std::mutex> lock(GetEffectsMutex());
+  GetEffects().erase(fd);
+}
+
+extern "C" __attribute__((visibility("default"))) int joystick_rumble(
+    int fd, uint16_t strong, uint16_t weak, uint16_t duration_ms) {
+  return JoystickRumble::Rumble(fd, strong, weak, duration_ms);
+}
+
+extern "C" __attribute__((visibility("default"))) void
+joystick_rumble_release(int fd) {
+  JoystickRumble::Release(fd);
+}
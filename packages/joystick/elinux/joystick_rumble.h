@@ -0,0 +1,31 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_JOYSTICK_JOYSTICK_ELINUX_JOYSTICK_RUMBLE_H_
+#define PACKAGES_JOYSTICK_JOYSTICK_ELINUX_JOYSTICK_RUMBLE_H_
+
+#include <cstdint>
+
+// Rumbles joysticks through the FF_RUMBLE effect of their evdev device.
+//
+// An effect is uploaded once per joystick, and then played by its ID with a
+// write(). It is only uploaded again when its magnitudes or its duration
+// change, so rumbling every frame with the same effect costs one system call.
+class JoystickRumble {
+ public:
+  // Plays the effect of |strong| and |weak| magnitudes, of the heavy and of
+  // the light motors, for |duration_ms|. Zero magnitudes stop the rumble.
+  // |fd| must be a writable /dev/input/event* descriptor. May be called from
+  // any thread.
+  static bool Rumble(int fd, uint16_t strong, uint16_t weak,
+                     uint16_t duration_ms);
+
+  // Removes the effect of |fd|, which must be done before it is closed.
+  static void Release(int fd);
+
+  // Forgets the effect of |fd|, already closed, which the kernel removed.
+  static void Forget(int fd);
+};
+
+#endif  // PACKAGES_JOYSTICK_JOYSTICK_ELINUX_JOYSTICK_RUMBLE_H_
@@ -4,10 +4,15 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <linux/input.h>
 #include <linux/joystick.h>
 #include <stdio.h>
+#include <sys/ioctl.h>
 #include <unistd.h>
 
+#include <cstdint>
+#include <cstring>
+
 extern "C" __attribute__((visibility("default"))) int joystick_open(
     const char* device) {
   int fd = open(device, O_NONBLOCK);
@@ -25,3 +30,59 @@ extern "C" __attribute__((visibility("default"))) int joystick_read(
   }
   return bytes == sizeof(*ev);
 }
+
+// Reads all the pending events, up to |max|, with one read(), and returns
+// their number, 0 if there are none, or -1 on an error.
+//
+// The events of an axis that moved several times since the last button
+// event are coalesced into its latest value and time, at the place of its
+// first event: only the order of the button events and of an axis against
+// them matters to the callers.
+extern "C" __attribute__((visibility("default"))) int joystick_read_many(
+    int fd, js_event* events, int max) {
+  if (max <= 0) {
+    return 0;
+  }
+  const ssize_t bytes = read(fd, events, sizeof(*events) * max);
+  if (bytes < 0) {
+    return errno == EAGAIN ? 0 : -1;
+  }
+
+  // The joystick driver only returns whole events.
+  const int count = static_cast<int>(bytes / sizeof(*events));
+  // The index + 1 of the kept event of each axis, 0 if there's none.
+  int axis_index[256];
+  std::memset(axis_index, 0, sizeof(axis_index));
+  int kept = 0;
+  for (int i = 0; i < count; i++) {
+    const auto event = events[i];
+    if (event.type == JS_EVENT_AXIS) {
+      const int index = axis_index[event.number];
+      if (index) {
+        events[index - 1].time = event.time;
+        events[index - 1].value = event.value;
+        continue;
+      }
+      axis_index[event.number] = kept + 1;
+    } else if (event.type & JS_EVENT_BUTTON) {
+      std::memset(axis_index, 0, sizeof(axis_index));
+    }
+    events[kept++] = event;
+  }
+  return kept;
+}
+
+// Copies the name of the joystick |fd|, of /dev/input/js* or event*, into
+// |name|. Returns false if the driver has none.
+extern "C" __attribute__((visibility("default"))) int joystick_get_name(
+    int fd, char* name, int size) {
+  if (size <= 0) {
+    return false;
+  }
+  if (ioctl(fd, JSIOCGNAME(size), name) < 0 &&
+      ioctl(fd, EVIOCGNAME(size), name) < 0) {
+    return false;
+  }
+  name[size - 1] = '\0';
+  return true;
+}
@@ -4,7 +4,10 @@
 
 // ignore_for_file: public_member_api_docs
 
+import 'dart:async';
 import 'dart:ffi';
+import 'dart:isolate';
+
 import 'package:ffi/ffi.dart';
 
 DynamicLibrary _dylib = DynamicLibrary.open('libjoystick_plugin.so');
@@ -36,6 +39,14 @@ const int JS_EVENT_AXIS = 0x02;
 /// initial state of device. See [JS_EVENT_INIT] in <linux/joystick.h>
 const int JS_EVENT_INIT = 0x80;
 
+/// A joystick opened by [JoystickReader.watchDevices] was plugged in. See
+/// kJoystickEventConnected in joystick_reader.h.
+const int JOYSTICK_EVENT_CONNECTED = 0x10;
+
+/// A joystick opened by [JoystickReader.watchDevices] was unplugged, and its
+/// descriptor closed. See kJoystickEventDisconnected in joystick_reader.h.
+const int JOYSTICK_EVENT_DISCONNECTED = 0x20;
+
 typedef JoystickOpenNative = Int32 Function(Pointer<Utf8>);
 typedef JoystickOpen = int Function(Pointer<Utf8>);
 
@@ -52,6 +63,65 @@ final JoystickRead joystickRead = _dylib
     .lookup<NativeFunction<JoystickReadNative>>('joystick_read')
     .asFunction();
 
+typedef JoystickReadManyNative = Int32 Function(
+    Int32 fd, Pointer<JSEvent>, Int32 max);
+typedef JoystickReadMany = int Function(int fd, Pointer<JSEvent>, int max);
+
+/// Reads all the pending joystick input data, up to `max` events, into an
+/// array. Returns the number of events read, or -1 on an error.
+///
+/// The successive movements of an axis between two button events are
+/// coalesced into its latest value.
+final JoystickReadMany joystickReadMany = _dylib
+    .lookup<NativeFunction<JoystickReadManyNative>>('joystick_read_many')
+    .asFunction();
+
+typedef _JoystickGetNameNative = Int32 Function(
+    Int32 fd, Pointer<Utf8>, Int32 size);
+typedef _JoystickGetName = int Function(int fd, Pointer<Utf8>, int size);
+
+final _JoystickGetName _joystickGetName = _dylib
+    .lookup<NativeFunction<_JoystickGetNameNative>>('joystick_get_name')
+    .asFunction();
+
+/// Returns the name of the joystick [fd], or null if the driver has none.
+String? joystickGetName(int fd) {
+  const int size = 128;
+  final Pointer<Utf8> name = calloc<Uint8>(size).cast<Utf8>();
+  try {
+    return _joystickGetName(fd, name, size) != 0 ? name.toDartString() : null;
+  } finally {
+    calloc.free(name);
+  }
+}
+
+typedef _JoystickRumbleNative = Int32 Function(
+    Int32 fd, Uint16 strong, Uint16 weak, Uint16 durationMs);
+typedef _JoystickRumble = int Function(
+    int fd, int strong, int weak, int durationMs);
+typedef _JoystickRumbleReleaseNative = Void Function(Int32 fd);
+typedef _JoystickRumbleRelease = void Function(int fd);
+
+final _JoystickRumble _joystickRumble = _dylib
+    .lookup<NativeFunction<_JoystickRumbleNative>>('joystick_rumble')
+    .asFunction();
+
+/// Rumbles the joystick [fd], a writable /dev/input/event* descriptor, with
+/// the [strong] and [weak] magnitudes, from 0 to 65535, of its heavy and
+/// light motors for [durationMs]. Zero magnitudes stop the rumble.
+///
+/// The effect is uploaded to the joystick once, and only again when its
+/// parameters change, so that calling this every frame stays cheap.
+bool joystickRumble(int fd, int strong, int weak, int durationMs) =>
+    _joystickRumble(fd, strong, weak, durationMs) != 0;
+
+/// Removes the rumble effect of [joystickRumble] from the joystick [fd],
+/// before the app closes it.
+final _JoystickRumbleRelease joystickRumbleRelease = _dylib
+    .lookup<NativeFunction<_JoystickRumbleReleaseNative>>(
+        'joystick_rumble_release')
+    .asFunction();
+
 /// Returns true if no events.
 bool joystickInputIsInactive(JSEvent ev) {
   return (ev.type & JS_EVENT_INIT) != 0;
@@ -71,3 +141,185 @@ bool joystickInputIsAxis(JSEvent ev) {
 bool joystickButtonIsPressed(JSEvent ev) {
   return (ev.value & 1) != 0;
 }
+
+/// An event of [JoystickReader]. See JoystickReaderEvent in
+/// joystick_reader.h.
+class JoystickReaderEvent extends Struct {
+  /// The descriptor of the joystick, as [joystickOpen] returned it.
+  @Int32()
+  external int fd;
+  @Uint32()
+  external int time;
+  @Int16()
+  external int value;
+  @Uint8()
+  external int type;
+  @Uint8()
+  external int number;
+
+  /// The time the event was read, or received by the kernel for evdev, in
+  /// CLOCK_MONOTONIC microseconds.
+  @Int64()
+  external int timestampUs;
+}
+
+typedef _JoystickReaderCreateNative = Pointer<Void> Function(
+    Int64 port, Pointer<Void> postCObject);
+typedef _JoystickReaderCreate = Pointer<Void> Function(
+    int port, Pointer<Void> postCObject);
+typedef _JoystickReaderDestroyNative = Void Function(Pointer<Void>);
+typedef _JoystickReaderDestroy = void Function(Pointer<Void>);
+typedef _JoystickReaderFdNative = Int32 Function(Pointer<Void>, Int32 fd);
+typedef _JoystickReaderFd = int Function(Pointer<Void>, int fd);
+typedef _JoystickReaderWatchDevicesNative = Int32 Function(
+    Pointer<Void>, Int32 evdev);
+typedef _JoystickReaderWatchDevices = int Function(Pointer<Void>, int evdev);
+typedef _JoystickReaderReadNative = Int32 Function(
+    Pointer<Void>, Pointer<JoystickReaderEvent>, Int32 max);
+typedef _JoystickReaderRead = int Function(
+    Pointer<Void>, Pointer<JoystickReaderEvent>, int max);
+
+final _JoystickReaderCreate _joystickReaderCreate = _dylib
+    .lookup<NativeFunction<_JoystickReaderCreateNative>>(
+        'joystick_reader_create')
+    .asFunction();
+final _JoystickReaderDestroy _joystickReaderDestroy = _dylib
+    .lookup<NativeFunction<_JoystickReaderDestroyNative>>(
+        'joystick_reader_destroy')
+    .asFunction();
+final _JoystickReaderFd _joystickReaderAdd = _dylib
+    .lookup<NativeFunction<_JoystickReaderFdNative>>('joystick_reader_add')
+    .asFunction();
+final _JoystickReaderFd _joystickReaderRemove = _dylib
+    .lookup<NativeFunction<_JoystickReaderFdNative>>('joystick_reader_remove')
+    .asFunction();
+final _JoystickReaderWatchDevices _joystickReaderWatchDevices = _dylib
+    .lookup<NativeFunction<_JoystickReaderWatchDevicesNative>>(
+        'joystick_reader_watch_devices')
+    .asFunction();
+final _JoystickReaderRead _joystickReaderRead = _dylib
+    .lookup<NativeFunction<_JoystickReaderReadNative>>('joystick_reader_read')
+    .asFunction();
+
+/// Reads joysticks on a native thread, which sleeps until one of them has
+/// input, instead of polling them with [joystickRead].
+///
+/// [onEvents] is called with the events read since the previous call. The
+/// events are only valid during the call.
+class JoystickReader {
+  JoystickReader(this.onEvents) {
+    _port = ReceivePort()..listen((dynamic _) => _drain());
+    _reader = _joystickReaderCreate(
+        _port.sendPort.nativePort, NativeApi.postCObject.cast<Void>());
+    if (_reader == nullptr) {
+      _port.close();
+      throw StateError('Failed to start the joystick reader');
+    }
+  }
+
+  static const int _batchSize = 64;
+
+  final void Function(List<JoystickReaderEvent> events) onEvents;
+  late final ReceivePort _port;
+  late final Pointer<Void> _reader;
+  final Pointer<JoystickReaderEvent> _events =
+      calloc<JoystickReaderEvent>(_batchSize);
+
+  /// Starts reading the joystick [fd] of [joystickOpen].
+  bool add(int fd) => _joystickReaderAdd(_reader, fd) != 0;
+
+  /// Stops reading the joystick [fd].
+  bool remove(int fd) => _joystickReaderRemove(_reader, fd) != 0;
+
+  /// Opens every joystick of /dev/input, now and as they are plugged in, and
+  /// closes them as they are unplugged. Their events come between a
+  /// [JOYSTICK_EVENT_CONNECTED] and a [JOYSTICK_EVENT_DISCONNECTED] event.
+  ///
+  /// With [evdev], the joysticks are read through /dev/input/event*, whose
+  /// axes are calibrated from the ranges of the driver and whose
+  /// [JoystickReaderEvent.timestampUs] is the time the kernel received the
+  /// input. Otherwise they are read through /dev/input/js*.
+  bool watchDevices({bool evdev = true}) =>
+      _joystickReaderWatchDevices(_reader, evdev ? 1 : 0) != 0;
+
+  /// Stops the thread. The joysticks of [add] are left open, those of
+  /// [watchDevices] are closed.
+  void dispose() {
+    _port.close();
+    _joystickReaderDestroy(_reader);
+    calloc.free(_events);
+  }
+
+  void _drain() {
+    int count;
+    do {
+      count = _joystickReaderRead(_reader, _events, _batchSize);
+      if (count > 0) {
+        onEvents(List<JoystickReaderEvent>.generate(
+            count, (int i) => _events[i],
+            growable: false));
+      }
+    } while (count == _batchSize);
+  }
+}
+
+typedef _JoystickGetStateNative = Int32 Function(Int32 fd, Pointer<Uint8>);
+typedef _JoystickGetState = int Function(int fd, Pointer<Uint8>);
+
+final _JoystickGetState _joystickGetState = _dylib
+    .lookup<NativeFunction<_JoystickGetStateNative>>('joystick_get_state')
+    .asFunction();
+
+/// The current state of a joystick read by a [JoystickReader], which
+/// [update] copies at once, e.g. once per frame.
+///
+/// The layout follows JoystickState in joystick_reader.h.
+class JoystickState {
+  static const int maxAxes = 64;
+  static const int maxButtons = 256;
+
+  static const int _timestampOffset = 0;
+  static const int _buttonsOffset = 8;
+  static const int _axesOffset = 40;
+  static const int _timeOffset = 168;
+  static const int _axisCountOffset = 172;
+  static const int _buttonCountOffset = 173;
+  static const int _size = 176;
+
+  final Pointer<Uint8> _state = calloc<Uint8>(_size);
+
+  /// Copies the state of the joystick [fd]. Returns false if no
+  /// [JoystickReader] reads it.
+  bool update(int fd) => _joystickGetState(fd, _state) != 0;
+
+  /// The time of the latest event, in CLOCK_MONOTONIC microseconds, or 0 if
+  /// there has been none.
+  int get timestampUs =>
+      _state.elementAt(_timestampOffset).cast<Int64>().value;
+
+  /// The time of the latest event from the driver, in milliseconds.
+  int get time => _state.elementAt(_timeOffset).cast<Uint32>().value;
+
+  /// The number of axes of the joystick.
+  int get axisCount => _state[_axisCountOffset];
+
+  /// The number of buttons of the joystick.
+  int get buttonCount => _state[_buttonCountOffset];
+
+  /// The value of the axis [number], from -32767 to 32767.
+  int axis(int number) {
+    RangeError.checkValidIndex(number, null, 'number', maxAxes);
+    return _state.elementAt(_axesOffset).cast<Int16>()[number];
+  }
+
+  /// Returns true while the button [number] is pressed.
+  bool isPressed(int number) {
+    RangeError.checkValidIndex(number, null, 'number', maxButtons);
+    // The 64-bit words of the bitmask are little-endian.
+    return (_state[_buttonsOffset + number ~/ 8] & (1 << (number % 8))) != 0;
+  }
+
+  void dispose() {
+    calloc.free(_state);
+  }
+}
@@ -0,0 +1,42 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "include/path_provider_elinux/path_provider_elinux_plugin.h"
+
+#include <flutter/plugin_registrar.h>
+
+#include <memory>
+
+namespace {
+
+// The paths are resolved through FFI, see xdg_paths.h. The plugin only gets
+// the library bundled and loaded with the app.
+class PathProviderElinuxPlugin : public flutter::Plugin {
+ public:
+  static void RegisterWithRegistrar(flutter::PluginRegistrar *registrar);
+
+  PathProviderElinuxPlugin();
+
+  virtual ~PathProviderElinuxPlugin();
+};
+
+// static
+void PathProviderElinuxPlugin::RegisterWithRegistrar(
+    flutter::PluginRegistrar *registrar) {
+  auto plugin = std::make_unique<PathProviderElinuxPlugin>();
+  registrar->AddPlugin(std::move(plugin));
+}
+
+PathProviderElinuxPlugin::PathProviderElinuxPlugin() {}
+
+PathProviderElinuxPlugin::~PathProviderElinuxPlugin() {}
+
+}  // namespace
+
+void PathProviderElinuxPluginRegisterWithRegistrar(
+    FlutterDesktopPluginRegistrarRef registrar) {
+  PathProviderElinuxPlugin::RegisterWithRegistrar(
+      flutter::PluginRegistrarManager::GetInstance()
+          ->GetRegistrar<flutter::PluginRegistrar>(registrar));
+}
@@ -0,0 +1,163 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xdg_paths.h"
+
+#include <limits.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+namespace {
+std::string GetEnvironment(const char* name) {
+  const char* value = std::getenv(name);
+  return value ? value : "";
+}
+
+std::string GetHome() {
+  const auto home = GetEnvironment("HOME");
+  return home.empty() ? "/" : home;
+}
+
+// $|name| if it is an absolute path, as the XDG specification requires, or
+// $HOME/|fallback|.
+std::string GetBaseDirectory(const char* name, const char* fallback) {
+  const auto value = GetEnvironment(name);
+  if (!value.empty() && value[0] == '/') {
+    return value;
+  }
+  return GetHome() + "/" + fallback;
+}
+
+std::string GetExecutableName() {
+  char path[PATH_MAX];
+  const auto size = readlink("/proc/self/exe", path, sizeof(path) - 1);
+  if (size <= 0) {
+    return "";
+  }
+  std::string name(path, size);
+  name = name.substr(name.rfind('/') + 1);
+  const auto extension = name.rfind('.');
+  return extension == 0 || extension == std::string::npos
+             ? name
+             : name.substr(0, extension);
+}
+
+bool IsDirectory(const std::string& path) {
+  struct stat status;
+  return stat(path.c_str(), &status) == 0 && S_ISDIR(status.st_mode);
+}
+
+// mkdir -p, skipping the stat() of each parent: mkdir() failing with EEXIST
+// is as cheap as one.
+bool CreateDirectories(const std::string& path) {
+  for (size_t end = path.find('/', 1);; end = path.find('/', end + 1)) {
+    const auto directory = path.substr(0, end);
+    if (mkdir(directory.c_str(), 0700) < 0 && errno != EEXIST) {
+      std::cerr << "Failed to create " << directory << ": "
+                << std::strerror(errno) << std::endl;
+      return false;
+    }
+    if (end == std::string::npos) {
+      return true;
+    }
+  }
+}
+
+// The user directories of user-dirs.dirs, by name, e.g. DOCUMENTS, as
+// xdg-user-dir reads them, in one pass instead of a process per directory.
+std::map<std::string, std::string> ReadUserDirectories(
+    const std::string& config_home) {
+  std::map<std::string, std::string> directories;
+  std::ifstream file(config_home + "/user-dirs.dirs");
+  std::string line;
+  while (std::getline(file, line)) {
+    // XDG_DOCUMENTS_DIR="$HOME/Documents"
+    const auto equals = line.find('=');
+    if (line.compare(0, 4, "XDG_") != 0 || equals == std::string::npos ||
+        equals < 8 || line.compare(equals - 4, 4, "_DIR") != 0) {
+      continue;
+    }
+    auto value = line.substr(equals + 1);
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+      value = value.substr(1, value.size() - 2);
+    }
+    if (value.compare(0, 5, "$HOME") == 0) {
+      value = GetHome() + value.substr(5);
+    } else if (value.empty() || value[0] != '/') {
+      continue;
+    }
+    directories[line.substr(4, equals - 8)] = value;
+  }
+  return directories;
+}
+
+XdgPaths Resolve(const std::string& application_id) {
+  XdgPaths paths;
+  const auto temporary = GetEnvironment("TMPDIR");
+  paths.temporary = temporary.empty() ? "/tmp" : temporary;
+
+  const auto data_home = GetBaseDirectory("XDG_DATA_HOME", ".local/share");
+  const auto cache_home = GetBaseDirectory("XDG_CACHE_HOME", ".cache");
+  const auto config_home = GetBaseDirectory("XDG_CONFIG_HOME", ".config");
+  const auto executable_name = GetExecutableName();
+  const auto id = application_id.empty() ? executable_name : application_id;
+
+  paths.application_support = data_home + "/" + id;
+  // The plugin originally used the executable name as the directory, which
+  // is kept if it exists.
+  if (!IsDirectory(paths.application_support)) {
+    const auto legacy = data_home + "/" + executable_name;
+    if (IsDirectory(legacy)) {
+      paths.application_support = legacy;
+    } else {
+      CreateDirectories(paths.application_support);
+    }
+  }
+  paths.application_cache = cache_home + "/" + id;
+  CreateDirectories(paths.application_cache);
+
+  // xdg-user-dir falls back to $HOME.
+  auto directories = ReadUserDirectories(config_home);
+  paths.documents = directories.count("DOCUMENTS") ? directories["DOCUMENTS"]
+                                                   : GetHome();
+  paths.downloads = directories.count("DOWNLOAD") ? directories["DOWNLOAD"]
+                                                  : GetHome();
+  return paths;
+}
+}  // namespace
+
+// static
+const XdgPaths& XdgPaths::Get(const std::string& application_id) {
+  static const XdgPaths paths = Resolve(application_id);
+  return paths;
+}
+
+// The paths of XdgPaths::Get(), as PathProviderPaths of
+// path_provider_elinux.dart.
+struct PathProviderPaths {
+  const char* temporary;
+  const char* application_support;
+  const char* application_cache;
+  const char* documents;
+  const char* downloads;
+};
+
+extern "C" __attribute__((visibility("default"))) const PathProviderPaths*
+path_provider_get_paths(const char* application_id) {
+  static const PathProviderPaths paths = [application_id]() {
+    const auto& xdg_paths = XdgPaths::Get(application_id ? application_id : "");
+    return PathProviderPaths{
+        xdg_paths.temporary.c_str(), xdg_paths.application_support.c_str(),
+        xdg_paths.application_cache.c_str(), xdg_paths.documents.c_str(),
+        xdg_paths.downloads.c_str()};
+  }();
+  return &paths;
+}
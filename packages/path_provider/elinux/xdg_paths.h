@@ -0,0 +1,27 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_PATH_PROVIDER_PATH_PROVIDER_ELINUX_XDG_PATHS_H_
+#define PACKAGES_PATH_PROVIDER_PATH_PROVIDER_ELINUX_XDG_PATHS_H_
+
+#include <string>
+
+// The directories of path_provider, as PathProviderELinux resolves them from
+// the XDG base and user directories.
+struct XdgPaths {
+  std::string temporary;
+  // Created if missing.
+  std::string application_support;
+  std::string application_cache;
+  // As xdg-user-dir gives them, from user-dirs.dirs.
+  std::string documents;
+  std::string downloads;
+
+  // Resolves all the paths and creates the missing directories the first
+  // time, with |application_id| or the name of the executable if empty, then
+  // returns the same paths for the lifetime of the process. Thread-safe.
+  static const XdgPaths& Get(const std::string& application_id);
+};
+
+#endif  // PACKAGES_PATH_PROVIDER_PATH_PROVIDER_ELINUX_XDG_PATHS_H_
@@ -0,0 +1,66 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+/// See PathProviderPaths in xdg_paths.cc.
+class _PathProviderPaths extends Struct {
+  external Pointer<Utf8> temporary;
+  external Pointer<Utf8> applicationSupport;
+  external Pointer<Utf8> applicationCache;
+  external Pointer<Utf8> documents;
+  external Pointer<Utf8> downloads;
+}
+
+typedef _GetPathsNative = Pointer<_PathProviderPaths> Function(
+    Pointer<Utf8> applicationId);
+typedef _GetPaths = Pointer<_PathProviderPaths> Function(
+    Pointer<Utf8> applicationId);
+
+/// The directories resolved by the native helper of xdg_paths.h, in one call
+/// that also creates the missing directories, once per process.
+class NativePaths {
+  NativePaths._(_PathProviderPaths paths)
+      : temporary = paths.temporary.toDartString(),
+        applicationSupport = paths.applicationSupport.toDartString(),
+        applicationCache = paths.applicationCache.toDartString(),
+        documents = paths.documents.toDartString(),
+        downloads = paths.downloads.toDartString();
+
+  final String temporary;
+  final String applicationSupport;
+  final String applicationCache;
+  final String documents;
+  final String downloads;
+
+  /// Returns the paths of the application [applicationId], or of the
+  /// executable if null. The first call decides for the whole process.
+  /// Returns null if the plugin library isn't there, e.g. in unit tests.
+  static NativePaths? get(String? applicationId) {
+    if (_instance != null || _getPaths == null) {
+      return _instance;
+    }
+    final Pointer<Utf8> id =
+        applicationId != null ? applicationId.toNativeUtf8() : nullptr;
+    _instance = NativePaths._(_getPaths!(id).ref);
+    if (id != nullptr) {
+      calloc.free(id);
+    }
+    return _instance;
+  }
+
+  static NativePaths? _instance;
+
+  static final _GetPaths? _getPaths = () {
+    try {
+      return DynamicLibrary.open('libpath_provider_elinux_plugin.so')
+          .lookupFunction<_GetPathsNative, _GetPaths>(
+              'path_provider_get_paths');
+    } on ArgumentError {
+      return null;
+    }
+  }();
+}
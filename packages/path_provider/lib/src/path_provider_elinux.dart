@@ -11,13 +11,16 @@ import 'package:path_provider_platform_interface/path_provider_platform_interfac
 import 'package:xdg_directories/xdg_directories.dart' as xdg;
 
 import 'get_application_id.dart';
+import 'native_paths.dart';
 
 /// The elinux implementation of [PathProviderPlatform]
 ///
 /// This class implements the `package:path_provider` functionality for eLinux
 class PathProviderELinux extends PathProviderPlatform {
   /// Constructs an instance of [PathProviderELinux]
-  PathProviderELinux() : _environment = Platform.environment;
+  PathProviderELinux()
+      : _environment = Platform.environment,
+        _useNativePaths = true;
 
   /// Constructs an instance of [PathProviderELinux] with the given [environment]
   @visibleForTesting
@@ -27,9 +30,13 @@ class PathProviderELinux extends PathProviderPlatform {
       String? applicationId})
       : _environment = environment,
         _executableName = executableName,
-        _applicationId = applicationId;
+        _applicationId = applicationId,
+        _useNativePaths = false;
 
   final Map<String, String> _environment;
+  // Whether the paths come from the native helper, which caches them for the
+  // process, where the plugin library is there.
+  final bool _useNativePaths;
   String? _executableName;
   String? _applicationId;
 
@@ -38,8 +45,20 @@ class PathProviderELinux extends PathProviderPlatform {
     PathProviderPlatform.instance = PathProviderELinux();
   }
 
+  NativePaths? _getNativePaths() {
+    if (!_useNativePaths) {
+      return null;
+    }
+    _applicationId ??= getApplicationId();
+    return NativePaths.get(_applicationId);
+  }
+
   @override
   Future<String?> getTemporaryPath() {
+    final NativePaths? paths = _getNativePaths();
+    if (paths != null) {
+      return Future<String?>.value(paths.temporary);
+    }
     final String environmentTmpDir = _environment['TMPDIR'] ?? '';
     return Future<String?>.value(
       environmentTmpDir.isEmpty ? '/tmp' : environmentTmpDir,
@@ -48,6 +67,10 @@ class PathProviderELinux extends PathProviderPlatform {
 
   @override
   Future<String?> getApplicationSupportPath() async {
+    final NativePaths? paths = _getNativePaths();
+    if (paths != null) {
+      return paths.applicationSupport;
+    }
     final Directory directory =
         Directory(path.join(xdg.dataHome.path, await _getId()));
     if (directory.existsSync()) {
@@ -69,11 +92,19 @@ class PathProviderELinux extends PathProviderPlatform {
 
   @override
   Future<String?> getApplicationDocumentsPath() {
+    final NativePaths? paths = _getNativePaths();
+    if (paths != null) {
+      return Future<String?>.value(paths.documents);
+    }
     return Future<String?>.value(xdg.getUserDirectory('DOCUMENTS')?.path);
   }
 
   @override
   Future<String?> getApplicationCachePath() async {
+    final NativePaths? paths = _getNativePaths();
+    if (paths != null) {
+      return paths.applicationCache;
+    }
     final Directory directory =
         Directory(path.join(xdg.cacheHome.path, await _getId()));
     if (!directory.existsSync()) {
@@ -84,6 +115,10 @@ class PathProviderELinux extends PathProviderPlatform {
 
   @override
   Future<String?> getDownloadsPath() {
+    final NativePaths? paths = _getNativePaths();
+    if (paths != null) {
+      return Future<String?>.value(paths.downloads);
+    }
     return Future<String?>.value(xdg.getUserDirectory('DOWNLOAD')?.path);
   }
 
@@ -0,0 +1,64 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "file_util.h"
+
+#include <fcntl.h>
+#include <libgen.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+// Makes the rename of a file in |path|'s directory durable.
+void SyncDirectory(const std::string& path) {
+  std::vector<char> buffer(path.begin(), path.end());
+  buffer.push_back('\0');
+  const int fd = open(dirname(buffer.data()), O_RDONLY | O_DIRECTORY);
+  if (fd >= 0) {
+    fsync(fd);
+    close(fd);
+  }
+}
+}  // namespace
+
+bool WriteAll(int fd, const uint8_t* data, size_t size) {
+  while (size > 0) {
+    const auto written = write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+int ReplaceFile(const std::string& path, const uint8_t* data, size_t size) {
+  const auto temporary_path = path + ".tmp";
+  const int fd = open(temporary_path.c_str(),
+                      O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    std::cerr << "Failed to open " << temporary_path << ": "
+              << std::strerror(errno) << std::endl;
+    return -1;
+  }
+  if (!WriteAll(fd, data, size) || fdatasync(fd) < 0 ||
+      rename(temporary_path.c_str(), path.c_str()) < 0) {
+    std::cerr << "Failed to replace " << path << ": " << std::strerror(errno)
+              << std::endl;
+    close(fd);
+    unlink(temporary_path.c_str());
+    return -1;
+  }
+  SyncDirectory(path);
+  return fd;
+}
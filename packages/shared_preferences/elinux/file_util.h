@@ -0,0 +1,21 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_FILE_UTIL_H_
+#define PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_FILE_UTIL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Writes all of |data|, retrying after interruptions.
+bool WriteAll(int fd, const uint8_t* data, size_t size);
+
+// Replaces the file at |path| with |data| such that a crash leaves either the
+// old or the new contents: they are written and synced to a temporary file
+// next to it, which is then renamed over it. Returns the descriptor of the
+// new file, open for writing at its end, or -1 on failure.
+int ReplaceFile(const std::string& path, const uint8_t* data, size_t size);
+
+#endif  // PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_FILE_UTIL_H_
@@ -0,0 +1,76 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "json_file_writer.h"
+
+#include <unistd.h>
+
+#include <utility>
+
+#include "file_util.h"
+
+JsonFileWriter::JsonFileWriter(const std::string& path, int64_t port,
+                               PostCObject post_cobject)
+    : path_(path), port_(port), post_cobject_(post_cobject) {
+  thread_ = std::thread([this]() { Run(); });
+}
+
+JsonFileWriter::~JsonFileWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+int64_t JsonFileWriter::Write(std::string contents) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_ = std::move(contents);
+  has_pending_ = true;
+  cv_.notify_one();
+  return ++sequence_;
+}
+
+void JsonFileWriter::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return has_pending_ || is_stopping_; });
+    if (!has_pending_) {
+      break;
+    }
+    // The writes of the window replace |pending_| meanwhile.
+    cv_.wait_for(lock, kCoalescingWindow, [this]() { return is_stopping_; });
+    const auto contents = std::move(pending_);
+    const auto sequence = sequence_;
+    pending_.clear();
+    has_pending_ = false;
+    lock.unlock();
+    const int fd = ReplaceFile(
+        path_, reinterpret_cast<const uint8_t*>(contents.data()),
+        contents.size());
+    if (fd >= 0) {
+      close(fd);
+    }
+    PostInt64(post_cobject_, port_, fd >= 0 ? sequence : -sequence);
+    lock.lock();
+  }
+}
+
+extern "C" __attribute__((visibility("default"))) JsonFileWriter*
+json_file_writer_create(const char* path, int64_t port, void* post_cobject) {
+  return new JsonFileWriter(path, port,
+                            reinterpret_cast<PostCObject>(post_cobject));
+}
+
+extern "C" __attribute__((visibility("default"))) void
+json_file_writer_destroy(JsonFileWriter* writer) {
+  delete writer;
+}
+
+extern "C" __attribute__((visibility("default"))) int64_t
+json_file_writer_write(JsonFileWriter* writer, const char* contents,
+                       int64_t size) {
+  return writer->Write(std::string(contents, static_cast<size_t>(size)));
+}
@@ -0,0 +1,63 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_JSON_FILE_WRITER_H_
+#define PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_JSON_FILE_WRITER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "native_port.h"
+
+// Writes the JSON file of the preferences on a thread of its own, for the
+// apps that keep that format rather than the log of PreferencesStore.
+//
+// The contents given within kCoalescingWindow of each other are coalesced
+// into the latest, so a burst of writes replaces the file once. The file is
+// replaced through ReplaceFile(), so a power loss leaves either version.
+class JsonFileWriter {
+ public:
+  static constexpr auto kCoalescingWindow = std::chrono::milliseconds(100);
+
+  // The sequence number of each write is posted to |port| once the file has
+  // been replaced, negated if it couldn't be.
+  JsonFileWriter(const std::string& path, int64_t port,
+                 PostCObject post_cobject);
+
+  // Writes the pending contents.
+  ~JsonFileWriter();
+
+  // Prevent copying.
+  JsonFileWriter(JsonFileWriter const&) = delete;
+  JsonFileWriter& operator=(JsonFileWriter const&) = delete;
+
+  // Queues |contents| to replace those of the file, and returns the sequence
+  // number of the write. Doesn't wait for the disk.
+  int64_t Write(std::string contents);
+
+ private:
+  void Run();
+
+  const std::string path_;
+  const int64_t port_;
+  const PostCObject post_cobject_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Guarded by |mutex_|. The latest contents, if not written yet, and the
+  // sequence number of their write.
+  std::string pending_;
+  bool has_pending_ = false;
+  int64_t sequence_ = 0;
+  bool is_stopping_ = false;
+  std::thread thread_;
+};
+
+#endif  // PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_JSON_FILE_WRITER_H_
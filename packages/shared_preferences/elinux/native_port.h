@@ -0,0 +1,24 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_NATIVE_PORT_H_
+#define PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_NATIVE_PORT_H_
+
+#include <cstdint>
+
+// Dart_PostCObject, as NativeApi.postCObject gives it.
+using PostCObject = bool (*)(int64_t port, void* message);
+
+// Posts |value| to the native |port| of Dart, as an int.
+inline bool PostInt64(PostCObject post_cobject, int64_t port, int64_t value) {
+  // The layout of Dart_CObject of dart_native_api.h, which spares the plugin
+  // the headers of the Dart SDK.
+  struct {
+    int32_t type;
+    int64_t value;
+  } message = {3 /* Dart_CObject_kInt64 */, value};
+  return post_cobject(port, &message);
+}
+
+#endif  // PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_NATIVE_PORT_H_
@@ -0,0 +1,361 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "preferences_store.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include "file_util.h"
+
+namespace {
+constexpr char kMagic[8] = {'F', 'L', 'P', 'R', 'E', 'F', 'S', '1'};
+// The size and the CRC-32 before each payload.
+constexpr size_t kFrameSize = 8;
+// Below which the log is never compacted.
+constexpr size_t kMinCompactionSize = 64 * 1024;
+// fdatasync() once the writes have been quiet for kSyncDelay, or at the
+// latest kMaxSyncDelay after the first unsynced one.
+constexpr auto kSyncDelay = std::chrono::milliseconds(500);
+constexpr auto kMaxSyncDelay = std::chrono::seconds(5);
+
+uint32_t Crc32(const uint8_t* data, size_t size) {
+  static const auto table = []() {
+    std::array<uint32_t, 256> table;
+    for (uint32_t i = 0; i < table.size(); i++) {
+      uint32_t value = i;
+      for (int bit = 0; bit < 8; bit++) {
+        value = (value & 1) ? 0xedb88320 ^ (value >> 1) : value >> 1;
+      }
+      table[i] = value;
+    }
+    return table;
+  }();
+  uint32_t crc = 0xffffffff;
+  for (size_t i = 0; i < size; i++) {
+    crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc ^ 0xffffffff;
+}
+
+uint32_t ReadUint32(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+         static_cast<uint32_t>(data[2]) << 16 |
+         static_cast<uint32_t>(data[3]) << 24;
+}
+
+void AppendUint32(std::vector<uint8_t>& data, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+void AppendRecord(std::vector<uint8_t>& data, const uint8_t* payload,
+                  size_t size) {
+  AppendUint32(data, static_cast<uint32_t>(size));
+  AppendUint32(data, Crc32(payload, size));
+  data.insert(data.end(), payload, payload + size);
+}
+
+// Returns false if |payload| isn't a record of the store.
+bool IsValidRecord(const uint8_t* payload, size_t size) {
+  if (size < 5 || ReadUint32(payload + 1) > size - 5) {
+    return false;
+  }
+  return payload[0] == PreferencesStore::kSet ||
+         payload[0] == PreferencesStore::kRemove;
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<PreferencesStore> PreferencesStore::Open(
+    const std::string& path, int64_t port, PostCObject post_cobject) {
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    std::cerr << "Failed to open " << path << ": " << std::strerror(errno)
+              << std::endl;
+    return nullptr;
+  }
+  auto store = std::unique_ptr<PreferencesStore>(
+      new PreferencesStore(path, fd, port, post_cobject));
+  if (!store->Load()) {
+    return nullptr;
+  }
+  store->thread_ = std::thread([store = store.get()]() { store->Run(); });
+  return store;
+}
+
+PreferencesStore::PreferencesStore(const std::string& path, int fd,
+                                   int64_t port, PostCObject post_cobject)
+    : path_(path), fd_(fd), port_(port), post_cobject_(post_cobject) {}
+
+PreferencesStore::~PreferencesStore() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  close(fd_);
+}
+
+std::vector<uint8_t> PreferencesStore::GetSnapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<uint8_t> snapshot;
+  snapshot.reserve(live_size_);
+  for (const auto& record : records_) {
+    AppendUint32(snapshot, static_cast<uint32_t>(record.second.size()));
+    snapshot.insert(snapshot.end(), record.second.begin(),
+                    record.second.end());
+  }
+  return snapshot;
+}
+
+int64_t PreferencesStore::Write(const uint8_t* data, size_t size) {
+  std::vector<uint8_t> framed;
+  framed.reserve(size + size / 4);
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Validated as a whole before any record is applied.
+  for (size_t offset = 0; offset < size;) {
+    if (size - offset < 4 || ReadUint32(data + offset) > size - offset - 4 ||
+        !IsValidRecord(data + offset + 4, ReadUint32(data + offset))) {
+      return -1;
+    }
+    offset += 4 + ReadUint32(data + offset);
+  }
+  for (size_t offset = 0; offset < size;) {
+    const auto payload_size = ReadUint32(data + offset);
+    const auto* payload = data + offset + 4;
+    Apply(payload, payload_size);
+    AppendRecord(framed, payload, payload_size);
+    offset += 4 + payload_size;
+  }
+  pending_.insert(pending_.end(), framed.begin(), framed.end());
+  const auto sequence = ++sequence_;
+  cv_.notify_one();
+  return sequence;
+}
+
+bool PreferencesStore::Load() {
+  struct stat status;
+  if (fstat(fd_, &status) < 0) {
+    std::cerr << "Failed to stat " << path_ << ": " << std::strerror(errno)
+              << std::endl;
+    return false;
+  }
+  const auto file_size = static_cast<size_t>(status.st_size);
+  size_t end = 0;
+  if (file_size >= sizeof(kMagic)) {
+    void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (mapping == MAP_FAILED) {
+      std::cerr << "Failed to map " << path_ << ": " << std::strerror(errno)
+                << std::endl;
+      return false;
+    }
+    const auto* data = static_cast<const uint8_t*>(mapping);
+    if (std::memcmp(data, kMagic, sizeof(kMagic))) {
+      std::cerr << path_ << " isn't a preferences log" << std::endl;
+      munmap(mapping, file_size);
+      return false;
+    }
+    madvise(mapping, file_size, MADV_SEQUENTIAL);
+    end = sizeof(kMagic);
+    while (file_size - end >= kFrameSize) {
+      const auto size = ReadUint32(data + end);
+      const auto* payload = data + end + kFrameSize;
+      if (size > file_size - end - kFrameSize ||
+          Crc32(payload, size) != ReadUint32(data + end + 4) ||
+          !IsValidRecord(payload, size)) {
+        break;
+      }
+      Apply(payload, size);
+      end += kFrameSize + size;
+    }
+    munmap(mapping, file_size);
+  }
+
+  if (end < sizeof(kMagic)) {
+    // New, or cut before the end of the magic.
+    if (ftruncate(fd_, 0) < 0 ||
+        !WriteAll(fd_, reinterpret_cast<const uint8_t*>(kMagic),
+                  sizeof(kMagic))) {
+      std::cerr << "Failed to initialize " << path_ << ": "
+                << std::strerror(errno) << std::endl;
+      return false;
+    }
+    end = sizeof(kMagic);
+  } else if (end < file_size) {
+    std::cerr << "Dropping the last " << file_size - end << " bytes of "
+              << path_ << ", which are incomplete" << std::endl;
+    if (ftruncate(fd_, end) < 0) {
+      std::cerr << "Failed to truncate " << path_ << ": "
+                << std::strerror(errno) << std::endl;
+      return false;
+    }
+  }
+  if (lseek(fd_, end, SEEK_SET) < 0) {
+    return false;
+  }
+  log_size_ = end;
+  return true;
+}
+
+void PreferencesStore::Apply(const uint8_t* payload, size_t size) {
+  const auto key_size = ReadUint32(payload + 1);
+  std::string key(reinterpret_cast<const char*>(payload + 5), key_size);
+  auto it = records_.find(key);
+  if (it != records_.end()) {
+    live_size_ -= kFrameSize + it->second.size();
+    records_.erase(it);
+  }
+  if (payload[0] == kSet) {
+    live_size_ += kFrameSize + size;
+    records_.emplace(std::move(key),
+                     std::vector<uint8_t>(payload, payload + size));
+  }
+}
+
+void PreferencesStore::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (pending_.empty()) {
+      if (is_stopping_) {
+        break;
+      }
+      if (!is_dirty_) {
+        cv_.wait(lock);
+        continue;
+      }
+      const auto deadline = std::min(last_write_ + kSyncDelay,
+                                     first_unsynced_write_ + kMaxSyncDelay);
+      if (cv_.wait_until(lock, deadline) == std::cv_status::timeout &&
+          pending_.empty()) {
+        lock.unlock();
+        Sync();
+        lock.lock();
+      }
+      continue;
+    }
+
+    std::vector<uint8_t> data;
+    data.swap(pending_);
+    const auto sequence = sequence_;
+    const bool should_compact = log_size_ + data.size() >= kMinCompactionSize &&
+                                log_size_ + data.size() > 2 * live_size_;
+    lock.unlock();
+    // A burst of writes queued meanwhile goes in one write().
+    const bool written = Append(data);
+    if (written && should_compact) {
+      Compact();
+    }
+    PostResult(written ? sequence : -sequence);
+    lock.lock();
+  }
+  lock.unlock();
+  Sync();
+}
+
+bool PreferencesStore::Append(const std::vector<uint8_t>& data) {
+  if (!WriteAll(fd_, data.data(), data.size())) {
+    std::cerr << "Failed to write " << path_ << ": " << std::strerror(errno)
+              << std::endl;
+    // A partial record is dropped the next time the log is loaded, but the
+    // following ones would be too.
+    if (ftruncate(fd_, log_size_) < 0 || lseek(fd_, log_size_, SEEK_SET) < 0) {
+      std::cerr << "Failed to truncate " << path_ << ": "
+                << std::strerror(errno) << std::endl;
+    }
+    return false;
+  }
+  log_size_ += data.size();
+  const auto now = std::chrono::steady_clock::now();
+  if (!is_dirty_) {
+    is_dirty_ = true;
+    first_unsynced_write_ = now;
+  }
+  last_write_ = now;
+  return true;
+}
+
+bool PreferencesStore::Compact() {
+  std::vector<uint8_t> data(kMagic, kMagic + sizeof(kMagic));
+  {
+    // The records queued since are in |records_| already, and are appended
+    // again after the rewrite, which replays to the same values.
+    std::lock_guard<std::mutex> lock(mutex_);
+    data.reserve(sizeof(kMagic) + live_size_);
+    for (const auto& record : records_) {
+      AppendRecord(data, record.second.data(), record.second.size());
+    }
+  }
+
+  const int fd = ReplaceFile(path_, data.data(), data.size());
+  if (fd < 0) {
+    return false;
+  }
+  close(fd_);
+  fd_ = fd;
+  log_size_ = data.size();
+  is_dirty_ = false;
+  return true;
+}
+
+void PreferencesStore::Sync() {
+  if (!is_dirty_) {
+    return;
+  }
+  if (fdatasync(fd_) < 0) {
+    std::cerr << "Failed to sync " << path_ << ": " << std::strerror(errno)
+              << std::endl;
+  }
+  is_dirty_ = false;
+}
+
+void PreferencesStore::PostResult(int64_t sequence) {
+  PostInt64(post_cobject_, port_, sequence);
+}
+
+extern "C" __attribute__((visibility("default"))) PreferencesStore*
+preferences_store_open(const char* path, int64_t port, void* post_cobject) {
+  return PreferencesStore::Open(
+             path, port,
+             reinterpret_cast<PostCObject>(post_cobject))
+      .release();
+}
+
+extern "C" __attribute__((visibility("default"))) void preferences_store_close(
+    PreferencesStore* store) {
+  delete store;
+}
+
+// Returns the snapshot in a buffer to free with preferences_store_free().
+extern "C" __attribute__((visibility("default"))) uint8_t*
+preferences_store_snapshot(PreferencesStore* store, int64_t* size) {
+  const auto snapshot = store->GetSnapshot();
+  *size = static_cast<int64_t>(snapshot.size());
+  auto* data = new uint8_t[snapshot.size() + 1];
+  std::memcpy(data, snapshot.data(), snapshot.size());
+  return data;
+}
+
+extern "C" __attribute__((visibility("default"))) void preferences_store_free(
+    uint8_t* data) {
+  delete[] data;
+}
+
+extern "C" __attribute__((visibility("default"))) int64_t
+preferences_store_write(PreferencesStore* store, const uint8_t* data,
+                        int64_t size) {
+  return store->Write(data, static_cast<size_t>(size));
+}
@@ -0,0 +1,105 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_PREFERENCES_STORE_H_
+#define PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_PREFERENCES_STORE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "native_port.h"
+
+// Stores the preferences in a log of records, appended to by a thread of its
+// own.
+//
+// Each record sets or removes a key, so a write costs the size of the value
+// rather than of all the preferences. The log is read at once through mmap()
+// when opened, replaying the records, and rewritten with the live ones only
+// once it has grown to twice their size. fdatasync() waits until the writes
+// have been quiet for a while, so a burst of them is synced once.
+//
+// A record is a uint32 size and a uint32 CRC-32 of the payload, followed by
+// the payload:
+//   uint8 operation, kSet or kRemove
+//   uint32 key size, key in UTF-8
+//   for kSet, the value, whose encoding is opaque to the store
+// All the integers are little-endian. A record cut short by a crash, or
+// corrupted, ends the log where it starts.
+class PreferencesStore {
+ public:
+  static constexpr uint8_t kSet = 1;
+  static constexpr uint8_t kRemove = 2;
+
+  // Opens or creates the log at |path|. The sequence number of each write is
+  // posted to |port| once the write is in the log, negated if it failed.
+  // Returns nullptr if the log can't be opened.
+  static std::unique_ptr<PreferencesStore> Open(const std::string& path,
+                                                int64_t port,
+                                                PostCObject post_cobject);
+
+  // Writes and syncs the pending records.
+  ~PreferencesStore();
+
+  // Prevent copying.
+  PreferencesStore(PreferencesStore const&) = delete;
+  PreferencesStore& operator=(PreferencesStore const&) = delete;
+
+  // The payloads of the live records, each after its size as a uint32.
+  std::vector<uint8_t> GetSnapshot() const;
+
+  // Queues the payloads of |data|, each after its size as a uint32, and
+  // returns the sequence number of the write, or -1 if |data| is malformed.
+  // Doesn't wait for the disk.
+  int64_t Write(const uint8_t* data, size_t size);
+
+ private:
+  PreferencesStore(const std::string& path, int fd, int64_t port,
+                   PostCObject post_cobject);
+
+  // Replays the log, and cuts it after the last valid record.
+  bool Load();
+  // Applies the valid record of |payload| to |records_|.
+  void Apply(const uint8_t* payload, size_t size);
+
+  void Run();
+  bool Append(const std::vector<uint8_t>& data);
+  // Rewrites the log with the live records only, then replaces it.
+  bool Compact();
+  void Sync();
+  void PostResult(int64_t sequence);
+
+  const std::string path_;
+  int fd_;
+  const int64_t port_;
+  const PostCObject post_cobject_;
+  // The size of the log, used by the writer thread only after Load().
+  size_t log_size_ = 0;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  // Guarded by |mutex_|. The latest kSet payload of each key, and the sum of
+  // their framed sizes.
+  std::map<std::string, std::vector<uint8_t>> records_;
+  size_t live_size_ = 0;
+  // Guarded by |mutex_|. The framed records not written yet, and the
+  // sequence number of the latest write.
+  std::vector<uint8_t> pending_;
+  int64_t sequence_ = 0;
+  bool is_stopping_ = false;
+  // Used by the writer thread only.
+  bool is_dirty_ = false;
+  std::chrono::steady_clock::time_point first_unsynced_write_;
+  std::chrono::steady_clock::time_point last_write_;
+  std::thread thread_;
+};
+
+#endif  // PACKAGES_SHARED_PREFERENCES_SHARED_PREFERENCES_ELINUX_PREFERENCES_STORE_H_
@@ -14,6 +14,9 @@ import 'package:path_provider_elinux/path_provider_elinux.dart';
 import 'package:shared_preferences_platform_interface/shared_preferences_platform_interface.dart';
 import 'package:shared_preferences_platform_interface/types.dart';
 
+import 'src/json_file_writer.dart';
+import 'src/preferences_store.dart';
+
 /// The Linux implementation of [SharedPreferencesStorePlatform].
 ///
 /// This class implements the `package:shared_preferences` functionality for Linux.
@@ -25,6 +28,11 @@ class SharedPreferencesELinux extends SharedPreferencesStorePlatform {
 
   static const String _defaultPrefix = 'flutter.';
 
+  /// Whether the preferences are kept in shared_preferences.json, as the
+  /// earlier versions kept them, e.g. for the tools reading that file,
+  /// rather than in the binary log. Must be set before the first access.
+  static bool useJsonFile = false;
+
   /// Registers the ELinux implementation.
   static void registerWith() {
     SharedPreferencesStorePlatform.instance = SharedPreferencesELinux();
@@ -33,6 +41,18 @@ class SharedPreferencesELinux extends SharedPreferencesStorePlatform {
   /// Local copy of preferences
   Map<String, Object>? _cachedPreferences;
 
+  /// The native log the preferences are written to, or null if they are
+  /// written to the JSON file.
+  PreferencesStore? _store;
+
+  /// The opening of [_store], which the calls made meanwhile wait for, so
+  /// that the log is opened and migrated once.
+  Future<PreferencesStore?>? _openingStore;
+
+  /// The write of the JSON file scheduled, which the writes made until it
+  /// runs share.
+  Future<bool>? _pendingWrite;
+
   /// File system used to store to disk. Exposed for testing only.
   @visibleForTesting
   FileSystem fs = const LocalFileSystem();
@@ -50,19 +70,60 @@ class SharedPreferencesELinux extends SharedPreferencesStorePlatform {
     return fs.file(path.join(directory, 'shared_preferences.json'));
   }
 
-  /// Gets the preferences from the stored file and saves them in cache.
-  Future<Map<String, Object>> _reload() async {
-    Map<String, Object> preferences = <String, Object>{};
-    final File? localDataFile = await _getLocalDataFile();
-    if (localDataFile != null && localDataFile.existsSync()) {
-      final String stringMap = localDataFile.readAsStringSync();
+  /// Opens the native log of the preferences, migrating those of the JSON
+  /// file the first time. Returns null if the plugin library isn't there, or
+  /// the file system is a fake one.
+  Future<PreferencesStore?> _openStore() async {
+    if (useJsonFile || fs is! LocalFileSystem) {
+      return null;
+    }
+    final String? directory = await pathProvider.getApplicationSupportPath();
+    if (directory == null) {
+      return null;
+    }
+    final File log = fs.file(path.join(directory, 'shared_preferences.log'));
+    final bool isNew = !log.existsSync();
+    if (isNew) {
+      log.parent.createSync(recursive: true);
+    }
+    final PreferencesStore? store = PreferencesStore.open(log.path);
+    if (store == null || !isNew) {
+      return store;
+    }
+    // The JSON file is left in place, and ignored from now on.
+    final Map<String, Object> preferences = _readJsonFile(
+        fs.file(path.join(directory, 'shared_preferences.json')));
+    if (preferences.isNotEmpty && !await store.setAll(preferences)) {
+      debugPrint('Error migrating preferences to ${log.path}');
+    }
+    return store;
+  }
+
+  Map<String, Object> _readJsonFile(File file) {
+    if (file.existsSync()) {
+      final String stringMap = file.readAsStringSync();
       if (stringMap.isNotEmpty) {
         final Object? data = json.decode(stringMap);
         if (data is Map) {
-          preferences = data.cast<String, Object>();
+          return data.cast<String, Object>();
         }
       }
     }
+    return <String, Object>{};
+  }
+
+  /// Gets the preferences from the stored file and saves them in cache.
+  Future<Map<String, Object>> _reload() async {
+    _store = await (_openingStore ??= _openStore());
+    if (_store != null) {
+      final Map<String, Object> preferences = _store!.load();
+      _cachedPreferences = preferences;
+      return preferences;
+    }
+    final File? localDataFile = await _getLocalDataFile();
+    final Map<String, Object> preferences = localDataFile != null
+        ? _readJsonFile(localDataFile)
+        : <String, Object>{};
     _cachedPreferences = preferences;
     return preferences;
   }
@@ -75,18 +136,38 @@ class SharedPreferencesELinux extends SharedPreferencesStorePlatform {
 
   /// Writes the cached preferences to disk. Returns [true] if the operation
   /// succeeded.
-  Future<bool> _writePreferences(Map<String, Object> preferences) async {
+  ///
+  /// The writes made until the end of the current event are coalesced into
+  /// one, of the latest preferences.
+  Future<bool> _writePreferences(Map<String, Object> preferences) {
+    return _pendingWrite ??= Future<bool>(() {
+      _pendingWrite = null;
+      return _writeJsonFile(preferences);
+    });
+  }
+
+  /// Replaces the JSON file such that a crash leaves either the previous or
+  /// the new preferences in it, from the native writer where available.
+  Future<bool> _writeJsonFile(Map<String, Object> preferences) async {
     try {
       final File? localDataFile = await _getLocalDataFile();
       if (localDataFile == null) {
         debugPrint('Unable to determine where to write preferences.');
         return false;
       }
-      if (!localDataFile.existsSync()) {
-        localDataFile.createSync(recursive: true);
+      if (!localDataFile.parent.existsSync()) {
+        localDataFile.parent.createSync(recursive: true);
       }
       final String stringMap = json.encode(preferences);
-      localDataFile.writeAsStringSync(stringMap);
+      final JsonFileWriter? writer = fs is LocalFileSystem
+          ? JsonFileWriter.create(localDataFile.path)
+          : null;
+      if (writer != null) {
+        return writer.write(stringMap);
+      }
+      final File temporaryFile = fs.file('${localDataFile.path}.tmp');
+      temporaryFile.writeAsStringSync(stringMap, flush: true);
+      temporaryFile.renameSync(localDataFile.path);
     } catch (e) {
       debugPrint('Error saving preferences to disk: $e');
       return false;
@@ -113,9 +194,15 @@ class SharedPreferencesELinux extends SharedPreferencesStorePlatform {
   Future<bool> clearWithParameters(ClearParameters parameters) async {
     final PreferencesFilter filter = parameters.filter;
     final Map<String, Object> preferences = await _readPreferences();
-    preferences.removeWhere((String key, _) =>
+    bool isCleared(String key) =>
         key.startsWith(filter.prefix) &&
-        (filter.allowList == null || filter.allowList!.contains(key)));
+        (filter.allowList == null || filter.allowList!.contains(key));
+    if (_store != null) {
+      final List<String> keys = preferences.keys.where(isCleared).toList();
+      preferences.removeWhere((String key, _) => isCleared(key));
+      return _store!.removeAll(keys);
+    }
+    preferences.removeWhere((String key, _) => isCleared(key));
     return _writePreferences(preferences);
   }
 
@@ -149,6 +236,9 @@ class SharedPreferencesELinux extends SharedPreferencesStorePlatform {
   Future<bool> remove(String key) async {
     final Map<String, Object> preferences = await _readPreferences();
     preferences.remove(key);
+    if (_store != null) {
+      return _store!.removeAll(<String>[key]);
+    }
     return _writePreferences(preferences);
   }
 
@@ -156,6 +246,9 @@ class SharedPreferencesELinux extends SharedPreferencesStorePlatform {
   Future<bool> setValue(String valueType, String key, Object value) async {
     final Map<String, Object> preferences = await _readPreferences();
     preferences[key] = value;
+    if (_store != null) {
+      return _store!.setAll(<String, Object>{key: value});
+    }
     return _writePreferences(preferences);
   }
 }
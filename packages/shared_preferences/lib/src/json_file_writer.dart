@@ -0,0 +1,63 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:convert' show utf8;
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import 'native_writes.dart';
+
+typedef _CreateNative = Pointer<Void> Function(
+    Pointer<Utf8> path, Int64 port, Pointer<Void> postCObject);
+typedef _Create = Pointer<Void> Function(
+    Pointer<Utf8> path, int port, Pointer<Void> postCObject);
+typedef _WriteNative = Int64 Function(
+    Pointer<Void>, Pointer<Uint8> contents, Int64 size);
+typedef _Write = int Function(Pointer<Void>, Pointer<Uint8> contents, int size);
+
+/// Replaces the JSON file of the preferences through the native writer of
+/// json_file_writer.h, off the UI thread, once per burst of writes.
+class JsonFileWriter {
+  JsonFileWriter._(this._writer, this._writes);
+
+  /// Returns the writer of [path], once per isolate, or null if the plugin
+  /// library isn't available.
+  static JsonFileWriter? create(String path) {
+    if (_create == null) {
+      return null;
+    }
+    return _writers.putIfAbsent(path, () {
+      final NativeWrites writes = NativeWrites();
+      final Pointer<Utf8> nativePath = path.toNativeUtf8();
+      final Pointer<Void> writer = _create!(
+          nativePath, writes.nativePort, NativeApi.postCObject.cast<Void>());
+      calloc.free(nativePath);
+      return JsonFileWriter._(writer, writes);
+    });
+  }
+
+  static final _Create? _create = pluginLibrary
+      ?.lookup<NativeFunction<_CreateNative>>('json_file_writer_create')
+      .asFunction();
+  static final _Write? _write = pluginLibrary
+      ?.lookup<NativeFunction<_WriteNative>>('json_file_writer_write')
+      .asFunction();
+  static final Map<String, JsonFileWriter> _writers =
+      <String, JsonFileWriter>{};
+
+  final Pointer<Void> _writer;
+  final NativeWrites _writes;
+
+  /// Replaces the contents of the file with [contents]. Completes with false
+  /// if the file couldn't be replaced.
+  Future<bool> write(String contents) {
+    final List<int> encoded = utf8.encode(contents);
+    final Pointer<Uint8> data = calloc<Uint8>(encoded.length);
+    data.asTypedList(encoded.length).setAll(0, encoded);
+    final int sequence = _write!(_writer, data, encoded.length);
+    calloc.free(data);
+    return _writes.add(sequence);
+  }
+}
@@ -0,0 +1,55 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:async';
+import 'dart:ffi';
+import 'dart:isolate';
+
+/// The library of the plugin, or null if it isn't there, e.g. in unit tests.
+final DynamicLibrary? pluginLibrary = () {
+  try {
+    return DynamicLibrary.open('libshared_preferences_elinux_plugin.so');
+  } on ArgumentError {
+    return null;
+  }
+}();
+
+/// Completes the writes of a native writer, which posts the sequence number
+/// of each write to [nativePort] once it is done, negated if it failed.
+class NativeWrites {
+  NativeWrites() {
+    _port.listen(_onWritten);
+  }
+
+  final ReceivePort _port = ReceivePort();
+  final Map<int, Completer<bool>> _writes = <int, Completer<bool>>{};
+
+  int get nativePort => _port.sendPort.nativePort;
+
+  /// Returns the future of the write [sequence].
+  Future<bool> add(int sequence) {
+    if (sequence < 0) {
+      return Future<bool>.value(false);
+    }
+    final Completer<bool> completer = Completer<bool>();
+    _writes[sequence] = completer;
+    return completer.future;
+  }
+
+  void close() => _port.close();
+
+  /// Completes the writes up to the sequence number [message], which are
+  /// done in order.
+  void _onWritten(dynamic message) {
+    final int sequence = (message as int).abs();
+    final bool succeeded = message > 0;
+    _writes.removeWhere((int key, Completer<bool> completer) {
+      if (key > sequence) {
+        return false;
+      }
+      completer.complete(succeeded);
+      return true;
+    });
+  }
+}
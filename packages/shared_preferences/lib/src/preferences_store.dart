@@ -0,0 +1,270 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:convert' show utf8;
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'native_writes.dart';
+
+typedef _OpenNative = Pointer<Void> Function(
+    Pointer<Utf8> path, Int64 port, Pointer<Void> postCObject);
+typedef _Open = Pointer<Void> Function(
+    Pointer<Utf8> path, int port, Pointer<Void> postCObject);
+typedef _SnapshotNative = Pointer<Uint8> Function(
+    Pointer<Void>, Pointer<Int64> size);
+typedef _Snapshot = Pointer<Uint8> Function(
+    Pointer<Void>, Pointer<Int64> size);
+typedef _FreeNative = Void Function(Pointer<Uint8>);
+typedef _Free = void Function(Pointer<Uint8>);
+typedef _CloseNative = Void Function(Pointer<Void>);
+typedef _Close = void Function(Pointer<Void>);
+typedef _WriteNative = Int64 Function(
+    Pointer<Void>, Pointer<Uint8> data, Int64 size);
+typedef _Write = int Function(Pointer<Void>, Pointer<Uint8> data, int size);
+
+class _Bindings {
+  _Bindings(DynamicLibrary library)
+      : open = library
+            .lookup<NativeFunction<_OpenNative>>('preferences_store_open')
+            .asFunction(),
+        snapshot = library
+            .lookup<NativeFunction<_SnapshotNative>>(
+                'preferences_store_snapshot')
+            .asFunction(),
+        close = library
+            .lookup<NativeFunction<_CloseNative>>('preferences_store_close')
+            .asFunction(),
+        free = library
+            .lookup<NativeFunction<_FreeNative>>('preferences_store_free')
+            .asFunction(),
+        write = library
+            .lookup<NativeFunction<_WriteNative>>('preferences_store_write')
+            .asFunction();
+
+  final _Open open;
+  final _Snapshot snapshot;
+  final _Close close;
+  final _Free free;
+  final _Write write;
+
+  /// Null if the plugin library isn't there.
+  static final _Bindings? instance =
+      pluginLibrary != null ? _Bindings(pluginLibrary!) : null;
+}
+
+/// The preferences stored by the native log of preferences_store.h, which
+/// writes only the preferences that change, off the UI thread.
+class PreferencesStore {
+  PreferencesStore._(this._path, this._bindings, this._store, this._writes);
+
+  /// Opens or creates the log at [path], once per isolate. Returns null if
+  /// the plugin library isn't available or the log can't be opened.
+  static PreferencesStore? open(String path) {
+    final _Bindings? bindings = _Bindings.instance;
+    if (bindings == null) {
+      return null;
+    }
+    if (_stores.containsKey(path)) {
+      return _stores[path];
+    }
+    final NativeWrites writes = NativeWrites();
+    final Pointer<Utf8> nativePath = path.toNativeUtf8();
+    final Pointer<Void> store = bindings.open(
+        nativePath, writes.nativePort, NativeApi.postCObject.cast<Void>());
+    calloc.free(nativePath);
+    if (store == nullptr) {
+      writes.close();
+      return null;
+    }
+    return _stores[path] = PreferencesStore._(path, bindings, store, writes);
+  }
+
+  static final Map<String, PreferencesStore> _stores =
+      <String, PreferencesStore>{};
+
+  static const int _set = 1;
+  static const int _remove = 2;
+
+  static const int _bool = 1;
+  static const int _int = 2;
+  static const int _double = 3;
+  static const int _string = 4;
+  static const int _stringList = 5;
+
+  final String _path;
+  final _Bindings _bindings;
+  final Pointer<Void> _store;
+  final NativeWrites _writes;
+
+  /// Reads all the preferences.
+  Map<String, Object> load() {
+    final Pointer<Int64> size = calloc<Int64>();
+    final Pointer<Uint8> data = _bindings.snapshot(_store, size);
+    final Map<String, Object> preferences = <String, Object>{};
+    try {
+      final ByteData bytes =
+          ByteData.sublistView(data.asTypedList(size.value));
+      int offset = 0;
+      while (offset < bytes.lengthInBytes) {
+        final int recordSize = bytes.getUint32(offset, Endian.little);
+        final _Reader reader = _Reader(ByteData.sublistView(
+            bytes, offset + 4, offset + 4 + recordSize));
+        offset += 4 + recordSize;
+        reader.readUint8();
+        final String key = reader.readString();
+        final Object? value = reader.readValue();
+        if (value != null) {
+          preferences[key] = value;
+        }
+      }
+    } finally {
+      _bindings.free(data);
+      calloc.free(size);
+    }
+    return preferences;
+  }
+
+  /// Writes and syncs the pending records, then closes the log, which
+  /// [open] opens again. The writes not completed yet never complete.
+  void close() {
+    _stores.remove(_path);
+    _bindings.close(_store);
+    _writes.close();
+  }
+
+  /// Stores [preferences]. Completes with false if they couldn't be written.
+  Future<bool> setAll(Map<String, Object> preferences) {
+    final BytesBuilder records = BytesBuilder(copy: false);
+    preferences.forEach((String key, Object value) {
+      _addRecord(records, _set, key, value);
+    });
+    return _write(records.takeBytes());
+  }
+
+  /// Removes [keys].
+  Future<bool> removeAll(Iterable<String> keys) {
+    final BytesBuilder records = BytesBuilder(copy: false);
+    for (final String key in keys) {
+      _addRecord(records, _remove, key, null);
+    }
+    return _write(records.takeBytes());
+  }
+
+  Future<bool> _write(Uint8List records) {
+    if (records.isEmpty) {
+      return Future<bool>.value(true);
+    }
+    final Pointer<Uint8> data = calloc<Uint8>(records.length);
+    data.asTypedList(records.length).setAll(0, records);
+    final int sequence = _bindings.write(_store, data, records.length);
+    calloc.free(data);
+    return _writes.add(sequence);
+  }
+
+  static void _addRecord(
+      BytesBuilder records, int operation, String key, Object? value) {
+    final _Writer writer = _Writer();
+    writer.addUint8(operation);
+    writer.addString(key);
+    if (operation == _set) {
+      writer.addValue(value!);
+    }
+    final Uint8List payload = writer.takeBytes();
+    records.add(_Writer.uint32(payload.length));
+    records.add(payload);
+  }
+}
+
+class _Writer {
+  final BytesBuilder _bytes = BytesBuilder(copy: false);
+
+  static Uint8List uint32(int value) =>
+      (ByteData(4)..setUint32(0, value, Endian.little)).buffer.asUint8List();
+
+  void addUint8(int value) => _bytes.addByte(value);
+
+  void addString(String value) {
+    final List<int> encoded = utf8.encode(value);
+    _bytes.add(uint32(encoded.length));
+    _bytes.add(encoded);
+  }
+
+  void addValue(Object value) {
+    if (value is bool) {
+      addUint8(PreferencesStore._bool);
+      addUint8(value ? 1 : 0);
+    } else if (value is int) {
+      addUint8(PreferencesStore._int);
+      _bytes.add((ByteData(8)..setInt64(0, value, Endian.little))
+          .buffer
+          .asUint8List());
+    } else if (value is double) {
+      addUint8(PreferencesStore._double);
+      _bytes.add((ByteData(8)..setFloat64(0, value, Endian.little))
+          .buffer
+          .asUint8List());
+    } else if (value is String) {
+      addUint8(PreferencesStore._string);
+      addString(value);
+    } else if (value is List) {
+      addUint8(PreferencesStore._stringList);
+      _bytes.add(uint32(value.length));
+      for (final Object? element in value) {
+        addString(element! as String);
+      }
+    } else {
+      throw ArgumentError.value(value, 'value', 'Unsupported preference type');
+    }
+  }
+
+  Uint8List takeBytes() => _bytes.takeBytes();
+}
+
+class _Reader {
+  _Reader(this._bytes);
+
+  final ByteData _bytes;
+  int _offset = 0;
+
+  int readUint8() => _bytes.getUint8(_offset++);
+
+  int readUint32() {
+    final int value = _bytes.getUint32(_offset, Endian.little);
+    _offset += 4;
+    return value;
+  }
+
+  String readString() {
+    final int length = readUint32();
+    final String value = utf8.decode(Uint8List.sublistView(
+        _bytes, _offset, _offset + length));
+    _offset += length;
+    return value;
+  }
+
+  /// Returns null for a type written by a later version.
+  Object? readValue() {
+    switch (readUint8()) {
+      case PreferencesStore._bool:
+        return readUint8() != 0;
+      case PreferencesStore._int:
+        final int value = _bytes.getInt64(_offset, Endian.little);
+        _offset += 8;
+        return value;
+      case PreferencesStore._double:
+        final double value = _bytes.getFloat64(_offset, Endian.little);
+        _offset += 8;
+        return value;
+      case PreferencesStore._string:
+        return readString();
+      case PreferencesStore._stringList:
+        final int length = readUint32();
+        return List<String>.generate(length, (int _) => readString());
+    }
+    return null;
+  }
+}
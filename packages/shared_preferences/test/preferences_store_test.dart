@@ -0,0 +1,100 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+import 'dart:io';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:path/path.dart' as path;
+import 'package:shared_preferences_elinux/src/native_writes.dart';
+import 'package:shared_preferences_elinux/src/preferences_store.dart';
+
+/// Tests the native log of elinux/preferences_store.cc, through the plugin
+/// library of an eLinux build, e.g. with
+/// LD_LIBRARY_PATH=<bundle>/lib flutter test. Skipped without it.
+void main() {
+  late Directory directory;
+  late String logPath;
+
+  setUp(() {
+    directory = Directory.systemTemp.createTempSync('preferences_store');
+    logPath = path.join(directory.path, 'shared_preferences.log');
+  });
+
+  tearDown(() {
+    directory.deleteSync(recursive: true);
+  });
+
+  PreferencesStore reopen(PreferencesStore store) {
+    store.close();
+    return PreferencesStore.open(logPath)!;
+  }
+
+  group('PreferencesStore', () {
+    test('replays the log', () async {
+      PreferencesStore store = PreferencesStore.open(logPath)!;
+      expect(
+          await store.setAll(<String, Object>{
+            'String': 'hello world',
+            'Bool': true,
+            'Int': 42,
+            'Double': 3.14159,
+            'StringList': <String>['foo', 'bar'],
+          }),
+          isTrue);
+      expect(await store.setAll(<String, Object>{'Int': 43}), isTrue);
+      expect(await store.removeAll(<String>['Bool']), isTrue);
+
+      store = reopen(store);
+      expect(store.load(), <String, Object>{
+        'String': 'hello world',
+        'Int': 43,
+        'Double': 3.14159,
+        'StringList': <String>['foo', 'bar'],
+      });
+      store.close();
+    });
+
+    test('drops a record cut short', () async {
+      PreferencesStore store = PreferencesStore.open(logPath)!;
+      expect(await store.setAll(<String, Object>{'first': 1}), isTrue);
+      final int intactLength = File(logPath).lengthSync();
+      expect(await store.setAll(<String, Object>{'second': 2}), isTrue);
+      store.close();
+
+      // As a crash in the middle of the second write would leave it.
+      final RandomAccessFile file =
+          File(logPath).openSync(mode: FileMode.append);
+      file.truncateSync(file.lengthSync() - 1);
+      file.closeSync();
+
+      store = PreferencesStore.open(logPath)!;
+      expect(store.load(), <String, Object>{'first': 1});
+      expect(File(logPath).lengthSync(), intactLength);
+      expect(await store.setAll(<String, Object>{'third': 3}), isTrue);
+
+      store = reopen(store);
+      expect(store.load(), <String, Object>{'first': 1, 'third': 3});
+      store.close();
+    });
+
+    test('compacts the log', () async {
+      PreferencesStore store = PreferencesStore.open(logPath)!;
+      final String value = 'x' * 1024;
+      for (int i = 0; i < 256; i++) {
+        expect(await store.setAll(<String, Object>{'key': '$i$value'}),
+            isTrue);
+      }
+      expect(await store.setAll(<String, Object>{'other': 1}), isTrue);
+
+      // 256 KiB were written, of which about 1 KiB is live, so the log was
+      // rewritten each time it reached 64 KiB.
+      expect(File(logPath).lengthSync(), lessThan(64 * 1024));
+      store = reopen(store);
+      expect(store.load(), <String, Object>{'key': '255$value', 'other': 1});
+      store.close();
+    });
+  },
+      skip: pluginLibrary == null
+          ? 'libshared_preferences_elinux_plugin.so is not available'
+          : null);
+}
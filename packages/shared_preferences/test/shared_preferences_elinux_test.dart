@@ -148,6 +148,19 @@ void main() {
     expect(await readTestFile(), '{"key1":"one","key2":2}');
   });
 
+  test('setValue coalesces a burst of writes', () async {
+    await writeTestFile('{}');
+    final SharedPreferencesELinux prefs = getPreferences();
+
+    final List<Future<bool>> writes = <Future<bool>>[
+      for (int i = 0; i < 10; i++) prefs.setValue('', 'key$i', i),
+    ];
+
+    expect(await Future.wait(writes), everyElement(isTrue));
+    expect(json.decode(await readTestFile()), hasLength(10));
+    expect(fs.file('${await getFilePath()}.tmp').existsSync(), isFalse);
+  });
+
   test('clear', () async {
     await writeTestFile(json.encode(flutterTestValues));
     final SharedPreferencesELinux prefs = getPreferences();
@@ -0,0 +1,66 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_ASSET_CACHE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_ASSET_CACHE_H_
+
+#include <gst/gst.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Keeps the media bundled with the application, e.g. the Flutter assets,
+// in the page cache, so that a short clip or sound played in a loop is read
+// from the flash once.
+//
+// The plugins tell the assets apart from other local files with Prefetch()
+// before playing them. Their sources are then read in large blocks, and
+// once a looping asset has been read to its end, i.e. while all of its
+// pages are still cached, Pin() maps and locks the file for the lifetime of
+// the process. filesrc keeps reading the same pages through the page
+// cache, so nothing else changes in the pipelines. The mappings are limited
+// in size, and larger assets only get the readahead.
+//
+// video_player and audioplayers each have a copy of this file.
+class AssetCache {
+ public:
+  static AssetCache& GetInstance();
+
+  // Prevent copying.
+  AssetCache(AssetCache const&) = delete;
+  AssetCache& operator=(AssetCache const&) = delete;
+
+  // Marks the local file at |path| as an asset, and starts reading its
+  // beginning in the background. Does nothing if it's no regular file.
+  void Prefetch(const std::string& path);
+
+  // Reads the asset played by |source| in large blocks, if it's a filesrc.
+  // Meant for the "source-setup" signal of playbin.
+  void ConfigureSource(GstElement* source);
+  // Pins the asset played by |source| once it has been played through.
+  // Returns true if it's pinned, now or before.
+  bool Pin(GstElement* source);
+
+ private:
+  struct Entry {
+    int64_t size = 0;
+    void* data = nullptr;
+    bool is_locked = false;
+  };
+
+  AssetCache() = default;
+  ~AssetCache();
+
+  // Returns the location of |source| if it's an asset, or an empty string.
+  // Must be called with |mutex_| held.
+  std::string GetAssetLocation(GstElement* source) const;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  int64_t pinned_size_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_ASSET_CACHE_H_
@@ -0,0 +1,576 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Plays a video with GstVideoPlayer, without Flutter, and fetches its frames
+// at the rate of a simulated vsync, as the texture callback of the plugin
+// does. Prints what it measured as JSON, for regression tracking.
+//
+// $ video_player_bench [--source=testsrc|file|rtsp] [--uri=<uri>]
+//       [--width=1280] [--height=720] [--fps=30] [--duration=10]
+//       [--vsync=60] [--copy] [--egl]
+
+#include <gst/gst.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef BENCH_RTSP_SERVER
+#include <gst/rtsp-server/rtsp-server.h>
+#endif  // BENCH_RTSP_SERVER
+#ifdef USE_EGL_IMAGE_DMABUF
+#include <EGL/egl.h>
+#endif  // USE_EGL_IMAGE_DMABUF
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gst_video_player.h"
+#include "latency_stats.h"
+#include "video_player_stream_handler.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// The encoders the test file is made with, in order of preference.
+constexpr const char* kTestFileEncoders[] = {
+    "x264enc tune=zerolatency speed-preset=ultrafast ! h264parse",
+    "openh264enc ! h264parse",
+    "vp8enc deadline=1",
+    "jpegenc",
+};
+// The length of the test file, which is played in a loop.
+constexpr int kTestFileSeconds = 10;
+
+struct Options {
+  // "testsrc", "file" or "rtsp".
+  std::string source = "testsrc";
+  std::string uri;
+  int width = 1280;
+  int height = 720;
+  int fps = 30;
+  int duration_s = 10;
+  int vsync_hz = 60;
+  // Copies every frame instead of mapping the buffers that are packed.
+  bool copy = false;
+  // Fetches EGLImages instead of pixels.
+  bool egl = false;
+};
+
+// Counts the frames, and tells the vsync loop when one is pending, as the
+// plugin marks the texture frame available.
+class BenchStreamHandler : public VideoPlayerStreamHandler {
+ public:
+  uint64_t GetDecodedFrameCount() const { return decoded_frames_; }
+  // Returns whether a frame has been decoded since the last call.
+  bool TakeFramePending() { return frame_pending_.exchange(false); }
+
+ protected:
+  void OnNotifyInitializedInternal() override {}
+  void OnNotifyFrameDecodedInternal() override {
+    decoded_frames_++;
+    frame_pending_ = true;
+  }
+  void OnNotifyFrameRenderedInternal() override {}
+  void OnNotifyCompletedInternal() override {}
+  void OnNotifyPlayingInternal(bool is_playing) override {}
+  void OnNotifyBufferingInternal(bool is_buffering) override {}
+  void OnNotifyBufferingUpdateInternal(
+      const std::vector<std::pair<int64_t, int64_t>>& ranges) override {}
+  void OnNotifyVariantSwitchInternal(int32_t width, int32_t height,
+                                     int64_t bitrate) override {}
+  void OnNotifyThroughputInternal(int64_t throughput,
+                                  int64_t bandwidth) override {}
+  void OnNotifySubtitleCueInternal(const std::string& text, bool is_markup,
+                                   int64_t start_ms,
+                                   int64_t duration_ms) override {}
+  void OnNotifyOverlayInternal(
+      const std::vector<OverlayRectangle>& rectangles) override {}
+
+ private:
+  std::atomic<uint64_t> decoded_frames_{0};
+  std::atomic<bool> frame_pending_{false};
+};
+
+struct Summary {
+  int64_t p50 = 0;
+  int64_t p95 = 0;
+  int64_t p99 = 0;
+  int64_t max = 0;
+  int64_t mean = 0;
+};
+
+Summary Summarize(std::vector<int64_t> samples) {
+  Summary summary;
+  if (samples.empty()) {
+    return summary;
+  }
+  std::sort(samples.begin(), samples.end());
+  const auto at = [&samples](size_t percent) {
+    return samples[std::min(samples.size() - 1,
+                            samples.size() * percent / 100)];
+  };
+  summary.p50 = at(50);
+  summary.p95 = at(95);
+  summary.p99 = at(99);
+  summary.max = samples.back();
+  int64_t total = 0;
+  for (const auto sample : samples) {
+    total += sample;
+  }
+  summary.mean = total / static_cast<int64_t>(samples.size());
+  return summary;
+}
+
+std::string EscapeJson(const std::string& value) {
+  std::string escaped;
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const auto equal = arg.find('=');
+    const auto name = arg.substr(0, equal);
+    const auto value = equal == std::string::npos ? "" : arg.substr(equal + 1);
+    if (name == "--source") {
+      options.source = value;
+    } else if (name == "--uri") {
+      options.uri = value;
+    } else if (name == "--width") {
+      options.width = std::atoi(value.c_str());
+    } else if (name == "--height") {
+      options.height = std::atoi(value.c_str());
+    } else if (name == "--fps") {
+      options.fps = std::atoi(value.c_str());
+    } else if (name == "--duration") {
+      options.duration_s = std::atoi(value.c_str());
+    } else if (name == "--vsync") {
+      options.vsync_hz = std::atoi(value.c_str());
+    } else if (name == "--copy") {
+      options.copy = true;
+    } else if (name == "--egl") {
+      options.egl = true;
+    } else {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return false;
+    }
+  }
+  if (options.source != "testsrc" && options.source != "file" &&
+      options.source != "rtsp") {
+    std::cerr << "Unknown source: " << options.source << std::endl;
+    return false;
+  }
+  if (options.source == "file" && options.uri.empty()) {
+    std::cerr << "--source=file needs --uri" << std::endl;
+    return false;
+  }
+  if (options.width <= 0 || options.height <= 0 || options.fps <= 0 ||
+      options.duration_s <= 0 || options.vsync_hz <= 0) {
+    std::cerr << "Invalid size or rate" << std::endl;
+    return false;
+  }
+#ifndef USE_EGL_IMAGE_DMABUF
+  if (options.egl) {
+    std::cerr << "--egl needs a build with USE_EGL_IMAGE_DMABUF" << std::endl;
+    return false;
+  }
+#endif  // USE_EGL_IMAGE_DMABUF
+  return true;
+}
+
+std::string GetRawCaps(const Options& options) {
+  return "video/x-raw,width=" + std::to_string(options.width) +
+         ",height=" + std::to_string(options.height) +
+         ",framerate=" + std::to_string(options.fps) + "/1";
+}
+
+bool RunToEos(GstElement* pipeline) {
+  if (gst_element_set_state(pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    return false;
+  }
+  auto* bus = gst_element_get_bus(pipeline);
+  auto* message = gst_bus_timed_pop_filtered(
+      bus, GST_CLOCK_TIME_NONE,
+      static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  const bool is_eos = message && GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS;
+  if (message) {
+    gst_message_unref(message);
+  }
+  gst_object_unref(bus);
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  return is_eos;
+}
+
+// Encodes the frames of videotestsrc into a temporary file with the first
+// encoder available, and returns its URI, or an empty string.
+std::string CreateTestFile(const Options& options, std::string& path) {
+  gchar* name = nullptr;
+  GError* error = nullptr;
+  const auto fd =
+      g_file_open_tmp("video_player_bench-XXXXXX.mkv", &name, &error);
+  if (fd < 0) {
+    std::cerr << "Failed to create a test file: " << error->message
+              << std::endl;
+    g_clear_error(&error);
+    return "";
+  }
+  close(fd);
+  path = name;
+  g_free(name);
+
+  const auto frames = options.fps * kTestFileSeconds;
+  for (const auto* encoder : kTestFileEncoders) {
+    const auto description =
+        "videotestsrc pattern=smpte num-buffers=" + std::to_string(frames) +
+        " ! " + GetRawCaps(options) + " ! videoconvert ! " + encoder +
+        " ! matroskamux ! filesink location=\"" + path + "\"";
+    auto* pipeline = gst_parse_launch(description.c_str(), &error);
+    if (!pipeline) {
+      g_clear_error(&error);
+      continue;
+    }
+    const bool ok = RunToEos(pipeline);
+    gst_object_unref(pipeline);
+    if (ok) {
+      auto* uri = gst_filename_to_uri(path.c_str(), nullptr);
+      const std::string result = uri;
+      g_free(uri);
+      return result;
+    }
+  }
+  std::cerr << "No encoder could make the test file" << std::endl;
+  return "";
+}
+
+#ifdef BENCH_RTSP_SERVER
+// Serves videotestsrc encoded in H.264 on a loopback port, from a thread of
+// its own.
+class RtspTestServer {
+ public:
+  ~RtspTestServer() {
+    if (thread_.joinable()) {
+      g_main_loop_quit(loop_);
+      thread_.join();
+    }
+    if (server_) {
+      g_object_unref(server_);
+    }
+    if (loop_) {
+      g_main_loop_unref(loop_);
+    }
+    if (context_) {
+      g_main_context_unref(context_);
+    }
+  }
+
+  // Returns the URI of the stream, or an empty string.
+  std::string Start(const Options& options) {
+    context_ = g_main_context_new();
+    loop_ = g_main_loop_new(context_, FALSE);
+    server_ = gst_rtsp_server_new();
+    gst_rtsp_server_set_address(server_, "127.0.0.1");
+    gst_rtsp_server_set_service(server_, "0");
+
+    auto* factory = gst_rtsp_media_factory_new();
+    const auto launch =
+        "( videotestsrc is-live=true pattern=smpte ! " + GetRawCaps(options) +
+        " ! videoconvert ! x264enc tune=zerolatency speed-preset=ultrafast"
+        " key-int-max=" +
+        std::to_string(options.fps) +
+        " ! rtph264pay name=pay0 pt=96 config-interval=1 )";
+    gst_rtsp_media_factory_set_launch(factory, launch.c_str());
+    gst_rtsp_media_factory_set_shared(factory, TRUE);
+    auto* mounts = gst_rtsp_server_get_mount_points(server_);
+    gst_rtsp_mount_points_add_factory(mounts, "/bench", factory);
+    g_object_unref(mounts);
+
+    if (gst_rtsp_server_attach(server_, context_) == 0) {
+      std::cerr << "Failed to start the RTSP server" << std::endl;
+      return "";
+    }
+    thread_ = std::thread([this]() {
+      g_main_context_push_thread_default(context_);
+      g_main_loop_run(loop_);
+      g_main_context_pop_thread_default(context_);
+    });
+    return "rtsp://127.0.0.1:" +
+           std::to_string(gst_rtsp_server_get_bound_port(server_)) + "/bench";
+  }
+
+ private:
+  GMainContext* context_ = nullptr;
+  GMainLoop* loop_ = nullptr;
+  GstRTSPServer* server_ = nullptr;
+  std::thread thread_;
+};
+#endif  // BENCH_RTSP_SERVER
+
+#ifdef USE_EGL_IMAGE_DMABUF
+// A context current on the vsync thread, with a pbuffer surface, standing
+// in for the one of the raster thread.
+class EglContext {
+ public:
+  ~EglContext() {
+    if (display_ == EGL_NO_DISPLAY) {
+      return;
+    }
+    eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface_ != EGL_NO_SURFACE) {
+      eglDestroySurface(display_, surface_);
+    }
+    if (context_ != EGL_NO_CONTEXT) {
+      eglDestroyContext(display_, context_);
+    }
+    eglTerminate(display_);
+  }
+
+  bool Create() {
+    display_ = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display_ == EGL_NO_DISPLAY || !eglInitialize(display_, nullptr,
+                                                     nullptr)) {
+      display_ = EGL_NO_DISPLAY;
+      return false;
+    }
+    eglBindAPI(EGL_OPENGL_ES_API);
+    const EGLint config_attributes[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                                        EGL_RENDERABLE_TYPE,
+                                        EGL_OPENGL_ES2_BIT, EGL_NONE};
+    EGLConfig config;
+    EGLint count = 0;
+    if (!eglChooseConfig(display_, config_attributes, &config, 1, &count) ||
+        count == 0) {
+      return false;
+    }
+    const EGLint context_attributes[] = {EGL_CONTEXT_CLIENT_VERSION, 2,
+                                         EGL_NONE};
+    context_ = eglCreateContext(display_, config, EGL_NO_CONTEXT,
+                                context_attributes);
+    const EGLint surface_attributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1,
+                                         EGL_NONE};
+    surface_ = eglCreatePbufferSurface(display_, config, surface_attributes);
+    return context_ != EGL_NO_CONTEXT && surface_ != EGL_NO_SURFACE &&
+           eglMakeCurrent(display_, surface_, surface_, context_);
+  }
+
+  EGLDisplay GetDisplay() const { return display_; }
+  EGLContext GetContext() const { return context_; }
+
+ private:
+  EGLDisplay display_ = EGL_NO_DISPLAY;
+  EGLContext context_ = EGL_NO_CONTEXT;
+  EGLSurface surface_ = EGL_NO_SURFACE;
+};
+#endif  // USE_EGL_IMAGE_DMABUF
+
+int64_t GetCpuTimeUs() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (static_cast<int64_t>(usage.ru_utime.tv_sec) +
+          usage.ru_stime.tv_sec) *
+             1000000 +
+         usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+int64_t GetRssKb() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0;
+  int64_t resident = 0;
+  if (!(statm >> size >> resident)) {
+    return 0;
+  }
+  return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+int64_t GetPeakRssKb() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+void PrintSummary(const char* name, const Summary& summary) {
+  std::printf(
+      "  \"%s\": {\"p50\": %lld, \"p95\": %lld, \"p99\": %lld, \"max\": %lld, "
+      "\"mean\": %lld},\n",
+      name, static_cast<long long>(summary.p50),
+      static_cast<long long>(summary.p95),
+      static_cast<long long>(summary.p99),
+      static_cast<long long>(summary.max),
+      static_cast<long long>(summary.mean));
+}
+
+void PrintPercentiles(const char* name,
+                      const LatencyStats::Percentiles& percentiles,
+                      const char* separator) {
+  std::printf(
+      "    \"%s\": {\"p50\": %lld, \"p95\": %lld, \"p99\": %lld, "
+      "\"count\": %zu}%s\n",
+      name, static_cast<long long>(percentiles.p50),
+      static_cast<long long>(percentiles.p95),
+      static_cast<long long>(percentiles.p99), percentiles.count, separator);
+}
+
+int Run(const Options& options) {
+  std::string uri = options.uri;
+  std::string test_file;
+#ifdef BENCH_RTSP_SERVER
+  RtspTestServer rtsp_server;
+#endif  // BENCH_RTSP_SERVER
+  if (options.source == "testsrc") {
+    uri = CreateTestFile(options, test_file);
+  } else if (options.source == "rtsp" && uri.empty()) {
+#ifdef BENCH_RTSP_SERVER
+    uri = rtsp_server.Start(options);
+#else
+    std::cerr << "--source=rtsp needs --uri, since the RTSP server isn't "
+                 "built in"
+              << std::endl;
+#endif  // BENCH_RTSP_SERVER
+  }
+  if (uri.empty()) {
+    return 1;
+  }
+
+#ifdef USE_EGL_IMAGE_DMABUF
+  EglContext egl;
+  if (options.egl && !egl.Create()) {
+    std::cerr << "Failed to create an EGL context" << std::endl;
+    return 1;
+  }
+#endif  // USE_EGL_IMAGE_DMABUF
+
+  auto handler = std::make_unique<BenchStreamHandler>();
+  auto* stream_handler = handler.get();
+  auto player = std::make_unique<GstVideoPlayer>(uri, std::move(handler));
+  if (!player->Init()) {
+    std::cerr << "Failed to open " << uri << std::endl;
+    if (!test_file.empty()) {
+      std::remove(test_file.c_str());
+    }
+    return 1;
+  }
+  if (!player->IsRtsp()) {
+    player->SetAutoRepeat(true);
+  }
+  player->RequestOutputSize(options.width, options.height);
+
+  const auto start_cpu_us = GetCpuTimeUs();
+  const auto start = Clock::now();
+  const auto start_frames = stream_handler->GetDecodedFrameCount();
+  player->Play();
+
+  std::vector<int64_t> fetch_times_us;
+  fetch_times_us.reserve(options.duration_s * options.vsync_hz);
+  const auto period = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / options.vsync_hz));
+  const auto end = start + std::chrono::seconds(options.duration_s);
+  auto next_vsync = start;
+  while (Clock::now() < end) {
+    next_vsync += period;
+    std::this_thread::sleep_until(next_vsync);
+    if (!stream_handler->TakeFramePending()) {
+      continue;
+    }
+    const auto fetch_start = Clock::now();
+#ifdef USE_EGL_IMAGE_DMABUF
+    if (options.egl) {
+      player->GetEGLImage(egl.GetDisplay(), egl.GetContext());
+    } else
+#endif  // USE_EGL_IMAGE_DMABUF
+    {
+      size_t width = 0;
+      size_t height = 0;
+      void* release_context = nullptr;
+      const auto* pixels = player->GetFrameBuffer(
+          width, height, options.copy ? nullptr : &release_context);
+      // Reads the frame, as the upload to the texture would.
+      if (pixels) {
+        volatile uint8_t sink = 0;
+        for (size_t i = 0; i < width * height * 4; i += 4096) {
+          sink = sink + pixels[i];
+        }
+      }
+      GstVideoPlayer::ReleaseFrameBuffer(release_context);
+    }
+    fetch_times_us.push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                              fetch_start)
+            .count());
+  }
+
+  const auto elapsed_s =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  const auto cpu_percent =
+      (GetCpuTimeUs() - start_cpu_us) / 1e6 / elapsed_s * 100.0;
+  const auto decoded_frames =
+      stream_handler->GetDecodedFrameCount() - start_frames;
+  const auto rss_kb = GetRssKb();
+  const auto fetch = Summarize(fetch_times_us);
+
+  std::printf("{\n");
+  std::printf("  \"source\": \"%s\",\n", options.source.c_str());
+  std::printf("  \"uri\": \"%s\",\n", EscapeJson(uri).c_str());
+  std::printf("  \"fetch_mode\": \"%s\",\n",
+              options.egl ? "egl" : (options.copy ? "copy" : "map"));
+  std::printf("  \"width\": %d,\n  \"height\": %d,\n", player->GetWidth(),
+              player->GetHeight());
+  std::printf("  \"duration_s\": %.3f,\n", elapsed_s);
+  std::printf("  \"vsync_hz\": %d,\n", options.vsync_hz);
+  std::printf("  \"decoded_frames\": %llu,\n",
+              static_cast<unsigned long long>(decoded_frames));
+  std::printf("  \"decode_fps\": %.2f,\n", decoded_frames / elapsed_s);
+  std::printf("  \"fetch_fps\": %.2f,\n", fetch_times_us.size() / elapsed_s);
+  std::printf("  \"dropped_frames\": %llu,\n",
+              static_cast<unsigned long long>(
+                  player->GetDroppedFrameCount()));
+  std::printf("  \"late_frames\": %llu,\n",
+              static_cast<unsigned long long>(player->GetLateFrameCount()));
+  PrintSummary("fetch_us", fetch);
+  std::printf("  \"latency_us\": {\n");
+  PrintPercentiles("decode_to_handoff",
+                   player->GetLatency(LatencyStats::kDecodeToHandoff), ",");
+  PrintPercentiles("handoff_to_fetch",
+                   player->GetLatency(LatencyStats::kHandoffToTexture), ",");
+  PrintPercentiles("decode_to_fetch",
+                   player->GetLatency(LatencyStats::kDecodeToTexture), "");
+  std::printf("  },\n");
+  std::printf("  \"cpu_percent\": %.1f,\n", cpu_percent);
+  std::printf("  \"rss_kb\": %lld,\n", static_cast<long long>(rss_kb));
+  std::printf("  \"peak_rss_kb\": %lld\n",
+              static_cast<long long>(GetPeakRssKb()));
+  std::printf("}\n");
+
+  player->Stop();
+  player = nullptr;
+  if (!test_file.empty()) {
+    std::remove(test_file.c_str());
+  }
+  return 0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    return 2;
+  }
+  GstVideoPlayer::GstLibraryLoad();
+  const auto result = Run(options);
+  GstVideoPlayer::GstLibraryUnload();
+  return result;
+}
@@ -0,0 +1,918 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Stresses the decoding of the plugin messages and the lifecycle of
+// GstVideoPlayer, without Flutter:
+//  - fuzz:  decodes random values with every FromMap of messages/, and
+//           checks that a decoded message decodes to itself again,
+//  - churn: creates, plays, seeks, changes the rate of, fetches the frames
+//           of and disposes players from concurrent threads at random
+//           times, the way the plugin does it from the platform thread,
+//           the init threads and the raster thread.
+// Then checks that no pipeline, thread or file descriptor has outlived the
+// players, and prints what it measured as JSON. Exits with 1 if it found a
+// leak or a mismatch, and aborts if an operation hangs, so that it can run
+// under ASan or TSan, see BENCH_SANITIZER in CMakeLists.txt.
+//
+// $ video_player_stress [--players=8] [--duration=30] [--uri=<uri>]
+//       [--pool=2] [--fuzz=10000] [--seed=<seed>] [--hang-timeout=10]
+
+#include <dirent.h>
+#include <gst/gst.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gst_video_player.h"
+#include "messages/messages.h"
+#include "video_player_pool.h"
+#include "video_player_stream_handler.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// The encoders the test file is made with, in order of preference.
+constexpr const char* kTestFileEncoders[] = {
+    "x264enc tune=zerolatency speed-preset=ultrafast key-int-max=30"
+    " ! h264parse",
+    "openh264enc ! h264parse",
+    "vp8enc deadline=1",
+    "jpegenc",
+};
+constexpr char kTestFileCaps[] =
+    "video/x-raw,width=320,height=240,framerate=30/1";
+constexpr int kTestFileFrames = 300;
+// Counts the live pipelines, unless GST_TRACERS is already set.
+constexpr char kLeaksTracer[] = "leaks(filters=GstPipeline)";
+// How long the threads and the pipelines of the disposed players may take
+// to go away.
+constexpr auto kSettleTimeout = std::chrono::seconds(3);
+constexpr int kMaxOperationsPerCycle = 8;
+constexpr int kMaxPauseMs = 100;
+// One in ... cycles disposes the player right after creating it, while it
+// is still prerolling.
+constexpr int kEarlyDisposeOdds = 8;
+constexpr double kPlaybackRates[] = {0.25, 0.5, 1.0, 1.5, 2.0};
+// The nesting of the fuzzed values.
+constexpr int kMaxFuzzDepth = 3;
+constexpr size_t kMaxFuzzSize = 6;
+
+// Taken from the keys of messages/, so that most of the fuzzed maps reach
+// the fields of the messages.
+constexpr const char* kFuzzKeys[] = {
+    "asset", "audioTrack", "bufferDurationMs", "bufferSizeBytes", "columns",
+    "count", "cpus", "delay", "directory", "enabled", "fastStart",
+    "followTextureSize", "format", "formatHint", "height", "idleFrames",
+    "intervalMs", "isLooping", "isScrubbing", "keyFrameOnly", "latencyBudget",
+    "maxBitrate", "maxDecoderThreads", "maxHeight", "maxSize", "maxSizeBytes",
+    "maxWidth", "mixWithOthers", "muted", "name", "nice", "packageName",
+    "position", "positionMs", "positions", "realtimePriority", "requests",
+    "role", "rtspTransport", "seekMode", "size", "speed", "startBitrate",
+    "textureId", "tileHeight", "tileWidth", "tiles", "timeout",
+    "timeshiftWindow", "transport", "uri", "uris", "volume", "width", "x", "y",
+    "zOrder",
+};
+
+enum Operation {
+  kCreate,
+  kInit,
+  kPlay,
+  kPause,
+  kSeek,
+  kSetPlaybackRate,
+  kFetchFrame,
+  kDispose,
+  kOperationCount,
+};
+// The operations on a prerolled player, from kPlay.
+constexpr int kPlayerOperationCount = kFetchFrame - kPlay + 1;
+constexpr const char* kOperationNames[] = {
+    "create", "init", "play", "pause", "seek", "set_playback_rate",
+    "fetch_frame", "dispose",
+};
+
+struct Options {
+  // The threads creating and disposing players at once.
+  int players = 8;
+  int duration_s = 30;
+  // Played instead of the test file if set.
+  std::string uri;
+  // The capacity of the pool of disposed players, or zero to destroy them.
+  int pool = 2;
+  int fuzz = 10000;
+  // Random if zero. Printed, so that a run can be repeated.
+  uint32_t seed = 0;
+  int hang_timeout_s = 10;
+};
+
+class StressStreamHandler : public VideoPlayerStreamHandler {
+ protected:
+  void OnNotifyInitializedInternal() override {}
+  void OnNotifyFrameDecodedInternal() override {}
+  void OnNotifyFrameRenderedInternal() override {}
+  void OnNotifyCompletedInternal() override {}
+  void OnNotifyPlayingInternal(bool is_playing) override {}
+  void OnNotifyBufferingInternal(bool is_buffering) override {}
+  void OnNotifyBufferingUpdateInternal(
+      const std::vector<std::pair<int64_t, int64_t>>& ranges) override {}
+  void OnNotifyVariantSwitchInternal(int32_t width, int32_t height,
+                                     int64_t bitrate) override {}
+  void OnNotifyThroughputInternal(int64_t throughput,
+                                  int64_t bandwidth) override {}
+  void OnNotifySubtitleCueInternal(const std::string& text, bool is_markup,
+                                   int64_t start_ms,
+                                   int64_t duration_ms) override {}
+  void OnNotifyOverlayInternal(
+      const std::vector<OverlayRectangle>& rectangles) override {}
+};
+
+// What the plugin does on the platform thread, which serializes the
+// creation and the disposal of the players.
+struct Platform {
+  std::mutex mutex;
+  VideoPlayerPool pool;
+};
+
+// A churning thread. The watchdog reads the operation in progress.
+struct Worker {
+  std::atomic<int> operation{-1};
+  std::atomic<int64_t> operation_started_us{0};
+  std::vector<int64_t> latencies_us[kOperationCount];
+  int failures[kOperationCount] = {};
+  int cycles = 0;
+  std::thread thread;
+};
+
+struct Summary {
+  int64_t p50 = 0;
+  int64_t p95 = 0;
+  int64_t p99 = 0;
+  int64_t max = 0;
+  size_t count = 0;
+};
+
+// The resources that outlive the players if they leak.
+struct Resources {
+  int threads = 0;
+  int fds = 0;
+  // -1 if the leaks tracer isn't active.
+  int pipelines = -1;
+  int64_t rss_kb = 0;
+};
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+Summary Summarize(std::vector<int64_t> samples) {
+  Summary summary;
+  summary.count = samples.size();
+  if (samples.empty()) {
+    return summary;
+  }
+  std::sort(samples.begin(), samples.end());
+  const auto at = [&samples](size_t percent) {
+    return samples[std::min(samples.size() - 1,
+                            samples.size() * percent / 100)];
+  };
+  summary.p50 = at(50);
+  summary.p95 = at(95);
+  summary.p99 = at(99);
+  summary.max = samples.back();
+  return summary;
+}
+
+std::string EscapeJson(const std::string& value) {
+  std::string escaped;
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const auto equal = arg.find('=');
+    const auto name = arg.substr(0, equal);
+    const auto value = equal == std::string::npos ? "" : arg.substr(equal + 1);
+    if (name == "--players") {
+      options.players = std::atoi(value.c_str());
+    } else if (name == "--duration") {
+      options.duration_s = std::atoi(value.c_str());
+    } else if (name == "--uri") {
+      options.uri = value;
+    } else if (name == "--pool") {
+      options.pool = std::atoi(value.c_str());
+    } else if (name == "--fuzz") {
+      options.fuzz = std::atoi(value.c_str());
+    } else if (name == "--seed") {
+      options.seed = static_cast<uint32_t>(std::strtoul(value.c_str(),
+                                                        nullptr, 10));
+    } else if (name == "--hang-timeout") {
+      options.hang_timeout_s = std::atoi(value.c_str());
+    } else {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return false;
+    }
+  }
+  if (options.players < 1 || options.players > 64) {
+    std::cerr << "Invalid player count: " << options.players << std::endl;
+    return false;
+  }
+  if (options.duration_s < 0 || options.pool < 0 || options.fuzz < 0 ||
+      options.hang_timeout_s <= 0) {
+    std::cerr << "Invalid duration, pool, fuzz count or timeout"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool RunToEos(GstElement* pipeline) {
+  if (gst_element_set_state(pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    return false;
+  }
+  auto* bus = gst_element_get_bus(pipeline);
+  auto* message = gst_bus_timed_pop_filtered(
+      bus, GST_CLOCK_TIME_NONE,
+      static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  const bool is_eos = message && GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS;
+  if (message) {
+    gst_message_unref(message);
+  }
+  gst_object_unref(bus);
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  return is_eos;
+}
+
+// Encodes the frames of videotestsrc into a temporary file with the first
+// encoder available, and returns its URI, or an empty string.
+std::string CreateTestFile(std::string& path) {
+  gchar* name = nullptr;
+  GError* error = nullptr;
+  const auto fd =
+      g_file_open_tmp("video_player_stress-XXXXXX.mkv", &name, &error);
+  if (fd < 0) {
+    std::cerr << "Failed to create a test file: " << error->message
+              << std::endl;
+    g_clear_error(&error);
+    return "";
+  }
+  close(fd);
+  path = name;
+  g_free(name);
+
+  for (const auto* encoder : kTestFileEncoders) {
+    const auto description =
+        "videotestsrc pattern=smpte num-buffers=" +
+        std::to_string(kTestFileFrames) + " ! " + kTestFileCaps +
+        " ! videoconvert ! " + encoder +
+        " ! matroskamux ! filesink location=\"" + path + "\"";
+    auto* pipeline = gst_parse_launch(description.c_str(), &error);
+    if (!pipeline) {
+      g_clear_error(&error);
+      continue;
+    }
+    const bool ok = RunToEos(pipeline);
+    gst_object_unref(pipeline);
+    if (ok) {
+      auto* uri = gst_filename_to_uri(path.c_str(), nullptr);
+      const std::string result = uri;
+      g_free(uri);
+      return result;
+    }
+  }
+  std::cerr << "No encoder could make the test file" << std::endl;
+  return "";
+}
+
+// Fuzzing.
+
+template <typename Message>
+flutter::EncodableValue Redecode(const flutter::EncodableValue& value) {
+  return Message::FromMap(value).ToMap();
+}
+
+struct Decoder {
+  const char* name;
+  flutter::EncodableValue (*redecode)(const flutter::EncodableValue& value);
+};
+
+// The messages the plugin decodes.
+constexpr Decoder kDecoders[] = {
+    {"AbrPolicyMessage", &Redecode<AbrPolicyMessage>},
+    {"CaptureFrameMessage", &Redecode<CaptureFrameMessage>},
+    {"CompositorLayoutMessage", &Redecode<CompositorLayoutMessage>},
+    {"CreateCompositorMessage", &Redecode<CreateCompositorMessage>},
+    {"CreateMessage", &Redecode<CreateMessage>},
+    {"DownloadCacheMessage", &Redecode<DownloadCacheMessage>},
+    {"ExtractFramesMessage", &Redecode<ExtractFramesMessage>},
+    {"GenerateSpriteSheetMessage", &Redecode<GenerateSpriteSheetMessage>},
+    {"IdleThrottleMessage", &Redecode<IdleThrottleMessage>},
+    {"KeyFrameOnlyMessage", &Redecode<KeyFrameOnlyMessage>},
+    {"LatencyBudgetMessage", &Redecode<LatencyBudgetMessage>},
+    {"LoopingMessage", &Redecode<LoopingMessage>},
+    {"MixWithOthersMessage", &Redecode<MixWithOthersMessage>},
+    {"MultiStreamModeMessage", &Redecode<MultiStreamModeMessage>},
+    {"PlaybackSpeedMessage", &Redecode<PlaybackSpeedMessage>},
+    {"PlayerPoolSizeMessage", &Redecode<PlayerPoolSizeMessage>},
+    {"PositionMessage", &Redecode<PositionMessage>},
+    {"PositionTickMessage", &Redecode<PositionTickMessage>},
+    {"PrerollTimeoutMessage", &Redecode<PrerollTimeoutMessage>},
+    {"QosMessage", &Redecode<QosMessage>},
+    {"ScrubbingMessage", &Redecode<ScrubbingMessage>},
+    {"SubtitlesMessage", &Redecode<SubtitlesMessage>},
+    {"TextureMessage", &Redecode<TextureMessage>},
+    {"ThreadPolicyMessage", &Redecode<ThreadPolicyMessage>},
+    {"TimeshiftMessage", &Redecode<TimeshiftMessage>},
+    {"TrackSelectionMessage", &Redecode<TrackSelectionMessage>},
+    {"VolumeMessage", &Redecode<VolumeMessage>},
+};
+
+bool IsSameDouble(double a, double b) {
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+template <typename T>
+bool IsSameList(const std::vector<T>& a, const std::vector<T>& b) {
+  return a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin(),
+                    [](T x, T y) { return IsSameDouble(x, y); });
+}
+
+// Compares the values recursively, with NaN equal to itself.
+bool IsSame(const flutter::EncodableValue& a,
+            const flutter::EncodableValue& b) {
+  if (a.index() != b.index()) {
+    return false;
+  }
+  if (std::holds_alternative<std::monostate>(a)) {
+    return true;
+  } else if (std::holds_alternative<bool>(a)) {
+    return std::get<bool>(a) == std::get<bool>(b);
+  } else if (std::holds_alternative<int32_t>(a)) {
+    return std::get<int32_t>(a) == std::get<int32_t>(b);
+  } else if (std::holds_alternative<int64_t>(a)) {
+    return std::get<int64_t>(a) == std::get<int64_t>(b);
+  } else if (std::holds_alternative<double>(a)) {
+    return IsSameDouble(std::get<double>(a), std::get<double>(b));
+  } else if (std::holds_alternative<std::string>(a)) {
+    return std::get<std::string>(a) == std::get<std::string>(b);
+  } else if (std::holds_alternative<std::vector<uint8_t>>(a)) {
+    return std::get<std::vector<uint8_t>>(a) ==
+           std::get<std::vector<uint8_t>>(b);
+  } else if (std::holds_alternative<std::vector<int32_t>>(a)) {
+    return std::get<std::vector<int32_t>>(a) ==
+           std::get<std::vector<int32_t>>(b);
+  } else if (std::holds_alternative<std::vector<int64_t>>(a)) {
+    return std::get<std::vector<int64_t>>(a) ==
+           std::get<std::vector<int64_t>>(b);
+  } else if (std::holds_alternative<std::vector<double>>(a)) {
+    return IsSameList(std::get<std::vector<double>>(a),
+                      std::get<std::vector<double>>(b));
+  } else if (std::holds_alternative<std::vector<float>>(a)) {
+    return IsSameList(std::get<std::vector<float>>(a),
+                      std::get<std::vector<float>>(b));
+  } else if (std::holds_alternative<flutter::EncodableList>(a)) {
+    const auto& list_a = std::get<flutter::EncodableList>(a);
+    const auto& list_b = std::get<flutter::EncodableList>(b);
+    return list_a.size() == list_b.size() &&
+           std::equal(list_a.begin(), list_a.end(), list_b.begin(), IsSame);
+  } else if (std::holds_alternative<flutter::EncodableMap>(a)) {
+    const auto& map_a = std::get<flutter::EncodableMap>(a);
+    const auto& map_b = std::get<flutter::EncodableMap>(b);
+    if (map_a.size() != map_b.size()) {
+      return false;
+    }
+    for (auto i = map_a.begin(), j = map_b.begin(); i != map_a.end();
+         ++i, ++j) {
+      if (!IsSame(i->first, j->first) || !IsSame(i->second, j->second)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  // The messages don't have custom values.
+  return false;
+}
+
+const char* RandomKey(std::mt19937& random) {
+  return kFuzzKeys[random() % (sizeof(kFuzzKeys) / sizeof(kFuzzKeys[0]))];
+}
+
+std::string RandomString(std::mt19937& random) {
+  switch (random() % 6) {
+    case 0:
+      return "";
+    case 1:
+      return RandomKey(random);
+    case 2:
+      return "rtsp://127.0.0.1:8554/stress";
+    case 3:
+      return std::string(4096, 'a');
+    case 4:
+      return std::string("\0\xff\xfe", 3);
+    default:
+      return std::to_string(random());
+  }
+}
+
+double RandomDouble(std::mt19937& random) {
+  switch (random() % 6) {
+    case 0:
+      return std::numeric_limits<double>::quiet_NaN();
+    case 1:
+      return std::numeric_limits<double>::infinity();
+    case 2:
+      return -std::numeric_limits<double>::max();
+    case 3:
+      return -0.0;
+    default:
+      return std::uniform_real_distribution<double>(-10.0, 10.0)(random);
+  }
+}
+
+int64_t RandomInteger(std::mt19937& random) {
+  switch (random() % 5) {
+    case 0:
+      return std::numeric_limits<int64_t>::min();
+    case 1:
+      return std::numeric_limits<int64_t>::max();
+    case 2:
+      return -1;
+    default:
+      return static_cast<int64_t>(random() % 2000) - 1000;
+  }
+}
+
+flutter::EncodableValue RandomValue(std::mt19937& random, int depth);
+
+flutter::EncodableValue RandomMap(std::mt19937& random, int depth) {
+  flutter::EncodableMap map;
+  const auto size = random() % (kMaxFuzzSize + 1);
+  for (size_t i = 0; i < size; i++) {
+    // Mostly the keys of the messages, but any value may be a key.
+    auto key = random() % 8 == 0
+                   ? RandomValue(random, kMaxFuzzDepth)
+                   : flutter::EncodableValue(RandomKey(random));
+    map[key] = RandomValue(random, depth + 1);
+  }
+  return flutter::EncodableValue(map);
+}
+
+flutter::EncodableValue RandomValue(std::mt19937& random, int depth) {
+  const auto size = random() % (kMaxFuzzSize + 1);
+  // The containers only until the maximum depth.
+  const auto type = random() % (depth < kMaxFuzzDepth ? 13 : 11);
+  switch (type) {
+    case 0:
+      return flutter::EncodableValue();
+    case 1:
+      return flutter::EncodableValue(random() % 2 == 0);
+    case 2:
+      return flutter::EncodableValue(
+          static_cast<int32_t>(RandomInteger(random)));
+    case 3:
+      return flutter::EncodableValue(RandomInteger(random));
+    case 4:
+      return flutter::EncodableValue(RandomDouble(random));
+    case 5:
+    case 6:
+      return flutter::EncodableValue(RandomString(random));
+    case 7:
+      return flutter::EncodableValue(std::vector<uint8_t>(size, 0xff));
+    case 8:
+      return flutter::EncodableValue(std::vector<int32_t>(size, -1));
+    case 9:
+      return flutter::EncodableValue(
+          std::vector<int64_t>(size, RandomInteger(random)));
+    case 10:
+      return flutter::EncodableValue(
+          std::vector<double>(size, RandomDouble(random)));
+    case 11: {
+      flutter::EncodableList list;
+      for (size_t i = 0; i < size; i++) {
+        list.push_back(random() % 2 == 0 ? RandomMap(random, depth + 1)
+                                         : RandomValue(random, depth + 1));
+      }
+      return flutter::EncodableValue(list);
+    }
+    default:
+      return RandomMap(random, depth);
+  }
+}
+
+// Returns the number of messages that didn't decode to themselves.
+int RunFuzz(int iterations, std::mt19937& random) {
+  int mismatches = 0;
+  for (int i = 0; i < iterations; i++) {
+    // Mostly maps, as the plugin receives.
+    const auto value = random() % 10 == 0 ? RandomValue(random, 0)
+                                          : RandomMap(random, 0);
+    for (const auto& decoder : kDecoders) {
+      const auto decoded = decoder.redecode(value);
+      if (!IsSame(decoded, decoder.redecode(decoded))) {
+        std::cerr << decoder.name << " doesn't decode to itself at iteration "
+                  << i << std::endl;
+        mismatches++;
+      }
+    }
+  }
+  return mismatches;
+}
+
+// Leak checking.
+
+int CountEntries(const char* path) {
+  auto* dir = opendir(path);
+  if (!dir) {
+    return 0;
+  }
+  int count = 0;
+  while (auto* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      count++;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+int64_t GetRssKb() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0;
+  int64_t resident = 0;
+  if (!(statm >> size >> resident)) {
+    return 0;
+  }
+  return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+int CountLivePipelines() {
+  auto* tracers = gst_tracing_get_active_tracers();
+  int count = -1;
+  for (auto* item = tracers; item; item = item->next) {
+    if (std::strcmp(G_OBJECT_TYPE_NAME(item->data), "GstLeaksTracer") != 0) {
+      continue;
+    }
+    GstStructure* info = nullptr;
+    g_signal_emit_by_name(item->data, "get-live-objects", &info);
+    const auto* objects =
+        info ? gst_structure_get_value(info, "live-objects-list") : nullptr;
+    if (objects) {
+      count = static_cast<int>(gst_value_list_get_size(objects));
+    }
+    if (info) {
+      gst_structure_free(info);
+    }
+    break;
+  }
+  g_list_free_full(tracers, gst_object_unref);
+  return count;
+}
+
+Resources GetResources() {
+  Resources resources;
+  resources.threads = CountEntries("/proc/self/task");
+  // Without the descriptor of the directory itself.
+  resources.fds = CountEntries("/proc/self/fd") - 1;
+  resources.pipelines = CountLivePipelines();
+  resources.rss_kb = GetRssKb();
+  return resources;
+}
+
+bool IsSettled(const Resources& resources, const Resources& baseline) {
+  return resources.threads <= baseline.threads &&
+         resources.fds <= baseline.fds &&
+         resources.pipelines <= baseline.pipelines;
+}
+
+// Waits for the streaming threads of the destroyed pipelines to go away.
+Resources Settle(const Resources& baseline) {
+  const auto end = Clock::now() + kSettleTimeout;
+  while (true) {
+    // Joins the idle threads of the default task pool.
+    gst_task_cleanup_all();
+    const auto resources = GetResources();
+    if (IsSettled(resources, baseline) || Clock::now() >= end) {
+      return resources;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
+// Churning.
+
+template <typename Function>
+bool Measure(Worker& worker, Operation operation, Function function) {
+  const auto start_us = NowUs();
+  worker.operation_started_us = start_us;
+  worker.operation = operation;
+  const bool ok = function();
+  worker.operation = -1;
+  worker.latencies_us[operation].push_back(NowUs() - start_us);
+  if (!ok) {
+    worker.failures[operation]++;
+  }
+  return ok;
+}
+
+void PauseRandomly(std::mt19937& random) {
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(random() % (kMaxPauseMs + 1)));
+}
+
+// Runs the lifecycle of a player once, as the plugin does.
+void RunCycle(Worker& worker, Platform& platform, const std::string& uri,
+              std::mt19937& random, bool is_warm_up) {
+  std::unique_ptr<GstVideoPlayer> player;
+  Measure(worker, kCreate, [&]() {
+    std::lock_guard<std::mutex> lock(platform.mutex);
+    auto handler = std::make_unique<StressStreamHandler>();
+    player = platform.pool.Acquire(uri);
+    if (player) {
+      player->SetStreamHandler(std::move(handler));
+    } else {
+      player = std::make_unique<GstVideoPlayer>(uri, std::move(handler));
+    }
+    return true;
+  });
+
+  // Prerolls on a thread of its own, which the disposal joins.
+  const auto init_started_us = NowUs();
+  std::atomic<int64_t> init_us{0};
+  std::atomic<bool> is_initialized{false};
+  std::atomic<bool> is_init_done{false};
+  auto* target = player.get();
+  std::thread init_thread([target, init_started_us, &init_us,
+                           &is_initialized, &is_init_done]() {
+    is_initialized = target->Init();
+    init_us = NowUs() - init_started_us;
+    is_init_done = true;
+  });
+
+  // As the plugin does, aborts a pending preroll and only pools the
+  // initialized players.
+  const auto dispose = [&]() {
+    Measure(worker, kDispose, [&]() {
+      std::lock_guard<std::mutex> lock(platform.mutex);
+      const bool is_pending = !is_init_done;
+      if (init_thread.joinable()) {
+        if (is_pending) {
+          player->AbortPreroll();
+        }
+        init_thread.join();
+      }
+      if (is_pending || !is_initialized) {
+        player = nullptr;
+      } else {
+        platform.pool.Release(std::move(player));
+      }
+      return true;
+    });
+    worker.cycles++;
+  };
+  if (!is_warm_up && random() % kEarlyDisposeOdds == 0) {
+    dispose();
+    return;
+  }
+
+  worker.operation_started_us = init_started_us;
+  worker.operation = kInit;
+  init_thread.join();
+  worker.operation = -1;
+  worker.latencies_us[kInit].push_back(init_us);
+  if (!is_initialized) {
+    worker.failures[kInit]++;
+    dispose();
+    return;
+  }
+  player->SetAutoRepeat(true);
+  Measure(worker, kPlay, [&]() { return player->Play(); });
+
+  // The warm-up runs every operation once.
+  const auto operations =
+      is_warm_up ? kPlayerOperationCount
+                 : 1 + static_cast<int>(random() % kMaxOperationsPerCycle);
+  for (int i = 0; i < operations; i++) {
+    PauseRandomly(random);
+    const auto operation =
+        kPlay + (is_warm_up
+                     ? i
+                     : static_cast<int>(random() % kPlayerOperationCount));
+    switch (operation) {
+      case kPlay:
+        Measure(worker, kPlay, [&]() { return player->Play(); });
+        break;
+      case kPause:
+        Measure(worker, kPause, [&]() { return player->Pause(); });
+        break;
+      case kSeek: {
+        const auto duration = player->GetDuration();
+        const auto position =
+            duration > 0 ? static_cast<int64_t>(random() % duration) : 0;
+        Measure(worker, kSeek, [&]() { return player->SetSeek(position); });
+        break;
+      }
+      case kSetPlaybackRate: {
+        constexpr auto kRateCount =
+            sizeof(kPlaybackRates) / sizeof(kPlaybackRates[0]);
+        const auto rate = kPlaybackRates[random() % kRateCount];
+        Measure(worker, kSetPlaybackRate,
+                [&]() { return player->SetPlaybackRate(rate); });
+        break;
+      }
+      default:
+        // As the texture callback does. No frame may be ready yet.
+        Measure(worker, kFetchFrame, [&]() {
+          size_t width = 0;
+          size_t height = 0;
+          void* release_context = nullptr;
+          player->GetFrameBuffer(width, height, &release_context);
+          GstVideoPlayer::ReleaseFrameBuffer(release_context);
+          return true;
+        });
+        break;
+    }
+  }
+  PauseRandomly(random);
+  dispose();
+}
+
+// Aborts if an operation takes longer than |timeout_us|, so that a hang
+// leaves a core dump, or the report of the sanitizer.
+void RunWatchdog(std::vector<Worker>& workers, int64_t timeout_us,
+                 std::atomic<bool>& is_done) {
+  while (!is_done) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto now_us = NowUs();
+    for (size_t i = 0; i < workers.size(); i++) {
+      const auto started_us = workers[i].operation_started_us.load();
+      const auto operation = workers[i].operation.load();
+      if (operation >= 0 && now_us - started_us > timeout_us) {
+        std::cerr << "Player " << i << " has hung in "
+                  << kOperationNames[operation] << " for "
+                  << (now_us - started_us) / 1000 << " ms" << std::endl;
+        std::abort();
+      }
+    }
+  }
+}
+
+void PrintSummary(const char* name, const Summary& summary, int failures,
+                  const char* separator) {
+  std::printf(
+      "    \"%s\": {\"p50\": %lld, \"p95\": %lld, \"p99\": %lld, \"max\": "
+      "%lld, \"count\": %zu, \"failures\": %d}%s\n",
+      name, static_cast<long long>(summary.p50),
+      static_cast<long long>(summary.p95),
+      static_cast<long long>(summary.p99),
+      static_cast<long long>(summary.max), summary.count, failures,
+      separator);
+}
+
+int Run(const Options& options) {
+  const auto seed = options.seed ? options.seed : std::random_device()();
+  std::mt19937 random(seed);
+  const auto mismatches = RunFuzz(options.fuzz, random);
+
+  std::string uri = options.uri;
+  std::string test_file;
+  if (uri.empty()) {
+    uri = CreateTestFile(test_file);
+  }
+  if (uri.empty()) {
+    return 1;
+  }
+
+  Platform platform;
+  platform.pool.SetCapacity(static_cast<size_t>(options.pool));
+  std::vector<Worker> workers(options.players);
+  std::atomic<bool> is_done{false};
+  std::thread watchdog(RunWatchdog, std::ref(workers),
+                       static_cast<int64_t>(options.hang_timeout_s) * 1000000,
+                       std::ref(is_done));
+
+  // The first player loads the plugins and starts the shared threads,
+  // which aren't leaks.
+  const auto before = GetResources();
+  {
+    Worker warm_up;
+    RunCycle(warm_up, platform, uri, random, true);
+    std::lock_guard<std::mutex> lock(platform.mutex);
+    platform.pool.Clear();
+  }
+  const auto baseline = Settle(before);
+
+  const auto start = Clock::now();
+  const auto end = start + std::chrono::seconds(options.duration_s);
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i].thread = std::thread([&, i]() {
+      std::mt19937 worker_random(seed + static_cast<uint32_t>(i) + 1);
+      // Spreads the first cycles.
+      PauseRandomly(worker_random);
+      while (Clock::now() < end) {
+        RunCycle(workers[i], platform, uri, worker_random, false);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.thread.join();
+  }
+  const auto elapsed_s =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  {
+    std::lock_guard<std::mutex> lock(platform.mutex);
+    platform.pool.Clear();
+  }
+  const auto after = Settle(baseline);
+  is_done = true;
+  watchdog.join();
+
+  int cycles = 0;
+  std::vector<int64_t> latencies_us[kOperationCount];
+  int failures[kOperationCount] = {};
+  for (const auto& worker : workers) {
+    cycles += worker.cycles;
+    for (int i = 0; i < kOperationCount; i++) {
+      latencies_us[i].insert(latencies_us[i].end(),
+                             worker.latencies_us[i].begin(),
+                             worker.latencies_us[i].end());
+      failures[i] += worker.failures[i];
+    }
+  }
+  const auto leaked_threads = after.threads - baseline.threads;
+  const auto leaked_fds = after.fds - baseline.fds;
+  // Unknown without the leaks tracer.
+  const auto leaked_pipelines = after.pipelines >= 0 && baseline.pipelines >= 0
+                                    ? after.pipelines - baseline.pipelines
+                                    : -1;
+
+  std::printf("{\n");
+  std::printf("  \"uri\": \"%s\",\n", EscapeJson(uri).c_str());
+  std::printf("  \"seed\": %u,\n", seed);
+  std::printf("  \"fuzz_iterations\": %d,\n", options.fuzz);
+  std::printf("  \"fuzz_mismatches\": %d,\n", mismatches);
+  std::printf("  \"players\": %d,\n", options.players);
+  std::printf("  \"pool\": %d,\n", options.pool);
+  std::printf("  \"duration_s\": %.3f,\n", elapsed_s);
+  std::printf("  \"cycles\": %d,\n", cycles);
+  std::printf("  \"latency_us\": {\n");
+  for (int i = 0; i < kOperationCount; i++) {
+    PrintSummary(kOperationNames[i], Summarize(latencies_us[i]), failures[i],
+                 i + 1 < kOperationCount ? "," : "");
+  }
+  std::printf("  },\n");
+  std::printf("  \"leaked_threads\": %d,\n", leaked_threads);
+  std::printf("  \"leaked_fds\": %d,\n", leaked_fds);
+  std::printf("  \"leaked_pipelines\": %d,\n", leaked_pipelines);
+  std::printf("  \"rss_growth_kb\": %lld\n",
+              static_cast<long long>(after.rss_kb - baseline.rss_kb));
+  std::printf("}\n");
+
+  if (!test_file.empty()) {
+    std::remove(test_file.c_str());
+  }
+  return mismatches > 0 || leaked_threads > 0 || leaked_fds > 0 ||
+                 leaked_pipelines > 0 ||
+                 (options.duration_s > 0 && cycles == 0)
+             ? 1
+             : 0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    return 2;
+  }
+  // Read by gst_init().
+  setenv("GST_TRACERS", kLeaksTracer, 0);
+  GstVideoPlayer::GstLibraryLoad();
+  const auto result = Run(options);
+  GstVideoPlayer::GstLibraryUnload();
+  return result;
+}
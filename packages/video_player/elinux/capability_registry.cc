@@ -0,0 +1,259 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "capability_registry.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+struct CodecCaps {
+  const char* name;
+  const char* media_type;
+};
+constexpr CodecCaps kCodecs[] = {
+    {"H264", "video/x-h264"}, {"H265", "video/x-h265"},
+    {"AV1", "video/x-av1"},   {"VP8", "video/x-vp8"},
+    {"VP9", "video/x-vp9"},   {"JPEG", "image/jpeg"},
+};
+
+// The families of hardware elements that don't say so in their klass.
+constexpr const char* kHardwarePrefixes[] = {
+    "qtiv", "v4l2", "va", "nv", "omx", "imx", "msdk", "mpp",
+};
+
+// Color conversion backends in order of preference. Each one also scales,
+// so that the output can be downscaled to the size shown on screen.
+struct ConverterChain {
+  const char* name;
+  const char* elements[4];
+  bool is_hardware;
+};
+constexpr ConverterChain kConverters[] = {
+    {"qtivtransform", {"qtivtransform", nullptr, nullptr, nullptr}, true},
+    {"v4l2convert", {"v4l2convert", nullptr, nullptr, nullptr}, true},
+    // A round trip through GL memory rather than a hardware converter.
+    {"glcolorconvert",
+     {"glupload", "glcolorconvert", "glcolorscale", "gldownload"},
+     false},
+    // Since GStreamer 1.22.
+    {"videoconvertscale",
+     {"videoconvertscale", nullptr, nullptr, nullptr},
+     false},
+    // Scales before converting, so that fewer pixels are converted.
+    {"videoconvert", {"videoscale", "videoconvert", nullptr, nullptr}, false},
+};
+
+// The frames every converter must handle to be used: a typical decoder
+// output, downscaled to the output format of the plugin.
+constexpr char kProbeInputCaps[] =
+    "video/x-raw,format=NV12,width=320,height=240";
+#ifdef USE_YUV_SHADER
+constexpr char kProbeOutputCaps[] =
+    "video/x-raw,format=NV12,width=160,height=120";
+#else
+constexpr char kProbeOutputCaps[] =
+    "video/x-raw,format=RGBA,width=160,height=120";
+#endif  // USE_YUV_SHADER
+// How long a converter gets to preroll a test frame.
+constexpr GstClockTime kProbeTimeout = GST_SECOND;
+
+bool HasElementFactory(const char* name) {
+  auto* factory = gst_element_factory_find(name);
+  if (!factory) {
+    return false;
+  }
+  gst_object_unref(factory);
+  return true;
+}
+
+bool IsHardware(GstElementFactory* factory) {
+  const auto* klass =
+      gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+  if (klass && std::strstr(klass, "Hardware")) {
+    return true;
+  }
+  const auto* name = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+  for (const auto* prefix : kHardwarePrefixes) {
+    if (g_str_has_prefix(name, prefix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns whether |elements| negotiate and preroll a test frame, since e.g.
+// the GL chain fails without a usable GL display, and a hardware converter
+// may not take the format.
+bool CanConvert(const std::vector<std::string>& elements) {
+  // videotestsrc is in the same plugin set as videoconvert, but don't drop
+  // every converter if it is missing.
+  if (!HasElementFactory("videotestsrc")) {
+    return true;
+  }
+  std::string description =
+      std::string("videotestsrc num-buffers=1 ! ") + kProbeInputCaps;
+  for (const auto& name : elements) {
+    description += " ! " + name;
+  }
+  description += std::string(" ! ") + kProbeOutputCaps + " ! fakesink";
+
+  GError* error = nullptr;
+  auto* pipeline = gst_parse_launch(description.c_str(), &error);
+  if (error) {
+    g_error_free(error);
+    if (pipeline) {
+      gst_object_unref(pipeline);
+    }
+    return false;
+  }
+  auto result = gst_element_set_state(pipeline, GST_STATE_PAUSED);
+  if (result == GST_STATE_CHANGE_ASYNC) {
+    result = gst_element_get_state(pipeline, nullptr, nullptr, kProbeTimeout);
+  }
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(pipeline);
+  return result == GST_STATE_CHANGE_SUCCESS;
+}
+
+// Returns the largest |field| the sink pads of |factory| accept for
+// |media_type|, or zero if they don't restrict it.
+int32_t GetMaxSize(GstElementFactory* factory, const char* media_type,
+                   const char* field) {
+  int32_t max_size = 0;
+  for (const auto* item = gst_element_factory_get_static_pad_templates(factory);
+       item; item = item->next) {
+    auto* pad_template = static_cast<GstStaticPadTemplate*>(item->data);
+    if (pad_template->direction != GST_PAD_SINK) {
+      continue;
+    }
+    auto* caps = gst_static_pad_template_get_caps(pad_template);
+    for (guint i = 0; i < gst_caps_get_size(caps); i++) {
+      auto* structure = gst_caps_get_structure(caps, i);
+      if (!gst_structure_has_name(structure, media_type)) {
+        continue;
+      }
+      const auto* value = gst_structure_get_value(structure, field);
+      if (value && GST_VALUE_HOLDS_INT_RANGE(value)) {
+        max_size = std::max(max_size, gst_value_get_int_range_max(value));
+      }
+    }
+    gst_caps_unref(caps);
+  }
+  return max_size;
+}
+}  // namespace
+
+// static
+CapabilityRegistry& CapabilityRegistry::GetInstance() {
+  static CapabilityRegistry instance;
+  return instance;
+}
+
+void CapabilityRegistry::Probe() {
+  std::call_once(probe_flag_, [this]() {
+    ProbeDecoders();
+    ProbeConverters();
+    ProbeCompositors();
+  });
+}
+
+const std::vector<CapabilityRegistry::Decoder>&
+CapabilityRegistry::GetDecoders(const std::string& codec) const {
+  static const std::vector<Decoder> kNoDecoders;
+  for (const auto& entry : codecs_) {
+    if (g_ascii_strcasecmp(entry.first.c_str(), codec.c_str()) == 0) {
+      return entry.second;
+    }
+  }
+  return kNoDecoders;
+}
+
+void CapabilityRegistry::ProbeDecoders() {
+  // Includes the unranked decoders, which some vendors ship, e.g. qtivdec.
+  auto* factories = gst_element_factory_list_get_elements(
+      GST_ELEMENT_FACTORY_TYPE_DECODER, GST_RANK_NONE);
+  for (const auto& codec : kCodecs) {
+    auto* caps = gst_caps_new_empty_simple(codec.media_type);
+    auto* matches =
+        gst_element_factory_list_filter(factories, caps, GST_PAD_SINK, FALSE);
+    gst_caps_unref(caps);
+
+    std::vector<std::pair<guint, Decoder>> ranked;
+    for (auto* item = matches; item; item = item->next) {
+      auto* factory = GST_ELEMENT_FACTORY(item->data);
+      Decoder decoder;
+      decoder.name = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+      decoder.is_hardware = IsHardware(factory);
+      decoder.max_width = GetMaxSize(factory, codec.media_type, "width");
+      decoder.max_height = GetMaxSize(factory, codec.media_type, "height");
+      ranked.emplace_back(
+          gst_plugin_feature_get_rank(GST_PLUGIN_FEATURE(factory)), decoder);
+    }
+    gst_plugin_feature_list_free(matches);
+
+    // The hardware decoders first, then by the rank they were given.
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const auto& a, const auto& b) {
+                       if (a.second.is_hardware != b.second.is_hardware) {
+                         return a.second.is_hardware;
+                       }
+                       return a.first > b.first;
+                     });
+    std::vector<Decoder> decoders;
+    for (const auto& entry : ranked) {
+      decoders.push_back(entry.second);
+    }
+    if (decoders.empty()) {
+      std::cerr << "No " << codec.name << " decoder found" << std::endl;
+    } else {
+      std::cout << codec.name << " decoder: " << decoders.front().name
+                << std::endl;
+    }
+    codecs_.emplace_back(codec.name, std::move(decoders));
+  }
+  gst_plugin_feature_list_free(factories);
+}
+
+void CapabilityRegistry::ProbeConverters() {
+  for (const auto& chain : kConverters) {
+    Converter converter;
+    converter.name = chain.name;
+    converter.is_hardware = chain.is_hardware;
+    auto available = true;
+    for (const auto* name : chain.elements) {
+      if (!name) {
+        break;
+      }
+      if (!HasElementFactory(name)) {
+        available = false;
+        break;
+      }
+      converter.elements.push_back(name);
+    }
+    if (available && !CanConvert(converter.elements)) {
+      std::cerr << "Color converter " << converter.name
+                << " failed to convert a test frame" << std::endl;
+      available = false;
+    }
+    if (available) {
+      converters_.push_back(std::move(converter));
+    }
+  }
+  if (converters_.empty()) {
+    std::cerr << "No suitable color converter found!" << std::endl;
+  } else {
+    std::cout << "Color converter: " << converters_.front().name << std::endl;
+  }
+}
+
+void CapabilityRegistry::ProbeCompositors() {
+  if (HasElementFactory("glvideomixer") && HasElementFactory("gldownload")) {
+    compositors_.push_back({"glvideomixer", "gldownload", true});
+  }
+  if (HasElementFactory("compositor")) {
+    compositors_.push_back({"compositor", "", false});
+  }
+}
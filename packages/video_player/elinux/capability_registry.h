@@ -0,0 +1,81 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_CAPABILITY_REGISTRY_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_CAPABILITY_REGISTRY_H_
+
+#include <gst/gst.h>
+
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The decoders, color converters and compositors available to the plugin,
+// probed once when the plugin is loaded and ranked with the hardware
+// accelerated ones first, so that the pipelines don't probe the GStreamer
+// registry for every player.
+class CapabilityRegistry {
+ public:
+  struct Decoder {
+    std::string name;
+    bool is_hardware = false;
+    // The largest size the decoder accepts, or zero if it doesn't tell.
+    int32_t max_width = 0;
+    int32_t max_height = 0;
+  };
+
+  // A color conversion backend: a chain of elements linked in order, which
+  // also scales.
+  struct Converter {
+    std::string name;
+    std::vector<std::string> elements;
+    bool is_hardware = false;
+  };
+
+  struct Compositor {
+    std::string name;
+    // Where the frames leave the compositor, e.g. gldownload.
+    std::string output;
+    bool is_hardware = false;
+  };
+
+  static CapabilityRegistry& GetInstance();
+
+  // Prevent copying.
+  CapabilityRegistry(CapabilityRegistry const&) = delete;
+  CapabilityRegistry& operator=(CapabilityRegistry const&) = delete;
+
+  // Probes the GStreamer registry. Must be called after gst_init(). Only the
+  // first call does anything.
+  void Probe();
+
+  // The codecs, named after their RTP encoding-name, e.g. "H264", with the
+  // decoders available for each.
+  const std::vector<std::pair<std::string, std::vector<Decoder>>>& GetCodecs()
+      const {
+    return codecs_;
+  }
+  // Returns an empty list for an unknown codec.
+  const std::vector<Decoder>& GetDecoders(const std::string& codec) const;
+  const std::vector<Converter>& GetConverters() const { return converters_; }
+  const std::vector<Compositor>& GetCompositors() const {
+    return compositors_;
+  }
+
+ private:
+  CapabilityRegistry() = default;
+  ~CapabilityRegistry() = default;
+
+  void ProbeDecoders();
+  void ProbeConverters();
+  void ProbeCompositors();
+
+  std::once_flag probe_flag_;
+  std::vector<std::pair<std::string, std::vector<Decoder>>> codecs_;
+  std::vector<Converter> converters_;
+  std::vector<Compositor> compositors_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_CAPABILITY_REGISTRY_H_
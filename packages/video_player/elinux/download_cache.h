@@ -0,0 +1,77 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_DOWNLOAD_CACHE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_DOWNLOAD_CACHE_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Keeps the complete progressive downloads of HTTP media on local storage,
+// so that a clip played again, e.g. in a loop, is read from the disk instead
+// of being downloaded again over a slow link.
+//
+// playbin downloads HTTP media into a temporary file of queue2 when
+// GST_PLAY_FLAG_DOWNLOAD is set. Players point the temporary file into the
+// cache directory and hand it over to Commit() once it is complete, which
+// links it under a name derived from the URI. The least recently used
+// downloads are evicted once the cache exceeds its size.
+class DownloadCache {
+ public:
+  struct Settings {
+    // Empty means the default directory in the user cache directory.
+    std::string directory;
+    // The cache is disabled if zero or less.
+    int64_t max_size_bytes = 0;
+    // How much of a network stream playbin buffers before playing, and its
+    // buffer in memory of streams that aren't downloaded. Zero or less
+    // keeps the defaults of playbin.
+    int64_t buffer_duration_ms = 0;
+    int32_t buffer_size_bytes = 0;
+  };
+
+  static DownloadCache& GetInstance();
+
+  // Prevent copying.
+  DownloadCache(DownloadCache const&) = delete;
+  DownloadCache& operator=(DownloadCache const&) = delete;
+
+  // Applies to the players created afterwards. Evicts downloads right away
+  // if the size shrinks.
+  void Configure(const Settings& settings);
+  Settings GetSettings();
+  bool IsEnabled();
+
+  // Whether |uri| is downloaded progressively by playbin.
+  static bool IsNetworkUri(const std::string& uri);
+
+  // Returns the file URI of the complete download of |uri|, or an empty
+  // string if there's none. Marks the download as recently used.
+  std::string Lookup(const std::string& uri);
+  // Returns the temp-template of queue2 for downloading |uri|, or an empty
+  // string if the cache is disabled.
+  std::string GetTemporaryTemplate(const std::string& uri);
+  // Adds the complete download of |uri| at |temporary_location|, which
+  // queue2 may keep using and remove. Fails unless the file has |size|
+  // bytes, if |size| isn't negative.
+  bool Commit(const std::string& uri, const std::string& temporary_location,
+              int64_t size);
+
+ private:
+  DownloadCache() = default;
+  ~DownloadCache() = default;
+
+  // Must be called with |mutex_| held.
+  std::string GetPath(const std::string& uri) const;
+  bool EnsureDirectory();
+  void Trim();
+
+  std::mutex mutex_;
+  Settings settings_;
+  // |settings_.directory| or the default one.
+  std::string directory_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_DOWNLOAD_CACHE_H_
@@ -0,0 +1,116 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "frame_buffer_pool.h"
+
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include <iostream>
+#include <utility>
+
+namespace {
+constexpr size_t kPageSize = 4096;
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+// The RGBA sizes of the usual resolutions, from QVGA to 8K. A buffer is
+// rounded up to the first one that fits, so that the streams of a class
+// share their buffers.
+constexpr size_t kResolutionClasses[] = {
+    320 * 240 * 4,   640 * 480 * 4,   1280 * 720 * 4,  1920 * 1080 * 4,
+    2560 * 1440 * 4, 3840 * 2160 * 4, 4096 * 2160 * 4, 7680 * 4320 * 4,
+};
+
+// How many free buffers of a class are kept for reuse.
+constexpr size_t kMaxFreeBuffersPerClass = 2;
+
+size_t RoundUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+size_t GetAlignment(size_t capacity) {
+  return capacity >= kHugePageSize ? kHugePageSize : kPageSize;
+}
+
+size_t GetCapacity(size_t size) {
+  for (const auto resolution_class : kResolutionClasses) {
+    if (size <= resolution_class) {
+      size = resolution_class;
+      break;
+    }
+  }
+  return RoundUp(size, GetAlignment(size));
+}
+}  // namespace
+
+FrameBufferPool::Buffer::~Buffer() { Reset(); }
+
+FrameBufferPool::Buffer::Buffer(Buffer&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      capacity_(std::exchange(other.capacity_, 0)) {}
+
+FrameBufferPool::Buffer& FrameBufferPool::Buffer::operator=(
+    Buffer&& other) noexcept {
+  if (this != &other) {
+    Reset();
+    data_ = std::exchange(other.data_, nullptr);
+    capacity_ = std::exchange(other.capacity_, 0);
+  }
+  return *this;
+}
+
+void FrameBufferPool::Buffer::Reset() {
+  if (data_) {
+    FrameBufferPool::GetInstance().Release(data_, capacity_);
+    data_ = nullptr;
+    capacity_ = 0;
+  }
+}
+
+// static
+FrameBufferPool& FrameBufferPool::GetInstance() {
+  // Never destroyed, so that a buffer released at exit finds it.
+  static auto* instance = new FrameBufferPool();
+  return *instance;
+}
+
+FrameBufferPool::Buffer FrameBufferPool::Acquire(size_t size) {
+  const auto capacity = GetCapacity(size);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = free_buffers_.find(capacity);
+    if (it != free_buffers_.end() && !it->second.empty()) {
+      auto* data = it->second.back();
+      it->second.pop_back();
+      return Buffer(data, capacity);
+    }
+  }
+
+  void* data = nullptr;
+  const auto alignment = GetAlignment(capacity);
+  if (posix_memalign(&data, alignment, capacity) != 0) {
+    std::cerr << "Failed to allocate a frame buffer of " << capacity
+              << " bytes" << std::endl;
+    return Buffer();
+  }
+#ifdef MADV_HUGEPAGE
+  if (alignment == kHugePageSize) {
+    // Only a hint, transparent huge pages may be disabled.
+    madvise(data, capacity, MADV_HUGEPAGE);
+  }
+#endif  // MADV_HUGEPAGE
+  return Buffer(reinterpret_cast<uint8_t*>(data), capacity);
+}
+
+void FrameBufferPool::Release(uint8_t* data, size_t capacity) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& buffers = free_buffers_[capacity];
+    if (buffers.size() < kMaxFreeBuffersPerClass) {
+      buffers.push_back(data);
+      return;
+    }
+  }
+  free(data);
+}
@@ -0,0 +1,73 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_BUFFER_POOL_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Recycles the CPU frame buffers of the plugin, so that resolution changes
+// and creating and disposing of players cause no heap traffic at steady
+// state.
+//
+// The buffers are page aligned and rounded up to a resolution class, so that
+// a buffer freed by one stream fits the next stream of a similar size. The
+// ones of 2 MiB and more are aligned to and advised as huge pages, which
+// saves TLB misses when copying large frames.
+class FrameBufferPool {
+ public:
+  // A buffer of the pool, given back to it when destroyed.
+  class Buffer {
+   public:
+    Buffer() = default;
+    ~Buffer();
+
+    // Prevent copying.
+    Buffer(Buffer const&) = delete;
+    Buffer& operator=(Buffer const&) = delete;
+
+    Buffer(Buffer&& other) noexcept;
+    Buffer& operator=(Buffer&& other) noexcept;
+
+    uint8_t* data() const { return data_; }
+    size_t capacity() const { return capacity_; }
+
+   private:
+    friend class FrameBufferPool;
+
+    Buffer(uint8_t* data, size_t capacity)
+        : data_(data), capacity_(capacity) {}
+    void Reset();
+
+    uint8_t* data_ = nullptr;
+    size_t capacity_ = 0;
+  };
+
+  // Returns the pool shared by all the players of the plugin.
+  static FrameBufferPool& GetInstance();
+
+  // Prevent copying.
+  FrameBufferPool(FrameBufferPool const&) = delete;
+  FrameBufferPool& operator=(FrameBufferPool const&) = delete;
+
+  // Returns a buffer of at least |size| bytes, or an empty one if the
+  // allocation failed.
+  Buffer Acquire(size_t size);
+
+ private:
+  FrameBufferPool() = default;
+  ~FrameBufferPool() = default;
+
+  void Release(uint8_t* data, size_t capacity);
+
+  std::mutex mutex_;
+  // The free buffers by capacity.
+  std::map<size_t, std::vector<uint8_t*>> free_buffers_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_BUFFER_POOL_H_
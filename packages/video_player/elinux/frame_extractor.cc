@@ -0,0 +1,351 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "frame_extractor.h"
+
+#include <gst/app/gstappsink.h>
+#include <gst/video/video.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "download_cache.h"
+
+namespace {
+// Bounds each state change, so that a broken file doesn't hold a worker.
+constexpr GstClockTime kPrerollTimeout = 10 * GST_SECOND;
+constexpr unsigned int kMaxWorkers = 4;
+
+// The header of a cached frame, followed by its data.
+constexpr char kCacheMagic[4] = {'V', 'P', 'F', '1'};
+struct CacheHeader {
+  char magic[4];
+  int32_t width;
+  int32_t height;
+};
+
+struct DecodeContext {
+  GstElement* converter;
+  GstElement* filter;
+  int32_t max_width;
+};
+}  // namespace
+
+FrameExtractor::FrameExtractor(const std::string& cache_directory)
+    : cache_directory_(cache_directory) {
+  if (!cache_directory_.empty() &&
+      g_mkdir_with_parents(cache_directory_.c_str(), 0700) != 0) {
+    std::cerr << "Failed to create the frame cache " << cache_directory_
+              << std::endl;
+  }
+  const auto worker_count =
+      std::min(std::max(std::thread::hardware_concurrency(), 1u), kMaxWorkers);
+  for (unsigned int i = 0; i < worker_count; i++) {
+    workers_.emplace_back([this]() { RunWorker(); });
+  }
+}
+
+FrameExtractor::~FrameExtractor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+    jobs_.clear();
+  }
+  job_available_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+// static
+bool FrameExtractor::ParseFormat(const std::string& name, Format& format) {
+  if (name == "rgba") {
+    format = Format::kRgba;
+  } else if (name == "png") {
+    format = Format::kPng;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void FrameExtractor::Extract(const Request& request, Callback callback) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back({request, std::move(callback)});
+  }
+  job_available_.notify_one();
+}
+
+void FrameExtractor::RunWorker() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      job_available_.wait(lock,
+                          [this]() { return is_stopping_ || !jobs_.empty(); });
+      if (is_stopping_) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job.callback(Run(job.request));
+  }
+}
+
+FrameExtractor::Frame FrameExtractor::Run(const Request& request) {
+  std::string uri = request.uri;
+  if (!gst_uri_is_valid(uri.c_str())) {
+    auto* filename_uri = gst_filename_to_uri(uri.c_str(), NULL);
+    if (filename_uri) {
+      uri = filename_uri;
+      g_free(filename_uri);
+    }
+  }
+  // A clip a player has downloaded is decoded from its local copy.
+  const auto cached_uri = DownloadCache::GetInstance().Lookup(uri);
+  if (!cached_uri.empty()) {
+    uri = cached_uri;
+  }
+
+  Frame frame;
+  const auto cache_path = GetCachePath(uri, request);
+  if (!cache_path.empty() && LoadFromCache(cache_path, frame)) {
+    return frame;
+  }
+  if (!Decode(uri, request, frame)) {
+    if (frame.error.empty()) {
+      frame.error = "Failed to extract a frame of " + request.uri;
+    }
+    std::cerr << frame.error << std::endl;
+    frame.data.clear();
+    return frame;
+  }
+  if (!cache_path.empty()) {
+    SaveToCache(cache_path, frame);
+  }
+  return frame;
+}
+
+bool FrameExtractor::Decode(const std::string& uri, const Request& request,
+                            Frame& frame) {
+  auto* pipeline = gst_pipeline_new("frame-extractor");
+  auto* decoder = gst_element_factory_make("uridecodebin", nullptr);
+  auto* converter = gst_element_factory_make("videoconvert", nullptr);
+  auto* scaler = gst_element_factory_make("videoscale", nullptr);
+  auto* filter = gst_element_factory_make("capsfilter", nullptr);
+  auto* encoder = request.format == Format::kPng
+                      ? gst_element_factory_make("pngenc", nullptr)
+                      : nullptr;
+  auto* sink = gst_element_factory_make("appsink", nullptr);
+  if (!pipeline || !decoder || !converter || !scaler || !filter || !sink ||
+      (request.format == Format::kPng && !encoder)) {
+    frame.error = "Failed to create a frame extractor pipeline";
+    for (auto* element :
+         {decoder, converter, scaler, filter, encoder, sink, pipeline}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    return false;
+  }
+
+  g_object_set(decoder, "uri", uri.c_str(), NULL);
+  g_object_set(sink, "sync", FALSE, "max-buffers", 1, NULL);
+  gst_bin_add_many(GST_BIN(pipeline), decoder, converter, scaler, filter, sink,
+                   NULL);
+  auto linked = false;
+  if (encoder) {
+    gst_bin_add(GST_BIN(pipeline), encoder);
+    linked =
+        gst_element_link_many(converter, scaler, filter, encoder, sink, NULL);
+  } else {
+    linked = gst_element_link_many(converter, scaler, filter, sink, NULL);
+  }
+  DecodeContext context{converter, filter, request.max_width};
+  g_signal_connect(decoder, "pad-added", G_CALLBACK(OnPadAdded), &context);
+
+  GstSample* sample = nullptr;
+  if (!linked) {
+    frame.error = "Failed to link the frame extractor pipeline";
+  } else if (gst_element_set_state(pipeline, GST_STATE_PAUSED) ==
+                 GST_STATE_CHANGE_FAILURE ||
+             gst_element_get_state(pipeline, nullptr, nullptr,
+                                   kPrerollTimeout) !=
+                 GST_STATE_CHANGE_SUCCESS) {
+    frame.error = "Failed to decode " + request.uri;
+  } else {
+    gint64 position = request.position_ms * GST_MSECOND;
+    gint64 duration = 0;
+    if (gst_element_query_duration(pipeline, GST_FORMAT_TIME, &duration) &&
+        duration > 0) {
+      position = std::min(position, duration - 1);
+    }
+    // A thumbnail doesn't need the exact frame, so the seek stops at the key
+    // frame before the position without decoding the frames in between.
+    if (position > 0 &&
+        (!gst_element_seek_simple(
+             pipeline, GST_FORMAT_TIME,
+             (GstSeekFlags)(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT |
+                            GST_SEEK_FLAG_SNAP_BEFORE),
+             position) ||
+         gst_element_get_state(pipeline, nullptr, nullptr, kPrerollTimeout) !=
+             GST_STATE_CHANGE_SUCCESS)) {
+      frame.error = "Failed to seek " + request.uri;
+    } else {
+      sample = gst_app_sink_try_pull_preroll(GST_APP_SINK(sink),
+                                             kPrerollTimeout);
+      if (!sample) {
+        frame.error = "No video frame in " + request.uri;
+      }
+    }
+  }
+
+  if (sample) {
+    auto* caps = gst_sample_get_caps(sample);
+    auto* buffer = gst_sample_get_buffer(sample);
+    auto* structure = caps ? gst_caps_get_structure(caps, 0) : nullptr;
+    GstMapInfo map;
+    if (!structure || !buffer ||
+        !gst_structure_get_int(structure, "width", &frame.width) ||
+        !gst_structure_get_int(structure, "height", &frame.height) ||
+        !gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+      frame.error = "Failed to read the frame of " + request.uri;
+    } else {
+      if (request.format == Format::kPng) {
+        frame.data.assign(map.data, map.data + map.size);
+      } else {
+        // Drops the padding of the rows, if any.
+        GstVideoInfo info;
+        gst_video_info_from_caps(&info, caps);
+        const auto row_size = static_cast<size_t>(frame.width) * 4;
+        const auto stride =
+            static_cast<size_t>(GST_VIDEO_INFO_PLANE_STRIDE(&info, 0));
+        frame.data.resize(row_size * frame.height);
+        for (int32_t row = 0; row < frame.height; row++) {
+          if (row * stride + row_size > map.size) {
+            break;
+          }
+          std::memcpy(frame.data.data() + row * row_size,
+                      map.data + row * stride, row_size);
+        }
+      }
+      gst_buffer_unmap(buffer, &map);
+    }
+    gst_sample_unref(sample);
+  }
+
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(pipeline);
+  return frame.error.empty();
+}
+
+// static
+void FrameExtractor::OnPadAdded(GstElement* element, GstPad* pad,
+                                gpointer user_data) {
+  auto* context = reinterpret_cast<DecodeContext*>(user_data);
+  auto* caps = gst_pad_get_current_caps(pad);
+  if (!caps) {
+    caps = gst_pad_query_caps(pad, nullptr);
+  }
+  auto* structure = gst_caps_get_structure(caps, 0);
+  const auto is_video =
+      g_str_has_prefix(gst_structure_get_name(structure), "video/");
+  gint width = 0;
+  gst_structure_get_int(structure, "width", &width);
+  gst_caps_unref(caps);
+
+  auto* sink_pad = gst_element_get_static_pad(context->converter, "sink");
+  if (is_video && !gst_pad_is_linked(sink_pad)) {
+    // Never scales up, and keeps the display aspect ratio of the video.
+    auto* filter_caps = gst_caps_new_simple(
+        "video/x-raw", "format", G_TYPE_STRING, "RGBA", "pixel-aspect-ratio",
+        GST_TYPE_FRACTION, 1, 1, NULL);
+    if (context->max_width > 0 && (width == 0 || width > context->max_width)) {
+      gst_caps_set_simple(filter_caps, "width", G_TYPE_INT,
+                          context->max_width & ~1, NULL);
+    }
+    g_object_set(context->filter, "caps", filter_caps, NULL);
+    gst_caps_unref(filter_caps);
+    if (GST_PAD_LINK_FAILED(gst_pad_link(pad, sink_pad))) {
+      std::cerr << "Failed to link the video of the frame extractor"
+                << std::endl;
+    }
+  }
+  gst_object_unref(sink_pad);
+}
+
+std::string FrameExtractor::GetCachePath(const std::string& uri,
+                                         const Request& request) const {
+  if (cache_directory_.empty()) {
+    return std::string();
+  }
+  // Only local files have a modification time to invalidate the cache with.
+  auto* filename = g_filename_from_uri(uri.c_str(), nullptr, nullptr);
+  if (!filename) {
+    return std::string();
+  }
+  struct stat file_stat;
+  const auto has_stat = stat(filename, &file_stat) == 0;
+  g_free(filename);
+  if (!has_stat) {
+    return std::string();
+  }
+
+  const auto key =
+      uri + "|" + std::to_string(file_stat.st_mtim.tv_sec) + "." +
+      std::to_string(file_stat.st_mtim.tv_nsec) + "|" +
+      std::to_string(file_stat.st_size) + "|" +
+      std::to_string(request.position_ms) + "|" +
+      std::to_string(std::max(request.max_width, 0)) + "|" +
+      std::to_string(static_cast<int>(request.format));
+  auto* checksum =
+      g_compute_checksum_for_string(G_CHECKSUM_SHA1, key.c_str(), -1);
+  const auto path = cache_directory_ + "/" + checksum + ".frame";
+  g_free(checksum);
+  return path;
+}
+
+// static
+bool FrameExtractor::LoadFromCache(const std::string& path, Frame& frame) {
+  gchar* contents = nullptr;
+  gsize length = 0;
+  if (!g_file_get_contents(path.c_str(), &contents, &length, nullptr)) {
+    return false;
+  }
+  CacheHeader header;
+  auto is_valid = length >= sizeof(header);
+  if (is_valid) {
+    std::memcpy(&header, contents, sizeof(header));
+    is_valid = std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) == 0;
+  }
+  if (is_valid) {
+    frame.width = header.width;
+    frame.height = header.height;
+    frame.data.assign(contents + sizeof(header), contents + length);
+  }
+  g_free(contents);
+  return is_valid;
+}
+
+// static
+void FrameExtractor::SaveToCache(const std::string& path, const Frame& frame) {
+  CacheHeader header;
+  std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+  header.width = frame.width;
+  header.height = frame.height;
+  std::string contents(reinterpret_cast<const char*>(&header), sizeof(header));
+  contents.append(frame.data.begin(), frame.data.end());
+  // Written to a temporary file and renamed, so that the workers never read
+  // a partial frame.
+  GError* error = nullptr;
+  if (!g_file_set_contents(path.c_str(), contents.data(), contents.size(),
+                           &error)) {
+    std::cerr << "Failed to cache a frame: " << error->message << std::endl;
+    g_error_free(error);
+  }
+}
@@ -0,0 +1,92 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_EXTRACTOR_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_EXTRACTOR_H_
+
+#include <gst/gst.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Extracts single frames of videos, e.g. for thumbnails, without a player or
+// a texture.
+//
+// Each request runs a short-lived uridecodebin pipeline that prerolls at the
+// requested position and scales the frame down, on a small pool of worker
+// threads, so that a batch of requests is decoded in parallel. The frames of
+// local files are cached on disk by uri, modification time and request, so
+// that browsing the same files again costs no decoding.
+class FrameExtractor {
+ public:
+  enum class Format {
+    // Tightly packed RGBA pixels.
+    kRgba,
+    kPng,
+  };
+
+  struct Request {
+    std::string uri;
+    int64_t position_ms = 0;
+    // The width the frame is scaled down to, keeping its aspect ratio. Zero
+    // or less keeps the decoded width.
+    int32_t max_width = 0;
+    Format format = Format::kRgba;
+  };
+
+  struct Frame {
+    int32_t width = 0;
+    int32_t height = 0;
+    std::vector<uint8_t> data;
+    // Empty on success.
+    std::string error;
+  };
+
+  // Called on a worker thread.
+  using Callback = std::function<void(Frame frame)>;
+
+  // Caches the frames under |cache_directory|, or nowhere if it's empty.
+  explicit FrameExtractor(const std::string& cache_directory);
+  // Drops the pending requests and waits for the running ones.
+  ~FrameExtractor();
+
+  // Prevent copying.
+  FrameExtractor(FrameExtractor const&) = delete;
+  FrameExtractor& operator=(FrameExtractor const&) = delete;
+
+  static bool ParseFormat(const std::string& name, Format& format);
+
+  void Extract(const Request& request, Callback callback);
+
+ private:
+  struct Job {
+    Request request;
+    Callback callback;
+  };
+
+  void RunWorker();
+  Frame Run(const Request& request);
+  bool Decode(const std::string& uri, const Request& request, Frame& frame);
+  // Returns an empty path if the frame of |uri| can't be cached.
+  std::string GetCachePath(const std::string& uri,
+                           const Request& request) const;
+  static bool LoadFromCache(const std::string& path, Frame& frame);
+  static void SaveToCache(const std::string& path, const Frame& frame);
+  static void OnPadAdded(GstElement* element, GstPad* pad, gpointer user_data);
+
+  const std::string cache_directory_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable job_available_;
+  std::deque<Job> jobs_;
+  bool is_stopping_ = false;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_EXTRACTOR_H_
@@ -0,0 +1,153 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "frame_stream.h"
+
+#include <gst/video/video.h>
+#include <sys/mman.h>
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace {
+constexpr int32_t kSlotCount = 4;
+constexpr size_t kPageSize = 4096;
+
+size_t RoundUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+}  // namespace
+
+FrameStream::FrameStream(int32_t every_nth, int32_t max_width,
+                         Callback callback)
+    : every_nth_(every_nth > 1 ? every_nth : 1),
+      max_width_(max_width),
+      callback_(std::move(callback)) {}
+
+FrameStream::~FrameStream() {
+  for (const auto& region : regions_) {
+    munmap(region.base, region.size);
+  }
+}
+
+void FrameStream::Push(GstBuffer* buffer, GstCaps* caps) {
+  if (frame_count_++ % every_nth_ != 0) {
+    return;
+  }
+
+  GstVideoInfo info;
+  if (!gst_video_info_from_caps(&info, caps)) {
+    return;
+  }
+  Format format;
+  int32_t bytes_per_pixel;
+  switch (GST_VIDEO_INFO_FORMAT(&info)) {
+    case GST_VIDEO_FORMAT_RGBA:
+      format = Format::kRgba;
+      bytes_per_pixel = 4;
+      break;
+    case GST_VIDEO_FORMAT_NV12:
+    case GST_VIDEO_FORMAT_I420:
+      format = Format::kGray8;
+      bytes_per_pixel = 1;
+      break;
+    default:
+      return;
+  }
+
+  // Point sampling by an integral factor costs no more than the copy.
+  const int32_t width = GST_VIDEO_INFO_WIDTH(&info);
+  const int32_t height = GST_VIDEO_INFO_HEIGHT(&info);
+  int32_t factor = 1;
+  if (max_width_ > 0 && width > max_width_) {
+    factor = (width + max_width_ - 1) / max_width_;
+  }
+  const int32_t output_width = width / factor;
+  const int32_t output_height = height / factor;
+  const int32_t stride = RoundUp(output_width * bytes_per_pixel, 4);
+  const size_t size = static_cast<size_t>(stride) * output_height;
+  if (size == 0 || (size > slot_size_ && !Allocate(size))) {
+    return;
+  }
+
+  int32_t slot = -1;
+  for (int32_t i = 0; i < kSlotCount; i++) {
+    const auto candidate = (next_slot_ + i) % kSlotCount;
+    if (GetState(candidate)->load(std::memory_order_acquire) == kFree) {
+      slot = candidate;
+      break;
+    }
+  }
+  if (slot < 0) {
+    dropped_frames_++;
+    return;
+  }
+
+  GstVideoFrame video_frame;
+  if (!gst_video_frame_map(&video_frame, &info, buffer, GST_MAP_READ)) {
+    return;
+  }
+  const auto* source =
+      static_cast<const uint8_t*>(GST_VIDEO_FRAME_PLANE_DATA(&video_frame, 0));
+  const auto source_stride = GST_VIDEO_FRAME_PLANE_STRIDE(&video_frame, 0);
+  auto* data = regions_.back().base + kPageSize + slot * slot_size_;
+  for (int32_t y = 0; y < output_height; y++) {
+    const auto* source_row = source + y * factor * source_stride;
+    auto* row = data + y * stride;
+    if (factor == 1) {
+      std::memcpy(row, source_row, output_width * bytes_per_pixel);
+      continue;
+    }
+    for (int32_t x = 0; x < output_width; x++) {
+      std::memcpy(row + x * bytes_per_pixel,
+                  source_row + x * factor * bytes_per_pixel, bytes_per_pixel);
+    }
+  }
+  gst_video_frame_unmap(&video_frame);
+
+  auto* state = GetState(slot);
+  state->store(kInUse, std::memory_order_release);
+  next_slot_ = (slot + 1) % kSlotCount;
+
+  Frame frame;
+  frame.slot = slot;
+  frame.sequence = sequence_++;
+  frame.width = output_width;
+  frame.height = output_height;
+  frame.stride = stride;
+  frame.format = format;
+  frame.timestamp_us = GST_CLOCK_TIME_IS_VALID(GST_BUFFER_PTS(buffer))
+                           ? GST_TIME_AS_USECONDS(GST_BUFFER_PTS(buffer))
+                           : -1;
+  frame.data = data;
+  frame.size = size;
+  frame.state = reinterpret_cast<uint32_t*>(state);
+  frame.dropped_frames = dropped_frames_;
+  callback_(frame);
+}
+
+bool FrameStream::Allocate(size_t slot_size) {
+  slot_size = RoundUp(slot_size, kPageSize);
+  // The first page holds the state words.
+  const auto size = kPageSize + slot_size * kSlotCount;
+  auto* base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) {
+    std::cerr << "Failed to map a frame stream of " << size << " bytes"
+              << std::endl;
+    return false;
+  }
+  // Anonymous pages are zeroed, so that all the slots start free.
+  regions_.push_back({static_cast<uint8_t*>(base), size});
+  slot_size_ = slot_size;
+  next_slot_ = 0;
+  return true;
+}
+
+std::atomic<uint32_t>* FrameStream::GetState(int32_t slot) const {
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "The state words are shared with Dart");
+  return reinterpret_cast<std::atomic<uint32_t>*>(regions_.back().base) + slot;
+}
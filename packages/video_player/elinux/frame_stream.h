@@ -0,0 +1,92 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_STREAM_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_STREAM_H_
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Hands the decoded frames of a player to Dart through a ring of slots in
+// memory shared with the Dart isolate, for on-device analytics.
+//
+// The event sent for a frame only carries the address of its slot, which
+// Dart reads with dart:ffi without a copy, instead of the pixels being
+// copied into an EncodableValue. Dart owns a slot until it clears the state
+// word of the slot, and the frames that find no free slot are dropped, so a
+// slow consumer throttles the stream instead of queueing frames.
+class FrameStream {
+ public:
+  enum class Format {
+    kRgba,
+    // The luma plane of a YUV frame.
+    kGray8,
+  };
+
+  // The state word of a slot.
+  enum SlotState : uint32_t {
+    kFree = 0,
+    // Set before the frame is sent, cleared by the consumer.
+    kInUse = 1,
+  };
+
+  struct Frame {
+    int32_t slot;
+    uint64_t sequence;
+    int32_t width;
+    int32_t height;
+    int32_t stride;
+    Format format;
+    // The presentation timestamp in microseconds, or -1 if unknown.
+    int64_t timestamp_us;
+    uint8_t* data;
+    size_t size;
+    uint32_t* state;
+    // The frames dropped so far for lack of a free slot.
+    uint64_t dropped_frames;
+  };
+
+  // Called on the streaming thread of the player.
+  using Callback = std::function<void(const Frame& frame)>;
+
+  // Sends every |every_nth| frame, scaled down by an integral factor to at
+  // most |max_width| if it's positive.
+  FrameStream(int32_t every_nth, int32_t max_width, Callback callback);
+  // Unmaps the slots, which Dart must no longer read.
+  ~FrameStream();
+
+  // Prevent copying.
+  FrameStream(FrameStream const&) = delete;
+  FrameStream& operator=(FrameStream const&) = delete;
+
+  void Push(GstBuffer* buffer, GstCaps* caps);
+
+ private:
+  struct Region {
+    uint8_t* base;
+    size_t size;
+  };
+
+  // Maps a new ring with slots of |slot_size| bytes. The previous one is
+  // kept mapped until destruction, since Dart may still read its slots.
+  bool Allocate(size_t slot_size);
+  std::atomic<uint32_t>* GetState(int32_t slot) const;
+
+  const int32_t every_nth_;
+  const int32_t max_width_;
+  const Callback callback_;
+  uint64_t frame_count_ = 0;
+  uint64_t sequence_ = 0;
+  uint64_t dropped_frames_ = 0;
+  int32_t next_slot_ = 0;
+  // The current ring is the last one.
+  std::vector<Region> regions_;
+  size_t slot_size_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_STREAM_H_
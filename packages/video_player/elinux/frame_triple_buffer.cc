@@ -0,0 +1,61 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "frame_triple_buffer.h"
+
+FrameTripleBuffer::~FrameTripleBuffer() { Reset(); }
+
+void FrameTripleBuffer::Publish(GstBuffer* buffer, GstCaps* caps,
+                                int32_t width, int32_t height,
+                                const Timestamps& timestamps) {
+  // The back slot holds either a frame the consumer has already released or
+  // one that was dropped, so the producer is free to overwrite it.
+  auto& slot = slots_[back_];
+  if (slot.buffer) {
+    gst_buffer_unref(slot.buffer);
+  }
+  if (slot.caps) {
+    gst_caps_unref(slot.caps);
+  }
+  slot.buffer = gst_buffer_ref(buffer);
+  slot.caps = gst_caps_ref(caps);
+  slot.width = width;
+  slot.height = height;
+  slot.timestamps = timestamps;
+
+  auto previous =
+      middle_.exchange(back_ | kDirtyFlag, std::memory_order_acq_rel);
+  back_ = previous & kIndexMask;
+  published_.fetch_add(1, std::memory_order_relaxed);
+  if (previous & kDirtyFlag) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+const FrameTripleBuffer::Frame& FrameTripleBuffer::Acquire() {
+  if (HasNewFrame()) {
+    auto previous = middle_.exchange(front_, std::memory_order_acq_rel);
+    front_ = previous & kIndexMask;
+  }
+  return slots_[front_];
+}
+
+bool FrameTripleBuffer::HasNewFrame() const {
+  return (middle_.load(std::memory_order_acquire) & kDirtyFlag) != 0;
+}
+
+void FrameTripleBuffer::Reset() {
+  for (auto& slot : slots_) {
+    if (slot.buffer) {
+      gst_buffer_unref(slot.buffer);
+    }
+    if (slot.caps) {
+      gst_caps_unref(slot.caps);
+    }
+    slot = Frame();
+  }
+  back_ = 0;
+  middle_.store(1, std::memory_order_release);
+  front_ = 2;
+}
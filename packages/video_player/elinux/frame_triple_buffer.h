@@ -0,0 +1,89 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_TRIPLE_BUFFER_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_TRIPLE_BUFFER_H_
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <cstdint>
+
+// A lock-free triple buffer of GstBuffer references shared between a single
+// producer (the GStreamer streaming thread) and a single consumer (the
+// texture callback on the raster thread).
+//
+// The producer never waits for the consumer: Publish() always succeeds and
+// replaces a frame that hasn't been consumed yet, which is counted as a
+// dropped frame. The consumer always gets the newest complete frame.
+class FrameTripleBuffer {
+ public:
+  // When the frame went through the pipeline, in microseconds of the
+  // monotonic clock. Zero if unknown.
+  struct Timestamps {
+    int64_t decoded = 0;
+    int64_t handoff = 0;
+    // How long before |decoded| the camera captured the frame, according to
+    // the NTP time of the RTCP sender reports.
+    int64_t capture_latency = 0;
+    bool has_capture_latency = false;
+  };
+
+  struct Frame {
+    GstBuffer* buffer = nullptr;
+    GstCaps* caps = nullptr;
+    int32_t width = 0;
+    int32_t height = 0;
+    Timestamps timestamps;
+  };
+
+  FrameTripleBuffer() = default;
+  ~FrameTripleBuffer();
+
+  // Prevent copying.
+  FrameTripleBuffer(FrameTripleBuffer const&) = delete;
+  FrameTripleBuffer& operator=(FrameTripleBuffer const&) = delete;
+
+  // Publishes a new frame. Takes new references to |buffer| and |caps|. Must
+  // only be called from the producer thread.
+  void Publish(GstBuffer* buffer, GstCaps* caps, int32_t width,
+               int32_t height, const Timestamps& timestamps);
+
+  // Returns the newest published frame, or the previously returned one if
+  // nothing new has been published since. The frame stays valid until the
+  // next call. Must only be called from the consumer thread.
+  const Frame& Acquire();
+
+  // Returns true if a frame has been published since the last Acquire().
+  bool HasNewFrame() const;
+
+  // Releases all the held frames. Must not run concurrently with Publish()
+  // or Acquire().
+  void Reset();
+
+  uint64_t GetPublishedFrameCount() const {
+    return published_.load(std::memory_order_relaxed);
+  }
+  uint64_t GetDroppedFrameCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint8_t kIndexMask = 0x03;
+  static constexpr uint8_t kDirtyFlag = 0x04;
+
+  Frame slots_[3];
+  // Owned by the producer.
+  uint8_t back_ = 0;
+  // Shared. The lower bits are the slot index, |kDirtyFlag| is set while
+  // the slot holds a frame the consumer hasn't seen yet.
+  std::atomic<uint8_t> middle_{1};
+  // Owned by the consumer.
+  uint8_t front_ = 2;
+
+  std::atomic<uint64_t> published_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_FRAME_TRIPLE_BUFFER_H_
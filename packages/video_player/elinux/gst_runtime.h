@@ -0,0 +1,49 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_RUNTIME_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_RUNTIME_H_
+
+#include <gst/gst.h>
+
+#include <functional>
+
+// The GStreamer runtime shared by the plugins of the process: video_player,
+// camera and audioplayers each have a copy of this file, but the copies
+// share one state, attached to the default GstRegistry, so that
+//  - GStreamer is deinitialized once the last plugin releases it, rather
+//    than by the first plugin destroyed, under the others,
+//  - one thread runs the GMainContext the buses are dispatched on,
+//  - one pool of threads runs the plugins' blocking tasks.
+//
+// The state is a plain C struct, since the copies may not be built by the
+// same version of the plugins: its quark is renamed whenever it changes.
+class GstRuntime {
+ public:
+  // Starts initializing GStreamer on a thread of its own, and returns at
+  // once, so that the registry scan of gst_init(), which is the slowest part
+  // of the startup otherwise, overlaps the launch of the engine. Called when
+  // the plugins register, which acquire the runtime on first use.
+  static void StartInit();
+
+  // Initializes GStreamer on the first call of the process. Each successful
+  // call must be balanced by a Release(). Waits for StartInit() if it is
+  // still running. Returns false if GStreamer can't be initialized.
+  static bool Acquire();
+  // Stops the shared threads and deinitializes GStreamer on the last call of
+  // the process. GStreamer can't be initialized again afterwards.
+  static void Release();
+
+  // The context run by the shared thread. Valid while the runtime is
+  // acquired.
+  static GMainContext* GetMainContext();
+
+  // Runs |task| on the shared pool. Must be called while the runtime is
+  // acquired.
+  static void RunTask(std::function<void()> task);
+
+  GstRuntime() = delete;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_RUNTIME_H_
@@ -4,28 +4,487 @@
 
 #include "gst_video_player.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <random>
+
+#include "asset_cache.h"
+#include "download_cache.h"
+#include "gst_runtime.h"
+#include "plugin_log.h"
+#include "thread_policy.h"
 
 #define MAX_WIDTH 8192
 #define MAX_HEIGHT 8192
 
+namespace {
+constexpr int32_t kBytesPerPixel = 4;
+
+// How often the reconnect supervisor checks that an RTSP stream is alive.
+constexpr auto kStallCheckInterval = std::chrono::seconds(1);
+// A playing RTSP stream without a frame for this long is reconnected.
+constexpr int64_t kStallTimeoutMs = 5000;
+// How slowly the QoS floor of a live stream follows a higher lateness, in
+// frames.
+constexpr GstClockTimeDiff kQosFloorRise = 256;
+constexpr int64_t kReconnectInitialBackoffMs = 500;
+constexpr int64_t kReconnectMaxBackoffMs = 30000;
+// How long a restarted source may take to deliver a frame when no preroll
+// timeout is set.
+constexpr int64_t kReconnectTimeoutMs = 10000;
+
+// From this rate on, only the key frames are decoded, and the audio is
+// dropped.
+constexpr double kKeyUnitTrickModeRate = 4.0;
+
+// How long the texture must be shown at a new size before the output is
+// scaled to it.
+constexpr int64_t kOutputSizeSettleMs = 500;
+// The output is scaled down to at most 1/8 of the decoded size.
+constexpr int kMaxOutputShift = 3;
+// How much larger than the texture a smaller output must still be.
+constexpr double kOutputSizeMargin = 1.1;
+// How far apart in percent the aspect ratios of two resolutions may be for
+// them to share an output size.
+constexpr int64_t kAspectRatioTolerance = 1;
+
+// More than the decoder, converter and queue hold at once.
+constexpr size_t kMaxPendingDecodeTimestamps = 32;
+// From 1900-01-01, the NTP epoch, to 1970-01-01.
+constexpr int64_t kNtpToUnixEpochUs = INT64_C(2208988800) * 1000000;
+
+#ifdef USE_YUV_SHADER
+// Planar YUV is converted to RGBA by YuvTextureRenderer on the GPU.
+#define OUTPUT_FORMAT "format={ NV12, I420 }"
+#else
+#define OUTPUT_FORMAT "format=RGBA"
+#endif  // USE_YUV_SHADER
+
+// GST_PLAY_FLAG_AUDIO and GST_PLAY_FLAG_DOWNLOAD of playbin, which has no
+// public header.
+constexpr guint kPlayFlagAudio = 1 << 1;
+constexpr guint kPlayFlagText = 1 << 2;
+constexpr guint kPlayFlagDownload = 1 << 7;
+
+// The adaptive demuxers, which select the variant of a stream.
+constexpr const char* kAdaptiveDemuxers[] = {
+    "hlsdemux", "hlsdemux2", "dashdemux", "dashdemux2", "mssdemux",
+    "mssdemux2"};
+// Posted by an adaptive demuxer for each downloaded fragment.
+constexpr char kFragmentStatistics[] = "adaptive-streaming-statistics";
+// Posted by OnTextureFetched() to seek back from the bus bridge thread.
+constexpr char kIdleResume[] = "elinux-idle-resume";
+// How far ahead of its running time the sink of a file releases a frame to
+// the presentation queue, about two vsyncs at 60 Hz.
+constexpr GstClockTimeDiff kPresentationLead = 35 * GST_MSECOND;
+// The first fragments are played at the start bitrate of the ABR policy.
+constexpr int kAbrRampFragments = 3;
+// The weight of a new fragment in the measured bandwidth.
+constexpr double kBandwidthSmoothing = 0.3;
+// The heights of the usual variants, which a texture size is rounded up to.
+constexpr int32_t kVariantHeights[] = {144, 240, 360, 480, 720, 1080, 1440,
+                                       2160};
+
+constexpr char kOutputCaps[] = "video/x-raw," OUTPUT_FORMAT;
+
+#ifdef USE_EGL_IMAGE_DMABUF
+// Prefers DMABUF memory so that the frames can be imported as EGLImages
+// without a copy, and falls back to system memory if upstream can't export
+// it.
+constexpr char kDmabufOutputCaps[] =
+    "video/x-raw(memory:DMABuf)," OUTPUT_FORMAT "; video/x-raw," OUTPUT_FORMAT;
+
+GQuark GetEGLImageQuark() {
+  static const GQuark quark =
+      g_quark_from_static_string("GstVideoPlayerEGLImage");
+  return quark;
+}
+
+// The number of frames the RTSP pipeline keeps referenced downstream of the
+// decoder: one in the queue, three in the frame ring and one being drawn.
+constexpr guint kHeldFrameCount = 5;
+#endif  // USE_EGL_IMAGE_DMABUF
+
+// How long rtspsrc waits for UDP packets before falling back to TCP.
+constexpr guint64 kUdpFallbackTimeoutUs = 2 * 1000 * 1000;
+
+// The limit of the timeshift buffer, which 30 seconds of a 16 Mbit/s stream
+// fit in.
+constexpr int64_t kTimeshiftMaxBytes = 64 * 1024 * 1024;
+
+// The jitter buffer of a WebRTC stream, which leaves room for a
+// retransmission on a local network.
+constexpr guint kWebRtcLatencyMs = 20;
+// The codecs offered to a WHEP server, all of which kRtpCodecs decodes.
+constexpr char kWebRtcVideoCaps[] =
+    "application/x-rtp,media=video,encoding-name=H264,payload=102,"
+    "clock-rate=90000;"
+    "application/x-rtp,media=video,encoding-name=H265,payload=103,"
+    "clock-rate=90000";
+
+// The chain built for each RTP encoding-name. The decoder is the first one
+// of the capability registry that can be created.
+struct RtpCodec {
+  const char* encoding_name;
+  const char* depay;
+  // Null if the depayloader output needs no parser.
+  const char* parse;
+};
+
+constexpr RtpCodec kRtpCodecs[] = {
+    {"H264", "rtph264depay", "h264parse"},
+    {"H265", "rtph265depay", "h265parse"},
+    {"AV1", "rtpav1depay", "av1parse"},
+    {"JPEG", "rtpjpegdepay", "jpegparse"},
+};
+
+// The demuxers of the direct file pipeline, by the extension of the file.
+struct FileContainer {
+  const char* extension;
+  const char* demuxer;
+};
+
+constexpr FileContainer kFileContainers[] = {
+    {".mp4", "qtdemux"},         {".m4v", "qtdemux"},
+    {".mov", "qtdemux"},         {".mkv", "matroskademux"},
+    {".webm", "matroskademux"},
+};
+
+// The chain built for each media type the demuxer exposes, keyed by the
+// codec names of the capability registry.
+struct FileCodec {
+  const char* media_type;
+  const char* codec;
+  // Null if the decoders take the demuxer output as is.
+  const char* parse;
+};
+
+constexpr FileCodec kFileCodecs[] = {
+    {"video/x-h264", "H264", "h264parse"}, {"video/x-h265", "H265", "h265parse"},
+    {"video/x-av1", "AV1", "av1parse"},    {"video/x-vp9", "VP9", "vp9parse"},
+    {"video/x-vp8", "VP8", nullptr},
+};
+
+// The audio of the direct file pipeline, where only the decoder is
+// autoplugged. The pipeline parser links decodebin once its pad appears.
+constexpr char kFileAudioBranch[] =
+    "queue ! decodebin ! audioconvert ! audioresample ! volume name=volume ! "
+    "autoaudiosink";
+
+// A frame handed to the renderer without a copy. The buffer stays referenced
+// and mapped until GstVideoPlayer::ReleaseFrameBuffer() is called.
+struct MappedFrame {
+  GstBuffer* buffer;
+  GstMapInfo map;
+};
+
+// Gets the offset and the row stride of the first plane. GstVideoMeta is
+// attached by elements that pad rows, e.g. hardware converters.
+void GetPlaneLayout(GstBuffer* buffer, int32_t width, gsize& offset,
+                    int32_t& stride) {
+  auto* meta = gst_buffer_get_video_meta(buffer);
+  if (meta) {
+    offset = meta->offset[0];
+    stride = meta->stride[0];
+  } else {
+    offset = 0;
+    stride = width * kBytesPerPixel;
+  }
+}
+
+// Returns true if the frame is a single memory block without row padding, so
+// that mapping it gives the exact layout FlutterDesktopPixelBuffer expects.
+bool IsPackedFrame(GstBuffer* buffer, int32_t width, int32_t height) {
+  if (gst_buffer_n_memory(buffer) != 1) {
+    return false;
+  }
+
+  gsize offset;
+  int32_t stride;
+  GetPlaneLayout(buffer, width, offset, stride);
+  return offset == 0 && stride == width * kBytesPerPixel &&
+         gst_buffer_get_size(buffer) >=
+             static_cast<gsize>(stride) * static_cast<gsize>(height);
+}
+
+GstElement* CreateColorConverterChain(
+    const CapabilityRegistry::Converter& converter) {
+  std::vector<GstElement*> elements(converter.elements.size(), nullptr);
+  int count = 0;
+  for (const auto& name : converter.elements) {
+    elements[count] = gst_element_factory_make(name.c_str(), nullptr);
+    if (!elements[count]) {
+      for (int i = 0; i < count; i++) {
+        gst_object_unref(elements[i]);
+      }
+      return nullptr;
+    }
+    count++;
+  }
+  if (count == 1) {
+    return elements[0];
+  }
+
+  // Wraps the chain in a bin so that it can be used like a single element.
+  auto* bin = gst_bin_new("videoconvert");
+  for (int i = 0; i < count; i++) {
+    gst_bin_add(GST_BIN(bin), elements[i]);
+    if (i > 0 && !gst_element_link(elements[i - 1], elements[i])) {
+      gst_object_unref(bin);
+      return nullptr;
+    }
+  }
+  auto* sinkpad = gst_element_get_static_pad(elements[0], "sink");
+  auto* srcpad = gst_element_get_static_pad(elements[count - 1], "src");
+  gst_element_add_pad(bin, gst_ghost_pad_new("sink", sinkpad));
+  gst_element_add_pad(bin, gst_ghost_pad_new("src", srcpad));
+  gst_object_unref(sinkpad);
+  gst_object_unref(srcpad);
+  return bin;
+}
+
+// Creates the color conversion stage in front of the RGBA caps filter, with
+// the first backend of the registry that can be created. videoconvert is the
+// last resort.
+GstElement* CreateColorConverter() {
+  for (const auto& converter :
+       CapabilityRegistry::GetInstance().GetConverters()) {
+    auto* element = CreateColorConverterChain(converter);
+    if (element) {
+      return element;
+    }
+    std::cerr << "Failed to create " << converter.name << std::endl;
+  }
+  std::cerr << "No suitable color converter found!" << std::endl;
+  return nullptr;
+}
+
+// Returns false if |decoder| doesn't have a thread count setting.
+bool SetDecoderThreadCount(GstElement* decoder, int threads) {
+  // avdec_* and openh264dec call it "max-threads", dav1d "n-threads".
+  for (const auto* name : {"max-threads", "n-threads"}) {
+    if (g_object_class_find_property(G_OBJECT_GET_CLASS(decoder), name)) {
+      g_object_set(G_OBJECT(decoder), name, threads, NULL);
+      return true;
+    }
+  }
+  return false;
+}
+
+const RtpCodec* FindRtpCodec(const gchar* encoding_name) {
+  for (const auto& codec : kRtpCodecs) {
+    if (g_ascii_strcasecmp(codec.encoding_name, encoding_name) == 0) {
+      return &codec;
+    }
+  }
+  return nullptr;
+}
+
+// Returns the demuxer of the direct file pipeline for |uri|, or null if it
+// must be autoplugged.
+const char* FindFileDemuxer(const std::string& uri) {
+  if (!gst_uri_has_protocol(uri.c_str(), "file")) {
+    return nullptr;
+  }
+  for (const auto& container : kFileContainers) {
+    if (g_str_has_suffix(uri.c_str(), container.extension)) {
+      auto* factory = gst_element_factory_find(container.demuxer);
+      if (!factory) {
+        return nullptr;
+      }
+      gst_object_unref(factory);
+      return container.demuxer;
+    }
+  }
+  return nullptr;
+}
+
+const FileCodec* FindFileCodec(const gchar* media_type) {
+  for (const auto& codec : kFileCodecs) {
+    if (g_strcmp0(codec.media_type, media_type) == 0) {
+      return &codec;
+    }
+  }
+  return nullptr;
+}
+
+GstElement* CreateDecoder(const char* codec) {
+  for (const auto& decoder :
+       CapabilityRegistry::GetInstance().GetDecoders(codec)) {
+    auto* element = gst_element_factory_make(decoder.name.c_str(), "decoder");
+    if (element) {
+      return element;
+    }
+    std::cerr << "Failed to create " << decoder.name << std::endl;
+  }
+  std::cerr << "No suitable " << codec << " decoder found!"
+            << std::endl;
+  return nullptr;
+}
+
+// Creates the mixer of a compositor pipeline and sets |output| to the element
+// to link the sink to. glvideomixer is preferred since it scales and blends
+// the tiles on the GPU.
+GstElement* CreateCompositor(GstElement* pipeline, GstElement** output) {
+  for (const auto& compositor :
+       CapabilityRegistry::GetInstance().GetCompositors()) {
+    auto* mixer =
+        gst_element_factory_make(compositor.name.c_str(), "compositor");
+    auto* download =
+        compositor.output.empty()
+            ? nullptr
+            : gst_element_factory_make(compositor.output.c_str(), nullptr);
+    if (!mixer || (!compositor.output.empty() && !download)) {
+      for (auto* element : {mixer, download}) {
+        if (element) {
+          gst_object_unref(element);
+        }
+      }
+      std::cerr << "Failed to create " << compositor.name << std::endl;
+      continue;
+    }
+    if (!download) {
+      gst_bin_add(GST_BIN(pipeline), mixer);
+      std::cout << "Compositor: " << compositor.name << std::endl;
+      *output = mixer;
+      return mixer;
+    }
+    gst_bin_add_many(GST_BIN(pipeline), mixer, download, NULL);
+    if (gst_element_link(mixer, download)) {
+      std::cout << "Compositor: " << compositor.name << std::endl;
+      *output = download;
+      return mixer;
+    }
+    gst_bin_remove_many(GST_BIN(pipeline), mixer, download, NULL);
+    std::cerr << "Failed to link " << compositor.name << std::endl;
+  }
+  std::cerr << "No suitable compositor found!" << std::endl;
+  return nullptr;
+}
+
+#ifdef USE_EGL_IMAGE_DMABUF
+// Asks V4L2 based elements to export their capture buffers as DMABUF instead
+// of copying them to system memory.
+void RequestDmabufOutput(GstElement* element) {
+  if (!element) {
+    return;
+  }
+  if (g_object_class_find_property(G_OBJECT_GET_CLASS(element),
+                                   "capture-io-mode")) {
+    gst_util_set_object_arg(G_OBJECT(element), "capture-io-mode", "dmabuf");
+  }
+}
+
+// appsink doesn't propose a pool in the allocation query, so upstream pools
+// would be sized as if the sink released each frame right away. Answers it on behalf
+// of the sink, so that a decoder exporting a fixed set of DMABUFs doesn't
+// starve while the player holds frames, and allows padded strides.
+GstPadProbeReturn OnVideoSinkQuery(GstPad* pad, GstPadProbeInfo* info,
+                                   gpointer user_data) {
+  auto* query = GST_PAD_PROBE_INFO_QUERY(info);
+  if (GST_QUERY_TYPE(query) != GST_QUERY_ALLOCATION) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstCaps* caps = nullptr;
+  gboolean need_pool = FALSE;
+  gst_query_parse_allocation(query, &caps, &need_pool);
+  GstVideoInfo video_info;
+  guint size = 0;
+  if (caps && gst_video_info_from_caps(&video_info, caps)) {
+    size = GST_VIDEO_INFO_SIZE(&video_info);
+  }
+  gst_query_add_allocation_pool(query, nullptr, size, kHeldFrameCount, 0);
+  gst_query_add_allocation_meta(query, GST_VIDEO_META_API_TYPE, nullptr);
+  return GST_PAD_PROBE_HANDLED;
+}
+#endif  // USE_EGL_IMAGE_DMABUF
+
+// The reference timestamps rtpjitterbuffer attaches from the RTCP sender
+// reports.
+GstCaps* GetNtpReferenceCaps() {
+  static GstCaps* caps = gst_caps_new_empty_simple("timestamp/x-ntp");
+  return caps;
+}
+
+int64_t NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+// In the order of PipelineTraits: create, apply_uri, is_live,
+// has_single_decoder, has_fixed_size and supports_segment_loop.
+const GstVideoPlayer::PipelineTraits GstVideoPlayer::kFilePipeline = {
+    &GstVideoPlayer::CreateAutoDecodeFilePipeline,
+    &GstVideoPlayer::ApplyFileUri,
+    false,
+    true,
+    false,
+    true,
+};
+
+// Its demuxer depends on the container, so it isn't retargeted.
+const GstVideoPlayer::PipelineTraits GstVideoPlayer::kDirectFilePipeline = {
+    &GstVideoPlayer::CreateDirectFilePipeline,
+    nullptr,
+    false,
+    true,
+    false,
+    true,
+};
+
+const GstVideoPlayer::PipelineTraits GstVideoPlayer::kRtspPipeline = {
+    &GstVideoPlayer::CreateLowLatencyRTSPPipeline,
+    &GstVideoPlayer::ApplyRtspUri,
+    true,
+    true,
+    false,
+    false,
+};
+
+const GstVideoPlayer::PipelineTraits GstVideoPlayer::kWebRtcPipeline = {
+    &GstVideoPlayer::CreateWebRtcPipeline,
+    &GstVideoPlayer::ApplyWebRtcUri,
+    true,
+    true,
+    false,
+    false,
+};
+
+const GstVideoPlayer::PipelineTraits GstVideoPlayer::kCompositorPipeline = {
+    &GstVideoPlayer::CreateCompositorPipeline,
+    nullptr,
+    false,
+    false,
+    true,
+    false,
+};
+
 GstVideoPlayer::GstVideoPlayer(
     const std::string& uri, std::unique_ptr<VideoPlayerStreamHandler> handler)
-    : stream_handler_(std::move(handler)) {
-    gst_.pipeline = nullptr;
-    gst_.playbin = nullptr;
-    gst_.video_convert = nullptr;
-    gst_.video_sink = nullptr;
-    gst_.output = nullptr;
-    gst_.bus = nullptr;
-    gst_.buffer = nullptr;
-    gst_.source = nullptr;
-    gst_.depay = nullptr;
-    gst_.parse = nullptr;
-    gst_.decoder = nullptr;
-
-  uri_ = ParseUri(uri);
-  is_rtsp_ = (uri_.find("rtsp://") == 0);
+    : GstVideoPlayer(uri, std::move(handler), FileOptions()) {}
+
+GstVideoPlayer::GstVideoPlayer(
+    const std::string& uri, std::unique_ptr<VideoPlayerStreamHandler> handler,
+    const FileOptions& file_options)
+    : file_options_(file_options), stream_handler_(std::move(handler)) {
+  track_selection_.audio = !file_options_.muted;
+  uri_ = PrepareDownload(ExtractUriOptions(ParseUri(uri)));
+  if (IsRtspUri(uri_)) {
+    traits_ = &kRtspPipeline;
+  } else if (IsWebRtcUri(uri_)) {
+    traits_ = &kWebRtcPipeline;
+  } else if (file_options_.fast_start && FindFileDemuxer(uri_)) {
+    traits_ = &kDirectFilePipeline;
+  } else {
+    traits_ = &kFilePipeline;
+  }
   if (!CreatePipeline()) {
     std::cerr << "Failed to create a pipeline" << std::endl;
     DestroyPipeline();
@@ -33,40 +492,986 @@ GstVideoPlayer::GstVideoPlayer(
   }
 }
 
-GstVideoPlayer::~GstVideoPlayer() {
-#ifdef USE_EGL_IMAGE_DMABUF
-  UnrefEGLImage();
-#endif  // USE_EGL_IMAGE_DMABUF
-  Stop();
-  DestroyPipeline();
+GstVideoPlayer::GstVideoPlayer(
+    const std::vector<std::string>& uris, int32_t width, int32_t height,
+    std::unique_ptr<VideoPlayerStreamHandler> handler)
+    : width_(width),
+      height_(height),
+      stream_handler_(std::move(handler)) {
+  traits_ = &kCompositorPipeline;
+  for (const auto& uri : uris) {
+    tile_uris_.push_back(ParseUri(uri));
+  }
+  if (!CreatePipeline()) {
+    std::cerr << "Failed to create a compositor pipeline" << std::endl;
+    DestroyPipeline();
+    return;
+  }
+}
+
+GstVideoPlayer::~GstVideoPlayer() {
+  StopReconnectSupervisor();
+  keyframe_index_.Reset();
+  if (preload_thread_.joinable()) {
+    // Aborts a preroll that is still waiting for the stream.
+    if (gst_.pipeline) {
+      gst_element_set_state(gst_.pipeline, GST_STATE_NULL);
+    }
+    preload_thread_.join();
+  }
+#ifdef USE_EGL_IMAGE_DMABUF
+  UnrefEGLImage();
+#endif  // USE_EGL_IMAGE_DMABUF
+  Stop();
+  DestroyPipeline();
+  SetTaskPool(nullptr);
+}
+
+#ifdef USE_TRACE_EVENTS
+// static
+std::string GstVideoPlayer::CreateTraceTrack() {
+  static std::atomic<int> count{0};
+  return "video_player " + std::to_string(++count);
+}
+#endif  // USE_TRACE_EVENTS
+
+// static
+void GstVideoPlayer::GstLibraryLoad() {
+  if (!GstRuntime::Acquire()) {
+    return;
+  }
+  CapabilityRegistry::GetInstance().Probe();
+}
+
+// static
+void GstVideoPlayer::GstLibraryUnload() { GstRuntime::Release(); }
+
+bool GstVideoPlayer::Init() {
+  if (preload_thread_.joinable()) {
+    preload_thread_.join();
+  }
+  if (!gst_.pipeline) {
+    return false;
+  }
+
+  // Prerolls before getting information from the pipeline.
+  if (is_prerolled_) {
+    // The preroll frame was decoded before the handler was attached.
+    if (frames_.HasNewFrame() || presentation_queue_.HasPending()) {
+      stream_handler()->OnNotifyFrameDecoded();
+    }
+  } else if (!Preroll()) {
+    gst_element_set_state(gst_.pipeline, GST_STATE_NULL);
+    return false;
+  }
+  is_prerolled_ = true;
+  if (auto_repeat_) {
+    StartSegmentLoop();
+  }
+  // Reading a remote file twice would cost more than the seeks save.
+  if (traits_->has_single_decoder && !keyframe_index_.IsReady() &&
+      gst_uri_has_protocol(uri_.c_str(), "file")) {
+    keyframe_index_.Build(uri_);
+  }
+
+  // Sets internal video size and buffier.
+  GetVideoSize(width_, height_);
+
+  // stream_handler_->OnNotifyInitialized();
+
+  return true;
+}
+
+void GstVideoPlayer::AbortPreroll() {
+  if (gst_.pipeline) {
+    gst_element_set_state(gst_.pipeline, GST_STATE_NULL);
+  }
+}
+
+void GstVideoPlayer::Preload() {
+  if (!gst_.pipeline || is_prerolled_ || preload_thread_.joinable()) {
+    return;
+  }
+  preload_thread_ = std::thread([this]() { is_prerolled_ = Preroll(); });
+}
+
+bool GstVideoPlayer::Retarget(const std::string& uri) {
+  if (preload_thread_.joinable()) {
+    preload_thread_.join();
+  }
+  rtsp_transport_ = RtspTransport::kTcp;
+  auto parsed_uri = ExtractUriOptions(ParseUri(uri));
+  if (!gst_.pipeline || !traits_->apply_uri ||
+      IsRtspUri(parsed_uri) != IsRtsp() ||
+      IsWebRtcUri(parsed_uri) != IsWebRtc()) {
+    return false;
+  }
+
+  if (gst_element_set_state(gst_.pipeline, GST_STATE_READY) ==
+      GST_STATE_CHANGE_FAILURE) {
+    std::cerr << "Failed to change the state to READY" << std::endl;
+    return false;
+  }
+  gst_element_get_state(gst_.pipeline, nullptr, nullptr, GST_CLOCK_TIME_NONE);
+
+  // Nothing is streaming in READY, so the per-stream state can be reset.
+  frames_.Reset();
+  presentation_queue_.Clear();
+  ReleaseCaptureFrame();
+  if (sample_caps_) {
+    gst_caps_unref(sample_caps_);
+    sample_caps_ = nullptr;
+  }
+  width_ = 0;
+  height_ = 0;
+  latency_budget_ms_ = 0;
+  late_frames_ = 0;
+  qos_dropped_frames_ = 0;
+  has_qos_floor_ = false;
+  latency_stats_.Reset();
+  {
+    std::lock_guard<std::mutex> lock(mutex_decode_timestamps_);
+    decode_timestamps_.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_abr_);
+    if (adaptive_demux_) {
+      gst_object_unref(adaptive_demux_);
+      adaptive_demux_ = nullptr;
+    }
+    abr_policy_ = {};
+    abr_follows_texture_ = false;
+    abr_fragments_ = 0;
+    abr_texture_height_ = 0;
+  }
+  measured_bandwidth_ = 0;
+  variant_width_ = 0;
+  variant_height_ = 0;
+  key_frame_only_ = false;
+  wait_for_key_frame_ = false;
+  frames_since_fetch_ = 0;
+  is_idle_throttled_ = false;
+  auto_repeat_ = false;
+  is_segment_looping_ = false;
+  is_subtitles_enabled_ = false;
+  overlay_seqnum_ = 0;
+  keyframe_index_.Reset();
+  is_scrubbing_ = false;
+  scrub_position_ = 0;
+  // The new stream starts with a segment at the normal rate.
+  playback_rate_ = 1.0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_output_size_);
+    if (output_shift_ > 0 || is_output_size_kept_) {
+      g_object_set(G_OBJECT(gst_.output_filter), "caps", output_caps_, NULL);
+    }
+    requested_width_ = 0;
+    requested_height_ = 0;
+    is_output_size_kept_ = false;
+    output_shift_ = 0;
+    output_source_width_ = 0;
+    output_source_height_ = 0;
+  }
+  is_buffering_ = false;
+  is_playing_ = false;
+  is_prerolled_ = false;
+  last_frame_time_ms_ = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_reconnect_);
+    reconnect_requested_ = false;
+    reconnect_stats_ = {};
+  }
+
+  uri_ = PrepareDownload(parsed_uri);
+  (this->*traits_->apply_uri)();
+  return true;
+}
+
+void GstVideoPlayer::ApplyFileUri() {
+  ApplyDownloadSettings();
+  ApplySubtitles();
+  g_object_set(G_OBJECT(file_.playbin), "uri", uri_.c_str(), NULL);
+}
+
+void GstVideoPlayer::ApplyRtspUri() {
+  g_object_set(G_OBJECT(rtsp_.source), "location", uri_.c_str(), NULL);
+  ApplyRtspTransport();
+}
+
+void GstVideoPlayer::ApplyWebRtcUri() {
+  // whep:// and wheps:// stand for the HTTP endpoint of the server.
+  const auto endpoint =
+      (uri_.find("wheps://") == 0 ? "https://" : "http://") +
+      uri_.substr(uri_.find("://") + 3);
+  g_object_set(G_OBJECT(rtsp_.source), "whep-endpoint", endpoint.c_str(),
+               NULL);
+}
+
+void GstVideoPlayer::SetStreamHandler(
+    std::unique_ptr<VideoPlayerStreamHandler> handler) {
+  std::lock_guard<std::shared_mutex> lock(mutex_stream_handler_);
+  stream_handler_ = std::move(handler);
+}
+
+// static
+bool GstVideoPlayer::IsRtspUri(const std::string& uri) {
+  return uri.find("rtsp://") == 0;
+}
+
+// static
+bool GstVideoPlayer::IsWebRtcUri(const std::string& uri) {
+  return uri.find("whep://") == 0 || uri.find("wheps://") == 0;
+}
+
+// static
+bool GstVideoPlayer::ParseRtspTransport(const std::string& name,
+                                        RtspTransport& transport) {
+  if (name == "tcp") {
+    transport = RtspTransport::kTcp;
+  } else if (name == "udp") {
+    transport = RtspTransport::kUdp;
+  } else if (name == "multicast") {
+    transport = RtspTransport::kMulticast;
+  } else if (name == "udp-first") {
+    transport = RtspTransport::kUdpFirst;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void GstVideoPlayer::SetRtspTransport(RtspTransport transport) {
+  rtsp_transport_ = transport;
+  ApplyRtspTransport();
+}
+
+void GstVideoPlayer::ApplyRtspTransport() {
+  if (!rtsp_.source) {
+    return;
+  }
+
+  // GstRTSPLowerTrans: 0x1 is UDP, 0x2 UDP multicast and 0x4 TCP.
+  switch (rtsp_transport_) {
+    case RtspTransport::kTcp:
+      g_object_set(G_OBJECT(rtsp_.source), "protocols", 0x4, NULL);
+      break;
+    case RtspTransport::kUdp:
+      g_object_set(G_OBJECT(rtsp_.source), "protocols", 0x1, NULL);
+      break;
+    case RtspTransport::kMulticast:
+      g_object_set(G_OBJECT(rtsp_.source), "protocols", 0x2, NULL);
+      break;
+    case RtspTransport::kUdpFirst:
+      // rtspsrc tries the transports in order and switches to TCP when no
+      // UDP packet arrives within tcp-timeout, e.g. behind a NAT.
+      g_object_set(G_OBJECT(rtsp_.source), "protocols", 0x1 | 0x2 | 0x4,
+                   "tcp-timeout", kUdpFallbackTimeoutUs, NULL);
+      break;
+  }
+}
+
+std::string GstVideoPlayer::PrepareDownload(const std::string& uri) {
+  std::lock_guard<std::mutex> lock(mutex_download_);
+  download_uri_.clear();
+  if (download_queue_) {
+    gst_object_unref(download_queue_);
+    download_queue_ = nullptr;
+  }
+  is_download_committed_ = false;
+  if (!DownloadCache::IsNetworkUri(uri)) {
+    return uri;
+  }
+
+  auto& cache = DownloadCache::GetInstance();
+  const auto cached_uri = cache.Lookup(uri);
+  if (!cached_uri.empty()) {
+    return cached_uri;
+  }
+  if (cache.IsEnabled()) {
+    download_uri_ = uri;
+  }
+  return uri;
+}
+
+void GstVideoPlayer::ApplyDownloadSettings() {
+  if (!file_.playbin) {
+    return;
+  }
+
+  guint flags = 0;
+  g_object_get(G_OBJECT(file_.playbin), "flags", &flags, NULL);
+  {
+    std::lock_guard<std::mutex> lock(mutex_download_);
+    if (download_uri_.empty()) {
+      flags &= ~kPlayFlagDownload;
+    } else {
+      flags |= kPlayFlagDownload;
+    }
+  }
+  // -1 is the default of playbin for both.
+  const auto settings = DownloadCache::GetInstance().GetSettings();
+  const gint64 buffer_duration = settings.buffer_duration_ms > 0
+                                     ? settings.buffer_duration_ms * GST_MSECOND
+                                     : -1;
+  const gint buffer_size =
+      settings.buffer_size_bytes > 0 ? settings.buffer_size_bytes : -1;
+  g_object_set(G_OBJECT(file_.playbin), "flags", flags, "buffer-duration",
+               buffer_duration, "buffer-size", buffer_size, NULL);
+}
+
+// static
+void GstVideoPlayer::OnDeepElementAdded(GstBin* bin, GstBin* sub_bin,
+                                        GstElement* element,
+                                        gpointer user_data) {
+  auto* factory = gst_element_get_factory(element);
+  if (!factory) {
+    return;
+  }
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  const auto* klass =
+      gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+  if (klass && strstr(klass, "Decoder") && strstr(klass, "Video")) {
+    self->stats_.SetDecoder(GST_OBJECT_NAME(factory));
+    auto* sink_pad = gst_element_get_static_pad(element, "sink");
+    if (sink_pad) {
+      gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_BUFFER,
+                        OnIdleDecoderSinkBuffer, self, nullptr);
+      gst_object_unref(sink_pad);
+    }
+    return;
+  }
+  for (const auto* name : kAdaptiveDemuxers) {
+    if (g_strcmp0(GST_OBJECT_NAME(factory), name) == 0) {
+      std::lock_guard<std::mutex> lock(self->mutex_abr_);
+      if (self->adaptive_demux_) {
+        gst_object_unref(self->adaptive_demux_);
+      }
+      self->adaptive_demux_ = GST_ELEMENT(gst_object_ref(element));
+      self->abr_fragments_ = 0;
+      self->ApplyAbrPolicy();
+      return;
+    }
+  }
+  if (g_strcmp0(GST_OBJECT_NAME(factory), "filesrc") == 0) {
+    AssetCache::GetInstance().ConfigureSource(element);
+    return;
+  }
+  if (g_strcmp0(GST_OBJECT_NAME(factory), "queue2") != 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(self->mutex_download_);
+  if (self->download_uri_.empty() || self->download_queue_) {
+    return;
+  }
+  // uridecodebin gives a temp-template only to the queue2 downloading the
+  // stream, before adding it.
+  gchar* default_template = nullptr;
+  g_object_get(G_OBJECT(element), "temp-template", &default_template, NULL);
+  if (!default_template) {
+    return;
+  }
+  g_free(default_template);
+  const auto temp_template =
+      DownloadCache::GetInstance().GetTemporaryTemplate(self->download_uri_);
+  if (temp_template.empty()) {
+    return;
+  }
+  g_object_set(G_OBJECT(element), "temp-template", temp_template.c_str(),
+               "temp-remove", TRUE, NULL);
+  self->download_queue_ = GST_ELEMENT(gst_object_ref(element));
+}
+
+void GstVideoPlayer::UpdateBufferedRanges() {
+  const auto duration = GetDuration();
+  if (duration <= 0) {
+    return;
+  }
+  auto* query = gst_query_new_buffering(GST_FORMAT_PERCENT);
+  if (!gst_element_query(gst_.pipeline, query)) {
+    gst_query_unref(query);
+    return;
+  }
+
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  bool is_complete = false;
+  const auto count = gst_query_get_n_buffering_ranges(query);
+  for (guint i = 0; i < count; i++) {
+    gint64 start = 0;
+    gint64 stop = 0;
+    if (!gst_query_parse_nth_buffering_range(query, i, &start, &stop)) {
+      continue;
+    }
+    is_complete = count == 1 && start == 0 && stop >= GST_FORMAT_PERCENT_MAX;
+    ranges.emplace_back(start * duration / GST_FORMAT_PERCENT_MAX,
+                        stop * duration / GST_FORMAT_PERCENT_MAX);
+  }
+  if (ranges.empty()) {
+    gint64 start = -1;
+    gint64 stop = -1;
+    gst_query_parse_buffering_range(query, nullptr, &start, &stop, nullptr);
+    if (start >= 0 && stop > start) {
+      ranges.emplace_back(start * duration / GST_FORMAT_PERCENT_MAX,
+                          stop * duration / GST_FORMAT_PERCENT_MAX);
+    }
+  }
+  gst_query_unref(query);
+
+  if (is_complete) {
+    CommitDownload();
+  }
+  stream_handler()->OnNotifyBufferingUpdate(ranges);
+}
+
+void GstVideoPlayer::CommitDownload() {
+  std::lock_guard<std::mutex> lock(mutex_download_);
+  if (!download_queue_ || is_download_committed_) {
+    return;
+  }
+  gchar* location = nullptr;
+  g_object_get(G_OBJECT(download_queue_), "temp-location", &location, NULL);
+  if (!location) {
+    return;
+  }
+  // The server tells the size, unless the stream is chunked.
+  gint64 size = -1;
+  if (!gst_element_query_duration(download_queue_, GST_FORMAT_BYTES, &size)) {
+    size = -1;
+  }
+  is_download_committed_ =
+      DownloadCache::GetInstance().Commit(download_uri_, location, size);
+  g_free(location);
+}
+
+void GstVideoPlayer::PinLoopingAsset() {
+  GstElement* source = nullptr;
+  if (file_.playbin) {
+    g_object_get(G_OBJECT(file_.playbin), "source", &source, NULL);
+  } else if (file_.source) {
+    source = GST_ELEMENT(gst_object_ref(file_.source));
+  }
+  if (!source) {
+    return;
+  }
+  AssetCache::GetInstance().Pin(source);
+  gst_object_unref(source);
+}
+
+void GstVideoPlayer::SetAbrPolicy(const AbrPolicy& policy) {
+  std::lock_guard<std::mutex> lock(mutex_abr_);
+  abr_policy_ = policy;
+  abr_follows_texture_ = policy.follow_texture_size;
+  ApplyAbrPolicy();
+}
+
+void GstVideoPlayer::ApplyAbrPolicy() {
+  if (!adaptive_demux_) {
+    return;
+  }
+  auto* klass = G_OBJECT_GET_CLASS(adaptive_demux_);
+
+  const bool is_ramping =
+      abr_policy_.start_bitrate > 0 && abr_fragments_ < kAbrRampFragments;
+  int64_t bitrate_cap = abr_policy_.max_bitrate;
+  if (is_ramping &&
+      (bitrate_cap <= 0 || abr_policy_.start_bitrate < bitrate_cap)) {
+    bitrate_cap = abr_policy_.start_bitrate;
+  }
+  bitrate_cap = std::min<int64_t>(bitrate_cap, G_MAXUINT);
+  if (g_object_class_find_property(klass, "start-bitrate") &&
+      abr_policy_.start_bitrate > 0) {
+    g_object_set(G_OBJECT(adaptive_demux_), "start-bitrate",
+                 static_cast<guint>(std::min<int64_t>(
+                     abr_policy_.start_bitrate, G_MAXUINT)),
+                 NULL);
+  }
+  if (g_object_class_find_property(klass, "max-bitrate")) {
+    g_object_set(G_OBJECT(adaptive_demux_), "max-bitrate",
+                 static_cast<guint>(std::max<int64_t>(bitrate_cap, 0)), NULL);
+  } else if (g_object_class_find_property(klass, "connection-speed")) {
+    // The legacy HLS demuxer only takes the bandwidth to select for, in
+    // kbps, which replaces its own estimate until it's set back to zero.
+    // The cap is applied to the bandwidth measured here instead.
+    int64_t speed = 0;
+    if (bitrate_cap > 0) {
+      const int64_t bandwidth = measured_bandwidth_;
+      speed = is_ramping || bandwidth <= 0 ? bitrate_cap
+                                           : std::min(bandwidth, bitrate_cap);
+    }
+    g_object_set(G_OBJECT(adaptive_demux_), "connection-speed",
+                 static_cast<guint>(speed / 1000), NULL);
+  }
+
+  int32_t max_width = abr_policy_.max_width;
+  int32_t max_height = abr_policy_.max_height;
+  if (abr_policy_.follow_texture_size && abr_texture_height_ > 0) {
+    int32_t texture_height = abr_texture_height_;
+    for (const auto height : kVariantHeights) {
+      if (height >= abr_texture_height_) {
+        texture_height = height;
+        break;
+      }
+    }
+    if (max_height <= 0 || texture_height < max_height) {
+      max_height = texture_height;
+    }
+  }
+  if (g_object_class_find_property(klass, "max-video-width")) {
+    g_object_set(G_OBJECT(adaptive_demux_), "max-video-width",
+                 static_cast<guint>(std::max(max_width, 0)), NULL);
+  }
+  if (g_object_class_find_property(klass, "max-video-height")) {
+    g_object_set(G_OBJECT(adaptive_demux_), "max-video-height",
+                 static_cast<guint>(std::max(max_height, 0)), NULL);
+  }
+}
+
+void GstVideoPlayer::UpdateAbrTextureSize(int32_t width, int32_t height) {
+  if (!abr_follows_texture_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_abr_);
+  if (height != abr_texture_height_) {
+    abr_texture_height_ = height;
+    ApplyAbrPolicy();
+  }
+}
+
+void GstVideoPlayer::HandleFragmentStatistics(const GstStructure* structure) {
+  guint64 size = 0;
+  guint64 download_time = 0;
+  if (!structure ||
+      !gst_structure_get_uint64(structure, "fragment-size", &size) ||
+      !gst_structure_get_uint64(structure, "fragment-download-time",
+                                &download_time) ||
+      download_time == 0) {
+    return;
+  }
+
+  const int64_t throughput = size * 8 * GST_SECOND / download_time;
+  const int64_t previous = measured_bandwidth_;
+  const int64_t bandwidth =
+      previous > 0
+          ? previous + static_cast<int64_t>((throughput - previous) *
+                                            kBandwidthSmoothing)
+          : throughput;
+  measured_bandwidth_ = bandwidth;
+  {
+    std::lock_guard<std::mutex> lock(mutex_abr_);
+    abr_fragments_++;
+    // The legacy demuxer is steered with the measured bandwidth, so it
+    // needs every measurement.
+    if (abr_fragments_ == kAbrRampFragments ||
+        (adaptive_demux_ && !g_object_class_find_property(
+                                G_OBJECT_GET_CLASS(adaptive_demux_),
+                                "max-bitrate"))) {
+      ApplyAbrPolicy();
+    }
+  }
+  stream_handler()->OnNotifyThroughput(throughput, bandwidth);
+}
+
+// static
+GstPadProbeReturn GstVideoPlayer::OnOutputSinkEvent(GstPad* pad,
+                                                    GstPadProbeInfo* info,
+                                                    gpointer user_data) {
+  auto* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) != GST_EVENT_CAPS) {
+    return GST_PAD_PROBE_OK;
+  }
+  GstCaps* caps = nullptr;
+  gst_event_parse_caps(event, &caps);
+  auto* structure = caps ? gst_caps_get_structure(caps, 0) : nullptr;
+  int width = 0, height = 0;
+  if (!structure || !gst_structure_get_int(structure, "width", &width) ||
+      !gst_structure_get_int(structure, "height", &height)) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  const bool is_switch =
+      self->variant_width_ > 0 &&
+      (width != self->variant_width_ || height != self->variant_height_);
+  self->variant_width_ = width;
+  self->variant_height_ = height;
+  if (!is_switch) {
+    return GST_PAD_PROBE_OK;
+  }
+  // Before the converter negotiates the new resolution.
+  self->KeepOutputSize(width, height);
+
+  guint bitrate = 0;
+  {
+    std::lock_guard<std::mutex> lock(self->mutex_abr_);
+    if (!self->adaptive_demux_) {
+      return GST_PAD_PROBE_OK;
+    }
+    if (g_object_class_find_property(
+            G_OBJECT_GET_CLASS(self->adaptive_demux_),
+            "current-level-bitrate")) {
+      g_object_get(G_OBJECT(self->adaptive_demux_), "current-level-bitrate",
+                   &bitrate, NULL);
+    }
+  }
+  self->stream_handler()->OnNotifyVariantSwitch(width, height, bitrate);
+  return GST_PAD_PROBE_OK;
+}
+
+// static
+GstPadProbeReturn GstVideoPlayer::OnOutputSinkQuery(GstPad* pad,
+                                                    GstPadProbeInfo* info,
+                                                    gpointer user_data) {
+  auto* query = GST_PAD_PROBE_INFO_QUERY(info);
+  if (GST_QUERY_TYPE(query) == GST_QUERY_ALLOCATION &&
+      !gst_query_find_allocation_meta(
+          query, GST_VIDEO_OVERLAY_COMPOSITION_META_API_TYPE, nullptr)) {
+    gst_query_add_allocation_meta(
+        query, GST_VIDEO_OVERLAY_COMPOSITION_META_API_TYPE, nullptr);
+  }
+  return GST_PAD_PROBE_OK;
 }
 
 // static
-void GstVideoPlayer::GstLibraryLoad() { gst_init(NULL, NULL); }
+GstPadProbeReturn GstVideoPlayer::OnOutputSinkBuffer(GstPad* pad,
+                                                     GstPadProbeInfo* info,
+                                                     gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  auto* meta = gst_buffer_get_video_overlay_composition_meta(
+      GST_PAD_PROBE_INFO_BUFFER(info));
+  // The same composition is attached to every frame it's shown on.
+  const auto seqnum =
+      meta ? gst_video_overlay_composition_get_seqnum(meta->overlay) : 0;
+  if (seqnum == self->overlay_seqnum_) {
+    return GST_PAD_PROBE_OK;
+  }
+  self->overlay_seqnum_ = seqnum;
+
+  std::vector<VideoPlayerStreamHandler::OverlayRectangle> rectangles;
+  const auto count =
+      meta ? gst_video_overlay_composition_n_rectangles(meta->overlay) : 0;
+  for (guint i = 0; i < count; i++) {
+    auto* rectangle =
+        gst_video_overlay_composition_get_rectangle(meta->overlay, i);
+    VideoPlayerStreamHandler::OverlayRectangle overlay_rectangle;
+    guint width = 0, height = 0;
+    gst_video_overlay_rectangle_get_render_rectangle(
+        rectangle, &overlay_rectangle.x, &overlay_rectangle.y, &width,
+        &height);
+    overlay_rectangle.width = static_cast<int32_t>(width);
+    overlay_rectangle.height = static_cast<int32_t>(height);
+    // Owned by the rectangle, which converts it once.
+    auto* pixels = gst_video_overlay_rectangle_get_pixels_unscaled_argb(
+        rectangle, GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+    auto* video_meta = pixels ? gst_buffer_get_video_meta(pixels) : nullptr;
+    GstMapInfo map;
+    if (!video_meta || !gst_buffer_map(pixels, &map, GST_MAP_READ)) {
+      continue;
+    }
+    overlay_rectangle.pixel_width = static_cast<int32_t>(video_meta->width);
+    overlay_rectangle.pixel_height = static_cast<int32_t>(video_meta->height);
+    const size_t row_size = video_meta->width * 4;
+    overlay_rectangle.pixels.resize(row_size * video_meta->height);
+    for (guint row = 0; row < video_meta->height; row++) {
+      memcpy(overlay_rectangle.pixels.data() + row * row_size,
+             map.data + video_meta->offset[0] + row * video_meta->stride[0],
+             row_size);
+    }
+    gst_buffer_unmap(pixels, &map);
+    rectangles.push_back(std::move(overlay_rectangle));
+  }
+  self->stream_handler()->OnNotifyOverlay(rectangles);
+  return GST_PAD_PROBE_OK;
+}
 
 // static
-void GstVideoPlayer::GstLibraryUnload() { gst_deinit(); }
+GstFlowReturn GstVideoPlayer::OnNewTextSample(GstAppSink* sink,
+                                              gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  auto* sample = gst_app_sink_pull_sample(sink);
+  if (!sample) {
+    return GST_FLOW_OK;
+  }
+  auto* buffer = gst_sample_get_buffer(sample);
+  auto* caps = gst_sample_get_caps(sample);
+  auto* segment = gst_sample_get_segment(sample);
+  auto* structure = caps && gst_caps_get_size(caps) > 0
+                        ? gst_caps_get_structure(caps, 0)
+                        : nullptr;
+  GstMapInfo map;
+  if (!self->is_subtitles_enabled_ || !buffer || !segment || !structure ||
+      !gst_structure_has_name(structure, "text/x-raw") ||
+      !gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    gst_sample_unref(sample);
+    return GST_FLOW_OK;
+  }
+  std::string text(reinterpret_cast<const char*>(map.data), map.size);
+  gst_buffer_unmap(buffer, &map);
+  // Some demuxers keep the terminating NUL.
+  text.erase(text.find_last_not_of('\0') + 1);
+  const auto is_markup =
+      g_strcmp0(gst_structure_get_string(structure, "format"),
+                "pango-markup") == 0;
+  const auto start = gst_segment_to_stream_time(segment, GST_FORMAT_TIME,
+                                                GST_BUFFER_PTS(buffer));
+  const int64_t duration_ms =
+      GST_BUFFER_DURATION_IS_VALID(buffer)
+          ? GST_TIME_AS_MSECONDS(GST_BUFFER_DURATION(buffer))
+          : -1;
+  gst_sample_unref(sample);
+  if (!GST_CLOCK_TIME_IS_VALID(start)) {
+    return GST_FLOW_OK;
+  }
+
+  self->stream_handler()->OnNotifySubtitleCue(
+      text, is_markup, GST_TIME_AS_MSECONDS(start), duration_ms);
+  return GST_FLOW_OK;
+}
 
-bool GstVideoPlayer::Init() {
-  if (!gst_.pipeline) {
+bool GstVideoPlayer::SetSubtitles(bool enabled) {
+  if (!file_.playbin) {
     return false;
   }
+  is_subtitles_enabled_ = enabled;
+  ApplySubtitles();
+  return true;
+}
 
-  // Prerolls before getting information from the pipeline.
-  if (!Preroll()) {
-    DestroyPipeline();
-    return false;
+void GstVideoPlayer::ApplySubtitles() {
+  guint flags = 0;
+  g_object_get(G_OBJECT(file_.playbin), "flags", &flags, NULL);
+  flags = is_subtitles_enabled_ ? (flags | kPlayFlagText)
+                                : (flags & ~kPlayFlagText);
+  g_object_set(G_OBJECT(file_.playbin), "flags", flags, NULL);
+}
+
+// Consumes the player options in the fragment of an RTSP URI, e.g.
+// rtsp://camera/stream#transport=udp-first, since the server never sees the
+// fragment anyway.
+std::string GstVideoPlayer::ExtractUriOptions(const std::string& uri) {
+  const auto fragment = uri.find('#');
+  if (!IsRtspUri(uri) || fragment == std::string::npos) {
+    return uri;
   }
 
-  // Sets internal video size and buffier.
-  GetVideoSize(width_, height_);
-  pixels_.reset(new uint32_t[width_ * height_]);
+  bool consumed = false;
+  std::string options = uri.substr(fragment + 1);
+  size_t start = 0;
+  while (start <= options.size()) {
+    auto end = options.find('&', start);
+    if (end == std::string::npos) {
+      end = options.size();
+    }
+    const auto option = options.substr(start, end - start);
+    const auto separator = option.find('=');
+    if (separator != std::string::npos &&
+        option.substr(0, separator) == "transport") {
+      if (ParseRtspTransport(option.substr(separator + 1), rtsp_transport_)) {
+        consumed = true;
+      } else {
+        std::cerr << "Unknown RTSP transport: " << option << std::endl;
+      }
+    }
+    start = end + 1;
+  }
+  return consumed ? uri.substr(0, fragment) : uri;
+}
 
-  // stream_handler_->OnNotifyInitialized();
+bool GstVideoPlayer::GetTransportStats(TransportStats& stats) {
+  std::lock_guard<std::mutex> lock(mutex_jitter_buffer_);
+  if (!jitter_buffer_) {
+    return false;
+  }
 
+  GstStructure* structure = nullptr;
+  g_object_get(G_OBJECT(jitter_buffer_), "stats", &structure, NULL);
+  if (!structure) {
+    return false;
+  }
+  guint64 value = 0;
+  if (gst_structure_get_uint64(structure, "num-pushed", &value)) {
+    stats.packets_received = value;
+  }
+  if (gst_structure_get_uint64(structure, "num-lost", &value)) {
+    stats.packets_lost = value;
+  }
+  if (gst_structure_get_uint64(structure, "num-late", &value)) {
+    stats.packets_late = value;
+  }
+  if (gst_structure_get_uint64(structure, "num-duplicates", &value)) {
+    stats.packets_duplicated = value;
+  }
+  if (gst_structure_get_uint64(structure, "avg-jitter", &value)) {
+    stats.jitter = value;
+  }
+  gst_structure_free(structure);
   return true;
 }
 
+// static
+void GstVideoPlayer::OnRtspNewManager(GstElement* source, GstElement* manager,
+                                      gpointer user_data) {
+  // rtspsrc creates a new rtpbin every time it connects.
+  g_signal_connect(manager, "new-jitterbuffer",
+                   G_CALLBACK(OnNewJitterBuffer), user_data);
+}
+
+// static
+void GstVideoPlayer::OnNewJitterBuffer(GstElement* manager,
+                                       GstElement* jitter_buffer,
+                                       guint session, guint ssrc,
+                                       gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  std::lock_guard<std::mutex> lock(self->mutex_jitter_buffer_);
+  // Only the first session, which carries the video, is reported.
+  if (session != 0) {
+    return;
+  }
+  gst_object_ref(jitter_buffer);
+  if (self->jitter_buffer_) {
+    gst_object_unref(self->jitter_buffer_);
+  }
+  self->jitter_buffer_ = jitter_buffer;
+}
+
+// static
+void GstVideoPlayer::OnWebRtcElementAdded(GstBin* bin, GstBin* sub_bin,
+                                          GstElement* element,
+                                          gpointer user_data) {
+  auto* factory = gst_element_get_factory(element);
+  if (!factory) {
+    return;
+  }
+  const auto* name = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+  if (g_strcmp0(name, "webrtcbin") == 0) {
+    g_object_set(G_OBJECT(element), "latency", kWebRtcLatencyMs, NULL);
+  } else if (g_strcmp0(name, "rtpbin") == 0) {
+    // The rtpbin of webrtcbin, which creates the jitter buffers.
+    g_object_set(G_OBJECT(element), "drop-on-latency", TRUE, NULL);
+    g_signal_connect(element, "new-jitterbuffer",
+                     G_CALLBACK(OnNewJitterBuffer), user_data);
+  }
+}
+
+GstVideoPlayer::ReconnectStats GstVideoPlayer::GetReconnectStats() {
+  std::lock_guard<std::mutex> lock(mutex_reconnect_);
+  return reconnect_stats_;
+}
+
+void GstVideoPlayer::RequestReconnect() {
+  std::lock_guard<std::mutex> lock(mutex_reconnect_);
+  reconnect_requested_ = true;
+  reconnect_cv_.notify_all();
+}
+
+void GstVideoPlayer::StopReconnectSupervisor() {
+  if (!reconnect_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_reconnect_);
+    stop_reconnect_ = true;
+  }
+  reconnect_cv_.notify_all();
+  reconnect_thread_.join();
+}
+
+void GstVideoPlayer::RunReconnectSupervisor() {
+  std::mt19937 random(std::random_device{}());
+  std::unique_lock<std::mutex> lock(mutex_reconnect_);
+  while (!stop_reconnect_) {
+    reconnect_cv_.wait_for(lock, kStallCheckInterval, [this]() {
+      return stop_reconnect_ || reconnect_requested_;
+    });
+    if (stop_reconnect_) {
+      break;
+    }
+    if (!is_playing_) {
+      reconnect_requested_ = false;
+      continue;
+    }
+    if (!reconnect_requested_) {
+      // Key frame only mode may legitimately go without frames for a
+      // whole GOP.
+      const auto last_frame_time = last_frame_time_ms_.load();
+      if (key_frame_only_ || last_frame_time == 0 ||
+          NowMs() - last_frame_time < kStallTimeoutMs) {
+        continue;
+      }
+      PLUGIN_LOG(Warning, "rtsp")
+          << "No frame from the RTSP stream for " << kStallTimeoutMs << " ms";
+    }
+
+    const auto lost_time = NowMs();
+    stream_handler()->OnNotifyBuffering(true);
+    auto backoff = kReconnectInitialBackoffMs;
+    bool resumed = false;
+    while (!stop_reconnect_ && is_playing_) {
+      reconnect_requested_ = false;
+      resumed_ = false;
+      wait_for_resume_ = true;
+      reconnect_stats_.attempts++;
+      lock.unlock();
+      RestartSource();
+      lock.lock();
+
+      const auto timeout =
+          preroll_timeout_ms_ > 0 ? preroll_timeout_ms_ : kReconnectTimeoutMs;
+      reconnect_cv_.wait_for(
+          lock, std::chrono::milliseconds(timeout), [this]() {
+            return stop_reconnect_ || !is_playing_ || resumed_ ||
+                   reconnect_requested_;
+          });
+      if (resumed_) {
+        resumed = true;
+        break;
+      }
+      wait_for_resume_ = false;
+
+      // Spreads the attempts by +-25%, so that the cameras of a wall that
+      // went down together don't all come back at once.
+      std::uniform_int_distribution<int64_t> spread(-backoff / 4, backoff / 4);
+      reconnect_cv_.wait_for(
+          lock, std::chrono::milliseconds(backoff + spread(random)),
+          [this]() { return stop_reconnect_ || !is_playing_; });
+      backoff = std::min(backoff * 2, kReconnectMaxBackoffMs);
+    }
+    wait_for_resume_ = false;
+    reconnect_requested_ = false;
+    if (resumed) {
+      reconnect_stats_.reconnects++;
+      stats_.Add(PluginStats::kReconnects);
+      reconnect_stats_.last_latency_ms = NowMs() - lost_time;
+      PLUGIN_LOG(Info, "rtsp") << "Reconnected the RTSP stream in "
+                               << reconnect_stats_.last_latency_ms << " ms";
+    }
+    if (!stop_reconnect_) {
+      stream_handler()->OnNotifyBuffering(false);
+    }
+  }
+}
+
+void GstVideoPlayer::RestartSource() {
+  if (gst_element_set_state(rtsp_.source, GST_STATE_NULL) ==
+      GST_STATE_CHANGE_FAILURE) {
+    PLUGIN_LOG(Error, "rtsp") << "Failed to stop the RTSP source";
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_decoder_);
+    if (rtsp_.depay) {
+      // Clears a pending EOS of the old session from the decoder chain.
+      auto* sink_pad = gst_element_get_static_pad(rtsp_.depay, "sink");
+      gst_pad_send_event(sink_pad, gst_event_new_flush_start());
+      gst_pad_send_event(sink_pad, gst_event_new_flush_stop(TRUE));
+      gst_object_unref(sink_pad);
+    }
+  }
+  // The decoder can't make sense of the delta frames before the first key
+  // frame of the new session.
+  wait_for_key_frame_ = true;
+  if (!gst_element_sync_state_with_parent(rtsp_.source)) {
+    PLUGIN_LOG(Error, "rtsp") << "Failed to restart the RTSP source";
+  }
+}
+
 bool GstVideoPlayer::Play() {
   if (gst_element_set_state(gst_.pipeline, GST_STATE_PLAYING) ==
       GST_STATE_CHANGE_FAILURE) {
@@ -74,8 +1479,14 @@ bool GstVideoPlayer::Play() {
     return false;
   }
 
-  stream_handler_->OnNotifyPlaying(true);
+  stream_handler()->OnNotifyPlaying(true);
+  // Gives the stream the stall timeout to deliver its first frame.
+  last_frame_time_ms_ = NowMs();
   is_playing_ = true;
+  if (traits_->is_live && !reconnect_thread_.joinable()) {
+    reconnect_thread_ =
+        std::thread(&GstVideoPlayer::RunReconnectSupervisor, this);
+  }
   return true;
 }
 
@@ -86,8 +1497,10 @@ bool GstVideoPlayer::Pause() {
     return false;
   }
 
-  stream_handler_->OnNotifyPlaying(false);
+  stream_handler()->OnNotifyPlaying(false);
   is_playing_ = false;
+  // Stops a reconnect in progress.
+  reconnect_cv_.notify_all();
   return true;
 }
 
@@ -98,89 +1511,270 @@ bool GstVideoPlayer::Stop() {
     return false;
   }
 
-  stream_handler_->OnNotifyPlaying(false);
+  stream_handler()->OnNotifyPlaying(false);
   is_playing_ = false;
+  reconnect_cv_.notify_all();
   return true;
 }
 
 bool GstVideoPlayer::SetVolume(double volume) {
-  if (is_rtsp_) {
-    if (!gst_.pipeline) {
-      return false;
-    }
-  } else {
-    if (!gst_.playbin) {
-      return false;
+  std::lock_guard<std::mutex> lock(mutex_decoder_);
+  // Also applied to the audio branch of the direct file pipeline once it is
+  // built.
+  volume_ = volume;
+  if (!file_.volume) {
+    return false;
+  }
+  g_object_set(file_.volume, "volume", volume, NULL);
+  return true;
+}
+
+void GstVideoPlayer::ApplyVolume() {
+  if (file_.volume) {
+    g_object_set(file_.volume, "volume", volume_, "mute", mute_, NULL);
+  }
+}
+
+bool GstVideoPlayer::SetTrackSelection(const TrackSelection& selection) {
+  if (!gst_.pipeline || IsCompositor()) {
+    return false;
+  }
+  if (IsRtsp() || IsWebRtc()) {
+    return !selection.audio;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_decoder_);
+  track_selection_ = selection;
+  if (file_.playbin) {
+    guint flags = 0;
+    g_object_get(G_OBJECT(file_.playbin), "flags", &flags, NULL);
+    flags = selection.audio ? (flags | kPlayFlagAudio)
+                            : (flags & ~kPlayFlagAudio);
+    // playbin reconfigures its sinks at once, and releases the audio device
+    // along with the audio sink.
+    g_object_set(G_OBJECT(file_.playbin), "flags", flags, NULL);
+    if (selection.audio && selection.audio_track >= 0) {
+      g_object_set(G_OBJECT(file_.playbin), "current-audio",
+                   selection.audio_track, NULL);
     }
+    file_.volume = selection.audio ? file_.playbin : nullptr;
+    ApplyVolume();
+    return true;
   }
 
-  volume_ = volume;
-  g_object_set(gst_.playbin, "volume", volume, NULL);
-  return true;
+  RemoveFileAudioChain();
+  if (!selection.audio) {
+    return true;
+  }
+  // Otherwise linked by OnDemuxerPadAdded() once the demuxer exposes it.
+  auto* pad = FindDemuxerAudioPad(selection.audio_track);
+  if (!pad) {
+    return true;
+  }
+  const auto linked = LinkFileAudioChain(pad);
+  gst_object_unref(pad);
+  return linked;
+}
+
+GstVideoPlayer::TrackSelection GstVideoPlayer::GetTrackSelection() {
+  std::lock_guard<std::mutex> lock(mutex_decoder_);
+  return track_selection_;
 }
 
 bool GstVideoPlayer::SetPlaybackRate(double rate) {
-  if (is_rtsp_) {
-    if (!gst_.pipeline) {
+  if (!gst_.pipeline) {
+    return false;
+  }
+
+  if (rate == 0) {
+    std::cerr << "Rate 0 is not supported, pause instead" << std::endl;
+    return false;
+  }
+
+  // An instant rate change keeps the pipeline running, but can't change the
+  // direction or the trick mode. It needs GStreamer 1.18 or later, and falls
+  // back to a flushing seek from the current position.
+  const auto flags = RateSeekFlags(rate);
+  const double current_rate = playback_rate_;
+  const auto is_instant =
+      !is_segment_looping_ && !is_scrubbing_ &&
+      (rate > 0) == (current_rate > 0) &&
+      flags == RateSeekFlags(current_rate) &&
+      gst_element_seek(
+          gst_.pipeline, rate, GST_FORMAT_TIME,
+          (GstSeekFlags)(GST_SEEK_FLAG_INSTANT_RATE_CHANGE | flags),
+          GST_SEEK_TYPE_NONE, 0, GST_SEEK_TYPE_NONE, 0);
+  if (!is_instant) {
+    auto position = GetCurrentPosition();
+    if (position < 0) {
       return false;
     }
-  } else {
-    if (!gst_.playbin) {
+    if (!SeekWithRate(
+            rate,
+            (GstSeekFlags)(GST_SEEK_FLAG_FLUSH | SegmentSeekFlags() | flags),
+            position * GST_MSECOND)) {
+      std::cerr << "Failed to set playback rate to " << rate
+                << " (gst_element_seek failed)" << std::endl;
       return false;
     }
   }
-  
 
-  if (rate <= 0) {
-    std::cerr << "Rate " << rate << " is not supported" << std::endl;
+  playback_rate_ = rate;
+  {
+    std::lock_guard<std::mutex> lock(mutex_decoder_);
+    mute_ = (rate < 0.5 || rate > 2);
+    ApplyVolume();
+  }
+
+  return true;
+}
+
+bool GstVideoPlayer::SeekWithRate(double rate, GstSeekFlags flags,
+                                  GstClockTime position) {
+  // Backwards, the segment ends at the position and playback starts there.
+  if (rate < 0) {
+    return gst_element_seek(gst_.pipeline, rate, GST_FORMAT_TIME, flags,
+                            GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_SET,
+                            position);
+  }
+  return gst_element_seek(gst_.pipeline, rate, GST_FORMAT_TIME, flags,
+                          GST_SEEK_TYPE_SET, position, GST_SEEK_TYPE_SET,
+                          GST_CLOCK_TIME_NONE);
+}
+
+// static
+GstSeekFlags GstVideoPlayer::RateSeekFlags(double rate) {
+  if (std::abs(rate) < kKeyUnitTrickModeRate) {
+    return GST_SEEK_FLAG_NONE;
+  }
+  return (GstSeekFlags)(GST_SEEK_FLAG_TRICKMODE |
+                        GST_SEEK_FLAG_TRICKMODE_KEY_UNITS |
+                        GST_SEEK_FLAG_TRICKMODE_NO_AUDIO);
+}
+
+void GstVideoPlayer::SetAutoRepeat(bool auto_repeat) {
+  auto_repeat_ = auto_repeat;
+  // Before Init(), the loop is started once the pipeline is prerolled.
+  // Leaving segment mode would cost a flushing seek, so it stays on and
+  // SEGMENT_DONE is reported as the completion instead.
+  if (auto_repeat && is_prerolled_ && gst_.pipeline) {
+    StartSegmentLoop();
+  }
+}
+
+bool GstVideoPlayer::StartSegmentLoop() {
+  if (!traits_->supports_segment_loop || is_segment_looping_) {
     return false;
   }
 
-  auto position = GetCurrentPosition();
-  if (position < 0) {
+  // One flushing seek enters segment mode at the current position. From then
+  // on, every loop is a non-flushing seek issued on SEGMENT_DONE.
+  gint64 position = 0;
+  gst_element_query_position(gst_.pipeline, GST_FORMAT_TIME, &position);
+  if (!SeekWithRate(playback_rate_,
+                    (GstSeekFlags)(GST_SEEK_FLAG_FLUSH |
+                                   GST_SEEK_FLAG_ACCURATE |
+                                   GST_SEEK_FLAG_SEGMENT |
+                                   RateSeekFlags(playback_rate_)),
+                    position)) {
+    std::cerr << "Failed to start a segment loop, looping on EOS instead"
+              << std::endl;
     return false;
   }
+  is_segment_looping_ = true;
+  return true;
+}
+
+GstSeekFlags GstVideoPlayer::SegmentSeekFlags() const {
+  return is_segment_looping_ ? GST_SEEK_FLAG_SEGMENT : GST_SEEK_FLAG_NONE;
+}
+
+bool GstVideoPlayer::SetSeek(int64_t position, SeekMode mode) {
+  GstClockTime target = position * GST_MSECOND;
+  GstClockTime keyframe;
+  auto flags = (GstSeekFlags)(GST_SEEK_FLAG_FLUSH | SegmentSeekFlags() |
+                              RateSeekFlags(playback_rate_));
+  if (is_scrubbing_) {
+    scrub_position_ = position;
+    flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_TRICKMODE |
+                           GST_SEEK_FLAG_TRICKMODE_KEY_UNITS |
+                           GST_SEEK_FLAG_TRICKMODE_NO_AUDIO);
+    if (keyframe_index_.FindNearest(target, keyframe)) {
+      target = keyframe;
+    } else {
+      flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_KEY_UNIT |
+                             GST_SEEK_FLAG_SNAP_NEAREST);
+    }
+  } else {
+    switch (mode) {
+      case SeekMode::kKeyUnit:
+        flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_KEY_UNIT);
+        break;
+      case SeekMode::kAccurate:
+        flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_ACCURATE);
+        break;
+      case SeekMode::kSnapBefore:
+      case SeekMode::kSnapAfter: {
+        const auto found =
+            mode == SeekMode::kSnapBefore
+                ? keyframe_index_.FindBefore(target, keyframe)
+                : keyframe_index_.FindAfter(target, keyframe);
+        // Landing exactly on a key frame, an accurate seek decodes nothing
+        // it doesn't show.
+        if (found) {
+          target = keyframe;
+          flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_ACCURATE);
+        } else {
+          flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_KEY_UNIT |
+                                 (mode == SeekMode::kSnapBefore
+                                      ? GST_SEEK_FLAG_SNAP_BEFORE
+                                      : GST_SEEK_FLAG_SNAP_AFTER));
+        }
+        break;
+      }
+    }
+  }
 
-  if (!gst_element_seek(gst_.pipeline, rate, GST_FORMAT_TIME,
-                        GST_SEEK_FLAG_FLUSH, GST_SEEK_TYPE_SET,
-                        position * GST_MSECOND, GST_SEEK_TYPE_SET,
-                        GST_CLOCK_TIME_NONE)) {
-    std::cerr << "Failed to set playback rate to " << rate
-              << " (gst_element_seek failed)" << std::endl;
+  // A paused pipeline prerolls on the new position by itself, and
+  // OnNewPreroll() shows the frame.
+  if (!SeekWithRate(playback_rate_, flags, target)) {
+    std::cerr << "Failed to seek " << target << std::endl;
     return false;
   }
+  return true;
+}
 
-  playback_rate_ = rate;
-  mute_ = (rate < 0.5 || rate > 2);
-  
-  if (is_rtsp_) {
-    g_object_set(gst_.pipeline, "mute", mute_, NULL);
+// static
+bool GstVideoPlayer::ParseSeekMode(const std::string& name, SeekMode& mode) {
+  if (name == "key-unit") {
+    mode = SeekMode::kKeyUnit;
+  } else if (name == "accurate") {
+    mode = SeekMode::kAccurate;
+  } else if (name == "snap-before") {
+    mode = SeekMode::kSnapBefore;
+  } else if (name == "snap-after") {
+    mode = SeekMode::kSnapAfter;
   } else {
-    g_object_set(gst_.playbin, "mute", mute_, NULL);
+    return false;
   }
-  
   return true;
 }
 
-bool GstVideoPlayer::SetSeek(int64_t position) {
-  auto nanosecond = position * 1000 * 1000;
-  if (!gst_element_seek(
-          gst_.pipeline, playback_rate_, GST_FORMAT_TIME,
-          (GstSeekFlags)(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT),
-          GST_SEEK_TYPE_SET, nanosecond, GST_SEEK_TYPE_SET,
-          GST_CLOCK_TIME_NONE)) {
-    std::cerr << "Failed to seek " << nanosecond << std::endl;
+bool GstVideoPlayer::SetScrubbing(bool scrubbing) {
+  if (traits_->is_live || !gst_.pipeline) {
     return false;
   }
-  
-  if (!is_playing_)
-  {
-    gst_element_set_state(gst_.pipeline, GST_STATE_PLAYING);
-    gst_element_get_state(gst_.pipeline, nullptr, nullptr, 500 * GST_MSECOND);
-    gst_element_set_state(gst_.pipeline, GST_STATE_PAUSED);
-    gst_element_get_state(gst_.pipeline, nullptr, nullptr, 500 * GST_MSECOND);
+  if (is_scrubbing_.exchange(scrubbing) == scrubbing) {
+    return true;
   }
-  return true;
+  if (scrubbing) {
+    const auto position = GetCurrentPosition();
+    scrub_position_ = position < 0 ? 0 : position;
+    return true;
+  }
+  // Drops the trick mode flags, which stick to the segment until the next
+  // flushing seek.
+  return SetSeek(scrub_position_, SeekMode::kAccurate);
 }
 
 int64_t GstVideoPlayer::GetDuration() {
@@ -203,87 +1797,397 @@ int64_t GstVideoPlayer::GetCurrentPosition() {
     return -1;
   }
 
-  // TODO: We need to handle this code in the proper plase.
-  // The VideoPlayer plugin doesn't have a main loop, so EOS message
-  // received from GStreamer cannot be processed directly in a callback
-  // function. This is because the event channel message of playback complettion
-  // needs to be thrown in the main thread.
-  {
-    std::unique_lock<std::mutex> lock(mutex_event_completed_);
-    if (is_completed_) {
-      is_completed_ = false;
-      lock.unlock();
+  return position / GST_MSECOND;
+}
+
+#ifdef USE_EGL_IMAGE_DMABUF
+struct GstVideoPlayer::EGLImageReleaseQueue {
+  ~EGLImageReleaseQueue() { Release(); }
+
+  void Push(GstEGLImage* image, GstGLContext* context) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.emplace_back(image, context);
+  }
+
+  void Release() {
+    std::vector<std::pair<GstEGLImage*, GstGLContext*>> released;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      released.swap(entries);
+    }
+    for (auto& entry : released) {
+      gst_egl_image_unref(entry.first);
+      gst_object_unref(entry.second);
+    }
+  }
+
+  std::mutex mutex;
+  std::vector<std::pair<GstEGLImage*, GstGLContext*>> entries;
+};
+
+struct GstVideoPlayer::CachedEGLImage {
+  GstEGLImage* image;
+  // Referenced, so that another context can't get the same address.
+  GstGLContext* context;
+  GstVideoInfo info;
+  std::shared_ptr<EGLImageReleaseQueue> release_queue;
+};
+
+// static
+void GstVideoPlayer::OnEGLImageMemoryFreed(gpointer data) {
+  auto* cached = static_cast<CachedEGLImage*>(data);
+  cached->release_queue->Push(cached->image, cached->context);
+  delete cached;
+}
+
+void* GstVideoPlayer::GetEGLImage(void* egl_display, void* egl_context) {
+  TRACE_SCOPE(trace_track_, "GetEGLImage");
+  OnTextureFetched();
+  stream_handler()->OnNotifyFrameRendered();
+  PresentScheduledFrame();
+  const bool is_new_frame = frames_.HasNewFrame();
+  const auto& frame = frames_.Acquire();
+  if (!frame.buffer) {
+    return nullptr;
+  }
+  if (is_new_frame) {
+    RecordTextureLatency(frame.timestamps);
+    stats_.Add(PluginStats::kFramesRendered);
+  }
+
+#ifdef USE_YUV_SHADER
+  GstVideoInfo info;
+  if (!gst_video_info_from_caps(&info, frame.caps)) {
+    std::cerr << "Failed to get a gst_video_info" << std::endl;
+    return nullptr;
+  }
+  if (!yuv_renderer_) {
+    yuv_renderer_ = std::make_unique<YuvTextureRenderer>();
+  }
+  return yuv_renderer_->Render(frame.buffer, info, egl_display, egl_context);
+#else
+  GstMemory* memory = gst_buffer_peek_memory(frame.buffer, 0);
+  if (!gst_is_dmabuf_memory(memory)) {
+    if (!warned_non_dmabuf_) {
+      std::cerr << "The decoded frames are not in DMABUF memory. Use a "
+                   "converter that can export DMABUF."
+                << std::endl;
+      warned_non_dmabuf_ = true;
+    }
+    return nullptr;
+  }
+  if (!EnsureGLContext(egl_display, egl_context)) {
+    return nullptr;
+  }
+  if (!egl_image_release_queue_) {
+    egl_image_release_queue_ = std::make_shared<EGLImageReleaseQueue>();
+  }
+  egl_image_release_queue_->Release();
+
+  if (!egl_image_caps_ || !gst_caps_is_equal(egl_image_caps_, frame.caps)) {
+    if (!gst_video_info_from_caps(&gst_video_info_, frame.caps)) {
+      std::cerr << "Failed to get a gst_video_info" << std::endl;
+      return nullptr;
+    }
+    gst_caps_replace(&egl_image_caps_, frame.caps);
+  }
+
+  auto* cached = static_cast<CachedEGLImage*>(gst_mini_object_get_qdata(
+      GST_MINI_OBJECT_CAST(memory), GetEGLImageQuark()));
+  if (!cached || cached->context != gst_gl_ctx_ ||
+      !gst_video_info_is_equal(&cached->info, &gst_video_info_)) {
+    auto* image = gst_egl_image_from_dmabuf(
+        gst_gl_ctx_, gst_dmabuf_memory_get_fd(memory), &gst_video_info_, 0,
+        memory->offset);
+    if (!image) {
+      std::cerr << "Failed to create an EGLImage from dmabuf" << std::endl;
+      return nullptr;
+    }
+    cached = new CachedEGLImage{
+        image, static_cast<GstGLContext*>(gst_object_ref(gst_gl_ctx_)),
+        gst_video_info_, egl_image_release_queue_};
+    // Releases the image made for the previous caps or context, if any.
+    gst_mini_object_set_qdata(GST_MINI_OBJECT_CAST(memory),
+                              GetEGLImageQuark(), cached,
+                              &GstVideoPlayer::OnEGLImageMemoryFreed);
+  }
+  return reinterpret_cast<void*>(gst_egl_image_get_image(cached->image));
+#endif  // USE_YUV_SHADER
+}
+
+bool GstVideoPlayer::EnsureGLContext(void* egl_display, void* egl_context) {
+  if (gst_gl_ctx_ && egl_display == egl_display_ &&
+      egl_context == egl_context_) {
+    gst_gl_context_activate(gst_gl_ctx_, TRUE);
+    return true;
+  }
+  UnrefEGLImage();
+
+  gst_gl_display_egl_ = gst_gl_display_egl_new_with_egl_display(
+      reinterpret_cast<gpointer>(egl_display));
+  if (!gst_gl_display_egl_) {
+    std::cerr << "Failed to wrap the EGL display" << std::endl;
+    return false;
+  }
+  gst_gl_ctx_ = gst_gl_context_new_wrapped(
+      GST_GL_DISPLAY_CAST(gst_gl_display_egl_),
+      reinterpret_cast<guintptr>(egl_context), GST_GL_PLATFORM_EGL,
+      GST_GL_API_GLES2);
+  if (!gst_gl_ctx_) {
+    std::cerr << "Failed to wrap the EGL context" << std::endl;
+    gst_object_unref(gst_gl_display_egl_);
+    gst_gl_display_egl_ = NULL;
+    return false;
+  }
+  egl_display_ = egl_display;
+  egl_context_ = egl_context;
+
+  gst_gl_context_activate(gst_gl_ctx_, TRUE);
+  return true;
+}
+
+void GstVideoPlayer::UnrefEGLImage() {
+  if (egl_image_release_queue_) {
+    egl_image_release_queue_->Release();
+  }
+  if (egl_image_caps_) {
+    gst_caps_unref(egl_image_caps_);
+    egl_image_caps_ = NULL;
+  }
+  if (gst_gl_ctx_) {
+    gst_object_unref(gst_gl_ctx_);
+    gst_gl_ctx_ = NULL;
+  }
+  if (gst_gl_display_egl_) {
+    gst_object_unref(gst_gl_display_egl_);
+    gst_gl_display_egl_ = NULL;
+  }
+  egl_display_ = nullptr;
+  egl_context_ = nullptr;
+}
+#endif  // USE_EGL_IMAGE_DMABUF
+
+void GstVideoPlayer::RequestOutputSize(int32_t width, int32_t height) {
+  UpdateAbrTextureSize(width, height);
+  // Without a converter, the frames are imported as decoded.
+  if (!gst_.output_filter || !gst_.video_convert || width <= 0 ||
+      height <= 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_output_size_);
+  const auto now = NowMs();
+  if (width != requested_width_ || height != requested_height_) {
+    requested_width_ = width;
+    requested_height_ = height;
+    request_time_ms_ = now;
+    return;
+  }
+  if (now - request_time_ms_ < kOutputSizeSettleMs ||
+      now - last_output_check_ms_ < kOutputSizeSettleMs) {
+    return;
+  }
+  last_output_check_ms_ = now;
+  if (is_output_size_kept_) {
+    if (width == kept_request_width_ && height == kept_request_height_) {
+      return;
+    }
+    // Shown at another size, so the output follows the decoded size again.
+    is_output_size_kept_ = false;
+    output_source_width_ = 0;
+    output_source_height_ = 0;
+  }
+
+  // The decoded size, which may change in the middle of the stream.
+  auto* pad = gst_element_get_static_pad(gst_.video_convert, "sink");
+  if (!pad) {
+    return;
+  }
+  auto* caps = gst_pad_get_current_caps(pad);
+  gst_object_unref(pad);
+  if (!caps) {
+    return;
+  }
+  GstVideoInfo info;
+  const auto has_info = gst_video_info_from_caps(&info, caps);
+  gst_caps_unref(caps);
+  if (!has_info) {
+    return;
+  }
+  const int32_t source_width = GST_VIDEO_INFO_WIDTH(&info);
+  const int32_t source_height = GST_VIDEO_INFO_HEIGHT(&info);
+
+  // Halving is cheap for the hardware scalers. A smaller output than the
+  // current one needs a margin, so that a texture close to a threshold
+  // doesn't flip the output between two sizes.
+  int shift = 0;
+  while (shift < kMaxOutputShift) {
+    const auto margin = shift + 1 > output_shift_ ? kOutputSizeMargin : 1.0;
+    if ((source_width >> (shift + 1)) < width * margin ||
+        (source_height >> (shift + 1)) < height * margin) {
+      break;
+    }
+    shift++;
+  }
+  if (shift == output_shift_ && source_width == output_source_width_ &&
+      source_height == output_source_height_) {
+    return;
+  }
 
-      if (auto_repeat_) {
-        SetSeek(0);
-      } else {
-        stream_handler_->OnNotifyCompleted();
-      }
+  // The caps filter renegotiates the converter on its own.
+  auto* output_caps = gst_caps_copy(output_caps_);
+  if (shift > 0) {
+    gst_caps_set_simple(output_caps, "width", G_TYPE_INT,
+                        (source_width >> shift) & ~1, "height", G_TYPE_INT,
+                        (source_height >> shift) & ~1, NULL);
+  }
+  g_object_set(G_OBJECT(gst_.output_filter), "caps", output_caps, NULL);
+  gst_caps_unref(output_caps);
+  output_shift_ = shift;
+  output_source_width_ = source_width;
+  output_source_height_ = source_height;
+}
+
+void GstVideoPlayer::KeepOutputSize(int32_t source_width,
+                                    int32_t source_height) {
+  // Without a converter, the frames are imported as decoded.
+  if (!gst_.output_filter || !gst_.video_convert) {
+    return;
+  }
+  const int32_t width = width_;
+  const int32_t height = height_;
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+  // Another picture, e.g. a letterboxed ad, gets a size of its own.
+  const auto source_area = static_cast<int64_t>(source_width) * height;
+  const auto difference =
+      std::abs(source_area - static_cast<int64_t>(source_height) * width);
+  std::lock_guard<std::mutex> lock(mutex_output_size_);
+  if (difference * 100 > source_area * kAspectRatioTolerance) {
+    if (is_output_size_kept_) {
+      is_output_size_kept_ = false;
+      output_shift_ = 0;
+      output_source_width_ = 0;
+      output_source_height_ = 0;
+      g_object_set(G_OBJECT(gst_.output_filter), "caps", output_caps_, NULL);
     }
+    return;
   }
 
-  return position / GST_MSECOND;
+  auto* output_caps = gst_caps_copy(output_caps_);
+  gst_caps_set_simple(output_caps, "width", G_TYPE_INT, width, "height",
+                      G_TYPE_INT, height, NULL);
+  g_object_set(G_OBJECT(gst_.output_filter), "caps", output_caps, NULL);
+  gst_caps_unref(output_caps);
+  is_output_size_kept_ = true;
+  kept_request_width_ = requested_width_;
+  kept_request_height_ = requested_height_;
+  output_source_width_ = source_width;
+  output_source_height_ = source_height;
+  PLUGIN_LOG(Debug, "caps") << "Keeping the output at " << width << "x"
+                            << height << " for " << source_width << "x"
+                            << source_height;
 }
 
-#ifdef USE_EGL_IMAGE_DMABUF
-void* GstVideoPlayer::GetEGLImage(void* egl_display, void* egl_context) {
-  std::shared_lock<std::shared_mutex> lock(mutex_buffer_);
-  if (!gst_.buffer) {
+const uint8_t* GstVideoPlayer::GetFrameBuffer(size_t& width, size_t& height,
+                                              void** release_context) {
+  TRACE_SCOPE(trace_track_, "GetFrameBuffer");
+  if (release_context) {
+    *release_context = nullptr;
+  }
+
+  OnTextureFetched();
+  // Acknowledged before acquiring, so that a frame published in between is
+  // notified again instead of being skipped.
+  stream_handler()->OnNotifyFrameRendered();
+  PresentScheduledFrame();
+  const bool is_new_frame = frames_.HasNewFrame();
+  const auto& frame = frames_.Acquire();
+  if (!frame.buffer) {
     return nullptr;
   }
+  if (is_new_frame) {
+    RecordTextureLatency(frame.timestamps);
+    stats_.Add(PluginStats::kFramesRendered);
+  }
+  width = frame.width;
+  height = frame.height;
 
-  GstMemory* memory = gst_buffer_peek_memory(gst_.buffer, 0);
-  if (gst_is_dmabuf_memory(memory)) {
-    UnrefEGLImage();
-
-    gint fd = gst_dmabuf_memory_get_fd(memory);
-    gst_gl_display_egl_ =
-        gst_gl_display_egl_new_with_egl_display(reinterpret_cast<gpointer>(egl_display));
-    gst_gl_ctx_ = gst_gl_context_new_wrapped(
-        GST_GL_DISPLAY_CAST(gst_gl_display_egl_), reinterpret_cast<guintptr>(egl_context),
-        GST_GL_PLATFORM_EGL, GST_GL_API_GLES2);
+  if (release_context &&
+      IsPackedFrame(frame.buffer, frame.width, frame.height)) {
+    auto* mapped = new MappedFrame();
+    mapped->buffer = gst_buffer_ref(frame.buffer);
+    if (gst_buffer_map(mapped->buffer, &mapped->map, GST_MAP_READ)) {
+      *release_context = mapped;
+      return mapped->map.data;
+    }
+    gst_buffer_unref(mapped->buffer);
+    delete mapped;
+  }
 
-    gst_gl_context_activate(gst_gl_ctx_, TRUE);
+  return CopyFrameBuffer(frame.buffer, frame.width, frame.height);
+}
 
-    gst_egl_image_ =
-        gst_egl_image_from_dmabuf(gst_gl_ctx_, fd, &gst_video_info_, 0, 0);
-    return reinterpret_cast<void*>(gst_egl_image_get_image(gst_egl_image_));
+// static
+void GstVideoPlayer::ReleaseFrameBuffer(void* release_context) {
+  auto* frame = reinterpret_cast<MappedFrame*>(release_context);
+  if (!frame) {
+    return;
   }
-  return nullptr;
+  gst_buffer_unmap(frame->buffer, &frame->map);
+  gst_buffer_unref(frame->buffer);
+  delete frame;
 }
 
-void GstVideoPlayer::UnrefEGLImage() {
-  if (gst_egl_image_) {
-    gst_egl_image_unref(gst_egl_image_);
-    gst_object_unref(gst_gl_ctx_);
-    gst_object_unref(gst_gl_display_egl_);
-    gst_egl_image_ = NULL;
-    gst_gl_ctx_ = NULL;
-    gst_gl_display_egl_ = NULL;
+const uint8_t* GstVideoPlayer::CopyFrameBuffer(GstBuffer* buffer,
+                                               int32_t width,
+                                               int32_t height) {
+  const size_t pixel_bytes =
+      static_cast<size_t>(width) * height * kBytesPerPixel;
+  // Also gives a much larger buffer back, e.g. once the output has been
+  // scaled down, for another player to use.
+  if (pixel_bytes > pixels_.capacity() ||
+      pixel_bytes <= pixels_.capacity() / 4) {
+    pixels_ = FrameBufferPool::GetInstance().Acquire(pixel_bytes);
+    if (!pixels_.data()) {
+      return nullptr;
+    }
   }
-}
-#endif  // USE_EGL_IMAGE_DMABUF
 
-const uint8_t* GstVideoPlayer::GetFrameBuffer() {
-  std::shared_lock<std::shared_mutex> lock(mutex_buffer_);
-  if (!gst_.buffer) {
-    return nullptr;
+  const int32_t row_bytes = width * kBytesPerPixel;
+  gsize offset;
+  int32_t stride;
+  GetPlaneLayout(buffer, width, offset, stride);
+
+  auto* pixels = pixels_.data();
+  stats_.Add(PluginStats::kBytesCopied, pixel_bytes);
+  if (stride == row_bytes) {
+    gst_buffer_extract(buffer, offset, pixels, row_bytes * height);
+    return pixels;
   }
 
-  const uint32_t pixel_bytes = width_ * height_ * 4;
-  gst_buffer_extract(gst_.buffer, 0, pixels_.get(), pixel_bytes);
-  return reinterpret_cast<const uint8_t*>(pixels_.get());
+  // Strips the row padding while copying.
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    PLUGIN_LOG(Error, "frame") << "Failed to map a video frame";
+    return nullptr;
+  }
+  for (int32_t y = 0; y < height; y++) {
+    const gsize src_offset = offset + static_cast<gsize>(y) * stride;
+    if (src_offset + row_bytes > map.size) {
+      break;
+    }
+    std::memcpy(pixels + y * row_bytes, map.data + src_offset, row_bytes);
+  }
+  gst_buffer_unmap(buffer, &map);
+  return pixels;
 }
 
 bool GstVideoPlayer::CreatePipeline() {
-  std::cerr << "[DEBUG] uri_ = " << uri_ << std::endl;
-  if (is_rtsp_) {
-    std::cerr << "[DEBUG] Creating low-latency RTSP pipeline..." << std::endl;
-    return CreateLowLatencyRTSPPipeline();
-  } else {
-    std::cerr << "[DEBUG] Creating auto-decode file pipeline..." << std::endl;
-    return CreateAutoDecodeFilePipeline();
-  }
+  TRACE_SCOPE(trace_track_, "CreatePipeline");
+  TRACE_INSTANT(trace_track_, "uri " + uri_);
+  return (this->*traits_->create)();
 }
 
 bool GstVideoPlayer::CreateLowLatencyRTSPPipeline() {
@@ -293,35 +2197,101 @@ bool GstVideoPlayer::CreateLowLatencyRTSPPipeline() {
 	  return false;
   }
 
-  // [2/10] Create GStreamer elements
-  gst_.source = gst_element_factory_make("rtspsrc", "source");
-  gst_.depay = gst_element_factory_make("rtph264depay", "depay");
-  gst_.parse = gst_element_factory_make("h264parse", "parse");
-  // 嘗試建立 qtivdec
-  // 自動根據環境選擇可用的解碼器，不會因為某台電腦沒有 qtivdec 就失敗
-  gst_.decoder = gst_element_factory_make("qtivdec", "decoder");
-  if (!gst_.decoder) {
-    std::cerr << "qtivdec not found, fallback to avdec_h264" << std::endl;
-    gst_.decoder = gst_element_factory_make("avdec_h264", "decoder");
-    if (!gst_.decoder) {
-      std::cerr << "avdec_h264 not found, fallback to openh264dec" << std::endl;
-      gst_.decoder = gst_element_factory_make("openh264dec", "decoder");
-      if (!gst_.decoder) {
-        std::cerr << "No suitable decoder found!" << std::endl;
-        return false;
-      }
-    }
+  // [2/10] Create the RTSP source. The depayloader, parser and decoder are
+  // chosen from the caps of the RTP stream in onPadAdded().
+  rtsp_.source = gst_element_factory_make("rtspsrc", "source");
+  if (!rtsp_.source) {
+	  return false;
+  }
+
+  // [3/10] Set properties for RTSP source
+  g_object_set(G_OBJECT(rtsp_.source),
+		 "location", uri_.c_str(),   // RTSP stream URI
+		 "latency", 0,               // Buffer latency in ms
+		 "buffer-mode", 0,           // Enable low latency mode
+		 "do-retransmission", FALSE, // Disable packet retransmission
+		 "drop-on-latency", TRUE,    // Drop frames if latency exceeds threshold
+		 NULL);
+  ApplyRtspTransport();
+  g_signal_connect(rtsp_.source, "new-manager", G_CALLBACK(OnRtspNewManager),
+                   this);
+  // Tags the buffers with their capture time for the latency statistics.
+  // Available since GStreamer 1.22.
+  if (g_object_class_find_property(G_OBJECT_GET_CLASS(rtsp_.source),
+                                   "add-reference-timestamp-meta")) {
+    g_object_set(G_OBJECT(rtsp_.source), "add-reference-timestamp-meta", TRUE,
+                 NULL);
+  }
+  g_signal_connect(rtsp_.source, "select-stream",
+                   G_CALLBACK(OnRtspSelectStream), this);
+
+  return CreateLiveRtpOutput();
+}
+
+// $ whepsrc whep-endpoint=<endpoint> ! <depay> ! <parse> ! <decoder> !
+// <converter> ! queue ! capsfilter ! appsink
+bool GstVideoPlayer::CreateWebRtcPipeline() {
+  // [1/10] Create the pipeline
+  gst_.pipeline = gst_pipeline_new("pipeline");
+  if (!gst_.pipeline) {
+    return false;
+  }
+
+  // [2/10] Create the WHEP source of gst-plugins-rs, which negotiates a
+  // receive-only session over HTTP and exposes the RTP streams of its
+  // webrtcbin, so that the RTSP decoder chain decodes them.
+  rtsp_.source = gst_element_factory_make("whepsrc", "source");
+  if (!rtsp_.source) {
+    std::cerr << "Failed to create whepsrc, which is in the webrtchttp "
+                 "plugin of gst-plugins-rs"
+              << std::endl;
+    return false;
   }
-  gst_.video_convert = gst_element_factory_make("videoconvert", "videoconvert");
-  gst_.video_sink = gst_element_factory_make("fakesink", "videosink"); // Fake sink to handle video frames
-  gst_.queue = gst_element_factory_make("queue", "queue");
 
-  // [3/10] Check if elements are created successfully
-  if (!gst_.source || !gst_.depay || !gst_.parse || !gst_.decoder || !gst_.video_convert || !gst_.video_sink) {
+  // [3/10] Offer the decodable video codecs only, and no audio
+  ApplyWebRtcUri();
+  auto* video_caps = gst_caps_from_string(kWebRtcVideoCaps);
+  auto* audio_caps = gst_caps_new_empty();
+  g_object_set(G_OBJECT(rtsp_.source), "video-caps", video_caps, "audio-caps",
+               audio_caps, NULL);
+  gst_caps_unref(video_caps);
+  gst_caps_unref(audio_caps);
+  // Sets the latency of webrtcbin, and collects the jitter buffer stats.
+  g_signal_connect(rtsp_.source, "deep-element-added",
+                   G_CALLBACK(OnWebRtcElementAdded), this);
+
+  return CreateLiveRtpOutput();
+}
+
+// The part of the live pipelines after the RTP source.
+bool GstVideoPlayer::CreateLiveRtpOutput() {
+  // [4/10] Create GStreamer elements
+#if defined(USE_EGL_IMAGE_DMABUF) && defined(USE_YUV_SHADER)
+  // The decoder output is imported as is, so no converter is needed.
+  gst_.video_convert = nullptr;
+#else
+  gst_.video_convert = CreateColorConverter();
+#endif
+  gst_.video_sink = gst_element_factory_make("appsink", "videosink");
+  rtsp_.queue = gst_element_factory_make("queue", "queue");
+  gst_.output_filter = gst_element_factory_make("capsfilter", "outputfilter");
+
+  // [5/10] Check if elements are created successfully
+  if (!rtsp_.queue || !gst_.output_filter || !gst_.video_sink) {
 	  return false;
   }
+#if !defined(USE_EGL_IMAGE_DMABUF) || !defined(USE_YUV_SHADER)
+  if (!gst_.video_convert) {
+	  return false;
+  }
+#endif
+
+#ifdef USE_EGL_IMAGE_DMABUF
+  // Keeps the decoded frames in DMABUF memory all the way to GetEGLImage().
+  RequestDmabufOutput(gst_.video_convert);
+#endif  // USE_EGL_IMAGE_DMABUF
 
-  g_object_set(G_OBJECT(gst_.queue),
+  g_object_set(G_OBJECT(rtsp_.queue),
 		 "max-size-buffers", 1, // Limit to 1 buffers to keep latency low
 		 "max-size-bytes", 0,   // No byte limit
 		 //"max-size-time", 0,    // No time limit
@@ -337,48 +2307,54 @@ bool GstVideoPlayer::CreateLowLatencyRTSPPipeline() {
    *  2 (Downstream Leak) Drops old buffers in the queue
    */
 
-  // [4/10] Set properties for RTSP source
-  g_object_set(G_OBJECT(gst_.source),
-		 "location", uri_.c_str(),   // RTSP stream URI
-		 "latency", 0,               // Buffer latency in ms
-		 "buffer-mode", 0,           // Enable low latency mode
-		 "do-retransmission", FALSE, // Disable packet retransmission
-		 "protocols", 0x00000004,    // Use TCP for transport
-		 "drop-on-latency", TRUE,    // Drop frames if latency exceeds threshold
-		 NULL);
-
-  // [5/10] Set properties for fakesink
+  // [6/10] Set properties for appsink
   g_object_set(G_OBJECT(gst_.video_sink),
 		 "sync", FALSE,           // Disable sync to reduce latency
 		 "async", FALSE,          // Disable async mode for immediate processing
-		 "signal-handoffs", TRUE, // Enable handoff signal to get frames
+		 "max-buffers", 1,        // Keep only the newest frame
+		 "drop", TRUE,            // Drop old frames instead of blocking
 		 NULL);
+  is_sink_synced_ = false;
 
-  // [6/10] Add all elements to the pipeline
+  // [7/10] Add all elements to the pipeline
   gst_bin_add_many(GST_BIN(gst_.pipeline),
-		     gst_.source, gst_.depay, gst_.parse, gst_.decoder,
-		     gst_.video_convert, gst_.queue, gst_.video_sink, NULL);
+		     rtsp_.source, rtsp_.queue, gst_.output_filter, gst_.video_sink,
+		     NULL);
+  if (gst_.video_convert) {
+    gst_bin_add(GST_BIN(gst_.pipeline), gst_.video_convert);
+  }
 
-  // [7/10] Link static elements
-  if (!gst_element_link_many(gst_.depay, gst_.parse, gst_.decoder, gst_.video_convert, gst_.queue, NULL)) {
+  // [8/10] Link static elements
+  if (gst_.video_convert &&
+      !gst_element_link(gst_.video_convert, rtsp_.queue)) {
 	  return false;
   }
 
-  // Link `videoconvert` to `fakesink` with a caps filter for RGBA format
-  auto *caps = gst_caps_from_string("video/x-raw,format=RGBA");
-  // auto *caps = gst_caps_from_string("video/x-raw,format=NV12"); -> X
-  // auto *caps = gst_caps_from_string("video/x-raw,format=I412"); -> Failed to link
-  if (!gst_element_link_filtered(gst_.queue, gst_.video_sink, caps)) {
-    gst_caps_unref(caps);
+  // Link the queue to `appsink` with a caps filter for the output format
+#ifdef USE_EGL_IMAGE_DMABUF
+  output_caps_ = gst_caps_from_string(kDmabufOutputCaps);
+  auto *sink_pad = gst_element_get_static_pad(gst_.video_sink, "sink");
+  gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM,
+                    OnVideoSinkQuery, nullptr, nullptr);
+  gst_object_unref(sink_pad);
+#else
+  output_caps_ = gst_caps_from_string(kOutputCaps);
+#endif  // USE_EGL_IMAGE_DMABUF
+  g_object_set(G_OBJECT(gst_.output_filter), "caps", output_caps_, NULL);
+  if (!gst_element_link_many(rtsp_.queue, gst_.output_filter, gst_.video_sink,
+                             NULL)) {
     return false;
   }
-  gst_caps_unref(caps);
 
-  // [8/10] Connect dynamic pad-added signal for RTSP source
-  g_signal_connect(gst_.source, "pad-added", G_CALLBACK(onPadAdded), gst_.depay);
+  // Connect dynamic pad-added signal for the source
+  g_signal_connect(rtsp_.source, "pad-added", G_CALLBACK(onPadAdded), this);
 
-  // [9/10] Connect handoff signal for fakesink to process frames
-  g_signal_connect(gst_.video_sink, "handoff", G_CALLBACK(HandoffHandler), this);
+  // [9/10] Set appsink callbacks to process frames
+  GstAppSinkCallbacks callbacks = {};
+  callbacks.new_sample = OnNewSample;
+  callbacks.new_preroll = OnNewPreroll;
+  gst_app_sink_set_callbacks(GST_APP_SINK(gst_.video_sink), &callbacks, this,
+                             NULL);
 
   // [10/10] Set up pipeline bus and sync handler
   gst_.bus = gst_pipeline_get_bus(GST_PIPELINE(gst_.pipeline));
@@ -386,34 +2362,124 @@ bool GstVideoPlayer::CreateLowLatencyRTSPPipeline() {
 	  return false;
   }
   gst_bus_set_sync_handler(gst_.bus, HandleGstMessage, this, NULL);
+  WatchBus();
 
   return true;
 }
 
 // Creats a video pipeline using playbin.
-// $ playbin uri=<file> video-sink="videoconvert ! video/x-raw,format=RGBA !
-// fakesink"
+// $ playbin uri=<file> video-sink="<converter> ! video/x-raw,format=RGBA !
+// appsink"
 bool GstVideoPlayer::CreateAutoDecodeFilePipeline() {
   gst_.pipeline = gst_pipeline_new("pipeline");
   if (!gst_.pipeline) {
     std::cerr << "Failed to create a pipeline" << std::endl;
     return false;
   }
-  gst_.playbin = gst_element_factory_make("playbin", "playbin");
-  if (!gst_.playbin) {
+  file_.playbin = gst_element_factory_make("playbin", "playbin");
+  if (!file_.playbin) {
+    std::cerr << "Failed to create a source" << std::endl;
+    return false;
+  }
+  if (!CreateFileOutput()) {
+    return false;
+  }
+
+  // Sets properties to playbin.
+  ApplyDownloadSettings();
+  ApplySubtitles();
+  if (!track_selection_.audio) {
+    guint flags = 0;
+    g_object_get(G_OBJECT(file_.playbin), "flags", &flags, NULL);
+    g_object_set(G_OBJECT(file_.playbin), "flags", flags & ~kPlayFlagAudio,
+                 NULL);
+  } else {
+    file_.volume = file_.playbin;
+  }
+  // The text streams go to the application instead of being rendered into
+  // the frames by subtitleoverlay. Any caps, so that bitmap subtitles, which
+  // are dropped, still link, and without holding up the preroll of a file
+  // without subtitles.
+  file_.text_sink = gst_element_factory_make("appsink", "textsink");
+  if (file_.text_sink) {
+    g_object_set(G_OBJECT(file_.text_sink), "sync", TRUE, "async", FALSE,
+                 NULL);
+    GstAppSinkCallbacks text_callbacks = {};
+    text_callbacks.new_sample = OnNewTextSample;
+    gst_app_sink_set_callbacks(GST_APP_SINK(file_.text_sink), &text_callbacks,
+                               this, NULL);
+    g_object_set(file_.playbin, "text-sink", file_.text_sink, NULL);
+  }
+  g_signal_connect(file_.playbin, "deep-element-added",
+                   G_CALLBACK(OnDeepElementAdded), this);
+  g_object_set(file_.playbin, "uri", uri_.c_str(), NULL);
+  g_object_set(file_.playbin, "video-sink", gst_.output, NULL);
+  gst_bin_add_many(GST_BIN(gst_.pipeline), file_.playbin, NULL);
+
+  return true;
+}
+
+// Creates a pipeline that decodes a local MP4 or Matroska file without
+// typefinding and autoplugging.
+// $ filesrc location=<path> ! <demuxer> ! <parser> ! <decoder> ! <output>
+//   <demuxer> ! queue ! decodebin ! audioconvert ! ... ! autoaudiosink
+bool GstVideoPlayer::CreateDirectFilePipeline() {
+  gst_.pipeline = gst_pipeline_new("pipeline");
+  if (!gst_.pipeline) {
+    std::cerr << "Failed to create a pipeline" << std::endl;
+    return false;
+  }
+  gchar* location = g_filename_from_uri(uri_.c_str(), nullptr, nullptr);
+  if (!location) {
+    std::cerr << "Failed to get the path of " << uri_ << std::endl;
+    return false;
+  }
+  file_.source = gst_element_factory_make("filesrc", "source");
+  file_.demuxer = gst_element_factory_make(FindFileDemuxer(uri_), "demuxer");
+  if (!file_.source || !file_.demuxer) {
     std::cerr << "Failed to create a source" << std::endl;
+    g_free(location);
+    for (auto** element : {&file_.source, &file_.demuxer}) {
+      if (*element) {
+        gst_object_unref(*element);
+        *element = nullptr;
+      }
+    }
+    return false;
+  }
+  g_object_set(G_OBJECT(file_.source), "location", location, NULL);
+  g_free(location);
+  AssetCache::GetInstance().ConfigureSource(file_.source);
+  gst_bin_add_many(GST_BIN(gst_.pipeline), file_.source, file_.demuxer, NULL);
+  if (!CreateFileOutput()) {
+    return false;
+  }
+  gst_bin_add(GST_BIN(gst_.pipeline), gst_.output);
+  if (!gst_element_link(file_.source, file_.demuxer)) {
+    std::cerr << "Failed to link elements" << std::endl;
     return false;
   }
-  gst_.video_convert = gst_element_factory_make("videoconvert", "videoconvert");
+  g_signal_connect(file_.demuxer, "pad-added", G_CALLBACK(OnDemuxerPadAdded),
+                   this);
+  return true;
+}
+
+bool GstVideoPlayer::CreateFileOutput() {
+  gst_.video_convert = CreateColorConverter();
   if (!gst_.video_convert) {
-    std::cerr << "Failed to create a videoconvert" << std::endl;
+    std::cerr << "Failed to create a color converter" << std::endl;
     return false;
   }
-  gst_.video_sink = gst_element_factory_make("fakesink", "videosink");
+  gst_.video_sink = gst_element_factory_make("appsink", "videosink");
   if (!gst_.video_sink) {
     std::cerr << "Failed to create a videosink" << std::endl;
     return false;
   }
+  gst_.output_filter = gst_element_factory_make("capsfilter", "outputfilter");
+  if (!gst_.output_filter) {
+    std::cerr << "Failed to create a capsfilter" << std::endl;
+    return false;
+  }
   gst_.output = gst_bin_new("output");
   if (!gst_.output) {
     std::cerr << "Failed to create an output" << std::endl;
@@ -425,48 +2491,368 @@ bool GstVideoPlayer::CreateAutoDecodeFilePipeline() {
     return false;
   }
   gst_bus_set_sync_handler(gst_.bus, HandleGstMessage, this, NULL);
-
-  // Sets properties to fakesink to get the callback of a decoded frame.
-  g_object_set(G_OBJECT(gst_.video_sink), "sync", TRUE, "qos", FALSE, NULL);
-  g_object_set(G_OBJECT(gst_.video_sink), "signal-handoffs", TRUE, NULL);
-  g_signal_connect(G_OBJECT(gst_.video_sink), "handoff",
-                   G_CALLBACK(HandoffHandler), this);
-  gst_bin_add_many(GST_BIN(gst_.output), gst_.video_convert, gst_.video_sink,
-                   NULL);
-
-  // Adds caps to the converter to convert the color format to RGBA.
-  auto* caps = gst_caps_from_string("video/x-raw,format=RGBA");
-  auto link_ok =
-      gst_element_link_filtered(gst_.video_convert, gst_.video_sink, caps);
-  gst_caps_unref(caps);
-  if (!link_ok) {
+  WatchBus();
+
+  // Sets properties to appsink to get the callback of a decoded frame. Only
+  // the newest frame is kept if the callback falls behind. The frames are
+  // released early into the presentation queue, which the texture callback
+  // takes them from on time.
+  g_object_set(G_OBJECT(gst_.video_sink), "sync", TRUE, "qos",
+               static_cast<gboolean>(is_qos_enabled_), "max-buffers", 1,
+               "drop", TRUE, "ts-offset", -kPresentationLead, NULL);
+  is_sink_synced_ = true;
+  is_presentation_scheduled_ = true;
+  GstAppSinkCallbacks callbacks = {};
+  callbacks.new_sample = OnNewSample;
+  callbacks.new_preroll = OnNewPreroll;
+  gst_app_sink_set_callbacks(GST_APP_SINK(gst_.video_sink), &callbacks, this,
+                             NULL);
+  gst_bin_add_many(GST_BIN(gst_.output), gst_.video_convert,
+                   gst_.output_filter, gst_.video_sink, NULL);
+
+  // Adds caps to the converter to convert the color format to the output
+  // format. RequestOutputSize() adds the size to them.
+  output_caps_ = gst_caps_from_string(kOutputCaps);
+  g_object_set(G_OBJECT(gst_.output_filter), "caps", output_caps_, NULL);
+  if (!gst_element_link_many(gst_.video_convert, gst_.output_filter,
+                             gst_.video_sink, NULL)) {
     std::cerr << "Failed to link elements" << std::endl;
     return false;
   }
 
   auto* sinkpad = gst_element_get_static_pad(gst_.video_convert, "sink");
+  gst_pad_add_probe(sinkpad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+                    OnOutputSinkEvent, this, nullptr);
+  // After the converter has answered the allocation query.
+  gst_pad_add_probe(
+      sinkpad,
+      (GstPadProbeType)(GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM |
+                        GST_PAD_PROBE_TYPE_PULL),
+      OnOutputSinkQuery, this, nullptr);
+  gst_pad_add_probe(sinkpad, GST_PAD_PROBE_TYPE_BUFFER, OnOutputSinkBuffer,
+                    this, nullptr);
   auto* ghost_sinkpad = gst_ghost_pad_new("sink", sinkpad);
   gst_pad_set_active(ghost_sinkpad, TRUE);
   gst_element_add_pad(gst_.output, ghost_sinkpad);
   gst_object_unref(sinkpad);
+  return true;
+}
 
-  // Sets properties to playbin.
-  g_object_set(gst_.playbin, "uri", uri_.c_str(), NULL);
-  g_object_set(gst_.playbin, "video-sink", gst_.output, NULL);
-  gst_bin_add_many(GST_BIN(gst_.pipeline), gst_.playbin, NULL);
+// static
+void GstVideoPlayer::OnDemuxerPadAdded(GstElement* demuxer, GstPad* new_pad,
+                                       gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  auto* caps = gst_pad_get_current_caps(new_pad);
+  if (!caps) {
+    caps = gst_pad_query_caps(new_pad, nullptr);
+  }
+  if (!caps || gst_caps_get_size(caps) == 0) {
+    if (caps) {
+      gst_caps_unref(caps);
+    }
+    return;
+  }
+  const auto* media_type =
+      gst_structure_get_name(gst_caps_get_structure(caps, 0));
+  // The other streams stay unlinked, which the demuxer ignores as long as
+  // one of them is linked.
+  if (g_str_has_prefix(media_type, "video/")) {
+    self->LinkFileVideoChain(new_pad, media_type);
+  } else if (g_str_has_prefix(media_type, "audio/")) {
+    std::lock_guard<std::mutex> lock(self->mutex_decoder_);
+    const auto index = self->file_.audio_pads++;
+    const auto& selection = self->track_selection_;
+    if (selection.audio && index == std::max(selection.audio_track, 0)) {
+      self->LinkFileAudioChain(new_pad);
+    }
+  }
+  gst_caps_unref(caps);
+}
 
-  return true;
+bool GstVideoPlayer::LinkFileVideoChain(GstPad* source_pad,
+                                        const gchar* media_type) {
+  std::lock_guard<std::mutex> lock(mutex_decoder_);
+  if (file_.decoder) {
+    return false;
+  }
+  const auto* codec = FindFileCodec(media_type);
+  if (!codec) {
+    PLUGIN_LOG(Error, "gst") << "No direct decoder chain for " << media_type;
+    return false;
+  }
+  auto* parse =
+      codec->parse ? gst_element_factory_make(codec->parse, "parse") : nullptr;
+  auto* decoder = CreateDecoder(codec->codec);
+  if ((codec->parse && !parse) || !decoder) {
+    PLUGIN_LOG(Error, "gst")
+        << "Failed to create the " << codec->codec << " elements";
+    for (auto* element : {parse, decoder}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    return false;
+  }
+#ifdef USE_EGL_IMAGE_DMABUF
+  RequestDmabufOutput(decoder);
+#endif  // USE_EGL_IMAGE_DMABUF
+  if (decoder_threads_ > 0) {
+    SetDecoderThreadCount(decoder, decoder_threads_);
+  }
+
+  gst_bin_add(GST_BIN(gst_.pipeline), decoder);
+  if (parse) {
+    gst_bin_add(GST_BIN(gst_.pipeline), parse);
+  }
+  file_.parse = parse;
+  file_.decoder = decoder;
+  stats_.SetDecoder(GST_OBJECT_NAME(gst_element_get_factory(decoder)));
+  bool linked = parse ? gst_element_link_many(parse, decoder, gst_.output, NULL)
+                      : gst_element_link(decoder, gst_.output);
+  if (!linked) {
+    PLUGIN_LOG(Error, "gst") << "Failed to link the decoder";
+    return false;
+  }
+
+  auto* decoder_sink_pad = gst_element_get_static_pad(decoder, "sink");
+  gst_pad_add_probe(decoder_sink_pad, GST_PAD_PROBE_TYPE_BUFFER,
+                    OnIdleDecoderSinkBuffer, this, nullptr);
+  gst_object_unref(decoder_sink_pad);
+
+  // Downstream first, so that nothing is pushed into an element that isn't
+  // running yet.
+  gst_element_sync_state_with_parent(decoder);
+  if (parse) {
+    gst_element_sync_state_with_parent(parse);
+  }
+  auto* sink_pad = gst_element_get_static_pad(parse ? parse : decoder, "sink");
+  linked = gst_pad_link(source_pad, sink_pad) == GST_PAD_LINK_OK;
+  gst_object_unref(sink_pad);
+  return linked;
 }
 
-bool GstVideoPlayer::Preroll() {
-  if (is_rtsp_) {
-    if (!gst_.pipeline) {
+bool GstVideoPlayer::LinkFileAudioChain(GstPad* source_pad) {
+  if (file_.audio) {
+    return false;
+  }
+  GError* error = nullptr;
+  auto* audio = gst_parse_bin_from_description(kFileAudioBranch, TRUE, &error);
+  if (!audio) {
+    PLUGIN_LOG(Error, "gst")
+        << "Failed to create the audio branch: " << error->message;
+    g_clear_error(&error);
+    return false;
+  }
+  gst_bin_add(GST_BIN(gst_.pipeline), audio);
+  file_.audio = audio;
+  // The bin keeps the element alive.
+  auto* volume = gst_bin_get_by_name(GST_BIN(audio), "volume");
+  file_.volume = volume;
+  gst_object_unref(volume);
+  ApplyVolume();
+
+  gst_element_sync_state_with_parent(audio);
+  auto* sink_pad = gst_element_get_static_pad(audio, "sink");
+  const bool linked = gst_pad_link(source_pad, sink_pad) == GST_PAD_LINK_OK;
+  gst_object_unref(sink_pad);
+  if (!linked) {
+    PLUGIN_LOG(Error, "gst") << "Failed to link the audio branch";
+  }
+  return linked;
+}
+
+void GstVideoPlayer::RemoveFileAudioChain() {
+  if (!file_.audio) {
+    return;
+  }
+  // Unlinked, the demuxer pushes nothing more into the branch, and carries
+  // on as long as the video pad is linked.
+  auto* sink_pad = gst_element_get_static_pad(file_.audio, "sink");
+  auto* peer = gst_pad_get_peer(sink_pad);
+  if (peer) {
+    gst_pad_unlink(peer, sink_pad);
+    gst_object_unref(peer);
+  }
+  gst_object_unref(sink_pad);
+  gst_element_set_state(file_.audio, GST_STATE_NULL);
+  gst_bin_remove(GST_BIN(gst_.pipeline), file_.audio);
+  file_.audio = nullptr;
+  file_.volume = nullptr;
+}
+
+GstPad* GstVideoPlayer::FindDemuxerAudioPad(int32_t index) {
+  struct Search {
+    int32_t index;
+    GstPad* pad;
+  } search = {std::max(index, 0), nullptr};
+  // In the order the demuxer exposed them, as OnDemuxerPadAdded() counts
+  // them.
+  gst_element_foreach_src_pad(
+      file_.demuxer,
+      [](GstElement* element, GstPad* pad, gpointer user_data) -> gboolean {
+        auto* search = static_cast<Search*>(user_data);
+        auto* caps = gst_pad_get_current_caps(pad);
+        if (!caps) {
+          return TRUE;
+        }
+        const auto is_audio =
+            gst_caps_get_size(caps) > 0 &&
+            g_str_has_prefix(
+                gst_structure_get_name(gst_caps_get_structure(caps, 0)),
+                "audio/");
+        gst_caps_unref(caps);
+        if (is_audio && search->index-- == 0) {
+          search->pad = GST_PAD(gst_object_ref(pad));
+          return FALSE;
+        }
+        return TRUE;
+      },
+      &search);
+  return search.pad;
+}
+
+// Creates a pipeline that mixes every tile into one frame.
+// $ uridecodebin uri=<tile 0> ! queue ! <compositor>.sink_0
+//   uridecodebin uri=<tile 1> ! queue ! <compositor>.sink_1 ...
+//   <compositor> ! video/x-raw,format=RGBA,width=<w>,height=<h> ! appsink
+bool GstVideoPlayer::CreateCompositorPipeline() {
+  if (tile_uris_.empty() || width_ <= 0 || height_ <= 0) {
+    std::cerr << "A compositor needs at least one tile and an output size"
+              << std::endl;
+    return false;
+  }
+
+  gst_.pipeline = gst_pipeline_new("pipeline");
+  if (!gst_.pipeline) {
+    std::cerr << "Failed to create a pipeline" << std::endl;
+    return false;
+  }
+  compositor_.compositor = CreateCompositor(gst_.pipeline, &compositor_.output);
+  if (!compositor_.compositor) {
+    return false;
+  }
+  // The default of compositor is a checker board.
+  gst_util_set_object_arg(G_OBJECT(compositor_.compositor), "background", "black");
+
+  gst_.video_sink = gst_element_factory_make("appsink", "videosink");
+  if (!gst_.video_sink) {
+    std::cerr << "Failed to create a sink" << std::endl;
+    return false;
+  }
+  gst_bin_add(GST_BIN(gst_.pipeline), gst_.video_sink);
+
+  // Live tiles are shown as soon as they arrive, like the RTSP pipeline.
+  bool is_live = true;
+  for (const auto& uri : tile_uris_) {
+    is_live &= IsRtspUri(uri);
+  }
+  g_object_set(G_OBJECT(gst_.video_sink), "sync", !is_live, "qos",
+               static_cast<gboolean>(is_qos_enabled_ && !is_live),
+               "max-buffers", 1, "drop", TRUE, NULL);
+  is_sink_synced_ = !is_live;
+
+#ifdef USE_EGL_IMAGE_DMABUF
+  auto* caps = gst_caps_from_string(kDmabufOutputCaps);
+#else
+  auto* caps = gst_caps_from_string(kOutputCaps);
+#endif  // USE_EGL_IMAGE_DMABUF
+  gst_caps_set_simple(caps, "width", G_TYPE_INT, width_, "height", G_TYPE_INT,
+                      height_, NULL);
+  auto link_ok =
+      gst_element_link_filtered(compositor_.output, gst_.video_sink, caps);
+  gst_caps_unref(caps);
+  if (!link_ok) {
+    std::cerr << "Failed to link the compositor to the sink" << std::endl;
+    return false;
+  }
+
+  for (const auto& uri : tile_uris_) {
+    auto* source = gst_element_factory_make("uridecodebin", nullptr);
+    auto* queue = gst_element_factory_make("queue", nullptr);
+    if (!source || !queue) {
+      std::cerr << "Failed to create the elements of a tile" << std::endl;
       return false;
     }
-  } else {
-    if (!gst_.playbin) {
+    g_object_set(G_OBJECT(source), "uri", uri.c_str(), NULL);
+    if (is_live) {
+      g_object_set(G_OBJECT(queue), "max-size-buffers", 1, "max-size-bytes",
+                   0, "max-size-time", 0, "leaky", 2, NULL);
+    }
+    gst_bin_add_many(GST_BIN(gst_.pipeline), source, queue, NULL);
+
+    auto* tile_pad = gst_element_request_pad_simple(compositor_.compositor, "sink_%u");
+    if (!tile_pad) {
+      std::cerr << "Failed to request a compositor pad" << std::endl;
       return false;
     }
+    tile_pads_.push_back(tile_pad);
+    auto* queue_pad = gst_element_get_static_pad(queue, "src");
+    auto link_result = gst_pad_link(queue_pad, tile_pad);
+    gst_object_unref(queue_pad);
+    if (link_result != GST_PAD_LINK_OK) {
+      std::cerr << "Failed to link a tile to the compositor" << std::endl;
+      return false;
+    }
+
+    g_signal_connect(source, "source-setup", G_CALLBACK(OnTileSourceSetup),
+                     this);
+    g_signal_connect(source, "pad-added", G_CALLBACK(OnTilePadAdded), queue);
+  }
+
+  // Lays the tiles out in an even grid.
+  const auto count = static_cast<int32_t>(tile_pads_.size());
+  int32_t columns = 1;
+  while (columns * columns < count) {
+    columns++;
+  }
+  const int32_t rows = (count + columns - 1) / columns;
+  const int32_t tile_width = width_ / columns;
+  const int32_t tile_height = height_ / rows;
+  for (int32_t i = 0; i < count; i++) {
+    SetTileLayout(i, (i % columns) * tile_width, (i / columns) * tile_height,
+                  tile_width, tile_height, 0);
+  }
+
+  GstAppSinkCallbacks callbacks = {};
+  callbacks.new_sample = OnNewSample;
+  callbacks.new_preroll = OnNewPreroll;
+  gst_app_sink_set_callbacks(GST_APP_SINK(gst_.video_sink), &callbacks, this,
+                             NULL);
+
+  gst_.bus = gst_pipeline_get_bus(GST_PIPELINE(gst_.pipeline));
+  if (!gst_.bus) {
+    std::cerr << "Failed to get a bus" << std::endl;
+    return false;
+  }
+  gst_bus_set_sync_handler(gst_.bus, HandleGstMessage, this, NULL);
+  WatchBus();
+
+  return true;
+}
+
+bool GstVideoPlayer::SetTileLayout(size_t index, int32_t x, int32_t y,
+                                   int32_t width, int32_t height,
+                                   int32_t z_order) {
+  if (index >= tile_pads_.size()) {
+    std::cerr << "Tile " << index << " doesn't exist" << std::endl;
+    return false;
+  }
+  if (width <= 0 || height <= 0 || z_order < 0) {
+    std::cerr << "Invalid layout of tile " << index << std::endl;
+    return false;
+  }
+
+  // The pad properties are read by the mixer under the object lock, so the
+  // layout can change while playing.
+  g_object_set(G_OBJECT(tile_pads_[index]), "xpos", x, "ypos", y, "width",
+               width, "height", height, "zorder",
+               static_cast<guint>(z_order), NULL);
+  return true;
+}
+
+bool GstVideoPlayer::Preroll() {
+  if (!gst_.pipeline) {
+    return false;
   }
 
   auto result = gst_element_set_state(gst_.pipeline, GST_STATE_PAUSED);
@@ -475,30 +2861,84 @@ bool GstVideoPlayer::Preroll() {
     return false;
   }
 
-  // Waits until the state becomes GST_STATE_PAUSED.
-  if (result == GST_STATE_CHANGE_ASYNC) {
-    GstState state, pending;
-    result = gst_element_get_state(gst_.pipeline, &state, &pending, GST_CLOCK_TIME_NONE);
-    if (result == GST_STATE_CHANGE_FAILURE) {
-      return false;
+  // Waits until the state becomes GST_STATE_PAUSED.
+  if (result == GST_STATE_CHANGE_ASYNC) {
+    const GstClockTime timeout = preroll_timeout_ms_ > 0
+                                     ? preroll_timeout_ms_ * GST_MSECOND
+                                     : GST_CLOCK_TIME_NONE;
+    GstState state, pending;
+    result = gst_element_get_state(gst_.pipeline, &state, &pending, timeout);
+    if (result == GST_STATE_CHANGE_FAILURE) {
+      return false;
+    }
+    if (result == GST_STATE_CHANGE_ASYNC) {
+      std::cerr << "Timed out prerolling after " << preroll_timeout_ms_
+                << " ms" << std::endl;
+      return false;
+    }
+  }
+  
+  return true;
+}
+
+void GstVideoPlayer::DestroyPipeline() {
+  if (bus_watch_id_) {
+    GstBusBridge::GetInstance().Unwatch(bus_watch_id_);
+    bus_watch_id_ = 0;
+  }
+
+  if (gst_.video_sink) {
+    GstAppSinkCallbacks callbacks = {};
+    gst_app_sink_set_callbacks(GST_APP_SINK(gst_.video_sink), &callbacks,
+                               NULL, NULL);
+  }
+
+  if (gst_.pipeline) {
+    gst_element_set_state(gst_.pipeline, GST_STATE_NULL);
+  }
+
+  if (timeshift_) {
+    timeshift_->Detach();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_jitter_buffer_);
+    if (jitter_buffer_) {
+      gst_object_unref(jitter_buffer_);
+      jitter_buffer_ = nullptr;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_download_);
+    if (download_queue_) {
+      gst_object_unref(download_queue_);
+      download_queue_ = nullptr;
     }
   }
-  
-  return true;
-}
 
-void GstVideoPlayer::DestroyPipeline() {
-  if (gst_.video_sink) {
-    g_object_set(G_OBJECT(gst_.video_sink), "signal-handoffs", FALSE, NULL);
+  {
+    std::lock_guard<std::mutex> lock(mutex_abr_);
+    if (adaptive_demux_) {
+      gst_object_unref(adaptive_demux_);
+      adaptive_demux_ = nullptr;
+    }
   }
 
-  if (gst_.pipeline) {
-    gst_element_set_state(gst_.pipeline, GST_STATE_NULL);
+  for (auto* pad : tile_pads_) {
+    gst_element_release_request_pad(compositor_.compositor, pad);
+    gst_object_unref(pad);
   }
+  tile_pads_.clear();
+  compositor_.compositor = nullptr;
+  compositor_.output = nullptr;
 
-  if (gst_.buffer) {
-    gst_buffer_unref(gst_.buffer);
-    gst_.buffer = nullptr;
+  frames_.Reset();
+  presentation_queue_.Clear();
+  ReleaseCaptureFrame();
+  if (sample_caps_) {
+    gst_caps_unref(sample_caps_);
+    sample_caps_ = nullptr;
   }
 
   if (gst_.bus) {
@@ -511,8 +2951,9 @@ void GstVideoPlayer::DestroyPipeline() {
     gst_.pipeline = nullptr;
   }
 
-  if (gst_.playbin) {
-    gst_.playbin = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_decoder_);
+    file_ = FileElements();
   }
 
   if (gst_.output) {
@@ -527,24 +2968,30 @@ void GstVideoPlayer::DestroyPipeline() {
     gst_.video_convert = nullptr;
   }
 
+  gst_.output_filter = nullptr;
+  if (output_caps_) {
+    gst_caps_unref(output_caps_);
+    output_caps_ = nullptr;
+  }
+
   // Unreference and clear the decoder
-  if (gst_.decoder) {
-    gst_.decoder = nullptr;
+  if (rtsp_.decoder) {
+    rtsp_.decoder = nullptr;
   }
 
   // Unreference and clear the parse
-  if (gst_.parse) {
-    gst_.parse = nullptr;
+  if (rtsp_.parse) {
+    rtsp_.parse = nullptr;
   }
 
   // Unreference and clear the depay
-  if (gst_.depay) {
-    gst_.depay = nullptr;
+  if (rtsp_.depay) {
+    rtsp_.depay = nullptr;
   }
 
   // Unreference and clear the source
-  if (gst_.source) {
-    gst_.source = nullptr;
+  if (rtsp_.source) {
+    rtsp_.source = nullptr;
   }
 }
 
@@ -565,7 +3012,11 @@ std::string GstVideoPlayer::ParseUri(const std::string& uri) {
 }
 
 void GstVideoPlayer::GetVideoSize(int32_t& width, int32_t& height) {
-  if (is_rtsp_) {
+  if (traits_->has_fixed_size) {
+    return;
+  }
+
+  if (traits_->is_live) {
     std::cerr
         << "rtsp width " << width << ", height " << height << std::endl;
     if (width <= 0 || height <= 0 || width > MAX_WIDTH || height > MAX_HEIGHT) {
@@ -620,84 +3071,686 @@ void GstVideoPlayer::GetVideoSize(int32_t& width, int32_t& height) {
   gst_object_unref(sink_pad);
 }
 
-void GstVideoPlayer::onPadAdded(GstElement *src, GstPad *new_pad, GstElement *depay)
-{
-  std::cout << "test onPadAdded" << std::endl;
-  GstPad *sink_pad = gst_element_get_static_pad(depay, "sink");
-  if (!gst_pad_is_linked(sink_pad)) {
-    GstPadLinkReturn ret = gst_pad_link(new_pad, sink_pad);
-    if (ret != GST_PAD_LINK_OK) {
-      std::cerr << "Failed to link dynamic pad from source to depayloader" << std::endl;
-    }
+// static
+gboolean GstVideoPlayer::OnRtspSelectStream(GstElement* source, guint num,
+                                            GstCaps* caps,
+                                            gpointer user_data) {
+  if (!caps || gst_caps_get_size(caps) == 0) {
+    return TRUE;
   }
-  gst_object_unref(sink_pad);
+  // onPadAdded() would leave the other streams unlinked, but they would
+  // still be received and go through the jitter buffer.
+  const auto* media =
+      gst_structure_get_string(gst_caps_get_structure(caps, 0), "media");
+  return !media || g_strcmp0(media, "video") == 0;
 }
 
-// static
-void GstVideoPlayer::HandoffHandler(GstElement* fakesink, GstBuffer* buf,
-                                    GstPad* new_pad, gpointer user_data) {
+void GstVideoPlayer::onPadAdded(GstElement* src, GstPad* new_pad,
+                                gpointer user_data) {
   auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
   auto* caps = gst_pad_get_current_caps(new_pad);
+  if (!caps) {
+    caps = gst_pad_query_caps(new_pad, nullptr);
+  }
   if (!caps || gst_caps_get_size(caps) == 0) {
-    std::cerr << "[Handoff] Failed to get valid caps" << std::endl;
+    PLUGIN_LOG(Error, "rtsp") << "Failed to get the caps of a dynamic pad";
+    if (caps) {
+      gst_caps_unref(caps);
+    }
     return;
   }
   auto* structure = gst_caps_get_structure(caps, 0);
-  if (!structure) {
-    std::cerr << "[Handoff] Caps has no structure" << std::endl;
+  const auto* media = gst_structure_get_string(structure, "media");
+  const auto* encoding_name =
+      gst_structure_get_string(structure, "encoding-name");
+  if (!media || g_strcmp0(media, "video") != 0 || !encoding_name) {
     gst_caps_unref(caps);
     return;
   }
-
-  int width = 0, height = 0;
-  if (!gst_structure_get_int(structure, "width", &width) || !gst_structure_get_int(structure, "height", &height)) {
+  const auto* codec = FindRtpCodec(encoding_name);
+  if (!codec) {
+    PLUGIN_LOG(Error, "rtsp") << "Unsupported RTP encoding " << encoding_name;
     gst_caps_unref(caps);
     return;
   }
   gst_caps_unref(caps);
-  if (width != self->width_ || height != self->height_) {
-    self->width_ = width;
-    self->height_ = height;
-    try {
-	    self->pixels_.reset(new uint32_t[width * height]);
-      std::cout << "Pixel buffer size: width = " << width
-              << ", height = " << height << std::endl;
-
-      self->stream_handler_->OnNotifyInitialized();
-	  } catch (const std::bad_alloc &e) {
-      return;
+
+  if (!self->LinkDecoderChain(codec->encoding_name, new_pad)) {
+    PLUGIN_LOG(Error, "rtsp")
+        << "Failed to link dynamic pad from source to depayloader";
+  }
+}
+
+bool GstVideoPlayer::LinkDecoderChain(const char* encoding_name,
+                                      GstPad* source_pad) {
+  const auto* codec = FindRtpCodec(encoding_name);
+  std::lock_guard<std::mutex> lock(mutex_decoder_);
+  if (rtsp_.depay && codec_ != codec->encoding_name) {
+    // Retargeted to a camera with another codec.
+    RemoveDecoderChain();
+  }
+
+  if (!rtsp_.depay) {
+    auto* depay = gst_element_factory_make(codec->depay, "depay");
+    auto* parse =
+        codec->parse ? gst_element_factory_make(codec->parse, "parse") : nullptr;
+    auto* decoder = CreateDecoder(codec->encoding_name);
+    if (!depay || (codec->parse && !parse) || !decoder) {
+      PLUGIN_LOG(Error, "rtsp")
+          << "Failed to create the " << codec->encoding_name << " elements";
+      for (auto* element : {depay, parse, decoder}) {
+        if (element) {
+          gst_object_unref(element);
+        }
+      }
+      return false;
+    }
+#ifdef USE_EGL_IMAGE_DMABUF
+    RequestDmabufOutput(decoder);
+#endif  // USE_EGL_IMAGE_DMABUF
+    if (decoder_threads_ > 0) {
+      SetDecoderThreadCount(decoder, decoder_threads_);
+    }
+
+    gst_bin_add_many(GST_BIN(gst_.pipeline), depay, decoder, NULL);
+    if (parse) {
+      gst_bin_add(GST_BIN(gst_.pipeline), parse);
+    }
+    rtsp_.depay = depay;
+    rtsp_.parse = parse;
+    rtsp_.decoder = decoder;
+    codec_ = codec->encoding_name;
+    stats_.SetDecoder(GST_OBJECT_NAME(gst_element_get_factory(decoder)));
+
+    auto* downstream = gst_.video_convert ? gst_.video_convert : rtsp_.queue;
+    bool linked = false;
+    if (parse && timeshift_) {
+      linked = gst_element_link(depay, parse) &&
+               timeshift_->Attach(gst_.pipeline, parse, decoder) &&
+               gst_element_link(decoder, downstream);
+    } else {
+      linked =
+          parse ? gst_element_link_many(depay, parse, decoder, downstream, NULL)
+                : gst_element_link_many(depay, decoder, downstream, NULL);
+    }
+    if (!linked) {
+      RemoveDecoderChain();
+      return false;
+    }
+
+    // Drops the delta frames before they reach the decoder in key frame
+    // only mode.
+    auto* decoder_sink_pad = gst_element_get_static_pad(decoder, "sink");
+    gst_pad_add_probe(decoder_sink_pad, GST_PAD_PROBE_TYPE_BUFFER,
+                      OnDecoderSinkBuffer, this, nullptr);
+    gst_object_unref(decoder_sink_pad);
+    auto* decoder_src_pad = gst_element_get_static_pad(decoder, "src");
+    gst_pad_add_probe(decoder_src_pad, GST_PAD_PROBE_TYPE_BUFFER,
+                      OnDecoderSrcBuffer, this, nullptr);
+    gst_object_unref(decoder_src_pad);
+
+    // Downstream first, so that nothing is pushed into an element that
+    // isn't running yet.
+    gst_element_sync_state_with_parent(decoder);
+    if (parse) {
+      gst_element_sync_state_with_parent(parse);
+    }
+    gst_element_sync_state_with_parent(depay);
+  }
+
+  auto* sink_pad = gst_element_get_static_pad(rtsp_.depay, "sink");
+  bool linked = gst_pad_is_linked(sink_pad) ||
+                gst_pad_link(source_pad, sink_pad) == GST_PAD_LINK_OK;
+  gst_object_unref(sink_pad);
+  return linked;
+}
+
+void GstVideoPlayer::RemoveDecoderChain() {
+  for (auto** element : {&rtsp_.depay, &rtsp_.parse, &rtsp_.decoder}) {
+    if (*element) {
+      gst_element_set_state(*element, GST_STATE_NULL);
+      gst_bin_remove(GST_BIN(gst_.pipeline), *element);
+      *element = nullptr;
+    }
+  }
+  if (timeshift_) {
+    timeshift_->Detach();
+  }
+  codec_.clear();
+}
+
+// static
+void GstVideoPlayer::OnTilePadAdded(GstElement* src, GstPad* new_pad,
+                                    GstElement* queue) {
+  auto* caps = gst_pad_get_current_caps(new_pad);
+  if (!caps) {
+    caps = gst_pad_query_caps(new_pad, nullptr);
+  }
+  const bool is_video =
+      caps && gst_caps_get_size(caps) > 0 &&
+      g_str_has_prefix(
+          gst_structure_get_name(gst_caps_get_structure(caps, 0)), "video/");
+  if (caps) {
+    gst_caps_unref(caps);
+  }
+  if (!is_video) {
+    return;
+  }
+
+  auto* sink_pad = gst_element_get_static_pad(queue, "sink");
+  if (!gst_pad_is_linked(sink_pad) &&
+      gst_pad_link(new_pad, sink_pad) != GST_PAD_LINK_OK) {
+    PLUGIN_LOG(Error, "gst") << "Failed to link a tile decoder to its queue";
+  }
+  gst_object_unref(sink_pad);
+}
+
+// static
+void GstVideoPlayer::OnTileSourceSetup(GstElement* bin, GstElement* source,
+                                       gpointer user_data) {
+  // Keeps the RTSP tiles as low-latency as the single stream pipeline.
+  if (g_object_class_find_property(G_OBJECT_GET_CLASS(source), "latency")) {
+    g_object_set(G_OBJECT(source), "latency", 0, NULL);
+  }
+  if (g_object_class_find_property(G_OBJECT_GET_CLASS(source),
+                                   "drop-on-latency")) {
+    g_object_set(G_OBJECT(source), "drop-on-latency", TRUE, NULL);
+  }
+}
+
+// static
+GstFlowReturn GstVideoPlayer::OnNewSample(GstAppSink* sink,
+                                          gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  auto* sample = gst_app_sink_pull_sample(sink);
+  if (!sample) {
+    return GST_FLOW_EOS;
+  }
+
+  TRACE_SCOPE(self->trace_track_, "OnNewSample");
+  self->last_frame_time_ms_ = NowMs();
+  if (self->wait_for_resume_.exchange(false)) {
+    std::lock_guard<std::mutex> lock(self->mutex_reconnect_);
+    self->resumed_ = true;
+    self->reconnect_cv_.notify_all();
+  }
+
+  GstClockTime running_time;
+  GstClockTimeDiff lateness;
+  const auto has_lateness = self->GetLateness(sample, running_time, lateness);
+  if (has_lateness) {
+    // In microseconds, keeping the sign.
+    self->latency_stats_.Record(LatencyStats::kAvDrift, lateness / 1000);
+    if (self->is_qos_enabled_ && !self->is_sink_synced_) {
+      self->SendQos(running_time, lateness);
     }
   }
+  if (has_lateness && self->IsLateFrame(lateness)) {
+    self->late_frames_++;
+    self->stats_.Add(PluginStats::kFramesDropped);
+  } else {
+    self->PublishSample(sample);
+  }
+  gst_sample_unref(sample);
+  return GST_FLOW_OK;
+}
+
+// static
+GstFlowReturn GstVideoPlayer::OnNewPreroll(GstAppSink* sink,
+                                           gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  auto* sample = gst_app_sink_pull_preroll(sink);
+  if (!sample) {
+    return GST_FLOW_OK;
+  }
+  // While playing, the same buffer is rendered as a sample right after. It is
+  // never late, since the preroll frame waits for the clock to start.
+  if (!self->is_playing_) {
+    self->PublishSample(sample);
+  }
+  gst_sample_unref(sample);
+  return GST_FLOW_OK;
+}
 
+void GstVideoPlayer::PublishSample(GstSample* sample) {
+  TRACE_SCOPE(trace_track_, "PublishSample");
+  auto* buffer = gst_sample_get_buffer(sample);
+  auto* caps = gst_sample_get_caps(sample);
+  if (!buffer || !caps) {
+    return;
+  }
+  // The sample shares the caps object of the pad until the next caps
+  // event, so comparing pointers is enough to detect a change.
+  if (caps != sample_caps_ && !UpdateSampleCaps(caps)) {
+    return;
+  }
+  auto timestamps = TakeDecodeTimestamps(GST_BUFFER_PTS(buffer));
+  timestamps.handoff = g_get_monotonic_time();
+  if (timestamps.decoded) {
+    latency_stats_.Record(LatencyStats::kDecodeToHandoff,
+                          timestamps.handoff - timestamps.decoded);
+  }
+  bool has_frame_stream = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_frame_stream_);
+    if (frame_stream_) {
+      frame_stream_->Push(buffer, caps);
+      has_frame_stream = true;
+    }
+  }
   {
-    std::lock_guard<std::shared_mutex> lock(self->mutex_buffer_);
-    if (self->gst_.buffer) {
-      gst_buffer_unref(self->gst_.buffer);
-      self->gst_.buffer = nullptr;
+    std::lock_guard<std::mutex> lock(mutex_capture_);
+    gst_buffer_replace(&capture_buffer_, buffer);
+    gst_caps_replace(&capture_caps_, caps);
+  }
+  if (is_presentation_scheduled_) {
+    presentation_queue_.Push(buffer, caps, width_, height_, timestamps,
+                             GetRunningTime(sample));
+  } else {
+    frames_.Publish(buffer, caps, width_, height_, timestamps);
+  }
+  stats_.Add(PluginStats::kFramesDecoded);
+  // The engine fetches a visible texture right after each notification.
+  // The frames of a frame stream are used even if the texture isn't shown,
+  // and the tiles of a compositor have no decoder to throttle.
+  const auto idle_frames = idle_throttle_frames_.load();
+  if (idle_frames > 0 && !has_frame_stream &&
+      traits_->has_single_decoder &&
+      ++frames_since_fetch_ == idle_frames) {
+    is_idle_throttled_ = true;
+    TRACE_INSTANT(trace_track_, "idle throttle on");
+  }
+  stream_handler()->OnNotifyFrameDecoded();
+}
+
+void GstVideoPlayer::SetFrameStream(FrameStream* stream) {
+  std::lock_guard<std::mutex> lock(mutex_frame_stream_);
+  frame_stream_ = stream;
+}
+
+bool GstVideoPlayer::CaptureFrame(FrameCapturePool& pool,
+                                  const FrameCapturePool::Request& request,
+                                  FrameCapturePool::Callback callback) {
+  std::lock_guard<std::mutex> lock(mutex_capture_);
+  if (!capture_buffer_) {
+    std::cerr << "No frame to capture" << std::endl;
+    return false;
+  }
+  return pool.Capture(capture_buffer_, capture_caps_, request,
+                      std::move(callback));
+}
+
+void GstVideoPlayer::ReleaseCaptureFrame() {
+  std::lock_guard<std::mutex> lock(mutex_capture_);
+  gst_buffer_replace(&capture_buffer_, nullptr);
+  gst_caps_replace(&capture_caps_, nullptr);
+}
+
+FrameTripleBuffer::Timestamps GstVideoPlayer::TakeDecodeTimestamps(
+    GstClockTime pts) {
+  std::lock_guard<std::mutex> lock(mutex_decode_timestamps_);
+  // The frames leave in order, so the older ones were dropped on the way.
+  while (!decode_timestamps_.empty()) {
+    auto entry = decode_timestamps_.front();
+    decode_timestamps_.pop_front();
+    if (entry.first == pts) {
+      return entry.second;
+    }
+  }
+  return FrameTripleBuffer::Timestamps();
+}
+
+void GstVideoPlayer::RecordTextureLatency(
+    const FrameTripleBuffer::Timestamps& timestamps) {
+  const auto now = g_get_monotonic_time();
+  if (timestamps.handoff) {
+    latency_stats_.Record(LatencyStats::kHandoffToTexture,
+                          now - timestamps.handoff);
+  }
+  if (timestamps.decoded) {
+    latency_stats_.Record(LatencyStats::kDecodeToTexture,
+                          now - timestamps.decoded);
+    if (timestamps.has_capture_latency) {
+      latency_stats_.Record(
+          LatencyStats::kGlassToGlass,
+          now - timestamps.decoded + timestamps.capture_latency);
+    }
+  }
+}
+
+bool GstVideoPlayer::UpdateSampleCaps(GstCaps* caps) {
+  auto* structure = gst_caps_get_structure(caps, 0);
+  if (!structure) {
+    PLUGIN_LOG(Error, "caps") << "Caps has no structure";
+    return false;
+  }
+
+  int width = 0, height = 0;
+  if (!gst_structure_get_int(structure, "width", &width) ||
+      !gst_structure_get_int(structure, "height", &height)) {
+    PLUGIN_LOG(Error, "caps") << "Failed to get the frame size from caps";
+    return false;
+  }
+  gst_caps_replace(&sample_caps_, caps);
+
+  if (width != width_ || height != height_) {
+    width_ = width;
+    height_ = height;
+    PLUGIN_LOG(Info, "caps") << "Pixel buffer size: width = " << width
+                             << ", height = " << height;
+
+    stream_handler()->OnNotifyInitialized();
+  }
+  return true;
+}
+
+bool GstVideoPlayer::GetLateness(GstSample* sample,
+                                 GstClockTime& running_time,
+                                 GstClockTimeDiff& lateness) {
+  running_time = GetRunningTime(sample);
+  GstClockTime now;
+  if (!GST_CLOCK_TIME_IS_VALID(running_time) || !GetSinkRunningTime(now)) {
+    return false;
+  }
+  lateness = GST_CLOCK_DIFF(running_time, now);
+  // The sink releases the scheduled frames ahead on purpose.
+  if (is_presentation_scheduled_) {
+    lateness += kPresentationLead;
+  }
+  return true;
+}
+
+// static
+GstClockTime GstVideoPlayer::GetRunningTime(GstSample* sample) {
+  auto* buffer = gst_sample_get_buffer(sample);
+  auto* segment = gst_sample_get_segment(sample);
+  if (!buffer || !segment || !GST_CLOCK_TIME_IS_VALID(GST_BUFFER_PTS(buffer))) {
+    return GST_CLOCK_TIME_NONE;
+  }
+  return gst_segment_to_running_time(segment, GST_FORMAT_TIME,
+                                     GST_BUFFER_PTS(buffer));
+}
+
+bool GstVideoPlayer::GetSinkRunningTime(GstClockTime& now) {
+  auto* clock = gst_element_get_clock(gst_.video_sink);
+  if (!clock) {
+    return false;
+  }
+  now = gst_clock_get_time(clock) - gst_element_get_base_time(gst_.video_sink);
+  gst_object_unref(clock);
+  return true;
+}
+
+void GstVideoPlayer::PresentScheduledFrame() {
+  if (!is_presentation_scheduled_) {
+    return;
+  }
+  presentation_queue_.OnFetch(g_get_monotonic_time());
+  // While paused, the queue holds the frame prerolled after a seek.
+  GstClockTime now;
+  if (!is_playing_ || !GetSinkRunningTime(now)) {
+    now = GST_CLOCK_TIME_NONE;
+  }
+  FrameTripleBuffer::Frame frame;
+  if (presentation_queue_.Take(now, frame)) {
+    // The texture callback is the producer of |frames_| in this case.
+    frames_.Publish(frame.buffer, frame.caps, frame.width, frame.height,
+                    frame.timestamps);
+    gst_buffer_unref(frame.buffer);
+    gst_caps_unref(frame.caps);
+  }
+  // The next frame may be due on the next vsync, which the engine only
+  // fetches the texture for once it is notified again.
+  if (presentation_queue_.HasPending()) {
+    stream_handler()->OnNotifyFrameDecoded();
+  }
+}
+
+bool GstVideoPlayer::IsLateFrame(GstClockTimeDiff lateness) {
+  const int64_t budget = latency_budget_ms_;
+  return budget > 0 &&
+         lateness > budget * static_cast<GstClockTimeDiff>(GST_MSECOND);
+}
+
+void GstVideoPlayer::SendQos(GstClockTime running_time,
+                             GstClockTimeDiff lateness) {
+  // The frames of a live stream arrive after their running time by the
+  // latency of the stream, which the floor tracks. It rises slowly, so that a
+  // lasting change of the network latency isn't taken for a slow decoder.
+  if (!has_qos_floor_ || lateness < qos_floor_) {
+    qos_floor_ = lateness;
+    has_qos_floor_ = true;
+  } else {
+    qos_floor_ += (lateness - qos_floor_) / kQosFloorRise;
+  }
+  auto* sink_pad = gst_element_get_static_pad(gst_.video_sink, "sink");
+  gst_pad_push_event(sink_pad,
+                     gst_event_new_qos(GST_QOS_TYPE_UNDERFLOW, 1.0,
+                                       lateness - qos_floor_, running_time));
+  gst_object_unref(sink_pad);
+}
+
+// static
+void GstVideoPlayer::SetTaskPool(GstTaskPool* task_pool) {
+  if (task_pool) {
+    gst_object_ref(task_pool);
+  }
+  if (task_pool_) {
+    gst_object_unref(task_pool_);
+  }
+  task_pool_ = task_pool;
+}
+
+bool GstVideoPlayer::SetDecoderThreads(int threads) {
+  std::lock_guard<std::mutex> lock(mutex_decoder_);
+  // Also applied to the decoders created later on.
+  decoder_threads_ = threads;
+  auto* decoder = rtsp_.decoder ? rtsp_.decoder : file_.decoder;
+  if (!decoder) {
+    return false;
+  }
+  return SetDecoderThreadCount(decoder, threads);
+}
+
+
+void GstVideoPlayer::SetQos(bool enabled) {
+  is_qos_enabled_ = enabled;
+  // A sink that syncs measures the lateness and sends the events itself.
+  if (gst_.video_sink && is_sink_synced_) {
+    g_object_set(G_OBJECT(gst_.video_sink), "qos",
+                 static_cast<gboolean>(enabled), NULL);
+  }
+}
+
+void GstVideoPlayer::EnableTimeshift(int64_t window_ms) {
+  if (!traits_->is_live || window_ms <= 0) {
+    return;
+  }
+  timeshift_ = std::make_unique<TimeshiftBuffer>(window_ms, kTimeshiftMaxBytes);
+}
+
+bool GstVideoPlayer::SetTimeshiftDelay(int64_t delay_ms) {
+  return timeshift_ && timeshift_->SetDelay(delay_ms);
+}
+
+bool GstVideoPlayer::GetTimeshiftState(TimeshiftBuffer::State& state) {
+  if (!timeshift_) {
+    return false;
+  }
+  state = timeshift_->GetState();
+  return true;
+}
+
+void GstVideoPlayer::SetKeyFrameOnly(bool key_frame_only) {
+  if (key_frame_only_.exchange(key_frame_only) && !key_frame_only) {
+    // The delta frames after the current position refer to the frames that
+    // have been dropped.
+    wait_for_key_frame_ = true;
+  }
+}
+
+void GstVideoPlayer::SetIdleThrottle(int idle_frames) {
+  idle_throttle_frames_ = std::max(idle_frames, 0);
+  if (idle_frames <= 0) {
+    OnTextureFetched();
+  }
+}
+
+void GstVideoPlayer::OnTextureFetched() {
+  frames_since_fetch_ = 0;
+  if (!is_idle_throttled_.exchange(false)) {
+    return;
+  }
+  TRACE_INSTANT(trace_track_, "idle throttle off");
+  if (traits_->is_live) {
+    wait_for_key_frame_ = true;
+    // Forwarded as a picture loss indication to cameras that support it,
+    // instead of waiting for the next key frame. Skipped while the decoder
+    // chain is rebuilt, rather than blocking the texture callback.
+    std::unique_lock<std::mutex> lock(mutex_decoder_, std::try_to_lock);
+    if (lock.owns_lock() && rtsp_.depay) {
+      gst_element_send_event(rtsp_.depay,
+                             gst_video_event_new_upstream_force_key_unit(
+                                 GST_CLOCK_TIME_NONE, TRUE, 0));
     }
-    self->gst_.buffer = gst_buffer_ref(buf);
+    return;
+  }
+  if (gst_.pipeline) {
+    gst_element_post_message(
+        gst_.pipeline,
+        gst_message_new_application(GST_OBJECT(gst_.pipeline),
+                                    gst_structure_new_empty(kIdleResume)));
   }
-  self->stream_handler_->OnNotifyFrameDecoded();
 }
 
 // static
-GstBusSyncReply GstVideoPlayer::HandleGstMessage(GstBus* bus,
-                                                 GstMessage* message,
-                                                 gpointer user_data) {
+GstPadProbeReturn GstVideoPlayer::OnDecoderSinkBuffer(GstPad* pad,
+                                                      GstPadProbeInfo* info,
+                                                      gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  auto* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  if (!GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    self->wait_for_key_frame_ = false;
+    return GST_PAD_PROBE_OK;
+  }
+  if (self->key_frame_only_ || self->wait_for_key_frame_ ||
+      self->is_idle_throttled_) {
+    return GST_PAD_PROBE_DROP;
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+// static
+GstPadProbeReturn GstVideoPlayer::OnIdleDecoderSinkBuffer(
+    GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  auto* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  if (self->is_idle_throttled_ &&
+      GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    return GST_PAD_PROBE_DROP;
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+// static
+GstPadProbeReturn GstVideoPlayer::OnDecoderSrcBuffer(GstPad* pad,
+                                                     GstPadProbeInfo* info,
+                                                     gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  auto* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  if (!GST_BUFFER_PTS_IS_VALID(buffer)) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  FrameTripleBuffer::Timestamps timestamps;
+  timestamps.decoded = g_get_monotonic_time();
+  auto* meta =
+      gst_buffer_get_reference_timestamp_meta(buffer, GetNtpReferenceCaps());
+  if (meta) {
+    // Negative when the clocks of the camera and this device disagree.
+    const auto capture_time =
+        static_cast<int64_t>(meta->timestamp / GST_USECOND) -
+        kNtpToUnixEpochUs;
+    timestamps.capture_latency = g_get_real_time() - capture_time;
+    timestamps.has_capture_latency = true;
+    self->latency_stats_.Record(LatencyStats::kCaptureToDecode,
+                                timestamps.capture_latency);
+  }
+
+  std::lock_guard<std::mutex> lock(self->mutex_decode_timestamps_);
+  self->decode_timestamps_.emplace_back(GST_BUFFER_PTS(buffer), timestamps);
+  if (self->decode_timestamps_.size() > kMaxPendingDecodeTimestamps) {
+    self->decode_timestamps_.pop_front();
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+void GstVideoPlayer::WatchBus() {
+  bus_watch_id_ = GstBusBridge::GetInstance().Watch(
+      gst_.bus,
+      [this](GstMessage* message) { HandleAsyncGstMessage(message); });
+}
+
+void GstVideoPlayer::HandleAsyncGstMessage(GstMessage* message) {
+  TRACE_SCOPE(trace_track_, "HandleAsyncGstMessage");
   switch (GST_MESSAGE_TYPE(message)) {
     case GST_MESSAGE_EOS: {
-      auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
-      std::lock_guard<std::mutex> lock(self->mutex_event_completed_);
-      self->is_completed_ = true;
+      if (traits_->is_live) {
+        // A live stream only ends when the server goes away.
+        RequestReconnect();
+        break;
+      }
+      // Outside segment mode, e.g. when the demuxer refused the segment
+      // seek, loops by seeking back.
+      if (auto_repeat_) {
+        PinLoopingAsset();
+        SetSeek(0);
+      } else {
+        stream_handler()->OnNotifyCompleted();
+      }
+      break;
+    }
+    case GST_MESSAGE_CLOCK_LOST: {
+      // E.g. the audio sink providing the clock went away with the audio
+      // stream. Going through PAUSED selects a new one.
+      if (is_playing_) {
+        gst_element_set_state(gst_.pipeline, GST_STATE_PAUSED);
+        gst_element_set_state(gst_.pipeline, GST_STATE_PLAYING);
+      }
+      break;
+    }
+    case GST_MESSAGE_SEGMENT_DONE: {
+      // The bin aggregates the streams, so only its own message marks the
+      // end of all of them.
+      if (GST_MESSAGE_SRC(message) != GST_OBJECT(gst_.pipeline)) {
+        break;
+      }
+      if (!auto_repeat_) {
+        stream_handler()->OnNotifyCompleted();
+        break;
+      }
+      PinLoopingAsset();
+      // Non-flushing, so the frames queued before the loop point are still
+      // shown and the decoder carries on without a new preroll.
+      // Backwards, the whole file is the segment again.
+      if (!gst_element_seek(gst_.pipeline, playback_rate_, GST_FORMAT_TIME,
+                            (GstSeekFlags)(GST_SEEK_FLAG_SEGMENT |
+                                           RateSeekFlags(playback_rate_)),
+                            GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_SET,
+                            GST_CLOCK_TIME_NONE)) {
+        PLUGIN_LOG(Warning, "gst") << "Failed to loop, seeking back instead";
+        is_segment_looping_ = false;
+        SetSeek(0);
+      }
       break;
     }
     case GST_MESSAGE_WARNING: {
       gchar* debug;
       GError* error;
       gst_message_parse_warning(message, &error, &debug);
-      g_printerr("WARNING from element %s: %s\n", GST_OBJECT_NAME(message->src),
-                 error->message);
-      g_printerr("Warning details: %s\n", debug);
+      PLUGIN_LOG(Warning, "gst")
+          << "WARNING from element " << GST_OBJECT_NAME(message->src) << ": "
+          << error->message << "\nWarning details: " << (debug ? debug : "");
       g_free(debug);
       g_error_free(error);
       break;
@@ -706,13 +3759,102 @@ GstBusSyncReply GstVideoPlayer::HandleGstMessage(GstBus* bus,
       gchar* debug;
       GError* error;
       gst_message_parse_error(message, &error, &debug);
-      g_printerr("ERROR from element %s: %s\n", GST_OBJECT_NAME(message->src),
-                 error->message);
-      g_printerr("Error details: %s\n", debug);
+      PLUGIN_LOG(Error, "gst")
+          << "ERROR from element " << GST_OBJECT_NAME(message->src) << ": "
+          << error->message << "\nError details: " << (debug ? debug : "");
       g_free(debug);
       g_error_free(error);
+      stats_.Add(PluginStats::kBusErrors);
+      if (rtsp_.source &&
+          gst_object_has_as_ancestor(GST_MESSAGE_SRC(message),
+                                     GST_OBJECT(rtsp_.source))) {
+        RequestReconnect();
+      }
+      break;
+    }
+    case GST_MESSAGE_BUFFERING: {
+      gint percent = 0;
+      gst_message_parse_buffering(message, &percent);
+      stats_.Set(PluginStats::kQueueLevel, percent);
+      const bool is_buffering = percent < 100;
+      if (is_buffering != is_buffering_) {
+        is_buffering_ = is_buffering;
+        stream_handler()->OnNotifyBuffering(is_buffering);
+      }
+      UpdateBufferedRanges();
+      break;
+    }
+    case GST_MESSAGE_ELEMENT:
+      HandleFragmentStatistics(gst_message_get_structure(message));
+      break;
+    case GST_MESSAGE_APPLICATION: {
+      // The decoder dropped the delta frames while the texture was idle,
+      // so it would otherwise only catch up at the next key frame.
+      const auto position = GetCurrentPosition();
+      if (position >= 0) {
+        SetSeek(position, SeekMode::kAccurate);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+GstBusSyncReply GstVideoPlayer::HandleGstMessage(GstBus* bus,
+                                                 GstMessage* message,
+                                                 gpointer user_data) {
+  TRACE_GST_MESSAGE(reinterpret_cast<GstVideoPlayer*>(user_data)->trace_track_,
+                    message);
+  switch (GST_MESSAGE_TYPE(message)) {
+    case GST_MESSAGE_STREAM_STATUS: {
+      ThreadPolicy::GetInstance().HandleStreamStatus(message);
+      // CREATE is posted from the thread creating the task, before it is
+      // started, so the task still can be moved to another pool.
+      auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+      GstStreamStatusType type;
+      GstElement* owner;
+      gst_message_parse_stream_status(message, &type, &owner);
+      if (type != GST_STREAM_STATUS_TYPE_CREATE || !self->task_pool_) {
+        break;
+      }
+      const GValue* object = gst_message_get_stream_status_object(message);
+      if (object && G_VALUE_TYPE(object) == GST_TYPE_TASK) {
+        gst_task_set_pool(GST_TASK(g_value_get_object(object)),
+                          self->task_pool_);
+      }
       break;
     }
+    case GST_MESSAGE_QOS: {
+      // Posted by a decoder for each frame it skips, and by the sink for
+      // each frame it drops.
+      auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+      if (GST_MESSAGE_SRC(message) != GST_OBJECT(self->gst_.video_sink)) {
+        self->qos_dropped_frames_++;
+        self->stats_.Add(PluginStats::kFramesDropped);
+        TRACE_COUNTER(self->trace_track_, "qos dropped frames",
+                      self->qos_dropped_frames_);
+      }
+      break;
+    }
+    case GST_MESSAGE_EOS:
+    case GST_MESSAGE_SEGMENT_DONE:
+    case GST_MESSAGE_CLOCK_LOST:
+    case GST_MESSAGE_WARNING:
+    case GST_MESSAGE_ERROR:
+    case GST_MESSAGE_BUFFERING:
+      // Handled by HandleAsyncGstMessage() on the bus bridge thread.
+      return GST_BUS_PASS;
+    case GST_MESSAGE_ELEMENT:
+      if (gst_message_has_name(message, kFragmentStatistics)) {
+        return GST_BUS_PASS;
+      }
+      break;
+    case GST_MESSAGE_APPLICATION:
+      if (gst_message_has_name(message, kIdleResume)) {
+        return GST_BUS_PASS;
+      }
+      break;
     default:
       break;
   }
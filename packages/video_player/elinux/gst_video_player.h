@@ -6,102 +6,754 @@
 #ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_PLAYER_H_
 #define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_PLAYER_H_
 
+#include <gst/app/gstappsink.h>
 #include <gst/gst.h>
+#include <gst/video/video.h>
 
 #ifdef USE_EGL_IMAGE_DMABUF
 #include <gst/allocators/gstdmabuf.h>
 #include <gst/gl/egl/egl.h>
 #include <gst/gl/gl.h>
-#include <gst/video/video.h>
 #endif  // USE_EGL_IMAGE_DMABUF
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "capability_registry.h"
+#include "frame_buffer_pool.h"
+#include "frame_capture_pool.h"
+#include "frame_stream.h"
+#include "frame_triple_buffer.h"
+#include "gst_bus_bridge.h"
+#include "keyframe_index.h"
+#include "latency_stats.h"
+#include "plugin_stats.h"
+#include "presentation_queue.h"
+#include "timeshift_buffer.h"
+#include "trace_event.h"
 #include "video_player_stream_handler.h"
+#ifdef USE_YUV_SHADER
+#include "yuv_texture_renderer.h"
+#endif  // USE_YUV_SHADER
 
 class GstVideoPlayer {
  public:
+  // How rtspsrc carries the RTP packets.
+  enum class RtspTransport {
+    // TCP interleaved. Works across NAT, but a lost packet stalls the ones
+    // behind it.
+    kTcp,
+    kUdp,
+    kMulticast,
+    // Unicast or multicast UDP, falling back to TCP when no UDP packet
+    // arrives.
+    kUdpFirst,
+  };
+
+  // Where a seek lands.
+  enum class SeekMode {
+    // On a key frame near the position, as chosen by the demuxer. The
+    // fastest.
+    kKeyUnit,
+    // On the exact position, decoding from the key frame before it.
+    kAccurate,
+    // On the last key frame at or before the position.
+    kSnapBefore,
+    // On the first key frame at or after the position.
+    kSnapAfter,
+  };
+
+  struct TransportStats {
+    uint64_t packets_received = 0;
+    uint64_t packets_lost = 0;
+    uint64_t packets_late = 0;
+    uint64_t packets_duplicated = 0;
+    // The average interarrival jitter in nanoseconds.
+    uint64_t jitter = 0;
+  };
+
+  // How the variants of an adaptive (HLS, DASH) stream are selected.
+  struct AbrPolicy {
+    // Caps the resolution of the variants. Zero means no cap.
+    int32_t max_width = 0;
+    int32_t max_height = 0;
+    // Also caps the resolution to the smallest common video height covering
+    // the size the texture is shown at.
+    bool follow_texture_size = false;
+    // Caps the bitrate of the variants in bits per second. Zero means no
+    // cap.
+    int64_t max_bitrate = 0;
+    // Caps the bitrate of the first fragments, after which the selection
+    // ramps up to the measured bandwidth. Zero lets the demuxer choose.
+    int64_t start_bitrate = 0;
+  };
+
+  struct ReconnectStats {
+    // The number of times the RTSP source has been restarted.
+    uint64_t attempts = 0;
+    // The number of times the stream has resumed after being lost.
+    uint64_t reconnects = 0;
+    // The time from losing the stream to its first frame after the last
+    // reconnect, in milliseconds.
+    int64_t last_latency_ms = 0;
+  };
+
+  // How a local file is played.
+  struct FileOptions {
+    // Builds filesrc ! demuxer ! parser ! decoder directly for MP4 and
+    // Matroska files, with the decoder ranked first by the capability
+    // registry, instead of autoplugging with playbin. Other files are still
+    // played with playbin.
+    bool fast_start = false;
+    // Builds no audio branch, as TrackSelection::audio does.
+    bool muted = false;
+  };
+
+  // The streams of a file that are played.
+  struct TrackSelection {
+    // Drops the audio streams instead of muting them, so that neither an
+    // audio decoder nor the audio device runs.
+    bool audio = true;
+    // The index of the audio stream played, or -1 for the default one.
+    int32_t audio_track = -1;
+  };
+
+  GstVideoPlayer(const std::string& uri,
+                 std::unique_ptr<VideoPlayerStreamHandler> handler);
   GstVideoPlayer(const std::string& uri,
+                 std::unique_ptr<VideoPlayerStreamHandler> handler,
+                 const FileOptions& file_options);
+  // Composites the videos of |uris| into one |width| x |height| frame, so
+  // that a grid of streams costs a single texture. The tiles are laid out
+  // in an even grid until SetTileLayout() is called.
+  GstVideoPlayer(const std::vector<std::string>& uris, int32_t width,
+                 int32_t height,
                  std::unique_ptr<VideoPlayerStreamHandler> handler);
   ~GstVideoPlayer();
 
   static void GstLibraryLoad();
   static void GstLibraryUnload();
 
+  // Prerolls the pipeline, waiting at most the preroll timeout. Blocks, so
+  // it should be called off the platform thread. Waits for Preload() if it
+  // has been called instead of prerolling again. On failure, the pipeline
+  // is left in NULL for the destructor, since the texture callback may
+  // still be using it.
   bool Init();
+  // Makes an Init() in progress on another thread return right away, e.g.
+  // when the player is disposed while waiting for its stream.
+  void AbortPreroll();
+  // Starts prerolling in the background.
+  void Preload();
+  // Points an idle player at |uri| without rebuilding its pipeline. Fails if
+  // |uri| needs a different type of pipeline. Leaves the pipeline in READY.
+  bool Retarget(const std::string& uri);
+  // Replaces the handler of the notifications. Waits for the notifications
+  // being delivered to the previous handler, so that it can be destroyed
+  // right after, even while the pipeline is streaming.
+  void SetStreamHandler(std::unique_ptr<VideoPlayerStreamHandler> handler);
+  static bool IsRtspUri(const std::string& uri);
+  // Whether |uri| is a whep:// or wheps:// endpoint of a WebRTC stream.
+  static bool IsWebRtcUri(const std::string& uri);
+  // Parses "tcp", "udp", "multicast" or "udp-first".
+  static bool ParseRtspTransport(const std::string& name,
+                                 RtspTransport& transport);
+  // Sets the transport of RTSP streams, which can also be given in the URI
+  // as rtsp://host/path#transport=udp-first. Takes effect when the stream
+  // connects, so it should be called before Init(). Defaults to TCP.
+  void SetRtspTransport(RtspTransport transport);
+  RtspTransport GetRtspTransport() const { return rtsp_transport_; }
+  // Reads the statistics of the jitter buffer of an RTSP stream. Returns
+  // false until the stream has connected.
+  bool GetTransportStats(TransportStats& stats);
+  // RTSP players restart their source when it fails, ends or stops
+  // delivering frames while playing, backing off exponentially between
+  // attempts. The texture keeps showing the last frame meanwhile, and the
+  // handler is notified of buffering until the stream resumes.
+  ReconnectStats GetReconnectStats();
+  // Takes effect at the next variant decision of the demuxer. The
+  // resolution is only capped by the demuxers that support it, e.g. DASH.
+  void SetAbrPolicy(const AbrPolicy& policy);
+  // Returns the bandwidth measured over the recent fragments of an adaptive
+  // stream in bits per second, or zero.
+  int64_t GetMeasuredBandwidth() const { return measured_bandwidth_; }
+  // Sets how long Init() waits for the pipeline to preroll in milliseconds.
+  // Zero or less waits forever.
+  void SetPrerollTimeout(int64_t milliseconds) {
+    preroll_timeout_ms_ = milliseconds;
+  };
   bool Play();
   bool Pause();
   bool Stop();
   bool SetVolume(double volume);
+  // Applies |selection| while playing. RTSP streams are always played
+  // without their audio streams, which are never set up, so only a
+  // selection without audio succeeds for them.
+  bool SetTrackSelection(const TrackSelection& selection);
+  TrackSelection GetTrackSelection();
+  // Sends the cues of the embedded text subtitles of a file played with
+  // playbin to the stream handler, which are no longer burned into the
+  // frames. Returns false for the other pipelines.
+  bool SetSubtitles(bool enabled);
+  // Negative rates play backwards. From 4x on either way, only the key
+  // frames are decoded, for fast scans of long recordings.
   bool SetPlaybackRate(double rate);
-  void SetAutoRepeat(bool auto_repeat) { auto_repeat_ = auto_repeat; };
-  bool SetSeek(int64_t position);
+  // Loops a file with segment seeks, so that the decoder keeps its state
+  // and the loop point costs no re-preroll. Falls back to seeking back on
+  // EOS when the demuxer doesn't support segment seeks.
+  void SetAutoRepeat(bool auto_repeat);
+  bool SetSeek(int64_t position) {
+    return SetSeek(position, SeekMode::kKeyUnit);
+  }
+  // Snaps with the key frame index once it is built, and with the snap
+  // flags of the demuxer until then.
+  bool SetSeek(int64_t position, SeekMode mode);
+  // Parses "key-unit", "accurate", "snap-before" or "snap-after".
+  static bool ParseSeekMode(const std::string& name, SeekMode& mode);
+  // In scrubbing mode, seeks only decode the key frame nearest to the
+  // position and skip the audio, so that dragging a timeline over a long
+  // recording stays interactive. Leaving it seeks accurately to the last
+  // scrubbed position.
+  bool SetScrubbing(bool scrubbing);
   int64_t GetDuration();
   int64_t GetCurrentPosition();
-  const uint8_t* GetFrameBuffer();
+  // Whether the playback is stalled on buffering, or on reconnecting an RTSP
+  // stream.
+  bool IsBuffering() const { return is_buffering_ || wait_for_resume_; }
+  // Returns the latest decoded RGBA frame and sets |width| and |height| to
+  // its size, which may differ from GetWidth() and GetHeight() while the
+  // stream is changing resolution.
+  //
+  // If |release_context| is not null and the held buffer is a single,
+  // tightly packed memory block, the buffer is mapped read-only and the
+  // returned pointer refers to it directly. In that case |*release_context|
+  // is set and must be passed to ReleaseFrameBuffer() once the caller has
+  // finished reading the pixels. Otherwise the frame is copied into an
+  // internal buffer and |*release_context| is set to nullptr.
+  const uint8_t* GetFrameBuffer(size_t& width, size_t& height,
+                                void** release_context = nullptr);
+  // Unmaps and unrefs a frame returned by GetFrameBuffer().
+  static void ReleaseFrameBuffer(void* release_context);
 #ifdef USE_EGL_IMAGE_DMABUF
   void* GetEGLImage(void* egl_display, void* egl_context);
 #endif  // USE_EGL_IMAGE_DMABUF
+  // Scales the output down to the smallest halving of the decoded size that
+  // still covers |width| x |height|, the size the texture is shown at, so
+  // that the conversion and the copy scale with what is on screen. Called
+  // from the texture callback. A size takes effect once the texture has been
+  // shown at it for a while, so resizing doesn't renegotiate every frame.
+  void RequestOutputSize(int32_t width, int32_t height);
+  // Also hands the frames to |stream|, or stops doing so if it's null. The
+  // stream must outlive its use, i.e. be replaced before being destroyed.
+  void SetFrameStream(FrameStream* stream);
+  // Captures the latest decoded frame on |pool|, as |request| asks. The
+  // frame is referenced rather than copied. Returns false without calling
+  // |callback| if there's no frame yet or the pool is busy.
+  bool CaptureFrame(FrameCapturePool& pool,
+                    const FrameCapturePool::Request& request,
+                    FrameCapturePool::Callback callback);
   int32_t GetWidth() const { return width_; };
   int32_t GetHeight() const { return height_; };
+  // Returns the number of decoded frames that were replaced by a newer one
+  // before the renderer picked them up.
+  uint64_t GetDroppedFrameCount() const {
+    return frames_.GetDroppedFrameCount() +
+           presentation_queue_.GetDroppedFrameCount();
+  };
+  // Sets the maximum age of a frame in milliseconds. Frames that reach the
+  // sink later than this after their running time are dropped before they
+  // are handed to the renderer. Zero or less disables the check.
+  void SetLatencyBudget(int64_t milliseconds) {
+    latency_budget_ms_ = milliseconds;
+  };
+  int64_t GetLatencyBudget() const { return latency_budget_ms_; };
+  // Returns the number of frames dropped for exceeding the latency budget.
+  uint64_t GetLateFrameCount() const { return late_frames_; };
+  // Returns the rolling percentiles of the frame latency at |stage|. The
+  // capture time is only known for RTSP cameras that send RTCP sender
+  // reports, and is only meaningful if the camera and this device are
+  // synchronized by NTP.
+  LatencyStats::Percentiles GetLatency(LatencyStats::Stage stage) const {
+    return latency_stats_.Get(stage);
+  };
+  bool IsRtsp() const { return traits_ == &kRtspPipeline; };
+  bool IsWebRtc() const { return traits_ == &kWebRtcPipeline; };
+  // Whether the stream is live, i.e. RTSP or WebRTC.
+  bool IsLive() const { return traits_->is_live; };
+  const FileOptions& GetFileOptions() const { return file_options_; };
+  bool IsCompositor() const { return traits_ == &kCompositorPipeline; };
+  // Runs the streaming threads of the pipeline on |task_pool|, or on the
+  // default pool if null. Must be called before Init().
+  void SetTaskPool(GstTaskPool* task_pool);
+  // Caps the number of threads used by the decoder. Returns false if the
+  // decoder doesn't have a thread count setting.
+  bool SetDecoderThreads(int threads);
+  // Keeps the last |window_ms| of the stream of a live player to play it
+  // back with SetTimeshiftDelay(). Only the codecs with a parser, e.g. H.264
+  // and H.265, are kept. Must be called before Init().
+  void EnableTimeshift(int64_t window_ms);
+  bool IsTimeshiftEnabled() const { return timeshift_ != nullptr; };
+  // Plays the stream |delay_ms| behind the live edge, or live if zero.
+  bool SetTimeshiftDelay(int64_t delay_ms);
+  // Returns false if timeshift isn't enabled.
+  bool GetTimeshiftState(TimeshiftBuffer::State& state);
+  // Decodes only the key frames of RTSP streams while enabled. Once
+  // disabled, decoding resumes from the next key frame.
+  void SetKeyFrameOnly(bool key_frame_only);
+  // Decodes only the key frames while the texture isn't fetched, e.g.
+  // behind another route, once |idle_frames| frames have been published
+  // since the last GetFrameBuffer() or GetEGLImage(). The next fetch
+  // resumes decoding at once, by seeking to the current position of a file
+  // and requesting a key frame from an RTSP camera. Zero disables it.
+  void SetIdleThrottle(int idle_frames);
+  bool IsIdleThrottled() const { return is_idle_throttled_; };
+  // Sends QoS events upstream while enabled, so that the decoders skip the
+  // frames that would reach the sink too late anyway instead of decoding
+  // them. A sink that doesn't sync, e.g. of an RTSP stream, measures the
+  // lateness above the latency of the stream.
+  void SetQos(bool enabled);
+  // Returns the number of frames the decoders have skipped for QoS.
+  uint64_t GetQosDroppedFrameCount() const { return qos_dropped_frames_; };
+  // The counters of the player listed on the stats channel once they have
+  // an id.
+  PluginStats& GetStats() { return stats_; }
+  size_t GetTileCount() const { return tile_pads_.size(); };
+  // Places the |index|-th tile of a compositor at (|x|, |y|) in the output
+  // frame, scaled to |width| x |height| and drawn above the tiles with a
+  // lower |z_order|.
+  bool SetTileLayout(size_t index, int32_t x, int32_t y, int32_t width,
+                     int32_t height, int32_t z_order);
 
  private:
+  // The elements every pipeline has.
   struct GstVideoElements {
-    GstElement* pipeline;
-    GstElement* playbin;
-    GstElement* video_convert;
-    GstElement* video_sink;
-    GstElement* output;
-    GstBus* bus;
-    GstBuffer* buffer;
-    GstElement* source;  // rtspsrc
-    GstElement* depay;   // rtph264depay
-    GstElement* parse;   // h264parse
-    GstElement* decoder; // qtic2vdec
-    GstElement* queue;
-  };
-
-  static void onPadAdded(GstElement* src, GstPad* new_pad, GstElement* depay);
-  static void HandoffHandler(GstElement* fakesink, GstBuffer* buf,
-                             GstPad* new_pad, gpointer user_data);
+    GstElement* pipeline = nullptr;
+    GstElement* video_convert = nullptr;
+    GstElement* video_sink = nullptr;
+    GstElement* output = nullptr;
+    GstBus* bus = nullptr;
+    GstElement* output_filter = nullptr;  // The caps filter in front of the sink.
+  };
+
+  struct FileElements {
+    GstElement* playbin = nullptr;
+    // The direct pipeline, the decoder chain being built by
+    // LinkFileVideoChain().
+    GstElement* source = nullptr;  // filesrc
+    GstElement* demuxer = nullptr;  // qtdemux or matroskademux
+    GstElement* parse = nullptr;
+    GstElement* decoder = nullptr;
+    // The element taking the "volume" and "mute" properties, i.e. playbin
+    // or the volume element of the audio branch. Null without audio.
+    GstElement* volume = nullptr;
+    // The audio branch of the direct pipeline, and the number of audio pads
+    // the demuxer has exposed.
+    GstElement* audio = nullptr;
+    int32_t audio_pads = 0;
+    // The text-sink of playbin.
+    GstElement* text_sink = nullptr;  // appsink
+  };
+
+  struct RtspElements {
+    GstElement* source = nullptr;  // rtspsrc or whepsrc
+    // Created by onPadAdded() for the codec of the stream.
+    GstElement* depay = nullptr;    // e.g. rtph264depay
+    GstElement* parse = nullptr;    // e.g. h264parse
+    GstElement* decoder = nullptr;  // e.g. qtivdec
+    GstElement* queue = nullptr;
+  };
+
+  struct CompositorElements {
+    GstElement* compositor = nullptr;  // glvideomixer or compositor
+    GstElement* output = nullptr;      // The element linked to the sink.
+  };
+
+  // What differs between the pipelines, described once per variant, so
+  // that the player asks the traits of its pipeline instead of branching on
+  // its type, and a new variant doesn't touch the others.
+  struct PipelineTraits {
+    bool (GstVideoPlayer::*create)();
+    // Points the source of a built pipeline at |uri_|. Null if the pipeline
+    // can't be retargeted.
+    void (GstVideoPlayer::*apply_uri)();
+    // Whether the stream is restarted when lost, and has no timeline to
+    // scrub.
+    bool is_live;
+    // Whether a single decoder decodes the stream, e.g. to throttle it.
+    bool has_single_decoder;
+    // Whether the output size is fixed by the caps of the sink.
+    bool has_fixed_size;
+    bool supports_segment_loop;
+  };
+  static const PipelineTraits kFilePipeline;
+  static const PipelineTraits kDirectFilePipeline;
+  static const PipelineTraits kRtspPipeline;
+  static const PipelineTraits kWebRtcPipeline;
+  static const PipelineTraits kCompositorPipeline;
+
+  static void onPadAdded(GstElement* src, GstPad* new_pad, gpointer user_data);
+  // Sets up the video streams of the RTSP session only.
+  static gboolean OnRtspSelectStream(GstElement* source, guint num,
+                                     GstCaps* caps, gpointer user_data);
+  static void OnRtspNewManager(GstElement* source, GstElement* manager,
+                               gpointer user_data);
+  static void OnNewJitterBuffer(GstElement* manager, GstElement* jitter_buffer,
+                                guint session, guint ssrc,
+                                gpointer user_data);
+  // Sets up the webrtcbin of whepsrc and its rtpbin.
+  static void OnWebRtcElementAdded(GstBin* bin, GstBin* sub_bin,
+                                   GstElement* element, gpointer user_data);
+  static void OnTilePadAdded(GstElement* src, GstPad* new_pad,
+                             GstElement* queue);
+  // Points the download of a network stream into the download cache,
+  // applies the ABR policy to the demuxer of an adaptive stream and sets up
+  // the source of an asset.
+  static void OnDeepElementAdded(GstBin* bin, GstBin* sub_bin,
+                                 GstElement* element, gpointer user_data);
+  static void OnTileSourceSetup(GstElement* bin, GstElement* source,
+                                gpointer user_data);
+  static GstFlowReturn OnNewSample(GstAppSink* sink, gpointer user_data);
+  // Shows the frame a paused pipeline prerolls on after a seek.
+  static GstFlowReturn OnNewPreroll(GstAppSink* sink, gpointer user_data);
+  void PublishSample(GstSample* sample);
+  static GstPadProbeReturn OnDecoderSinkBuffer(GstPad* pad,
+                                               GstPadProbeInfo* info,
+                                               gpointer user_data);
+  static GstPadProbeReturn OnDecoderSrcBuffer(GstPad* pad,
+                                              GstPadProbeInfo* info,
+                                              gpointer user_data);
+  // Drops the delta frames before the decoder of a file while the texture
+  // is idle.
+  static GstPadProbeReturn OnIdleDecoderSinkBuffer(GstPad* pad,
+                                                   GstPadProbeInfo* info,
+                                                   gpointer user_data);
+  // Called by the texture callbacks, to leave the idle throttling.
+  void OnTextureFetched();
+  // Holds |mutex_stream_handler_| shared until the end of the expression it
+  // is used in, e.g. stream_handler()->OnNotifyFrameDecoded().
+  class StreamHandlerRef {
+   public:
+    explicit StreamHandlerRef(GstVideoPlayer* player)
+        : lock_(player->mutex_stream_handler_),
+          handler_(player->stream_handler_.get()) {}
+    VideoPlayerStreamHandler* operator->() const { return handler_; }
+
+   private:
+    std::shared_lock<std::shared_mutex> lock_;
+    VideoPlayerStreamHandler* handler_;
+  };
+  StreamHandlerRef stream_handler() { return StreamHandlerRef(this); }
   static GstBusSyncReply HandleGstMessage(GstBus* bus, GstMessage* message,
                                           gpointer user_data);
+  // Handles the messages HandleGstMessage() passes on, on the bus bridge
+  // thread.
+  void HandleAsyncGstMessage(GstMessage* message);
+  void WatchBus();
+  bool StartSegmentLoop();
+  GstSeekFlags SegmentSeekFlags() const;
+  // Seeks to |position| in the direction of |rate|.
+  bool SeekWithRate(double rate, GstSeekFlags flags, GstClockTime position);
+  static GstSeekFlags RateSeekFlags(double rate);
   std::string ParseUri(const std::string& uri);
+  std::string ExtractUriOptions(const std::string& uri);
+  void ApplyRtspTransport();
+  // Returns the cached copy of |uri| if there's one. Otherwise sets up the
+  // download of |uri| into the download cache if it's enabled.
+  std::string PrepareDownload(const std::string& uri);
+  // Sets the download flag and the buffering properties of playbin.
+  void ApplyDownloadSettings();
+  // The |apply_uri| of the file, the RTSP and the WebRTC pipelines.
+  void ApplyFileUri();
+  void ApplyRtspUri();
+  void ApplyWebRtcUri();
+  // Notifies the buffered ranges and commits the download once it covers
+  // the whole stream. Called on the bus bridge thread.
+  void UpdateBufferedRanges();
+  void CommitDownload();
+  // Pins the file played in a loop, if it's an asset, once it has been read
+  // to its end. Called on the bus bridge thread.
+  void PinLoopingAsset();
+  // Must be called with |mutex_abr_| held.
+  void ApplyAbrPolicy();
+  void UpdateAbrTextureSize(int32_t width, int32_t height);
+  // Keeps the output at the size of the frames published so far when the
+  // decoded size switches to another resolution of the same picture, e.g.
+  // another variant of an adaptive stream, so that the texture keeps its
+  // size and the engine doesn't reallocate it. The converter scales the new
+  // resolution instead, until the texture is shown at another size. Called
+  // on the streaming thread.
+  void KeepOutputSize(int32_t source_width, int32_t source_height);
+  // Measures the throughput from the statistics an adaptive demuxer posts
+  // for each fragment. Called on the bus bridge thread.
+  void HandleFragmentStatistics(const GstStructure* structure);
+  // Reports the resolution switches of adaptive streams.
+  static GstPadProbeReturn OnOutputSinkEvent(GstPad* pad,
+                                             GstPadProbeInfo* info,
+                                             gpointer user_data);
+  // Lets the elements upstream attach their overlays to the frames as
+  // GstVideoOverlayCompositionMeta instead of blending them, and reports
+  // those overlays whenever they change.
+  static GstPadProbeReturn OnOutputSinkQuery(GstPad* pad,
+                                             GstPadProbeInfo* info,
+                                             gpointer user_data);
+  static GstPadProbeReturn OnOutputSinkBuffer(GstPad* pad,
+                                              GstPadProbeInfo* info,
+                                              gpointer user_data);
+  static GstFlowReturn OnNewTextSample(GstAppSink* sink, gpointer user_data);
+  // Sets the text flag of playbin from |is_subtitles_enabled_|.
+  void ApplySubtitles();
+  // Wakes up the reconnect supervisor. Called from the streaming threads.
+  void RequestReconnect();
+  void RunReconnectSupervisor();
+  void StopReconnectSupervisor();
+  // Restarts rtspsrc alone. The decoder chain stays in place, and
+  // onPadAdded() links the pads of the new session to it.
+  void RestartSource();
+  // Builds the pipeline of |traits_|.
   bool CreatePipeline();
   bool CreateLowLatencyRTSPPipeline();
+  bool CreateWebRtcPipeline();
+  // Creates the part of the RTSP and the WebRTC pipelines after the source,
+  // which onPadAdded() links the decoder chain to.
+  bool CreateLiveRtpOutput();
   bool CreateAutoDecodeFilePipeline();
+  bool CreateDirectFilePipeline();
+  // Creates the output bin of the file pipelines, i.e. the converter and
+  // the appsink.
+  bool CreateFileOutput();
+  static void OnDemuxerPadAdded(GstElement* demuxer, GstPad* new_pad,
+                                gpointer user_data);
+  bool LinkFileVideoChain(GstPad* source_pad, const gchar* media_type);
+  // Must be called with |mutex_decoder_| held, as the others of the audio
+  // branch of the direct pipeline.
+  bool LinkFileAudioChain(GstPad* source_pad);
+  void RemoveFileAudioChain();
+  // Returns a new reference to the |index|-th audio pad of the demuxer, or
+  // null if it hasn't exposed it yet.
+  GstPad* FindDemuxerAudioPad(int32_t index);
+  // Sets |volume_| and |mute_| to the audio of the pipeline, if it has any.
+  // Must be called with |mutex_decoder_| held.
+  void ApplyVolume();
+  bool CreateCompositorPipeline();
+  // Links |source_pad| of rtspsrc to a depayloader, parser and decoder for
+  // |encoding_name|, creating them unless the current chain matches.
+  bool LinkDecoderChain(const char* encoding_name, GstPad* source_pad);
+  // Must be called with |mutex_decoder_| held.
+  void RemoveDecoderChain();
   void DestroyPipeline();
   bool Preroll();
   void GetVideoSize(int32_t& width, int32_t& height);
+  bool UpdateSampleCaps(GstCaps* caps);
+  void ReleaseCaptureFrame();
+  // Returns how late |sample| reaches the sink against the pipeline clock,
+  // and its running time.
+  bool GetLateness(GstSample* sample, GstClockTime& running_time,
+                   GstClockTimeDiff& lateness);
+  // GST_CLOCK_TIME_NONE if |sample| has no timestamp or segment.
+  static GstClockTime GetRunningTime(GstSample* sample);
+  // The current running time of the video sink.
+  bool GetSinkRunningTime(GstClockTime& now);
+  // Moves the frame due on the next vsync from |presentation_queue_| to
+  // |frames_|. Called by the texture callbacks.
+  void PresentScheduledFrame();
+  bool IsLateFrame(GstClockTimeDiff lateness);
+  // Sends the QoS event of a frame at |running_time| from a sink that
+  // doesn't sync.
+  void SendQos(GstClockTime running_time, GstClockTimeDiff lateness);
+  // Returns the timestamps recorded at the decoder for the frame at |pts|.
+  FrameTripleBuffer::Timestamps TakeDecodeTimestamps(GstClockTime pts);
+  void RecordTextureLatency(const FrameTripleBuffer::Timestamps& timestamps);
+  const uint8_t* CopyFrameBuffer(GstBuffer* buffer, int32_t width,
+                                 int32_t height);
 #ifdef USE_EGL_IMAGE_DMABUF
+  bool EnsureGLContext(void* egl_display, void* egl_context);
   void UnrefEGLImage();
+  // The EGLImage of a DMABUF memory, attached to the memory so that it is
+  // reused as long as the decoder pool recycles the memory, and released
+  // once the memory is freed.
+  struct CachedEGLImage;
+  // Holds the EGLImages whose memory was freed on a streaming thread until
+  // the texture callback unreferences them, since the wrapped context only
+  // destroys them on the thread it is current on.
+  struct EGLImageReleaseQueue;
+  static void OnEGLImageMemoryFreed(gpointer data);
 #endif  // USE_EGL_IMAGE_DMABUF
 
+  const PipelineTraits* traits_ = nullptr;
   GstVideoElements gst_;
+  FileElements file_;
+  RtspElements rtsp_;
+  CompositorElements compositor_;
   std::string uri_;
-  std::unique_ptr<uint32_t[]> pixels_;
+  // Written by the streaming thread, read by the texture callback.
+  FrameTripleBuffer frames_;
+  // Whether the frames go through |presentation_queue_| on the way to
+  // |frames_|, i.e. the sink of a file.
+  bool is_presentation_scheduled_ = false;
+  PresentationQueue presentation_queue_;
+  // The caps of the last sample. Only touched by the streaming thread, so
+  // the caps are parsed once per caps change instead of once per frame.
+  GstCaps* sample_caps_ = nullptr;
+  // The output caps without a size.
+  GstCaps* output_caps_ = nullptr;
+  // Guards |frame_stream_| against the streaming thread.
+  std::mutex mutex_frame_stream_;
+  FrameStream* frame_stream_ = nullptr;
+  // The latest published frame, guarded by |mutex_capture_|. It's also held
+  // by |frames_| or |presentation_queue_| until the next one, so this
+  // reference doesn't keep another buffer of the decoder.
+  std::mutex mutex_capture_;
+  GstBuffer* capture_buffer_ = nullptr;
+  GstCaps* capture_caps_ = nullptr;
+  // Only touched by the texture callback, by KeepOutputSize() and by
+  // Retarget().
+  std::mutex mutex_output_size_;
+  int32_t requested_width_ = 0;
+  int32_t requested_height_ = 0;
+  int64_t request_time_ms_ = 0;
+  int64_t last_output_check_ms_ = 0;
+  int output_shift_ = 0;
+  int32_t output_source_width_ = 0;
+  int32_t output_source_height_ = 0;
+  // Set by KeepOutputSize(), with the texture size requested at the time.
+  bool is_output_size_kept_ = false;
+  int32_t kept_request_width_ = 0;
+  int32_t kept_request_height_ = 0;
+  std::atomic<int64_t> latency_budget_ms_{0};
+  int64_t preroll_timeout_ms_ = 0;
+  std::atomic<uint64_t> late_frames_{0};
+  std::atomic<bool> is_qos_enabled_{false};
+  std::atomic<bool> is_subtitles_enabled_{false};
+  // The sequence number of the overlay composition last reported, or zero
+  // without one. Only touched on the streaming thread.
+  guint overlay_seqnum_ = 0;
+  // Whether the appsink syncs to the clock, and so sends the QoS events
+  // itself.
+  bool is_sink_synced_ = true;
+  // The lateness of the frames of a sink that doesn't sync, below which they
+  // are on time, only touched on the streaming thread.
+  GstClockTimeDiff qos_floor_ = 0;
+  bool has_qos_floor_ = false;
+  std::atomic<uint64_t> qos_dropped_frames_{0};
+  PluginStats stats_{"video_player"};
+  LatencyStats latency_stats_;
+  KeyframeIndex keyframe_index_;
+  std::atomic<bool> is_scrubbing_{false};
+  int64_t scrub_position_ = 0;
+  // The frames between the decoder and the appsink, oldest first.
+  std::mutex mutex_decode_timestamps_;
+  std::deque<std::pair<GstClockTime, FrameTripleBuffer::Timestamps>>
+      decode_timestamps_;
+  GstTaskPool* task_pool_ = nullptr;
+  // Guards the decoder chain, which is built on the streaming thread.
+  std::mutex mutex_decoder_;
+  std::string codec_;
+  int decoder_threads_ = 0;
+  // Between the parser and the decoder of a live stream, if enabled.
+  std::unique_ptr<TimeshiftBuffer> timeshift_;
+  RtspTransport rtsp_transport_ = RtspTransport::kTcp;
+  // The jitter buffer of the current RTSP session, set on the streaming
+  // thread.
+  std::mutex mutex_jitter_buffer_;
+  GstElement* jitter_buffer_ = nullptr;
+  // The network URI being downloaded into the download cache, and the
+  // queue2 downloading it, set on the streaming thread.
+  std::mutex mutex_download_;
+  std::string download_uri_;
+  GstElement* download_queue_ = nullptr;
+  bool is_download_committed_ = false;
+  // The demuxer of an adaptive stream, set on the streaming thread, and its
+  // selection state.
+  std::mutex mutex_abr_;
+  AbrPolicy abr_policy_;
+  GstElement* adaptive_demux_ = nullptr;
+  int abr_fragments_ = 0;
+  int32_t abr_texture_height_ = 0;
+  std::atomic<bool> abr_follows_texture_{false};
+  std::atomic<int64_t> measured_bandwidth_{0};
+  // The decoded size of the current variant. Only touched by the streaming
+  // thread, and by Retarget().
+  int32_t variant_width_ = 0;
+  int32_t variant_height_ = 0;
+  // Guards the state of the reconnect supervisor.
+  std::mutex mutex_reconnect_;
+  std::condition_variable reconnect_cv_;
+  std::thread reconnect_thread_;
+  bool stop_reconnect_ = false;
+  bool reconnect_requested_ = false;
+  // Set by the first frame after a restart of the source.
+  bool resumed_ = false;
+  std::atomic<bool> wait_for_resume_{false};
+  // The steady clock time of the last sample in milliseconds, or zero.
+  std::atomic<int64_t> last_frame_time_ms_{0};
+  ReconnectStats reconnect_stats_;
+  std::atomic<bool> key_frame_only_{false};
+  // Set when leaving key frame only mode, until the next key frame.
+  std::atomic<bool> wait_for_key_frame_{false};
+  std::atomic<int> idle_throttle_frames_{0};
+  std::atomic<int> frames_since_fetch_{0};
+  std::atomic<bool> is_idle_throttled_{false};
+  // Only touched by the texture callback.
+  FrameBufferPool::Buffer pixels_;
   int32_t width_;
   int32_t height_;
+  FileOptions file_options_;
+  // Guarded by |mutex_decoder_|, since the audio branch of the direct file
+  // pipeline is built on the streaming thread.
+  TrackSelection track_selection_;
   double volume_ = 1.0;
-  double playback_rate_ = 1.0;
+  std::atomic<double> playback_rate_{1.0};
   bool mute_ = false;
-  bool auto_repeat_ = false;
-  bool is_completed_ = false;
-  bool is_playing_ = false;
-  bool is_rtsp_ = false;
-  std::mutex mutex_event_completed_;
-  std::shared_mutex mutex_buffer_;
+  std::atomic<bool> auto_repeat_{false};
+  // Set once the pipeline is in segment mode, where the end of the stream
+  // posts SEGMENT_DONE instead of EOS and every seek must keep the
+  // segment flag.
+  std::atomic<bool> is_segment_looping_{false};
+  // Written by the bus bridge thread.
+  std::atomic<bool> is_buffering_{false};
+  std::atomic<bool> is_playing_{false};
+  bool is_prerolled_ = false;
+  std::thread preload_thread_;
+  std::vector<std::string> tile_uris_;
+  // The request pads of the compositor, one per tile.
+  std::vector<GstPad*> tile_pads_;
+  guint bus_watch_id_ = 0;
+  // Held shared while a notification is delivered, and exclusively by
+  // SetStreamHandler().
+  std::shared_mutex mutex_stream_handler_;
   std::unique_ptr<VideoPlayerStreamHandler> stream_handler_;
+#ifdef USE_TRACE_EVENTS
+  // The track of the trace events of the player, numbered in the order the
+  // players are created.
+  static std::string CreateTraceTrack();
+  const std::string trace_track_ = CreateTraceTrack();
+#endif  // USE_TRACE_EVENTS
 
 #ifdef USE_EGL_IMAGE_DMABUF
   GstVideoInfo gst_video_info_;
-  GstEGLImage* gst_egl_image_ = NULL;
+  // The wrapped display and context are created once per Flutter
+  // (egl_display, egl_context) pair.
+  void* egl_display_ = nullptr;
+  void* egl_context_ = nullptr;
   GstGLContext* gst_gl_ctx_ = NULL;
   GstGLDisplayEGL* gst_gl_display_egl_ = NULL;
+  // The caps |gst_video_info_| was made from. The EGLImages themselves are
+  // attached to the memories of the frames.
+  GstCaps* egl_image_caps_ = NULL;
+  std::shared_ptr<EGLImageReleaseQueue> egl_image_release_queue_;
+  bool warned_non_dmabuf_ = false;
 #endif  // USE_EGL_IMAGE_DMABUF
+#ifdef USE_YUV_SHADER
+  std::unique_ptr<YuvTextureRenderer> yuv_renderer_;
+#endif  // USE_YUV_SHADER
 };
 
 #endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_PLAYER_H_
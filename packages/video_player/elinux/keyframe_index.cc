@@ -0,0 +1,223 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "keyframe_index.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+// How often the indexing thread checks for a cancellation.
+constexpr GstClockTime kBusPollInterval = 100 * GST_MSECOND;
+}  // namespace
+
+KeyframeIndex::~KeyframeIndex() { Reset(); }
+
+void KeyframeIndex::Build(const std::string& uri) {
+  Reset();
+  is_cancelled_ = false;
+  thread_ = std::thread([this, uri]() { Run(uri); });
+}
+
+void KeyframeIndex::Reset() {
+  is_cancelled_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  keyframes_.clear();
+  is_ready_ = false;
+}
+
+bool KeyframeIndex::FindBefore(GstClockTime position,
+                               GstClockTime& timestamp) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (keyframes_.empty()) {
+    return false;
+  }
+  auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), position);
+  timestamp = it == keyframes_.begin() ? *it : *(it - 1);
+  return true;
+}
+
+bool KeyframeIndex::FindAfter(GstClockTime position,
+                              GstClockTime& timestamp) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (keyframes_.empty()) {
+    return false;
+  }
+  auto it = std::lower_bound(keyframes_.begin(), keyframes_.end(), position);
+  timestamp = it == keyframes_.end() ? keyframes_.back() : *it;
+  return true;
+}
+
+bool KeyframeIndex::FindNearest(GstClockTime position,
+                                GstClockTime& timestamp) const {
+  GstClockTime before, after;
+  if (!FindBefore(position, before) || !FindAfter(position, after)) {
+    return false;
+  }
+  const auto distance_before =
+      position > before ? position - before : before - position;
+  const auto distance_after =
+      after > position ? after - position : position - after;
+  timestamp = distance_before <= distance_after ? before : after;
+  return true;
+}
+
+void KeyframeIndex::Run(const std::string& uri) {
+  pipeline_ = gst_pipeline_new("keyframe-index");
+  auto* source = gst_element_factory_make("urisourcebin", nullptr);
+  parser_ = gst_element_factory_make("parsebin", nullptr);
+  if (!pipeline_ || !source || !parser_) {
+    std::cerr << "Failed to create a key frame index pipeline" << std::endl;
+    if (source) {
+      gst_object_unref(source);
+    }
+    if (parser_) {
+      gst_object_unref(parser_);
+    }
+    if (pipeline_) {
+      gst_object_unref(pipeline_);
+    }
+    pipeline_ = nullptr;
+    parser_ = nullptr;
+    return;
+  }
+  g_object_set(source, "uri", uri.c_str(), NULL);
+  gst_bin_add_many(GST_BIN(pipeline_), source, parser_, NULL);
+  g_signal_connect(source, "pad-added", G_CALLBACK(OnPadAdded), this);
+  g_signal_connect(parser_, "pad-added", G_CALLBACK(OnPadAdded), this);
+  gst_segment_init(&segment_, GST_FORMAT_TIME);
+  has_video_pad_ = false;
+  collected_.clear();
+
+  // The sinks don't sync, so the file is demuxed as fast as it can be read.
+  auto is_done = false;
+  auto* bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline_));
+  if (gst_element_set_state(pipeline_, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    std::cerr << "Failed to start indexing the key frames of " << uri
+              << std::endl;
+  } else {
+    while (!is_cancelled_) {
+      auto* message = gst_bus_timed_pop_filtered(
+          bus, kBusPollInterval,
+          (GstMessageType)(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+      if (!message) {
+        continue;
+      }
+      if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS) {
+        is_done = true;
+      } else {
+        GError* error;
+        gchar* debug;
+        gst_message_parse_error(message, &error, &debug);
+        std::cerr << "Failed to index the key frames of " << uri << ": "
+                  << error->message << std::endl;
+        g_free(debug);
+        g_error_free(error);
+      }
+      gst_message_unref(message);
+      break;
+    }
+  }
+  gst_element_set_state(pipeline_, GST_STATE_NULL);
+  gst_object_unref(bus);
+  gst_object_unref(pipeline_);
+  pipeline_ = nullptr;
+  parser_ = nullptr;
+
+  if (is_done && !collected_.empty()) {
+    // The timestamps come in decoding order, and a key frame may be output
+    // twice around a fragment boundary.
+    std::sort(collected_.begin(), collected_.end());
+    collected_.erase(std::unique(collected_.begin(), collected_.end()),
+                     collected_.end());
+    std::lock_guard<std::mutex> lock(mutex_);
+    keyframes_.swap(collected_);
+    is_ready_ = true;
+  }
+  collected_.clear();
+}
+
+// static
+void KeyframeIndex::OnPadAdded(GstElement* element, GstPad* pad,
+                               gpointer user_data) {
+  auto* self = reinterpret_cast<KeyframeIndex*>(user_data);
+  if (element != self->parser_) {
+    auto* sink_pad = gst_element_get_static_pad(self->parser_, "sink");
+    if (gst_pad_link(pad, sink_pad) != GST_PAD_LINK_OK) {
+      std::cerr << "Failed to link the source to the parser" << std::endl;
+    }
+    gst_object_unref(sink_pad);
+    return;
+  }
+
+  // Every stream needs a sink, or the demuxer stops on not-linked.
+  auto* sink = gst_element_factory_make("fakesink", nullptr);
+  if (!sink) {
+    std::cerr << "Failed to create a fakesink" << std::endl;
+    return;
+  }
+  g_object_set(G_OBJECT(sink), "sync", FALSE, "async", FALSE, NULL);
+  gst_bin_add(GST_BIN(self->pipeline_), sink);
+  gst_element_sync_state_with_parent(sink);
+  auto* sink_pad = gst_element_get_static_pad(sink, "sink");
+  gst_pad_link(pad, sink_pad);
+  gst_object_unref(sink_pad);
+
+  if (self->has_video_pad_) {
+    return;
+  }
+  auto* caps = gst_pad_get_current_caps(pad);
+  if (!caps) {
+    caps = gst_pad_query_caps(pad, nullptr);
+  }
+  auto* structure = caps ? gst_caps_get_structure(caps, 0) : nullptr;
+  if (structure &&
+      g_str_has_prefix(gst_structure_get_name(structure), "video/")) {
+    self->has_video_pad_ = true;
+    gst_pad_add_probe(pad,
+                      (GstPadProbeType)(GST_PAD_PROBE_TYPE_BUFFER |
+                                        GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM),
+                      OnVideoData, self, nullptr);
+  }
+  if (caps) {
+    gst_caps_unref(caps);
+  }
+}
+
+// static
+GstPadProbeReturn KeyframeIndex::OnVideoData(GstPad* pad,
+                                             GstPadProbeInfo* info,
+                                             gpointer user_data) {
+  auto* self = reinterpret_cast<KeyframeIndex*>(user_data);
+  if (info->type & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+    auto* event = GST_PAD_PROBE_INFO_EVENT(info);
+    // The positions of the player are stream times, which differ from the
+    // timestamps when the container doesn't start at zero, e.g. MPEG-TS.
+    if (GST_EVENT_TYPE(event) == GST_EVENT_SEGMENT) {
+      gst_event_copy_segment(event, &self->segment_);
+    }
+    return GST_PAD_PROBE_OK;
+  }
+
+  auto* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  if (!buffer || GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    return GST_PAD_PROBE_OK;
+  }
+  const auto timestamp = GST_BUFFER_PTS_IS_VALID(buffer)
+                             ? GST_BUFFER_PTS(buffer)
+                             : GST_BUFFER_DTS(buffer);
+  if (!GST_CLOCK_TIME_IS_VALID(timestamp)) {
+    return GST_PAD_PROBE_OK;
+  }
+  const auto stream_time =
+      gst_segment_to_stream_time(&self->segment_, GST_FORMAT_TIME, timestamp);
+  if (GST_CLOCK_TIME_IS_VALID(stream_time)) {
+    self->collected_.push_back(stream_time);
+  }
+  return GST_PAD_PROBE_OK;
+}
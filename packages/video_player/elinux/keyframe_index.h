@@ -0,0 +1,68 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_KEYFRAME_INDEX_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_KEYFRAME_INDEX_H_
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The stream times of the key frames of a file, collected on a background
+// thread by demuxing the file without decoding it.
+//
+// Lets the player snap a seek to a key frame before or after the target and
+// then seek there accurately, which costs no decoding of the frames in
+// between, for any container and whatever the demuxer does with the snap
+// flags.
+class KeyframeIndex {
+ public:
+  KeyframeIndex() = default;
+  ~KeyframeIndex();
+
+  // Prevent copying.
+  KeyframeIndex(KeyframeIndex const&) = delete;
+  KeyframeIndex& operator=(KeyframeIndex const&) = delete;
+
+  // Starts indexing |uri|, dropping the index of the previous file.
+  void Build(const std::string& uri);
+  // Stops the indexing and drops the index.
+  void Reset();
+  bool IsReady() const { return is_ready_; }
+
+  // Sets |timestamp| to the last key frame at or before |position|, in
+  // nanoseconds. Returns false until the index is ready.
+  bool FindBefore(GstClockTime position, GstClockTime& timestamp) const;
+  // Sets |timestamp| to the first key frame at or after |position|.
+  bool FindAfter(GstClockTime position, GstClockTime& timestamp) const;
+  // Sets |timestamp| to the key frame closest to |position|.
+  bool FindNearest(GstClockTime position, GstClockTime& timestamp) const;
+
+ private:
+  void Run(const std::string& uri);
+  static void OnPadAdded(GstElement* element, GstPad* pad,
+                         gpointer user_data);
+  static GstPadProbeReturn OnVideoData(GstPad* pad, GstPadProbeInfo* info,
+                                       gpointer user_data);
+
+  std::thread thread_;
+  std::atomic<bool> is_cancelled_{false};
+  std::atomic<bool> is_ready_{false};
+  // Only touched by the streaming thread of the indexing pipeline.
+  GstElement* pipeline_ = nullptr;
+  GstElement* parser_ = nullptr;
+  bool has_video_pad_ = false;
+  GstSegment segment_;
+  std::vector<GstClockTime> collected_;
+
+  mutable std::mutex mutex_;
+  // Sorted, only set once the whole file is indexed.
+  std::vector<GstClockTime> keyframes_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_KEYFRAME_INDEX_H_
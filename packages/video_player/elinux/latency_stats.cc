@@ -0,0 +1,55 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "latency_stats.h"
+
+#include <algorithm>
+#include <vector>
+
+void LatencyStats::Record(Stage stage, int64_t latency_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& window = windows_[stage];
+  window.samples[window.next] = latency_us;
+  window.next = (window.next + 1) % kWindowSize;
+  window.count = std::min(window.count + 1, kWindowSize);
+}
+
+LatencyStats::Percentiles LatencyStats::Get(Stage stage) const {
+  std::vector<int64_t> samples;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto& window = windows_[stage];
+    samples.assign(window.samples.begin(),
+                   window.samples.begin() + window.count);
+  }
+
+  Percentiles percentiles;
+  percentiles.count = samples.size();
+  if (samples.empty()) {
+    return percentiles;
+  }
+  // Nearest-rank percentiles. The element at each rank is selected in
+  // ascending order, so every nth_element() only scans the upper part.
+  const auto select = [&samples](size_t percent, size_t from) {
+    const size_t rank = (samples.size() * percent + 99) / 100;
+    const size_t index = std::max<size_t>(rank, 1) - 1;
+    std::nth_element(samples.begin() + std::min(from, index),
+                     samples.begin() + index, samples.end());
+    return index;
+  };
+  const auto p50 = select(50, 0);
+  percentiles.p50 = samples[p50];
+  const auto p95 = select(95, p50);
+  percentiles.p95 = samples[p95];
+  percentiles.p99 = samples[select(99, p95)];
+  return percentiles;
+}
+
+void LatencyStats::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& window : windows_) {
+    window.next = 0;
+    window.count = 0;
+  }
+}
@@ -0,0 +1,71 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_LATENCY_STATS_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_LATENCY_STATS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Rolling percentiles of the per-frame latencies between the stages of a
+// pipeline, over the last |kWindowSize| frames.
+//
+// Record() is called from the streaming and raster threads and only takes a
+// short lock, the percentiles are computed on demand by Get().
+class LatencyStats {
+ public:
+  enum Stage {
+    // From the capture time of the camera to the output of the decoder: the
+    // encoding, network, jitter buffer and decoding latency.
+    kCaptureToDecode = 0,
+    // From the decoder to the appsink: the conversion and the queue.
+    kDecodeToHandoff,
+    // From the appsink to the texture callback picking up the frame.
+    kHandoffToTexture,
+    kDecodeToTexture,
+    // From the capture time of the camera to the texture callback.
+    kGlassToGlass,
+    // How late a frame reaches the sink against the pipeline clock, which
+    // is the clock of the audio sink while the media has audio. Negative if
+    // early.
+    kAvDrift,
+    kStageCount,
+  };
+
+  struct Percentiles {
+    // In microseconds.
+    int64_t p50 = 0;
+    int64_t p95 = 0;
+    int64_t p99 = 0;
+    // The number of frames in the window.
+    size_t count = 0;
+  };
+
+  static constexpr size_t kWindowSize = 300;
+
+  LatencyStats() = default;
+  ~LatencyStats() = default;
+
+  // Prevent copying.
+  LatencyStats(LatencyStats const&) = delete;
+  LatencyStats& operator=(LatencyStats const&) = delete;
+
+  void Record(Stage stage, int64_t latency_us);
+  Percentiles Get(Stage stage) const;
+  void Reset();
+
+ private:
+  struct Window {
+    std::array<int64_t, kWindowSize> samples;
+    size_t next = 0;
+    size_t count = 0;
+  };
+
+  mutable std::mutex mutex_;
+  Window windows_[kStageCount];
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_LATENCY_STATS_H_
@@ -0,0 +1,124 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_ABR_POLICY_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_ABR_POLICY_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class AbrPolicyMessage {
+ public:
+  AbrPolicyMessage() = default;
+  ~AbrPolicyMessage() = default;
+
+  // Prevent copying.
+  AbrPolicyMessage(AbrPolicyMessage const&) = default;
+  AbrPolicyMessage& operator=(AbrPolicyMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetMaxWidth(int64_t max_width) { max_width_ = max_width; }
+
+  int64_t GetMaxWidth() const { return max_width_; }
+
+  void SetMaxHeight(int64_t max_height) { max_height_ = max_height; }
+
+  int64_t GetMaxHeight() const { return max_height_; }
+
+  void SetFollowTextureSize(bool follow_texture_size) {
+    follow_texture_size_ = follow_texture_size;
+  }
+
+  bool GetFollowTextureSize() const { return follow_texture_size_; }
+
+  void SetMaxBitrate(int64_t max_bitrate) { max_bitrate_ = max_bitrate; }
+
+  int64_t GetMaxBitrate() const { return max_bitrate_; }
+
+  void SetStartBitrate(int64_t start_bitrate) {
+    start_bitrate_ = start_bitrate;
+  }
+
+  int64_t GetStartBitrate() const { return start_bitrate_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("textureId"),
+         flutter::EncodableValue(texture_id_)},
+        {flutter::EncodableValue("maxWidth"),
+         flutter::EncodableValue(max_width_)},
+        {flutter::EncodableValue("maxHeight"),
+         flutter::EncodableValue(max_height_)},
+        {flutter::EncodableValue("followTextureSize"),
+         flutter::EncodableValue(follow_texture_size_)},
+        {flutter::EncodableValue("maxBitrate"),
+         flutter::EncodableValue(max_bitrate_)},
+        {flutter::EncodableValue("startBitrate"),
+         flutter::EncodableValue(start_bitrate_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static AbrPolicyMessage FromMap(const flutter::EncodableValue& value) {
+    AbrPolicyMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& max_width =
+          map[flutter::EncodableValue("maxWidth")];
+      if (std::holds_alternative<int32_t>(max_width) ||
+          std::holds_alternative<int64_t>(max_width)) {
+        message.SetMaxWidth(max_width.LongValue());
+      }
+
+      flutter::EncodableValue& max_height =
+          map[flutter::EncodableValue("maxHeight")];
+      if (std::holds_alternative<int32_t>(max_height) ||
+          std::holds_alternative<int64_t>(max_height)) {
+        message.SetMaxHeight(max_height.LongValue());
+      }
+
+      flutter::EncodableValue& follow_texture_size =
+          map[flutter::EncodableValue("followTextureSize")];
+      if (std::holds_alternative<bool>(follow_texture_size)) {
+        message.SetFollowTextureSize(std::get<bool>(follow_texture_size));
+      }
+
+      flutter::EncodableValue& max_bitrate =
+          map[flutter::EncodableValue("maxBitrate")];
+      if (std::holds_alternative<int32_t>(max_bitrate) ||
+          std::holds_alternative<int64_t>(max_bitrate)) {
+        message.SetMaxBitrate(max_bitrate.LongValue());
+      }
+
+      flutter::EncodableValue& start_bitrate =
+          map[flutter::EncodableValue("startBitrate")];
+      if (std::holds_alternative<int32_t>(start_bitrate) ||
+          std::holds_alternative<int64_t>(start_bitrate)) {
+        message.SetStartBitrate(start_bitrate.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  int64_t max_width_ = 0;
+  int64_t max_height_ = 0;
+  bool follow_texture_size_ = false;
+  int64_t max_bitrate_ = 0;
+  int64_t start_bitrate_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_ABR_POLICY_MESSAGE_H_
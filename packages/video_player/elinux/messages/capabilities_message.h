@@ -0,0 +1,108 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CAPABILITIES_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CAPABILITIES_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+#include <vector>
+
+struct DecoderCapability {
+  std::string codec;
+  std::string name;
+  bool is_hardware = false;
+  // Zero if the decoder doesn't tell.
+  int32_t max_width = 0;
+  int32_t max_height = 0;
+};
+
+struct ElementCapability {
+  std::string name;
+  bool is_hardware = false;
+};
+
+class CapabilitiesMessage {
+ public:
+  CapabilitiesMessage() = default;
+  ~CapabilitiesMessage() = default;
+
+  // Prevent copying.
+  CapabilitiesMessage(CapabilitiesMessage const&) = default;
+  CapabilitiesMessage& operator=(CapabilitiesMessage const&) = default;
+
+  // In order of preference for each codec.
+  void AddDecoder(const DecoderCapability& decoder) {
+    decoders_.push_back(decoder);
+  }
+
+  const std::vector<DecoderCapability>& GetDecoders() const {
+    return decoders_;
+  }
+
+  void AddConverter(const ElementCapability& converter) {
+    converters_.push_back(converter);
+  }
+
+  const std::vector<ElementCapability>& GetConverters() const {
+    return converters_;
+  }
+
+  void AddCompositor(const ElementCapability& compositor) {
+    compositors_.push_back(compositor);
+  }
+
+  const std::vector<ElementCapability>& GetCompositors() const {
+    return compositors_;
+  }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableList decoders;
+    for (const auto& decoder : decoders_) {
+      flutter::EncodableMap map = {
+          {flutter::EncodableValue("codec"),
+           flutter::EncodableValue(decoder.codec)},
+          {flutter::EncodableValue("name"),
+           flutter::EncodableValue(decoder.name)},
+          {flutter::EncodableValue("isHardware"),
+           flutter::EncodableValue(decoder.is_hardware)},
+          {flutter::EncodableValue("maxWidth"),
+           flutter::EncodableValue(decoder.max_width)},
+          {flutter::EncodableValue("maxHeight"),
+           flutter::EncodableValue(decoder.max_height)}};
+      decoders.push_back(flutter::EncodableValue(map));
+    }
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("decoders"),
+         flutter::EncodableValue(decoders)},
+        {flutter::EncodableValue("converters"),
+         flutter::EncodableValue(ToList(converters_))},
+        {flutter::EncodableValue("compositors"),
+         flutter::EncodableValue(ToList(compositors_))}};
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  static flutter::EncodableList ToList(
+      const std::vector<ElementCapability>& elements) {
+    flutter::EncodableList list;
+    for (const auto& element : elements) {
+      flutter::EncodableMap map = {
+          {flutter::EncodableValue("name"),
+           flutter::EncodableValue(element.name)},
+          {flutter::EncodableValue("isHardware"),
+           flutter::EncodableValue(element.is_hardware)}};
+      list.push_back(flutter::EncodableValue(map));
+    }
+    return list;
+  }
+
+  std::vector<DecoderCapability> decoders_;
+  std::vector<ElementCapability> converters_;
+  std::vector<ElementCapability> compositors_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CAPABILITIES_MESSAGE_H_
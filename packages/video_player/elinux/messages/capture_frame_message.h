@@ -0,0 +1,91 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CAPTURE_FRAME_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CAPTURE_FRAME_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+
+class CaptureFrameMessage {
+ public:
+  CaptureFrameMessage() = default;
+  ~CaptureFrameMessage() = default;
+
+  // Prevent copying.
+  CaptureFrameMessage(CaptureFrameMessage const&) = default;
+  CaptureFrameMessage& operator=(CaptureFrameMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  // "jpeg", "png" or "rgba".
+  void SetFormat(const std::string& format) { format_ = format; }
+
+  const std::string& GetFormat() const { return format_; }
+
+  void SetMaxSize(int64_t max_size) { max_size_ = max_size; }
+
+  int64_t GetMaxSize() const { return max_size_; }
+
+  void SetPath(const std::string& path) { path_ = path; }
+
+  const std::string& GetPath() const { return path_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {{flutter::EncodableValue("textureId"),
+                                  flutter::EncodableValue(texture_id_)},
+                                 {flutter::EncodableValue("format"),
+                                  flutter::EncodableValue(format_)},
+                                 {flutter::EncodableValue("maxSize"),
+                                  flutter::EncodableValue(max_size_)},
+                                 {flutter::EncodableValue("path"),
+                                  flutter::EncodableValue(path_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static CaptureFrameMessage FromMap(const flutter::EncodableValue& value) {
+    CaptureFrameMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& format = map[flutter::EncodableValue("format")];
+      if (std::holds_alternative<std::string>(format)) {
+        message.SetFormat(std::get<std::string>(format));
+      }
+
+      flutter::EncodableValue& max_size =
+          map[flutter::EncodableValue("maxSize")];
+      if (std::holds_alternative<int32_t>(max_size) ||
+          std::holds_alternative<int64_t>(max_size)) {
+        message.SetMaxSize(max_size.LongValue());
+      }
+
+      flutter::EncodableValue& path = map[flutter::EncodableValue("path")];
+      if (std::holds_alternative<std::string>(path)) {
+        message.SetPath(std::get<std::string>(path));
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  std::string format_ = "jpeg";
+  int64_t max_size_ = 0;
+  std::string path_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CAPTURE_FRAME_MESSAGE_H_
@@ -0,0 +1,63 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CAPTURED_FRAME_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CAPTURED_FRAME_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+class CapturedFrameMessage {
+ public:
+  CapturedFrameMessage() = default;
+  ~CapturedFrameMessage() = default;
+
+  // Prevent copying.
+  CapturedFrameMessage(CapturedFrameMessage const&) = default;
+  CapturedFrameMessage& operator=(CapturedFrameMessage const&) = default;
+
+  void SetWidth(int64_t width) { width_ = width; }
+
+  int64_t GetWidth() const { return width_; }
+
+  void SetHeight(int64_t height) { height_ = height; }
+
+  int64_t GetHeight() const { return height_; }
+
+  void SetData(std::vector<uint8_t> data) { data_ = std::move(data); }
+
+  const std::vector<uint8_t>& GetData() const { return data_; }
+
+  // Set instead of the data if the frame was written to a file.
+  void SetPath(const std::string& path) { path_ = path; }
+
+  const std::string& GetPath() const { return path_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("width"), flutter::EncodableValue(width_)},
+        {flutter::EncodableValue("height"), flutter::EncodableValue(height_)}};
+    if (path_.empty()) {
+      // Moved rather than copied, since a frame may be large.
+      map.emplace(flutter::EncodableValue("data"),
+                  flutter::EncodableValue(std::move(data_)));
+    } else {
+      map.emplace(flutter::EncodableValue("path"),
+                  flutter::EncodableValue(path_));
+    }
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  int64_t width_ = 0;
+  int64_t height_ = 0;
+  std::vector<uint8_t> data_;
+  std::string path_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CAPTURED_FRAME_MESSAGE_H_
@@ -0,0 +1,107 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_COMPOSITOR_LAYOUT_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_COMPOSITOR_LAYOUT_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <vector>
+
+struct CompositorTile {
+  int64_t x = 0;
+  int64_t y = 0;
+  int64_t width = 0;
+  int64_t height = 0;
+  int64_t z_order = 0;
+};
+
+class CompositorLayoutMessage {
+ public:
+  CompositorLayoutMessage() = default;
+  ~CompositorLayoutMessage() = default;
+
+  // Prevent copying.
+  CompositorLayoutMessage(CompositorLayoutMessage const&) = default;
+  CompositorLayoutMessage& operator=(CompositorLayoutMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetTiles(const std::vector<CompositorTile>& tiles) { tiles_ = tiles; }
+
+  const std::vector<CompositorTile>& GetTiles() const { return tiles_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableList tiles;
+    for (const auto& tile : tiles_) {
+      tiles.push_back(flutter::EncodableValue(flutter::EncodableMap{
+          {flutter::EncodableValue("x"), flutter::EncodableValue(tile.x)},
+          {flutter::EncodableValue("y"), flutter::EncodableValue(tile.y)},
+          {flutter::EncodableValue("width"),
+           flutter::EncodableValue(tile.width)},
+          {flutter::EncodableValue("height"),
+           flutter::EncodableValue(tile.height)},
+          {flutter::EncodableValue("zOrder"),
+           flutter::EncodableValue(tile.z_order)}}));
+    }
+    flutter::EncodableMap map = {{flutter::EncodableValue("textureId"),
+                                  flutter::EncodableValue(texture_id_)},
+                                 {flutter::EncodableValue("tiles"),
+                                  flutter::EncodableValue(tiles)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static CompositorLayoutMessage FromMap(const flutter::EncodableValue& value) {
+    CompositorLayoutMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& tiles = map[flutter::EncodableValue("tiles")];
+      if (std::holds_alternative<flutter::EncodableList>(tiles)) {
+        std::vector<CompositorTile> values;
+        for (const auto& tile : std::get<flutter::EncodableList>(tiles)) {
+          if (std::holds_alternative<flutter::EncodableMap>(tile)) {
+            values.push_back(TileFromMap(std::get<flutter::EncodableMap>(tile)));
+          }
+        }
+        message.SetTiles(values);
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  static CompositorTile TileFromMap(flutter::EncodableMap map) {
+    CompositorTile tile;
+    const auto get = [&map](const char* key, int64_t& value) {
+      flutter::EncodableValue& field = map[flutter::EncodableValue(key)];
+      if (std::holds_alternative<int32_t>(field) ||
+          std::holds_alternative<int64_t>(field)) {
+        value = field.LongValue();
+      }
+    };
+    get("x", tile.x);
+    get("y", tile.y);
+    get("width", tile.width);
+    get("height", tile.height);
+    get("zOrder", tile.z_order);
+    return tile;
+  }
+
+  int64_t texture_id_ = 0;
+  std::vector<CompositorTile> tiles_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_COMPOSITOR_LAYOUT_MESSAGE_H_
@@ -0,0 +1,85 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CREATE_COMPOSITOR_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CREATE_COMPOSITOR_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+#include <vector>
+
+class CreateCompositorMessage {
+ public:
+  CreateCompositorMessage() = default;
+  ~CreateCompositorMessage() = default;
+
+  // Prevent copying.
+  CreateCompositorMessage(CreateCompositorMessage const&) = default;
+  CreateCompositorMessage& operator=(CreateCompositorMessage const&) = default;
+
+  void SetUris(const std::vector<std::string>& uris) { uris_ = uris; }
+
+  const std::vector<std::string>& GetUris() const { return uris_; }
+
+  void SetWidth(int64_t width) { width_ = width; }
+
+  int64_t GetWidth() const { return width_; }
+
+  void SetHeight(int64_t height) { height_ = height; }
+
+  int64_t GetHeight() const { return height_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableList uris;
+    for (const auto& uri : uris_) {
+      uris.push_back(flutter::EncodableValue(uri));
+    }
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("uris"), flutter::EncodableValue(uris)},
+        {flutter::EncodableValue("width"), flutter::EncodableValue(width_)},
+        {flutter::EncodableValue("height"), flutter::EncodableValue(height_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static CreateCompositorMessage FromMap(const flutter::EncodableValue& value) {
+    CreateCompositorMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& uris = map[flutter::EncodableValue("uris")];
+      if (std::holds_alternative<flutter::EncodableList>(uris)) {
+        std::vector<std::string> values;
+        for (const auto& uri : std::get<flutter::EncodableList>(uris)) {
+          if (std::holds_alternative<std::string>(uri)) {
+            values.push_back(std::get<std::string>(uri));
+          }
+        }
+        message.SetUris(values);
+      }
+
+      flutter::EncodableValue& width = map[flutter::EncodableValue("width")];
+      if (std::holds_alternative<int32_t>(width) ||
+          std::holds_alternative<int64_t>(width)) {
+        message.SetWidth(width.LongValue());
+      }
+
+      flutter::EncodableValue& height = map[flutter::EncodableValue("height")];
+      if (std::holds_alternative<int32_t>(height) ||
+          std::holds_alternative<int64_t>(height)) {
+        message.SetHeight(height.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  std::vector<std::string> uris_;
+  int64_t width_ = 0;
+  int64_t height_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CREATE_COMPOSITOR_MESSAGE_H_
@@ -37,6 +37,26 @@ class CreateMessage {
 
   std::string GetFormatHint() const { return format_hint_; }
 
+  void SetRtspTransport(const std::string& rtspTransport) {
+    rtsp_transport_ = rtspTransport;
+  }
+
+  std::string GetRtspTransport() const { return rtsp_transport_; }
+
+  void SetFastStart(bool fastStart) { fast_start_ = fastStart; }
+
+  bool GetFastStart() const { return fast_start_; }
+
+  void SetMuted(bool muted) { muted_ = muted; }
+
+  bool GetMuted() const { return muted_; }
+
+  void SetTimeshiftWindow(int64_t timeshiftWindow) {
+    timeshift_window_ = timeshiftWindow;
+  }
+
+  int64_t GetTimeshiftWindow() const { return timeshift_window_; }
+
   flutter::EncodableValue ToMap() {
     // todo: Add httpHeaders.
     flutter::EncodableMap map = {
@@ -45,7 +65,14 @@ class CreateMessage {
         {flutter::EncodableValue("packageName"),
          flutter::EncodableValue(package_name_)},
         {flutter::EncodableValue("formatHint"),
-         flutter::EncodableValue(format_hint_)}};
+         flutter::EncodableValue(format_hint_)},
+        {flutter::EncodableValue("rtspTransport"),
+         flutter::EncodableValue(rtsp_transport_)},
+        {flutter::EncodableValue("fastStart"),
+         flutter::EncodableValue(fast_start_)},
+        {flutter::EncodableValue("muted"), flutter::EncodableValue(muted_)},
+        {flutter::EncodableValue("timeshiftWindow"),
+         flutter::EncodableValue(timeshift_window_)}};
     return flutter::EncodableValue(map);
   }
 
@@ -75,6 +102,30 @@ class CreateMessage {
       if (std::holds_alternative<std::string>(formatHint)) {
         message.SetFormatHint(std::get<std::string>(formatHint));
       }
+
+      flutter::EncodableValue& rtspTransport =
+          map[flutter::EncodableValue("rtspTransport")];
+      if (std::holds_alternative<std::string>(rtspTransport)) {
+        message.SetRtspTransport(std::get<std::string>(rtspTransport));
+      }
+
+      flutter::EncodableValue& fastStart =
+          map[flutter::EncodableValue("fastStart")];
+      if (std::holds_alternative<bool>(fastStart)) {
+        message.SetFastStart(std::get<bool>(fastStart));
+      }
+
+      flutter::EncodableValue& muted = map[flutter::EncodableValue("muted")];
+      if (std::holds_alternative<bool>(muted)) {
+        message.SetMuted(std::get<bool>(muted));
+      }
+
+      flutter::EncodableValue& timeshiftWindow =
+          map[flutter::EncodableValue("timeshiftWindow")];
+      if (std::holds_alternative<int32_t>(timeshiftWindow) ||
+          std::holds_alternative<int64_t>(timeshiftWindow)) {
+        message.SetTimeshiftWindow(timeshiftWindow.LongValue());
+      }
     }
 
     return message;
@@ -85,6 +136,10 @@ class CreateMessage {
   std::string uri_;
   std::string package_name_;
   std::string format_hint_;
+  std::string rtsp_transport_;
+  bool fast_start_ = false;
+  bool muted_ = false;
+  int64_t timeshift_window_ = 0;
 };
 
 #endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CREATE_MESSAGE_H_
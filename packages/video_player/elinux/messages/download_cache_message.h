@@ -0,0 +1,101 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_DOWNLOAD_CACHE_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_DOWNLOAD_CACHE_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+
+class DownloadCacheMessage {
+ public:
+  DownloadCacheMessage() = default;
+  ~DownloadCacheMessage() = default;
+
+  // Prevent copying.
+  DownloadCacheMessage(DownloadCacheMessage const&) = default;
+  DownloadCacheMessage& operator=(DownloadCacheMessage const&) = default;
+
+  void SetDirectory(const std::string& directory) { directory_ = directory; }
+
+  std::string GetDirectory() const { return directory_; }
+
+  void SetMaxSizeBytes(int64_t max_size_bytes) {
+    max_size_bytes_ = max_size_bytes;
+  }
+
+  int64_t GetMaxSizeBytes() const { return max_size_bytes_; }
+
+  void SetBufferDurationMs(int64_t buffer_duration_ms) {
+    buffer_duration_ms_ = buffer_duration_ms;
+  }
+
+  int64_t GetBufferDurationMs() const { return buffer_duration_ms_; }
+
+  void SetBufferSizeBytes(int64_t buffer_size_bytes) {
+    buffer_size_bytes_ = buffer_size_bytes;
+  }
+
+  int64_t GetBufferSizeBytes() const { return buffer_size_bytes_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("directory"),
+         flutter::EncodableValue(directory_)},
+        {flutter::EncodableValue("maxSizeBytes"),
+         flutter::EncodableValue(max_size_bytes_)},
+        {flutter::EncodableValue("bufferDurationMs"),
+         flutter::EncodableValue(buffer_duration_ms_)},
+        {flutter::EncodableValue("bufferSizeBytes"),
+         flutter::EncodableValue(buffer_size_bytes_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static DownloadCacheMessage FromMap(const flutter::EncodableValue& value) {
+    DownloadCacheMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& directory =
+          map[flutter::EncodableValue("directory")];
+      if (std::holds_alternative<std::string>(directory)) {
+        message.SetDirectory(std::get<std::string>(directory));
+      }
+
+      flutter::EncodableValue& max_size_bytes =
+          map[flutter::EncodableValue("maxSizeBytes")];
+      if (std::holds_alternative<int32_t>(max_size_bytes) ||
+          std::holds_alternative<int64_t>(max_size_bytes)) {
+        message.SetMaxSizeBytes(max_size_bytes.LongValue());
+      }
+
+      flutter::EncodableValue& buffer_duration_ms =
+          map[flutter::EncodableValue("bufferDurationMs")];
+      if (std::holds_alternative<int32_t>(buffer_duration_ms) ||
+          std::holds_alternative<int64_t>(buffer_duration_ms)) {
+        message.SetBufferDurationMs(buffer_duration_ms.LongValue());
+      }
+
+      flutter::EncodableValue& buffer_size_bytes =
+          map[flutter::EncodableValue("bufferSizeBytes")];
+      if (std::holds_alternative<int32_t>(buffer_size_bytes) ||
+          std::holds_alternative<int64_t>(buffer_size_bytes)) {
+        message.SetBufferSizeBytes(buffer_size_bytes.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  // Empty means the default directory.
+  std::string directory_;
+  int64_t max_size_bytes_ = 0;
+  int64_t buffer_duration_ms_ = 0;
+  int64_t buffer_size_bytes_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_DOWNLOAD_CACHE_MESSAGE_H_
@@ -0,0 +1,103 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_EXTRACT_FRAMES_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_EXTRACT_FRAMES_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+#include <vector>
+
+struct FrameRequest {
+  std::string uri;
+  int64_t position_ms = 0;
+  int64_t max_width = 0;
+  // "rgba" or "png".
+  std::string format;
+};
+
+class ExtractFramesMessage {
+ public:
+  ExtractFramesMessage() = default;
+  ~ExtractFramesMessage() = default;
+
+  // Prevent copying.
+  ExtractFramesMessage(ExtractFramesMessage const&) = default;
+  ExtractFramesMessage& operator=(ExtractFramesMessage const&) = default;
+
+  void SetRequests(const std::vector<FrameRequest>& requests) {
+    requests_ = requests;
+  }
+
+  const std::vector<FrameRequest>& GetRequests() const { return requests_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableList requests;
+    for (const auto& request : requests_) {
+      requests.push_back(flutter::EncodableValue(flutter::EncodableMap{
+          {flutter::EncodableValue("uri"),
+           flutter::EncodableValue(request.uri)},
+          {flutter::EncodableValue("positionMs"),
+           flutter::EncodableValue(request.position_ms)},
+          {flutter::EncodableValue("maxWidth"),
+           flutter::EncodableValue(request.max_width)},
+          {flutter::EncodableValue("format"),
+           flutter::EncodableValue(request.format)}}));
+    }
+    flutter::EncodableMap map = {{flutter::EncodableValue("requests"),
+                                  flutter::EncodableValue(requests)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static ExtractFramesMessage FromMap(const flutter::EncodableValue& value) {
+    ExtractFramesMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& requests =
+          map[flutter::EncodableValue("requests")];
+      if (std::holds_alternative<flutter::EncodableList>(requests)) {
+        std::vector<FrameRequest> values;
+        for (const auto& request : std::get<flutter::EncodableList>(requests)) {
+          if (std::holds_alternative<flutter::EncodableMap>(request)) {
+            values.push_back(
+                RequestFromMap(std::get<flutter::EncodableMap>(request)));
+          }
+        }
+        message.SetRequests(values);
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  static FrameRequest RequestFromMap(flutter::EncodableMap map) {
+    FrameRequest request;
+    flutter::EncodableValue& uri = map[flutter::EncodableValue("uri")];
+    if (std::holds_alternative<std::string>(uri)) {
+      request.uri = std::get<std::string>(uri);
+    }
+    const auto get = [&map](const char* key, int64_t& value) {
+      flutter::EncodableValue& field = map[flutter::EncodableValue(key)];
+      if (std::holds_alternative<int32_t>(field) ||
+          std::holds_alternative<int64_t>(field)) {
+        value = field.LongValue();
+      }
+    };
+    get("positionMs", request.position_ms);
+    get("maxWidth", request.max_width);
+    flutter::EncodableValue& format = map[flutter::EncodableValue("format")];
+    if (std::holds_alternative<std::string>(format)) {
+      request.format = std::get<std::string>(format);
+    }
+    return request;
+  }
+
+  std::vector<FrameRequest> requests_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_EXTRACT_FRAMES_MESSAGE_H_
@@ -0,0 +1,66 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_EXTRACTED_FRAMES_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_EXTRACTED_FRAMES_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ExtractedFrame {
+  int64_t width = 0;
+  int64_t height = 0;
+  std::vector<uint8_t> data;
+  // Empty on success.
+  std::string error;
+};
+
+class ExtractedFramesMessage {
+ public:
+  ExtractedFramesMessage() = default;
+  ~ExtractedFramesMessage() = default;
+
+  // Prevent copying.
+  ExtractedFramesMessage(ExtractedFramesMessage const&) = default;
+  ExtractedFramesMessage& operator=(ExtractedFramesMessage const&) = default;
+
+  // In the order of the requests.
+  void SetFrames(std::vector<ExtractedFrame> frames) {
+    frames_ = std::move(frames);
+  }
+
+  const std::vector<ExtractedFrame>& GetFrames() const { return frames_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableList frames;
+    for (auto& frame : frames_) {
+      flutter::EncodableMap map = {
+          {flutter::EncodableValue("width"),
+           flutter::EncodableValue(frame.width)},
+          {flutter::EncodableValue("height"),
+           flutter::EncodableValue(frame.height)}};
+      if (frame.error.empty()) {
+        // Moved rather than copied, since a batch of frames may be large.
+        map.emplace(flutter::EncodableValue("data"),
+                    flutter::EncodableValue(std::move(frame.data)));
+      } else {
+        map.emplace(flutter::EncodableValue("error"),
+                    flutter::EncodableValue(frame.error));
+      }
+      frames.push_back(flutter::EncodableValue(map));
+    }
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("frames"), flutter::EncodableValue(frames)}};
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  std::vector<ExtractedFrame> frames_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_EXTRACTED_FRAMES_MESSAGE_H_
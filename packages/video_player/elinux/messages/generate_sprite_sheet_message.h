@@ -0,0 +1,93 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_GENERATE_SPRITE_SHEET_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_GENERATE_SPRITE_SHEET_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+
+class GenerateSpriteSheetMessage {
+ public:
+  GenerateSpriteSheetMessage() = default;
+  ~GenerateSpriteSheetMessage() = default;
+
+  // Prevent copying.
+  GenerateSpriteSheetMessage(GenerateSpriteSheetMessage const&) = default;
+  GenerateSpriteSheetMessage& operator=(GenerateSpriteSheetMessage const&) =
+      default;
+
+  void SetUri(const std::string& uri) { uri_ = uri; }
+
+  std::string GetUri() const { return uri_; }
+
+  void SetIntervalMs(int64_t interval_ms) { interval_ms_ = interval_ms; }
+
+  int64_t GetIntervalMs() const { return interval_ms_; }
+
+  void SetTileWidth(int64_t tile_width) { tile_width_ = tile_width; }
+
+  int64_t GetTileWidth() const { return tile_width_; }
+
+  void SetColumns(int64_t columns) { columns_ = columns; }
+
+  int64_t GetColumns() const { return columns_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("uri"), flutter::EncodableValue(uri_)},
+        {flutter::EncodableValue("intervalMs"),
+         flutter::EncodableValue(interval_ms_)},
+        {flutter::EncodableValue("tileWidth"),
+         flutter::EncodableValue(tile_width_)},
+        {flutter::EncodableValue("columns"),
+         flutter::EncodableValue(columns_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static GenerateSpriteSheetMessage FromMap(
+      const flutter::EncodableValue& value) {
+    GenerateSpriteSheetMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& uri = map[flutter::EncodableValue("uri")];
+      if (std::holds_alternative<std::string>(uri)) {
+        message.SetUri(std::get<std::string>(uri));
+      }
+
+      flutter::EncodableValue& interval_ms =
+          map[flutter::EncodableValue("intervalMs")];
+      if (std::holds_alternative<int32_t>(interval_ms) ||
+          std::holds_alternative<int64_t>(interval_ms)) {
+        message.SetIntervalMs(interval_ms.LongValue());
+      }
+
+      flutter::EncodableValue& tile_width =
+          map[flutter::EncodableValue("tileWidth")];
+      if (std::holds_alternative<int32_t>(tile_width) ||
+          std::holds_alternative<int64_t>(tile_width)) {
+        message.SetTileWidth(tile_width.LongValue());
+      }
+
+      flutter::EncodableValue& columns = map[flutter::EncodableValue("columns")];
+      if (std::holds_alternative<int32_t>(columns) ||
+          std::holds_alternative<int64_t>(columns)) {
+        message.SetColumns(columns.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  std::string uri_;
+  int64_t interval_ms_ = 0;
+  int64_t tile_width_ = 0;
+  int64_t columns_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_GENERATE_SPRITE_SHEET_MESSAGE_H_
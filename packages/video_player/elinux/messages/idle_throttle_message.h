@@ -0,0 +1,51 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_IDLE_THROTTLE_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_IDLE_THROTTLE_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class IdleThrottleMessage {
+ public:
+  IdleThrottleMessage() = default;
+  ~IdleThrottleMessage() = default;
+
+  // Prevent copying.
+  IdleThrottleMessage(IdleThrottleMessage const&) = default;
+  IdleThrottleMessage& operator=(IdleThrottleMessage const&) = default;
+
+  void SetIdleFrames(int64_t idle_frames) { idle_frames_ = idle_frames; }
+
+  int64_t GetIdleFrames() const { return idle_frames_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("idleFrames"),
+         flutter::EncodableValue(idle_frames_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static IdleThrottleMessage FromMap(const flutter::EncodableValue& value) {
+    IdleThrottleMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& idle_frames =
+          map[flutter::EncodableValue("idleFrames")];
+      if (std::holds_alternative<int32_t>(idle_frames) ||
+          std::holds_alternative<int64_t>(idle_frames)) {
+        message.SetIdleFrames(idle_frames.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t idle_frames_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_IDLE_THROTTLE_MESSAGE_H_
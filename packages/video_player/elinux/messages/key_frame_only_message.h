@@ -0,0 +1,65 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_KEY_FRAME_ONLY_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_KEY_FRAME_ONLY_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class KeyFrameOnlyMessage {
+ public:
+  KeyFrameOnlyMessage() = default;
+  ~KeyFrameOnlyMessage() = default;
+
+  // Prevent copying.
+  KeyFrameOnlyMessage(KeyFrameOnlyMessage const&) = default;
+  KeyFrameOnlyMessage& operator=(KeyFrameOnlyMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetKeyFrameOnly(bool key_frame_only) {
+    key_frame_only_ = key_frame_only;
+  }
+
+  bool GetKeyFrameOnly() const { return key_frame_only_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {{flutter::EncodableValue("textureId"),
+                                  flutter::EncodableValue(texture_id_)},
+                                 {flutter::EncodableValue("keyFrameOnly"),
+                                  flutter::EncodableValue(key_frame_only_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static KeyFrameOnlyMessage FromMap(const flutter::EncodableValue& value) {
+    KeyFrameOnlyMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& key_frame_only =
+          map[flutter::EncodableValue("keyFrameOnly")];
+      if (std::holds_alternative<bool>(key_frame_only)) {
+        message.SetKeyFrameOnly(std::get<bool>(key_frame_only));
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  bool key_frame_only_ = false;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_KEY_FRAME_ONLY_MESSAGE_H_
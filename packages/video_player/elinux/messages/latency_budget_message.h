@@ -0,0 +1,67 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_LATENCY_BUDGET_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_LATENCY_BUDGET_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class LatencyBudgetMessage {
+ public:
+  LatencyBudgetMessage() = default;
+  ~LatencyBudgetMessage() = default;
+
+  // Prevent copying.
+  LatencyBudgetMessage(LatencyBudgetMessage const&) = default;
+  LatencyBudgetMessage& operator=(LatencyBudgetMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetLatencyBudget(int64_t latency_budget) {
+    latency_budget_ = latency_budget;
+  }
+
+  int64_t GetLatencyBudget() const { return latency_budget_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("textureId"),
+         flutter::EncodableValue(texture_id_)},
+        {flutter::EncodableValue("latencyBudget"),
+         flutter::EncodableValue(latency_budget_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static LatencyBudgetMessage FromMap(const flutter::EncodableValue& value) {
+    LatencyBudgetMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& latency_budget =
+          map[flutter::EncodableValue("latencyBudget")];
+      if (std::holds_alternative<int32_t>(latency_budget) ||
+          std::holds_alternative<int64_t>(latency_budget)) {
+        message.SetLatencyBudget(latency_budget.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  int64_t latency_budget_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_LATENCY_BUDGET_MESSAGE_H_
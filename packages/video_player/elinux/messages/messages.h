@@ -5,12 +5,39 @@
 #ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MESSAGES_H_
 #define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MESSAGES_H_
 
+#include "abr_policy_message.h"
+#include "capabilities_message.h"
+#include "capture_frame_message.h"
+#include "captured_frame_message.h"
+#include "compositor_layout_message.h"
+#include "create_compositor_message.h"
 #include "create_message.h"
+#include "download_cache_message.h"
+#include "extract_frames_message.h"
+#include "extracted_frames_message.h"
+#include "generate_sprite_sheet_message.h"
+#include "idle_throttle_message.h"
+#include "key_frame_only_message.h"
+#include "latency_budget_message.h"
 #include "looping_message.h"
 #include "mix_with_others_message.h"
+#include "multi_stream_mode_message.h"
 #include "playback_speed_message.h"
+#include "player_pool_size_message.h"
 #include "position_message.h"
+#include "position_tick_message.h"
+#include "positions_message.h"
+#include "preroll_timeout_message.h"
+#include "qos_message.h"
+#include "scrubbing_message.h"
+#include "sprite_sheet_message.h"
+#include "stats_message.h"
+#include "subtitles_message.h"
 #include "texture_message.h"
+#include "thread_policy_message.h"
+#include "timeshift_message.h"
+#include "track_selection_message.h"
+#include "transport_stats_message.h"
 #include "volume_message.h"
 
 #endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MESSAGES_H_
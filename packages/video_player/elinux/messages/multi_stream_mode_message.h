@@ -0,0 +1,65 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MULTI_STREAM_MODE_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MULTI_STREAM_MODE_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class MultiStreamModeMessage {
+ public:
+  MultiStreamModeMessage() = default;
+  ~MultiStreamModeMessage() = default;
+
+  // Prevent copying.
+  MultiStreamModeMessage(MultiStreamModeMessage const&) = default;
+  MultiStreamModeMessage& operator=(MultiStreamModeMessage const&) = default;
+
+  void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+  bool GetEnabled() const { return enabled_; }
+
+  void SetMaxDecoderThreads(int64_t max_decoder_threads) {
+    max_decoder_threads_ = max_decoder_threads;
+  }
+
+  int64_t GetMaxDecoderThreads() const { return max_decoder_threads_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("enabled"), flutter::EncodableValue(enabled_)},
+        {flutter::EncodableValue("maxDecoderThreads"),
+         flutter::EncodableValue(max_decoder_threads_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static MultiStreamModeMessage FromMap(const flutter::EncodableValue& value) {
+    MultiStreamModeMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& enabled =
+          map[flutter::EncodableValue("enabled")];
+      if (std::holds_alternative<bool>(enabled)) {
+        message.SetEnabled(std::get<bool>(enabled));
+      }
+
+      flutter::EncodableValue& max_decoder_threads =
+          map[flutter::EncodableValue("maxDecoderThreads")];
+      if (std::holds_alternative<int32_t>(max_decoder_threads) ||
+          std::holds_alternative<int64_t>(max_decoder_threads)) {
+        message.SetMaxDecoderThreads(max_decoder_threads.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  bool enabled_ = false;
+  int64_t max_decoder_threads_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MULTI_STREAM_MODE_MESSAGE_H_
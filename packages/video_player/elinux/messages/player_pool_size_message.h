@@ -0,0 +1,49 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PLAYER_POOL_SIZE_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PLAYER_POOL_SIZE_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class PlayerPoolSizeMessage {
+ public:
+  PlayerPoolSizeMessage() = default;
+  ~PlayerPoolSizeMessage() = default;
+
+  // Prevent copying.
+  PlayerPoolSizeMessage(PlayerPoolSizeMessage const&) = default;
+  PlayerPoolSizeMessage& operator=(PlayerPoolSizeMessage const&) = default;
+
+  void SetSize(int64_t size) { size_ = size; }
+
+  int64_t GetSize() const { return size_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("size"), flutter::EncodableValue(size_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static PlayerPoolSizeMessage FromMap(const flutter::EncodableValue& value) {
+    PlayerPoolSizeMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& size = map[flutter::EncodableValue("size")];
+      if (std::holds_alternative<int32_t>(size) ||
+          std::holds_alternative<int64_t>(size)) {
+        message.SetSize(size.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t size_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PLAYER_POOL_SIZE_MESSAGE_H_
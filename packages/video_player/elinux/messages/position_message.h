@@ -25,11 +25,17 @@ class PositionMessage {
 
   int64_t GetPosition() const { return position_; }
 
+  void SetSeekMode(const std::string& seek_mode) { seek_mode_ = seek_mode; }
+
+  std::string GetSeekMode() const { return seek_mode_; }
+
   flutter::EncodableValue ToMap() {
     flutter::EncodableMap toMapResult = {{flutter::EncodableValue("textureId"),
                                           flutter::EncodableValue(texture_id_)},
                                          {flutter::EncodableValue("position"),
-                                          flutter::EncodableValue(position_)}};
+                                          flutter::EncodableValue(position_)},
+                                         {flutter::EncodableValue("seekMode"),
+                                          flutter::EncodableValue(seek_mode_)}};
 
     return flutter::EncodableValue(toMapResult);
   }
@@ -52,6 +58,12 @@ class PositionMessage {
           std::holds_alternative<int64_t>(position)) {
         message.SetPosition(position.LongValue());
       }
+
+      flutter::EncodableValue& seek_mode =
+          map[flutter::EncodableValue("seekMode")];
+      if (std::holds_alternative<std::string>(seek_mode)) {
+        message.SetSeekMode(std::get<std::string>(seek_mode));
+      }
     }
 
     return message;
@@ -60,6 +72,7 @@ class PositionMessage {
  private:
   int64_t texture_id_ = 0;
   int64_t position_ = 0;
+  std::string seek_mode_;
 };
 
 #endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_POSITION_MESSAGE_H_
@@ -0,0 +1,65 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_POSITION_TICK_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_POSITION_TICK_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class PositionTickMessage {
+ public:
+  PositionTickMessage() = default;
+  ~PositionTickMessage() = default;
+
+  // Prevent copying.
+  PositionTickMessage(PositionTickMessage const&) = default;
+  PositionTickMessage& operator=(PositionTickMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetIntervalMs(int64_t interval_ms) { interval_ms_ = interval_ms; }
+
+  int64_t GetIntervalMs() const { return interval_ms_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("textureId"),
+         flutter::EncodableValue(texture_id_)},
+        {flutter::EncodableValue("intervalMs"),
+         flutter::EncodableValue(interval_ms_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static PositionTickMessage FromMap(const flutter::EncodableValue& value) {
+    PositionTickMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& interval_ms =
+          map[flutter::EncodableValue("intervalMs")];
+      if (std::holds_alternative<int32_t>(interval_ms) ||
+          std::holds_alternative<int64_t>(interval_ms)) {
+        message.SetIntervalMs(interval_ms.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  int64_t interval_ms_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_POSITION_TICK_MESSAGE_H_
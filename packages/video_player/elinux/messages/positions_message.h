@@ -0,0 +1,61 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_POSITIONS_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_POSITIONS_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <vector>
+
+// In milliseconds, -1 if unknown.
+struct PlayerPosition {
+  int64_t texture_id = 0;
+  int64_t position = -1;
+  int64_t duration = -1;
+  bool is_buffering = false;
+};
+
+class PositionsMessage {
+ public:
+  PositionsMessage() = default;
+  ~PositionsMessage() = default;
+
+  // Prevent copying.
+  PositionsMessage(PositionsMessage const&) = default;
+  PositionsMessage& operator=(PositionsMessage const&) = default;
+
+  void AddPosition(const PlayerPosition& position) {
+    positions_.push_back(position);
+  }
+
+  const std::vector<PlayerPosition>& GetPositions() const {
+    return positions_;
+  }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableList positions;
+    positions.reserve(positions_.size());
+    for (const auto& position : positions_) {
+      positions.push_back(flutter::EncodableValue(flutter::EncodableMap{
+          {flutter::EncodableValue("textureId"),
+           flutter::EncodableValue(position.texture_id)},
+          {flutter::EncodableValue("position"),
+           flutter::EncodableValue(position.position)},
+          {flutter::EncodableValue("duration"),
+           flutter::EncodableValue(position.duration)},
+          {flutter::EncodableValue("isBuffering"),
+           flutter::EncodableValue(position.is_buffering)}}));
+    }
+    flutter::EncodableMap map = {{flutter::EncodableValue("positions"),
+                                  flutter::EncodableValue(positions)}};
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  std::vector<PlayerPosition> positions_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_POSITIONS_MESSAGE_H_
@@ -0,0 +1,49 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PREROLL_TIMEOUT_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PREROLL_TIMEOUT_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class PrerollTimeoutMessage {
+ public:
+  PrerollTimeoutMessage() = default;
+  ~PrerollTimeoutMessage() = default;
+
+  // Prevent copying.
+  PrerollTimeoutMessage(PrerollTimeoutMessage const&) = default;
+  PrerollTimeoutMessage& operator=(PrerollTimeoutMessage const&) = default;
+
+  void SetTimeout(int64_t timeout) { timeout_ = timeout; }
+
+  int64_t GetTimeout() const { return timeout_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("timeout"), flutter::EncodableValue(timeout_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static PrerollTimeoutMessage FromMap(const flutter::EncodableValue& value) {
+    PrerollTimeoutMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& timeout = map[flutter::EncodableValue("timeout")];
+      if (std::holds_alternative<int32_t>(timeout) ||
+          std::holds_alternative<int64_t>(timeout)) {
+        message.SetTimeout(timeout.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t timeout_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PREROLL_TIMEOUT_MESSAGE_H_
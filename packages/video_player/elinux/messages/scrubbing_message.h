@@ -0,0 +1,63 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_SCRUBBING_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_SCRUBBING_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class ScrubbingMessage {
+ public:
+  ScrubbingMessage() = default;
+  ~ScrubbingMessage() = default;
+
+  // Prevent copying.
+  ScrubbingMessage(ScrubbingMessage const&) = default;
+  ScrubbingMessage& operator=(ScrubbingMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetIsScrubbing(bool is_scrubbing) { is_scrubbing_ = is_scrubbing; }
+
+  bool GetIsScrubbing() const { return is_scrubbing_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {{flutter::EncodableValue("textureId"),
+                                  flutter::EncodableValue(texture_id_)},
+                                 {flutter::EncodableValue("isScrubbing"),
+                                  flutter::EncodableValue(is_scrubbing_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static ScrubbingMessage FromMap(const flutter::EncodableValue& value) {
+    ScrubbingMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& is_scrubbing =
+          map[flutter::EncodableValue("isScrubbing")];
+      if (std::holds_alternative<bool>(is_scrubbing)) {
+        message.SetIsScrubbing(std::get<bool>(is_scrubbing));
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  bool is_scrubbing_ = false;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_SCRUBBING_MESSAGE_H_
@@ -0,0 +1,69 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_SPRITE_SHEET_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_SPRITE_SHEET_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+
+class SpriteSheetMessage {
+ public:
+  SpriteSheetMessage() = default;
+  ~SpriteSheetMessage() = default;
+
+  // Prevent copying.
+  SpriteSheetMessage(SpriteSheetMessage const&) = default;
+  SpriteSheetMessage& operator=(SpriteSheetMessage const&) = default;
+
+  void SetPath(const std::string& path) { path_ = path; }
+
+  const std::string& GetPath() const { return path_; }
+
+  void SetIntervalMs(int64_t interval_ms) { interval_ms_ = interval_ms; }
+
+  int64_t GetIntervalMs() const { return interval_ms_; }
+
+  void SetTileWidth(int64_t tile_width) { tile_width_ = tile_width; }
+
+  int64_t GetTileWidth() const { return tile_width_; }
+
+  void SetTileHeight(int64_t tile_height) { tile_height_ = tile_height; }
+
+  int64_t GetTileHeight() const { return tile_height_; }
+
+  void SetColumns(int64_t columns) { columns_ = columns; }
+
+  int64_t GetColumns() const { return columns_; }
+
+  void SetCount(int64_t count) { count_ = count; }
+
+  int64_t GetCount() const { return count_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("path"), flutter::EncodableValue(path_)},
+        {flutter::EncodableValue("intervalMs"),
+         flutter::EncodableValue(interval_ms_)},
+        {flutter::EncodableValue("tileWidth"),
+         flutter::EncodableValue(tile_width_)},
+        {flutter::EncodableValue("tileHeight"),
+         flutter::EncodableValue(tile_height_)},
+        {flutter::EncodableValue("columns"), flutter::EncodableValue(columns_)},
+        {flutter::EncodableValue("count"), flutter::EncodableValue(count_)}};
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  std::string path_;
+  int64_t interval_ms_ = 0;
+  int64_t tile_width_ = 0;
+  int64_t tile_height_ = 0;
+  int64_t columns_ = 0;
+  int64_t count_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_SPRITE_SHEET_MESSAGE_H_
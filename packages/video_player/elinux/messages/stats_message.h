@@ -0,0 +1,138 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_STATS_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_STATS_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+// In microseconds.
+struct LatencyPercentiles {
+  int64_t p50 = 0;
+  int64_t p95 = 0;
+  int64_t p99 = 0;
+  // The number of frames the percentiles are computed from.
+  int64_t count = 0;
+};
+
+class StatsMessage {
+ public:
+  StatsMessage() = default;
+  ~StatsMessage() = default;
+
+  // Prevent copying.
+  StatsMessage(StatsMessage const&) = default;
+  StatsMessage& operator=(StatsMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetCaptureToDecode(const LatencyPercentiles& latency) {
+    capture_to_decode_ = latency;
+  }
+
+  const LatencyPercentiles& GetCaptureToDecode() const {
+    return capture_to_decode_;
+  }
+
+  void SetDecodeToHandoff(const LatencyPercentiles& latency) {
+    decode_to_handoff_ = latency;
+  }
+
+  const LatencyPercentiles& GetDecodeToHandoff() const {
+    return decode_to_handoff_;
+  }
+
+  void SetHandoffToTexture(const LatencyPercentiles& latency) {
+    handoff_to_texture_ = latency;
+  }
+
+  const LatencyPercentiles& GetHandoffToTexture() const {
+    return handoff_to_texture_;
+  }
+
+  void SetDecodeToTexture(const LatencyPercentiles& latency) {
+    decode_to_texture_ = latency;
+  }
+
+  const LatencyPercentiles& GetDecodeToTexture() const {
+    return decode_to_texture_;
+  }
+
+  void SetGlassToGlass(const LatencyPercentiles& latency) {
+    glass_to_glass_ = latency;
+  }
+
+  const LatencyPercentiles& GetGlassToGlass() const { return glass_to_glass_; }
+
+  void SetAvDrift(const LatencyPercentiles& drift) { av_drift_ = drift; }
+
+  const LatencyPercentiles& GetAvDrift() const { return av_drift_; }
+
+  void SetDroppedFrames(int64_t dropped_frames) {
+    dropped_frames_ = dropped_frames;
+  }
+
+  int64_t GetDroppedFrames() const { return dropped_frames_; }
+
+  void SetLateFrames(int64_t late_frames) { late_frames_ = late_frames; }
+
+  int64_t GetLateFrames() const { return late_frames_; }
+
+  void SetQosDroppedFrames(int64_t qos_dropped_frames) {
+    qos_dropped_frames_ = qos_dropped_frames;
+  }
+
+  int64_t GetQosDroppedFrames() const { return qos_dropped_frames_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("textureId"),
+         flutter::EncodableValue(texture_id_)},
+        {flutter::EncodableValue("captureToDecode"),
+         PercentilesToMap(capture_to_decode_)},
+        {flutter::EncodableValue("decodeToHandoff"),
+         PercentilesToMap(decode_to_handoff_)},
+        {flutter::EncodableValue("handoffToTexture"),
+         PercentilesToMap(handoff_to_texture_)},
+        {flutter::EncodableValue("decodeToTexture"),
+         PercentilesToMap(decode_to_texture_)},
+        {flutter::EncodableValue("glassToGlass"),
+         PercentilesToMap(glass_to_glass_)},
+        {flutter::EncodableValue("droppedFrames"),
+         flutter::EncodableValue(dropped_frames_)},
+        {flutter::EncodableValue("avDrift"), PercentilesToMap(av_drift_)},
+        {flutter::EncodableValue("lateFrames"),
+         flutter::EncodableValue(late_frames_)},
+        {flutter::EncodableValue("qosDroppedFrames"),
+         flutter::EncodableValue(qos_dropped_frames_)}};
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  static flutter::EncodableValue PercentilesToMap(
+      const LatencyPercentiles& latency) {
+    return flutter::EncodableValue(flutter::EncodableMap{
+        {flutter::EncodableValue("p50"), flutter::EncodableValue(latency.p50)},
+        {flutter::EncodableValue("p95"), flutter::EncodableValue(latency.p95)},
+        {flutter::EncodableValue("p99"), flutter::EncodableValue(latency.p99)},
+        {flutter::EncodableValue("count"),
+         flutter::EncodableValue(latency.count)}});
+  }
+
+  int64_t texture_id_ = 0;
+  LatencyPercentiles capture_to_decode_;
+  LatencyPercentiles decode_to_handoff_;
+  LatencyPercentiles handoff_to_texture_;
+  LatencyPercentiles decode_to_texture_;
+  LatencyPercentiles glass_to_glass_;
+  LatencyPercentiles av_drift_;
+  int64_t dropped_frames_ = 0;
+  int64_t late_frames_ = 0;
+  int64_t qos_dropped_frames_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_STATS_MESSAGE_H_
@@ -0,0 +1,62 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_SUBTITLES_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_SUBTITLES_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class SubtitlesMessage {
+ public:
+  SubtitlesMessage() = default;
+  ~SubtitlesMessage() = default;
+
+  // Prevent copying.
+  SubtitlesMessage(SubtitlesMessage const&) = default;
+  SubtitlesMessage& operator=(SubtitlesMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+  bool GetEnabled() const { return enabled_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {{flutter::EncodableValue("textureId"),
+                                  flutter::EncodableValue(texture_id_)},
+                                 {flutter::EncodableValue("enabled"),
+                                  flutter::EncodableValue(enabled_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static SubtitlesMessage FromMap(const flutter::EncodableValue& value) {
+    SubtitlesMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& enabled = map[flutter::EncodableValue("enabled")];
+      if (std::holds_alternative<bool>(enabled)) {
+        message.SetEnabled(std::get<bool>(enabled));
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  bool enabled_ = false;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_SUBTITLES_MESSAGE_H_
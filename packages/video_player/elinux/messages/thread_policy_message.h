@@ -0,0 +1,101 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_THREAD_POLICY_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_THREAD_POLICY_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+#include <vector>
+
+class ThreadPolicyMessage {
+ public:
+  ThreadPolicyMessage() = default;
+  ~ThreadPolicyMessage() = default;
+
+  // Prevent copying.
+  ThreadPolicyMessage(ThreadPolicyMessage const&) = default;
+  ThreadPolicyMessage& operator=(ThreadPolicyMessage const&) = default;
+
+  void SetRole(const std::string& role) { role_ = role; }
+
+  std::string GetRole() const { return role_; }
+
+  void SetCpus(const std::vector<int64_t>& cpus) { cpus_ = cpus; }
+
+  std::vector<int64_t> GetCpus() const { return cpus_; }
+
+  void SetRealtimePriority(int64_t realtime_priority) {
+    realtime_priority_ = realtime_priority;
+  }
+
+  int64_t GetRealtimePriority() const { return realtime_priority_; }
+
+  void SetNice(int64_t nice) { nice_ = nice; }
+
+  int64_t GetNice() const { return nice_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableList cpus;
+    for (const auto cpu : cpus_) {
+      cpus.push_back(flutter::EncodableValue(cpu));
+    }
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("role"), flutter::EncodableValue(role_)},
+        {flutter::EncodableValue("cpus"), flutter::EncodableValue(cpus)},
+        {flutter::EncodableValue("realtimePriority"),
+         flutter::EncodableValue(realtime_priority_)},
+        {flutter::EncodableValue("nice"), flutter::EncodableValue(nice_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static ThreadPolicyMessage FromMap(const flutter::EncodableValue& value) {
+    ThreadPolicyMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& role = map[flutter::EncodableValue("role")];
+      if (std::holds_alternative<std::string>(role)) {
+        message.SetRole(std::get<std::string>(role));
+      }
+
+      flutter::EncodableValue& cpus = map[flutter::EncodableValue("cpus")];
+      if (std::holds_alternative<flutter::EncodableList>(cpus)) {
+        std::vector<int64_t> values;
+        for (const auto& cpu : std::get<flutter::EncodableList>(cpus)) {
+          if (std::holds_alternative<int32_t>(cpu) ||
+              std::holds_alternative<int64_t>(cpu)) {
+            values.push_back(cpu.LongValue());
+          }
+        }
+        message.SetCpus(values);
+      }
+
+      flutter::EncodableValue& realtime_priority =
+          map[flutter::EncodableValue("realtimePriority")];
+      if (std::holds_alternative<int32_t>(realtime_priority) ||
+          std::holds_alternative<int64_t>(realtime_priority)) {
+        message.SetRealtimePriority(realtime_priority.LongValue());
+      }
+
+      flutter::EncodableValue& nice = map[flutter::EncodableValue("nice")];
+      if (std::holds_alternative<int32_t>(nice) ||
+          std::holds_alternative<int64_t>(nice)) {
+        message.SetNice(nice.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  std::string role_;
+  std::vector<int64_t> cpus_;
+  int64_t realtime_priority_ = 0;
+  int64_t nice_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_THREAD_POLICY_MESSAGE_H_
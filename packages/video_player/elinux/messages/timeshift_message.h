@@ -0,0 +1,77 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TIMESHIFT_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TIMESHIFT_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class TimeshiftMessage {
+ public:
+  TimeshiftMessage() = default;
+  ~TimeshiftMessage() = default;
+
+  // Prevent copying.
+  TimeshiftMessage(TimeshiftMessage const&) = default;
+  TimeshiftMessage& operator=(TimeshiftMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetDelay(int64_t delay) { delay_ = delay; }
+
+  int64_t GetDelay() const { return delay_; }
+
+  void SetAvailable(int64_t available) { available_ = available; }
+
+  int64_t GetAvailable() const { return available_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("textureId"),
+         flutter::EncodableValue(texture_id_)},
+        {flutter::EncodableValue("delay"), flutter::EncodableValue(delay_)},
+        {flutter::EncodableValue("available"),
+         flutter::EncodableValue(available_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static TimeshiftMessage FromMap(const flutter::EncodableValue& value) {
+    TimeshiftMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& delay = map[flutter::EncodableValue("delay")];
+      if (std::holds_alternative<int32_t>(delay) ||
+          std::holds_alternative<int64_t>(delay)) {
+        message.SetDelay(delay.LongValue());
+      }
+
+      flutter::EncodableValue& available =
+          map[flutter::EncodableValue("available")];
+      if (std::holds_alternative<int32_t>(available) ||
+          std::holds_alternative<int64_t>(available)) {
+        message.SetAvailable(available.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  int64_t delay_ = 0;
+  int64_t available_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TIMESHIFT_MESSAGE_H_
@@ -0,0 +1,76 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TRACK_SELECTION_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TRACK_SELECTION_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class TrackSelectionMessage {
+ public:
+  TrackSelectionMessage() = default;
+  ~TrackSelectionMessage() = default;
+
+  // Prevent copying.
+  TrackSelectionMessage(TrackSelectionMessage const&) = default;
+  TrackSelectionMessage& operator=(TrackSelectionMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetAudio(bool audio) { audio_ = audio; }
+
+  bool GetAudio() const { return audio_; }
+
+  void SetAudioTrack(int64_t audio_track) { audio_track_ = audio_track; }
+
+  int64_t GetAudioTrack() const { return audio_track_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {{flutter::EncodableValue("textureId"),
+                                  flutter::EncodableValue(texture_id_)},
+                                 {flutter::EncodableValue("audio"),
+                                  flutter::EncodableValue(audio_)},
+                                 {flutter::EncodableValue("audioTrack"),
+                                  flutter::EncodableValue(audio_track_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static TrackSelectionMessage FromMap(const flutter::EncodableValue& value) {
+    TrackSelectionMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& audio = map[flutter::EncodableValue("audio")];
+      if (std::holds_alternative<bool>(audio)) {
+        message.SetAudio(std::get<bool>(audio));
+      }
+
+      flutter::EncodableValue& audio_track =
+          map[flutter::EncodableValue("audioTrack")];
+      if (std::holds_alternative<int32_t>(audio_track) ||
+          std::holds_alternative<int64_t>(audio_track)) {
+        message.SetAudioTrack(audio_track.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  bool audio_ = true;
+  int64_t audio_track_ = -1;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TRACK_SELECTION_MESSAGE_H_
@@ -0,0 +1,109 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TRANSPORT_STATS_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TRANSPORT_STATS_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+
+class TransportStatsMessage {
+ public:
+  TransportStatsMessage() = default;
+  ~TransportStatsMessage() = default;
+
+  // Prevent copying.
+  TransportStatsMessage(TransportStatsMessage const&) = default;
+  TransportStatsMessage& operator=(TransportStatsMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetTransport(const std::string& transport) { transport_ = transport; }
+
+  std::string GetTransport() const { return transport_; }
+
+  void SetPacketsReceived(int64_t packets_received) {
+    packets_received_ = packets_received;
+  }
+
+  int64_t GetPacketsReceived() const { return packets_received_; }
+
+  void SetPacketsLost(int64_t packets_lost) { packets_lost_ = packets_lost; }
+
+  int64_t GetPacketsLost() const { return packets_lost_; }
+
+  void SetPacketsLate(int64_t packets_late) { packets_late_ = packets_late; }
+
+  int64_t GetPacketsLate() const { return packets_late_; }
+
+  void SetPacketsDuplicated(int64_t packets_duplicated) {
+    packets_duplicated_ = packets_duplicated;
+  }
+
+  int64_t GetPacketsDuplicated() const { return packets_duplicated_; }
+
+  // In microseconds.
+  void SetJitter(int64_t jitter) { jitter_ = jitter; }
+
+  int64_t GetJitter() const { return jitter_; }
+
+  void SetReconnectAttempts(int64_t reconnect_attempts) {
+    reconnect_attempts_ = reconnect_attempts;
+  }
+
+  int64_t GetReconnectAttempts() const { return reconnect_attempts_; }
+
+  void SetReconnects(int64_t reconnects) { reconnects_ = reconnects; }
+
+  int64_t GetReconnects() const { return reconnects_; }
+
+  // In milliseconds.
+  void SetLastReconnectLatency(int64_t last_reconnect_latency) {
+    last_reconnect_latency_ = last_reconnect_latency;
+  }
+
+  int64_t GetLastReconnectLatency() const { return last_reconnect_latency_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("textureId"),
+         flutter::EncodableValue(texture_id_)},
+        {flutter::EncodableValue("transport"),
+         flutter::EncodableValue(transport_)},
+        {flutter::EncodableValue("packetsReceived"),
+         flutter::EncodableValue(packets_received_)},
+        {flutter::EncodableValue("packetsLost"),
+         flutter::EncodableValue(packets_lost_)},
+        {flutter::EncodableValue("packetsLate"),
+         flutter::EncodableValue(packets_late_)},
+        {flutter::EncodableValue("packetsDuplicated"),
+         flutter::EncodableValue(packets_duplicated_)},
+        {flutter::EncodableValue("jitter"), flutter::EncodableValue(jitter_)},
+        {flutter::EncodableValue("reconnectAttempts"),
+         flutter::EncodableValue(reconnect_attempts_)},
+        {flutter::EncodableValue("reconnects"),
+         flutter::EncodableValue(reconnects_)},
+        {flutter::EncodableValue("lastReconnectLatency"),
+         flutter::EncodableValue(last_reconnect_latency_)}};
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  std::string transport_;
+  int64_t packets_received_ = 0;
+  int64_t packets_lost_ = 0;
+  int64_t packets_late_ = 0;
+  int64_t packets_duplicated_ = 0;
+  int64_t jitter_ = 0;
+  int64_t reconnect_attempts_ = 0;
+  int64_t reconnects_ = 0;
+  int64_t last_reconnect_latency_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TRANSPORT_STATS_MESSAGE_H_
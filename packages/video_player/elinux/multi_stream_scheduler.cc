@@ -0,0 +1,73 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "multi_stream_scheduler.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+MultiStreamScheduler::MultiStreamScheduler() {
+  task_pool_ = gst_task_pool_new();
+  GError* error = nullptr;
+  gst_task_pool_prepare(task_pool_, &error);
+  if (error) {
+    std::cerr << "Failed to prepare the shared task pool: " << error->message
+              << std::endl;
+    g_error_free(error);
+    gst_object_unref(task_pool_);
+    task_pool_ = nullptr;
+  }
+}
+
+MultiStreamScheduler::~MultiStreamScheduler() {
+  // The players hold a reference to the pool, so they must be gone before
+  // the pool threads are joined.
+  for (auto* player : players_) {
+    player->SetTaskPool(nullptr);
+  }
+  players_.clear();
+
+  if (task_pool_) {
+    gst_task_pool_cleanup(task_pool_);
+    gst_object_unref(task_pool_);
+  }
+}
+
+void MultiStreamScheduler::SetMaxDecoderThreads(int max_decoder_threads) {
+  max_decoder_threads_ = max_decoder_threads;
+  Rebalance();
+}
+
+void MultiStreamScheduler::Attach(GstVideoPlayer* player) {
+  if (!players_.insert(player).second) {
+    return;
+  }
+  player->SetTaskPool(task_pool_);
+  Rebalance();
+}
+
+void MultiStreamScheduler::Detach(GstVideoPlayer* player) {
+  if (players_.erase(player) == 0) {
+    return;
+  }
+  player->SetTaskPool(nullptr);
+  Rebalance();
+}
+
+void MultiStreamScheduler::Rebalance() {
+  if (players_.empty()) {
+    return;
+  }
+
+  int budget = max_decoder_threads_;
+  if (budget <= 0) {
+    budget = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const int threads =
+      std::max(1, budget / static_cast<int>(players_.size()));
+  for (auto* player : players_) {
+    player->SetDecoderThreads(threads);
+  }
+}
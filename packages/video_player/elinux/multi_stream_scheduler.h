@@ -0,0 +1,50 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MULTI_STREAM_SCHEDULER_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MULTI_STREAM_SCHEDULER_H_
+
+#include <gst/gst.h>
+
+#include <set>
+
+#include "gst_video_player.h"
+
+// Runs the RTSP players of a multi-stream wall under one scheduler.
+//
+// The streaming threads of every attached player are taken from one shared
+// GstTaskPool, so the threads of a closed stream are reused by the next one
+// instead of being created again, and the decoder threads are split from a
+// fixed budget instead of every decoder sizing itself to all the cores.
+class MultiStreamScheduler {
+ public:
+  MultiStreamScheduler();
+  ~MultiStreamScheduler();
+
+  // Prevent copying.
+  MultiStreamScheduler(MultiStreamScheduler const&) = delete;
+  MultiStreamScheduler& operator=(MultiStreamScheduler const&) = delete;
+
+  // Sets the total number of decoder threads shared by all the streams. Zero
+  // or less uses the number of cores.
+  void SetMaxDecoderThreads(int max_decoder_threads);
+
+  // Adds |player| to the scheduler. Must be called before
+  // GstVideoPlayer::Init() so that the streaming threads come from the
+  // shared pool.
+  void Attach(GstVideoPlayer* player);
+  void Detach(GstVideoPlayer* player);
+
+  size_t GetStreamCount() const { return players_.size(); }
+
+ private:
+  // Splits the decoder thread budget between the attached players.
+  void Rebalance();
+
+  GstTaskPool* task_pool_ = nullptr;
+  int max_decoder_threads_ = 0;
+  std::set<GstVideoPlayer*> players_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MULTI_STREAM_SCHEDULER_H_
@@ -0,0 +1,97 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform_task_queue.h"
+
+#include <flutter/standard_message_codec.h>
+
+#include <utility>
+#include <variant>
+
+namespace {
+constexpr char kPort[] = "port";
+constexpr char kPostCObject[] = "postCObject";
+
+// Dart sends an int as int32_t if it fits and as int64_t otherwise.
+bool GetInt64(const flutter::EncodableMap& map, const char* key,
+              int64_t& value) {
+  const auto it = map.find(flutter::EncodableValue(key));
+  if (it == map.end() || !(std::holds_alternative<int32_t>(it->second) ||
+                           std::holds_alternative<int64_t>(it->second))) {
+    return false;
+  }
+  value = it->second.LongValue();
+  return true;
+}
+}  // namespace
+
+PlatformTaskQueue::PlatformTaskQueue(flutter::BinaryMessenger* messenger,
+                                     const std::string& channel_name) {
+  channel_ =
+      std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+          messenger, channel_name,
+          &flutter::StandardMessageCodec::GetInstance());
+  channel_->SetMessageHandler(
+      [this](const flutter::EncodableValue& message,
+             const flutter::MessageReply<flutter::EncodableValue>& reply) {
+        HandleMessage(message);
+        reply(flutter::EncodableValue());
+      });
+}
+
+PlatformTaskQueue::~PlatformTaskQueue() {
+  channel_->SetMessageHandler(nullptr);
+}
+
+void PlatformTaskQueue::Post(Task task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tasks_.push_back(std::move(task));
+  Wake();
+}
+
+void PlatformTaskQueue::RunPending() {
+  std::vector<Task> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The tasks posted by the ones below wake Dart again.
+    is_wake_pending_ = false;
+    tasks.swap(tasks_);
+  }
+  for (auto& task : tasks) {
+    task();
+  }
+}
+
+void PlatformTaskQueue::HandleMessage(const flutter::EncodableValue& message) {
+  // The port of the isolate, sent once it starts, and nothing otherwise.
+  if (const auto* map = std::get_if<flutter::EncodableMap>(&message)) {
+    int64_t port = 0;
+    int64_t post_cobject = 0;
+    if (GetInt64(*map, kPort, port) &&
+        GetInt64(*map, kPostCObject, post_cobject)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      port_ = port;
+      post_cobject_ = reinterpret_cast<PostCObject>(
+          static_cast<uintptr_t>(post_cobject));
+      // The previous isolate may not have run its wake up, e.g. on a hot
+      // restart. The tasks are run below anyway.
+      is_wake_pending_ = false;
+    }
+  }
+  RunPending();
+}
+
+void PlatformTaskQueue::Wake() {
+  if (is_wake_pending_ || !post_cobject_) {
+    return;
+  }
+  // An int, in the layout of Dart_CObject of dart_native_api.h, which spares
+  // the plugin the headers of the Dart SDK.
+  struct {
+    int32_t type;
+    int64_t value;
+  } message = {3 /* Dart_CObject_kInt64 */, 0};
+  // Only fails once the isolate is gone, whose successor sends its port.
+  is_wake_pending_ = post_cobject_(port_, &message);
+}
@@ -0,0 +1,209 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "plugin_log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr char kLevelsEnv[] = "ELINUX_PLUGIN_LOG";
+constexpr PluginLog::Level kDefaultLevel = PluginLog::kInfo;
+// Every category may write a burst of kBurstMessages, then
+// kMessagesPerSecond on average.
+constexpr double kBurstMessages = 20;
+constexpr double kMessagesPerSecond = 5;
+constexpr size_t kMaxQueuedMessages = 256;
+
+struct Levels {
+  PluginLog::Level default_level = kDefaultLevel;
+  std::vector<std::pair<std::string, PluginLog::Level>> categories;
+};
+
+bool ParseLevel(const std::string& name, PluginLog::Level* level) {
+  static const std::pair<const char*, PluginLog::Level> kLevels[] = {
+      {"none", PluginLog::kNone},       {"error", PluginLog::kError},
+      {"warning", PluginLog::kWarning}, {"info", PluginLog::kInfo},
+      {"debug", PluginLog::kDebug},
+  };
+  for (const auto& [level_name, value] : kLevels) {
+    if (name == level_name) {
+      *level = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+// e.g. "gst:error,rtsp:debug,*:warning".
+Levels ParseLevels(const char* value) {
+  Levels levels;
+  if (!value) {
+    return levels;
+  }
+  std::istringstream stream(value);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    const auto separator = item.find(':');
+    PluginLog::Level level;
+    if (separator == std::string::npos ||
+        !ParseLevel(item.substr(separator + 1), &level)) {
+      std::cerr << "Invalid " << kLevelsEnv << " entry: " << item
+                << std::endl;
+      continue;
+    }
+    const auto category = item.substr(0, separator);
+    if (category == "*") {
+      levels.default_level = level;
+    } else {
+      levels.categories.emplace_back(category, level);
+    }
+  }
+  return levels;
+}
+
+const Levels& GetLevels() {
+  static const Levels levels = ParseLevels(std::getenv(kLevelsEnv));
+  return levels;
+}
+
+class Logger {
+ public:
+  // Never destroyed, so that the streaming threads still running at exit
+  // can log. The queue is flushed by an atexit handler instead.
+  static Logger& Get() {
+    static Logger* const logger = []() {
+      auto* logger = new Logger();
+      std::atexit([]() { Get().Flush(); });
+      return logger;
+    }();
+    return *logger;
+  }
+
+  void Write(PluginLog::Level level, const char* category,
+             const std::string& message) {
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = rates_.try_emplace(category);
+    auto& rate = it->second;
+    if (inserted) {
+      rate.tokens = kBurstMessages;
+    } else {
+      const std::chrono::duration<double> elapsed = now - rate.last_time;
+      rate.tokens = std::min(
+          kBurstMessages, rate.tokens + elapsed.count() * kMessagesPerSecond);
+    }
+    rate.last_time = now;
+    if (rate.tokens < 1) {
+      rate.suppressed++;
+      return;
+    }
+    if (queue_.size() >= kMaxQueuedMessages) {
+      overflowed_++;
+      return;
+    }
+    rate.tokens -= 1;
+
+    std::string text;
+    const auto prefix = std::string("[") + category + "] ";
+    if (rate.suppressed > 0) {
+      text = prefix + std::to_string(rate.suppressed) +
+             " messages were suppressed\n";
+      rate.suppressed = 0;
+    }
+    text += prefix + message + "\n";
+    queue_.push_back({level, std::move(text)});
+    queued_cv_.notify_one();
+  }
+
+  void Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    written_cv_.wait(lock, [this]() {
+      return queue_.empty() && overflowed_ == 0 && !is_writing_;
+    });
+  }
+
+ private:
+  struct RateLimit {
+    double tokens = 0;
+    std::chrono::steady_clock::time_point last_time;
+    uint64_t suppressed = 0;
+  };
+
+  struct Entry {
+    PluginLog::Level level;
+    std::string text;
+  };
+
+  Logger() { std::thread([this]() { Run(); }).detach(); }
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      queued_cv_.wait(lock,
+                      [this]() { return !queue_.empty() || overflowed_ > 0; });
+      auto entries = std::move(queue_);
+      queue_.clear();
+      const auto overflowed = overflowed_;
+      overflowed_ = 0;
+      is_writing_ = true;
+      lock.unlock();
+
+      if (overflowed > 0) {
+        std::fprintf(stderr, "%llu log messages were dropped\n",
+                     static_cast<unsigned long long>(overflowed));
+      }
+      for (const auto& entry : entries) {
+        std::fputs(entry.text.c_str(),
+                   entry.level <= PluginLog::kWarning ? stderr : stdout);
+      }
+      std::fflush(stdout);
+
+      lock.lock();
+      is_writing_ = false;
+      written_cv_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable queued_cv_;
+  std::condition_variable written_cv_;
+  std::deque<Entry> queue_;
+  uint64_t overflowed_ = 0;
+  bool is_writing_ = false;
+  std::unordered_map<std::string, RateLimit> rates_;
+};
+}  // namespace
+
+// static
+bool PluginLog::IsEnabled(Level level, const char* category) {
+  const auto& levels = GetLevels();
+  auto enabled_level = levels.default_level;
+  for (const auto& [name, category_level] : levels.categories) {
+    if (name == category) {
+      enabled_level = category_level;
+      break;
+    }
+  }
+  return level != kNone && level <= enabled_level;
+}
+
+// static
+void PluginLog::Write(Level level, const char* category,
+                      const std::string& message) {
+  Logger::Get().Write(level, category, message);
+}
+
+// static
+void PluginLog::Flush() { Logger::Get().Flush(); }
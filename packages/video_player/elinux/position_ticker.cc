@@ -0,0 +1,70 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "position_ticker.h"
+
+#include <algorithm>
+#include <utility>
+
+PositionTicker::~PositionTicker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  changed_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void PositionTicker::Set(int64_t texture_id, int64_t interval_ms, Tick tick) {
+  if (interval_ms <= 0) {
+    Remove(texture_id);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto interval = std::chrono::milliseconds(interval_ms);
+    entries_[texture_id] = {interval, Clock::now() + interval, std::move(tick)};
+    // Started by the first player, so that apps that poll pay nothing.
+    if (!thread_.joinable()) {
+      thread_ = std::thread([this]() { Run(); });
+    }
+  }
+  changed_.notify_all();
+}
+
+void PositionTicker::Remove(int64_t texture_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.erase(texture_id);
+}
+
+void PositionTicker::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!is_stopping_) {
+    if (entries_.empty()) {
+      changed_.wait(lock);
+      continue;
+    }
+    auto next_tick = Clock::time_point::max();
+    for (const auto& entry : entries_) {
+      next_tick = std::min(next_tick, entry.second.next_tick);
+    }
+    if (changed_.wait_until(lock, next_tick) == std::cv_status::no_timeout) {
+      // The entries changed, or a spurious wakeup.
+      continue;
+    }
+    const auto now = Clock::now();
+    for (auto& entry : entries_) {
+      if (entry.second.next_tick > now) {
+        continue;
+      }
+      entry.second.tick();
+      // Skips the ticks missed by a slow tick instead of bursting.
+      do {
+        entry.second.next_tick += entry.second.interval;
+      } while (entry.second.next_tick <= now);
+    }
+  }
+}
@@ -0,0 +1,110 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "presentation_queue.h"
+
+namespace {
+// Fetches further apart than this many periods skipped a vsync, e.g. while
+// no frame was due, and aren't measured.
+constexpr int64_t kMaxPeriodRatio = 3;
+// The shortest period measured, i.e. 240 Hz.
+constexpr int64_t kMinPeriodUs = 4000;
+// The inverse weight of a new measurement.
+constexpr int64_t kPeriodSmoothing = 8;
+}  // namespace
+
+PresentationQueue::~PresentationQueue() { Clear(); }
+
+void PresentationQueue::Push(GstBuffer* buffer, GstCaps* caps, int32_t width,
+                             int32_t height,
+                             const FrameTripleBuffer::Timestamps& timestamps,
+                             GstClockTime running_time) {
+  Entry entry;
+  entry.frame.buffer = gst_buffer_ref(buffer);
+  entry.frame.caps = gst_caps_ref(caps);
+  entry.frame.width = width;
+  entry.frame.height = height;
+  entry.frame.timestamps = timestamps;
+  entry.running_time = running_time;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.size() == kCapacity) {
+    Unref(entries_.front().frame);
+    entries_.pop_front();
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+  entries_.push_back(entry);
+}
+
+bool PresentationQueue::Take(GstClockTime now,
+                             FrameTripleBuffer::Frame& frame) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.empty()) {
+    return false;
+  }
+  auto due = entries_.size();
+  if (!GST_CLOCK_TIME_IS_VALID(now)) {
+    due = entries_.size() - 1;
+  } else {
+    // The frame is shown a period after the fetch. A frame without a
+    // running time is shown at once. The frames queued before a flushing
+    // seek are ahead of the others, and are dropped with the older ones.
+    const auto period = GetVsyncPeriod();
+    const auto vsync = now + period + period / 2;
+    for (size_t i = 0; i < entries_.size(); i++) {
+      const auto running_time = entries_[i].running_time;
+      if (!GST_CLOCK_TIME_IS_VALID(running_time) || running_time <= vsync) {
+        due = i;
+      }
+    }
+    if (due == entries_.size()) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < due; i++) {
+    Unref(entries_.front().frame);
+    entries_.pop_front();
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+  frame = entries_.front().frame;
+  entries_.pop_front();
+  return true;
+}
+
+void PresentationQueue::OnFetch(int64_t now_us) {
+  const auto interval = now_us - last_fetch_us_;
+  last_fetch_us_ = now_us;
+  const auto period_us = static_cast<int64_t>(GetVsyncPeriod() / 1000);
+  if (interval < kMinPeriodUs || interval > period_us * kMaxPeriodRatio) {
+    return;
+  }
+  const auto smoothed =
+      period_us + (interval - period_us) / kPeriodSmoothing;
+  vsync_period_ns_.store(static_cast<GstClockTime>(smoothed) * 1000,
+                         std::memory_order_relaxed);
+}
+
+bool PresentationQueue::HasPending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !entries_.empty();
+}
+
+void PresentationQueue::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : entries_) {
+    Unref(entry.frame);
+  }
+  entries_.clear();
+}
+
+// static
+void PresentationQueue::Unref(FrameTripleBuffer::Frame& frame) {
+  if (frame.buffer) {
+    gst_buffer_unref(frame.buffer);
+  }
+  if (frame.caps) {
+    gst_caps_unref(frame.caps);
+  }
+  frame = FrameTripleBuffer::Frame();
+}
@@ -0,0 +1,81 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_PRESENTATION_QUEUE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_PRESENTATION_QUEUE_H_
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+#include "frame_triple_buffer.h"
+
+// The next few frames of a player, released by a sink that syncs ahead of
+// their running time, so that the texture callback shows each frame on the
+// vsync nearest to it. Otherwise a frame is shown on the vsync after it
+// reaches the sink, and the phase between the clock and the display makes
+// 24, 25 or 30 fps content hold some frames one vsync longer than the
+// others.
+//
+// The plugin never sees the vsyncs, but the engine fetches the texture
+// once per vsync while the frames keep coming, so the period is measured
+// between the fetches.
+class PresentationQueue {
+ public:
+  static constexpr size_t kCapacity = 3;
+
+  PresentationQueue() = default;
+  ~PresentationQueue();
+
+  // Prevent copying.
+  PresentationQueue(PresentationQueue const&) = delete;
+  PresentationQueue& operator=(PresentationQueue const&) = delete;
+
+  // Queues a frame to be shown at |running_time|. Takes new references to
+  // |buffer| and |caps|. Drops the oldest frame if the queue is full, e.g.
+  // while the texture isn't shown.
+  void Push(GstBuffer* buffer, GstCaps* caps, int32_t width, int32_t height,
+            const FrameTripleBuffer::Timestamps& timestamps,
+            GstClockTime running_time);
+
+  // Takes the frame to show at the vsync after a fetch at running time
+  // |now|, i.e. the newest one at or before that vsync rounded to the
+  // nearest, and drops the older ones. Takes the newest frame if |now| is
+  // GST_CLOCK_TIME_NONE, e.g. while paused. Returns false if no frame is due
+  // yet. |frame| owns its references on success.
+  bool Take(GstClockTime now, FrameTripleBuffer::Frame& frame);
+
+  // Records a fetch of the texture, to measure the vsync period.
+  void OnFetch(int64_t now_us);
+  GstClockTime GetVsyncPeriod() const {
+    return vsync_period_ns_.load(std::memory_order_relaxed);
+  }
+
+  bool HasPending() const;
+  void Clear();
+
+  uint64_t GetDroppedFrameCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Entry {
+    FrameTripleBuffer::Frame frame;
+    GstClockTime running_time;
+  };
+
+  static void Unref(FrameTripleBuffer::Frame& frame);
+
+  mutable std::mutex mutex_;
+  std::deque<Entry> entries_;
+  // Only touched by the texture callback.
+  int64_t last_fetch_us_ = 0;
+  std::atomic<GstClockTime> vsync_period_ns_{16666667};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_PRESENTATION_QUEUE_H_
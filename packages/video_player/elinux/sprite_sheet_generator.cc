@@ -0,0 +1,487 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sprite_sheet_generator.h"
+
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/video/video.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "download_cache.h"
+
+namespace {
+// Bounds each state change and each frame, so that a broken file doesn't
+// hold the worker.
+constexpr GstClockTime kTimeout = 10 * GST_SECOND;
+
+// The largest side of a sheet, which the GPUs of the usual embedded devices
+// still take as one texture.
+constexpr int32_t kMaxSheetSize = 8192;
+constexpr int32_t kMinTileWidth = 16;
+constexpr int64_t kMinIntervalMs = 100;
+
+constexpr char kSheetSuffix[] = ".sprites.jpg";
+constexpr char kIndexSuffix[] = ".sprites.idx";
+constexpr char kIndexMagic[] = "VPS1";
+
+int64_t DivideRoundingUp(int64_t value, int64_t divisor) {
+  return (value + divisor - 1) / divisor;
+}
+}  // namespace
+
+SpriteSheetGenerator::SpriteSheetGenerator(const std::string& cache_directory)
+    : cache_directory_(cache_directory) {
+  if (!cache_directory_.empty() &&
+      g_mkdir_with_parents(cache_directory_.c_str(), 0700) != 0) {
+    std::cerr << "Failed to create the sprite sheet cache " << cache_directory_
+              << std::endl;
+  }
+  // One file at a time, so that the previews don't take the CPUs of the
+  // players.
+  worker_ = std::thread([this]() { RunWorker(); });
+}
+
+SpriteSheetGenerator::~SpriteSheetGenerator() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+    jobs_.clear();
+  }
+  job_available_.notify_all();
+  worker_.join();
+}
+
+bool SpriteSheetGenerator::Generate(const Request& request,
+                                    Callback callback) {
+  if (request.interval_ms < kMinIntervalMs ||
+      request.tile_width < kMinTileWidth || request.columns <= 0 ||
+      static_cast<int64_t>(request.tile_width) * request.columns >
+          kMaxSheetSize) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back({request, std::move(callback)});
+  }
+  job_available_.notify_one();
+  return true;
+}
+
+void SpriteSheetGenerator::RunWorker() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      job_available_.wait(lock,
+                          [this]() { return is_stopping_ || !jobs_.empty(); });
+      if (is_stopping_) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job.callback(Run(job.request));
+  }
+}
+
+SpriteSheetGenerator::SpriteSheet SpriteSheetGenerator::Run(
+    const Request& request) {
+  std::string uri = request.uri;
+  if (!gst_uri_is_valid(uri.c_str())) {
+    auto* filename_uri = gst_filename_to_uri(uri.c_str(), NULL);
+    if (filename_uri) {
+      uri = filename_uri;
+      g_free(filename_uri);
+    }
+  }
+  // A clip a player has downloaded is decoded from its local copy.
+  const auto cached_uri = DownloadCache::GetInstance().Lookup(uri);
+  if (!cached_uri.empty()) {
+    uri = cached_uri;
+  }
+
+  SpriteSheet result;
+  // Only local files have a modification time to invalidate the sheet with.
+  auto* filename = g_filename_from_uri(uri.c_str(), nullptr, nullptr);
+  struct stat file_stat;
+  if (!filename || stat(filename, &file_stat) != 0) {
+    g_free(filename);
+    result.error = "Sprite sheets need a local file: " + request.uri;
+    return result;
+  }
+  const std::string path(filename);
+  g_free(filename);
+
+  const auto key =
+      uri + "|" + std::to_string(file_stat.st_mtim.tv_sec) + "." +
+      std::to_string(file_stat.st_mtim.tv_nsec) + "|" +
+      std::to_string(file_stat.st_size) + "|" +
+      std::to_string(request.interval_ms) + "|" +
+      std::to_string(request.tile_width) + "|" +
+      std::to_string(request.columns);
+  auto* checksum =
+      g_compute_checksum_for_string(G_CHECKSUM_SHA1, key.c_str(), -1);
+  const std::string key_checksum(checksum);
+  g_free(checksum);
+  // Next to the file, or in the cache if its directory isn't writable.
+  std::vector<std::string> prefixes = {path};
+  if (!cache_directory_.empty()) {
+    auto* path_checksum =
+        g_compute_checksum_for_string(G_CHECKSUM_SHA1, path.c_str(), -1);
+    prefixes.push_back(cache_directory_ + "/" + path_checksum);
+    g_free(path_checksum);
+  }
+
+  for (const auto& prefix : prefixes) {
+    SpriteSheet indexed;
+    if (LoadIndex(prefix + kIndexSuffix, key_checksum, indexed) &&
+        g_file_test((prefix + kSheetSuffix).c_str(), G_FILE_TEST_EXISTS)) {
+      indexed.path = prefix + kSheetSuffix;
+      return indexed;
+    }
+  }
+
+  Sheet sheet;
+  std::string jpeg;
+  if (!Decode(uri, request, sheet, result.error) ||
+      !Encode(sheet, jpeg, result.error)) {
+    if (result.error.empty()) {
+      result.error = "Failed to generate a sprite sheet of " + request.uri;
+    }
+    std::cerr << result.error << std::endl;
+    return result;
+  }
+  for (const auto& prefix : prefixes) {
+    // The index is written last, so that it never points to a partial sheet.
+    const auto sheet_path = prefix + kSheetSuffix;
+    if (g_file_set_contents(sheet_path.c_str(), jpeg.data(), jpeg.size(),
+                            nullptr) &&
+        SaveIndex(prefix + kIndexSuffix, key_checksum, sheet)) {
+      result.path = sheet_path;
+      result.interval_ms = sheet.interval_ms;
+      result.tile_width = sheet.tile_width;
+      result.tile_height = sheet.tile_height;
+      result.columns = sheet.columns;
+      result.count = sheet.count;
+      return result;
+    }
+  }
+  result.error = "Failed to write the sprite sheet of " + request.uri;
+  std::cerr << result.error << std::endl;
+  return result;
+}
+
+bool SpriteSheetGenerator::Decode(const std::string& uri,
+                                  const Request& request, Sheet& sheet,
+                                  std::string& error) {
+  auto* pipeline = gst_pipeline_new("sprite-sheet");
+  auto* decoder = gst_element_factory_make("uridecodebin", nullptr);
+  auto* converter = gst_element_factory_make("videoconvert", nullptr);
+  auto* scaler = gst_element_factory_make("videoscale", nullptr);
+  auto* filter = gst_element_factory_make("capsfilter", nullptr);
+  auto* sink = gst_element_factory_make("appsink", nullptr);
+  if (!pipeline || !decoder || !converter || !scaler || !filter || !sink) {
+    error = "Failed to create a sprite sheet pipeline";
+    for (auto* element : {decoder, converter, scaler, filter, sink, pipeline}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    return false;
+  }
+
+  // Keeps the display aspect ratio of the video.
+  auto* filter_caps = gst_caps_new_simple(
+      "video/x-raw", "format", G_TYPE_STRING, "RGBA", "width", G_TYPE_INT,
+      request.tile_width & ~1, "pixel-aspect-ratio", GST_TYPE_FRACTION, 1, 1,
+      NULL);
+  g_object_set(filter, "caps", filter_caps, NULL);
+  gst_caps_unref(filter_caps);
+  g_object_set(decoder, "uri", uri.c_str(), NULL);
+  // Decodes ahead by a couple of frames only, at the speed of the decoder.
+  g_object_set(sink, "sync", FALSE, "max-buffers", 2, NULL);
+  gst_bin_add_many(GST_BIN(pipeline), decoder, converter, scaler, filter, sink,
+                   NULL);
+  const auto linked =
+      gst_element_link_many(converter, scaler, filter, sink, NULL);
+  g_signal_connect(decoder, "pad-added", G_CALLBACK(OnPadAdded), converter);
+
+  gint64 duration = 0;
+  GstSample* preroll = nullptr;
+  if (!linked) {
+    error = "Failed to link the sprite sheet pipeline";
+  } else if (gst_element_set_state(pipeline, GST_STATE_PAUSED) ==
+                 GST_STATE_CHANGE_FAILURE ||
+             gst_element_get_state(pipeline, nullptr, nullptr, kTimeout) !=
+                 GST_STATE_CHANGE_SUCCESS) {
+    error = "Failed to decode " + request.uri;
+  } else if (!gst_element_query_duration(pipeline, GST_FORMAT_TIME,
+                                         &duration) ||
+             duration <= 0) {
+    error = "Unknown duration of " + request.uri;
+  } else {
+    preroll = gst_app_sink_try_pull_preroll(GST_APP_SINK(sink), kTimeout);
+    auto* caps = preroll ? gst_sample_get_caps(preroll) : nullptr;
+    auto* structure = caps ? gst_caps_get_structure(caps, 0) : nullptr;
+    if (!structure ||
+        !gst_structure_get_int(structure, "width", &sheet.tile_width) ||
+        !gst_structure_get_int(structure, "height", &sheet.tile_height) ||
+        sheet.tile_width <= 0 || sheet.tile_height <= 0) {
+      error = "No video frame in " + request.uri;
+    }
+  }
+  if (preroll) {
+    gst_sample_unref(preroll);
+  }
+
+  if (error.empty()) {
+    // Spreads the tiles over a longer interval if the sheet would be too
+    // large for the whole file otherwise.
+    const auto duration_ms = std::max<int64_t>(duration / GST_MSECOND, 1);
+    const auto max_count =
+        static_cast<int64_t>(std::max(kMaxSheetSize / sheet.tile_height, 1)) *
+        request.columns;
+    sheet.interval_ms = std::max(request.interval_ms,
+                                 DivideRoundingUp(duration_ms, max_count));
+    sheet.count = static_cast<int32_t>(
+        DivideRoundingUp(duration_ms, sheet.interval_ms));
+    sheet.columns = std::min(request.columns, sheet.count);
+    const auto rows = DivideRoundingUp(sheet.count, sheet.columns);
+    sheet.pixels.assign(static_cast<size_t>(sheet.columns) *
+                            sheet.tile_width * rows * sheet.tile_height * 4,
+                        0);
+
+    // Only the key frames are demuxed and decoded, and the audio is skipped.
+    if (!gst_element_seek(
+            pipeline, 1.0, GST_FORMAT_TIME,
+            (GstSeekFlags)(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_TRICKMODE |
+                           GST_SEEK_FLAG_TRICKMODE_KEY_UNITS |
+                           GST_SEEK_FLAG_TRICKMODE_NO_AUDIO),
+            GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_NONE, GST_CLOCK_TIME_NONE) ||
+        gst_element_set_state(pipeline, GST_STATE_PLAYING) ==
+            GST_STATE_CHANGE_FAILURE) {
+      error = "Failed to seek " + request.uri;
+    }
+  }
+
+  if (error.empty()) {
+    // Each tile shows the last key frame at or before its time, or the first
+    // one for the tiles before it.
+    GstSample* previous = nullptr;
+    int32_t next = 0;
+    while (next < sheet.count && !is_stopping_) {
+      auto* sample =
+          gst_app_sink_try_pull_sample(GST_APP_SINK(sink), kTimeout);
+      if (!sample) {
+        if (!gst_app_sink_is_eos(GST_APP_SINK(sink))) {
+          error = "Timed out decoding " + request.uri;
+        }
+        break;
+      }
+      auto* buffer = gst_sample_get_buffer(sample);
+      const auto* segment = gst_sample_get_segment(sample);
+      auto timestamp = buffer ? GST_BUFFER_PTS(buffer) : GST_CLOCK_TIME_NONE;
+      if (segment && GST_CLOCK_TIME_IS_VALID(timestamp)) {
+        timestamp =
+            gst_segment_to_stream_time(segment, GST_FORMAT_TIME, timestamp);
+      }
+      if (!GST_CLOCK_TIME_IS_VALID(timestamp)) {
+        gst_sample_unref(sample);
+        continue;
+      }
+      const auto position_ms = static_cast<int64_t>(timestamp / GST_MSECOND);
+      while (next < sheet.count && next * sheet.interval_ms < position_ms) {
+        CopyTile(previous ? previous : sample, next++, sheet);
+      }
+      if (next < sheet.count && next * sheet.interval_ms == position_ms) {
+        CopyTile(sample, next++, sheet);
+      }
+      if (previous) {
+        gst_sample_unref(previous);
+      }
+      previous = sample;
+    }
+    if (!previous && error.empty()) {
+      error = "No video frame in " + request.uri;
+    }
+    if (previous) {
+      while (next < sheet.count) {
+        CopyTile(previous, next++, sheet);
+      }
+      gst_sample_unref(previous);
+    }
+    if (is_stopping_) {
+      error = "The sprite sheet was cancelled";
+    }
+  }
+
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(pipeline);
+  return error.empty();
+}
+
+// static
+void SpriteSheetGenerator::CopyTile(GstSample* sample, int32_t index,
+                                    Sheet& sheet) {
+  auto* buffer = gst_sample_get_buffer(sample);
+  GstVideoInfo info;
+  GstMapInfo map;
+  if (!buffer || !gst_video_info_from_caps(&info, gst_sample_get_caps(sample)) ||
+      !gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    return;
+  }
+  // A frame of another size, e.g. after a resolution change in the file, is
+  // cropped or padded to the tile.
+  const auto width = std::min<int32_t>(GST_VIDEO_INFO_WIDTH(&info),
+                                       sheet.tile_width);
+  const auto height = std::min<int32_t>(GST_VIDEO_INFO_HEIGHT(&info),
+                                        sheet.tile_height);
+  const auto stride =
+      static_cast<size_t>(GST_VIDEO_INFO_PLANE_STRIDE(&info, 0));
+  const auto sheet_stride =
+      static_cast<size_t>(sheet.columns) * sheet.tile_width * 4;
+  const auto column = index % sheet.columns;
+  const auto row = index / sheet.columns;
+  auto* origin = sheet.pixels.data() +
+                 static_cast<size_t>(row) * sheet.tile_height * sheet_stride +
+                 static_cast<size_t>(column) * sheet.tile_width * 4;
+  for (int32_t y = 0; y < height; y++) {
+    if (y * stride + width * 4 > map.size) {
+      break;
+    }
+    std::memcpy(origin + y * sheet_stride, map.data + y * stride, width * 4);
+  }
+  gst_buffer_unmap(buffer, &map);
+}
+
+// static
+bool SpriteSheetGenerator::Encode(const Sheet& sheet, std::string& jpeg,
+                                  std::string& error) {
+  auto* pipeline = gst_pipeline_new("sprite-sheet-encoder");
+  auto* source = gst_element_factory_make("appsrc", nullptr);
+  auto* converter = gst_element_factory_make("videoconvert", nullptr);
+  // The hardware encoders don't take images this large.
+  auto* encoder = gst_element_factory_make("jpegenc", nullptr);
+  auto* sink = gst_element_factory_make("appsink", nullptr);
+  if (!pipeline || !source || !converter || !encoder || !sink) {
+    error = "Failed to create a sprite sheet encoder";
+    for (auto* element : {source, converter, encoder, sink, pipeline}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    return false;
+  }
+
+  const auto width = sheet.columns * sheet.tile_width;
+  const auto height = static_cast<int32_t>(
+      sheet.pixels.size() / (static_cast<size_t>(width) * 4));
+  auto* caps = gst_caps_new_simple(
+      "video/x-raw", "format", G_TYPE_STRING, "RGBA", "width", G_TYPE_INT,
+      width, "height", G_TYPE_INT, height, "framerate", GST_TYPE_FRACTION, 0,
+      1, NULL);
+  gst_app_src_set_caps(GST_APP_SRC(source), caps);
+  gst_caps_unref(caps);
+  g_object_set(source, "format", GST_FORMAT_TIME, NULL);
+  g_object_set(sink, "sync", FALSE, NULL);
+  gst_bin_add_many(GST_BIN(pipeline), source, converter, encoder, sink, NULL);
+
+  GstSample* sample = nullptr;
+  if (!gst_element_link_many(source, converter, encoder, sink, NULL) ||
+      gst_element_set_state(pipeline, GST_STATE_PLAYING) ==
+          GST_STATE_CHANGE_FAILURE) {
+    error = "Failed to start the sprite sheet encoder";
+  } else {
+    // The pixels outlive the pipeline, so they aren't copied.
+    auto* buffer = gst_buffer_new_wrapped_full(
+        GST_MEMORY_FLAG_READONLY, const_cast<uint8_t*>(sheet.pixels.data()),
+        sheet.pixels.size(), 0, sheet.pixels.size(), nullptr, nullptr);
+    GST_BUFFER_PTS(buffer) = 0;
+    if (gst_app_src_push_buffer(GST_APP_SRC(source), buffer) != GST_FLOW_OK) {
+      error = "Failed to encode the sprite sheet";
+    } else {
+      gst_app_src_end_of_stream(GST_APP_SRC(source));
+      sample = gst_app_sink_try_pull_sample(GST_APP_SINK(sink), kTimeout);
+      if (!sample) {
+        error = "Failed to encode the sprite sheet";
+      }
+    }
+  }
+
+  if (sample) {
+    auto* buffer = gst_sample_get_buffer(sample);
+    GstMapInfo map;
+    if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+      jpeg.assign(reinterpret_cast<const char*>(map.data), map.size);
+      gst_buffer_unmap(buffer, &map);
+    } else {
+      error = "Failed to read the sprite sheet";
+    }
+    gst_sample_unref(sample);
+  }
+
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(pipeline);
+  return error.empty();
+}
+
+// static
+bool SpriteSheetGenerator::LoadIndex(const std::string& path,
+                                     const std::string& key,
+                                     SpriteSheet& sheet) {
+  gchar* contents = nullptr;
+  if (!g_file_get_contents(path.c_str(), &contents, nullptr, nullptr)) {
+    return false;
+  }
+  std::istringstream stream(contents);
+  g_free(contents);
+  std::string magic;
+  std::string index_key;
+  stream >> magic >> index_key >> sheet.interval_ms >> sheet.tile_width >>
+      sheet.tile_height >> sheet.columns >> sheet.count;
+  return stream && magic == kIndexMagic && index_key == key &&
+         sheet.interval_ms > 0 && sheet.tile_width > 0 &&
+         sheet.tile_height > 0 && sheet.columns > 0 && sheet.count > 0;
+}
+
+// static
+bool SpriteSheetGenerator::SaveIndex(const std::string& path,
+                                     const std::string& key,
+                                     const Sheet& sheet) {
+  std::ostringstream stream;
+  stream << kIndexMagic << "\n"
+         << key << "\n"
+         << sheet.interval_ms << " " << sheet.tile_width << " "
+         << sheet.tile_height << " " << sheet.columns << " " << sheet.count
+         << "\n";
+  const auto contents = stream.str();
+  return g_file_set_contents(path.c_str(), contents.data(), contents.size(),
+                             nullptr);
+}
+
+// static
+void SpriteSheetGenerator::OnPadAdded(GstElement* element, GstPad* pad,
+                                      gpointer user_data) {
+  auto* converter = reinterpret_cast<GstElement*>(user_data);
+  auto* caps = gst_pad_get_current_caps(pad);
+  if (!caps) {
+    caps = gst_pad_query_caps(pad, nullptr);
+  }
+  const auto is_video = g_str_has_prefix(
+      gst_structure_get_name(gst_caps_get_structure(caps, 0)), "video/");
+  gst_caps_unref(caps);
+
+  auto* sink_pad = gst_element_get_static_pad(converter, "sink");
+  if (is_video && !gst_pad_is_linked(sink_pad) &&
+      GST_PAD_LINK_FAILED(gst_pad_link(pad, sink_pad))) {
+    std::cerr << "Failed to link the video of the sprite sheet" << std::endl;
+  }
+  gst_object_unref(sink_pad);
+}
@@ -0,0 +1,112 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_SPRITE_SHEET_GENERATOR_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_SPRITE_SHEET_GENERATOR_H_
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Builds sprite sheets of video files for timeline previews: a JPEG grid of
+// small frames taken at a fixed interval, so that the preview of a position
+// is a rectangle of one image the app has already loaded instead of a seek.
+//
+// Each file is decoded in one pass on a background thread with a key-unit
+// trick mode, so that only the key frames are decoded, and each tile shows
+// the last key frame at or before its time. The sheet and its index are
+// written next to the file, as <file>.sprites.jpg and <file>.sprites.idx,
+// or to the cache directory if the directory of the file isn't writable,
+// and reused until the file is modified.
+class SpriteSheetGenerator {
+ public:
+  struct Request {
+    std::string uri;
+    int64_t interval_ms = 10000;
+    // The width of a tile. The height follows the aspect ratio of the video.
+    int32_t tile_width = 160;
+    int32_t columns = 10;
+  };
+
+  struct SpriteSheet {
+    // The JPEG image.
+    std::string path;
+    // The interval between the tiles, which is longer than requested if
+    // the sheet would be too large for the whole file otherwise.
+    int64_t interval_ms = 0;
+    int32_t tile_width = 0;
+    int32_t tile_height = 0;
+    int32_t columns = 0;
+    // The tile of a position is the one of the last interval starting at or
+    // before it, from left to right and top to bottom.
+    int32_t count = 0;
+    // Empty on success.
+    std::string error;
+  };
+
+  // Called on the worker thread.
+  using Callback = std::function<void(SpriteSheet sheet)>;
+
+  // Falls back to |cache_directory| for the files whose directory isn't
+  // writable.
+  explicit SpriteSheetGenerator(const std::string& cache_directory);
+  // Drops the pending requests and stops the running one.
+  ~SpriteSheetGenerator();
+
+  // Prevent copying.
+  SpriteSheetGenerator(SpriteSheetGenerator const&) = delete;
+  SpriteSheetGenerator& operator=(SpriteSheetGenerator const&) = delete;
+
+  // Returns false without calling |callback| if |request| is out of range.
+  bool Generate(const Request& request, Callback callback);
+
+ private:
+  struct Job {
+    Request request;
+    Callback callback;
+  };
+
+  // The tiles of a sheet being decoded.
+  struct Sheet {
+    int64_t interval_ms = 0;
+    int32_t tile_width = 0;
+    int32_t tile_height = 0;
+    int32_t columns = 0;
+    int32_t count = 0;
+    // Tightly packed RGBA pixels of the whole sheet.
+    std::vector<uint8_t> pixels;
+  };
+
+  void RunWorker();
+  SpriteSheet Run(const Request& request);
+  bool Decode(const std::string& uri, const Request& request, Sheet& sheet,
+              std::string& error);
+  static void CopyTile(GstSample* sample, int32_t index, Sheet& sheet);
+  // Sets |jpeg| to the JPEG image of |sheet|.
+  static bool Encode(const Sheet& sheet, std::string& jpeg,
+                     std::string& error);
+  // Sets |sheet| from the index at |path| if it was written for |key|.
+  static bool LoadIndex(const std::string& path, const std::string& key,
+                        SpriteSheet& sheet);
+  static bool SaveIndex(const std::string& path, const std::string& key,
+                        const Sheet& sheet);
+  static void OnPadAdded(GstElement* element, GstPad* pad, gpointer user_data);
+
+  const std::string cache_directory_;
+  std::thread worker_;
+  std::atomic<bool> is_stopping_{false};
+  std::mutex mutex_;
+  std::condition_variable job_available_;
+  std::deque<Job> jobs_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_SPRITE_SHEET_GENERATOR_H_
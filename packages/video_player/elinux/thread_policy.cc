@@ -0,0 +1,248 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "thread_policy.h"
+
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "plugin_log.h"
+
+namespace {
+constexpr char kThreadsEnv[] = "ELINUX_PLUGIN_THREADS";
+constexpr const char* kRoleNames[] = {"network", "streaming"};
+
+// Whether the calling thread runs with the settings of a role.
+thread_local bool is_thread_tuned = false;
+
+// e.g. "0-3,6".
+bool ParseCpus(const std::string& value, std::vector<int>& cpus) {
+  std::istringstream stream(value);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    const auto separator = item.find('-');
+    char* end = nullptr;
+    const auto first = std::strtol(item.c_str(), &end, 10);
+    auto last = first;
+    if (separator != std::string::npos) {
+      last = std::strtol(item.c_str() + separator + 1, &end, 10);
+    }
+    if (item.empty() || *end != '\0' || first < 0 || last < first ||
+        last >= CPU_SETSIZE) {
+      return false;
+    }
+    for (auto cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(static_cast<int>(cpu));
+    }
+  }
+  return !cpus.empty();
+}
+
+// e.g. "cpus=4-7:fifo=10" or "cpus=0-3:nice=-5".
+bool ParseSettings(const std::string& value, ThreadPolicy::Settings& settings) {
+  std::istringstream stream(value);
+  std::string item;
+  while (std::getline(stream, item, ':')) {
+    const auto separator = item.find('=');
+    if (separator == std::string::npos) {
+      return false;
+    }
+    const auto key = item.substr(0, separator);
+    const auto number = item.substr(separator + 1);
+    char* end = nullptr;
+    if (key == "cpus") {
+      if (!ParseCpus(number, settings.cpus)) {
+        return false;
+      }
+    } else if (key == "fifo") {
+      settings.realtime_priority =
+          static_cast<int>(std::strtol(number.c_str(), &end, 10));
+    } else if (key == "nice") {
+      settings.nice = static_cast<int>(std::strtol(number.c_str(), &end, 10));
+    } else {
+      return false;
+    }
+    if (end && (number.empty() || *end != '\0')) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+// static
+ThreadPolicy& ThreadPolicy::GetInstance() {
+  static ThreadPolicy instance;
+  return instance;
+}
+
+ThreadPolicy::ThreadPolicy() {
+  CPU_ZERO(&default_cpus_);
+  if (sched_getaffinity(0, sizeof(default_cpus_), &default_cpus_) != 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      CPU_SET(cpu, &default_cpus_);
+    }
+  }
+
+  // e.g. "streaming:cpus=4-7:fifo=10;network:cpus=0-3:nice=-5".
+  const char* value = std::getenv(kThreadsEnv);
+  if (!value) {
+    return;
+  }
+  std::istringstream stream(value);
+  std::string item;
+  while (std::getline(stream, item, ';')) {
+    const auto separator = item.find(':');
+    Role role;
+    Settings settings;
+    if (separator == std::string::npos ||
+        !ParseRole(item.substr(0, separator), role) ||
+        !ParseSettings(item.substr(separator + 1), settings) ||
+        !Set(role, settings)) {
+      std::cerr << "Invalid " << kThreadsEnv << " entry: " << item
+                << std::endl;
+    }
+  }
+}
+
+// static
+bool ThreadPolicy::ParseRole(const std::string& name, Role& role) {
+  for (int i = 0; i < kRoleCount; i++) {
+    if (name == kRoleNames[i]) {
+      role = static_cast<Role>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPolicy::Set(Role role, const Settings& settings) {
+  if (role < 0 || role >= kRoleCount || !IsValid(settings)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  settings_[role] = settings;
+  auto is_enabled = false;
+  for (const auto& role_settings : settings_) {
+    is_enabled |= !role_settings.IsDefault();
+  }
+  is_enabled_ = is_enabled;
+  return true;
+}
+
+ThreadPolicy::Settings ThreadPolicy::Get(Role role) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return settings_[role];
+}
+
+// static
+bool ThreadPolicy::IsValid(const Settings& settings) {
+  for (const auto cpu : settings.cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return false;
+    }
+  }
+  return settings.realtime_priority >= 0 &&
+         settings.realtime_priority <= 99 && settings.nice >= -20 &&
+         settings.nice <= 19;
+}
+
+void ThreadPolicy::HandleStreamStatus(GstMessage* message) {
+  if (!is_enabled_ && !is_thread_tuned) {
+    return;
+  }
+  GstStreamStatusType type;
+  GstElement* owner = nullptr;
+  gst_message_parse_stream_status(message, &type, &owner);
+  // Both are posted by the streaming thread itself.
+  if (type == GST_STREAM_STATUS_TYPE_LEAVE) {
+    if (is_thread_tuned) {
+      Restore();
+    }
+    return;
+  }
+  if (type != GST_STREAM_STATUS_TYPE_ENTER || !owner) {
+    return;
+  }
+  const auto role = GetRole(owner);
+  const auto settings = Get(role);
+  if (!settings.IsDefault()) {
+    Apply(settings, kRoleNames[role]);
+  }
+}
+
+// static
+ThreadPolicy::Role ThreadPolicy::GetRole(GstElement* owner) {
+  auto* factory = gst_element_get_factory(owner);
+  const auto* klass = factory ? gst_element_factory_get_metadata(
+                                    factory, GST_ELEMENT_METADATA_KLASS)
+                              : nullptr;
+  // e.g. "Source/Network/UDP", but not the "Filter/Network/RTP" of the
+  // jitter buffer, whose thread pushes to the decoder.
+  if (klass && std::strstr(klass, "Source") &&
+      std::strstr(klass, "Network")) {
+    return kNetwork;
+  }
+  return kStreaming;
+}
+
+void ThreadPolicy::Apply(const Settings& settings,
+                         const char* role_name) const {
+  is_thread_tuned = true;
+  if (!settings.cpus.empty()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (const auto cpu : settings.cpus) {
+      CPU_SET(cpu, &cpus);
+    }
+    const auto result =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (result != 0) {
+      PLUGIN_LOG(Warning, "thread")
+          << "Failed to pin a " << role_name
+          << " thread: " << std::strerror(result);
+    }
+  }
+  if (settings.realtime_priority > 0) {
+    sched_param param = {};
+    param.sched_priority = settings.realtime_priority;
+    const auto result =
+        pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0) {
+      PLUGIN_LOG(Warning, "thread")
+          << "Failed to set SCHED_FIFO on a " << role_name
+          << " thread: " << std::strerror(result);
+    }
+  } else if (settings.nice != 0) {
+    // The nice value of a Linux thread is its own.
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)),
+                    settings.nice) != 0) {
+      PLUGIN_LOG(Warning, "thread")
+          << "Failed to set the nice value of a " << role_name
+          << " thread: " << std::strerror(errno);
+    }
+  }
+  PLUGIN_LOG(Debug, "thread") << "Applied the " << role_name
+                              << " settings to thread "
+                              << syscall(SYS_gettid);
+}
+
+void ThreadPolicy::Restore() const {
+  is_thread_tuned = false;
+  pthread_setaffinity_np(pthread_self(), sizeof(default_cpus_),
+                         &default_cpus_);
+  sched_param param = {};
+  pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+  // Raising the priority back may be denied without CAP_SYS_NICE, which
+  // only leaves the thread nicer than the others.
+  setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 0);
+}
@@ -0,0 +1,327 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "timeshift_buffer.h"
+
+#include <gst/app/gstappsrc.h>
+#include <gst/video/video.h>
+
+#include <chrono>
+#include <iostream>
+
+TimeshiftBuffer::TimeshiftBuffer(int64_t window_ms, int64_t max_bytes)
+    : window_us_(window_ms * 1000), max_bytes_(max_bytes) {
+  replay_thread_ = std::thread(&TimeshiftBuffer::RunReplay, this);
+}
+
+TimeshiftBuffer::~TimeshiftBuffer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  cv_.notify_all();
+  replay_thread_.join();
+  Detach();
+}
+
+bool TimeshiftBuffer::Attach(GstElement* pipeline, GstElement* parse,
+                             GstElement* decoder) {
+  auto* selector = gst_element_factory_make("input-selector", "timeshift");
+  auto* source = gst_element_factory_make("appsrc", "timeshiftsrc");
+  if (!selector || !source) {
+    std::cerr << "Failed to create the timeshift elements" << std::endl;
+    for (auto* element : {selector, source}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    return false;
+  }
+  // Drops the buffers of the inactive pad at once, instead of holding them
+  // back until the running time of the active one catches up.
+  if (g_object_class_find_property(G_OBJECT_GET_CLASS(selector),
+                                   "sync-streams")) {
+    g_object_set(G_OBJECT(selector), "sync-streams", FALSE, NULL);
+  }
+  // The replay thread paces the access units itself.
+  g_object_set(G_OBJECT(source), "format", GST_FORMAT_TIME, "is-live", TRUE,
+               "block", FALSE, NULL);
+  // Repeats the parameter sets with every key frame, so that the decoder
+  // can start from any of them after a flush.
+  if (g_object_class_find_property(G_OBJECT_GET_CLASS(parse),
+                                   "config-interval")) {
+    g_object_set(G_OBJECT(parse), "config-interval", -1, NULL);
+  }
+
+  gst_bin_add_many(GST_BIN(pipeline), selector, source, NULL);
+  auto* live_pad = gst_element_request_pad_simple(selector, "sink_%u");
+  auto* replay_pad = gst_element_request_pad_simple(selector, "sink_%u");
+  auto* parse_pad = gst_element_get_static_pad(parse, "src");
+  auto* source_pad = gst_element_get_static_pad(source, "src");
+  const bool linked =
+      gst_pad_link(parse_pad, live_pad) == GST_PAD_LINK_OK &&
+      gst_pad_link(source_pad, replay_pad) == GST_PAD_LINK_OK &&
+      gst_element_link(selector, decoder);
+  if (linked) {
+    g_object_set(G_OBJECT(selector), "active-pad", live_pad, NULL);
+  }
+  gst_object_unref(live_pad);
+  gst_object_unref(replay_pad);
+  gst_object_unref(source_pad);
+  if (!linked) {
+    gst_object_unref(parse_pad);
+    gst_bin_remove_many(GST_BIN(pipeline), selector, source, NULL);
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_push_);
+    pipeline_ = pipeline;
+    parse_ = GST_ELEMENT(gst_object_ref(parse));
+    selector_ = GST_ELEMENT(gst_object_ref(selector));
+    source_ = GST_ELEMENT(gst_object_ref(source));
+  }
+  probe_id_ = gst_pad_add_probe(
+      parse_pad,
+      static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER |
+                                   GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM),
+      OnParsedData, this, nullptr);
+  gst_object_unref(parse_pad);
+  gst_element_sync_state_with_parent(selector);
+  gst_element_sync_state_with_parent(source);
+  return true;
+}
+
+void TimeshiftBuffer::Detach() {
+  std::lock_guard<std::mutex> push_lock(mutex_push_);
+  if (!selector_) {
+    return;
+  }
+  auto* parse_pad = gst_element_get_static_pad(parse_, "src");
+  gst_pad_remove_probe(parse_pad, probe_id_);
+  gst_object_unref(parse_pad);
+  probe_id_ = 0;
+  for (auto* element : {selector_, source_}) {
+    gst_element_set_state(element, GST_STATE_NULL);
+    if (GST_OBJECT_PARENT(element) == GST_OBJECT(pipeline_)) {
+      gst_bin_remove(GST_BIN(pipeline_), element);
+    }
+  }
+  for (auto** element : {&parse_, &selector_, &source_}) {
+    gst_object_unref(*element);
+    *element = nullptr;
+  }
+  pipeline_ = nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Clear();
+  is_replaying_ = false;
+  is_waiting_for_key_ = false;
+  generation_++;
+}
+
+bool TimeshiftBuffer::SetDelay(int64_t delay_ms) {
+  std::lock_guard<std::mutex> push_lock(mutex_push_);
+  if (!selector_) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (delay_ms <= 0) {
+      if (!is_replaying_) {
+        return true;
+      }
+      is_replaying_ = false;
+      is_waiting_for_key_ = true;
+    } else {
+      if (units_.empty()) {
+        return false;
+      }
+      // The oldest access unit is a key frame.
+      const auto now = g_get_monotonic_time();
+      const auto position = now - delay_ms * 1000;
+      size_t index = 0;
+      for (size_t i = 0; i < units_.size() && units_[i].arrival_us <= position;
+           i++) {
+        if (units_[i].is_key) {
+          index = i;
+        }
+      }
+      cursor_ = first_sequence_ + index;
+      delay_us_ = now - units_[index].arrival_us;
+      is_replaying_ = true;
+      is_waiting_for_key_ = false;
+    }
+    generation_++;
+  }
+
+  if (delay_ms > 0) {
+    // Selected first, so that the flush reaches the decoder.
+    SelectPad(true);
+    FlushReplay();
+    cv_.notify_all();
+  } else {
+    SelectPad(false);
+    FlushReplay();
+    // Forwarded as a picture loss indication to the senders that support
+    // it, instead of waiting for the next key frame.
+    gst_element_send_event(parse_, gst_video_event_new_upstream_force_key_unit(
+                                       GST_CLOCK_TIME_NONE, TRUE, 0));
+  }
+  return true;
+}
+
+TimeshiftBuffer::State TimeshiftBuffer::GetState() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  State state;
+  if (!units_.empty()) {
+    state.available_ms =
+        (g_get_monotonic_time() - units_.front().arrival_us) / 1000;
+  }
+  state.delay_ms = is_replaying_ ? delay_us_ / 1000 : 0;
+  state.bytes = bytes_;
+  return state;
+}
+
+// static
+GstPadProbeReturn TimeshiftBuffer::OnParsedData(GstPad* pad,
+                                                GstPadProbeInfo* info,
+                                                gpointer user_data) {
+  auto* self = reinterpret_cast<TimeshiftBuffer*>(user_data);
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+    auto* event = GST_PAD_PROBE_INFO_EVENT(info);
+    if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+      GstCaps* caps = nullptr;
+      gst_event_parse_caps(event, &caps);
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      // The access units recorded so far may not decode with the new caps.
+      self->Clear();
+      gst_app_src_set_caps(GST_APP_SRC(self->source_), caps);
+    }
+    return GST_PAD_PROBE_OK;
+  }
+
+  auto* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  std::lock_guard<std::mutex> lock(self->mutex_);
+  self->Record(buffer);
+  if (self->is_replaying_) {
+    self->cv_.notify_all();
+    return GST_PAD_PROBE_DROP;
+  }
+  if (self->is_waiting_for_key_) {
+    if (GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+      return GST_PAD_PROBE_DROP;
+    }
+    self->is_waiting_for_key_ = false;
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+void TimeshiftBuffer::Record(GstBuffer* buffer) {
+  const bool is_key =
+      !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+  if (units_.empty() && !is_key) {
+    return;
+  }
+  const auto now = g_get_monotonic_time();
+  units_.push_back({gst_buffer_ref(buffer), now, is_key});
+  bytes_ += static_cast<int64_t>(gst_buffer_get_size(buffer));
+
+  // Drops whole key frame intervals, so that the oldest access unit stays a
+  // key frame.
+  while (!units_.empty() && (bytes_ > max_bytes_ ||
+                             now - units_.front().arrival_us > window_us_)) {
+    do {
+      const auto& unit = units_.front();
+      bytes_ -= static_cast<int64_t>(gst_buffer_get_size(unit.buffer));
+      gst_buffer_unref(unit.buffer);
+      units_.pop_front();
+      first_sequence_++;
+    } while (!units_.empty() && !units_.front().is_key);
+  }
+}
+
+void TimeshiftBuffer::Clear() {
+  for (auto& unit : units_) {
+    gst_buffer_unref(unit.buffer);
+  }
+  first_sequence_ += units_.size();
+  units_.clear();
+  bytes_ = 0;
+}
+
+void TimeshiftBuffer::RunReplay() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!is_stopping_) {
+    if (!is_replaying_ || cursor_ >= first_sequence_ + units_.size()) {
+      cv_.wait(lock);
+      continue;
+    }
+    // Dropped while waiting, e.g. for exceeding the size.
+    if (cursor_ < first_sequence_) {
+      cursor_ = first_sequence_;
+    }
+    const auto& unit = units_[cursor_ - first_sequence_];
+    const auto now = g_get_monotonic_time();
+    const auto due = unit.arrival_us + delay_us_;
+    if (due > now) {
+      cv_.wait_for(lock, std::chrono::microseconds(due - now));
+      continue;
+    }
+
+    // Shifted by how long it was kept, so that it isn't late for the sink.
+    // Without the metas, so that the capture latency it carries doesn't end
+    // up in the latency statistics.
+    auto* buffer = gst_buffer_copy_region(
+        unit.buffer,
+        static_cast<GstBufferCopyFlags>(GST_BUFFER_COPY_FLAGS |
+                                        GST_BUFFER_COPY_TIMESTAMPS |
+                                        GST_BUFFER_COPY_MEMORY),
+        0, static_cast<gsize>(-1));
+    const auto shift =
+        static_cast<GstClockTime>(now - unit.arrival_us) * GST_USECOND;
+    if (GST_BUFFER_PTS_IS_VALID(buffer)) {
+      GST_BUFFER_PTS(buffer) += shift;
+    }
+    if (GST_BUFFER_DTS_IS_VALID(buffer)) {
+      GST_BUFFER_DTS(buffer) += shift;
+    }
+    cursor_++;
+    const auto generation = generation_;
+    lock.unlock();
+
+    {
+      std::lock_guard<std::mutex> push_lock(mutex_push_);
+      bool is_current = false;
+      {
+        std::lock_guard<std::mutex> check_lock(mutex_);
+        is_current = generation == generation_ && !is_stopping_;
+      }
+      if (is_current && source_) {
+        gst_app_src_push_buffer(GST_APP_SRC(source_), buffer);
+      } else {
+        gst_buffer_unref(buffer);
+      }
+    }
+    lock.lock();
+  }
+}
+
+void TimeshiftBuffer::FlushReplay() {
+  // appsrc forwards the flush downstream, drops its queue, and starts over
+  // with a new segment.
+  gst_element_send_event(source_, gst_event_new_flush_start());
+  gst_element_send_event(source_, gst_event_new_flush_stop(FALSE));
+}
+
+void TimeshiftBuffer::SelectPad(bool replay) {
+  auto* source_pad = gst_element_get_static_pad(replay ? source_ : parse_,
+                                                "src");
+  auto* sink_pad = gst_pad_get_peer(source_pad);
+  if (sink_pad) {
+    g_object_set(G_OBJECT(selector_), "active-pad", sink_pad, NULL);
+    gst_object_unref(sink_pad);
+  }
+  gst_object_unref(source_pad);
+}
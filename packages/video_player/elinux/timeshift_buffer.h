@@ -0,0 +1,115 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_TIMESHIFT_BUFFER_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_TIMESHIFT_BUFFER_H_
+
+#include <gst/gst.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Keeps the last seconds of a live stream to play them back, e.g. to rewind
+// a camera.
+//
+// The encoded access units are kept rather than the decoded frames, so that
+// the memory is bounded by the bitrate times the window, e.g. 15 MB for 30
+// seconds at 4 Mbit/s. They are copied by reference from the output of the
+// parser, which passes them on to the decoder through an input-selector:
+//
+//   parse ! input-selector ! decoder
+//   appsrc !
+//
+// Playing back switches the selector to the appsrc, flushes the decoder and
+// replays the access units from the key frame at or before the requested
+// position at their original pace, shifted to the current running time.
+// Going back to live switches the selector back and waits for the next key
+// frame of the stream, which is requested from the sender.
+class TimeshiftBuffer {
+ public:
+  struct State {
+    // The length of the stream kept.
+    int64_t available_ms = 0;
+    // How far behind the live edge the stream is played, or zero if live.
+    int64_t delay_ms = 0;
+    int64_t bytes = 0;
+  };
+
+  // Keeps up to |window_ms| of the stream, and drops the oldest key frame
+  // intervals beyond |max_bytes|.
+  TimeshiftBuffer(int64_t window_ms, int64_t max_bytes);
+  ~TimeshiftBuffer();
+
+  // Prevent copying.
+  TimeshiftBuffer(TimeshiftBuffer const&) = delete;
+  TimeshiftBuffer& operator=(TimeshiftBuffer const&) = delete;
+
+  // Links |parse| to |decoder| through the selector in |pipeline|, and
+  // starts recording. |parse| must output whole access units with the
+  // delta unit flags.
+  bool Attach(GstElement* pipeline, GstElement* parse, GstElement* decoder);
+  // Removes the selector from the pipeline and drops the recorded stream.
+  void Detach();
+
+  // Plays the stream |delay_ms| behind the live edge, from the key frame at
+  // or before it, or live if zero. Returns false if nothing is recorded.
+  bool SetDelay(int64_t delay_ms);
+  State GetState();
+
+ private:
+  struct AccessUnit {
+    GstBuffer* buffer = nullptr;
+    // The monotonic time it was parsed at.
+    int64_t arrival_us = 0;
+    bool is_key = false;
+  };
+
+  // Records the access units, and drops them while playing back or until
+  // the next key frame after going back to live.
+  static GstPadProbeReturn OnParsedData(GstPad* pad, GstPadProbeInfo* info,
+                                        gpointer user_data);
+  void Record(GstBuffer* buffer);
+  void Clear();
+  void RunReplay();
+  // Clears the queue of the appsrc, and the decoder if the selector is on
+  // the appsrc.
+  void FlushReplay();
+  void SelectPad(bool replay);
+
+  const int64_t window_us_;
+  const int64_t max_bytes_;
+
+  // Held while pushing to |source_| and while switching the selector, so
+  // that no stale access unit is pushed after a flush. Taken before
+  // |mutex_|.
+  std::mutex mutex_push_;
+  GstElement* pipeline_ = nullptr;
+  GstElement* parse_ = nullptr;
+  GstElement* selector_ = nullptr;
+  GstElement* source_ = nullptr;
+  gulong probe_id_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<AccessUnit> units_;
+  // The sequence number of |units_.front()|.
+  uint64_t first_sequence_ = 0;
+  int64_t bytes_ = 0;
+  bool is_replaying_ = false;
+  // After going back to live.
+  bool is_waiting_for_key_ = false;
+  // The sequence number of the next access unit to replay.
+  uint64_t cursor_ = 0;
+  int64_t delay_us_ = 0;
+  // Changed by every SetDelay(), so that the replay thread drops the access
+  // unit it was about to push.
+  uint64_t generation_ = 0;
+  bool is_stopping_ = false;
+  std::thread replay_thread_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_TIMESHIFT_BUFFER_H_
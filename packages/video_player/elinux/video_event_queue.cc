@@ -0,0 +1,192 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "video_event_queue.h"
+
+#include <algorithm>
+
+namespace {
+// Bounds the memory of a stalled listener. Newer events are dropped once
+// the queue is full.
+constexpr size_t kMaxPendingEvents = 1024;
+constexpr size_t kHeaderSize = 8;
+
+template <typename T>
+uint8_t* WriteLittleEndian(uint8_t* data, T value) {
+  auto bits = static_cast<uint64_t>(value);
+  for (size_t i = 0; i < sizeof(T); i++) {
+    data[i] = static_cast<uint8_t>(bits >> (8 * i));
+  }
+  return data + sizeof(T);
+}
+}  // namespace
+
+VideoEventQueue::~VideoEventQueue() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  changed_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void VideoEventQueue::Start(int64_t interval_ms, Send send) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> send_lock(send_mutex_);
+    interval_ = std::chrono::milliseconds(std::max<int64_t>(interval_ms, 0));
+    send_ = std::move(send);
+    pending_.reserve(kMaxPendingEvents);
+    sending_.reserve(kMaxPendingEvents);
+    // Started by the first listener, so that apps that don't listen pay
+    // nothing.
+    if (!thread_.joinable()) {
+      thread_ = std::thread([this]() { Run(); });
+    }
+  }
+  changed_.notify_all();
+}
+
+void VideoEventQueue::Stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::lock_guard<std::mutex> send_lock(send_mutex_);
+  send_ = nullptr;
+  pending_.clear();
+  dropped_ = 0;
+}
+
+bool VideoEventQueue::IsStarted() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return send_ != nullptr;
+}
+
+void VideoEventQueue::Push(const Event& event) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!send_) {
+      return;
+    }
+    if (IsStateUpdate(event.type)) {
+      RemovePending(event.texture_id, event.type);
+    }
+    Append(event);
+  }
+  changed_.notify_all();
+}
+
+void VideoEventQueue::PushBufferedRanges(
+    int64_t texture_id,
+    const std::vector<std::pair<int64_t, int64_t>>& ranges) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!send_) {
+      return;
+    }
+    RemovePending(texture_id, Type::kBufferedRanges);
+    Event event;
+    event.texture_id = texture_id;
+    event.type = Type::kBufferedRanges;
+    event.values[2] = static_cast<int64_t>(ranges.size());
+    if (ranges.empty()) {
+      Append(event);
+    }
+    for (size_t i = 0; i < ranges.size(); i++) {
+      event.index = static_cast<int32_t>(i);
+      event.values[0] = ranges[i].first;
+      event.values[1] = ranges[i].second;
+      Append(event);
+    }
+  }
+  changed_.notify_all();
+}
+
+void VideoEventQueue::Remove(int64_t texture_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                [texture_id](const Event& event) {
+                                  return event.texture_id == texture_id;
+                                }),
+                 pending_.end());
+}
+
+// static
+bool VideoEventQueue::IsStateUpdate(Type type) {
+  switch (type) {
+    case Type::kIsPlaying:
+    case Type::kBuffering:
+    case Type::kBufferedRanges:
+    case Type::kPosition:
+    case Type::kThroughput:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void VideoEventQueue::RemovePending(int64_t texture_id, Type type) {
+  pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                [texture_id, type](const Event& event) {
+                                  return event.texture_id == texture_id &&
+                                         event.type == type;
+                                }),
+                 pending_.end());
+}
+
+void VideoEventQueue::Append(const Event& event) {
+  if (pending_.size() >= kMaxPendingEvents) {
+    dropped_++;
+    return;
+  }
+  if (pending_.empty()) {
+    first_pending_time_ = Clock::now();
+  }
+  pending_.push_back(event);
+}
+
+std::vector<uint8_t> VideoEventQueue::Encode(const std::vector<Event>& events,
+                                             uint32_t dropped) {
+  std::vector<uint8_t> batch(kHeaderSize + events.size() * kEventSize);
+  auto* data = WriteLittleEndian(batch.data(), kVersion);
+  data = WriteLittleEndian(data, dropped);
+  for (const auto& event : events) {
+    data = WriteLittleEndian(data, event.texture_id);
+    data = WriteLittleEndian(data, static_cast<int32_t>(event.type));
+    data = WriteLittleEndian(data, event.index);
+    for (const auto value : event.values) {
+      data = WriteLittleEndian(data, value);
+    }
+  }
+  return batch;
+}
+
+void VideoEventQueue::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!is_stopping_) {
+    if (!send_ || pending_.empty()) {
+      changed_.wait(lock);
+      continue;
+    }
+    // The events pushed meanwhile are coalesced into the same batch.
+    const auto send_time = first_pending_time_ + interval_;
+    if (Clock::now() < send_time) {
+      changed_.wait_until(lock, send_time);
+      continue;
+    }
+    sending_.swap(pending_);
+    const auto dropped = dropped_;
+    dropped_ = 0;
+    // Taken before |mutex_| is released, so that Stop() can't clear
+    // |send_| in between.
+    std::unique_lock<std::mutex> send_lock(send_mutex_);
+    lock.unlock();
+
+    send_(Encode(sending_, dropped));
+    sending_.clear();
+
+    send_lock.unlock();
+    lock.lock();
+  }
+}
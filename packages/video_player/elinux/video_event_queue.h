@@ -0,0 +1,110 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_EVENT_QUEUE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_EVENT_QUEUE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Collects the events of all the players and sends them in batches of
+// fixed-size binary records tagged with the texture id, on one channel
+// instead of a map per event on a channel per player. The state updates
+// of a player, e.g. its position, replace the pending one of the same type,
+// so a batch only carries the latest of them.
+//
+// A batch is a header of two uint32, the format version and the number of
+// events dropped since the previous batch, followed by the records, all
+// little endian.
+class VideoEventQueue {
+ public:
+  enum class Type : int32_t {
+    // values: duration, width, height.
+    kInitialized = 1,
+    kInitializationFailed,
+    kCompleted,
+    // values: is playing.
+    kIsPlaying,
+    // values: is buffering.
+    kBuffering,
+    // One event per range. index: index of the range, values: start, end,
+    // number of ranges. An update without ranges has one event with no
+    // range.
+    kBufferedRanges,
+    // values: position, duration, is buffering.
+    kPosition,
+    // values: width, height, bitrate, bandwidth.
+    kVariantSwitch,
+    // values: throughput, bandwidth.
+    kThroughput,
+  };
+
+  // 48 bytes in a batch.
+  struct Event {
+    int64_t texture_id = 0;
+    Type type = Type::kCompleted;
+    int32_t index = 0;
+    int64_t values[4] = {};
+  };
+
+  static constexpr uint32_t kVersion = 1;
+  static constexpr size_t kEventSize = 48;
+
+  using Send = std::function<void(std::vector<uint8_t> batch)>;
+
+  VideoEventQueue() = default;
+  ~VideoEventQueue();
+
+  // Prevent copying.
+  VideoEventQueue(VideoEventQueue const&) = delete;
+  VideoEventQueue& operator=(VideoEventQueue const&) = delete;
+
+  // Calls |send| with the pending events at most every |interval_ms|
+  // milliseconds, from a thread of the queue.
+  void Start(int64_t interval_ms, Send send);
+  // Drops the pending events. No |send| runs once this returns.
+  void Stop();
+  bool IsStarted();
+
+  void Push(const Event& event);
+  void PushBufferedRanges(
+      int64_t texture_id,
+      const std::vector<std::pair<int64_t, int64_t>>& ranges);
+  // Drops the pending events of |texture_id|, e.g. once it's disposed.
+  void Remove(int64_t texture_id);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  static bool IsStateUpdate(Type type);
+  // Must be called with |mutex_| held.
+  void RemovePending(int64_t texture_id, Type type);
+  void Append(const Event& event);
+  std::vector<uint8_t> Encode(const std::vector<Event>& events,
+                              uint32_t dropped);
+  void Run();
+
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::vector<Event> pending_;
+  // Swapped with |pending_|, so that the steady state allocates nothing
+  // but the batches.
+  std::vector<Event> sending_;
+  uint32_t dropped_ = 0;
+  Clock::time_point first_pending_time_;
+  std::chrono::milliseconds interval_{0};
+  Send send_;
+  // Held while sending, so that Stop() waits for a running send.
+  std::mutex send_mutex_;
+  std::thread thread_;
+  bool is_stopping_ = false;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_EVENT_QUEUE_H_
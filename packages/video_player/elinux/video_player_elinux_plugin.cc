@@ -14,10 +14,34 @@
 #include <flutter/standard_method_codec.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
-
+#include <utility>
+
+#include "asset_cache.h"
+#include "capability_registry.h"
+#include "download_cache.h"
+#include "frame_extractor.h"
+#include "frame_stream.h"
+#include "gst_runtime.h"
+#include "position_ticker.h"
 #include "gst_video_player.h"
 #include "messages/messages.h"
+#include "multi_stream_scheduler.h"
+#include "platform_task_queue.h"
+#include "plugin_stats_channel.h"
+#include "sprite_sheet_generator.h"
+#include "thread_policy.h"
+#include "trace_event.h"
+#include "video_event_queue.h"
+#include "video_player_pool.h"
 #include "video_player_stream_handler_impl.h"
 
 namespace {
@@ -27,6 +51,10 @@ constexpr char kVideoPlayerApiChannelSetMixWithOthersName[] =
     "dev.flutter.pigeon.VideoPlayerApi.setMixWithOthers";
 constexpr char kVideoPlayerApiChannelCreateName[] =
     "dev.flutter.pigeon.VideoPlayerApi.create";
+constexpr char kVideoPlayerApiChannelPreloadName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.preload";
+constexpr char kVideoPlayerApiChannelCreateCompositorName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.createCompositor";
 constexpr char kVideoPlayerApiChannelDisposeName[] =
     "dev.flutter.pigeon.VideoPlayerApi.dispose";
 constexpr char kVideoPlayerApiChannelSetLoopingName[] =
@@ -44,9 +72,102 @@ constexpr char kVideoPlayerApiChannelSetPlaybackSpeedName[] =
 constexpr char kVideoPlayerApiChannelSeekToName[] =
     "dev.flutter.pigeon.VideoPlayerApi.seekTo";
 
+constexpr char kVideoPlayerApiChannelSetLatencyBudgetName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setLatencyBudget";
+
+constexpr char kVideoPlayerApiChannelSetMultiStreamModeName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setMultiStreamMode";
+
+constexpr char kVideoPlayerApiChannelSetKeyFrameOnlyName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setKeyFrameOnly";
+constexpr char kVideoPlayerApiChannelSetTrackSelectionName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setTrackSelection";
+constexpr char kVideoPlayerApiChannelSetSubtitlesName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setSubtitles";
+constexpr char kVideoPlayerApiChannelSetQosName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setQos";
+
+constexpr char kVideoPlayerApiChannelSetCompositorLayoutName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setCompositorLayout";
+
+constexpr char kVideoPlayerApiChannelSetPrerollTimeoutName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setPrerollTimeout";
+
+constexpr char kVideoPlayerApiChannelSetPlayerPoolSizeName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setPlayerPoolSize";
+
+constexpr char kVideoPlayerApiChannelSetIdleThrottleName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setIdleThrottle";
+
+constexpr char kVideoPlayerApiChannelGetTransportStatsName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.getTransportStats";
+
+constexpr char kVideoPlayerApiChannelGetStatsName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.getStats";
+
+constexpr char kVideoPlayerApiChannelSetTimeshiftDelayName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setTimeshiftDelay";
+
+constexpr char kVideoPlayerApiChannelGetTimeshiftName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.getTimeshift";
+
+constexpr char kVideoPlayerApiChannelSetScrubbingName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setScrubbing";
+
+constexpr char kVideoPlayerApiChannelGetCapabilitiesName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.getCapabilities";
+
+constexpr char kVideoPlayerApiChannelExtractFramesName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.extractFrames";
+
+constexpr char kVideoPlayerApiChannelCaptureFrameName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.captureFrame";
+
+constexpr char kVideoPlayerApiChannelGenerateSpriteSheetName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.generateSpriteSheet";
+
+constexpr char kVideoPlayerApiChannelGetPositionsName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.getPositions";
+
+constexpr char kVideoPlayerApiChannelSetPositionTickName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setPositionTick";
+
+constexpr char kVideoPlayerApiChannelSetDownloadCacheName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setDownloadCache";
+
+constexpr char kVideoPlayerApiChannelSetAbrPolicyName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setAbrPolicy";
+
+constexpr char kVideoPlayerApiChannelSetThreadPolicyName[] =
+    "dev.flutter.pigeon.VideoPlayerApi.setThreadPolicy";
+
 constexpr char kVideoPlayerVideoEventsChannelName[] =
     "flutter.io/videoPlayer/videoEvents";
 
+constexpr char kVideoPlayerFrameStreamChannelName[] =
+    "flutter.io/videoPlayer/frameStream";
+
+constexpr char kVideoPlayerEventsChannelName[] =
+    "flutter.io/videoPlayer/events";
+
+constexpr char kVideoPlayerPlatformTasksChannelName[] =
+    "flutter.io/videoPlayer/platformTasks";
+
+// How long the events of the multiplexed stream are coalesced before being
+// sent, about a frame at 60 Hz.
+constexpr int64_t kDefaultEventIntervalMs = 16;
+
+// How long a player may take to preroll before its creation fails.
+constexpr int64_t kDefaultPrerollTimeoutMs = 10000;
+
+// How many frames a texture may leave unfetched before its decoder only
+// decodes the key frames, about a second.
+constexpr int64_t kDefaultIdleThrottleFrames = 30;
+
+// The captures of all the players share these threads.
+constexpr size_t kCaptureThreadCount = 2;
+constexpr size_t kMaxQueuedCaptures = 8;
+
 constexpr char kEncodableMapkeyResult[] = "result";
 constexpr char kEncodableMapkeyError[] = "error";
 
@@ -57,22 +178,48 @@ class VideoPlayerPlugin : public flutter::Plugin {
   VideoPlayerPlugin(flutter::PluginRegistrar* plugin_registrar,
                     flutter::TextureRegistrar* texture_registrar)
       : plugin_registrar_(plugin_registrar),
-        texture_registrar_(texture_registrar) {
-    // Needs to call 'gst_init' that initializing the GStreamer library before
-    // using it.
-    GstVideoPlayer::GstLibraryLoad();
+        texture_registrar_(texture_registrar),
+        plugin_stats_channel_(plugin_registrar),
+        platform_tasks_(plugin_registrar->messenger(),
+                        kVideoPlayerPlatformTasksChannelName) {
+    // Waited for by the first call from Dart, see LoadGstLibrary().
+    GstRuntime::StartInit();
+    SetUpEventsChannel();
   }
   virtual ~VideoPlayerPlugin() {
+    events_channel_->SetStreamHandler(nullptr);
+    event_queue_.Stop();
     for (auto itr = players_.begin(); itr != players_.end();) {
       auto texture_id = itr->first;
       DisposePlayer(texture_id);
       itr = players_.erase(itr);
     }
+    player_pool_.Clear();
+    multi_stream_scheduler_ = nullptr;
+    frame_extractor_ = nullptr;
+    sprite_sheet_generator_ = nullptr;
 
-    GstVideoPlayer::GstLibraryUnload();
+    if (is_gst_library_loaded_) {
+      GstVideoPlayer::GstLibraryUnload();
+    }
   }
 
  private:
+  // Needs to call 'gst_init' that initializing the GStreamer library before
+  // using it.
+  void LoadGstLibrary() {
+    if (!is_gst_library_loaded_) {
+      GstVideoPlayer::GstLibraryLoad();
+      is_gst_library_loaded_ = true;
+    }
+  }
+
+  enum class InitState {
+    kPending,
+    kInitialized,
+    kFailed,
+  };
+
   struct FlutterVideoPlayer {
     int64_t texture_id;
     std::unique_ptr<GstVideoPlayer> player;
@@ -83,7 +230,23 @@ class VideoPlayerPlugin : public flutter::Plugin {
 #endif  // USE_EGL_IMAGE_DMABUF
     std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>>
         event_channel;
+    // Only used on the platform thread, like the other sinks.
     std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> event_sink;
+    // Created while the multiplexed stream was listened to, so its events
+    // are sent to |event_queue_| instead, and it has no |event_channel|.
+    bool is_multiplexed = false;
+    // Prerolls |player| so that creating it doesn't block the platform
+    // thread.
+    std::thread init_thread;
+    // Guards |init_state| against |init_thread|.
+    std::mutex event_mutex;
+    InitState init_state = InitState::kPending;
+    // Sends the frames to Dart while it listens to the channel.
+    std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>>
+        frame_stream_channel;
+    std::unique_ptr<flutter::EventSink<flutter::EncodableValue>>
+        frame_stream_sink;
+    std::unique_ptr<FrameStream> frame_stream;
   };
 
   void HandleInitializeMethodCall(
@@ -92,6 +255,12 @@ class VideoPlayerPlugin : public flutter::Plugin {
   void HandleCreateMethodCall(
       const flutter::EncodableValue& message,
       flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleCreateCompositorMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandlePreloadMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
   void HandleDisposeMethodCall(
       const flutter::EncodableValue& message,
       flutter::MessageReply<flutter::EncodableValue> reply);
@@ -116,25 +285,168 @@ class VideoPlayerPlugin : public flutter::Plugin {
   void HandleSeekToMethodCall(
       const flutter::EncodableValue& message,
       flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetScrubbingMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleGetCapabilitiesMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleExtractFramesMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleCaptureFrameMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleGenerateSpriteSheetMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleGetPositionsMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetPositionTickMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetDownloadCacheMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetAbrPolicyMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetThreadPolicyMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
   void HandlePositionMethodCall(
       const flutter::EncodableValue& message,
       flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetLatencyBudgetMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetMultiStreamModeMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetKeyFrameOnlyMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetTrackSelectionMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetSubtitlesMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetQosMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetCompositorLayoutMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetPrerollTimeoutMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetPlayerPoolSizeMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetIdleThrottleMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleGetTransportStatsMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleGetStatsMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetTimeshiftDelayMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleGetTimeshiftMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
 
-  void SendInitializedEventMessage(int64_t texture_id);
-  void SendPlayCompletedEventMessage(int64_t texture_id);
-  void SendIsPlayingStateUpdate(int64_t texture_id, bool is_playing);
-
+  // Runs |send| with the player of |texture_id| on the platform thread,
+  // unless it's disposed by then. The threads of the players post the
+  // events with it, since the sinks must be used on the platform thread.
+  void PostToPlayer(int64_t texture_id,
+                    std::function<void(FlutterVideoPlayer*)> send);
+  // The Send* methods below are called on the platform thread.
+  // Sends the result of the initialization, if it is known yet.
+  void SendInitializedEventMessage(FlutterVideoPlayer* instance);
+  void SendPlayCompletedEventMessage(FlutterVideoPlayer* instance);
+  void SendIsPlayingStateUpdate(FlutterVideoPlayer* instance, bool is_playing);
+  void SendBufferingUpdate(FlutterVideoPlayer* instance, bool is_buffering);
+  void SendBufferedRangesUpdate(
+      FlutterVideoPlayer* instance,
+      const std::vector<std::pair<int64_t, int64_t>>& ranges);
+  void SendVariantSwitch(FlutterVideoPlayer* instance, int32_t width,
+                         int32_t height, int64_t bitrate);
+  void SendThroughput(FlutterVideoPlayer* instance, int64_t throughput,
+                      int64_t bandwidth);
+  // Only sent on the event channel of the player, as a batch of the event
+  // queue has no room for them.
+  void SendSubtitleCue(FlutterVideoPlayer* instance, const std::string& text,
+                       bool is_markup, int64_t start_ms, int64_t duration_ms);
+  void SendOverlay(
+      FlutterVideoPlayer* instance,
+      const std::vector<VideoPlayerStreamHandler::OverlayRectangle>&
+          rectangles);
+  void PushEvent(FlutterVideoPlayer* instance, VideoEventQueue::Type type,
+                 std::initializer_list<int64_t> values = {});
+  // Sets up the channel that multiplexes the events of the players.
+  void SetUpEventsChannel();
+
+  using PlayerFactory = std::function<std::unique_ptr<GstVideoPlayer>(
+      std::unique_ptr<VideoPlayerStreamHandler> handler)>;
+  // Registers a texture and an event channel for the player made by
+  // |factory| and replies with the texture id.
+  void CreatePlayer(const PlayerFactory& factory,
+                    flutter::MessageReply<flutter::EncodableValue> reply);
   void DisposePlayer(int64_t texture_id);
+  // Replies with an error if the player of the texture id in |message| is
+  // still prerolling on its |init_thread|, or failed to, since its pipeline
+  // can't be used until then.
+  bool ReplyIfNotInitialized(
+      const flutter::EncodableValue& message,
+      const flutter::MessageReply<flutter::EncodableValue>& reply);
+  void StartFrameStream(FlutterVideoPlayer* instance,
+                        const flutter::EncodableValue* arguments);
+  void StopFrameStream(FlutterVideoPlayer* instance);
+  PlayerPosition GetPlayerPosition(FlutterVideoPlayer* instance);
+  // Queries the position on the ticker thread, and sends it on the event
+  // channel from the platform thread.
+  void SendPositionUpdate(FlutterVideoPlayer* instance);
 
   flutter::EncodableValue WrapError(const std::string& message,
                                     const std::string& code = std::string(),
                                     const std::string& details = std::string());
 
   const std::string GetExecutableDirectory();
+  std::string GetUri(const CreateMessage& meta);
 
   flutter::PluginRegistrar* plugin_registrar_;
   flutter::TextureRegistrar* texture_registrar_;
+  PluginStatsChannel plugin_stats_channel_;
+  // Declared before the members whose threads post to it, so that it is
+  // destroyed after them.
+  PlatformTaskQueue platform_tasks_;
   std::unordered_map<int64_t, std::unique_ptr<FlutterVideoPlayer>> players_;
+  // Created on the first setMultiStreamMode call and kept until the plugin
+  // is destroyed, since the attached players share its task pool.
+  std::unique_ptr<MultiStreamScheduler> multi_stream_scheduler_;
+  bool multi_stream_mode_ = false;
+  int64_t preroll_timeout_ms_ = kDefaultPrerollTimeoutMs;
+  int64_t idle_throttle_frames_ = kDefaultIdleThrottleFrames;
+  VideoPlayerPool player_pool_;
+  // Created on the first extractFrames call.
+  std::unique_ptr<FrameExtractor> frame_extractor_;
+  // Created on the first generateSpriteSheet call.
+  std::unique_ptr<SpriteSheetGenerator> sprite_sheet_generator_;
+  // Created on the first captureFrame call.
+  std::unique_ptr<FrameCapturePool> frame_capture_pool_;
+  PositionTicker position_ticker_;
+  std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>>
+      events_channel_;
+  std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> events_sink_;
+  VideoEventQueue event_queue_;
+  // Whether GStreamer was initialized for the plugin, on the first call.
+  bool is_gst_library_loaded_ = false;
 };
 
 // static
@@ -143,124 +455,97 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
   auto plugin = std::make_unique<VideoPlayerPlugin>(
       registrar, registrar->texture_registrar());
 
-  {
-    auto channel =
-        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelInitializeName,
-            &flutter::StandardMessageCodec::GetInstance());
-    channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandleInitializeMethodCall(message, reply);
-        });
-  }
-
-  {
-    auto channel =
-        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelCreateName,
-            &flutter::StandardMessageCodec::GetInstance());
-    channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandleCreateMethodCall(message, reply);
-        });
-  }
-
-  {
-    auto channel =
-        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelDisposeName,
-            &flutter::StandardMessageCodec::GetInstance());
-    channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandleDisposeMethodCall(message, reply);
-        });
-  }
-
-  {
-    auto channel =
-        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelPauseName,
-            &flutter::StandardMessageCodec::GetInstance());
-    channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandlePauseMethodCall(message, reply);
-        });
-  }
-
-  {
-    auto channel =
-        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelPlayName,
-            &flutter::StandardMessageCodec::GetInstance());
-    channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandlePlayMethodCall(message, reply);
-        });
-  }
-
-  {
-    auto channel =
-        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelSetLoopingName,
-            &flutter::StandardMessageCodec::GetInstance());
-    channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandleSetLoopingMethodCall(message, reply);
-        });
-  }
-
-  {
-    auto channel =
-        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelSetVolumeName,
-            &flutter::StandardMessageCodec::GetInstance());
-    channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandleSetVolumeMethodCall(message, reply);
-        });
-  }
-
-  {
-    auto channel =
-        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelSetMixWithOthersName,
-            &flutter::StandardMessageCodec::GetInstance());
-    channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandleSetMixWithOthersMethodCall(message, reply);
-        });
-  }
-
-  {
-    auto channel =
-        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelSetPlaybackSpeedName,
-            &flutter::StandardMessageCodec::GetInstance());
-    channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandleSetPlaybackSpeedMethodCall(message, reply);
-        });
-  }
-
-  {
-    auto channel =
-        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelSeekToName,
-            &flutter::StandardMessageCodec::GetInstance());
-    channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandleSeekToMethodCall(message, reply);
-        });
-  }
-
-  {
+  // The handlers of the API, each on a channel of its own. GStreamer is
+  // initialized by the first call, meanwhile in the background.
+  using Handler = void (VideoPlayerPlugin::*)(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  const std::pair<const char*, Handler> handlers[] = {
+      {kVideoPlayerApiChannelInitializeName,
+       &VideoPlayerPlugin::HandleInitializeMethodCall},
+      {kVideoPlayerApiChannelCreateName,
+       &VideoPlayerPlugin::HandleCreateMethodCall},
+      {kVideoPlayerApiChannelPreloadName,
+       &VideoPlayerPlugin::HandlePreloadMethodCall},
+      {kVideoPlayerApiChannelCreateCompositorName,
+       &VideoPlayerPlugin::HandleCreateCompositorMethodCall},
+      {kVideoPlayerApiChannelDisposeName,
+       &VideoPlayerPlugin::HandleDisposeMethodCall},
+      {kVideoPlayerApiChannelPauseName,
+       &VideoPlayerPlugin::HandlePauseMethodCall},
+      {kVideoPlayerApiChannelPlayName,
+       &VideoPlayerPlugin::HandlePlayMethodCall},
+      {kVideoPlayerApiChannelSetLoopingName,
+       &VideoPlayerPlugin::HandleSetLoopingMethodCall},
+      {kVideoPlayerApiChannelSetVolumeName,
+       &VideoPlayerPlugin::HandleSetVolumeMethodCall},
+      {kVideoPlayerApiChannelSetMixWithOthersName,
+       &VideoPlayerPlugin::HandleSetMixWithOthersMethodCall},
+      {kVideoPlayerApiChannelSetPlaybackSpeedName,
+       &VideoPlayerPlugin::HandleSetPlaybackSpeedMethodCall},
+      {kVideoPlayerApiChannelSeekToName,
+       &VideoPlayerPlugin::HandleSeekToMethodCall},
+      {kVideoPlayerApiChannelPositionName,
+       &VideoPlayerPlugin::HandlePositionMethodCall},
+      {kVideoPlayerApiChannelSetLatencyBudgetName,
+       &VideoPlayerPlugin::HandleSetLatencyBudgetMethodCall},
+      {kVideoPlayerApiChannelSetMultiStreamModeName,
+       &VideoPlayerPlugin::HandleSetMultiStreamModeMethodCall},
+      {kVideoPlayerApiChannelSetKeyFrameOnlyName,
+       &VideoPlayerPlugin::HandleSetKeyFrameOnlyMethodCall},
+      {kVideoPlayerApiChannelSetTrackSelectionName,
+       &VideoPlayerPlugin::HandleSetTrackSelectionMethodCall},
+      {kVideoPlayerApiChannelSetSubtitlesName,
+       &VideoPlayerPlugin::HandleSetSubtitlesMethodCall},
+      {kVideoPlayerApiChannelSetQosName,
+       &VideoPlayerPlugin::HandleSetQosMethodCall},
+      {kVideoPlayerApiChannelSetCompositorLayoutName,
+       &VideoPlayerPlugin::HandleSetCompositorLayoutMethodCall},
+      {kVideoPlayerApiChannelSetPrerollTimeoutName,
+       &VideoPlayerPlugin::HandleSetPrerollTimeoutMethodCall},
+      {kVideoPlayerApiChannelSetPlayerPoolSizeName,
+       &VideoPlayerPlugin::HandleSetPlayerPoolSizeMethodCall},
+      {kVideoPlayerApiChannelSetIdleThrottleName,
+       &VideoPlayerPlugin::HandleSetIdleThrottleMethodCall},
+      {kVideoPlayerApiChannelGetTransportStatsName,
+       &VideoPlayerPlugin::HandleGetTransportStatsMethodCall},
+      {kVideoPlayerApiChannelGetStatsName,
+       &VideoPlayerPlugin::HandleGetStatsMethodCall},
+      {kVideoPlayerApiChannelSetTimeshiftDelayName,
+       &VideoPlayerPlugin::HandleSetTimeshiftDelayMethodCall},
+      {kVideoPlayerApiChannelGetTimeshiftName,
+       &VideoPlayerPlugin::HandleGetTimeshiftMethodCall},
+      {kVideoPlayerApiChannelSetScrubbingName,
+       &VideoPlayerPlugin::HandleSetScrubbingMethodCall},
+      {kVideoPlayerApiChannelGetCapabilitiesName,
+       &VideoPlayerPlugin::HandleGetCapabilitiesMethodCall},
+      {kVideoPlayerApiChannelExtractFramesName,
+       &VideoPlayerPlugin::HandleExtractFramesMethodCall},
+      {kVideoPlayerApiChannelCaptureFrameName,
+       &VideoPlayerPlugin::HandleCaptureFrameMethodCall},
+      {kVideoPlayerApiChannelGenerateSpriteSheetName,
+       &VideoPlayerPlugin::HandleGenerateSpriteSheetMethodCall},
+      {kVideoPlayerApiChannelGetPositionsName,
+       &VideoPlayerPlugin::HandleGetPositionsMethodCall},
+      {kVideoPlayerApiChannelSetPositionTickName,
+       &VideoPlayerPlugin::HandleSetPositionTickMethodCall},
+      {kVideoPlayerApiChannelSetDownloadCacheName,
+       &VideoPlayerPlugin::HandleSetDownloadCacheMethodCall},
+      {kVideoPlayerApiChannelSetAbrPolicyName,
+       &VideoPlayerPlugin::HandleSetAbrPolicyMethodCall},
+      {kVideoPlayerApiChannelSetThreadPolicyName,
+       &VideoPlayerPlugin::HandleSetThreadPolicyMethodCall},
+  };
+  for (const auto& [name, handler] : handlers) {
     auto channel =
         std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
-            registrar->messenger(), kVideoPlayerApiChannelPositionName,
+            registrar->messenger(), name,
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
-        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
-          plugin_pointer->HandlePositionMethodCall(message, reply);
+        [plugin_pointer = plugin.get(), handler = handler](
+            const auto& message, auto reply) {
+          plugin_pointer->LoadGstLibrary();
+          (plugin_pointer->*handler)(message, reply);
         });
   }
 
@@ -290,15 +575,72 @@ void VideoPlayerPlugin::HandleCreateMethodCall(
     const flutter::EncodableValue& message,
     flutter::MessageReply<flutter::EncodableValue> reply) {
   auto meta = CreateMessage::FromMap(message);
-  std::string uri;
-  if (!meta.GetAsset().empty()) {
-    // todo: gets propery path of the Flutter project.
-    std::string flutter_project_path = GetExecutableDirectory() + "/data/";
-    uri = flutter_project_path + "flutter_assets/" + meta.GetAsset();
-  } else {
-    uri = meta.GetUri();
-  }
+  const auto uri = GetUri(meta);
+  const auto transport_name = meta.GetRtspTransport();
+  const auto timeshift_window = meta.GetTimeshiftWindow();
+  GstVideoPlayer::FileOptions file_options;
+  file_options.fast_start = meta.GetFastStart();
+  file_options.muted = meta.GetMuted();
+  CreatePlayer(
+      [&uri, &transport_name, timeshift_window, &file_options,
+       host = this](std::unique_ptr<VideoPlayerStreamHandler> handler) {
+        // The pooled players are built without the file options, and
+        // without a timeshift buffer.
+        auto player = file_options.fast_start || file_options.muted ||
+                               timeshift_window > 0
+                           ? nullptr
+                           : host->player_pool_.Acquire(uri);
+        if (!player) {
+          player = std::make_unique<GstVideoPlayer>(uri, std::move(handler),
+                                                    file_options);
+        } else {
+          player->SetStreamHandler(std::move(handler));
+        }
+        if (!transport_name.empty()) {
+          GstVideoPlayer::RtspTransport transport;
+          if (GstVideoPlayer::ParseRtspTransport(transport_name, transport)) {
+            player->SetRtspTransport(transport);
+          } else {
+            std::cerr << "Unknown RTSP transport: " << transport_name
+                      << std::endl;
+          }
+        }
+        if (timeshift_window > 0) {
+          player->EnableTimeshift(timeshift_window);
+        }
+        return player;
+      },
+      reply);
+}
+
+void VideoPlayerPlugin::HandlePreloadMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto meta = CreateMessage::FromMap(message);
+  player_pool_.Preload(GetUri(meta), preroll_timeout_ms_);
+
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleCreateCompositorMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto meta = CreateCompositorMessage::FromMap(message);
+  CreatePlayer(
+      [&meta](std::unique_ptr<VideoPlayerStreamHandler> handler) {
+        return std::make_unique<GstVideoPlayer>(
+            meta.GetUris(), static_cast<int32_t>(meta.GetWidth()),
+            static_cast<int32_t>(meta.GetHeight()), std::move(handler));
+      },
+      reply);
+}
 
+void VideoPlayerPlugin::CreatePlayer(
+    const PlayerFactory& factory,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
   auto instance = std::make_unique<FlutterVideoPlayer>();
 #ifdef USE_EGL_IMAGE_DMABUF
   instance->egl_image = std::make_unique<FlutterDesktopEGLImage>();
@@ -307,9 +649,11 @@ void VideoPlayerPlugin::HandleCreateMethodCall(
           [instance = instance.get()](
               size_t width, size_t height, void* egl_display,
               void* egl_context) -> const FlutterDesktopEGLImage* {
+            TRACE_SCOPE("video_player", "EGLImageTexture");
             if (!instance->player) {
               return nullptr;
             }
+            instance->player->RequestOutputSize(width, height);
             instance->egl_image->width = instance->player->GetWidth();
             instance->egl_image->height = instance->player->GetHeight();
             instance->egl_image->egl_image =
@@ -322,19 +666,28 @@ void VideoPlayerPlugin::HandleCreateMethodCall(
       std::make_unique<flutter::TextureVariant>(flutter::PixelBufferTexture(
           [instance = instance.get()](
               size_t width, size_t height) -> const FlutterDesktopPixelBuffer* {
+            TRACE_SCOPE("video_player", "PixelBufferTexture");
             if (!instance->player) {
               return nullptr;
             }
-            instance->buffer->width = instance->player->GetWidth();
-            instance->buffer->height = instance->player->GetHeight();
-            instance->buffer->buffer = instance->player->GetFrameBuffer();
+            instance->player->RequestOutputSize(width, height);
+            // Maps the decoded frame directly when possible. The engine
+            // invokes the release callback once it has uploaded the pixels.
+            instance->buffer->buffer = instance->player->GetFrameBuffer(
+                instance->buffer->width, instance->buffer->height,
+                &instance->buffer->release_context);
+            instance->buffer->release_callback =
+                instance->buffer->release_context
+                    ? &GstVideoPlayer::ReleaseFrameBuffer
+                    : nullptr;
             return instance->buffer.get();
           }));
 #endif  // USE_EGL_IMAGE_DMABUF
   const auto texture_id =
       texture_registrar_->RegisterTexture(instance->texture.get());
   instance->texture_id = texture_id;
-  {
+  instance->is_multiplexed = event_queue_.IsStarted();
+  if (!instance->is_multiplexed) {
     auto event_channel =
         std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
             plugin_registrar_->messenger(),
@@ -349,7 +702,7 @@ void VideoPlayerPlugin::HandleCreateMethodCall(
             -> std::unique_ptr<
                 flutter::StreamHandlerError<flutter::EncodableValue>> {
           instance->event_sink = std::move(events);
-          host->SendInitializedEventMessage(instance->texture_id);
+          host->SendInitializedEventMessage(instance);
           return nullptr;
         },
         [instance = instance.get()](const flutter::EncodableValue* arguments)
@@ -361,42 +714,141 @@ void VideoPlayerPlugin::HandleCreateMethodCall(
     event_channel->SetStreamHandler(std::move(event_channel_handler));
     instance->event_channel = std::move(event_channel);
   }
+  {
+    auto frame_stream_channel =
+        std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
+            plugin_registrar_->messenger(),
+            kVideoPlayerFrameStreamChannelName + std::to_string(texture_id),
+            &flutter::StandardMethodCodec::GetInstance());
+    auto frame_stream_handler = std::make_unique<
+        flutter::StreamHandlerFunctions<flutter::EncodableValue>>(
+        [instance = instance.get(), host = this](
+            const flutter::EncodableValue* arguments,
+            std::unique_ptr<flutter::EventSink<flutter::EncodableValue>>&&
+                events)
+            -> std::unique_ptr<
+                flutter::StreamHandlerError<flutter::EncodableValue>> {
+          instance->frame_stream_sink = std::move(events);
+          host->StartFrameStream(instance, arguments);
+          return nullptr;
+        },
+        [instance = instance.get(), host = this](
+            const flutter::EncodableValue* arguments)
+            -> std::unique_ptr<
+                flutter::StreamHandlerError<flutter::EncodableValue>> {
+          host->StopFrameStream(instance);
+          return nullptr;
+        });
+    frame_stream_channel->SetStreamHandler(std::move(frame_stream_handler));
+    instance->frame_stream_channel = std::move(frame_stream_channel);
+  }
   {
     auto player_handler = std::make_unique<VideoPlayerStreamHandlerImpl>(
         // OnNotifyInitialized
         [texture_id, host = this]() {
-          host->SendInitializedEventMessage(texture_id);
+          host->PostToPlayer(texture_id, [host](FlutterVideoPlayer* instance) {
+            host->SendInitializedEventMessage(instance);
+          });
         },
         // OnNotifyFrameDecoded
         [texture_id, host = this]() {
+          TRACE_SCOPE("video_player", "MarkTextureFrameAvailable");
           host->texture_registrar_->MarkTextureFrameAvailable(texture_id);
         },
-        // OnNotifyCompleted
+        // OnNotifyCompleted, called from the bus bridge thread.
         [texture_id, host = this]() {
-          host->SendPlayCompletedEventMessage(texture_id);
+          host->PostToPlayer(texture_id, [host](FlutterVideoPlayer* instance) {
+            host->SendPlayCompletedEventMessage(instance);
+          });
         },
         [texture_id, host = this](bool is_playing) {
-          host->SendIsPlayingStateUpdate(texture_id, is_playing);
+          host->PostToPlayer(
+              texture_id, [host, is_playing](FlutterVideoPlayer* instance) {
+                host->SendIsPlayingStateUpdate(instance, is_playing);
+              });
+        },
+        // OnNotifyBuffering, called from the reconnect supervisor thread.
+        [texture_id, host = this](bool is_buffering) {
+          host->PostToPlayer(
+              texture_id, [host, is_buffering](FlutterVideoPlayer* instance) {
+                host->SendBufferingUpdate(instance, is_buffering);
+              });
+        },
+        // OnNotifyBufferingUpdate, called from the bus bridge thread.
+        [texture_id, host = this](
+            const std::vector<std::pair<int64_t, int64_t>>& ranges) {
+          host->PostToPlayer(
+              texture_id, [host, ranges](FlutterVideoPlayer* instance) {
+                host->SendBufferedRangesUpdate(instance, ranges);
+              });
+        },
+        // OnNotifyVariantSwitch, called from a streaming thread.
+        [texture_id, host = this](int32_t width, int32_t height,
+                                  int64_t bitrate) {
+          host->PostToPlayer(texture_id, [host, width, height, bitrate](
+                                             FlutterVideoPlayer* instance) {
+            host->SendVariantSwitch(instance, width, height, bitrate);
+          });
+        },
+        // OnNotifyThroughput, called from the bus bridge thread.
+        [texture_id, host = this](int64_t throughput, int64_t bandwidth) {
+          host->PostToPlayer(texture_id, [host, throughput, bandwidth](
+                                             FlutterVideoPlayer* instance) {
+            host->SendThroughput(instance, throughput, bandwidth);
+          });
+        },
+        // OnNotifySubtitleCue, called from a streaming thread.
+        [texture_id, host = this](const std::string& text, bool is_markup,
+                                  int64_t start_ms, int64_t duration_ms) {
+          host->PostToPlayer(
+              texture_id, [host, text, is_markup, start_ms,
+                           duration_ms](FlutterVideoPlayer* instance) {
+                host->SendSubtitleCue(instance, text, is_markup, start_ms,
+                                      duration_ms);
+              });
+        },
+        // OnNotifyOverlay, called from a streaming thread.
+        [texture_id, host = this](
+            const std::vector<VideoPlayerStreamHandler::OverlayRectangle>&
+                rectangles) {
+          host->PostToPlayer(
+              texture_id, [host, rectangles](FlutterVideoPlayer* instance) {
+                host->SendOverlay(instance, rectangles);
+              });
+        });
+    instance->player = factory(std::move(player_handler));
+    instance->player->GetStats().SetId(std::to_string(texture_id));
+    if (multi_stream_mode_ && instance->player->IsLive()) {
+      multi_stream_scheduler_->Attach(instance->player.get());
+    }
+    instance->player->SetPrerollTimeout(preroll_timeout_ms_);
+    instance->player->SetIdleThrottle(
+        static_cast<int>(idle_throttle_frames_));
+
+    // Replies with the texture id right away. The result of the preroll is
+    // sent on the event channel, so that an unreachable stream doesn't
+    // block the UI and several streams preroll in parallel.
+    instance->init_thread =
+        std::thread([instance = instance.get(), host = this]() {
+          const bool ok = instance->player->Init();
+          {
+            std::lock_guard<std::mutex> lock(instance->event_mutex);
+            instance->init_state =
+                ok ? InitState::kInitialized : InitState::kFailed;
+          }
+          host->PostToPlayer(instance->texture_id,
+                             [host](FlutterVideoPlayer* instance) {
+                               host->SendInitializedEventMessage(instance);
+                             });
         });
-    instance->player =
-        std::make_unique<GstVideoPlayer>(uri, std::move(player_handler));
     players_[texture_id] = std::move(instance);
   }
 
   flutter::EncodableMap value;
   TextureMessage result;
-
-  bool ok = players_[texture_id]->player->Init();
-  if (ok) {
-    result.SetTextureId(texture_id);
-    value.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
-                  result.ToMap());
-  } else {
-    auto error_message = "Failed to initialize the player with texture id: " +
-                         std::to_string(texture_id);
-    value.emplace(flutter::EncodableValue(kEncodableMapkeyError),
-                  flutter::EncodableValue(WrapError(error_message)));
-  }
+  result.SetTextureId(texture_id);
+  value.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                result.ToMap());
   reply(flutter::EncodableValue(value));
 }
 
@@ -424,6 +876,9 @@ void VideoPlayerPlugin::HandleDisposeMethodCall(
 void VideoPlayerPlugin::HandlePauseMethodCall(
     const flutter::EncodableValue& message,
     flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
   auto parameter = TextureMessage::FromMap(message);
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
@@ -444,6 +899,9 @@ void VideoPlayerPlugin::HandlePauseMethodCall(
 void VideoPlayerPlugin::HandlePlayMethodCall(
     const flutter::EncodableValue& message,
     flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
   auto parameter = TextureMessage::FromMap(message);
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
@@ -464,6 +922,9 @@ void VideoPlayerPlugin::HandlePlayMethodCall(
 void VideoPlayerPlugin::HandleSetLoopingMethodCall(
     const flutter::EncodableValue& message,
     flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
   auto parameter = LoopingMessage::FromMap(message);
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
@@ -484,6 +945,9 @@ void VideoPlayerPlugin::HandleSetLoopingMethodCall(
 void VideoPlayerPlugin::HandleSetVolumeMethodCall(
     const flutter::EncodableValue& message,
     flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
   auto parameter = VolumeMessage::FromMap(message);
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
@@ -515,6 +979,9 @@ void VideoPlayerPlugin::HandleSetMixWithOthersMethodCall(
 void VideoPlayerPlugin::HandlePositionMethodCall(
     const flutter::EncodableValue& message,
     flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
   auto parameter = TextureMessage::FromMap(message);
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
@@ -545,6 +1012,9 @@ void VideoPlayerPlugin::HandlePositionMethodCall(
 void VideoPlayerPlugin::HandleSetPlaybackSpeedMethodCall(
     const flutter::EncodableValue& message,
     flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
   auto parameter = PlaybackSpeedMessage::FromMap(message);
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
@@ -565,12 +1035,21 @@ void VideoPlayerPlugin::HandleSetPlaybackSpeedMethodCall(
 void VideoPlayerPlugin::HandleSeekToMethodCall(
     const flutter::EncodableValue& message,
     flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
   auto parameter = PositionMessage::FromMap(message);
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
 
   if (players_.find(texture_id) != players_.end()) {
-    players_[texture_id]->player->SetSeek(parameter.GetPosition());
+    GstVideoPlayer::SeekMode mode = GstVideoPlayer::SeekMode::kKeyUnit;
+    const auto mode_name = parameter.GetSeekMode();
+    if (!mode_name.empty() &&
+        !GstVideoPlayer::ParseSeekMode(mode_name, mode)) {
+      std::cerr << "Unknown seek mode: " << mode_name << std::endl;
+    }
+    players_[texture_id]->player->SetSeek(parameter.GetPosition(), mode);
     result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
                    flutter::EncodableValue());
   } else {
@@ -582,41 +1061,841 @@ void VideoPlayerPlugin::HandleSeekToMethodCall(
   reply(flutter::EncodableValue(result));
 }
 
-void VideoPlayerPlugin::SendInitializedEventMessage(int64_t texture_id) {
-  if (players_.find(texture_id) == players_.end() ||
-      !players_[texture_id]->event_sink) {
+void VideoPlayerPlugin::HandleSetLatencyBudgetMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
     return;
   }
+  auto parameter = LatencyBudgetMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
 
-  auto duration = players_[texture_id]->player->GetDuration();
-  auto width = players_[texture_id]->player->GetWidth();
-  auto height = players_[texture_id]->player->GetHeight();
-  flutter::EncodableMap encodables = {
-      {flutter::EncodableValue("event"),
-       flutter::EncodableValue("initialized")},
-      {flutter::EncodableValue("duration"), flutter::EncodableValue(duration)},
-      {flutter::EncodableValue("width"), flutter::EncodableValue(width)},
-      {flutter::EncodableValue("height"), flutter::EncodableValue(height)}};
-  flutter::EncodableValue event(encodables);
-  players_[texture_id]->event_sink->Success(event);
-}
-
-void VideoPlayerPlugin::SendPlayCompletedEventMessage(int64_t texture_id) {
+  if (players_.find(texture_id) != players_.end()) {
+    players_[texture_id]->player->SetLatencyBudget(
+        parameter.GetLatencyBudget());
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   flutter::EncodableValue());
+  } else {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+  }
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetMultiStreamModeMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = MultiStreamModeMessage::FromMap(message);
+  multi_stream_mode_ = parameter.GetEnabled();
+  if (multi_stream_mode_) {
+    if (!multi_stream_scheduler_) {
+      multi_stream_scheduler_ = std::make_unique<MultiStreamScheduler>();
+    }
+    multi_stream_scheduler_->SetMaxDecoderThreads(
+        static_cast<int>(parameter.GetMaxDecoderThreads()));
+  }
+
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetKeyFrameOnlyMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = KeyFrameOnlyMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) != players_.end()) {
+    players_[texture_id]->player->SetKeyFrameOnly(parameter.GetKeyFrameOnly());
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   flutter::EncodableValue());
+  } else {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+  }
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetTrackSelectionMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = TrackSelectionMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) == players_.end()) {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  GstVideoPlayer::TrackSelection selection;
+  selection.audio = parameter.GetAudio();
+  selection.audio_track = static_cast<int32_t>(parameter.GetAudioTrack());
+  if (!players_[texture_id]->player->SetTrackSelection(selection)) {
+    auto error_message = "Couldn't select the tracks of texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetSubtitlesMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = SubtitlesMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) == players_.end()) {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  if (!players_[texture_id]->player->SetSubtitles(parameter.GetEnabled())) {
+    auto error_message = "No subtitles for texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetQosMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = QosMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) != players_.end()) {
+    players_[texture_id]->player->SetQos(parameter.GetEnabled());
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   flutter::EncodableValue());
+  } else {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+  }
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetCompositorLayoutMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = CompositorLayoutMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) == players_.end()) {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  auto* player = players_[texture_id]->player.get();
+  const auto& tiles = parameter.GetTiles();
+  if (tiles.size() != player->GetTileCount()) {
+    auto error_message =
+        "The layout has " + std::to_string(tiles.size()) +
+        " tiles, but the compositor has " +
+        std::to_string(player->GetTileCount());
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  for (size_t i = 0; i < tiles.size(); i++) {
+    const auto& tile = tiles[i];
+    if (!player->SetTileLayout(i, static_cast<int32_t>(tile.x),
+                               static_cast<int32_t>(tile.y),
+                               static_cast<int32_t>(tile.width),
+                               static_cast<int32_t>(tile.height),
+                               static_cast<int32_t>(tile.z_order))) {
+      auto error_message = "Invalid layout of tile " + std::to_string(i);
+      result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                     flutter::EncodableValue(WrapError(error_message)));
+      reply(flutter::EncodableValue(result));
+      return;
+    }
+  }
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetPrerollTimeoutMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = PrerollTimeoutMessage::FromMap(message);
+  preroll_timeout_ms_ = parameter.GetTimeout();
+
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetPlayerPoolSizeMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = PlayerPoolSizeMessage::FromMap(message);
+  const auto size = parameter.GetSize();
+  player_pool_.SetCapacity(size > 0 ? static_cast<size_t>(size) : 0);
+
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetIdleThrottleMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = IdleThrottleMessage::FromMap(message);
+  idle_throttle_frames_ = std::clamp<int64_t>(
+      parameter.GetIdleFrames(), 0, std::numeric_limits<int>::max());
+  for (auto& entry : players_) {
+    if (entry.second->player) {
+      entry.second->player->SetIdleThrottle(
+          static_cast<int>(idle_throttle_frames_));
+    }
+  }
+
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleGetTransportStatsMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = TextureMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) == players_.end()) {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  auto& player = players_[texture_id]->player;
+  GstVideoPlayer::TransportStats stats;
+  if (!player->GetTransportStats(stats)) {
+    auto error_message =
+        "No transport statistics available for texture id: " +
+        std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  TransportStatsMessage stats_message;
+  stats_message.SetTextureId(texture_id);
+  switch (player->GetRtspTransport()) {
+    case GstVideoPlayer::RtspTransport::kTcp:
+      stats_message.SetTransport("tcp");
+      break;
+    case GstVideoPlayer::RtspTransport::kUdp:
+      stats_message.SetTransport("udp");
+      break;
+    case GstVideoPlayer::RtspTransport::kMulticast:
+      stats_message.SetTransport("multicast");
+      break;
+    case GstVideoPlayer::RtspTransport::kUdpFirst:
+      stats_message.SetTransport("udp-first");
+      break;
+  }
+  stats_message.SetPacketsReceived(
+      static_cast<int64_t>(stats.packets_received));
+  stats_message.SetPacketsLost(static_cast<int64_t>(stats.packets_lost));
+  stats_message.SetPacketsLate(static_cast<int64_t>(stats.packets_late));
+  stats_message.SetPacketsDuplicated(
+      static_cast<int64_t>(stats.packets_duplicated));
+  stats_message.SetJitter(static_cast<int64_t>(stats.jitter / 1000));
+  const auto reconnect_stats = player->GetReconnectStats();
+  stats_message.SetReconnectAttempts(
+      static_cast<int64_t>(reconnect_stats.attempts));
+  stats_message.SetReconnects(static_cast<int64_t>(reconnect_stats.reconnects));
+  stats_message.SetLastReconnectLatency(reconnect_stats.last_latency_ms);
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 stats_message.ToMap());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetTimeshiftDelayMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = TimeshiftMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  std::string error_message;
+  if (players_.find(texture_id) == players_.end()) {
+    error_message = "Couldn't find the player with texture id: " +
+                    std::to_string(texture_id);
+  } else if (!players_[texture_id]->player->SetTimeshiftDelay(
+                 parameter.GetDelay())) {
+    error_message = "Nothing to play back for texture id: " +
+                    std::to_string(texture_id);
+  }
+  if (error_message.empty()) {
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   flutter::EncodableValue());
+  } else {
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+  }
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleGetTimeshiftMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = TextureMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  TimeshiftBuffer::State state;
   if (players_.find(texture_id) == players_.end() ||
-      !players_[texture_id]->event_sink) {
+      !players_[texture_id]->player->GetTimeshiftState(state)) {
+    auto error_message = "No timeshift buffer for texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  TimeshiftMessage timeshift_message;
+  timeshift_message.SetTextureId(texture_id);
+  timeshift_message.SetDelay(state.delay_ms);
+  timeshift_message.SetAvailable(state.available_ms);
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 timeshift_message.ToMap());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleGetStatsMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = TextureMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) == players_.end()) {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  auto& player = players_[texture_id]->player;
+  const auto get = [&player](LatencyStats::Stage stage) {
+    const auto percentiles = player->GetLatency(stage);
+    LatencyPercentiles latency;
+    latency.p50 = percentiles.p50;
+    latency.p95 = percentiles.p95;
+    latency.p99 = percentiles.p99;
+    latency.count = static_cast<int64_t>(percentiles.count);
+    return latency;
+  };
+  StatsMessage stats_message;
+  stats_message.SetTextureId(texture_id);
+  stats_message.SetCaptureToDecode(get(LatencyStats::kCaptureToDecode));
+  stats_message.SetDecodeToHandoff(get(LatencyStats::kDecodeToHandoff));
+  stats_message.SetHandoffToTexture(get(LatencyStats::kHandoffToTexture));
+  stats_message.SetDecodeToTexture(get(LatencyStats::kDecodeToTexture));
+  stats_message.SetGlassToGlass(get(LatencyStats::kGlassToGlass));
+  stats_message.SetAvDrift(get(LatencyStats::kAvDrift));
+  stats_message.SetDroppedFrames(
+      static_cast<int64_t>(player->GetDroppedFrameCount()));
+  stats_message.SetLateFrames(
+      static_cast<int64_t>(player->GetLateFrameCount()));
+  stats_message.SetQosDroppedFrames(
+      static_cast<int64_t>(player->GetQosDroppedFrameCount()));
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 stats_message.ToMap());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetScrubbingMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = ScrubbingMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) != players_.end()) {
+    players_[texture_id]->player->SetScrubbing(parameter.GetIsScrubbing());
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   flutter::EncodableValue());
+  } else {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+  }
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleGetCapabilitiesMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  const auto& registry = CapabilityRegistry::GetInstance();
+  CapabilitiesMessage capabilities_message;
+  for (const auto& codec : registry.GetCodecs()) {
+    for (const auto& decoder : codec.second) {
+      DecoderCapability capability;
+      capability.codec = codec.first;
+      capability.name = decoder.name;
+      capability.is_hardware = decoder.is_hardware;
+      capability.max_width = decoder.max_width;
+      capability.max_height = decoder.max_height;
+      capabilities_message.AddDecoder(capability);
+    }
+  }
+  for (const auto& converter : registry.GetConverters()) {
+    capabilities_message.AddConverter({converter.name, converter.is_hardware});
+  }
+  for (const auto& compositor : registry.GetCompositors()) {
+    capabilities_message.AddCompositor(
+        {compositor.name, compositor.is_hardware});
+  }
+
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 capabilities_message.ToMap());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleExtractFramesMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = ExtractFramesMessage::FromMap(message);
+  const auto& requests = parameter.GetRequests();
+  if (requests.empty()) {
+    ExtractedFramesMessage frames_message;
+    flutter::EncodableMap result;
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   frames_message.ToMap());
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+  if (!frame_extractor_) {
+    frame_extractor_ = std::make_unique<FrameExtractor>(
+        std::string(g_get_user_cache_dir()) + "/video_player_elinux/frames");
+  }
+
+  // The reply is sent by the worker thread that completes the batch.
+  struct Batch {
+    std::mutex mutex;
+    std::vector<ExtractedFrame> frames;
+    size_t remaining;
+    flutter::MessageReply<flutter::EncodableValue> reply;
+  };
+  auto batch = std::make_shared<Batch>();
+  batch->frames.resize(requests.size());
+  batch->remaining = requests.size();
+  batch->reply = std::move(reply);
+  const auto complete = [batch](size_t index, FrameExtractor::Frame frame) {
+    std::lock_guard<std::mutex> lock(batch->mutex);
+    auto& extracted = batch->frames[index];
+    extracted.width = frame.width;
+    extracted.height = frame.height;
+    extracted.data = std::move(frame.data);
+    extracted.error = frame.error;
+    if (--batch->remaining > 0) {
+      return;
+    }
+    ExtractedFramesMessage frames_message;
+    frames_message.SetFrames(std::move(batch->frames));
+    flutter::EncodableMap result;
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   frames_message.ToMap());
+    batch->reply(flutter::EncodableValue(result));
+  };
+
+  for (size_t i = 0; i < requests.size(); i++) {
+    FrameExtractor::Request request;
+    request.uri = requests[i].uri;
+    request.position_ms = requests[i].position_ms;
+    request.max_width = static_cast<int32_t>(requests[i].max_width);
+    if (!requests[i].format.empty() &&
+        !FrameExtractor::ParseFormat(requests[i].format, request.format)) {
+      FrameExtractor::Frame frame;
+      frame.error = "Unknown frame format: " + requests[i].format;
+      complete(i, std::move(frame));
+      continue;
+    }
+    frame_extractor_->Extract(
+        request, [complete, i](FrameExtractor::Frame frame) {
+          complete(i, std::move(frame));
+        });
+  }
+}
+
+void VideoPlayerPlugin::HandleCaptureFrameMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = CaptureFrameMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  // |frame_capture_pool_| is destroyed with the plugin, so the plugin
+  // outlives the callback.
+  const auto reply_error = [this, reply](const std::string& error_message) {
+    flutter::EncodableMap result;
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+  };
+
+  if (players_.find(texture_id) == players_.end()) {
+    reply_error("Couldn't find the player with texture id: " +
+                std::to_string(texture_id));
+    return;
+  }
+  FrameCapturePool::Request request;
+  request.max_size = static_cast<int32_t>(parameter.GetMaxSize());
+  request.path = parameter.GetPath();
+  if (!FrameCapturePool::ParseFormat(parameter.GetFormat(), request.format)) {
+    reply_error("Unknown frame format: " + parameter.GetFormat());
+    return;
+  }
+  if (!frame_capture_pool_) {
+    frame_capture_pool_ = std::make_unique<FrameCapturePool>(
+        kCaptureThreadCount, kMaxQueuedCaptures);
+  }
+
+  // The reply is sent by the capture thread.
+  auto on_captured = [reply, reply_error](FrameCapturePool::Picture&& picture) {
+    if (!picture.error.empty()) {
+      reply_error(picture.error);
+      return;
+    }
+    CapturedFrameMessage frame_message;
+    frame_message.SetWidth(picture.width);
+    frame_message.SetHeight(picture.height);
+    frame_message.SetData(std::move(picture.data));
+    frame_message.SetPath(picture.path);
+    flutter::EncodableMap result;
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   frame_message.ToMap());
+    reply(flutter::EncodableValue(result));
+  };
+  if (!players_[texture_id]->player->CaptureFrame(
+          *frame_capture_pool_, request, std::move(on_captured))) {
+    reply_error("Failed to capture a frame of texture id: " +
+                std::to_string(texture_id));
+  }
+}
+
+void VideoPlayerPlugin::HandleGenerateSpriteSheetMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = GenerateSpriteSheetMessage::FromMap(message);
+  // |sprite_sheet_generator_| is destroyed with the plugin, so the plugin
+  // outlives the callback.
+  const auto reply_error = [this, reply](const std::string& error_message) {
+    flutter::EncodableMap result;
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+  };
+
+  SpriteSheetGenerator::Request request;
+  request.uri = parameter.GetUri();
+  request.interval_ms = parameter.GetIntervalMs();
+  request.tile_width = static_cast<int32_t>(parameter.GetTileWidth());
+  request.columns = static_cast<int32_t>(parameter.GetColumns());
+  if (!sprite_sheet_generator_) {
+    sprite_sheet_generator_ = std::make_unique<SpriteSheetGenerator>(
+        std::string(g_get_user_cache_dir()) + "/video_player_elinux/sprites");
+  }
+
+  // The reply is sent by the worker thread.
+  auto on_generated = [reply,
+                       reply_error](SpriteSheetGenerator::SpriteSheet sheet) {
+    if (!sheet.error.empty()) {
+      reply_error(sheet.error);
+      return;
+    }
+    SpriteSheetMessage sheet_message;
+    sheet_message.SetPath(sheet.path);
+    sheet_message.SetIntervalMs(sheet.interval_ms);
+    sheet_message.SetTileWidth(sheet.tile_width);
+    sheet_message.SetTileHeight(sheet.tile_height);
+    sheet_message.SetColumns(sheet.columns);
+    sheet_message.SetCount(sheet.count);
+    flutter::EncodableMap result;
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   sheet_message.ToMap());
+    reply(flutter::EncodableValue(result));
+  };
+  if (!sprite_sheet_generator_->Generate(request, std::move(on_generated))) {
+    reply_error("Invalid sprite sheet request for " + request.uri);
+  }
+}
+
+void VideoPlayerPlugin::HandleGetPositionsMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  PositionsMessage positions_message;
+  for (const auto& entry : players_) {
+    positions_message.AddPosition(GetPlayerPosition(entry.second.get()));
+  }
+
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 positions_message.ToMap());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetPositionTickMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = PositionTickMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) != players_.end()) {
+    position_ticker_.Set(
+        texture_id, parameter.GetIntervalMs(),
+        [instance = players_[texture_id].get(), host = this]() {
+          host->SendPositionUpdate(instance);
+        });
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   flutter::EncodableValue());
+  } else {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+  }
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetDownloadCacheMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = DownloadCacheMessage::FromMap(message);
+  DownloadCache::Settings settings;
+  settings.directory = parameter.GetDirectory();
+  settings.max_size_bytes = parameter.GetMaxSizeBytes();
+  settings.buffer_duration_ms = parameter.GetBufferDurationMs();
+  settings.buffer_size_bytes = static_cast<int32_t>(std::min<int64_t>(
+      parameter.GetBufferSizeBytes(), std::numeric_limits<int32_t>::max()));
+  DownloadCache::GetInstance().Configure(settings);
+
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetAbrPolicyMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (ReplyIfNotInitialized(message, reply)) {
+    return;
+  }
+  auto parameter = AbrPolicyMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) != players_.end()) {
+    GstVideoPlayer::AbrPolicy policy;
+    policy.max_width = static_cast<int32_t>(parameter.GetMaxWidth());
+    policy.max_height = static_cast<int32_t>(parameter.GetMaxHeight());
+    policy.follow_texture_size = parameter.GetFollowTextureSize();
+    policy.max_bitrate = parameter.GetMaxBitrate();
+    policy.start_bitrate = parameter.GetStartBitrate();
+    players_[texture_id]->player->SetAbrPolicy(policy);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   flutter::EncodableValue());
+  } else {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+  }
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetThreadPolicyMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = ThreadPolicyMessage::FromMap(message);
+  flutter::EncodableMap result;
+
+  ThreadPolicy::Role role;
+  ThreadPolicy::Settings settings;
+  for (const auto cpu : parameter.GetCpus()) {
+    settings.cpus.push_back(static_cast<int>(cpu));
+  }
+  settings.realtime_priority =
+      static_cast<int>(parameter.GetRealtimePriority());
+  settings.nice = static_cast<int>(parameter.GetNice());
+  if (!ThreadPolicy::ParseRole(parameter.GetRole(), role) ||
+      !ThreadPolicy::GetInstance().Set(role, settings)) {
+    auto error_message =
+        "Invalid thread policy for role: " + parameter.GetRole();
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+  } else {
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   flutter::EncodableValue());
+  }
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::PostToPlayer(
+    int64_t texture_id, std::function<void(FlutterVideoPlayer*)> send) {
+  // Looked up once run, since |players_| is only used on the platform
+  // thread.
+  platform_tasks_.Post([this, texture_id, send = std::move(send)]() {
+    auto itr = players_.find(texture_id);
+    if (itr != players_.end()) {
+      send(itr->second.get());
+    }
+  });
+}
+
+void VideoPlayerPlugin::SendInitializedEventMessage(
+    FlutterVideoPlayer* instance) {
+  InitState init_state;
+  {
+    std::lock_guard<std::mutex> lock(instance->event_mutex);
+    init_state = instance->init_state;
+  }
+  if (init_state == InitState::kPending) {
+    return;
+  }
+  if (instance->is_multiplexed) {
+    if (init_state == InitState::kFailed) {
+      PushEvent(instance, VideoEventQueue::Type::kInitializationFailed);
+      return;
+    }
+    PushEvent(instance, VideoEventQueue::Type::kInitialized,
+              {instance->player->GetDuration(), instance->player->GetWidth(),
+               instance->player->GetHeight()});
+    return;
+  }
+  if (!instance->event_sink) {
+    return;
+  }
+  if (init_state == InitState::kFailed) {
+    instance->event_sink->Error(
+        "VideoError", "Failed to initialize the player with texture id: " +
+                          std::to_string(instance->texture_id));
+    return;
+  }
+
+  auto duration = instance->player->GetDuration();
+  auto width = instance->player->GetWidth();
+  auto height = instance->player->GetHeight();
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue("initialized")},
+      {flutter::EncodableValue("duration"), flutter::EncodableValue(duration)},
+      {flutter::EncodableValue("width"), flutter::EncodableValue(width)},
+      {flutter::EncodableValue("height"), flutter::EncodableValue(height)}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendPlayCompletedEventMessage(
+    FlutterVideoPlayer* instance) {
+  if (instance->is_multiplexed) {
+    PushEvent(instance, VideoEventQueue::Type::kCompleted);
+    return;
+  }
+  if (!instance->event_sink) {
     return;
   }
 
   flutter::EncodableMap encodables = {
       {flutter::EncodableValue("event"), flutter::EncodableValue("completed")}};
   flutter::EncodableValue event(encodables);
-  players_[texture_id]->event_sink->Success(event);
+  instance->event_sink->Success(event);
 }
 
-void VideoPlayerPlugin::SendIsPlayingStateUpdate(int64_t texture_id,
+void VideoPlayerPlugin::SendIsPlayingStateUpdate(FlutterVideoPlayer* instance,
                                                  bool is_playing) {
-  if (players_.find(texture_id) == players_.end() ||
-      !players_[texture_id]->event_sink) {
+  if (instance->is_multiplexed) {
+    PushEvent(instance, VideoEventQueue::Type::kIsPlaying, {is_playing});
+    return;
+  }
+  if (!instance->event_sink) {
     return;
   }
 
@@ -626,23 +1905,402 @@ void VideoPlayerPlugin::SendIsPlayingStateUpdate(int64_t texture_id,
       {flutter::EncodableValue("isPlaying"),
        flutter::EncodableValue(is_playing)}};
   flutter::EncodableValue event(encodables);
-  players_[texture_id]->event_sink->Success(event);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendBufferingUpdate(FlutterVideoPlayer* instance,
+                                            bool is_buffering) {
+  if (instance->is_multiplexed) {
+    PushEvent(instance, VideoEventQueue::Type::kBuffering, {is_buffering});
+    return;
+  }
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue(is_buffering ? "bufferingStart"
+                                            : "bufferingEnd")}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendBufferedRangesUpdate(
+    FlutterVideoPlayer* instance,
+    const std::vector<std::pair<int64_t, int64_t>>& ranges) {
+  if (instance->is_multiplexed) {
+    event_queue_.PushBufferedRanges(instance->texture_id, ranges);
+    return;
+  }
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableList values;
+  for (const auto& range : ranges) {
+    values.push_back(flutter::EncodableValue(flutter::EncodableList{
+        flutter::EncodableValue(range.first),
+        flutter::EncodableValue(range.second)}));
+  }
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue("bufferingUpdate")},
+      {flutter::EncodableValue("values"), flutter::EncodableValue(values)}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendVariantSwitch(FlutterVideoPlayer* instance,
+                                          int32_t width, int32_t height,
+                                          int64_t bitrate) {
+  if (instance->is_multiplexed) {
+    PushEvent(instance, VideoEventQueue::Type::kVariantSwitch,
+              {width, height, bitrate,
+               instance->player->GetMeasuredBandwidth()});
+    return;
+  }
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue("variantSwitch")},
+      {flutter::EncodableValue("width"), flutter::EncodableValue(width)},
+      {flutter::EncodableValue("height"), flutter::EncodableValue(height)},
+      {flutter::EncodableValue("bitrate"), flutter::EncodableValue(bitrate)},
+      {flutter::EncodableValue("bandwidth"),
+       flutter::EncodableValue(instance->player->GetMeasuredBandwidth())}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendThroughput(FlutterVideoPlayer* instance,
+                                       int64_t throughput,
+                                       int64_t bandwidth) {
+  if (instance->is_multiplexed) {
+    PushEvent(instance, VideoEventQueue::Type::kThroughput,
+              {throughput, bandwidth});
+    return;
+  }
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue("throughput")},
+      {flutter::EncodableValue("throughput"),
+       flutter::EncodableValue(throughput)},
+      {flutter::EncodableValue("bandwidth"),
+       flutter::EncodableValue(bandwidth)}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendSubtitleCue(FlutterVideoPlayer* instance,
+                                        const std::string& text,
+                                        bool is_markup, int64_t start_ms,
+                                        int64_t duration_ms) {
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue("subtitleCue")},
+      {flutter::EncodableValue("text"), flutter::EncodableValue(text)},
+      {flutter::EncodableValue("isMarkup"),
+       flutter::EncodableValue(is_markup)},
+      {flutter::EncodableValue("start"), flutter::EncodableValue(start_ms)},
+      {flutter::EncodableValue("duration"),
+       flutter::EncodableValue(duration_ms)}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendOverlay(
+    FlutterVideoPlayer* instance,
+    const std::vector<VideoPlayerStreamHandler::OverlayRectangle>&
+        rectangles) {
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableList list;
+  for (const auto& rectangle : rectangles) {
+    list.push_back(flutter::EncodableValue(flutter::EncodableMap{
+        {flutter::EncodableValue("x"), flutter::EncodableValue(rectangle.x)},
+        {flutter::EncodableValue("y"), flutter::EncodableValue(rectangle.y)},
+        {flutter::EncodableValue("width"),
+         flutter::EncodableValue(rectangle.width)},
+        {flutter::EncodableValue("height"),
+         flutter::EncodableValue(rectangle.height)},
+        {flutter::EncodableValue("pixelWidth"),
+         flutter::EncodableValue(rectangle.pixel_width)},
+        {flutter::EncodableValue("pixelHeight"),
+         flutter::EncodableValue(rectangle.pixel_height)},
+        {flutter::EncodableValue("pixels"),
+         flutter::EncodableValue(rectangle.pixels)}}));
+  }
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"), flutter::EncodableValue("overlay")},
+      {flutter::EncodableValue("rectangles"), flutter::EncodableValue(list)}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::PushEvent(FlutterVideoPlayer* instance,
+                                  VideoEventQueue::Type type,
+                                  std::initializer_list<int64_t> values) {
+  VideoEventQueue::Event event;
+  event.texture_id = instance->texture_id;
+  event.type = type;
+  std::copy_n(values.begin(),
+              std::min(values.size(), std::size(event.values)), event.values);
+  event_queue_.Push(event);
+}
+
+void VideoPlayerPlugin::SetUpEventsChannel() {
+  events_channel_ =
+      std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
+          plugin_registrar_->messenger(), kVideoPlayerEventsChannelName,
+          &flutter::StandardMethodCodec::GetInstance());
+  auto handler = std::make_unique<
+      flutter::StreamHandlerFunctions<flutter::EncodableValue>>(
+      [host = this](
+          const flutter::EncodableValue* arguments,
+          std::unique_ptr<flutter::EventSink<flutter::EncodableValue>>&&
+              events)
+          -> std::unique_ptr<
+              flutter::StreamHandlerError<flutter::EncodableValue>> {
+        int64_t interval_ms = kDefaultEventIntervalMs;
+        if (arguments &&
+            std::holds_alternative<flutter::EncodableMap>(*arguments)) {
+          const auto& map = std::get<flutter::EncodableMap>(*arguments);
+          const auto it = map.find(flutter::EncodableValue("intervalMs"));
+          if (it != map.end() &&
+              (std::holds_alternative<int32_t>(it->second) ||
+               std::holds_alternative<int64_t>(it->second))) {
+            interval_ms = it->second.LongValue();
+          }
+        }
+        host->events_sink_ = std::move(events);
+        host->event_queue_.Start(
+            interval_ms, [host](std::vector<uint8_t> batch) {
+              host->platform_tasks_.Post(
+                  [host, batch = std::move(batch)]() mutable {
+                    if (host->events_sink_) {
+                      host->events_sink_->Success(
+                          flutter::EncodableValue(std::move(batch)));
+                    }
+                  });
+            });
+        return nullptr;
+      },
+      [host = this](const flutter::EncodableValue* arguments)
+          -> std::unique_ptr<
+              flutter::StreamHandlerError<flutter::EncodableValue>> {
+        host->event_queue_.Stop();
+        host->events_sink_ = nullptr;
+        return nullptr;
+      });
+  events_channel_->SetStreamHandler(std::move(handler));
+}
+
+PlayerPosition VideoPlayerPlugin::GetPlayerPosition(
+    FlutterVideoPlayer* instance) {
+  PlayerPosition position;
+  position.texture_id = instance->texture_id;
+  {
+    std::lock_guard<std::mutex> lock(instance->event_mutex);
+    if (instance->init_state != InitState::kInitialized) {
+      return position;
+    }
+  }
+  auto& player = instance->player;
+  position.position = player->GetCurrentPosition();
+  // Live streams have no duration to query.
+  position.duration = player->IsLive() ? -1 : player->GetDuration();
+  position.is_buffering = player->IsBuffering();
+  return position;
+}
+
+void VideoPlayerPlugin::SendPositionUpdate(FlutterVideoPlayer* instance) {
+  const auto position = GetPlayerPosition(instance);
+  if (position.position < 0) {
+    return;
+  }
+  PostToPlayer(instance->texture_id, [this,
+                                      position](FlutterVideoPlayer* player) {
+    if (player->is_multiplexed) {
+      PushEvent(player, VideoEventQueue::Type::kPosition,
+                {position.position, position.duration, position.is_buffering});
+      return;
+    }
+    if (!player->event_sink) {
+      return;
+    }
+    flutter::EncodableMap encodables = {
+        {flutter::EncodableValue("event"),
+         flutter::EncodableValue("positionUpdate")},
+        {flutter::EncodableValue("position"),
+         flutter::EncodableValue(position.position)},
+        {flutter::EncodableValue("duration"),
+         flutter::EncodableValue(position.duration)},
+        {flutter::EncodableValue("isBuffering"),
+         flutter::EncodableValue(position.is_buffering)}};
+    flutter::EncodableValue event(encodables);
+    player->event_sink->Success(event);
+  });
+}
+
+bool VideoPlayerPlugin::ReplyIfNotInitialized(
+    const flutter::EncodableValue& message,
+    const flutter::MessageReply<flutter::EncodableValue>& reply) {
+  const auto texture_id = TextureMessage::FromMap(message).GetTextureId();
+  auto itr = players_.find(texture_id);
+  // An unknown texture id is reported by the handler.
+  if (itr == players_.end()) {
+    return false;
+  }
+  std::string error_message;
+  {
+    std::lock_guard<std::mutex> lock(itr->second->event_mutex);
+    if (itr->second->init_state == InitState::kInitialized) {
+      return false;
+    }
+    error_message = itr->second->init_state == InitState::kPending
+                        ? "The player with texture id: " +
+                              std::to_string(texture_id) +
+                              " isn't initialized yet"
+                        : "Failed to initialize the player with texture id: " +
+                              std::to_string(texture_id);
+  }
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                 flutter::EncodableValue(WrapError(error_message)));
+  reply(flutter::EncodableValue(result));
+  return true;
 }
 
 void VideoPlayerPlugin::DisposePlayer(int64_t texture_id) {
   if (players_.find(texture_id) != players_.end()) {
-    texture_registrar_->UnregisterTexture(texture_id);
     auto* player = players_[texture_id].get();
+    position_ticker_.Remove(texture_id);
+    bool is_pending = false;
     player->event_sink = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(player->event_mutex);
+      is_pending = player->init_state == InitState::kPending;
+    }
+    if (player->init_thread.joinable()) {
+      // Otherwise a stream that doesn't answer blocks the platform thread
+      // for the whole preroll timeout.
+      if (is_pending) {
+        player->player->AbortPreroll();
+      }
+      player->init_thread.join();
+    }
+    event_queue_.Remove(texture_id);
+    texture_registrar_->UnregisterTexture(texture_id);
     if (player->event_channel) {
       player->event_channel->SetStreamHandler(nullptr);
     }
-    player->player = nullptr;
+    StopFrameStream(player);
+    if (player->frame_stream_channel) {
+      player->frame_stream_channel->SetStreamHandler(nullptr);
+    }
+    if (multi_stream_scheduler_ && player->player) {
+      multi_stream_scheduler_->Detach(player->player.get());
+    }
+    // A failed player isn't worth reusing, and a pending one was aborted.
+    if (is_pending || player->init_state == InitState::kFailed) {
+      player->player = nullptr;
+    } else {
+      player_pool_.Release(std::move(player->player));
+    }
     player->buffer = nullptr;
     player->texture = nullptr;
   }
 }
 
+void VideoPlayerPlugin::StartFrameStream(
+    FlutterVideoPlayer* instance, const flutter::EncodableValue* arguments) {
+  if (!instance->player) {
+    return;
+  }
+  int64_t every_nth = 1;
+  int64_t max_width = 0;
+  if (arguments && std::holds_alternative<flutter::EncodableMap>(*arguments)) {
+    auto map = std::get<flutter::EncodableMap>(*arguments);
+    const auto get = [&map](const char* key, int64_t& value) {
+      flutter::EncodableValue& field = map[flutter::EncodableValue(key)];
+      if (std::holds_alternative<int32_t>(field) ||
+          std::holds_alternative<int64_t>(field)) {
+        value = field.LongValue();
+      }
+    };
+    get("everyNth", every_nth);
+    get("maxWidth", max_width);
+  }
+
+  // Detached first, since the streaming thread may be pushing to the
+  // previous stream.
+  instance->player->SetFrameStream(nullptr);
+  instance->frame_stream = std::make_unique<FrameStream>(
+      static_cast<int32_t>(every_nth), static_cast<int32_t>(max_width),
+      [texture_id = instance->texture_id, host = this](
+          const FrameStream::Frame& frame) {
+        const auto address = [](const void* pointer) {
+          return static_cast<int64_t>(reinterpret_cast<uintptr_t>(pointer));
+        };
+        flutter::EncodableMap event = {
+            {flutter::EncodableValue("slot"),
+             flutter::EncodableValue(frame.slot)},
+            {flutter::EncodableValue("sequence"),
+             flutter::EncodableValue(static_cast<int64_t>(frame.sequence))},
+            {flutter::EncodableValue("width"),
+             flutter::EncodableValue(frame.width)},
+            {flutter::EncodableValue("height"),
+             flutter::EncodableValue(frame.height)},
+            {flutter::EncodableValue("stride"),
+             flutter::EncodableValue(frame.stride)},
+            {flutter::EncodableValue("format"),
+             flutter::EncodableValue(
+                 frame.format == FrameStream::Format::kRgba ? "rgba"
+                                                            : "gray8")},
+            {flutter::EncodableValue("timestampUs"),
+             flutter::EncodableValue(frame.timestamp_us)},
+            {flutter::EncodableValue("address"),
+             flutter::EncodableValue(address(frame.data))},
+            {flutter::EncodableValue("size"),
+             flutter::EncodableValue(static_cast<int64_t>(frame.size))},
+            {flutter::EncodableValue("stateAddress"),
+             flutter::EncodableValue(address(frame.state))},
+            {flutter::EncodableValue("droppedFrames"),
+             flutter::EncodableValue(
+                 static_cast<int64_t>(frame.dropped_frames))}};
+        host->PostToPlayer(texture_id, [event = std::move(event)](
+                                           FlutterVideoPlayer* instance) {
+          if (instance->frame_stream_sink) {
+            instance->frame_stream_sink->Success(
+                flutter::EncodableValue(event));
+          }
+        });
+      });
+  instance->player->SetFrameStream(instance->frame_stream.get());
+}
+
+void VideoPlayerPlugin::StopFrameStream(FlutterVideoPlayer* instance) {
+  if (instance->player) {
+    instance->player->SetFrameStream(nullptr);
+  }
+  instance->frame_stream_sink = nullptr;
+  instance->frame_stream = nullptr;
+}
+
 flutter::EncodableValue VideoPlayerPlugin::WrapError(
     const std::string& message, const std::string& code,
     const std::string& details) {
@@ -653,6 +2311,19 @@ flutter::EncodableValue VideoPlayerPlugin::WrapError(
   return flutter::EncodableValue(map);
 }
 
+std::string VideoPlayerPlugin::GetUri(const CreateMessage& meta) {
+  if (!meta.GetAsset().empty()) {
+    // todo: gets propery path of the Flutter project.
+    std::string flutter_project_path = GetExecutableDirectory() + "/data/";
+    const auto path =
+        flutter_project_path + "flutter_assets/" + meta.GetAsset();
+    // Read ahead while the pipeline is being built.
+    AssetCache::GetInstance().Prefetch(path);
+    return path;
+  }
+  return meta.GetUri();
+}
+
 const std::string VideoPlayerPlugin::GetExecutableDirectory() {
   static char buf[1024] = {};
   readlink("/proc/self/exe", buf, sizeof(buf) - 1);
@@ -0,0 +1,116 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "video_player_pool.h"
+
+#include "video_player_stream_handler_impl.h"
+
+namespace {
+
+// Drops the notifications of a player that isn't bound to a texture.
+std::unique_ptr<VideoPlayerStreamHandler> CreateIdleStreamHandler() {
+  return std::make_unique<VideoPlayerStreamHandlerImpl>(
+      nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+      nullptr, nullptr);
+}
+
+}  // namespace
+
+void VideoPlayerPool::SetCapacity(size_t capacity) {
+  capacity_ = capacity;
+  while (idle_rtsp_players_.size() > capacity_) {
+    idle_rtsp_players_.pop_back();
+  }
+  while (idle_playbin_players_.size() > capacity_) {
+    idle_playbin_players_.pop_back();
+  }
+  while (preloaded_players_.size() > capacity_) {
+    preloaded_players_.pop_front();
+  }
+}
+
+std::unique_ptr<GstVideoPlayer> VideoPlayerPool::Acquire(
+    const std::string& uri) {
+  for (auto it = preloaded_players_.begin(); it != preloaded_players_.end();
+       ++it) {
+    if (it->first == uri) {
+      auto player = std::move(it->second);
+      preloaded_players_.erase(it);
+      return player;
+    }
+  }
+
+  auto player = TakeIdle(GstVideoPlayer::IsRtspUri(uri));
+  if (player && !player->Retarget(uri)) {
+    return nullptr;
+  }
+  return player;
+}
+
+void VideoPlayerPool::Release(std::unique_ptr<GstVideoPlayer> player) {
+  // The WebRTC sessions aren't kept alive for another endpoint.
+  if (!player || player->IsCompositor() || player->IsWebRtc() ||
+      player->IsTimeshiftEnabled()) {
+    return;
+  }
+  // Acquire() hands the players to any uri, with the default file options.
+  const auto& file_options = player->GetFileOptions();
+  const auto track_selection = player->GetTrackSelection();
+  if (file_options.fast_start || file_options.muted ||
+      !track_selection.audio || track_selection.audio_track >= 0) {
+    return;
+  }
+  auto& idle_players =
+      player->IsRtsp() ? idle_rtsp_players_ : idle_playbin_players_;
+  if (idle_players.size() >= capacity_) {
+    return;
+  }
+
+  // Waits for the streaming threads still notifying the disposed texture.
+  player->SetStreamHandler(CreateIdleStreamHandler());
+  if (!player->Stop()) {
+    return;
+  }
+  idle_players.push_back(std::move(player));
+}
+
+void VideoPlayerPool::Preload(const std::string& uri,
+                              int64_t preroll_timeout_ms) {
+  if (capacity_ == 0) {
+    return;
+  }
+  for (const auto& preloaded_player : preloaded_players_) {
+    if (preloaded_player.first == uri) {
+      return;
+    }
+  }
+
+  auto player = TakeIdle(GstVideoPlayer::IsRtspUri(uri));
+  if (!player || !player->Retarget(uri)) {
+    player = std::make_unique<GstVideoPlayer>(uri, CreateIdleStreamHandler());
+  }
+  player->SetPrerollTimeout(preroll_timeout_ms);
+  player->Preload();
+
+  if (preloaded_players_.size() >= capacity_) {
+    preloaded_players_.pop_front();
+  }
+  preloaded_players_.emplace_back(uri, std::move(player));
+}
+
+void VideoPlayerPool::Clear() {
+  idle_rtsp_players_.clear();
+  idle_playbin_players_.clear();
+  preloaded_players_.clear();
+}
+
+std::unique_ptr<GstVideoPlayer> VideoPlayerPool::TakeIdle(bool is_rtsp) {
+  auto& idle_players = is_rtsp ? idle_rtsp_players_ : idle_playbin_players_;
+  if (idle_players.empty()) {
+    return nullptr;
+  }
+  auto player = std::move(idle_players.back());
+  idle_players.pop_back();
+  return player;
+}
@@ -0,0 +1,58 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_POOL_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_POOL_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gst_video_player.h"
+
+// Keeps disposed players in READY so that the next player of the same
+// pipeline type reuses their elements instead of building new ones, and
+// holds the players prerolled ahead of time by Preload().
+class VideoPlayerPool {
+ public:
+  VideoPlayerPool() = default;
+  ~VideoPlayerPool() = default;
+
+  // Prevent copying.
+  VideoPlayerPool(VideoPlayerPool const&) = delete;
+  VideoPlayerPool& operator=(VideoPlayerPool const&) = delete;
+
+  // Sets how many idle players are kept per pipeline type, and how many
+  // preloaded players are kept. Zero disables the pool.
+  void SetCapacity(size_t capacity);
+
+  // Returns the preloaded player of |uri|, or an idle player of the same
+  // pipeline type pointed at |uri|, or nullptr if there is neither. The
+  // returned player has no stream handler yet.
+  std::unique_ptr<GstVideoPlayer> Acquire(const std::string& uri);
+
+  // Takes back a disposed player. It is kept idle if there is room for its
+  // pipeline type, and destroyed otherwise.
+  void Release(std::unique_ptr<GstVideoPlayer> player);
+
+  // Prerolls a player of |uri| in the background for a later Acquire().
+  void Preload(const std::string& uri, int64_t preroll_timeout_ms);
+
+  // Destroys all the idle and preloaded players.
+  void Clear();
+
+ private:
+  std::unique_ptr<GstVideoPlayer> TakeIdle(bool is_rtsp);
+
+  size_t capacity_ = 2;
+  std::vector<std::unique_ptr<GstVideoPlayer>> idle_rtsp_players_;
+  std::vector<std::unique_ptr<GstVideoPlayer>> idle_playbin_players_;
+  // Oldest first.
+  std::deque<std::pair<std::string, std::unique_ptr<GstVideoPlayer>>>
+      preloaded_players_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_POOL_H_
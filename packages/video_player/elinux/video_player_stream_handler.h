@@ -5,6 +5,11 @@
 #ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_H_
 #define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_H_
 
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
 class VideoPlayerStreamHandler {
  public:
   VideoPlayerStreamHandler() = default;
@@ -14,23 +19,92 @@ class VideoPlayerStreamHandler {
   VideoPlayerStreamHandler(VideoPlayerStreamHandler const&) = delete;
   VideoPlayerStreamHandler& operator=(VideoPlayerStreamHandler const&) = delete;
 
+  // A bitmap to composite over the video, e.g. a DVB subtitle.
+  struct OverlayRectangle {
+    // Where it's shown, in the coordinates of the video.
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    // The size of the bitmap, and its BGRA pixels with straight alpha,
+    // without padding.
+    int32_t pixel_width = 0;
+    int32_t pixel_height = 0;
+    std::vector<uint8_t> pixels;
+  };
+
   // Notifies the completion of initializing the video player.
   void OnNotifyInitialized() { OnNotifyInitializedInternal(); }
 
   // Notifies the completion of decoding a video frame.
   void OnNotifyFrameDecoded() { OnNotifyFrameDecodedInternal(); }
 
+  // Notifies that the renderer has picked up the latest decoded frame.
+  void OnNotifyFrameRendered() { OnNotifyFrameRenderedInternal(); }
+
   // Notifies the completion of playing a video.
   void OnNotifyCompleted() { OnNotifyCompletedInternal(); }
 
   // Notifies update of playing or pausing a video.
   void OnNotifyPlaying(bool is_playing) { OnNotifyPlayingInternal(is_playing); }
 
+  // Notifies that the stream has been lost and is being reconnected, or
+  // that it has resumed.
+  void OnNotifyBuffering(bool is_buffering) {
+    OnNotifyBufferingInternal(is_buffering);
+  }
+
+  // Notifies the buffered ranges of a network stream, as the start and the
+  // end of each range in milliseconds.
+  void OnNotifyBufferingUpdate(
+      const std::vector<std::pair<int64_t, int64_t>>& ranges) {
+    OnNotifyBufferingUpdateInternal(ranges);
+  }
+
+  // Notifies that an adaptive stream has switched to a variant of |width| x
+  // |height|, of |bitrate| bits per second if the demuxer tells.
+  void OnNotifyVariantSwitch(int32_t width, int32_t height, int64_t bitrate) {
+    OnNotifyVariantSwitchInternal(width, height, bitrate);
+  }
+
+  // Notifies the throughput of the last fragment of an adaptive stream and
+  // the bandwidth measured over the recent ones, in bits per second.
+  void OnNotifyThroughput(int64_t throughput, int64_t bandwidth) {
+    OnNotifyThroughputInternal(throughput, bandwidth);
+  }
+
+  // Notifies a subtitle cue, shown from |start_ms| in the stream time for
+  // |duration_ms|, or until the next cue if it's negative. |is_markup| is
+  // set if |text| is Pango markup rather than plain text.
+  void OnNotifySubtitleCue(const std::string& text, bool is_markup,
+                           int64_t start_ms, int64_t duration_ms) {
+    OnNotifySubtitleCueInternal(text, is_markup, start_ms, duration_ms);
+  }
+
+  // Notifies the overlay of the frames from now on, which is cleared if
+  // |rectangles| is empty.
+  void OnNotifyOverlay(const std::vector<OverlayRectangle>& rectangles) {
+    OnNotifyOverlayInternal(rectangles);
+  }
+
  protected:
   virtual void OnNotifyInitializedInternal() = 0;
   virtual void OnNotifyFrameDecodedInternal() = 0;
+  virtual void OnNotifyFrameRenderedInternal() = 0;
   virtual void OnNotifyCompletedInternal() = 0;
   virtual void OnNotifyPlayingInternal(bool is_playing) = 0;
+  virtual void OnNotifyBufferingInternal(bool is_buffering) = 0;
+  virtual void OnNotifyBufferingUpdateInternal(
+      const std::vector<std::pair<int64_t, int64_t>>& ranges) = 0;
+  virtual void OnNotifyVariantSwitchInternal(int32_t width, int32_t height,
+                                             int64_t bitrate) = 0;
+  virtual void OnNotifyThroughputInternal(int64_t throughput,
+                                          int64_t bandwidth) = 0;
+  virtual void OnNotifySubtitleCueInternal(const std::string& text,
+                                           bool is_markup, int64_t start_ms,
+                                           int64_t duration_ms) = 0;
+  virtual void OnNotifyOverlayInternal(
+      const std::vector<OverlayRectangle>& rectangles) = 0;
 };
 
 #endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_H_
@@ -5,7 +5,12 @@
 #ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_IMPL_H_
 #define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_IMPL_H_
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "video_player_stream_handler.h"
 
@@ -15,15 +20,38 @@ class VideoPlayerStreamHandlerImpl : public VideoPlayerStreamHandler {
   using OnNotifyFrameDecoded = std::function<void()>;
   using OnNotifyCompleted = std::function<void()>;
   using OnNotifyPlaying = std::function<void(bool)>;
+  using OnNotifyBuffering = std::function<void(bool)>;
+  using OnNotifyBufferingUpdate = std::function<void(
+      const std::vector<std::pair<int64_t, int64_t>>&)>;
+  using OnNotifyVariantSwitch =
+      std::function<void(int32_t, int32_t, int64_t)>;
+  using OnNotifyThroughput = std::function<void(int64_t, int64_t)>;
+  using OnNotifySubtitleCue =
+      std::function<void(const std::string&, bool, int64_t, int64_t)>;
+  using OnNotifyOverlay =
+      std::function<void(const std::vector<OverlayRectangle>&)>;
 
   VideoPlayerStreamHandlerImpl(OnNotifyInitialized on_notify_initialized,
                                OnNotifyFrameDecoded on_notify_frame_decoded,
                                OnNotifyCompleted on_notify_completed,
-                               OnNotifyPlaying on_notify_playing)
+                               OnNotifyPlaying on_notify_playing,
+                               OnNotifyBuffering on_notify_buffering,
+                               OnNotifyBufferingUpdate
+                                   on_notify_buffering_update,
+                               OnNotifyVariantSwitch on_notify_variant_switch,
+                               OnNotifyThroughput on_notify_throughput,
+                               OnNotifySubtitleCue on_notify_subtitle_cue,
+                               OnNotifyOverlay on_notify_overlay)
       : on_notify_initialized_(on_notify_initialized),
         on_notify_frame_decoded_(on_notify_frame_decoded),
         on_notify_completed_(on_notify_completed),
-        on_notify_playing_(on_notify_playing) {}
+        on_notify_playing_(on_notify_playing),
+        on_notify_buffering_(on_notify_buffering),
+        on_notify_buffering_update_(on_notify_buffering_update),
+        on_notify_variant_switch_(on_notify_variant_switch),
+        on_notify_throughput_(on_notify_throughput),
+        on_notify_subtitle_cue_(on_notify_subtitle_cue),
+        on_notify_overlay_(on_notify_overlay) {}
   virtual ~VideoPlayerStreamHandlerImpl() = default;
 
   // Prevent copying.
@@ -31,6 +59,16 @@ class VideoPlayerStreamHandlerImpl : public VideoPlayerStreamHandler {
   VideoPlayerStreamHandlerImpl& operator=(VideoPlayerStreamHandlerImpl const&) =
       delete;
 
+  // Returns the number of frames reported by the decoder.
+  uint64_t GetDecodedFrameCount() const { return decoded_frames_; }
+
+  // Returns the number of frames passed on to |on_notify_frame_decoded_|.
+  uint64_t GetNotifiedFrameCount() const { return notified_frames_; }
+
+  // Returns the number of frames that weren't notified because the renderer
+  // hadn't picked up the previously notified one yet.
+  uint64_t GetDroppedFrameCount() const { return dropped_frames_; }
+
  protected:
   // |VideoPlayerStreamHandler|
   void OnNotifyInitializedInternal() {
@@ -40,12 +78,26 @@ class VideoPlayerStreamHandlerImpl : public VideoPlayerStreamHandler {
   }
 
   // |VideoPlayerStreamHandler|
+  //
+  // Coalesces the notifications against the display: once a frame has been
+  // notified, the following frames are skipped until the renderer picks one
+  // up, which it does at most once per vsync. The renderer always takes the
+  // newest frame, so the skipped frames would never have been shown anyway.
   void OnNotifyFrameDecodedInternal() {
+    decoded_frames_++;
+    if (frame_pending_.exchange(true)) {
+      dropped_frames_++;
+      return;
+    }
+    notified_frames_++;
     if (on_notify_frame_decoded_) {
       on_notify_frame_decoded_();
     }
   }
 
+  // |VideoPlayerStreamHandler|
+  void OnNotifyFrameRenderedInternal() { frame_pending_ = false; }
+
   // |VideoPlayerStreamHandler|
   void OnNotifyCompletedInternal() {
     if (on_notify_completed_) {
@@ -59,10 +111,62 @@ class VideoPlayerStreamHandlerImpl : public VideoPlayerStreamHandler {
     }
   }
 
+  void OnNotifyBufferingInternal(bool is_buffering) {
+    if (on_notify_buffering_) {
+      on_notify_buffering_(is_buffering);
+    }
+  }
+
+  void OnNotifyBufferingUpdateInternal(
+      const std::vector<std::pair<int64_t, int64_t>>& ranges) {
+    if (on_notify_buffering_update_) {
+      on_notify_buffering_update_(ranges);
+    }
+  }
+
+  void OnNotifyVariantSwitchInternal(int32_t width, int32_t height,
+                                     int64_t bitrate) {
+    if (on_notify_variant_switch_) {
+      on_notify_variant_switch_(width, height, bitrate);
+    }
+  }
+
+  void OnNotifyThroughputInternal(int64_t throughput, int64_t bandwidth) {
+    if (on_notify_throughput_) {
+      on_notify_throughput_(throughput, bandwidth);
+    }
+  }
+
+  void OnNotifySubtitleCueInternal(const std::string& text, bool is_markup,
+                                   int64_t start_ms, int64_t duration_ms) {
+    if (on_notify_subtitle_cue_) {
+      on_notify_subtitle_cue_(text, is_markup, start_ms, duration_ms);
+    }
+  }
+
+  void OnNotifyOverlayInternal(
+      const std::vector<OverlayRectangle>& rectangles) {
+    if (on_notify_overlay_) {
+      on_notify_overlay_(rectangles);
+    }
+  }
+
   OnNotifyInitialized on_notify_initialized_;
   OnNotifyFrameDecoded on_notify_frame_decoded_;
   OnNotifyCompleted on_notify_completed_;
   OnNotifyPlaying on_notify_playing_;
+  OnNotifyBuffering on_notify_buffering_;
+  OnNotifyBufferingUpdate on_notify_buffering_update_;
+  OnNotifyVariantSwitch on_notify_variant_switch_;
+  OnNotifyThroughput on_notify_throughput_;
+  OnNotifySubtitleCue on_notify_subtitle_cue_;
+  OnNotifyOverlay on_notify_overlay_;
+
+  // Set from the notification of a frame until the renderer picks it up.
+  std::atomic<bool> frame_pending_{false};
+  std::atomic<uint64_t> decoded_frames_{0};
+  std::atomic<uint64_t> notified_frames_{0};
+  std::atomic<uint64_t> dropped_frames_{0};
 };
 
 #endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_IMPL_H_
@@ -0,0 +1,628 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "yuv_texture_renderer.h"
+
+#include <gst/allocators/gstdmabuf.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+constexpr EGLint MakeFourcc(char a, char b, char c, char d) {
+  return static_cast<EGLint>(static_cast<uint32_t>(a) |
+                             (static_cast<uint32_t>(b) << 8) |
+                             (static_cast<uint32_t>(c) << 16) |
+                             (static_cast<uint32_t>(d) << 24));
+}
+// DRM_FORMAT_R8 and DRM_FORMAT_GR88 in drm_fourcc.h.
+constexpr EGLint kDrmFormatR8 = MakeFourcc('R', '8', ' ', ' ');
+constexpr EGLint kDrmFormatGR88 = MakeFourcc('G', 'R', '8', '8');
+
+// The plane EGLImages of a DMABUF memory, attached to the memory so that a
+// decoder pool recycling a fixed set of buffers costs no EGL allocations at
+// steady state, and destroyed with the memory. eglDestroyImageKHR() needs no
+// current context, so this is safe on the streaming thread freeing it.
+struct PlaneImages {
+  struct Plane {
+    EGLint offset = -1;
+    EGLint stride = 0;
+    EGLImageKHR image = EGL_NO_IMAGE_KHR;
+  };
+
+  EGLDisplay display = EGL_NO_DISPLAY;
+  PFNEGLDESTROYIMAGEKHRPROC destroy_image = nullptr;
+  GstVideoFormat format = GST_VIDEO_FORMAT_UNKNOWN;
+  gint width = 0;
+  gint height = 0;
+  Plane planes[GST_VIDEO_MAX_PLANES];
+};
+
+void DestroyPlaneImages(gpointer data) {
+  auto* images = static_cast<PlaneImages*>(data);
+  for (auto& plane : images->planes) {
+    if (plane.image != EGL_NO_IMAGE_KHR) {
+      images->destroy_image(images->display, plane.image);
+    }
+  }
+  delete images;
+}
+
+GQuark GetPlaneImagesQuark() {
+  static const GQuark quark =
+      g_quark_from_static_string("YuvTextureRendererPlaneImages");
+  return quark;
+}
+
+constexpr GLuint kPositionAttribute = 0;
+constexpr GLuint kTexcoordAttribute = 1;
+
+// A full-screen quad. Texture row 0 is drawn at the bottom, so that the
+// output keeps the row order of the decoded frame.
+constexpr GLfloat kQuadVertices[] = {
+    // x, y, u, v
+    -1.0f, -1.0f, 0.0f, 0.0f,  //
+    1.0f,  -1.0f, 1.0f, 0.0f,  //
+    -1.0f, 1.0f,  0.0f, 1.0f,  //
+    1.0f,  1.0f,  1.0f, 1.0f,  //
+};
+
+constexpr char kVertexShader[] = R"(
+attribute vec2 a_position;
+attribute vec2 a_texcoord;
+varying vec2 v_texcoord;
+void main() {
+  v_texcoord = a_texcoord;
+  gl_Position = vec4(a_position, 0.0, 1.0);
+}
+)";
+
+constexpr char kFragmentShader[] = R"(
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+varying vec2 v_texcoord;
+uniform sampler2D u_plane0;
+uniform sampler2D u_plane1;
+uniform sampler2D u_plane2;
+uniform float u_luma_scale;
+uniform float u_chroma_scale;
+uniform mat3 u_matrix;
+uniform vec3 u_offset;
+void main() {
+  vec3 yuv;
+  yuv.x = texture2D(u_plane0, vec2(v_texcoord.x * u_luma_scale,
+                                   v_texcoord.y)).r;
+  vec2 chroma_coord = vec2(v_texcoord.x * u_chroma_scale, v_texcoord.y);
+  yuv.yz = SAMPLE_CHROMA(chroma_coord);
+  gl_FragColor = vec4(u_matrix * (yuv - u_offset), 1.0);
+}
+)";
+
+// Indexed by YuvTextureRenderer::ChromaLayout.
+constexpr const char* kSampleChromaDefines[] = {
+    "#define SAMPLE_CHROMA(c) texture2D(u_plane1, c).rg\n",
+    "#define SAMPLE_CHROMA(c) texture2D(u_plane1, c).ra\n",
+    "#define SAMPLE_CHROMA(c) "
+    "vec2(texture2D(u_plane1, c).r, texture2D(u_plane2, c).r)\n",
+};
+
+bool HasExtension(const char* extensions, const char* name) {
+  if (!extensions) {
+    return false;
+  }
+  const auto length = std::strlen(name);
+  for (const char* p = extensions; (p = std::strstr(p, name)); p += length) {
+    if ((p == extensions || p[-1] == ' ') &&
+        (p[length] == ' ' || p[length] == '\0')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+GLuint CompileShader(GLenum type, const char* const* sources, GLsizei count) {
+  auto shader = glCreateShader(type);
+  glShaderSource(shader, count, sources, nullptr);
+  glCompileShader(shader);
+
+  GLint status = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if (status != GL_TRUE) {
+    GLchar log[512] = {};
+    glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+    std::cerr << "Failed to compile a shader: " << log << std::endl;
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+void GetPlaneLayout(GstBuffer* buffer, const GstVideoInfo& info, guint plane,
+                    gsize& offset, gint& stride) {
+  auto* meta = gst_buffer_get_video_meta(buffer);
+  if (meta) {
+    offset = meta->offset[plane];
+    stride = meta->stride[plane];
+  } else {
+    offset = GST_VIDEO_INFO_PLANE_OFFSET(&info, plane);
+    stride = GST_VIDEO_INFO_PLANE_STRIDE(&info, plane);
+  }
+}
+
+// Computes the matrix that converts (Y, U, V) minus |offset| to RGB, in
+// column-major order.
+void GetColorMatrix(const GstVideoInfo& info, GLfloat matrix[9],
+                    GLfloat offset[3]) {
+  gdouble kr = 0.299;
+  gdouble kb = 0.114;
+  if (!gst_video_color_matrix_get_Kr_Kb(info.colorimetry.matrix, &kr, &kb)) {
+    // Falls back to BT.601.
+    kr = 0.299;
+    kb = 0.114;
+  }
+  const gdouble kg = 1.0 - kr - kb;
+
+  const bool full_range =
+      info.colorimetry.range == GST_VIDEO_COLOR_RANGE_0_255;
+  const gdouble luma_scale = full_range ? 1.0 : 255.0 / 219.0;
+  const gdouble chroma_scale = full_range ? 1.0 : 255.0 / 224.0;
+  offset[0] = full_range ? 0.0f : 16.0f / 255.0f;
+  offset[1] = 128.0f / 255.0f;
+  offset[2] = 128.0f / 255.0f;
+
+  // Y column.
+  matrix[0] = luma_scale;
+  matrix[1] = luma_scale;
+  matrix[2] = luma_scale;
+  // U column.
+  matrix[3] = 0.0f;
+  matrix[4] = -chroma_scale * 2.0 * kb * (1.0 - kb) / kg;
+  matrix[5] = chroma_scale * 2.0 * (1.0 - kb);
+  // V column.
+  matrix[6] = chroma_scale * 2.0 * (1.0 - kr);
+  matrix[7] = -chroma_scale * 2.0 * kr * (1.0 - kr) / kg;
+  matrix[8] = 0.0f;
+}
+
+// Saves the GL state the renderer touches and restores it on destruction, so
+// that the Flutter engine's cached state stays valid.
+class ScopedGlState {
+ public:
+  ScopedGlState() {
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer_);
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program_);
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &active_texture_);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &array_buffer_);
+    glGetIntegerv(GL_VIEWPORT, viewport_);
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpack_alignment_);
+    for (int i = 0; i < 3; i++) {
+      glActiveTexture(GL_TEXTURE0 + i);
+      glGetIntegerv(GL_TEXTURE_BINDING_2D, &textures_[i]);
+    }
+    for (int i = 0; i < kCapabilityCount; i++) {
+      enabled_[i] = glIsEnabled(kCapabilities[i]);
+      glDisable(kCapabilities[i]);
+    }
+  }
+
+  ~ScopedGlState() {
+    for (int i = 0; i < kCapabilityCount; i++) {
+      if (enabled_[i]) {
+        glEnable(kCapabilities[i]);
+      }
+    }
+    for (int i = 0; i < 3; i++) {
+      glActiveTexture(GL_TEXTURE0 + i);
+      glBindTexture(GL_TEXTURE_2D, textures_[i]);
+    }
+    glActiveTexture(active_texture_);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, unpack_alignment_);
+    glViewport(viewport_[0], viewport_[1], viewport_[2], viewport_[3]);
+    glBindBuffer(GL_ARRAY_BUFFER, array_buffer_);
+    glUseProgram(program_);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+  }
+
+ private:
+  static constexpr int kCapabilityCount = 5;
+  static constexpr GLenum kCapabilities[kCapabilityCount] = {
+      GL_SCISSOR_TEST, GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST,
+      GL_CULL_FACE};
+
+  GLint framebuffer_ = 0;
+  GLint program_ = 0;
+  GLint active_texture_ = GL_TEXTURE0;
+  GLint array_buffer_ = 0;
+  GLint viewport_[4] = {0, 0, 0, 0};
+  GLint unpack_alignment_ = 4;
+  GLint textures_[3] = {0, 0, 0};
+  GLboolean enabled_[kCapabilityCount] = {};
+};
+}  // namespace
+
+YuvTextureRenderer::~YuvTextureRenderer() {
+  DestroyTargets();
+  // GL objects can only be deleted with their context current. Otherwise
+  // they are released together with the context.
+  if (context_ != EGL_NO_CONTEXT && eglGetCurrentContext() == context_) {
+    glDeleteTextures(3, plane_textures_);
+    for (auto& program : programs_) {
+      if (program.id) {
+        glDeleteProgram(program.id);
+      }
+    }
+  }
+}
+
+// static
+bool YuvTextureRenderer::IsSupportedFormat(GstVideoFormat format) {
+  return format == GST_VIDEO_FORMAT_NV12 || format == GST_VIDEO_FORMAT_I420;
+}
+
+void* YuvTextureRenderer::Render(GstBuffer* buffer, const GstVideoInfo& info,
+                                 void* egl_display, void* egl_context) {
+  const auto format = GST_VIDEO_INFO_FORMAT(&info);
+  if (!IsSupportedFormat(format)) {
+    std::cerr << "Unsupported video format: "
+              << gst_video_format_to_string(format) << std::endl;
+    return nullptr;
+  }
+  if (!EnsureInitialized(reinterpret_cast<EGLDisplay>(egl_display),
+                         reinterpret_cast<EGLContext>(egl_context))) {
+    return nullptr;
+  }
+
+  ScopedGlState state;
+  if (!EnsureTargets(GST_VIDEO_INFO_WIDTH(&info),
+                     GST_VIDEO_INFO_HEIGHT(&info))) {
+    return nullptr;
+  }
+  if (!(has_dmabuf_import_ && ImportPlanes(buffer, info)) &&
+      !UploadPlanes(buffer, info)) {
+    std::cerr << "Failed to upload a video frame" << std::endl;
+    return nullptr;
+  }
+  const auto* program = GetProgram(layout_);
+  if (!program) {
+    return nullptr;
+  }
+
+  current_target_ = (current_target_ + 1) % 2;
+  const auto& target = targets_[current_target_];
+  Draw(*program, info, target);
+  return reinterpret_cast<void*>(target.image);
+}
+
+bool YuvTextureRenderer::EnsureInitialized(EGLDisplay display,
+                                           EGLContext context) {
+  // Makes the context current in the same way as gst_gl_context_activate()
+  // does for the RGBA DMABUF path.
+  if (eglGetCurrentContext() != context &&
+      !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+    std::cerr << "Failed to make the Flutter GL context current" << std::endl;
+    return false;
+  }
+  if (context_ != EGL_NO_CONTEXT) {
+    return context_ == context;
+  }
+
+  const auto* extensions = eglQueryString(display, EGL_EXTENSIONS);
+  if (!HasExtension(extensions, "EGL_KHR_gl_texture_2D_image")) {
+    std::cerr << "EGL_KHR_gl_texture_2D_image is not supported" << std::endl;
+    return false;
+  }
+  has_dmabuf_import_ =
+      HasExtension(extensions, "EGL_EXT_image_dma_buf_import");
+
+  egl_create_image_ = reinterpret_cast<PFNEGLCREATEIMAGEKHRPROC>(
+      eglGetProcAddress("eglCreateImageKHR"));
+  egl_destroy_image_ = reinterpret_cast<PFNEGLDESTROYIMAGEKHRPROC>(
+      eglGetProcAddress("eglDestroyImageKHR"));
+  gl_egl_image_target_texture_ =
+      reinterpret_cast<PFNGLEGLIMAGETARGETTEXTURE2DOESPROC>(
+          eglGetProcAddress("glEGLImageTargetTexture2DOES"));
+  if (!egl_create_image_ || !egl_destroy_image_ ||
+      !gl_egl_image_target_texture_) {
+    std::cerr << "Failed to get the EGLImage entry points" << std::endl;
+    return false;
+  }
+
+  glGenTextures(3, plane_textures_);
+  for (auto texture : plane_textures_) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  }
+
+  display_ = display;
+  context_ = context;
+  std::cout << "YUV texture renderer: DMABUF import "
+            << (has_dmabuf_import_ ? "enabled" : "disabled") << std::endl;
+  return true;
+}
+
+bool YuvTextureRenderer::EnsureTargets(int32_t width, int32_t height) {
+  if (width == target_width_ && height == target_height_) {
+    return true;
+  }
+  DestroyTargets();
+
+  for (auto& target : targets_) {
+    glGenTextures(1, &target.texture);
+    glBindTexture(GL_TEXTURE_2D, target.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, nullptr);
+
+    glGenFramebuffers(1, &target.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D, target.texture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+      std::cerr << "Failed to create a framebuffer" << std::endl;
+      DestroyTargets();
+      return false;
+    }
+
+    const EGLint attribs[] = {EGL_GL_TEXTURE_LEVEL_KHR, 0, EGL_NONE};
+    target.image = egl_create_image_(
+        display_, context_, EGL_GL_TEXTURE_2D_KHR,
+        reinterpret_cast<EGLClientBuffer>(
+            static_cast<uintptr_t>(target.texture)),
+        attribs);
+    if (target.image == EGL_NO_IMAGE_KHR) {
+      std::cerr << "Failed to create an EGLImage: " << eglGetError()
+                << std::endl;
+      DestroyTargets();
+      return false;
+    }
+  }
+
+  target_width_ = width;
+  target_height_ = height;
+  return true;
+}
+
+const YuvTextureRenderer::Program* YuvTextureRenderer::GetProgram(
+    ChromaLayout layout) {
+  auto& program = programs_[layout];
+  if (program.id) {
+    return &program;
+  }
+
+  const char* vertex_sources[] = {kVertexShader};
+  const char* fragment_sources[] = {kSampleChromaDefines[layout],
+                                    kFragmentShader};
+  auto vertex_shader = CompileShader(GL_VERTEX_SHADER, vertex_sources, 1);
+  auto fragment_shader =
+      CompileShader(GL_FRAGMENT_SHADER, fragment_sources, 2);
+  if (!vertex_shader || !fragment_shader) {
+    glDeleteShader(vertex_shader);
+    glDeleteShader(fragment_shader);
+    return nullptr;
+  }
+
+  auto id = glCreateProgram();
+  glAttachShader(id, vertex_shader);
+  glAttachShader(id, fragment_shader);
+  glBindAttribLocation(id, kPositionAttribute, "a_position");
+  glBindAttribLocation(id, kTexcoordAttribute, "a_texcoord");
+  glLinkProgram(id);
+  glDeleteShader(vertex_shader);
+  glDeleteShader(fragment_shader);
+
+  GLint status = GL_FALSE;
+  glGetProgramiv(id, GL_LINK_STATUS, &status);
+  if (status != GL_TRUE) {
+    GLchar log[512] = {};
+    glGetProgramInfoLog(id, sizeof(log), nullptr, log);
+    std::cerr << "Failed to link a shader program: " << log << std::endl;
+    glDeleteProgram(id);
+    return nullptr;
+  }
+
+  program.id = id;
+  for (int i = 0; i < 3; i++) {
+    const auto name = "u_plane" + std::to_string(i);
+    program.planes[i] = glGetUniformLocation(id, name.c_str());
+  }
+  program.luma_scale = glGetUniformLocation(id, "u_luma_scale");
+  program.chroma_scale = glGetUniformLocation(id, "u_chroma_scale");
+  program.matrix = glGetUniformLocation(id, "u_matrix");
+  program.offset = glGetUniformLocation(id, "u_offset");
+  return &program;
+}
+
+bool YuvTextureRenderer::ImportPlanes(GstBuffer* buffer,
+                                      const GstVideoInfo& info) {
+  const auto format = GST_VIDEO_INFO_FORMAT(&info);
+  const gint width = GST_VIDEO_INFO_WIDTH(&info);
+  const gint height = GST_VIDEO_INFO_HEIGHT(&info);
+
+  const auto n_planes = GST_VIDEO_INFO_N_PLANES(&info);
+  for (guint plane = 0; plane < n_planes; plane++) {
+    gsize offset;
+    gint stride;
+    GetPlaneLayout(buffer, info, plane, offset, stride);
+
+    guint index, length;
+    gsize skip;
+    if (!gst_buffer_find_memory(buffer, offset, 1, &index, &length, &skip)) {
+      return false;
+    }
+    auto* memory = gst_buffer_peek_memory(buffer, index);
+    if (!gst_is_dmabuf_memory(memory)) {
+      return false;
+    }
+
+    const EGLint fd = gst_dmabuf_memory_get_fd(memory);
+    const auto plane_offset = static_cast<EGLint>(memory->offset + skip);
+    // The planes of I420 usually share a memory.
+    auto* images = static_cast<PlaneImages*>(gst_mini_object_get_qdata(
+        GST_MINI_OBJECT_CAST(memory), GetPlaneImagesQuark()));
+    if (!images || images->display != display_ || images->format != format ||
+        images->width != width || images->height != height) {
+      images = new PlaneImages();
+      images->display = display_;
+      images->destroy_image = egl_destroy_image_;
+      images->format = format;
+      images->width = width;
+      images->height = height;
+      // Destroys the images made for the previous format or size, if any.
+      gst_mini_object_set_qdata(GST_MINI_OBJECT_CAST(memory),
+                                GetPlaneImagesQuark(), images,
+                                &DestroyPlaneImages);
+    }
+    auto& cached = images->planes[plane];
+    if (cached.image == EGL_NO_IMAGE_KHR || cached.offset != plane_offset ||
+        cached.stride != stride) {
+      if (cached.image != EGL_NO_IMAGE_KHR) {
+        egl_destroy_image_(display_, cached.image);
+        cached.image = EGL_NO_IMAGE_KHR;
+      }
+
+      const bool chroma = plane > 0;
+      const bool interleaved = chroma && format == GST_VIDEO_FORMAT_NV12;
+      const EGLint attribs[] = {
+          EGL_WIDTH,
+          chroma ? (width + 1) / 2 : width,
+          EGL_HEIGHT,
+          chroma ? (height + 1) / 2 : height,
+          EGL_LINUX_DRM_FOURCC_EXT,
+          interleaved ? kDrmFormatGR88 : kDrmFormatR8,
+          EGL_DMA_BUF_PLANE0_FD_EXT,
+          fd,
+          EGL_DMA_BUF_PLANE0_OFFSET_EXT,
+          plane_offset,
+          EGL_DMA_BUF_PLANE0_PITCH_EXT,
+          stride,
+          EGL_NONE,
+      };
+      auto image = egl_create_image_(display_, EGL_NO_CONTEXT,
+                                     EGL_LINUX_DMA_BUF_EXT, nullptr, attribs);
+      if (image == EGL_NO_IMAGE_KHR) {
+        return false;
+      }
+      cached.offset = plane_offset;
+      cached.stride = stride;
+      cached.image = image;
+    }
+    glBindTexture(GL_TEXTURE_2D, plane_textures_[plane]);
+    gl_egl_image_target_texture_(GL_TEXTURE_2D, cached.image);
+  }
+
+  layout_ = format == GST_VIDEO_FORMAT_NV12 ? kChromaLayoutRG
+                                            : kChromaLayoutPlanar;
+  luma_scale_ = 1.0f;
+  chroma_scale_ = 1.0f;
+  return true;
+}
+
+bool YuvTextureRenderer::UploadPlanes(GstBuffer* buffer,
+                                      const GstVideoInfo& info) {
+  GstVideoFrame frame;
+  if (!gst_video_frame_map(&frame, &info, buffer, GST_MAP_READ)) {
+    return false;
+  }
+
+  const auto format = GST_VIDEO_INFO_FORMAT(&info);
+  const gint width = GST_VIDEO_INFO_WIDTH(&info);
+  const gint height = GST_VIDEO_INFO_HEIGHT(&info);
+  const auto n_planes = GST_VIDEO_INFO_N_PLANES(&info);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  for (guint plane = 0; plane < n_planes; plane++) {
+    const bool chroma = plane > 0;
+    const bool interleaved = chroma && format == GST_VIDEO_FORMAT_NV12;
+    const GLenum gl_format = interleaved ? GL_LUMINANCE_ALPHA : GL_LUMINANCE;
+    const gint texel_bytes = interleaved ? 2 : 1;
+    // GLES2 has no GL_UNPACK_ROW_LENGTH, so padded rows are uploaded as is
+    // and cropped in the shader.
+    const gint texture_width =
+        GST_VIDEO_FRAME_PLANE_STRIDE(&frame, plane) / texel_bytes;
+    const gint plane_width = chroma ? (width + 1) / 2 : width;
+    const gint plane_height = chroma ? (height + 1) / 2 : height;
+
+    glBindTexture(GL_TEXTURE_2D, plane_textures_[plane]);
+    glTexImage2D(GL_TEXTURE_2D, 0, gl_format, texture_width, plane_height, 0,
+                 gl_format, GL_UNSIGNED_BYTE,
+                 GST_VIDEO_FRAME_PLANE_DATA(&frame, plane));
+
+    const auto scale = static_cast<GLfloat>(plane_width) / texture_width;
+    if (chroma) {
+      chroma_scale_ = scale;
+    } else {
+      luma_scale_ = scale;
+    }
+  }
+  gst_video_frame_unmap(&frame);
+
+  layout_ = format == GST_VIDEO_FORMAT_NV12 ? kChromaLayoutRA
+                                            : kChromaLayoutPlanar;
+  return true;
+}
+
+void YuvTextureRenderer::Draw(const Program& program, const GstVideoInfo& info,
+                              const Target& target) {
+  glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+  glViewport(0, 0, target_width_, target_height_);
+  glUseProgram(program.id);
+
+  for (int i = 0; i < 3; i++) {
+    glActiveTexture(GL_TEXTURE0 + i);
+    glBindTexture(GL_TEXTURE_2D, plane_textures_[i]);
+    glUniform1i(program.planes[i], i);
+  }
+  glUniform1f(program.luma_scale, luma_scale_);
+  glUniform1f(program.chroma_scale, chroma_scale_);
+
+  GLfloat matrix[9];
+  GLfloat offset[3];
+  GetColorMatrix(info, matrix, offset);
+  glUniformMatrix3fv(program.matrix, 1, GL_FALSE, matrix);
+  glUniform3fv(program.offset, 1, offset);
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glVertexAttribPointer(kPositionAttribute, 2, GL_FLOAT, GL_FALSE,
+                        4 * sizeof(GLfloat), kQuadVertices);
+  glVertexAttribPointer(kTexcoordAttribute, 2, GL_FLOAT, GL_FALSE,
+                        4 * sizeof(GLfloat), kQuadVertices + 2);
+  glEnableVertexAttribArray(kPositionAttribute);
+  glEnableVertexAttribArray(kTexcoordAttribute);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  glDisableVertexAttribArray(kPositionAttribute);
+  glDisableVertexAttribArray(kTexcoordAttribute);
+
+  // Flutter samples the image in the same context right after this.
+  glFlush();
+}
+
+void YuvTextureRenderer::DestroyTargets() {
+  const bool current =
+      context_ != EGL_NO_CONTEXT && eglGetCurrentContext() == context_;
+  for (auto& target : targets_) {
+    if (target.image != EGL_NO_IMAGE_KHR) {
+      egl_destroy_image_(display_, target.image);
+    }
+    if (current) {
+      if (target.framebuffer) {
+        glDeleteFramebuffers(1, &target.framebuffer);
+      }
+      if (target.texture) {
+        glDeleteTextures(1, &target.texture);
+      }
+    }
+    target = Target();
+  }
+  target_width_ = 0;
+  target_height_ = 0;
+}
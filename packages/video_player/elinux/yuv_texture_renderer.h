@@ -0,0 +1,101 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_YUV_TEXTURE_RENDERER_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_YUV_TEXTURE_RENDERER_H_
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+// Converts NV12 / I420 frames to RGBA with a fragment shader and hands the
+// result to Flutter as an EGLImage.
+//
+// The planes are imported as EGLImages when the frame lives in DMABUF memory
+// and the driver supports EGL_EXT_image_dma_buf_import, and are uploaded as
+// luminance textures otherwise. Either way, the CPU never touches a
+// full-size RGBA frame.
+//
+// All the methods must be called on the raster thread, i.e. from the
+// EGLImage texture callback.
+class YuvTextureRenderer {
+ public:
+  YuvTextureRenderer() = default;
+  ~YuvTextureRenderer();
+
+  // Prevent copying.
+  YuvTextureRenderer(YuvTextureRenderer const&) = delete;
+  YuvTextureRenderer& operator=(YuvTextureRenderer const&) = delete;
+
+  static bool IsSupportedFormat(GstVideoFormat format);
+
+  // Renders |buffer| described by |info| and returns the EGLImage of the
+  // converted frame, or nullptr on failure. The returned image stays valid
+  // until the next-but-one call.
+  void* Render(GstBuffer* buffer, const GstVideoInfo& info, void* egl_display,
+               void* egl_context);
+
+ private:
+  // How the chroma samples are laid out in the plane textures.
+  enum ChromaLayout {
+    // NV12 imported as GR88: U in .r, V in .g.
+    kChromaLayoutRG = 0,
+    // NV12 uploaded as GL_LUMINANCE_ALPHA: U in .r, V in .a.
+    kChromaLayoutRA,
+    // I420: U and V in separate planes.
+    kChromaLayoutPlanar,
+    kChromaLayoutCount,
+  };
+
+  struct Program {
+    GLuint id = 0;
+    GLint planes[3] = {-1, -1, -1};
+    GLint luma_scale = -1;
+    GLint chroma_scale = -1;
+    GLint matrix = -1;
+    GLint offset = -1;
+  };
+
+  struct Target {
+    GLuint texture = 0;
+    GLuint framebuffer = 0;
+    EGLImageKHR image = EGL_NO_IMAGE_KHR;
+  };
+
+  bool EnsureInitialized(EGLDisplay display, EGLContext context);
+  bool EnsureTargets(int32_t width, int32_t height);
+  const Program* GetProgram(ChromaLayout layout);
+  bool ImportPlanes(GstBuffer* buffer, const GstVideoInfo& info);
+  bool UploadPlanes(GstBuffer* buffer, const GstVideoInfo& info);
+  void Draw(const Program& program, const GstVideoInfo& info,
+            const Target& target);
+  void DestroyTargets();
+
+  EGLDisplay display_ = EGL_NO_DISPLAY;
+  EGLContext context_ = EGL_NO_CONTEXT;
+  bool has_dmabuf_import_ = false;
+  PFNEGLCREATEIMAGEKHRPROC egl_create_image_ = nullptr;
+  PFNEGLDESTROYIMAGEKHRPROC egl_destroy_image_ = nullptr;
+  PFNGLEGLIMAGETARGETTEXTURE2DOESPROC gl_egl_image_target_texture_ = nullptr;
+
+  Program programs_[kChromaLayoutCount];
+  ChromaLayout layout_ = kChromaLayoutRG;
+  GLuint plane_textures_[3] = {0, 0, 0};
+  // The visible part of the plane textures, which may be wider than the
+  // frame when the rows are padded.
+  GLfloat luma_scale_ = 1.0f;
+  GLfloat chroma_scale_ = 1.0f;
+
+  // Double-buffered so that Flutter can still sample the previous frame
+  // while the next one is being drawn.
+  Target targets_[2];
+  int32_t target_width_ = 0;
+  int32_t target_height_ = 0;
+  int current_target_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_YUV_TEXTURE_RENDERER_H_
@@ -4,21 +4,600 @@
 // found in the LICENSE file.
 
 import 'dart:async';
+import 'dart:ffi';
+import 'dart:typed_data';
 
 import 'package:flutter/services.dart';
 import 'package:flutter/widgets.dart';
 import 'package:video_player_platform_interface/video_player_platform_interface.dart';
 
 import 'messages.g.dart';
+import 'platform_tasks.dart';
+
+/// How an RTSP player receives the media packets.
+enum RtspTransport {
+  /// Interleaved in the RTSP TCP connection. The most reliable transport,
+  /// and the default.
+  tcp,
+
+  /// Unicast UDP. Lower latency, but packets may be lost.
+  udp,
+
+  /// Multicast UDP.
+  multicast,
+
+  /// UDP, falling back to TCP when no UDP packet arrives, e.g. behind a NAT.
+  udpFirst,
+}
+
+/// Where [ELinuxVideoPlayer.seekToWithMode] lands.
+enum SeekMode {
+  /// On a key frame near the position. The fastest, and what
+  /// [ELinuxVideoPlayer.seekTo] does.
+  keyUnit,
+
+  /// On the exact position, decoding from the key frame before it.
+  accurate,
+
+  /// On the last key frame at or before the position.
+  snapBefore,
+
+  /// On the first key frame at or after the position.
+  snapAfter,
+}
+
+/// The encoding of a frame returned by [ELinuxVideoPlayer.extractFrame] or
+/// [ELinuxVideoPlayer.captureFrame].
+enum VideoFrameFormat {
+  /// Tightly packed RGBA pixels, e.g. for `decodeImageFromPixels`.
+  rgba,
+
+  /// A PNG image, e.g. for `Image.memory`.
+  png,
+
+  /// A JPEG image, encoded in hardware when the device can. Only
+  /// [ELinuxVideoPlayer.captureFrame] supports it.
+  jpeg,
+}
+
+/// A frame to extract with [ELinuxVideoPlayer.extractFrames].
+class VideoFrameRequest {
+  /// Constructs an instance with the given values.
+  const VideoFrameRequest({
+    required this.uri,
+    this.position = Duration.zero,
+    this.maxWidth,
+    this.format = VideoFrameFormat.png,
+  });
+
+  /// The uri or path of the video.
+  final String uri;
+
+  /// Where to take the frame. The frame is taken at the key frame at or
+  /// before the position.
+  final Duration position;
+
+  /// The width to scale the frame down to, keeping its aspect ratio, or null
+  /// to keep the width of the video.
+  final int? maxWidth;
+
+  /// The encoding of the frame.
+  final VideoFrameFormat format;
+}
+
+/// A frame extracted from a video.
+class VideoFrame {
+  /// Constructs an instance with the given values.
+  const VideoFrame({
+    required this.width,
+    required this.height,
+    required this.format,
+    required this.bytes,
+  });
+
+  /// The width of the frame in pixels.
+  final int width;
+
+  /// The height of the frame in pixels.
+  final int height;
+
+  /// The encoding of [bytes].
+  final VideoFrameFormat format;
+
+  /// The pixels or the encoded image.
+  final Uint8List bytes;
+}
+
+/// A sprite sheet of a video file generated by
+/// [ELinuxVideoPlayer.generateSpriteSheet], e.g. for the previews of a
+/// timeline.
+///
+/// Load the image at [path] once, e.g. with `FileImage`, and draw the
+/// [getPreviewAt] rectangle of it for the previews.
+class VideoSpriteSheet {
+  /// Constructs an instance with the given values.
+  const VideoSpriteSheet({
+    required this.path,
+    required this.interval,
+    required this.tileSize,
+    required this.columns,
+    required this.count,
+  });
+
+  /// The JPEG image of the tiles.
+  final String path;
+
+  /// The time between the tiles.
+  final Duration interval;
+
+  /// The size of a tile in pixels.
+  final Size tileSize;
+
+  /// The number of tiles in a row of the image.
+  final int columns;
+
+  /// The number of tiles.
+  final int count;
+
+  /// Returns the rectangle of the image showing [position], which is the
+  /// last key frame at or before the start of its interval.
+  Rect getPreviewAt(Duration position) {
+    final int index = (position.inMilliseconds ~/ interval.inMilliseconds)
+        .clamp(0, count - 1);
+    return Offset((index % columns) * tileSize.width,
+            (index ~/ columns) * tileSize.height) &
+        tileSize;
+  }
+}
+
+/// The streaming threads a [ELinuxVideoPlayer.setThreadPolicy] applies to.
+enum VideoThreadRole {
+  /// The threads receiving from the network, e.g. of `udpsrc` or
+  /// `souphttpsrc`.
+  network,
+
+  /// The threads demuxing, decoding and converting the frames.
+  streaming,
+}
+
+/// The pixel format of a [VideoFrameBuffer].
+enum VideoFrameBufferFormat {
+  /// RGBA, 4 bytes per pixel.
+  rgba,
+
+  /// The luma plane of a YUV frame, 1 byte per pixel, when the plugin is
+  /// built with GPU YUV conversion.
+  gray8,
+}
+
+/// A decoded frame of [ELinuxVideoPlayer.frameStream], in memory shared with
+/// the plugin.
+///
+/// The slot of the frame is reused only after [release] is called, so call
+/// it as soon as the pixels are no longer needed. The pixels must not be
+/// read after [release] or after the stream is cancelled.
+class VideoFrameBuffer {
+  VideoFrameBuffer._({
+    required this.sequence,
+    required this.width,
+    required this.height,
+    required this.stride,
+    required this.format,
+    required this.timestamp,
+    required this.droppedFrames,
+    required int address,
+    required int size,
+    required int stateAddress,
+  })  : _address = address,
+        _size = size,
+        _stateAddress = stateAddress;
+
+  /// The number of the frame in the stream, counting the frames sent.
+  final int sequence;
+
+  /// The width of the frame in pixels.
+  final int width;
+
+  /// The height of the frame in pixels.
+  final int height;
+
+  /// The number of bytes between the starts of two rows.
+  final int stride;
+
+  /// The pixel format of [pixels].
+  final VideoFrameBufferFormat format;
+
+  /// The presentation timestamp of the frame, or null if unknown.
+  final Duration? timestamp;
+
+  /// The frames dropped so far because every slot was still held.
+  final int droppedFrames;
+
+  final int _address;
+  final int _size;
+  final int _stateAddress;
+  bool _isReleased = false;
+
+  /// A view of the pixels, without a copy.
+  Uint8List get pixels {
+    assert(!_isReleased);
+    return Pointer<Uint8>.fromAddress(_address).asTypedList(_size);
+  }
+
+  /// Gives the slot of the frame back to the plugin.
+  void release() {
+    if (_isReleased) {
+      return;
+    }
+    _isReleased = true;
+    Pointer<Uint32>.fromAddress(_stateAddress).value = 0;
+  }
+}
+
+/// The playback position of a player, from
+/// [ELinuxVideoPlayer.getPositions] or
+/// [ELinuxVideoPlayer.positionUpdatesFor].
+class VideoPlayerPosition {
+  /// Constructs an instance with the given values.
+  const VideoPlayerPosition({
+    required this.position,
+    required this.duration,
+    required this.isBuffering,
+  });
+
+  /// The current position, or null until the player is initialized.
+  final Duration? position;
+
+  /// The duration, or null for live streams and until the player is
+  /// initialized.
+  final Duration? duration;
+
+  /// Whether the playback is stalled on buffering or reconnecting.
+  final bool isBuffering;
+}
+
+/// A switch of an adaptive stream to another variant, from
+/// [ELinuxVideoPlayer.variantSwitchesFor].
+class VideoVariantSwitch {
+  /// Constructs an instance with the given values.
+  const VideoVariantSwitch({
+    required this.size,
+    required this.bitrate,
+    required this.bandwidth,
+  });
+
+  /// The decoded size of the new variant.
+  final Size size;
+
+  /// The bitrate of the new variant in bits per second, or zero if the
+  /// demuxer doesn't tell.
+  final int bitrate;
+
+  /// The bandwidth measured over the recent fragments in bits per second.
+  final int bandwidth;
+}
+
+/// The throughput of a fragment of an adaptive stream, from
+/// [ELinuxVideoPlayer.throughputFor].
+class VideoThroughput {
+  /// Constructs an instance with the given values.
+  const VideoThroughput({
+    required this.throughput,
+    required this.bandwidth,
+  });
+
+  /// The throughput of the fragment in bits per second.
+  final int throughput;
+
+  /// The bandwidth measured over the recent fragments in bits per second.
+  final int bandwidth;
+}
+
+/// A text subtitle of a file, from [ELinuxVideoPlayer.subtitleCuesFor].
+class VideoSubtitleCue {
+  /// Constructs an instance with the given values.
+  const VideoSubtitleCue({
+    required this.text,
+    required this.isMarkup,
+    required this.start,
+    this.duration,
+  });
+
+  /// The text of the cue. Pango markup, e.g. `<i>`, if [isMarkup].
+  final String text;
+
+  /// Whether [text] is Pango markup rather than plain text.
+  final bool isMarkup;
+
+  /// The position of the video the cue starts at.
+  final Duration start;
+
+  /// How long the cue is shown, or null until the next cue if the stream
+  /// doesn't tell.
+  final Duration? duration;
+}
+
+/// A bitmap drawn over the video by an element of the pipeline, from
+/// [ELinuxVideoPlayer.overlaysFor].
+class VideoOverlayRectangle {
+  /// Constructs an instance with the given values.
+  const VideoOverlayRectangle({
+    required this.rect,
+    required this.pixelSize,
+    required this.pixels,
+  });
+
+  /// Where the bitmap is drawn, in pixels of the video.
+  final Rect rect;
+
+  /// The size of the bitmap, which is scaled to [rect].
+  final Size pixelSize;
+
+  /// The rows of the bitmap in BGRA order without padding, with straight
+  /// alpha.
+  final Uint8List pixels;
+}
+
+/// Network statistics of an RTSP player.
+class RtspTransportStats {
+  /// Constructs an instance with the given values.
+  const RtspTransportStats({
+    required this.transport,
+    required this.packetsReceived,
+    required this.packetsLost,
+    required this.packetsLate,
+    required this.packetsDuplicated,
+    required this.jitter,
+    required this.reconnectAttempts,
+    required this.reconnects,
+    required this.lastReconnectLatency,
+  });
+
+  /// The configured transport.
+  final RtspTransport transport;
+
+  /// The number of packets pushed out of the jitter buffer.
+  final int packetsReceived;
+
+  /// The number of packets that never arrived.
+  final int packetsLost;
+
+  /// The number of packets that arrived too late to be played.
+  final int packetsLate;
+
+  /// The number of packets that arrived more than once.
+  final int packetsDuplicated;
+
+  /// The average interarrival jitter.
+  final Duration jitter;
+
+  /// The number of times the player has restarted the RTSP session after
+  /// losing the stream.
+  final int reconnectAttempts;
+
+  /// The number of times the stream has resumed after being lost.
+  final int reconnects;
+
+  /// The time from losing the stream to its first frame after the last
+  /// reconnect.
+  final Duration lastReconnectLatency;
+}
+
+/// The timeshift buffer of a live player.
+class VideoTimeshift {
+  /// Constructs an instance with the given values.
+  const VideoTimeshift({
+    required this.delay,
+    required this.available,
+  });
+
+  /// How far behind the live edge the stream is played, or [Duration.zero]
+  /// if live.
+  final Duration delay;
+
+  /// How far back the stream can be played.
+  final Duration available;
+}
+
+/// Rolling percentiles of a per-frame latency.
+class FrameLatency {
+  /// Constructs an instance with the given values.
+  const FrameLatency({
+    required this.p50,
+    required this.p95,
+    required this.p99,
+    required this.count,
+  });
+
+  /// The median latency.
+  final Duration p50;
+
+  /// The 95th percentile latency.
+  final Duration p95;
+
+  /// The 99th percentile latency.
+  final Duration p99;
+
+  /// The number of recent frames the percentiles are computed from. Zero if
+  /// the latency can't be measured for this player.
+  final int count;
+}
+
+/// Latency statistics of a player over its recent frames.
+class VideoPlayerStats {
+  /// Constructs an instance with the given values.
+  const VideoPlayerStats({
+    required this.captureToDecode,
+    required this.decodeToHandoff,
+    required this.handoffToTexture,
+    required this.decodeToTexture,
+    required this.glassToGlass,
+    required this.avDrift,
+    required this.droppedFrames,
+    required this.lateFrames,
+    required this.qosDroppedFrames,
+  });
+
+  /// From the capture by the camera to the output of the decoder. Only
+  /// available for RTSP cameras that send RTCP sender reports, and only
+  /// meaningful if the camera and the device are synchronized by NTP.
+  final FrameLatency captureToDecode;
+
+  /// From the output of the decoder to the end of the pipeline.
+  final FrameLatency decodeToHandoff;
+
+  /// From the end of the pipeline to Flutter picking up the frame.
+  final FrameLatency handoffToTexture;
+
+  /// From the output of the decoder to Flutter picking up the frame.
+  final FrameLatency decodeToTexture;
+
+  /// From the capture by the camera to Flutter picking up the frame, with
+  /// the same requirements as [captureToDecode].
+  final FrameLatency glassToGlass;
+
+  /// How late the frames reach the end of the pipeline against its clock,
+  /// which follows the audio while the media has audio, i.e. how far the
+  /// video lags behind the audio. Negative if the frames are early.
+  final FrameLatency avDrift;
+
+  /// The number of decoded frames replaced by a newer one before Flutter
+  /// picked them up.
+  final int droppedFrames;
+
+  /// The number of frames dropped for exceeding the latency budget.
+  final int lateFrames;
+
+  /// The number of frames the decoders skipped while QoS is enabled.
+  final int qosDroppedFrames;
+}
+
+/// A decoder available to the players.
+class VideoDecoderCapability {
+  /// Constructs an instance with the given values.
+  const VideoDecoderCapability({
+    required this.codec,
+    required this.name,
+    required this.isHardware,
+    this.maxWidth,
+    this.maxHeight,
+  });
+
+  /// The codec, e.g. `H264`, `H265`, `AV1`, `VP8`, `VP9` or `JPEG`.
+  final String codec;
+
+  /// The name of the GStreamer element.
+  final String name;
+
+  /// Whether the decoder is hardware accelerated.
+  final bool isHardware;
+
+  /// The largest width the decoder accepts, or null if it doesn't tell.
+  final int? maxWidth;
+
+  /// The largest height the decoder accepts, or null if it doesn't tell.
+  final int? maxHeight;
+}
+
+/// A color converter or compositor available to the players.
+class VideoElementCapability {
+  /// Constructs an instance with the given values.
+  const VideoElementCapability({
+    required this.name,
+    required this.isHardware,
+  });
+
+  /// The name of the backend, after its main GStreamer element.
+  final String name;
+
+  /// Whether the backend is hardware accelerated.
+  final bool isHardware;
+}
+
+/// The decoders, color converters and compositors found on the device when
+/// the plugin was loaded, each in the order the players try them.
+class VideoCapabilities {
+  /// Constructs an instance with the given values.
+  const VideoCapabilities({
+    required this.decoders,
+    required this.converters,
+    required this.compositors,
+  });
+
+  /// The decoders of all the codecs, the preferred one of each codec first.
+  final List<VideoDecoderCapability> decoders;
+
+  /// The color converters, which also scale the video.
+  final List<VideoElementCapability> converters;
+
+  /// The compositors used by [ELinuxVideoPlayer.createCompositor].
+  final List<VideoElementCapability> compositors;
+
+  /// Returns the decoders of [codec], the preferred one first.
+  List<VideoDecoderCapability> decodersFor(String codec) => decoders
+      .where((VideoDecoderCapability decoder) =>
+          decoder.codec.toUpperCase() == codec.toUpperCase())
+      .toList();
+
+  /// Whether [codec] has a hardware decoder that accepts [width] x [height].
+  bool canDecodeInHardware(String codec, int width, int height) =>
+      decodersFor(codec).any((VideoDecoderCapability decoder) =>
+          decoder.isHardware &&
+          (decoder.maxWidth == null || width <= decoder.maxWidth!) &&
+          (decoder.maxHeight == null || height <= decoder.maxHeight!));
+}
 
 /// An eLinux implementation of [VideoPlayerPlatform] that uses the
 /// Pigeon-generated [VideoPlayerApi].
 class ELinuxVideoPlayer extends VideoPlayerPlatform {
   final ELinuxVideoPlayerApi _api = ELinuxVideoPlayerApi();
 
+  // Shared by [videoEventsFor] and the other event streams, since the plugin
+  // only sends the events of a player to one listener.
+  final Map<int, Stream<dynamic>> _eventStreams = <int, Stream<dynamic>>{};
+
+  // The players created while [setMultiplexedEvents] is enabled, which get
+  // their events from [_multiplexedSubscription] instead of a channel.
+  final Map<int, StreamController<dynamic>> _multiplexedControllers =
+      <int, StreamController<dynamic>>{};
+  StreamSubscription<dynamic>? _multiplexedSubscription;
+  // The buffered ranges of a player, until the batch has all of them.
+  final Map<int, List<dynamic>> _pendingBufferedRanges =
+      <int, List<dynamic>>{};
+
+  // The events that aren't [VideoEvent]s.
+  static const Set<String> _extensionEvents = <String>{
+    'positionUpdate',
+    'variantSwitch',
+    'throughput',
+    'subtitleCue',
+    'overlay',
+  };
+
+  /// The transport of the RTSP players created from now on. A
+  /// `#transport=` fragment of the uri takes precedence, e.g.
+  /// `rtsp://camera/stream#transport=udp-first`.
+  RtspTransport? rtspTransport;
+
+  /// Whether the players of local MP4 and Matroska files created from now
+  /// on decode them with a demuxer and a decoder chosen up front, instead
+  /// of autoplugging, so that they show their first frame sooner.
+  bool fastStart = false;
+
+  /// Whether the players created from now on have no audio at all, e.g.
+  /// for silent signage clips, which saves building the audio branch.
+  /// [setVolume] has no effect on them.
+  bool createMuted = false;
+
+  /// How much of the stream the RTSP and WebRTC players created from now on
+  /// keep to play it back with [setTimeshiftDelay], or null to keep none.
+  /// Only H.264, H.265 and AV1 streams are kept.
+  Duration? timeshiftWindow;
+
   /// Registers this class as the default instance of [PathProviderPlatform].
   static void registerWith() {
     VideoPlayerPlatform.instance = ELinuxVideoPlayer();
+    PlatformTasks.start('flutter.io/videoPlayer/platformTasks');
   }
 
   @override
@@ -28,11 +607,171 @@ class ELinuxVideoPlayer extends VideoPlayerPlatform {
 
   @override
   Future<void> dispose(int textureId) {
+    _eventStreams.remove(textureId);
+    _multiplexedControllers.remove(textureId)?.close();
+    _pendingBufferedRanges.remove(textureId);
     return _api.dispose(TextureMessage(textureId: textureId));
   }
 
   @override
   Future<int?> create(DataSource dataSource) async {
+    final bool isMultiplexed = _multiplexedSubscription != null;
+    final TextureMessage response =
+        await _api.create(_createMessageFor(dataSource));
+    if (isMultiplexed) {
+      // Buffers the events sent before [videoEventsFor] is listened to.
+      final StreamController<dynamic> controller =
+          StreamController<dynamic>();
+      _multiplexedControllers[response.textureId] = controller;
+      _eventStreams[response.textureId] =
+          controller.stream.asBroadcastStream();
+    }
+    return response.textureId;
+  }
+
+  /// Makes the players created from now on send their events on one
+  /// channel shared by all the players, instead of a channel per player.
+  ///
+  /// The events are sent in binary batches at most every [interval], and
+  /// the state updates of a player within a batch, e.g. its position or
+  /// buffering state, are coalesced into the latest one. Meant for apps
+  /// with many players. The players created while this is enabled get no
+  /// more events once it's disabled.
+  void setMultiplexedEvents(
+    bool enabled, {
+    Duration interval = const Duration(milliseconds: 16),
+  }) {
+    _multiplexedSubscription?.cancel();
+    _multiplexedSubscription = null;
+    if (!enabled) {
+      return;
+    }
+    _multiplexedSubscription =
+        const EventChannel('flutter.io/videoPlayer/events')
+            .receiveBroadcastStream(<String, Object>{
+      'intervalMs': interval.inMilliseconds,
+    }).listen(_dispatchEventBatch);
+  }
+
+  // Decodes a batch of VideoEventQueue, see video_event_queue.h, into the
+  // events a player channel would send.
+  void _dispatchEventBatch(dynamic event) {
+    final Uint8List bytes = event as Uint8List;
+    final ByteData data =
+        bytes.buffer.asByteData(bytes.offsetInBytes, bytes.lengthInBytes);
+    if (data.lengthInBytes < _eventBatchHeaderSize ||
+        data.getUint32(0, Endian.little) != _eventBatchVersion) {
+      return;
+    }
+    for (int offset = _eventBatchHeaderSize;
+        offset + _eventRecordSize <= data.lengthInBytes;
+        offset += _eventRecordSize) {
+      final int textureId = data.getInt64(offset, Endian.little);
+      final int type = data.getInt32(offset + 8, Endian.little);
+      final int index = data.getInt32(offset + 12, Endian.little);
+      int value(int i) => data.getInt64(offset + 16 + 8 * i, Endian.little);
+
+      final StreamController<dynamic>? controller =
+          _multiplexedControllers[textureId];
+      if (controller == null) {
+        continue;
+      }
+      switch (type) {
+        case 1:
+          controller.add(<String, Object>{
+            'event': 'initialized',
+            'duration': value(0),
+            'width': value(1),
+            'height': value(2),
+          });
+          break;
+        case 2:
+          controller.addError(PlatformException(
+            code: 'VideoError',
+            message:
+                'Failed to initialize the player with texture id: $textureId',
+          ));
+          break;
+        case 3:
+          controller.add(<String, Object>{'event': 'completed'});
+          break;
+        case 4:
+          controller.add(<String, Object>{
+            'event': 'isPlayingStateUpdate',
+            'isPlaying': value(0) != 0,
+          });
+          break;
+        case 5:
+          controller.add(<String, Object>{
+            'event': value(0) != 0 ? 'bufferingStart' : 'bufferingEnd',
+          });
+          break;
+        case 6:
+          final int count = value(2);
+          final List<dynamic> ranges = index == 0
+              ? (_pendingBufferedRanges[textureId] = <dynamic>[])
+              : (_pendingBufferedRanges[textureId] ??= <dynamic>[]);
+          if (count > 0) {
+            ranges.add(<int>[value(0), value(1)]);
+          }
+          if (index + 1 >= count) {
+            _pendingBufferedRanges.remove(textureId);
+            controller.add(<String, Object>{
+              'event': 'bufferingUpdate',
+              'values': ranges,
+            });
+          }
+          break;
+        case 7:
+          controller.add(<String, Object>{
+            'event': 'positionUpdate',
+            'position': value(0),
+            'duration': value(1),
+            'isBuffering': value(2) != 0,
+          });
+          break;
+        case 8:
+          controller.add(<String, Object>{
+            'event': 'variantSwitch',
+            'width': value(0),
+            'height': value(1),
+            'bitrate': value(2),
+            'bandwidth': value(3),
+          });
+          break;
+        case 9:
+          controller.add(<String, Object>{
+            'event': 'throughput',
+            'throughput': value(0),
+            'bandwidth': value(1),
+          });
+          break;
+      }
+    }
+  }
+
+  /// Prerolls [dataSource] in the background, so that a later [create] of
+  /// the same source starts instantly.
+  Future<void> preload(DataSource dataSource) {
+    return _api.preload(_createMessageFor(dataSource));
+  }
+
+  /// Sets how many disposed players are kept for reuse per pipeline type,
+  /// and how many sources can be preloaded at once. Zero disables both.
+  Future<void> setPlayerPoolSize(int size) {
+    return _api.setPlayerPoolSize(PlayerPoolSizeMessage(size: size));
+  }
+
+  /// Sets after how many frames a player whose texture isn't drawn, e.g.
+  /// behind another route, only decodes the key frames, to save CPU and
+  /// power. It decodes every frame again as soon as the texture is drawn.
+  /// Players with a [frameStream] are never throttled. Zero disables it,
+  /// and the default is 30.
+  Future<void> setIdleThrottle(int idleFrames) {
+    return _api.setIdleThrottle(IdleThrottleMessage(idleFrames: idleFrames));
+  }
+
+  CreateMessage _createMessageFor(DataSource dataSource) {
     String? asset;
     String? packageName;
     String? uri;
@@ -56,16 +795,17 @@ class ELinuxVideoPlayer extends VideoPlayerPlatform {
         uri = dataSource.uri;
         break;
     }
-    final CreateMessage message = CreateMessage(
+    return CreateMessage(
       asset: asset,
       packageName: packageName,
       uri: uri,
       httpHeaders: httpHeaders,
       formatHint: formatHint,
+      rtspTransport: _rtspTransportStringMap[rtspTransport],
+      fastStart: fastStart,
+      muted: createMuted,
+      timeshiftWindow: timeshiftWindow?.inMilliseconds,
     );
-
-    final TextureMessage response = await _api.create(message);
-    return response.textureId;
   }
 
   @override
@@ -121,8 +861,9 @@ class ELinuxVideoPlayer extends VideoPlayerPlatform {
 
   @override
   Stream<VideoEvent> videoEventsFor(int textureId) {
-    return _eventChannelFor(textureId)
-        .receiveBroadcastStream()
+    return _eventsFor(textureId)
+        .where((dynamic event) => !_extensionEvents
+            .contains((event as Map<dynamic, dynamic>)['event']))
         .map((dynamic event) {
       final Map<dynamic, dynamic> map = event as Map<dynamic, dynamic>;
       switch (map['event']) {
@@ -171,6 +912,645 @@ class ELinuxVideoPlayer extends VideoPlayerPlatform {
         .setMixWithOthers(MixWithOthersMessage(mixWithOthers: mixWithOthers));
   }
 
+  /// Sets the maximum age of a decoded frame.
+  ///
+  /// Frames that reach the video sink later than [budget] after their
+  /// presentation time are dropped instead of being rendered, which bounds
+  /// the display latency of live streams. [Duration.zero] disables the check.
+  Future<void> setLatencyBudget(int textureId, Duration budget) {
+    return _api.setLatencyBudget(LatencyBudgetMessage(
+      textureId: textureId,
+      latencyBudget: budget.inMilliseconds,
+    ));
+  }
+
+  /// Runs the RTSP players created from now on under one scheduler.
+  ///
+  /// The players share one pool of streaming threads and split
+  /// [maxDecoderThreads] decoder threads between them, where zero uses the
+  /// number of cores. Meant for showing many cameras at once.
+  Future<void> setMultiStreamMode(bool enabled, {int maxDecoderThreads = 0}) {
+    return _api.setMultiStreamMode(MultiStreamModeMessage(
+      enabled: enabled,
+      maxDecoderThreads: maxDecoderThreads,
+    ));
+  }
+
+  /// Selects the streams of a file played by [textureId].
+  ///
+  /// Without [audio], the audio streams are dropped rather than muted, so
+  /// that no audio decoder or audio device is used, e.g. for a silent video
+  /// wall. [audioTrack] selects an audio stream by its index, and -1 plays
+  /// the default one. The audio of RTSP streams is never received, so they
+  /// only accept `audio: false`.
+  Future<void> setTrackSelection(int textureId,
+      {bool audio = true, int audioTrack = -1}) {
+    return _api.setTrackSelection(TrackSelectionMessage(
+      textureId: textureId,
+      audio: audio,
+      audioTrack: audioTrack,
+    ));
+  }
+
+  /// Drops the audio streams of [textureId], as
+  /// `setTrackSelection(textureId, audio: false)` does.
+  Future<void> disableAudio(int textureId) {
+    return setTrackSelection(textureId, audio: false);
+  }
+
+  /// Shows or hides the text subtitles of the file played by [textureId].
+  ///
+  /// The subtitles are hidden by default. Rather than being drawn into the
+  /// frames, they're sent to [subtitleCuesFor], so that the app draws them
+  /// over the texture. Bitmap subtitles, e.g. DVD or PGS, aren't supported.
+  /// Only files accept this, and not with [setMultiStreamMode].
+  Future<void> setSubtitles(int textureId, bool enabled) {
+    return _api.setSubtitles(SubtitlesMessage(
+      textureId: textureId,
+      enabled: enabled,
+    ));
+  }
+
+  /// Decodes only the key frames of the RTSP stream of [textureId].
+  ///
+  /// Useful for off-screen or small tiles of a multi-stream wall. Once
+  /// disabled, decoding resumes from the next key frame.
+  Future<void> setKeyFrameOnly(int textureId, bool keyFrameOnly) {
+    return _api.setKeyFrameOnly(KeyFrameOnlyMessage(
+      textureId: textureId,
+      keyFrameOnly: keyFrameOnly,
+    ));
+  }
+
+  /// Lets the decoders of [textureId] skip the frames that would be shown
+  /// too late anyway, instead of decoding them, while [enabled].
+  ///
+  /// Useful when the CPU can't keep up. The sink sends QoS events upstream
+  /// with how late each frame is against the pipeline clock. For RTSP
+  /// streams, which are shown as soon as they arrive, the lateness is
+  /// measured above the usual latency of the stream. The skipped frames are
+  /// counted in [VideoPlayerStats.qosDroppedFrames].
+  Future<void> setQos(int textureId, bool enabled) {
+    return _api.setQos(QosMessage(
+      textureId: textureId,
+      enabled: enabled,
+    ));
+  }
+
+  /// Creates a player that composites the videos of [uris] into a single
+  /// [width] x [height] texture, and returns its texture id.
+  ///
+  /// The tiles are laid out in an even grid until [setCompositorLayout] is
+  /// called. Playback is controlled with the usual methods of the texture id.
+  Future<int> createCompositor(List<String> uris,
+      {required int width, required int height}) async {
+    final TextureMessage response =
+        await _api.createCompositor(CreateCompositorMessage(
+      uris: uris,
+      width: width,
+      height: height,
+    ));
+    return response.textureId;
+  }
+
+  /// Places the tiles of the compositor of [textureId], in the order of the
+  /// uris it was created with. [tiles] are in pixels of the output texture,
+  /// and later tiles are drawn above earlier ones.
+  Future<void> setCompositorLayout(int textureId, List<Rect> tiles) {
+    int zOrder = 0;
+    return _api.setCompositorLayout(CompositorLayoutMessage(
+      textureId: textureId,
+      tiles: tiles
+          .map((Rect tile) => CompositorTile(
+                x: tile.left.round(),
+                y: tile.top.round(),
+                width: tile.width.round(),
+                height: tile.height.round(),
+                zOrder: zOrder++,
+              ))
+          .toList(),
+    ));
+  }
+
+  /// Sets how long the players created from now on may take to preroll.
+  ///
+  /// Players are prerolled in the background, and one that doesn't preroll
+  /// in time reports an error on its event stream instead of becoming
+  /// initialized. [Duration.zero] waits forever. Defaults to 10 seconds.
+  Future<void> setPrerollTimeout(Duration timeout) {
+    return _api.setPrerollTimeout(PrerollTimeoutMessage(
+      timeout: timeout.inMilliseconds,
+    ));
+  }
+
+  /// Returns the network statistics of the RTSP player of [textureId].
+  ///
+  /// Throws a [PlatformException] when the player isn't an RTSP player or
+  /// hasn't started receiving yet.
+  Future<RtspTransportStats> getTransportStats(int textureId) async {
+    final TransportStatsMessage response =
+        await _api.getTransportStats(TextureMessage(textureId: textureId));
+    return RtspTransportStats(
+      transport: _rtspTransportStringMap.entries
+          .firstWhere(
+              (MapEntry<RtspTransport, String> entry) =>
+                  entry.value == response.transport,
+              orElse: () => const MapEntry<RtspTransport, String>(
+                  RtspTransport.tcp, 'tcp'))
+          .key,
+      packetsReceived: response.packetsReceived,
+      packetsLost: response.packetsLost,
+      packetsLate: response.packetsLate,
+      packetsDuplicated: response.packetsDuplicated,
+      jitter: Duration(microseconds: response.jitter),
+      reconnectAttempts: response.reconnectAttempts,
+      reconnects: response.reconnects,
+      lastReconnectLatency:
+          Duration(milliseconds: response.lastReconnectLatency),
+    );
+  }
+
+  /// Plays the live stream of [textureId] [delay] behind the live edge,
+  /// from the key frame at or before it, or live if [Duration.zero].
+  ///
+  /// Throws a [PlatformException] when the player has no timeshift buffer,
+  /// see [timeshiftWindow], or nothing has been kept yet.
+  Future<void> setTimeshiftDelay(int textureId, Duration delay) {
+    return _api.setTimeshiftDelay(TimeshiftMessage(
+      textureId: textureId,
+      delay: delay.inMilliseconds,
+      available: 0,
+    ));
+  }
+
+  /// Returns the state of the timeshift buffer of [textureId].
+  ///
+  /// Throws a [PlatformException] when the player has no timeshift buffer.
+  Future<VideoTimeshift> getTimeshift(int textureId) async {
+    final TimeshiftMessage response =
+        await _api.getTimeshift(TextureMessage(textureId: textureId));
+    return VideoTimeshift(
+      delay: Duration(milliseconds: response.delay),
+      available: Duration(milliseconds: response.available),
+    );
+  }
+
+  /// Returns the latency statistics of the player of [textureId].
+  ///
+  /// The decoder stages are only measured for RTSP streams.
+  Future<VideoPlayerStats> getStats(int textureId) async {
+    final StatsMessage response =
+        await _api.getStats(TextureMessage(textureId: textureId));
+    return VideoPlayerStats(
+      captureToDecode: _toFrameLatency(response.captureToDecode),
+      decodeToHandoff: _toFrameLatency(response.decodeToHandoff),
+      handoffToTexture: _toFrameLatency(response.handoffToTexture),
+      decodeToTexture: _toFrameLatency(response.decodeToTexture),
+      glassToGlass: _toFrameLatency(response.glassToGlass),
+      avDrift: _toFrameLatency(response.avDrift),
+      droppedFrames: response.droppedFrames,
+      lateFrames: response.lateFrames,
+      qosDroppedFrames: response.qosDroppedFrames,
+    );
+  }
+
+  /// Sets the playback rate of [textureId], which unlike [setPlaybackSpeed]
+  /// may be negative to play backwards.
+  ///
+  /// From 4x on, in either direction, only the key frames are decoded and the
+  /// audio is dropped, so that 8x or 16x scans of long recordings stay cheap.
+  /// Rate changes that keep the direction and the decoding mode are applied
+  /// without flushing the pipeline on GStreamer 1.18 or later.
+  Future<void> setPlaybackRate(int textureId, double rate) {
+    assert(rate != 0);
+
+    return _api.setPlaybackSpeed(PlaybackSpeedMessage(
+      textureId: textureId,
+      speed: rate,
+    ));
+  }
+
+  /// Seeks [textureId] to [position], landing where [mode] says.
+  ///
+  /// Local files are indexed in the background once initialized, after which
+  /// the snap modes land on the key frame without decoding anything else.
+  Future<void> seekToWithMode(
+      int textureId, Duration position, SeekMode mode) {
+    return _api.seekTo(PositionMessage(
+      textureId: textureId,
+      position: position.inMilliseconds,
+      seekMode: _seekModeStringMap[mode],
+    ));
+  }
+
+  /// Enters or leaves the scrubbing mode of [textureId].
+  ///
+  /// While scrubbing, seeks only decode the key frame nearest to the position
+  /// and skip the audio, so dragging a timeline stays interactive on long
+  /// recordings. Leaving it seeks accurately to the last scrubbed position.
+  Future<void> setScrubbing(int textureId, bool scrubbing) {
+    return _api.setScrubbing(ScrubbingMessage(
+      textureId: textureId,
+      isScrubbing: scrubbing,
+    ));
+  }
+
+  /// Returns the decoders, color converters and compositors the players can
+  /// use, probed once when the plugin was loaded, so that the app can pick
+  /// the codecs and resolutions that decode in hardware.
+  Future<VideoCapabilities> getCapabilities() async {
+    final CapabilitiesMessage response = await _api.getCapabilities();
+    VideoElementCapability toElement(ElementCapabilityMessage element) =>
+        VideoElementCapability(
+          name: element.name,
+          isHardware: element.isHardware,
+        );
+    return VideoCapabilities(
+      decoders: response.decoders
+          .map((DecoderCapabilityMessage decoder) => VideoDecoderCapability(
+                codec: decoder.codec,
+                name: decoder.name,
+                isHardware: decoder.isHardware,
+                maxWidth: decoder.maxWidth > 0 ? decoder.maxWidth : null,
+                maxHeight: decoder.maxHeight > 0 ? decoder.maxHeight : null,
+              ))
+          .toList(),
+      converters: response.converters.map(toElement).toList(),
+      compositors: response.compositors.map(toElement).toList(),
+    );
+  }
+
+  /// Extracts the frame of [uri] at [position] without creating a player,
+  /// e.g. for a thumbnail or a poster frame.
+  ///
+  /// See [extractFrames] for the details. Throws a [PlatformException] if the
+  /// frame couldn't be extracted.
+  Future<VideoFrame> extractFrame(
+    String uri, {
+    Duration position = Duration.zero,
+    int? maxWidth,
+    VideoFrameFormat format = VideoFrameFormat.png,
+  }) async {
+    final VideoFrameRequest request = VideoFrameRequest(
+      uri: uri,
+      position: position,
+      maxWidth: maxWidth,
+      format: format,
+    );
+    final ExtractedFramesMessage response =
+        await _api.extractFrames(ExtractFramesMessage(
+      requests: <FrameRequestMessage>[_toFrameRequestMessage(request)],
+    ));
+    final ExtractedFrameMessage frame = response.frames.single;
+    if (frame.data == null) {
+      throw PlatformException(code: 'extract-frame', message: frame.error);
+    }
+    return VideoFrame(
+      width: frame.width,
+      height: frame.height,
+      format: format,
+      bytes: frame.data!,
+    );
+  }
+
+  /// Extracts the frames of [requests] in parallel, without creating
+  /// players, and returns them in the same order, with null for the frames
+  /// that couldn't be extracted.
+  ///
+  /// Each frame is decoded by a short-lived pipeline on a pool of worker
+  /// threads. The frames of local files are cached on disk by uri,
+  /// modification time and request, so that asking for them again costs no
+  /// decoding.
+  Future<List<VideoFrame?>> extractFrames(
+      List<VideoFrameRequest> requests) async {
+    final ExtractedFramesMessage response =
+        await _api.extractFrames(ExtractFramesMessage(
+      requests: requests.map(_toFrameRequestMessage).toList(),
+    ));
+    final List<VideoFrame?> frames = <VideoFrame?>[];
+    for (int i = 0; i < requests.length; i++) {
+      final ExtractedFrameMessage frame = response.frames[i];
+      frames.add(frame.data == null
+          ? null
+          : VideoFrame(
+              width: frame.width,
+              height: frame.height,
+              format: requests[i].format,
+              bytes: frame.data!,
+            ));
+    }
+    return frames;
+  }
+
+  /// Captures the latest decoded frame of [textureId], e.g. for a
+  /// screenshot, scaled down so that its longest side is at most [maxSize]
+  /// if given.
+  ///
+  /// The frame is referenced rather than copied, and scaled and encoded on
+  /// worker threads shared by the players, so neither the playback nor the
+  /// platform thread waits for it. Throws a [PlatformException] if there's
+  /// no frame yet or too many captures are pending.
+  Future<VideoFrame> captureFrame(
+    int textureId, {
+    VideoFrameFormat format = VideoFrameFormat.jpeg,
+    int? maxSize,
+  }) async {
+    final CapturedFrameMessage frame =
+        await _api.captureFrame(CaptureFrameMessage(
+      textureId: textureId,
+      format: _videoFrameFormatStringMap[format]!,
+      maxSize: maxSize ?? 0,
+      path: '',
+    ));
+    return VideoFrame(
+      width: frame.width,
+      height: frame.height,
+      format: format,
+      bytes: frame.data!,
+    );
+  }
+
+  /// Like [captureFrame], but writes the frame to [path] on the worker
+  /// thread instead of returning it, and returns [path].
+  Future<String> captureFrameToFile(
+    int textureId,
+    String path, {
+    VideoFrameFormat format = VideoFrameFormat.jpeg,
+    int? maxSize,
+  }) async {
+    final CapturedFrameMessage frame =
+        await _api.captureFrame(CaptureFrameMessage(
+      textureId: textureId,
+      format: _videoFrameFormatStringMap[format]!,
+      maxSize: maxSize ?? 0,
+      path: path,
+    ));
+    return frame.path!;
+  }
+
+  /// Generates a sprite sheet of the video file at [uri], with a tile of
+  /// [tileWidth] pixels every [interval], in rows of [columns] tiles.
+  ///
+  /// Only the key frames are decoded, one file at a time on a background
+  /// thread. The sheet is written next to the file, or to the user cache
+  /// directory if its directory isn't writable, and returned again without
+  /// decoding until the file is modified. The interval is made longer for
+  /// a long file so that the image stays within 8192 pixels. Throws a
+  /// [PlatformException] if [uri] isn't a local file or can't be decoded.
+  Future<VideoSpriteSheet> generateSpriteSheet(
+    String uri, {
+    Duration interval = const Duration(seconds: 10),
+    int tileWidth = 160,
+    int columns = 10,
+  }) async {
+    final SpriteSheetMessage sheet =
+        await _api.generateSpriteSheet(GenerateSpriteSheetMessage(
+      uri: uri,
+      intervalMs: interval.inMilliseconds,
+      tileWidth: tileWidth,
+      columns: columns,
+    ));
+    return VideoSpriteSheet(
+      path: sheet.path,
+      interval: Duration(milliseconds: sheet.intervalMs),
+      tileSize:
+          Size(sheet.tileWidth.toDouble(), sheet.tileHeight.toDouble()),
+      columns: sheet.columns,
+      count: sheet.count,
+    );
+  }
+
+  /// Streams the decoded frames of [textureId], e.g. for on-device
+  /// inference, through memory shared with the plugin instead of copies.
+  ///
+  /// Only every [everyNth] frame is sent, scaled down by an integral factor
+  /// to at most [maxWidth] pixels wide if given. Each frame holds one of four
+  /// slots until [VideoFrameBuffer.release] is called, and the frames that
+  /// find no free slot are dropped, so a slow consumer only lowers the frame
+  /// rate of the stream.
+  Stream<VideoFrameBuffer> frameStream(
+    int textureId, {
+    int everyNth = 1,
+    int? maxWidth,
+  }) {
+    assert(everyNth > 0);
+
+    return EventChannel('flutter.io/videoPlayer/frameStream$textureId')
+        .receiveBroadcastStream(<String, Object>{
+      'everyNth': everyNth,
+      'maxWidth': maxWidth ?? 0,
+    }).map((dynamic event) {
+      final Map<dynamic, dynamic> map = event as Map<dynamic, dynamic>;
+      final int timestampUs = map['timestampUs'] as int;
+      return VideoFrameBuffer._(
+        sequence: map['sequence'] as int,
+        width: map['width'] as int,
+        height: map['height'] as int,
+        stride: map['stride'] as int,
+        format: map['format'] == 'gray8'
+            ? VideoFrameBufferFormat.gray8
+            : VideoFrameBufferFormat.rgba,
+        timestamp:
+            timestampUs < 0 ? null : Duration(microseconds: timestampUs),
+        droppedFrames: map['droppedFrames'] as int,
+        address: map['address'] as int,
+        size: map['size'] as int,
+        stateAddress: map['stateAddress'] as int,
+      );
+    });
+  }
+
+  /// Returns the positions of all the players in one message, keyed by
+  /// texture id, which is cheaper than a [getPosition] per player.
+  Future<Map<int, VideoPlayerPosition>> getPositions() async {
+    final PositionsMessage response = await _api.getPositions();
+    return <int, VideoPlayerPosition>{
+      for (final PlayerPositionMessage position in response.positions)
+        position.textureId: _toVideoPlayerPosition(
+            position.position, position.duration, position.isBuffering),
+    };
+  }
+
+  /// Makes [textureId] push its position to [positionUpdatesFor] every
+  /// [interval], or stops it if [interval] is null.
+  ///
+  /// The positions of all the players are pushed from one native thread, so
+  /// this costs less than polling [getPosition] with many players.
+  Future<void> setPositionTick(int textureId, Duration? interval) {
+    return _api.setPositionTick(PositionTickMessage(
+      textureId: textureId,
+      intervalMs: interval?.inMilliseconds ?? 0,
+    ));
+  }
+
+  /// Returns the positions pushed by [textureId], see [setPositionTick].
+  Stream<VideoPlayerPosition> positionUpdatesFor(int textureId) {
+    return _eventsFor(textureId)
+        .where((dynamic event) =>
+            (event as Map<dynamic, dynamic>)['event'] == 'positionUpdate')
+        .map((dynamic event) {
+      final Map<dynamic, dynamic> map = event as Map<dynamic, dynamic>;
+      return _toVideoPlayerPosition(map['position'] as int,
+          map['duration'] as int, map['isBuffering'] as bool);
+    });
+  }
+
+  Stream<dynamic> _eventsFor(int textureId) {
+    return _eventStreams.putIfAbsent(
+        textureId, () => _eventChannelFor(textureId).receiveBroadcastStream());
+  }
+
+  /// Keeps up to [maxSizeBytes] of complete HTTP downloads on local storage,
+  /// so that a clip played again is read from the disk instead of being
+  /// downloaded again. A [maxSizeBytes] of zero disables the cache.
+  ///
+  /// The downloads are kept in [directory], or in the user cache directory
+  /// if it's null, and the least recently used ones are evicted first.
+  /// [bufferDuration] and [bufferSizeBytes] set how much of a network
+  /// stream is buffered before it plays. Applies to the players created
+  /// afterwards, and to [extractFrames].
+  Future<void> setDownloadCache({
+    required int maxSizeBytes,
+    String? directory,
+    Duration? bufferDuration,
+    int? bufferSizeBytes,
+  }) {
+    return _api.setDownloadCache(DownloadCacheMessage(
+      directory: directory,
+      maxSizeBytes: maxSizeBytes,
+      bufferDurationMs: bufferDuration?.inMilliseconds ?? 0,
+      bufferSizeBytes: bufferSizeBytes ?? 0,
+    ));
+  }
+
+  /// Sets how [textureId] selects the variants of an adaptive (HLS, DASH)
+  /// stream.
+  ///
+  /// [maxWidth] and [maxHeight] cap the resolution, and [followTextureSize]
+  /// also caps it to the size the texture is shown at, where the demuxer
+  /// supports it, e.g. for DASH. [maxBitrate] caps the bitrate in bits per
+  /// second. [startBitrate] plays the first fragments at a low bitrate and
+  /// then ramps up to the measured bandwidth, so that playback starts
+  /// quickly on a slow link.
+  Future<void> setAbrPolicy(
+    int textureId, {
+    int? maxWidth,
+    int? maxHeight,
+    bool followTextureSize = false,
+    int? maxBitrate,
+    int? startBitrate,
+  }) {
+    return _api.setAbrPolicy(AbrPolicyMessage(
+      textureId: textureId,
+      maxWidth: maxWidth ?? 0,
+      maxHeight: maxHeight ?? 0,
+      followTextureSize: followTextureSize,
+      maxBitrate: maxBitrate ?? 0,
+      startBitrate: startBitrate ?? 0,
+    ));
+  }
+
+  /// Pins the threads of [role] of all the players to [cpus], e.g. the big
+  /// cores of a big.LITTLE SoC, and runs them with SCHED_FIFO at
+  /// [realtimePriority] from 1 to 99, or else with [nice].
+  ///
+  /// Applies to the threads that start afterwards, e.g. when a player is
+  /// created or its source changes. An empty [cpus] lets them run on any
+  /// CPU. Real-time priorities and negative nice values need CAP_SYS_NICE
+  /// or the matching rlimit, otherwise the threads keep their scheduling and
+  /// a warning is logged.
+  Future<void> setThreadPolicy(
+    VideoThreadRole role, {
+    List<int> cpus = const <int>[],
+    int realtimePriority = 0,
+    int nice = 0,
+  }) {
+    return _api.setThreadPolicy(ThreadPolicyMessage(
+      role: _videoThreadRoleStringMap[role]!,
+      cpus: cpus,
+      realtimePriority: realtimePriority,
+      nice: nice,
+    ));
+  }
+
+  /// Returns the variant switches of the adaptive stream of [textureId].
+  Stream<VideoVariantSwitch> variantSwitchesFor(int textureId) {
+    return _eventsFor(textureId)
+        .where((dynamic event) =>
+            (event as Map<dynamic, dynamic>)['event'] == 'variantSwitch')
+        .map((dynamic event) {
+      final Map<dynamic, dynamic> map = event as Map<dynamic, dynamic>;
+      return VideoVariantSwitch(
+        size: Size((map['width'] as num).toDouble(),
+            (map['height'] as num).toDouble()),
+        bitrate: map['bitrate'] as int,
+        bandwidth: map['bandwidth'] as int,
+      );
+    });
+  }
+
+  /// Returns the throughput of each fragment of the adaptive stream of
+  /// [textureId].
+  Stream<VideoThroughput> throughputFor(int textureId) {
+    return _eventsFor(textureId)
+        .where((dynamic event) =>
+            (event as Map<dynamic, dynamic>)['event'] == 'throughput')
+        .map((dynamic event) {
+      final Map<dynamic, dynamic> map = event as Map<dynamic, dynamic>;
+      return VideoThroughput(
+        throughput: map['throughput'] as int,
+        bandwidth: map['bandwidth'] as int,
+      );
+    });
+  }
+
+  /// Returns the text subtitles of [textureId], once [setSubtitles] has
+  /// enabled them. The cues come slightly ahead of their [start].
+  Stream<VideoSubtitleCue> subtitleCuesFor(int textureId) {
+    return _eventsFor(textureId)
+        .where((dynamic event) =>
+            (event as Map<dynamic, dynamic>)['event'] == 'subtitleCue')
+        .map((dynamic event) {
+      final Map<dynamic, dynamic> map = event as Map<dynamic, dynamic>;
+      final int duration = map['duration'] as int;
+      return VideoSubtitleCue(
+        text: map['text'] as String,
+        isMarkup: map['isMarkup'] as bool,
+        start: Duration(milliseconds: map['start'] as int),
+        duration: duration < 0 ? null : Duration(milliseconds: duration),
+      );
+    });
+  }
+
+  /// Returns the overlays of the frames of [textureId], each time they
+  /// change. An empty list removes the previous overlay.
+  Stream<List<VideoOverlayRectangle>> overlaysFor(int textureId) {
+    return _eventsFor(textureId)
+        .where((dynamic event) =>
+            (event as Map<dynamic, dynamic>)['event'] == 'overlay')
+        .map((dynamic event) {
+      final Map<dynamic, dynamic> map = event as Map<dynamic, dynamic>;
+      return (map['rectangles'] as List<dynamic>).map((dynamic rectangle) {
+        final Map<dynamic, dynamic> values =
+            rectangle as Map<dynamic, dynamic>;
+        return VideoOverlayRectangle(
+          rect: Rect.fromLTWH(
+              (values['x'] as num).toDouble(),
+              (values['y'] as num).toDouble(),
+              (values['width'] as num).toDouble(),
+              (values['height'] as num).toDouble()),
+          pixelSize: Size((values['pixelWidth'] as num).toDouble(),
+              (values['pixelHeight'] as num).toDouble()),
+          pixels: values['pixels'] as Uint8List,
+        );
+      }).toList();
+    });
+  }
+
+  static const int _eventBatchVersion = 1;
+  static const int _eventBatchHeaderSize = 8;
+  static const int _eventRecordSize = 48;
+
   EventChannel _eventChannelFor(int textureId) {
     return EventChannel('flutter.io/videoPlayer/videoEvents$textureId');
   }
@@ -183,6 +1563,61 @@ class ELinuxVideoPlayer extends VideoPlayerPlatform {
     VideoFormat.other: 'other',
   };
 
+  static const Map<RtspTransport, String> _rtspTransportStringMap =
+      <RtspTransport, String>{
+    RtspTransport.tcp: 'tcp',
+    RtspTransport.udp: 'udp',
+    RtspTransport.multicast: 'multicast',
+    RtspTransport.udpFirst: 'udp-first',
+  };
+
+  static const Map<SeekMode, String> _seekModeStringMap = <SeekMode, String>{
+    SeekMode.keyUnit: 'key-unit',
+    SeekMode.accurate: 'accurate',
+    SeekMode.snapBefore: 'snap-before',
+    SeekMode.snapAfter: 'snap-after',
+  };
+
+  static const Map<VideoFrameFormat, String> _videoFrameFormatStringMap =
+      <VideoFrameFormat, String>{
+    VideoFrameFormat.rgba: 'rgba',
+    VideoFrameFormat.png: 'png',
+    VideoFrameFormat.jpeg: 'jpeg',
+  };
+
+  static const Map<VideoThreadRole, String> _videoThreadRoleStringMap =
+      <VideoThreadRole, String>{
+    VideoThreadRole.network: 'network',
+    VideoThreadRole.streaming: 'streaming',
+  };
+
+  FrameRequestMessage _toFrameRequestMessage(VideoFrameRequest request) {
+    return FrameRequestMessage(
+      uri: request.uri,
+      positionMs: request.position.inMilliseconds,
+      maxWidth: request.maxWidth ?? 0,
+      format: _videoFrameFormatStringMap[request.format]!,
+    );
+  }
+
+  VideoPlayerPosition _toVideoPlayerPosition(
+      int position, int duration, bool isBuffering) {
+    return VideoPlayerPosition(
+      position: position < 0 ? null : Duration(milliseconds: position),
+      duration: duration < 0 ? null : Duration(milliseconds: duration),
+      isBuffering: isBuffering,
+    );
+  }
+
+  FrameLatency _toFrameLatency(LatencyPercentiles value) {
+    return FrameLatency(
+      p50: Duration(microseconds: value.p50),
+      p95: Duration(microseconds: value.p95),
+      p99: Duration(microseconds: value.p99),
+      count: value.count,
+    );
+  }
+
   DurationRange _toDurationRange(dynamic value) {
     final List<dynamic> pair = value as List<dynamic>;
     return DurationRange(
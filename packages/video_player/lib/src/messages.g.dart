@@ -40,6 +40,10 @@ class CreateMessage {
     this.packageName,
     this.formatHint,
     required this.httpHeaders,
+    this.rtspTransport,
+    this.fastStart,
+    this.muted,
+    this.timeshiftWindow,
   });
 
   String? asset;
@@ -47,6 +51,10 @@ class CreateMessage {
   String? packageName;
   String? formatHint;
   Map<String?, String?> httpHeaders;
+  String? rtspTransport;
+  bool? fastStart;
+  bool? muted;
+  int? timeshiftWindow;
 
   Object encode() {
     final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
@@ -55,6 +63,10 @@ class CreateMessage {
     pigeonMap['packageName'] = packageName;
     pigeonMap['formatHint'] = formatHint;
     pigeonMap['httpHeaders'] = httpHeaders;
+    pigeonMap['rtspTransport'] = rtspTransport;
+    pigeonMap['fastStart'] = fastStart;
+    pigeonMap['muted'] = muted;
+    pigeonMap['timeshiftWindow'] = timeshiftWindow;
     return pigeonMap;
   }
 
@@ -66,6 +78,10 @@ class CreateMessage {
       packageName: pigeonMap['packageName'] as String?,
       formatHint: pigeonMap['formatHint'] as String?,
       httpHeaders: pigeonMap['httpHeaders'] as Map<String?, String?>,
+      rtspTransport: pigeonMap['rtspTransport'] as String?,
+      fastStart: pigeonMap['fastStart'] as bool?,
+      muted: pigeonMap['muted'] as bool?,
+      timeshiftWindow: pigeonMap['timeshiftWindow'] as int?,
     );
   }
 }
@@ -149,15 +165,18 @@ class PositionMessage {
   PositionMessage({
     required this.textureId,
     required this.position,
+    this.seekMode,
   });
 
   int textureId;
   int position;
+  String? seekMode;
 
   Object encode() {
     final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
     pigeonMap['textureId'] = textureId;
     pigeonMap['position'] = position;
+    pigeonMap['seekMode'] = seekMode;
     return pigeonMap;
   }
 
@@ -166,6 +185,7 @@ class PositionMessage {
     return PositionMessage(
       textureId: pigeonMap['textureId'] as int,
       position: pigeonMap['position'] as int,
+      seekMode: pigeonMap['seekMode'] as String?,
     );
   }
 }
@@ -191,13 +211,1485 @@ class MixWithOthersMessage {
   }
 }
 
+class LatencyBudgetMessage {
+  LatencyBudgetMessage({
+    required this.textureId,
+    required this.latencyBudget,
+  });
+
+  int textureId;
+  int latencyBudget;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['latencyBudget'] = latencyBudget;
+    return pigeonMap;
+  }
+
+  static LatencyBudgetMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return LatencyBudgetMessage(
+      textureId: pigeonMap['textureId'] as int,
+      latencyBudget: pigeonMap['latencyBudget'] as int,
+    );
+  }
+}
+
+class MultiStreamModeMessage {
+  MultiStreamModeMessage({
+    required this.enabled,
+    required this.maxDecoderThreads,
+  });
+
+  bool enabled;
+  int maxDecoderThreads;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['enabled'] = enabled;
+    pigeonMap['maxDecoderThreads'] = maxDecoderThreads;
+    return pigeonMap;
+  }
+
+  static MultiStreamModeMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return MultiStreamModeMessage(
+      enabled: pigeonMap['enabled'] as bool,
+      maxDecoderThreads: pigeonMap['maxDecoderThreads'] as int,
+    );
+  }
+}
+
+class KeyFrameOnlyMessage {
+  KeyFrameOnlyMessage({
+    required this.textureId,
+    required this.keyFrameOnly,
+  });
+
+  int textureId;
+  bool keyFrameOnly;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['keyFrameOnly'] = keyFrameOnly;
+    return pigeonMap;
+  }
+
+  static KeyFrameOnlyMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return KeyFrameOnlyMessage(
+      textureId: pigeonMap['textureId'] as int,
+      keyFrameOnly: pigeonMap['keyFrameOnly'] as bool,
+    );
+  }
+}
+
+class TrackSelectionMessage {
+  TrackSelectionMessage({
+    required this.textureId,
+    required this.audio,
+    required this.audioTrack,
+  });
+
+  int textureId;
+  bool audio;
+  int audioTrack;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['audio'] = audio;
+    pigeonMap['audioTrack'] = audioTrack;
+    return pigeonMap;
+  }
+
+  static TrackSelectionMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return TrackSelectionMessage(
+      textureId: pigeonMap['textureId'] as int,
+      audio: pigeonMap['audio'] as bool,
+      audioTrack: pigeonMap['audioTrack'] as int,
+    );
+  }
+}
+
+class SubtitlesMessage {
+  SubtitlesMessage({
+    required this.textureId,
+    required this.enabled,
+  });
+
+  int textureId;
+  bool enabled;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['enabled'] = enabled;
+    return pigeonMap;
+  }
+
+  static SubtitlesMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return SubtitlesMessage(
+      textureId: pigeonMap['textureId'] as int,
+      enabled: pigeonMap['enabled'] as bool,
+    );
+  }
+}
+
+class QosMessage {
+  QosMessage({
+    required this.textureId,
+    required this.enabled,
+  });
+
+  int textureId;
+  bool enabled;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['enabled'] = enabled;
+    return pigeonMap;
+  }
+
+  static QosMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return QosMessage(
+      textureId: pigeonMap['textureId'] as int,
+      enabled: pigeonMap['enabled'] as bool,
+    );
+  }
+}
+
+class CreateCompositorMessage {
+  CreateCompositorMessage({
+    required this.uris,
+    required this.width,
+    required this.height,
+  });
+
+  List<String?> uris;
+  int width;
+  int height;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['uris'] = uris;
+    pigeonMap['width'] = width;
+    pigeonMap['height'] = height;
+    return pigeonMap;
+  }
+
+  static CreateCompositorMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return CreateCompositorMessage(
+      uris: (pigeonMap['uris'] as List<Object?>).cast<String?>(),
+      width: pigeonMap['width'] as int,
+      height: pigeonMap['height'] as int,
+    );
+  }
+}
+
+class CompositorTile {
+  CompositorTile({
+    required this.x,
+    required this.y,
+    required this.width,
+    required this.height,
+    required this.zOrder,
+  });
+
+  int x;
+  int y;
+  int width;
+  int height;
+  int zOrder;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['x'] = x;
+    pigeonMap['y'] = y;
+    pigeonMap['width'] = width;
+    pigeonMap['height'] = height;
+    pigeonMap['zOrder'] = zOrder;
+    return pigeonMap;
+  }
+
+  static CompositorTile decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return CompositorTile(
+      x: pigeonMap['x'] as int,
+      y: pigeonMap['y'] as int,
+      width: pigeonMap['width'] as int,
+      height: pigeonMap['height'] as int,
+      zOrder: pigeonMap['zOrder'] as int,
+    );
+  }
+}
+
+class CompositorLayoutMessage {
+  CompositorLayoutMessage({
+    required this.textureId,
+    required this.tiles,
+  });
+
+  int textureId;
+  List<CompositorTile?> tiles;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['tiles'] =
+        tiles.map((CompositorTile? tile) => tile?.encode()).toList();
+    return pigeonMap;
+  }
+
+  static CompositorLayoutMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return CompositorLayoutMessage(
+      textureId: pigeonMap['textureId'] as int,
+      tiles: (pigeonMap['tiles'] as List<Object?>)
+          .map((Object? tile) =>
+              tile == null ? null : CompositorTile.decode(tile))
+          .toList(),
+    );
+  }
+}
+
+class PrerollTimeoutMessage {
+  PrerollTimeoutMessage({
+    required this.timeout,
+  });
+
+  int timeout;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['timeout'] = timeout;
+    return pigeonMap;
+  }
+
+  static PrerollTimeoutMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return PrerollTimeoutMessage(
+      timeout: pigeonMap['timeout'] as int,
+    );
+  }
+}
+
+class PlayerPoolSizeMessage {
+  PlayerPoolSizeMessage({
+    required this.size,
+  });
+
+  int size;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['size'] = size;
+    return pigeonMap;
+  }
+
+  static PlayerPoolSizeMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return PlayerPoolSizeMessage(
+      size: pigeonMap['size'] as int,
+    );
+  }
+}
+
+class IdleThrottleMessage {
+  IdleThrottleMessage({
+    required this.idleFrames,
+  });
+
+  int idleFrames;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['idleFrames'] = idleFrames;
+    return pigeonMap;
+  }
+
+  static IdleThrottleMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return IdleThrottleMessage(
+      idleFrames: pigeonMap['idleFrames'] as int,
+    );
+  }
+}
+
+class TransportStatsMessage {
+  TransportStatsMessage({
+    required this.textureId,
+    required this.transport,
+    required this.packetsReceived,
+    required this.packetsLost,
+    required this.packetsLate,
+    required this.packetsDuplicated,
+    required this.jitter,
+    required this.reconnectAttempts,
+    required this.reconnects,
+    required this.lastReconnectLatency,
+  });
+
+  int textureId;
+  String transport;
+  int packetsReceived;
+  int packetsLost;
+  int packetsLate;
+  int packetsDuplicated;
+  int jitter;
+  int reconnectAttempts;
+  int reconnects;
+  int lastReconnectLatency;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['transport'] = transport;
+    pigeonMap['packetsReceived'] = packetsReceived;
+    pigeonMap['packetsLost'] = packetsLost;
+    pigeonMap['packetsLate'] = packetsLate;
+    pigeonMap['packetsDuplicated'] = packetsDuplicated;
+    pigeonMap['jitter'] = jitter;
+    pigeonMap['reconnectAttempts'] = reconnectAttempts;
+    pigeonMap['reconnects'] = reconnects;
+    pigeonMap['lastReconnectLatency'] = lastReconnectLatency;
+    return pigeonMap;
+  }
+
+  static TransportStatsMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return TransportStatsMessage(
+      textureId: pigeonMap['textureId'] as int,
+      transport: pigeonMap['transport'] as String,
+      packetsReceived: pigeonMap['packetsReceived'] as int,
+      packetsLost: pigeonMap['packetsLost'] as int,
+      packetsLate: pigeonMap['packetsLate'] as int,
+      packetsDuplicated: pigeonMap['packetsDuplicated'] as int,
+      jitter: pigeonMap['jitter'] as int,
+      reconnectAttempts: pigeonMap['reconnectAttempts'] as int,
+      reconnects: pigeonMap['reconnects'] as int,
+      lastReconnectLatency: pigeonMap['lastReconnectLatency'] as int,
+    );
+  }
+}
+
+class LatencyPercentiles {
+  LatencyPercentiles({
+    required this.p50,
+    required this.p95,
+    required this.p99,
+    required this.count,
+  });
+
+  int p50;
+  int p95;
+  int p99;
+  int count;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['p50'] = p50;
+    pigeonMap['p95'] = p95;
+    pigeonMap['p99'] = p99;
+    pigeonMap['count'] = count;
+    return pigeonMap;
+  }
+
+  static LatencyPercentiles decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return LatencyPercentiles(
+      p50: pigeonMap['p50'] as int,
+      p95: pigeonMap['p95'] as int,
+      p99: pigeonMap['p99'] as int,
+      count: pigeonMap['count'] as int,
+    );
+  }
+}
+
+class StatsMessage {
+  StatsMessage({
+    required this.textureId,
+    required this.captureToDecode,
+    required this.decodeToHandoff,
+    required this.handoffToTexture,
+    required this.decodeToTexture,
+    required this.glassToGlass,
+    required this.avDrift,
+    required this.droppedFrames,
+    required this.lateFrames,
+    required this.qosDroppedFrames,
+  });
+
+  int textureId;
+  LatencyPercentiles captureToDecode;
+  LatencyPercentiles decodeToHandoff;
+  LatencyPercentiles handoffToTexture;
+  LatencyPercentiles decodeToTexture;
+  LatencyPercentiles glassToGlass;
+  LatencyPercentiles avDrift;
+  int droppedFrames;
+  int lateFrames;
+  int qosDroppedFrames;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['captureToDecode'] = captureToDecode.encode();
+    pigeonMap['decodeToHandoff'] = decodeToHandoff.encode();
+    pigeonMap['handoffToTexture'] = handoffToTexture.encode();
+    pigeonMap['decodeToTexture'] = decodeToTexture.encode();
+    pigeonMap['glassToGlass'] = glassToGlass.encode();
+    pigeonMap['avDrift'] = avDrift.encode();
+    pigeonMap['droppedFrames'] = droppedFrames;
+    pigeonMap['lateFrames'] = lateFrames;
+    pigeonMap['qosDroppedFrames'] = qosDroppedFrames;
+    return pigeonMap;
+  }
+
+  static StatsMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return StatsMessage(
+      textureId: pigeonMap['textureId'] as int,
+      captureToDecode: LatencyPercentiles.decode(pigeonMap['captureToDecode']!),
+      decodeToHandoff: LatencyPercentiles.decode(pigeonMap['decodeToHandoff']!),
+      handoffToTexture:
+          LatencyPercentiles.decode(pigeonMap['handoffToTexture']!),
+      decodeToTexture: LatencyPercentiles.decode(pigeonMap['decodeToTexture']!),
+      glassToGlass: LatencyPercentiles.decode(pigeonMap['glassToGlass']!),
+      avDrift: LatencyPercentiles.decode(pigeonMap['avDrift']!),
+      droppedFrames: pigeonMap['droppedFrames'] as int,
+      lateFrames: pigeonMap['lateFrames'] as int,
+      qosDroppedFrames: pigeonMap['qosDroppedFrames'] as int,
+    );
+  }
+}
+
+class ScrubbingMessage {
+  ScrubbingMessage({
+    required this.textureId,
+    required this.isScrubbing,
+  });
+
+  int textureId;
+  bool isScrubbing;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['isScrubbing'] = isScrubbing;
+    return pigeonMap;
+  }
+
+  static ScrubbingMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return ScrubbingMessage(
+      textureId: pigeonMap['textureId'] as int,
+      isScrubbing: pigeonMap['isScrubbing'] as bool,
+    );
+  }
+}
+
+class DecoderCapabilityMessage {
+  DecoderCapabilityMessage({
+    required this.codec,
+    required this.name,
+    required this.isHardware,
+    required this.maxWidth,
+    required this.maxHeight,
+  });
+
+  String codec;
+  String name;
+  bool isHardware;
+  int maxWidth;
+  int maxHeight;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['codec'] = codec;
+    pigeonMap['name'] = name;
+    pigeonMap['isHardware'] = isHardware;
+    pigeonMap['maxWidth'] = maxWidth;
+    pigeonMap['maxHeight'] = maxHeight;
+    return pigeonMap;
+  }
+
+  static DecoderCapabilityMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return DecoderCapabilityMessage(
+      codec: pigeonMap['codec'] as String,
+      name: pigeonMap['name'] as String,
+      isHardware: pigeonMap['isHardware'] as bool,
+      maxWidth: pigeonMap['maxWidth'] as int,
+      maxHeight: pigeonMap['maxHeight'] as int,
+    );
+  }
+}
+
+class ElementCapabilityMessage {
+  ElementCapabilityMessage({
+    required this.name,
+    required this.isHardware,
+  });
+
+  String name;
+  bool isHardware;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['name'] = name;
+    pigeonMap['isHardware'] = isHardware;
+    return pigeonMap;
+  }
+
+  static ElementCapabilityMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return ElementCapabilityMessage(
+      name: pigeonMap['name'] as String,
+      isHardware: pigeonMap['isHardware'] as bool,
+    );
+  }
+}
+
+class CapabilitiesMessage {
+  CapabilitiesMessage({
+    required this.decoders,
+    required this.converters,
+    required this.compositors,
+  });
+
+  List<DecoderCapabilityMessage> decoders;
+  List<ElementCapabilityMessage> converters;
+  List<ElementCapabilityMessage> compositors;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['decoders'] = decoders
+        .map((DecoderCapabilityMessage decoder) => decoder.encode())
+        .toList();
+    pigeonMap['converters'] = converters
+        .map((ElementCapabilityMessage converter) => converter.encode())
+        .toList();
+    pigeonMap['compositors'] = compositors
+        .map((ElementCapabilityMessage compositor) => compositor.encode())
+        .toList();
+    return pigeonMap;
+  }
+
+  static CapabilitiesMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return CapabilitiesMessage(
+      decoders: (pigeonMap['decoders'] as List<Object?>)
+          .map((Object? decoder) => DecoderCapabilityMessage.decode(decoder!))
+          .toList(),
+      converters: (pigeonMap['converters'] as List<Object?>)
+          .map((Object? converter) =>
+              ElementCapabilityMessage.decode(converter!))
+          .toList(),
+      compositors: (pigeonMap['compositors'] as List<Object?>)
+          .map((Object? compositor) =>
+              ElementCapabilityMessage.decode(compositor!))
+          .toList(),
+    );
+  }
+}
+
+class FrameRequestMessage {
+  FrameRequestMessage({
+    required this.uri,
+    required this.positionMs,
+    required this.maxWidth,
+    required this.format,
+  });
+
+  String uri;
+  int positionMs;
+  int maxWidth;
+  String format;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['uri'] = uri;
+    pigeonMap['positionMs'] = positionMs;
+    pigeonMap['maxWidth'] = maxWidth;
+    pigeonMap['format'] = format;
+    return pigeonMap;
+  }
+
+  static FrameRequestMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return FrameRequestMessage(
+      uri: pigeonMap['uri'] as String,
+      positionMs: pigeonMap['positionMs'] as int,
+      maxWidth: pigeonMap['maxWidth'] as int,
+      format: pigeonMap['format'] as String,
+    );
+  }
+}
+
+class ExtractFramesMessage {
+  ExtractFramesMessage({
+    required this.requests,
+  });
+
+  List<FrameRequestMessage> requests;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['requests'] = requests
+        .map((FrameRequestMessage request) => request.encode())
+        .toList();
+    return pigeonMap;
+  }
+
+  static ExtractFramesMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return ExtractFramesMessage(
+      requests: (pigeonMap['requests'] as List<Object?>)
+          .map((Object? request) => FrameRequestMessage.decode(request!))
+          .toList(),
+    );
+  }
+}
+
+class ExtractedFrameMessage {
+  ExtractedFrameMessage({
+    required this.width,
+    required this.height,
+    this.data,
+    this.error,
+  });
+
+  int width;
+  int height;
+  Uint8List? data;
+  String? error;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['width'] = width;
+    pigeonMap['height'] = height;
+    pigeonMap['data'] = data;
+    pigeonMap['error'] = error;
+    return pigeonMap;
+  }
+
+  static ExtractedFrameMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return ExtractedFrameMessage(
+      width: pigeonMap['width'] as int,
+      height: pigeonMap['height'] as int,
+      data: pigeonMap['data'] as Uint8List?,
+      error: pigeonMap['error'] as String?,
+    );
+  }
+}
+
+class CaptureFrameMessage {
+  CaptureFrameMessage({
+    required this.textureId,
+    required this.format,
+    required this.maxSize,
+    required this.path,
+  });
+
+  int textureId;
+  String format;
+  int maxSize;
+  String path;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['format'] = format;
+    pigeonMap['maxSize'] = maxSize;
+    pigeonMap['path'] = path;
+    return pigeonMap;
+  }
+
+  static CaptureFrameMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return CaptureFrameMessage(
+      textureId: pigeonMap['textureId'] as int,
+      format: pigeonMap['format'] as String,
+      maxSize: pigeonMap['maxSize'] as int,
+      path: pigeonMap['path'] as String,
+    );
+  }
+}
+
+class CapturedFrameMessage {
+  CapturedFrameMessage({
+    required this.width,
+    required this.height,
+    this.data,
+    this.path,
+  });
+
+  int width;
+  int height;
+  Uint8List? data;
+  String? path;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['width'] = width;
+    pigeonMap['height'] = height;
+    pigeonMap['data'] = data;
+    pigeonMap['path'] = path;
+    return pigeonMap;
+  }
+
+  static CapturedFrameMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return CapturedFrameMessage(
+      width: pigeonMap['width'] as int,
+      height: pigeonMap['height'] as int,
+      data: pigeonMap['data'] as Uint8List?,
+      path: pigeonMap['path'] as String?,
+    );
+  }
+}
+
+class GenerateSpriteSheetMessage {
+  GenerateSpriteSheetMessage({
+    required this.uri,
+    required this.intervalMs,
+    required this.tileWidth,
+    required this.columns,
+  });
+
+  String uri;
+  int intervalMs;
+  int tileWidth;
+  int columns;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['uri'] = uri;
+    pigeonMap['intervalMs'] = intervalMs;
+    pigeonMap['tileWidth'] = tileWidth;
+    pigeonMap['columns'] = columns;
+    return pigeonMap;
+  }
+
+  static GenerateSpriteSheetMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return GenerateSpriteSheetMessage(
+      uri: pigeonMap['uri'] as String,
+      intervalMs: pigeonMap['intervalMs'] as int,
+      tileWidth: pigeonMap['tileWidth'] as int,
+      columns: pigeonMap['columns'] as int,
+    );
+  }
+}
+
+class SpriteSheetMessage {
+  SpriteSheetMessage({
+    required this.path,
+    required this.intervalMs,
+    required this.tileWidth,
+    required this.tileHeight,
+    required this.columns,
+    required this.count,
+  });
+
+  String path;
+  int intervalMs;
+  int tileWidth;
+  int tileHeight;
+  int columns;
+  int count;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['path'] = path;
+    pigeonMap['intervalMs'] = intervalMs;
+    pigeonMap['tileWidth'] = tileWidth;
+    pigeonMap['tileHeight'] = tileHeight;
+    pigeonMap['columns'] = columns;
+    pigeonMap['count'] = count;
+    return pigeonMap;
+  }
+
+  static SpriteSheetMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return SpriteSheetMessage(
+      path: pigeonMap['path'] as String,
+      intervalMs: pigeonMap['intervalMs'] as int,
+      tileWidth: pigeonMap['tileWidth'] as int,
+      tileHeight: pigeonMap['tileHeight'] as int,
+      columns: pigeonMap['columns'] as int,
+      count: pigeonMap['count'] as int,
+    );
+  }
+}
+
+class ExtractedFramesMessage {
+  ExtractedFramesMessage({
+    required this.frames,
+  });
+
+  List<ExtractedFrameMessage> frames;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['frames'] =
+        frames.map((ExtractedFrameMessage frame) => frame.encode()).toList();
+    return pigeonMap;
+  }
+
+  static ExtractedFramesMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return ExtractedFramesMessage(
+      frames: (pigeonMap['frames'] as List<Object?>)
+          .map((Object? frame) => ExtractedFrameMessage.decode(frame!))
+          .toList(),
+    );
+  }
+}
+
+class PlayerPositionMessage {
+  PlayerPositionMessage({
+    required this.textureId,
+    required this.position,
+    required this.duration,
+    required this.isBuffering,
+  });
+
+  int textureId;
+  int position;
+  int duration;
+  bool isBuffering;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['position'] = position;
+    pigeonMap['duration'] = duration;
+    pigeonMap['isBuffering'] = isBuffering;
+    return pigeonMap;
+  }
+
+  static PlayerPositionMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return PlayerPositionMessage(
+      textureId: pigeonMap['textureId'] as int,
+      position: pigeonMap['position'] as int,
+      duration: pigeonMap['duration'] as int,
+      isBuffering: pigeonMap['isBuffering'] as bool,
+    );
+  }
+}
+
+class PositionsMessage {
+  PositionsMessage({
+    required this.positions,
+  });
+
+  List<PlayerPositionMessage> positions;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['positions'] = positions
+        .map((PlayerPositionMessage position) => position.encode())
+        .toList();
+    return pigeonMap;
+  }
+
+  static PositionsMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return PositionsMessage(
+      positions: (pigeonMap['positions'] as List<Object?>)
+          .map((Object? position) => PlayerPositionMessage.decode(position!))
+          .toList(),
+    );
+  }
+}
+
+class PositionTickMessage {
+  PositionTickMessage({
+    required this.textureId,
+    required this.intervalMs,
+  });
+
+  int textureId;
+  int intervalMs;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['intervalMs'] = intervalMs;
+    return pigeonMap;
+  }
+
+  static PositionTickMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return PositionTickMessage(
+      textureId: pigeonMap['textureId'] as int,
+      intervalMs: pigeonMap['intervalMs'] as int,
+    );
+  }
+}
+
+class DownloadCacheMessage {
+  DownloadCacheMessage({
+    this.directory,
+    required this.maxSizeBytes,
+    required this.bufferDurationMs,
+    required this.bufferSizeBytes,
+  });
+
+  String? directory;
+  int maxSizeBytes;
+  int bufferDurationMs;
+  int bufferSizeBytes;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['directory'] = directory;
+    pigeonMap['maxSizeBytes'] = maxSizeBytes;
+    pigeonMap['bufferDurationMs'] = bufferDurationMs;
+    pigeonMap['bufferSizeBytes'] = bufferSizeBytes;
+    return pigeonMap;
+  }
+
+  static DownloadCacheMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return DownloadCacheMessage(
+      directory: pigeonMap['directory'] as String?,
+      maxSizeBytes: pigeonMap['maxSizeBytes'] as int,
+      bufferDurationMs: pigeonMap['bufferDurationMs'] as int,
+      bufferSizeBytes: pigeonMap['bufferSizeBytes'] as int,
+    );
+  }
+}
+
+class AbrPolicyMessage {
+  AbrPolicyMessage({
+    required this.textureId,
+    required this.maxWidth,
+    required this.maxHeight,
+    required this.followTextureSize,
+    required this.maxBitrate,
+    required this.startBitrate,
+  });
+
+  int textureId;
+  int maxWidth;
+  int maxHeight;
+  bool followTextureSize;
+  int maxBitrate;
+  int startBitrate;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['maxWidth'] = maxWidth;
+    pigeonMap['maxHeight'] = maxHeight;
+    pigeonMap['followTextureSize'] = followTextureSize;
+    pigeonMap['maxBitrate'] = maxBitrate;
+    pigeonMap['startBitrate'] = startBitrate;
+    return pigeonMap;
+  }
+
+  static AbrPolicyMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return AbrPolicyMessage(
+      textureId: pigeonMap['textureId'] as int,
+      maxWidth: pigeonMap['maxWidth'] as int,
+      maxHeight: pigeonMap['maxHeight'] as int,
+      followTextureSize: pigeonMap['followTextureSize'] as bool,
+      maxBitrate: pigeonMap['maxBitrate'] as int,
+      startBitrate: pigeonMap['startBitrate'] as int,
+    );
+  }
+}
+
+class ThreadPolicyMessage {
+  ThreadPolicyMessage({
+    required this.role,
+    required this.cpus,
+    required this.realtimePriority,
+    required this.nice,
+  });
+
+  String role;
+  List<int?> cpus;
+  int realtimePriority;
+  int nice;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['role'] = role;
+    pigeonMap['cpus'] = cpus;
+    pigeonMap['realtimePriority'] = realtimePriority;
+    pigeonMap['nice'] = nice;
+    return pigeonMap;
+  }
+
+  static ThreadPolicyMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return ThreadPolicyMessage(
+      role: pigeonMap['role'] as String,
+      cpus: (pigeonMap['cpus'] as List<Object?>).cast<int?>(),
+      realtimePriority: pigeonMap['realtimePriority'] as int,
+      nice: pigeonMap['nice'] as int,
+    );
+  }
+}
+
+class TimeshiftMessage {
+  TimeshiftMessage({
+    required this.textureId,
+    required this.delay,
+    required this.available,
+  });
+
+  int textureId;
+  int delay;
+  int available;
+
+  Object encode() {
+    final Map<Object?, Object?> pigeonMap = <Object?, Object?>{};
+    pigeonMap['textureId'] = textureId;
+    pigeonMap['delay'] = delay;
+    pigeonMap['available'] = available;
+    return pigeonMap;
+  }
+
+  static TimeshiftMessage decode(Object message) {
+    final Map<Object?, Object?> pigeonMap = message as Map<Object?, Object?>;
+    return TimeshiftMessage(
+      textureId: pigeonMap['textureId'] as int,
+      delay: pigeonMap['delay'] as int,
+      available: pigeonMap['available'] as int,
+    );
+  }
+}
+
 /// [VideoPlayerApi] in 
 class ELinuxVideoPlayerApi {
   Future<void> initialize() async {
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.initialize', StandardMessageCodec());
+        'dev.flutter.pigeon.VideoPlayerApi.initialize', StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(null) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<TextureMessage> create(CreateMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.create', StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      return TextureMessage.decode(replyMap['result']!);
+    }
+  }
+
+  Future<void> dispose(TextureMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.dispose', StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setLooping(LoopingMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setLooping', StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setVolume(VolumeMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setVolume', StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setPlaybackSpeed(PlaybackSpeedMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setPlaybackSpeed',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> play(TextureMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.play', StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
-        await channel.send(null) as Map<Object?, Object?>?;
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<PositionMessage> position(TextureMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.position', StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      return PositionMessage.decode(replyMap['result']!);
+    }
+  }
+
+  Future<void> seekTo(PositionMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.seekTo', StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> pause(TextureMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.pause', StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setMixWithOthers(MixWithOthersMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setMixWithOthers',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setLatencyBudget(LatencyBudgetMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setLatencyBudget',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setMultiStreamMode(MultiStreamModeMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setMultiStreamMode',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setTrackSelection(TrackSelectionMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setTrackSelection',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setSubtitles(SubtitlesMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setSubtitles',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setKeyFrameOnly(KeyFrameOnlyMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setKeyFrameOnly',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setQos(QosMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setQos',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
     if (replyMap == null) {
       throw PlatformException(
         code: 'channel-error',
@@ -217,10 +1709,11 @@ class ELinuxVideoPlayerApi {
     }
   }
 
-  Future<TextureMessage> create(CreateMessage arg) async {
+  Future<TextureMessage> createCompositor(CreateCompositorMessage arg) async {
     final Object encoded = arg.encode();
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.create', StandardMessageCodec());
+        'dev.flutter.pigeon.VideoPlayerApi.createCompositor',
+        StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
         await channel.send(encoded) as Map<Object?, Object?>?;
     if (replyMap == null) {
@@ -242,10 +1735,11 @@ class ELinuxVideoPlayerApi {
     }
   }
 
-  Future<void> dispose(TextureMessage arg) async {
+  Future<void> setCompositorLayout(CompositorLayoutMessage arg) async {
     final Object encoded = arg.encode();
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.dispose', StandardMessageCodec());
+        'dev.flutter.pigeon.VideoPlayerApi.setCompositorLayout',
+        StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
         await channel.send(encoded) as Map<Object?, Object?>?;
     if (replyMap == null) {
@@ -267,10 +1761,11 @@ class ELinuxVideoPlayerApi {
     }
   }
 
-  Future<void> setLooping(LoopingMessage arg) async {
+  Future<void> setPrerollTimeout(PrerollTimeoutMessage arg) async {
     final Object encoded = arg.encode();
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.setLooping', StandardMessageCodec());
+        'dev.flutter.pigeon.VideoPlayerApi.setPrerollTimeout',
+        StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
         await channel.send(encoded) as Map<Object?, Object?>?;
     if (replyMap == null) {
@@ -292,10 +1787,10 @@ class ELinuxVideoPlayerApi {
     }
   }
 
-  Future<void> setVolume(VolumeMessage arg) async {
+  Future<void> preload(CreateMessage arg) async {
     final Object encoded = arg.encode();
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.setVolume', StandardMessageCodec());
+        'dev.flutter.pigeon.VideoPlayerApi.preload', StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
         await channel.send(encoded) as Map<Object?, Object?>?;
     if (replyMap == null) {
@@ -317,10 +1812,35 @@ class ELinuxVideoPlayerApi {
     }
   }
 
-  Future<void> setPlaybackSpeed(PlaybackSpeedMessage arg) async {
+  Future<void> setPlayerPoolSize(PlayerPoolSizeMessage arg) async {
     final Object encoded = arg.encode();
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.setPlaybackSpeed',
+        'dev.flutter.pigeon.VideoPlayerApi.setPlayerPoolSize',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+  Future<void> setIdleThrottle(IdleThrottleMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setIdleThrottle',
         StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
         await channel.send(encoded) as Map<Object?, Object?>?;
@@ -343,10 +1863,62 @@ class ELinuxVideoPlayerApi {
     }
   }
 
-  Future<void> play(TextureMessage arg) async {
+  Future<TransportStatsMessage> getTransportStats(TextureMessage arg) async {
     final Object encoded = arg.encode();
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.play', StandardMessageCodec());
+        'dev.flutter.pigeon.VideoPlayerApi.getTransportStats',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      return TransportStatsMessage.decode(replyMap['result']!);
+    }
+  }
+
+  Future<StatsMessage> getStats(TextureMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.getStats', StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      return StatsMessage.decode(replyMap['result']!);
+    }
+  }
+
+  Future<void> setScrubbing(ScrubbingMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setScrubbing',
+        StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
         await channel.send(encoded) as Map<Object?, Object?>?;
     if (replyMap == null) {
@@ -368,10 +1940,36 @@ class ELinuxVideoPlayerApi {
     }
   }
 
-  Future<PositionMessage> position(TextureMessage arg) async {
+  Future<CapabilitiesMessage> getCapabilities() async {
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.getCapabilities',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(null) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      return CapabilitiesMessage.decode(replyMap['result']!);
+    }
+  }
+
+  Future<ExtractedFramesMessage> extractFrames(ExtractFramesMessage arg) async {
     final Object encoded = arg.encode();
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.position', StandardMessageCodec());
+        'dev.flutter.pigeon.VideoPlayerApi.extractFrames',
+        StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
         await channel.send(encoded) as Map<Object?, Object?>?;
     if (replyMap == null) {
@@ -389,14 +1987,92 @@ class ELinuxVideoPlayerApi {
         details: error['details'],
       );
     } else {
-      return PositionMessage.decode(replyMap['result']!);
+      return ExtractedFramesMessage.decode(replyMap['result']!);
     }
   }
 
-  Future<void> seekTo(PositionMessage arg) async {
+  Future<CapturedFrameMessage> captureFrame(CaptureFrameMessage arg) async {
     final Object encoded = arg.encode();
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.seekTo', StandardMessageCodec());
+        'dev.flutter.pigeon.VideoPlayerApi.captureFrame',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      return CapturedFrameMessage.decode(replyMap['result']!);
+    }
+  }
+
+  Future<SpriteSheetMessage> generateSpriteSheet(
+      GenerateSpriteSheetMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.generateSpriteSheet',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      return SpriteSheetMessage.decode(replyMap['result']!);
+    }
+  }
+
+  Future<PositionsMessage> getPositions() async {
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.getPositions',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(null) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      return PositionsMessage.decode(replyMap['result']!);
+    }
+  }
+  Future<void> setPositionTick(PositionTickMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setPositionTick',
+        StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
         await channel.send(encoded) as Map<Object?, Object?>?;
     if (replyMap == null) {
@@ -418,10 +2094,11 @@ class ELinuxVideoPlayerApi {
     }
   }
 
-  Future<void> pause(TextureMessage arg) async {
+  Future<void> setDownloadCache(DownloadCacheMessage arg) async {
     final Object encoded = arg.encode();
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.pause', StandardMessageCodec());
+        'dev.flutter.pigeon.VideoPlayerApi.setDownloadCache',
+        StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
         await channel.send(encoded) as Map<Object?, Object?>?;
     if (replyMap == null) {
@@ -443,10 +2120,62 @@ class ELinuxVideoPlayerApi {
     }
   }
 
-  Future<void> setMixWithOthers(MixWithOthersMessage arg) async {
+  Future<void> setAbrPolicy(AbrPolicyMessage arg) async {
     final Object encoded = arg.encode();
     const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
-        'dev.flutter.pigeon.VideoPlayerApi.setMixWithOthers',
+        'dev.flutter.pigeon.VideoPlayerApi.setAbrPolicy',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setThreadPolicy(ThreadPolicyMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setThreadPolicy',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      // noop
+    }
+  }
+
+  Future<void> setTimeshiftDelay(TimeshiftMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.setTimeshiftDelay',
         StandardMessageCodec());
     final Map<Object?, Object?>? replyMap =
         await channel.send(encoded) as Map<Object?, Object?>?;
@@ -468,4 +2197,30 @@ class ELinuxVideoPlayerApi {
       // noop
     }
   }
+
+  Future<TimeshiftMessage> getTimeshift(TextureMessage arg) async {
+    final Object encoded = arg.encode();
+    const BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.getTimeshift',
+        StandardMessageCodec());
+    final Map<Object?, Object?>? replyMap =
+        await channel.send(encoded) as Map<Object?, Object?>?;
+    if (replyMap == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+        details: null,
+      );
+    } else if (replyMap['error'] != null) {
+      final Map<Object?, Object?> error =
+          replyMap['error'] as Map<Object?, Object?>;
+      throw PlatformException(
+        code: error['code'] as String,
+        message: error['message'] as String?,
+        details: error['details'],
+      );
+    } else {
+      return TimeshiftMessage.decode(replyMap['result']!);
+    }
+  }
 }
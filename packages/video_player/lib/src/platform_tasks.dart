@@ -0,0 +1,45 @@
+// Copyright 2026 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:ffi';
+import 'dart:isolate';
+import 'dart:ui' as ui;
+
+import 'package:flutter/services.dart';
+
+/// Runs the tasks that the native plugin posts to the platform thread, e.g.
+/// the events of the players, see elinux/platform_task_queue.h.
+///
+/// The plugin wakes the native port of this isolate from its own threads,
+/// and the message sent back on the channel runs the tasks on the platform
+/// thread.
+class PlatformTasks {
+  PlatformTasks._(this._channelName) {
+    _port.listen((dynamic _) => _send(null));
+    _send(<String, Object>{
+      'port': _port.sendPort.nativePort,
+      'postCObject': NativeApi.postCObject.address,
+    });
+  }
+
+  /// Starts running the tasks posted on [channelName], once per isolate.
+  static void start(String channelName) {
+    _instances.putIfAbsent(channelName, () => PlatformTasks._(channelName));
+  }
+
+  static final Map<String, PlatformTasks> _instances =
+      <String, PlatformTasks>{};
+
+  static const StandardMessageCodec _codec = StandardMessageCodec();
+
+  final String _channelName;
+  final ReceivePort _port = ReceivePort();
+
+  /// Sent through the dispatcher rather than a channel, which needs the
+  /// binding, since registerWith() runs before it exists.
+  void _send(Object? message) {
+    ui.PlatformDispatcher.instance
+        .sendPlatformMessage(_channelName, _codec.encodeMessage(message), null);
+  }
+}